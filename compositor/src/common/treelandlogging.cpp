@@ -15,6 +15,7 @@ Q_LOGGING_CATEGORY(treelandShell, "treeland.shell")
 // Input modules
 Q_LOGGING_CATEGORY(treelandInput, "treeland.input")
 Q_LOGGING_CATEGORY(treelandGestures, "treeland.gestures")
+Q_LOGGING_CATEGORY(treelandGamepad, "treeland.gamepad")
 
 // Output module
 Q_LOGGING_CATEGORY(treelandOutput, "treeland.output")
@@ -19,6 +19,7 @@ Q_DECLARE_LOGGING_CATEGORY(treelandShell)
 // Input modules
 Q_DECLARE_LOGGING_CATEGORY(treelandInput)
 Q_DECLARE_LOGGING_CATEGORY(treelandGestures)
+Q_DECLARE_LOGGING_CATEGORY(treelandGamepad)
 
 // Output module
 Q_DECLARE_LOGGING_CATEGORY(treelandOutput)
@@ -162,6 +162,39 @@ Item {
                     Helper.toggleMultitaskView()
                 }
             }
+
+            ToolButton {
+                text: "Capture"
+                onClicked: captureStatsPopup.open()
+
+                Popup {
+                    id: captureStatsPopup
+
+                    y: parent.height
+
+                    function refresh() {
+                        const sessions = Helper.captureManager?.sessionStats() ?? []
+                        captureStatsLabel.text = sessions.length === 0
+                            ? "No capture sessions"
+                            : sessions.map(s => `pid ${s.pid} ${s.sourceType} (${s.pacingMode} ${s.minIntervalUs}us): `
+                                           + `delivered ${s.delivered}, skipped ${s.skipped}, late ${s.late}, `
+                                           + `ack ${s.lastAckLatencyUs}/${s.smoothedAckLatencyUs}/${s.maxAckLatencyUs}us`).join("\n")
+                    }
+
+                    onOpened: refresh()
+
+                    Timer {
+                        interval: 1000
+                        repeat: true
+                        running: captureStatsPopup.opened
+                        onTriggered: captureStatsPopup.refresh()
+                    }
+
+                    Label {
+                        id: captureStatsLabel
+                    }
+                }
+            }
         }
     }
 }
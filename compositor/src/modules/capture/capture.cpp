@@ -3,8 +3,12 @@
 
 #include "capture.h"
 
+#include "modules/capture/capturecursor.h"
+#include "modules/capture/capturedamage.h"
 #include "modules/capture/impl/capturev1impl.h"
 #include "modules/item-selector/itemselector.h"
+#include "core/rootsurfacecontainer.h"
+#include "output/output.h"
 #include "seat/helper.h"
 #include "surface/surfacewrapper.h"
 #include "workspace/workspace.h"
@@ -21,16 +25,34 @@
 #include <wtools.h>
 
 #include <qwcompositor.h>
+#include <qwallocator.h>
 #include <qwdisplay.h>
 #include <qwlayershellv1.h>
+#include <qwoutput.h>
+#include <qwrenderer.h>
 
+#include <QDBusAbstractAdaptor>
+#include <QDBusConnection>
 #include <QLoggingCategory>
 #include <QQueue>
 #include <QQuickItemGrabResult>
 #include <QSGTextureProvider>
+#include <QtMath>
 
 #include <utility>
 
+extern "C" {
+#include <drm_fourcc.h>
+#include <wlr/render/wlr_texture.h>
+}
+
+// Damage with more rectangles is sent as its bounding rect
+static constexpr int MaxDamageRects = 32;
+// Session stats are exported below the compositor's own object
+static constexpr QLatin1StringView CaptureDBusPath("/org/deepin/Compositor1/Capture");
+// Format of GPU snapshots of one shot captures and of composite frames
+static constexpr uint32_t SnapshotFormat = DRM_FORMAT_ARGB8888;
+
 static inline QRectF scaledRect(const QRectF &rect, qreal devicePixelRatio)
 {
     return { rect.x() * devicePixelRatio,
@@ -39,6 +61,50 @@ static inline QRectF scaledRect(const QRectF &rect, qreal devicePixelRatio)
              rect.height() * devicePixelRatio };
 }
 
+// Crops, converts and scales image into the memory of a shm buffer in a single pass.
+static bool paintImage(const QImage &image, const QRect &sourceRect, wlr_buffer *target)
+{
+    void *data = nullptr;
+    uint32_t format = 0;
+    size_t stride = 0;
+    if (!wlr_buffer_begin_data_ptr_access(target,
+                                          WLR_BUFFER_DATA_PTR_ACCESS_WRITE,
+                                          &data,
+                                          &format,
+                                          &stride)) {
+        return false;
+    }
+    const auto imageFormat = WTools::toImageFormat(format);
+    if (imageFormat != QImage::Format_Invalid) {
+        QImage targetImage(static_cast<uchar *>(data),
+                           target->width,
+                           target->height,
+                           static_cast<qsizetype>(stride),
+                           imageFormat);
+        QPainter painter(&targetImage);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform,
+                              targetImage.size() != sourceRect.size());
+        painter.drawImage(targetImage.rect(), image, sourceRect);
+    }
+    wlr_buffer_end_data_ptr_access(target);
+    return imageFormat != QImage::Format_Invalid;
+}
+
+static QRegion regionFromPixman(pixman_region32_t *region)
+{
+    int count = 0;
+    const pixman_box32_t *boxes = pixman_region32_rectangles(region, &count);
+    QRegion result;
+    for (int i = 0; i < count; ++i) {
+        result += QRect(boxes[i].x1,
+                        boxes[i].y1,
+                        boxes[i].x2 - boxes[i].x1,
+                        boxes[i].y2 - boxes[i].y1);
+    }
+    return result;
+}
+
 CaptureSource *CaptureContextV1::source() const
 {
     return m_captureSource;
@@ -111,7 +177,10 @@ CaptureContextV1::CaptureContextV1(treeland_capture_context_v1 *h,
     : QObject(parent)
     , m_handle(h)
     , m_outputRenderWindow(outputRenderWindow)
+    , m_pacer(new CaptureFramePacer(this))
 {
+    // Damage held back by the rate limit is delivered even if nothing renders anymore.
+    connect(m_pacer, &CaptureFramePacer::frameDue, this, &CaptureContextV1::handleRenderEnd);
     connect(h, &treeland_capture_context_v1::selectSource, this, &CaptureContextV1::onSelectSource);
     connect(h, &treeland_capture_context_v1::capture, this, &CaptureContextV1::onCapture);
     connect(h, &treeland_capture_context_v1::newSession, this, &CaptureContextV1::onCreateSession);
@@ -138,8 +207,10 @@ void CaptureContextV1::onCapture(treeland_capture_frame_v1 *frame)
     }
     m_frame = frame;
     auto notifyBuffer = [this] {
+        if (!m_frame)
+            return;
         m_frame->sendBuffer(
-            WTools::drmToShmFormat(WTools::toDrmFormat(m_captureSource->image().format())),
+            m_captureSource->shmFormat(),
             source()->cropRect().width(),
             source()->cropRect().height(),
             source()->cropRect().width() * 4);
@@ -149,14 +220,20 @@ void CaptureContextV1::onCapture(treeland_capture_frame_v1 *frame)
                 this,
                 &CaptureContextV1::handleFrameCopy,
                 Qt::UniqueConnection);
-        connect(m_frame, &treeland_capture_frame_v1::beforeDestroy, this, [this] {
-            m_frame = nullptr;
-        });
     };
+    connect(m_frame, &treeland_capture_frame_v1::beforeDestroy, this, [this] {
+        m_frame = nullptr;
+    });
     if (m_captureSource->imageValid()) {
         notifyBuffer();
+    } else if (m_captureSource->imageCreationFailed()) {
+        m_frame->sendFailed();
     } else {
         connect(m_captureSource, &CaptureSource::imageReady, this, notifyBuffer);
+        connect(m_captureSource, &CaptureSource::imageFailed, this, [this] {
+            if (m_frame)
+                m_frame->sendFailed();
+        });
     }
     Q_EMIT finishSelect();
 }
@@ -164,8 +241,10 @@ void CaptureContextV1::onCapture(treeland_capture_frame_v1 *frame)
 void CaptureContextV1::handleFrameCopy(QW_NAMESPACE::qw_buffer *buffer)
 {
     if (m_captureSource) {
-        m_captureSource->copyBuffer(buffer);
-        m_frame->sendReady();
+        if (m_captureSource->copyBuffer(buffer))
+            m_frame->sendReady();
+        else
+            m_frame->sendFailed();
     } else {
         wl_client_post_implementation_error(wl_resource_get_client(m_handle->resource),
                                             "Source is not ready, cannot capture.");
@@ -190,19 +269,40 @@ void CaptureContextV1::onCreateSession(treeland_capture_session_v1 *session)
         return;
     }
     m_session = session;
+    m_pacer->reset();
     connect(m_session,
             &treeland_capture_session_v1::start,
             this,
             &CaptureContextV1::handleSessionStart);
+    connect(m_session, &treeland_capture_session_v1::framePacingChanged, this, [this, session] {
+        const auto mode = session->pacingMode == TREELAND_CAPTURE_SESSION_V1_PACING_MODE_FIXED
+            ? CaptureFramePacer::Mode::Fixed
+            : CaptureFramePacer::Mode::Damage;
+        m_pacer->setPacing(mode, std::chrono::microseconds(session->minInterval));
+    });
     connect(m_session,
             &treeland_capture_session_v1::frameDone,
             this,
             &CaptureContextV1::handleFrameDone);
+    connect(m_session,
+            &treeland_capture_session_v1::cursorModeChanged,
+            this,
+            &CaptureContextV1::handleCursorModeChanged);
     connect(m_session, &treeland_capture_session_v1::beforeDestroy, this, [this] {
         disconnect(outputRenderWindow(),
                    &WOutputRenderWindow::renderEnd,
                    this,
                    &CaptureContextV1::handleRenderEnd);
+        if (m_damageTracker) {
+            m_damageTracker->deleteLater();
+            m_damageTracker = nullptr;
+        }
+        if (m_cursorTracker) {
+            m_cursorTracker->deleteLater();
+            m_cursorTracker = nullptr;
+        }
+        m_bufferRing.reset();
+        m_pendingDamage = {};
     });
     ensureSourceSessionConnection();
     Q_EMIT finishSelect();
@@ -236,6 +336,14 @@ void CaptureContextV1::handleSourceDestroyed()
 void CaptureContextV1::handleSessionStart()
 {
     m_currentFrameData.acked = true;
+    if (!m_bufferRing)
+        m_bufferRing = std::make_unique<CaptureBufferRing>();
+    // The first frame is always fully damaged.
+    captureSource()->damageAll();
+    // Surface sources are damaged by the commits of the surface itself.
+    if (!m_damageTracker && captureSource()->sourceType() != CaptureSource::Surface) {
+        m_damageTracker = new CaptureDamageTracker(outputRenderWindow(), captureSource(), this);
+    }
     moveToThread(QQuickWindowPrivate::get(outputRenderWindow())->context->thread());
     captureSource()->moveToThread(
         QQuickWindowPrivate::get(outputRenderWindow())->context->thread());
@@ -257,15 +365,50 @@ void CaptureContextV1::handleFrameDone(uint32_t tvSecHi, uint32_t tvSecLo, uint3
     if (m_currentFrameData.readyAt.tvSecHi == tvSecHi
         && m_currentFrameData.readyAt.tvSecLo == tvSecLo
         && m_currentFrameData.readyAt.tvUsec == tvUsec) {
-        // Note: dmabuf attributes is exported from output backing buffer, fds will be
-        // closed as soon as backing buffer is destroyed. We should not close fd here.
+        // Note: dmabuf attributes belong to a slot of the buffer ring, fds will be
+        // closed as soon as the slot is destroyed. We should not close fd here.
         m_currentFrameData.acked = true;
+        m_pacer->frameAcked();
+        if (m_bufferRing) {
+            m_bufferRing->release();
+            // A newer frame has been copied while the client held the previous one.
+            if (m_bufferRing->hasPending())
+                sendPendingFrame(true);
+        }
     } else {
         qCWarning(treelandCapture)
             << "Receive a frame done event that is not corresponding to current frame timestamp.";
     }
 }
 
+void CaptureContextV1::handleCursorModeChanged()
+{
+    if (!session())
+        return;
+    if (session()->cursorMode != TREELAND_CAPTURE_SESSION_V1_CURSOR_MODE_METADATA) {
+        if (m_cursorTracker) {
+            m_cursorTracker->deleteLater();
+            m_cursorTracker = nullptr;
+        }
+        return;
+    }
+    if (m_cursorTracker)
+        return;
+    m_cursorTracker = new CaptureCursorTracker(outputRenderWindow(), captureSource(), this);
+    connect(m_cursorTracker,
+            &CaptureCursorTracker::imageChanged,
+            session(),
+            &treeland_capture_session_v1::sendCursorImage);
+    connect(m_cursorTracker,
+            &CaptureCursorTracker::positionChanged,
+            session(),
+            &treeland_capture_session_v1::sendCursorPosition);
+    connect(m_cursorTracker,
+            &CaptureCursorTracker::left,
+            session(),
+            &treeland_capture_session_v1::sendCursorLeave);
+}
+
 QPointer<treeland_capture_session_v1> CaptureContextV1::session() const
 {
     return m_session;
@@ -283,17 +426,78 @@ QPointer<WOutputRenderWindow> CaptureContextV1::outputRenderWindow() const
 
 void CaptureContextV1::handleRenderEnd()
 {
-    if (!session() || !m_currentFrameData.acked)
+    if (!session() || !m_bufferRing)
         return;
     auto source = captureSource();
     Q_ASSERT(source);
-    auto dmabuf = source->sourceDMABuffer();
-    if (!dmabuf) {
+    // Rate limit before touching any buffer, held back damage stays in the source.
+    if (!source->hasDamage() || !m_pacer->tryBeginFrame())
+        return;
+    QList<CaptureRenderPart> parts;
+    QSize size;
+    uint32_t format = SnapshotFormat;
+    uint64_t modifier = DRM_FORMAT_MOD_INVALID;
+    QRect bounds;
+    if (source->isComposite()) {
+        // All contributing outputs are rendered into one frame.
+        parts = source->compositeParts();
+        size = source->cropRect().size();
+        bounds = QRect(QPoint(0, 0), size);
+    } else if (auto buffer = source->sourceDMABuffer();
+               buffer && captureBufferFormat(buffer->handle(), &format, &modifier)) {
+        size = QSize(buffer->handle()->width, buffer->handle()->height);
+        const QRect bufferRect(QPoint(0, 0), size);
+        parts.append({ buffer->handle(),
+                       { 0, 0, double(size.width()), double(size.height()) },
+                       bufferRect });
+        bounds = source->sourceType() == CaptureSource::Surface
+            ? bufferRect
+            : source->cropRect().intersected(bufferRect);
+    }
+    if (parts.isEmpty()) {
         qCWarning(treelandCapture) << "Source has been invalid while connection still exists.";
         return;
     }
+    // Keep the client's previous frame if nothing changed in the source since then.
+    const QRegion damage = source->takeDamage(bounds);
+    if (damage.isEmpty())
+        return;
+
+    // Copy into the session's own buffers instead of exporting the buffer being scanned
+    // out, so the render loop doesn't depend on how fast the client consumes frames.
+    auto helper = Helper::instance();
+    const bool replacesPending = m_bufferRing->hasPending();
+    if (!m_bufferRing->copy(helper->renderer()->handle(),
+                            helper->allocator()->handle(),
+                            parts,
+                            size,
+                            format,
+                            modifier,
+                            bounds,
+                            damage)) {
+        qCWarning(treelandCapture) << "Failed to copy source into capture buffer.";
+        source->addDamage(damage);
+        return;
+    }
+    m_pacer->frameProduced();
+    if (replacesPending)
+        m_pacer->frameReplaced();
+    m_pendingDamage += damage;
+    m_pendingCursorEmbedded = m_cursorTracker && m_cursorTracker->isEmbedded();
+    if (m_currentFrameData.acked)
+        sendPendingFrame(false);
+}
+
+void CaptureContextV1::sendPendingFrame(bool late)
+{
+    auto source = captureSource();
+    if (!session() || !source)
+        return;
+    auto attribs = m_bufferRing->acquirePending();
+    if (!attribs)
+        return;
     m_currentFrameData = {};
-    dmabuf->get_dmabuf(&m_currentFrameData.attribs);
+    m_currentFrameData.attribs = *attribs;
 
     union
     {
@@ -306,15 +510,21 @@ void CaptureContextV1::handleRenderEnd()
         };
     } modifierUnion(m_currentFrameData.attribs.modifier);
 
-    qCInfo(treelandCapture) << "Session:" << session();
-    qCInfo(treelandCapture) << "Session resource:" << session()->resource;
+    uint32_t flags = TREELAND_CAPTURE_SESSION_V1_FLAGS_TRANSIENT;
+    if (m_pendingCursorEmbedded
+        && wl_resource_get_version(session()->resource)
+            >= TREELAND_CAPTURE_SESSION_V1_FLAGS_CURSOR_EMBEDDED_SINCE_VERSION)
+        flags |= TREELAND_CAPTURE_SESSION_V1_FLAGS_CURSOR_EMBEDDED;
+    m_pendingCursorEmbedded = false;
+
+    // Slots are reused once the client acknowledges the frame.
     treeland_capture_session_v1_send_frame(session()->resource,
                                            source->cropRect().x(),
                                            source->cropRect().y(),
                                            m_currentFrameData.attribs.width,
                                            m_currentFrameData.attribs.height,
                                            0,
-                                           0,
+                                           flags,
                                            m_currentFrameData.attribs.format,
                                            modifierUnion.mod_high,
                                            modifierUnion.mod_low,
@@ -329,13 +539,67 @@ void CaptureContextV1::handleRenderEnd()
                                                 m_currentFrameData.attribs.stride[i],
                                                 i);
     }
+    if (m_pendingDamage.rectCount() > MaxDamageRects)
+        m_pendingDamage = m_pendingDamage.boundingRect();
+    session()->sendDamage(m_pendingDamage);
+    m_pendingDamage = {};
     gettimeofday(&m_currentFrameData.readyAt.tv, nullptr);
     treeland_capture_session_v1_send_ready(session()->resource,
                                            m_currentFrameData.readyAt.tvSecHi,
                                            m_currentFrameData.readyAt.tvSecLo,
                                            m_currentFrameData.readyAt.tvUsec);
+    m_pacer->frameSent(late);
 }
 
+QVariantMap CaptureContextV1::sessionInfo() const
+{
+    const QPointer<treeland_capture_session_v1> session = m_session;
+    if (!session || !m_captureSource)
+        return {};
+    QVariantMap info = m_pacer->stats().toVariantMap();
+    pid_t pid = 0;
+    wl_client_get_credentials(wl_resource_get_client(m_handle->resource), &pid, nullptr, nullptr);
+    info.insert(QStringLiteral("pid"), pid);
+    const auto sourceTypes = QMetaEnum::fromType<CaptureSource::CaptureSourceType>();
+    info.insert(QStringLiteral("sourceType"),
+                QString::fromLatin1(sourceTypes.valueToKey(m_captureSource->sourceType())));
+    info.insert(QStringLiteral("pacingMode"),
+                session->pacingMode == TREELAND_CAPTURE_SESSION_V1_PACING_MODE_FIXED
+                    ? QStringLiteral("fixed")
+                    : QStringLiteral("damage"));
+    info.insert(QStringLiteral("minIntervalUs"), session->minInterval);
+    return info;
+}
+
+class Capture1Adaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.Compositor1.Capture")
+    Q_CLASSINFO("D-Bus Introspection",
+                "  <interface name=\"org.deepin.Compositor1.Capture\">\n"
+                "    <method name=\"SessionStats\">\n"
+                "      <arg direction=\"out\" type=\"av\" name=\"sessions\"/>\n"
+                "    </method>\n"
+                "  </interface>\n"
+                "")
+public:
+    explicit Capture1Adaptor(CaptureManagerV1 *parent)
+        : QDBusAbstractAdaptor(parent)
+    {
+    }
+
+    inline CaptureManagerV1 *parent() const
+    {
+        return static_cast<CaptureManagerV1 *>(QObject::parent());
+    }
+
+public Q_SLOTS:
+    QVariantList SessionStats()
+    {
+        return parent()->sessionStats();
+    }
+};
+
 CaptureManagerV1::CaptureManagerV1(QObject *parent)
     : QObject(parent)
     , m_manager(nullptr)
@@ -402,13 +666,32 @@ void CaptureManagerV1::create(WServer *server)
                         this,
                         &CaptureManagerV1::onCaptureContextSelectSource);
             });
+
+    new Capture1Adaptor(this);
+    if (!QDBusConnection::sessionBus().registerObject(CaptureDBusPath, this)) {
+        qCWarning(treelandCapture) << "Failed to register" << CaptureDBusPath
+                                   << "on the session bus, SessionStats will not be available";
+    }
 }
 
 void CaptureManagerV1::destroy([[maybe_unused]] WServer *server)
 {
+    QDBusConnection::sessionBus().unregisterObject(CaptureDBusPath);
     this->disconnect();
 }
 
+QVariantList CaptureManagerV1::sessionStats() const
+{
+    QVariantList result;
+    const auto contexts = m_captureContextModel->contexts();
+    for (auto context : contexts) {
+        const QVariantMap info = context->sessionInfo();
+        if (!info.isEmpty())
+            result.append(info);
+    }
+    return result;
+}
+
 void CaptureManagerV1::onCaptureContextSelectSource()
 {
     CaptureContextV1 *context = qobject_cast<CaptureContextV1 *>(sender());
@@ -663,13 +946,17 @@ void CaptureSourceSelector::createImage()
                &CaptureSourceSelector::createImage);
     if (m_selectedSource) {
         m_selectedSource->createImage();
-        if (m_selectedSource->imageValid()) {
+        if (m_selectedSource->imageValid() || m_selectedSource->imageCreationFailed()) {
             releaseMaskSurface();
         } else {
             connect(m_selectedSource,
                     &CaptureSource::imageReady,
                     this,
                     &CaptureSourceSelector::releaseMaskSurface);
+            connect(m_selectedSource,
+                    &CaptureSource::imageFailed,
+                    this,
+                    &CaptureSourceSelector::releaseMaskSurface);
         }
     } else {
         releaseMaskSurface();
@@ -743,6 +1030,19 @@ CaptureSourceSurface::CaptureSourceSurface(WSurfaceItemContent *surfaceItemConte
     : CaptureSource(surfaceItemContent, devicePixelRatio, nullptr)
     , m_surfaceItemContent(surfaceItemContent)
 {
+    if (auto surface = surfaceItemContent->surface(); surface && surface->handle()) {
+        auto qwSurface = surface->handle();
+        // Buffer damage is only valid until the next commit, the source may live on the
+        // render thread so read it directly.
+        connect(
+            qwSurface,
+            &qw_surface::notify_commit,
+            this,
+            [this, qwSurface] {
+                addDamage(regionFromPixman(&qwSurface->handle()->buffer_damage));
+            },
+            Qt::DirectConnection);
+    }
 }
 
 qw_buffer *CaptureSourceSurface::internalBuffer()
@@ -773,6 +1073,17 @@ QRect CaptureSourceSurface::cropRect() const
         : QRect{};
 }
 
+bool CaptureSourceSurface::mapFromScene(const QPointF &scenePos, QPointF *framePos) const
+{
+    if (!m_surfaceItemContent)
+        return false;
+    const QPointF pos = m_surfaceItemContent->mapFromScene(scenePos);
+    if (!m_surfaceItemContent->boundingRect().contains(pos))
+        return false;
+    *framePos = pos * m_devicePixelRatio;
+    return true;
+}
+
 QSize CaptureSourceSurface::sourceSize() const
 {
     return m_surfaceItemContent ? (m_surfaceItemContent->size() * m_devicePixelRatio).toSize()
@@ -834,14 +1145,25 @@ void CaptureSourceSelector::mouseReleaseEvent([[maybe_unused]] QMouseEvent *even
 {
     switch (selectionMode()) {
     case SelectionMode::SelectRegion: {
-        auto viewport =
-            m_itemSelector->outputItem()->property("screenViewport").value<WOutputViewport *>();
-        if (viewport) {
-            setSelectedSource(
-                new CaptureSourceRegion(viewport,
-                                        mapRectToItem(viewport, selectionRegion()).toRect()),
-                selectionRegion().toRect());
+        // A selection across outputs becomes one source composited from all of them.
+        CaptureSourceRegion *source = nullptr;
+        const auto outputs = Helper::instance()->rootSurfaceContainer()->outputs();
+        for (auto output : outputs) {
+            auto viewport = output->screenViewport();
+            if (!viewport)
+                continue;
+            const QRect region = mapRectToItem(viewport, selectionRegion())
+                                     .toRect()
+                                     .intersected(viewport->boundingRect().toRect());
+            if (region.isEmpty())
+                continue;
+            if (!source)
+                source = new CaptureSourceRegion(viewport, region);
+            else
+                source->addViewportRegion(viewport, region);
         }
+        if (source)
+            setSelectedSource(source, selectionRegion().toRect());
         // Exit item selection mode after first click
         setItemSelectionMode(false);
         break;
@@ -885,9 +1207,20 @@ void CaptureSourceSelector::handleItemSelectorSelectionRegionChanged()
     setSelectionRegion(m_itemSelector->selectionRegion());
 }
 
+CaptureSource::~CaptureSource()
+{
+    if (m_snapshot)
+        wlr_buffer_drop(m_snapshot);
+}
+
 bool CaptureSource::imageValid() const
 {
-    return !m_image.isNull();
+    return m_snapshot || !m_image.isNull();
+}
+
+bool CaptureSource::imageCreationFailed() const
+{
+    return m_imageCreationFailed;
 }
 
 QImage CaptureSource::image() const
@@ -897,6 +1230,11 @@ QImage CaptureSource::image() const
 
 void CaptureSource::createImage()
 {
+    m_imageCreationFailed = false;
+    if (createSnapshot()) {
+        Q_EMIT imageReady();
+        return;
+    }
     if (m_sourceList.size() == 1 && m_sourceList.first().first) {
         auto grabber = new WTextureCapturer(m_sourceList.first().second, this);
         grabber->grabToImage()
@@ -904,12 +1242,263 @@ void CaptureSource::createImage()
                 m_image = std::move(image);
                 Q_EMIT imageReady();
             })
-            .onFailed([](const std::exception &e) {
+            .onFailed([this](const std::exception &e) {
                 qCCritical(treelandCapture) << e.what();
+                m_imageCreationFailed = true;
+                Q_EMIT imageFailed();
             });
+        return;
+    }
+    if (isComposite()) {
+        qCWarning(treelandCapture) << "Failed to composite" << *this;
+    }
+    m_imageCreationFailed = true;
+    Q_EMIT imageFailed();
+}
+
+uint32_t CaptureSource::shmFormat() const
+{
+    return WTools::drmToShmFormat(m_snapshot ? SnapshotFormat
+                                             : WTools::toDrmFormat(m_image.format()));
+}
+
+bool CaptureSource::createSnapshot()
+{
+    auto helper = Helper::instance();
+    if (!helper->renderer() || !helper->allocator())
+        return false;
+    // Outputs and regions are mapped through the output's transform and scale like the
+    // frames of a session, only surfaces are cropped from their buffer directly.
+    if (sourceType() != Surface) {
+        const auto parts = snapshotParts();
+        const QSize size = cropRect().size();
+        if (parts.isEmpty() || size.isEmpty())
+            return false;
+        wlr_buffer *snapshot = createCaptureBuffer(helper->allocator()->handle(),
+                                                   size,
+                                                   SnapshotFormat,
+                                                   DRM_FORMAT_MOD_INVALID);
+        if (!snapshot || !renderCaptureParts(helper->renderer()->handle(), parts, snapshot)) {
+            if (snapshot)
+                wlr_buffer_drop(snapshot);
+            return false;
+        }
+        if (m_snapshot)
+            wlr_buffer_drop(m_snapshot);
+        m_snapshot = snapshot;
+        return true;
+    }
+    if (m_sourceList.size() != 1 || !m_sourceList.first().first)
+        return false;
+    auto buffer = internalBuffer();
+    if (!buffer)
+        return false;
+    // Surface contents are scaled to the crop size like the texture of the surface item.
+    const QRect sourceRect(0, 0, buffer->handle()->width, buffer->handle()->height);
+    const QSize size = cropRect().size();
+    if (sourceRect.isEmpty() || size.isEmpty())
+        return false;
+
+    wlr_renderer *renderer = helper->renderer()->handle();
+    wlr_texture *texture = wlr_texture_from_buffer(renderer, buffer->handle());
+    if (!texture)
+        return false;
+    wlr_buffer *snapshot = createCaptureBuffer(helper->allocator()->handle(),
+                                               size,
+                                               SnapshotFormat,
+                                               DRM_FORMAT_MOD_INVALID);
+    const bool ok = snapshot
+        && renderCaptureTexture(renderer,
+                                texture,
+                                snapshot,
+                                { double(sourceRect.x()),
+                                  double(sourceRect.y()),
+                                  double(sourceRect.width()),
+                                  double(sourceRect.height()) },
+                                QRect(QPoint(0, 0), size));
+    wlr_texture_destroy(texture);
+    if (!ok) {
+        if (snapshot)
+            wlr_buffer_drop(snapshot);
+        return false;
+    }
+    if (m_snapshot)
+        wlr_buffer_drop(m_snapshot);
+    m_snapshot = snapshot;
+    return true;
+}
+
+bool CaptureSource::copySnapshot(wlr_buffer *target)
+{
+    auto helper = Helper::instance();
+    wlr_renderer *renderer = helper->renderer()->handle();
+    wlr_texture *texture = wlr_texture_from_buffer(renderer, m_snapshot);
+    if (!texture)
+        return false;
+    const QSize snapshotSize(m_snapshot->width, m_snapshot->height);
+    const QRect targetRect(0, 0, target->width, target->height);
+    const wlr_fbox snapshotBox{ 0, 0, double(snapshotSize.width()), double(snapshotSize.height()) };
+
+    bool ok = false;
+    wlr_dmabuf_attributes dmabuf{};
+    if (wlr_buffer_get_dmabuf(target, &dmabuf)) {
+        // Scale and swizzle straight into the client's buffer.
+        ok = renderCaptureTexture(renderer, texture, target, snapshotBox, targetRect);
+    } else if (targetRect.size() == snapshotSize) {
+        // One read back into the client's memory, the renderer converts the format.
+        ok = readCaptureTexture(texture, target);
     } else {
-        // TODO: support multiple sources
+        // Thumbnail into shared memory, scale on the GPU before reading back.
+        wlr_buffer *scaled = createCaptureBuffer(helper->allocator()->handle(),
+                                                 targetRect.size(),
+                                                 SnapshotFormat,
+                                                 DRM_FORMAT_MOD_INVALID);
+        if (scaled && renderCaptureTexture(renderer, texture, scaled, snapshotBox, targetRect)) {
+            if (wlr_texture *scaledTexture = wlr_texture_from_buffer(renderer, scaled)) {
+                ok = readCaptureTexture(scaledTexture, target);
+                wlr_texture_destroy(scaledTexture);
+            }
+        }
+        if (scaled)
+            wlr_buffer_drop(scaled);
+    }
+
+    if (!ok && !dmabuf.n_planes) {
+        // The renderer can't read back in the client's format, read in its preferred
+        // format and convert while copying into the client's memory.
+        const uint32_t readFormat = wlr_texture_preferred_read_format(texture);
+        QImage image(snapshotSize, WTools::toImageFormat(readFormat));
+        if (!image.isNull()) {
+            wlr_texture_read_pixels_options options{};
+            options.data = image.bits();
+            options.format = readFormat;
+            options.stride = static_cast<uint32_t>(image.bytesPerLine());
+            options.src_box = { 0, 0, snapshotSize.width(), snapshotSize.height() };
+            ok = wlr_texture_read_pixels(texture, &options)
+                && paintImage(image, image.rect(), target);
+        }
     }
+    wlr_texture_destroy(texture);
+    return ok;
+}
+
+void CaptureSource::addDamage(const QRegion &region)
+{
+    QMutexLocker locker(&m_damageMutex);
+    if (!m_fullDamage)
+        m_damage += region;
+}
+
+void CaptureSource::damageAll()
+{
+    QMutexLocker locker(&m_damageMutex);
+    m_fullDamage = true;
+    m_damage = {};
+}
+
+bool CaptureSource::hasDamage()
+{
+    QMutexLocker locker(&m_damageMutex);
+    return m_fullDamage || !m_damage.isEmpty();
+}
+
+QRegion CaptureSource::takeDamage(const QRect &bounds)
+{
+    QMutexLocker locker(&m_damageMutex);
+    QRegion damage = m_fullDamage ? QRegion(bounds) : m_damage.intersected(bounds);
+    m_fullDamage = false;
+    m_damage = {};
+    if (damage.rectCount() > MaxDamageRects)
+        damage = damage.boundingRect();
+    return damage;
+}
+
+void CaptureSource::addSceneDamage([[maybe_unused]] const QRectF &sceneRect) { }
+
+bool CaptureSource::isComposite() const
+{
+    return false;
+}
+
+QList<CaptureRenderPart> CaptureSource::compositeParts()
+{
+    return {};
+}
+
+QList<CaptureRenderPart> CaptureSource::snapshotParts()
+{
+    return isComposite() ? compositeParts() : QList<CaptureRenderPart>{};
+}
+
+bool CaptureSource::viewportPart(WOutputViewport *viewport,
+                                 const QRect &region,
+                                 const QRect &targetRect,
+                                 CaptureRenderPart *part)
+{
+    if (!viewport->wTextureProvider())
+        return false;
+    auto buffer = viewport->wTextureProvider()->qwBuffer();
+    if (!buffer)
+        return false;
+    wlr_buffer *handle = buffer->handle();
+
+    // The output's buffer is in its physical orientation, map the region from the
+    // transformed output into the buffer and let the render pass rotate it back.
+    auto transform = WL_OUTPUT_TRANSFORM_NORMAL;
+    if (auto output = viewport->output())
+        transform = output->handle()->handle()->transform;
+    const wlr_box bufferBox =
+        captureOutputBufferBox(scaledRect(region, viewport->devicePixelRatio()).toAlignedRect(),
+                               transform,
+                               QSize(handle->width, handle->height));
+    if (wlr_box_empty(&bufferBox))
+        return false;
+    *part = { handle,
+              { double(bufferBox.x),
+                double(bufferBox.y),
+                double(bufferBox.width),
+                double(bufferBox.height) },
+              targetRect,
+              wlr_output_transform_invert(transform) };
+    return true;
+}
+
+qreal CaptureSource::frameScale() const
+{
+    return m_devicePixelRatio;
+}
+
+QPointF CaptureSource::mapToViewportBuffer(WOutputViewport *viewport, const QPointF &scenePos)
+{
+    const qreal scale = viewport->devicePixelRatio();
+    const QPointF pos = viewport->mapFromScene(scenePos) * scale;
+    auto output = viewport->output();
+    const auto transform =
+        output ? output->handle()->handle()->transform : WL_OUTPUT_TRANSFORM_NORMAL;
+    if (transform == WL_OUTPUT_TRANSFORM_NORMAL)
+        return pos;
+    // Same mapping as the render pass of the output, see CaptureSourceRegion::compositeParts()
+    const QSize size = (viewport->size() * scale).toSize();
+    const wlr_box point{ qFloor(pos.x()), qFloor(pos.y()), 0, 0 };
+    wlr_box mapped{};
+    wlr_box_transform(&mapped,
+                      &point,
+                      wlr_output_transform_invert(transform),
+                      size.width(),
+                      size.height());
+    return QPointF(mapped.x, mapped.y);
+}
+
+void CaptureSource::addViewportDamage(WOutputViewport *viewport, const QRectF &sceneRect)
+{
+    auto output = viewport->output();
+    if (output && output->handle()->handle()->transform != WL_OUTPUT_TRANSFORM_NORMAL) {
+        // The buffer is transformed, don't bother mapping rects into it.
+        damageAll();
+        return;
+    }
+    addDamage(scaledRect(viewport->mapRectFromScene(sceneRect), viewport->devicePixelRatio())
+                  .toAlignedRect());
 }
 
 qw_buffer *CaptureSource::sourceDMABuffer()
@@ -921,23 +1510,12 @@ qw_buffer *CaptureSource::sourceDMABuffer()
     return buffer;
 }
 
-void CaptureSource::copyBuffer(qw_buffer *buffer)
+bool CaptureSource::copyBuffer(qw_buffer *buffer)
 {
     Q_ASSERT(imageValid());
-    auto width = cropRect().width();
-    auto height = cropRect().height();
-    uint32_t format;
-    size_t stride;
-    void *data;
-    buffer->begin_data_ptr_access(WLR_BUFFER_DATA_PTR_ACCESS_WRITE, &data, &format, &stride);
-    Q_ASSERT(stride == static_cast<size_t>(width) * 4); // For QImage
-    QImage img = image().copy(cropRect());
-    auto bufFormat = WTools::toImageFormat(format);
-    if (image().format() != bufFormat) {
-        img = image().convertToFormat(bufFormat);
-    }
-    memcpy(data, img.constBits(), stride * height);
-    buffer->end_data_ptr_access();
+    if (m_snapshot)
+        return copySnapshot(buffer->handle());
+    return paintImage(image(), cropRect(), buffer->handle());
 }
 
 CaptureSourceOutput::CaptureSourceOutput(WOutputViewport *viewport)
@@ -973,6 +1551,33 @@ CaptureSource::CaptureSourceType CaptureSourceOutput::sourceType()
     return CaptureSource::Output;
 }
 
+void CaptureSourceOutput::addSceneDamage(const QRectF &sceneRect)
+{
+    if (m_outputViewport)
+        addViewportDamage(m_outputViewport, sceneRect);
+}
+
+QList<CaptureRenderPart> CaptureSourceOutput::snapshotParts()
+{
+    CaptureRenderPart part;
+    if (!m_outputViewport
+        || !viewportPart(m_outputViewport,
+                         m_outputViewport->boundingRect().toAlignedRect(),
+                         QRect(QPoint(0, 0), cropRect().size()),
+                         &part))
+        return {};
+    return { part };
+}
+
+bool CaptureSourceOutput::mapFromScene(const QPointF &scenePos, QPointF *framePos) const
+{
+    if (!m_outputViewport
+        || !m_outputViewport->boundingRect().contains(m_outputViewport->mapFromScene(scenePos)))
+        return false;
+    *framePos = mapToViewportBuffer(m_outputViewport, scenePos);
+    return true;
+}
+
 CaptureSourceRegion::CaptureSourceRegion(WOutputViewport *viewport, const QRect &region)
     : CaptureSource(viewport, viewport->devicePixelRatio(), nullptr)
 {
@@ -994,59 +1599,135 @@ CaptureSource::CaptureSourceType CaptureSourceRegion::sourceType()
     return CaptureSource::Region;
 }
 
-QRect CaptureSourceRegion::cropRect() const
+void CaptureSourceRegion::addSceneDamage(const QRectF &sceneRect)
 {
-    QRect result{};
-    WOutputViewport *ref = nullptr;
+    if (isComposite()) {
+        const QRectF compositeRect = compositeSceneRect();
+        const QRectF rect =
+            sceneRect.intersected(compositeRect).translated(-compositeRect.topLeft());
+        addDamage(scaledRect(rect, compositeScale()).toAlignedRect());
+        return;
+    }
+    // The exported buffer belongs to the first target, see internalBuffer()
+    if (auto viewport = qobject_cast<WOutputViewport *>(m_sourceList.first().first))
+        addViewportDamage(viewport, sceneRect);
+}
+
+bool CaptureSourceRegion::isComposite() const
+{
+    int count = 0;
+    for (const auto &[viewport, region] : std::as_const(m_viewportRegions)) {
+        if (viewport)
+            ++count;
+    }
+    return count > 1;
+}
+
+QRectF CaptureSourceRegion::compositeSceneRect() const
+{
+    QRectF result;
+    for (const auto &[viewport, region] : std::as_const(m_viewportRegions)) {
+        if (viewport)
+            result |= viewport->mapRectToScene(QRectF(region));
+    }
+    return result;
+}
+
+qreal CaptureSourceRegion::compositeScale() const
+{
+    // Render at the highest density so no output loses detail.
+    qreal scale = 0;
+    for (const auto &[viewport, region] : std::as_const(m_viewportRegions)) {
+        if (viewport)
+            scale = qMax(scale, viewport->devicePixelRatio());
+    }
+    return scale > 0 ? scale : 1.0;
+}
+
+QList<CaptureRenderPart> CaptureSourceRegion::compositeParts()
+{
+    QList<CaptureRenderPart> parts;
+    const QRectF compositeRect = compositeSceneRect();
+    const qreal scale = compositeScale();
     for (const auto &[viewport, region] : std::as_const(m_viewportRegions)) {
         if (!viewport)
             continue;
-        if (!ref) {
-            result = scaledRect(region, viewport->devicePixelRatio()).toRect();
-            ref = viewport;
-        } else {
-            auto mapped =
-                scaledRect(ref->mapRectFromItem(viewport, region), viewport->devicePixelRatio())
-                    .toRect(); // FIXME: firstly map or firstly scale?
-            result = result.united(mapped);
-        }
+        const QRectF targetRect =
+            viewport->mapRectToScene(QRectF(region)).translated(-compositeRect.topLeft());
+        CaptureRenderPart part;
+        if (viewportPart(viewport, region, scaledRect(targetRect, scale).toAlignedRect(), &part))
+            parts.append(part);
     }
-    return result;
+    return parts;
 }
 
-QSize CaptureSourceRegion::sourceSize() const
+QList<CaptureRenderPart> CaptureSourceRegion::snapshotParts()
+{
+    // A single region is a composite of one viewport, this maps it like the render pass.
+    return compositeParts();
+}
+
+qreal CaptureSourceRegion::frameScale() const
 {
-    QRect result{};
-    WOutputViewport *ref = nullptr;
+    if (isComposite())
+        return compositeScale();
+    for (const auto &[viewport, region] : std::as_const(m_viewportRegions)) {
+        if (viewport)
+            return viewport->devicePixelRatio();
+    }
+    return CaptureSource::frameScale();
+}
+
+bool CaptureSourceRegion::mapFromScene(const QPointF &scenePos, QPointF *framePos) const
+{
+    if (isComposite()) {
+        const QRectF compositeRect = compositeSceneRect();
+        if (!compositeRect.contains(scenePos))
+            return false;
+        *framePos = (scenePos - compositeRect.topLeft()) * compositeScale();
+        return true;
+    }
     for (const auto &[viewport, region] : std::as_const(m_viewportRegions)) {
         if (!viewport)
             continue;
-        if (!ref) {
-            result = scaledRect(viewport->boundingRect(), viewport->devicePixelRatio()).toRect();
-            ref = viewport;
-        } else {
-            auto mapped = ref->mapRectFromItem(
-                                 viewport,
-                                 scaledRect(viewport->boundingRect(), viewport->devicePixelRatio()))
-                              .toRect(); // FIXME: firstly map or firstly scale?
-            result = result.united(mapped);
-        }
+        if (!QRectF(region).contains(viewport->mapFromScene(scenePos)))
+            return false;
+        *framePos = mapToViewportBuffer(viewport, scenePos);
+        return true;
+    }
+    return false;
+}
+
+QRect CaptureSourceRegion::cropRect() const
+{
+    if (isComposite())
+        return QRect(QPoint(0, 0), (compositeSceneRect().size() * compositeScale()).toSize());
+    for (const auto &[viewport, region] : std::as_const(m_viewportRegions)) {
+        if (viewport)
+            return scaledRect(region, viewport->devicePixelRatio()).toRect();
+    }
+    return {};
+}
+
+QSize CaptureSourceRegion::sourceSize() const
+{
+    if (isComposite())
+        return cropRect().size();
+    for (const auto &[viewport, region] : std::as_const(m_viewportRegions)) {
+        if (viewport)
+            return (viewport->size() * viewport->devicePixelRatio()).toSize();
     }
-    return result.size();
+    return {};
 }
 
 bool CaptureSourceRegion::addViewportRegion(WOutputViewport *viewport, const QRect &region)
 {
-    auto scenePos = viewport->mapToScene({ 0, 0 });
-    int insertIndex;
-    for (insertIndex = 0; insertIndex < m_viewportRegions.size(); ++insertIndex) {
-        auto &[v, _] = m_viewportRegions[insertIndex];
-        auto vScenePos = v->mapToScene({ 0, 0 });
-        if (vScenePos.x() > scenePos.x()) {
-            break;
-        }
+    for (const auto &[v, _] : std::as_const(m_viewportRegions)) {
+        if (v == viewport)
+            return false;
     }
-    m_viewportRegions.insert(insertIndex, { viewport, region });
+    m_viewportRegions.push_back({ viewport, region });
+    addTarget(viewport);
     return true;
 }
 
@@ -1217,3 +1898,5 @@ void CaptureSourceSelector::releaseMaskSurface()
         }
     }
 }
+
+#include "capture.moc"
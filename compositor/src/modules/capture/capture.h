@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include "modules/capture/capturebufferring.h"
+#include "modules/capture/capturepacer.h"
+#include "modules/capture/capturerender.h"
 #include "modules/capture/impl/capturev1impl.h"
 #include "modules/item-selector/itemselector.h"
 #include "surface/surfacecontainer.h"
@@ -15,11 +18,15 @@
 
 #include <QAbstractListModel>
 #include <QMetaObject>
+#include <QMutex>
 #include <QPainter>
 #include <QPair>
 #include <QPointer>
 #include <QQuickPaintedItem>
 #include <QRect>
+#include <QRegion>
+
+#include <memory>
 
 extern "C" {
 #include <wlr/types/wlr_buffer.h>
@@ -34,6 +41,8 @@ WAYLIB_SERVER_END_NAMESPACE
 WAYLIB_SERVER_USE_NAMESPACE
 class SurfaceWrapper;
 class ItemSelector;
+class CaptureCursorTracker;
+class CaptureDamageTracker;
 
 template<typename T>
 concept IsCaptureSourceTarget =
@@ -73,21 +82,33 @@ public:
                 this,
                 &CaptureSource::targetResized);
     }
+    ~CaptureSource() override;
 
 Q_SIGNALS:
     void imageReady();
+    // createImage() could not produce contents; pending one shot frames must fail.
+    void imageFailed();
     void bufferDestroyed();
     void targetDestroyed();
     void targetResized();
 
 public:
     bool imageValid() const;
+    // The last createImage() failed; imageFailed() has already been emitted.
+    bool imageCreationFailed() const;
 
     // Get an image that is already cropped.
     QImage image() const;
 
+    /**
+     * @brief createImage snapshot contents of the source for one shot captures. Contents
+     * are kept on the GPU if the renderer allows it, otherwise they are read back to image().
+     */
     void createImage();
 
+    // Shm format of the buffer announced to one shot capture clients
+    uint32_t shmFormat() const;
+
     /**
      * @brief DMA buffer of source, there are three cases
      * 1. output - output's dma buffer
@@ -99,10 +120,12 @@ public:
     qw_buffer *sourceDMABuffer();
 
     /**
-     * @brief copyBuffer render captured contents to a buffer
+     * @brief copyBuffer render captured contents to a buffer, contents are scaled if the
+     * buffer size differs from the size of cropRect()
      * @param buffer buffer prepared by client
+     * @return false if the contents can't be copied into the buffer
      */
-    void copyBuffer(qw_buffer *buffer);
+    bool copyBuffer(qw_buffer *buffer);
 
     // Cropped area of source
     virtual QRect cropRect() const = 0;
@@ -112,8 +135,42 @@ public:
 
     virtual CaptureSourceType sourceType() = 0;
 
+    /**
+     * @brief Damage accumulated since the last takeDamage(), in coordinates of the
+     * buffer returned by sourceDMABuffer(). These functions are thread safe.
+     */
+    void addDamage(const QRegion &region);
+    void damageAll();
+    QRegion takeDamage(const QRect &bounds);
+    bool hasDamage();
+
+    // Maps damage of the scene into buffer coordinates, used by CaptureDamageTracker
+    virtual void addSceneDamage(const QRectF &sceneRect);
+
+    /**
+     * @brief A composite source has no buffer of its own, its frames are rendered from
+     * the buffers of several targets into a buffer of cropRect() size. Damage and
+     * cropRect() of a composite source are in coordinates of that buffer.
+     */
+    virtual bool isComposite() const;
+    virtual QList<CaptureRenderPart> compositeParts();
+    // Parts a one shot snapshot of an output or region is rendered from
+    virtual QList<CaptureRenderPart> snapshotParts();
+
+    // Pixels of a frame per logical pixel of the scene
+    virtual qreal frameScale() const;
+    // Maps a scene position into buffer coordinates of the frames, false if it's outside
+    virtual bool mapFromScene(const QPointF &scenePos, QPointF *framePos) const = 0;
+
 protected:
     virtual qw_buffer *internalBuffer() = 0;
+    void addViewportDamage(WOutputViewport *viewport, const QRectF &sceneRect);
+    static QPointF mapToViewportBuffer(WOutputViewport *viewport, const QPointF &scenePos);
+    // Part for region of viewport, in its logical coordinates, rendered into targetRect
+    static bool viewportPart(WOutputViewport *viewport,
+                             const QRect &region,
+                             const QRect &targetRect,
+                             CaptureRenderPart *part);
 
     template<IsCaptureSourceTarget T>
     void addTarget(T *target)
@@ -136,9 +193,19 @@ protected:
 
     friend QDebug operator<<(QDebug debug, CaptureSource &captureSource);
     QImage m_image;
+    // Cropped contents of the source kept on the GPU, replaces m_image if valid
+    wlr_buffer *m_snapshot{ nullptr };
+    bool m_imageCreationFailed{ false };
     QMetaObject::Connection m_bufferConn;
     QList<QPair<QPointer<QQuickItem>, WTextureProviderProvider *>> m_sourceList;
     qreal m_devicePixelRatio;
+    QMutex m_damageMutex;
+    QRegion m_damage;
+    bool m_fullDamage{ true };
+
+private:
+    bool createSnapshot();
+    bool copySnapshot(wlr_buffer *target);
 };
 
 #define CaptureSource_iid "org.deepin.treeland.CaptureSource"
@@ -163,6 +230,11 @@ public:
     void addContext(CaptureContextV1 *context);
     void removeContext(CaptureContextV1 *context);
 
+    const QList<CaptureContextV1 *> &contexts() const
+    {
+        return m_captureContexts;
+    }
+
 private:
     QList<CaptureContextV1 *> m_captureContexts;
 };
@@ -228,6 +300,9 @@ public:
         return m_captureRegion;
     }
 
+    // Owner, pacing and stats of the session, empty without a session
+    QVariantMap sessionInfo() const;
+
 Q_SIGNALS:
     void sourceChanged();
     void finishSelect();
@@ -241,6 +316,9 @@ private:
     void handleSessionStart();
     void handleFrameDone(uint32_t tvSecHi, uint32_t tvSecLo, uint32_t tvUsec);
     void handleRenderEnd();
+    // Late if the frame had to wait for the client to acknowledge the previous one
+    void sendPendingFrame(bool late);
+    void handleCursorModeChanged();
 
     void ensureSourceSessionConnection();
     void handleSourceDestroyed();
@@ -249,7 +327,15 @@ private:
     CaptureSource *m_captureSource{ nullptr };
     QPointer<treeland_capture_frame_v1> m_frame{ nullptr };
     QPointer<treeland_capture_session_v1> m_session{ nullptr };
+    CaptureDamageTracker *m_damageTracker{ nullptr };
+    CaptureCursorTracker *m_cursorTracker{ nullptr };
+    std::unique_ptr<CaptureBufferRing> m_bufferRing;
+    // Damage of the pending frame relative to the last frame sent to the client
+    QRegion m_pendingDamage;
+    // The software cursor was rendered into the pending frame, only in metadata mode
+    bool m_pendingCursorEmbedded{ false };
     const QPointer<WOutputRenderWindow> m_outputRenderWindow;
+    CaptureFramePacer *const m_pacer;
     FrameData m_currentFrameData{};
     QRect m_captureRegion;
 };
@@ -288,6 +374,8 @@ public:
     QPointer<WToplevelSurface> maskShellSurface() const;
     QPointer<SurfaceWrapper> maskSurfaceWrapper() const;
     void clearContextInSelection(CaptureContextV1 *context);
+    // CaptureContextV1::sessionInfo() of all sessions, also exported on D-Bus
+    Q_INVOKABLE QVariantList sessionStats() const;
 Q_SIGNALS:
     void contextInSelectionChanged();
     void newCaptureContext(CaptureContextV1 *context);
@@ -323,6 +411,7 @@ public:
     CaptureSourceType sourceType() override;
     QRect cropRect() const override;
     QSize sourceSize() const override;
+    bool mapFromScene(const QPointF &scenePos, QPointF *framePos) const override;
 
 private:
     const QPointer<WSurfaceItemContent> m_surfaceItemContent;
@@ -337,6 +426,9 @@ public:
     CaptureSourceType sourceType() override;
     QRect cropRect() const override;
     QSize sourceSize() const override;
+    void addSceneDamage(const QRectF &sceneRect) override;
+    QList<CaptureRenderPart> snapshotParts() override;
+    bool mapFromScene(const QPointF &scenePos, QPointF *framePos) const override;
 
 private:
     const QPointer<WOutputViewport> m_outputViewport;
@@ -351,9 +443,20 @@ public:
     CaptureSourceType sourceType() override;
     QRect cropRect() const override;
     QSize sourceSize() const override;
+    void addSceneDamage(const QRectF &sceneRect) override;
+    bool isComposite() const override;
+    QList<CaptureRenderPart> compositeParts() override;
+    QList<CaptureRenderPart> snapshotParts() override;
+    qreal frameScale() const override;
+    bool mapFromScene(const QPointF &scenePos, QPointF *framePos) const override;
     bool addViewportRegion(WOutputViewport *viewport, const QRect &region);
 
 private:
+    // Bounds of all regions in the scene and the scale they are composited with
+    QRectF compositeSceneRect() const;
+    qreal compositeScale() const;
+
+    // Regions are in coordinates of their viewport
     QList<QPair<QPointer<WOutputViewport>, QRect>> m_viewportRegions;
 };
 class ToolBarModel;
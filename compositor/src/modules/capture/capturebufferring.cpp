@@ -0,0 +1,151 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "capturebufferring.h"
+
+#include "common/treelandlogging.h"
+
+#include <QLoggingCategory>
+
+extern "C" {
+#include <wlr/types/wlr_buffer.h>
+}
+
+CaptureBufferRing::CaptureBufferRing(int slotCount)
+    : m_slotCount(qBound(MinSlotCount, slotCount, MaxSlotCount))
+{
+}
+
+CaptureBufferRing::~CaptureBufferRing()
+{
+    // The client keeps its own references to the dmabuf through the fds it received.
+    for (auto &slot : m_slots)
+        destroySlot(slot);
+}
+
+bool CaptureBufferRing::copy(wlr_renderer *renderer,
+                             wlr_allocator *allocator,
+                             const QList<CaptureRenderPart> &parts,
+                             const QSize &size,
+                             uint32_t format,
+                             uint64_t modifier,
+                             const QRect &bounds,
+                             const QRegion &damage)
+{
+    if (parts.isEmpty() || size.isEmpty())
+        return false;
+
+    if (size != m_size || format != m_format || modifier != m_modifier) {
+        clear();
+        m_size = size;
+        m_format = format;
+        m_modifier = modifier;
+    }
+
+    for (auto &slot : m_slots) {
+        if (slot.buffer && !slot.obsolete)
+            slot.stale += damage;
+    }
+
+    Slot *target = targetSlot();
+    if (!target || (!target->buffer && !allocate(*target, allocator)))
+        return false;
+
+    const QRegion region = target->stale.intersected(bounds);
+    if (!region.isEmpty() && !renderCaptureParts(renderer, parts, target->buffer, region))
+        return false;
+    target->stale -= bounds;
+
+    for (auto &slot : m_slots) {
+        if (&slot != target && slot.state == SlotState::Pending)
+            slot.state = SlotState::Free;
+    }
+    target->state = SlotState::Pending;
+    return true;
+}
+
+bool CaptureBufferRing::hasPending() const
+{
+    for (const auto &slot : m_slots) {
+        if (slot.state == SlotState::Pending)
+            return true;
+    }
+    return false;
+}
+
+const wlr_dmabuf_attributes *CaptureBufferRing::acquirePending()
+{
+    for (auto &slot : m_slots) {
+        if (slot.state == SlotState::Pending) {
+            slot.state = SlotState::Acquired;
+            return &slot.attribs;
+        }
+    }
+    return nullptr;
+}
+
+void CaptureBufferRing::release()
+{
+    for (auto &slot : m_slots) {
+        if (slot.state != SlotState::Acquired)
+            continue;
+        if (slot.obsolete)
+            destroySlot(slot);
+        else
+            slot.state = SlotState::Free;
+    }
+}
+
+void CaptureBufferRing::clear()
+{
+    for (auto &slot : m_slots) {
+        if (slot.state == SlotState::Acquired)
+            slot.obsolete = true;
+        else
+            destroySlot(slot);
+    }
+}
+
+CaptureBufferRing::Slot *CaptureBufferRing::targetSlot()
+{
+    Slot *empty = nullptr;
+    Slot *pending = nullptr;
+    for (int i = 0; i < m_slotCount; ++i) {
+        Slot &slot = m_slots[i];
+        if (slot.obsolete)
+            continue;
+        if (!slot.buffer) {
+            if (!empty)
+                empty = &slot;
+        } else if (slot.state == SlotState::Free) {
+            return &slot;
+        } else if (slot.state == SlotState::Pending) {
+            pending = &slot;
+        }
+    }
+    // Prefer growing the ring over overwriting the pending frame.
+    return empty ? empty : pending;
+}
+
+bool CaptureBufferRing::allocate(Slot &slot, wlr_allocator *allocator)
+{
+    wlr_buffer *buffer = createCaptureBuffer(allocator, m_size, m_format, m_modifier);
+    if (!buffer)
+        return false;
+    if (!wlr_buffer_get_dmabuf(buffer, &slot.attribs)) {
+        qCWarning(treelandCapture) << "Capture buffer is not a dmabuf, allocator can't be used.";
+        wlr_buffer_drop(buffer);
+        return false;
+    }
+    slot.buffer = buffer;
+    slot.state = SlotState::Free;
+    slot.stale = QRect(QPoint(0, 0), m_size);
+    return true;
+}
+
+void CaptureBufferRing::destroySlot(Slot &slot)
+{
+    if (slot.buffer)
+        wlr_buffer_drop(slot.buffer);
+    slot = {};
+}
@@ -0,0 +1,87 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "modules/capture/capturerender.h"
+
+#include <QRegion>
+#include <QSize>
+
+#include <array>
+
+extern "C" {
+#include <wlr/render/dmabuf.h>
+}
+
+struct wlr_allocator;
+struct wlr_buffer;
+struct wlr_renderer;
+
+/**
+ * @brief CaptureBufferRing is a small ring of dmabufs owned by a capture session
+ *
+ * Every new frame is copied on the GPU into a free slot, only the area that changed since
+ * the slot was last written is copied. The copied frame waits as the pending slot until the
+ * client has released the slot it holds, a newer frame replaces the pending one. So the
+ * render loop never waits for the client, the client always receives the newest frame and
+ * never sees the buffers the output scans out.
+ */
+class CaptureBufferRing
+{
+public:
+    static constexpr int MinSlotCount = 2;
+    static constexpr int MaxSlotCount = 4;
+
+    explicit CaptureBufferRing(int slotCount = 3);
+    ~CaptureBufferRing();
+
+    Q_DISABLE_COPY_MOVE(CaptureBufferRing)
+
+    // Renders damage of parts, clipped to bounds, into a slot that becomes the pending one.
+    // Slots are reallocated when size, format or modifier of the frames change.
+    bool copy(wlr_renderer *renderer,
+              wlr_allocator *allocator,
+              const QList<CaptureRenderPart> &parts,
+              const QSize &size,
+              uint32_t format,
+              uint64_t modifier,
+              const QRect &bounds,
+              const QRegion &damage);
+
+    bool hasPending() const;
+    // Hands the pending slot over to the client, nullptr if there is none.
+    const wlr_dmabuf_attributes *acquirePending();
+    // The client is done with the slot handed over by acquirePending().
+    void release();
+    void clear();
+
+private:
+    enum class SlotState
+    {
+        Free,
+        Pending,
+        Acquired,
+    };
+
+    struct Slot
+    {
+        wlr_buffer *buffer{ nullptr };
+        wlr_dmabuf_attributes attribs{};
+        SlotState state{ SlotState::Free };
+        // Area that is not up to date with the source.
+        QRegion stale;
+        // Format changed while the client held the slot, destroy it once released.
+        bool obsolete{ false };
+    };
+
+    Slot *targetSlot();
+    bool allocate(Slot &slot, wlr_allocator *allocator);
+    static void destroySlot(Slot &slot);
+
+    const int m_slotCount;
+    std::array<Slot, MaxSlotCount> m_slots;
+    QSize m_size;
+    uint32_t m_format{ 0 };
+    uint64_t m_modifier{ 0 };
+};
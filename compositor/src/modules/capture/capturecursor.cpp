@@ -0,0 +1,185 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "capturecursor.h"
+
+#include "common/treelandlogging.h"
+#include "core/rootsurfacecontainer.h"
+#include "modules/capture/capture.h"
+#include "output/output.h"
+#include "seat/helper.h"
+
+#include <private/qquickitem_p.h>
+#include <private/qquickwindow_p.h>
+
+#include <wcursor.h>
+#include <woutputitem.h>
+#include <woutputlayer.h>
+#include <woutputrenderwindow.h>
+#include <woutputviewport.h>
+#include <wquickcursor.h>
+
+#include <QLoggingCategory>
+#include <QQuickItemGrabResult>
+
+// Changes of a cursor item that change what the cursor looks like
+static constexpr quint32 ShapeDirtyMask = QQuickItemPrivate::Content | QQuickItemPrivate::Size;
+
+CaptureCursorTracker::CaptureCursorTracker(WOutputRenderWindow *renderWindow,
+                                           CaptureSource *source,
+                                           QObject *parent)
+    : QObject(parent)
+    , m_renderWindow(renderWindow)
+    , m_source(source)
+{
+    // Dirty items are cleaned while syncing, so they must be read right before it.
+    connect(renderWindow,
+            &QQuickWindow::beforeSynchronizing,
+            this,
+            &CaptureCursorTracker::collectDirtyItems,
+            Qt::DirectConnection);
+    connect(Helper::instance()->rootSurfaceContainer()->cursor(),
+            &WCursor::positionChanged,
+            this,
+            &CaptureCursorTracker::update);
+    // Report the current state even if the cursor doesn't move.
+    QMetaObject::invokeMethod(this, &CaptureCursorTracker::update, Qt::QueuedConnection);
+}
+
+bool CaptureCursorTracker::isEmbedded() const
+{
+    // Surfaces are captured from their own buffers, the cursor is never part of them.
+    if (!m_source || m_source->sourceType() == CaptureSource::Surface)
+        return false;
+    auto cursor = currentCursor();
+    if (!cursor)
+        return false;
+    const QPointF scenePos = Helper::instance()->rootSurfaceContainer()->cursor()->position();
+    QPointF framePos;
+    if (!m_source->mapFromScene(scenePos, &framePos))
+        return false;
+    const auto outputs = Helper::instance()->rootSurfaceContainer()->outputs();
+    for (auto output : outputs) {
+        auto viewport = output->screenViewport();
+        if (!viewport)
+            continue;
+        const auto layers = viewport->hardwareLayers();
+        for (auto layer : layers) {
+            if (layer->parent() == cursor)
+                return false;
+        }
+    }
+    return true;
+}
+
+void CaptureCursorTracker::collectDirtyItems()
+{
+    if (!m_renderWindow)
+        return;
+    bool cursorDirty = false;
+    auto wd = QQuickWindowPrivate::get(m_renderWindow);
+    for (QQuickItem *item = wd->dirtyItemList; item;
+         item = QQuickItemPrivate::get(item)->nextDirtyItem) {
+        for (QQuickItem *it = item; it; it = it->parentItem()) {
+            auto cursor = qobject_cast<WQuickCursor *>(it);
+            if (!cursor)
+                continue;
+            cursorDirty = true;
+            if (cursor == m_cursor
+                && (QQuickItemPrivate::get(item)->dirtyAttributes & ShapeDirtyMask))
+                m_shapeDirty = true;
+            break;
+        }
+    }
+    // Grabbing the image can't happen while the scene is being synchronized.
+    if (cursorDirty && !m_updateScheduled) {
+        m_updateScheduled = true;
+        QMetaObject::invokeMethod(
+            this,
+            [this] {
+                m_updateScheduled = false;
+                update();
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+void CaptureCursorTracker::update()
+{
+    if (!m_source)
+        return;
+    auto cursor = currentCursor();
+    if (cursor != m_cursor) {
+        m_cursor = cursor;
+        m_shapeDirty = true;
+    }
+
+    const QPointF scenePos = Helper::instance()->rootSurfaceContainer()->cursor()->position();
+    QPointF framePos;
+    if (!m_cursor || !m_source->mapFromScene(scenePos, &framePos)) {
+        if (m_inside) {
+            m_inside = false;
+            Q_EMIT left();
+        }
+        return;
+    }
+
+    if (m_shapeDirty)
+        grabImage();
+    // Positions refer to an image, the first one is still being grabbed.
+    if (!m_serial)
+        return;
+    const QPoint position = framePos.toPoint();
+    if (m_inside && position == m_position && m_positionSerial == m_serial)
+        return;
+    m_inside = true;
+    m_position = position;
+    m_positionSerial = m_serial;
+    Q_EMIT positionChanged(m_serial, position);
+}
+
+void CaptureCursorTracker::grabImage()
+{
+    m_shapeDirty = false;
+    const qreal scale = m_source->frameScale();
+    const QSize size = (m_cursor->size() * scale).toSize();
+    if (size.isEmpty())
+        return;
+    auto grab = m_cursor->grabToImage(size);
+    if (!grab) {
+        qCWarning(treelandCapture) << "Failed to grab cursor image.";
+        return;
+    }
+    // Replacing a grab still in flight drops it together with its connection.
+    m_grab = grab;
+    const QPoint hotspot = (m_cursor->hotSpot() * scale).toPoint();
+    connect(grab.data(),
+            &QQuickItemGrabResult::ready,
+            this,
+            [this, result = grab.data(), hotspot] {
+                if (m_grab.data() != result)
+                    return;
+                const QImage image = result->image();
+                m_grab.reset();
+                Q_EMIT imageChanged(++m_serial, image, hotspot);
+                update();
+            });
+}
+
+WQuickCursor *CaptureCursorTracker::currentCursor() const
+{
+    auto root = Helper::instance()->rootSurfaceContainer();
+    const QPointF scenePos = root->cursor()->position();
+    const auto outputs = root->outputs();
+    for (auto output : outputs) {
+        auto outputItem = output->outputItem();
+        if (!outputItem || !outputItem->contains(outputItem->mapFromScene(scenePos)))
+            continue;
+        const auto cursors = outputItem->cursorItems();
+        for (auto cursor : cursors) {
+            if (cursor->isVisible())
+                return cursor;
+        }
+    }
+    return nullptr;
+}
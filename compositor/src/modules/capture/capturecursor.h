@@ -0,0 +1,67 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <wglobal.h>
+
+#include <QImage>
+#include <QObject>
+#include <QPoint>
+#include <QPointer>
+#include <QSharedPointer>
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+class WOutputRenderWindow;
+class WQuickCursor;
+WAYLIB_SERVER_END_NAMESPACE
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+class QQuickItemGrabResult;
+class CaptureSource;
+
+/**
+ * @brief CaptureCursorTracker reports the cursor of a source as metadata
+ *
+ * The position is followed through the seat's cursor and mapped into the frames of the
+ * source. The image of the cursor item is only grabbed again when its contents, size or
+ * hotspot change, every image gets a new serial that following positions refer to.
+ * A cursor the compositor has to render in software is still part of the captured
+ * buffers, isEmbedded() tells when frames carry it.
+ */
+class CaptureCursorTracker : public QObject
+{
+    Q_OBJECT
+public:
+    CaptureCursorTracker(WOutputRenderWindow *renderWindow,
+                         CaptureSource *source,
+                         QObject *parent = nullptr);
+
+    // Whether the cursor is currently rendered into the frames of the source, i.e. it's
+    // visible inside the source and not shown on a hardware plane.
+    bool isEmbedded() const;
+
+Q_SIGNALS:
+    void imageChanged(uint32_t serial, const QImage &image, const QPoint &hotspot);
+    void positionChanged(uint32_t serial, const QPoint &position);
+    void left();
+
+private:
+    void collectDirtyItems();
+    void update();
+    void grabImage();
+    WQuickCursor *currentCursor() const;
+
+    QPointer<WOutputRenderWindow> m_renderWindow;
+    QPointer<CaptureSource> m_source;
+    QPointer<WQuickCursor> m_cursor;
+    QSharedPointer<QQuickItemGrabResult> m_grab;
+    // Serial of the last image sent, 0 before the first one
+    uint32_t m_serial{ 0 };
+    uint32_t m_positionSerial{ 0 };
+    QPoint m_position;
+    bool m_shapeDirty{ true };
+    bool m_inside{ false };
+    bool m_updateScheduled{ false };
+};
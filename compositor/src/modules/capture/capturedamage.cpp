@@ -0,0 +1,210 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "capturedamage.h"
+
+#include "core/rootsurfacecontainer.h"
+#include "modules/capture/capture.h"
+#include "output/output.h"
+#include "seat/helper.h"
+
+#include <private/qquickitem_p.h>
+#include <private/qquickwindow_p.h>
+
+#include <woutputlayer.h>
+#include <woutputrenderwindow.h>
+#include <woutputviewport.h>
+#include <wquickcursor.h>
+#include <wsurface.h>
+#include <wsurfaceitem.h>
+
+#include <qwcompositor.h>
+
+// Changes that can't be bounded by the old and new bounds of the item itself.
+static constexpr quint32 FullDamageMask = QQuickItemPrivate::ParentChanged
+    | QQuickItemPrivate::Window | QQuickItemPrivate::EffectReference
+    | QQuickItemPrivate::HideReference;
+
+static constexpr quint32 GeometryDamageMask = QQuickItemPrivate::TransformOrigin
+    | QQuickItemPrivate::Transform | QQuickItemPrivate::BasicTransform
+    | QQuickItemPrivate::Position | QQuickItemPrivate::Size | QQuickItemPrivate::ZValue
+    | QQuickItemPrivate::OpacityValue | QQuickItemPrivate::ChildrenChanged
+    | QQuickItemPrivate::ChildrenStackingChanged | QQuickItemPrivate::Clip
+    | QQuickItemPrivate::Visible;
+
+static QRectF subtreeSceneRect(QQuickItem *item)
+{
+    if (!item->isVisible())
+        return {};
+    QRectF rect = item->mapRectToScene(item->boundingRect());
+    const auto children = item->childItems();
+    for (auto child : children)
+        rect |= subtreeSceneRect(child);
+    return rect;
+}
+
+CaptureDamageTracker::CaptureDamageTracker(WOutputRenderWindow *renderWindow,
+                                           CaptureSource *source,
+                                           QObject *parent)
+    : QObject(parent)
+    , m_renderWindow(renderWindow)
+    , m_source(source)
+{
+    // Dirty items are cleaned while syncing, so they must be read right before it.
+    connect(renderWindow,
+            &QQuickWindow::beforeSynchronizing,
+            this,
+            &CaptureDamageTracker::collectDirtyItems,
+            Qt::DirectConnection);
+    // A cursor moving between a hardware plane and the buffer changes the buffer
+    // without dirtying any item.
+    const auto outputs = Helper::instance()->rootSurfaceContainer()->outputs();
+    for (auto output : outputs) {
+        if (auto viewport = output->screenViewport()) {
+            connect(viewport,
+                    &WOutputViewport::hardwareLayersChanged,
+                    source,
+                    &CaptureSource::damageAll);
+        }
+    }
+}
+
+void CaptureDamageTracker::collectDirtyItems()
+{
+    if (!m_renderWindow || !m_source)
+        return;
+    bool fullDamage = false;
+    auto wd = QQuickWindowPrivate::get(m_renderWindow);
+    for (QQuickItem *item = wd->dirtyItemList; item;
+         item = QQuickItemPrivate::get(item)->nextDirtyItem) {
+        // Keep walking after a full damage so the bounds of the other items stay known.
+        if (!damageItem(item))
+            fullDamage = true;
+    }
+    if (fullDamage)
+        m_source->damageAll();
+}
+
+bool CaptureDamageTracker::damageItem(QQuickItem *item)
+{
+    if (isHardwareCursor(item))
+        return true;
+    const quint32 dirty = QQuickItemPrivate::get(item)->dirtyAttributes;
+    if (dirty & FullDamageMask) {
+        recordItem(item, subtreeSceneRect(item));
+        return false;
+    }
+
+    if (dirty & GeometryDamageMask) {
+        const QRectF newRect = subtreeSceneRect(item);
+        const auto it = m_itemRects.constFind(item);
+        const bool known = it != m_itemRects.cend();
+        if (known) {
+            QQuickItem *parent = item->parentItem();
+            const QRectF oldRect = parent ? parent->mapRectToScene(*it) : *it;
+            m_source->addSceneDamage(oldRect | newRect);
+        }
+        recordItem(item, newRect);
+        return known;
+    }
+
+    if ((dirty & QQuickItemPrivate::Content) && item->isVisible()) {
+        if (qobject_cast<WSurfaceItemContent *>(item))
+            damageSurfaceContent(item);
+        else
+            m_source->addSceneDamage(item->mapRectToScene(item->boundingRect()));
+    }
+    return true;
+}
+
+bool CaptureDamageTracker::isHardwareCursor(QQuickItem *item) const
+{
+    WQuickCursor *cursor = nullptr;
+    for (; item && !cursor; item = item->parentItem())
+        cursor = qobject_cast<WQuickCursor *>(item);
+    if (!cursor)
+        return false;
+    const auto outputs = Helper::instance()->rootSurfaceContainer()->outputs();
+    for (auto output : outputs) {
+        auto viewport = output->screenViewport();
+        if (!viewport)
+            continue;
+        const auto layers = viewport->hardwareLayers();
+        for (auto layer : layers) {
+            if (layer->parent() == cursor)
+                return true;
+        }
+    }
+    return false;
+}
+
+void CaptureDamageTracker::damageSurfaceContent(QQuickItem *item)
+{
+    const QRectF itemRect = item->mapRectToScene(item->boundingRect());
+    WSurface *surface = static_cast<WSurfaceItemContent *>(item)->surface();
+    if (!surface || !surface->handle()) {
+        m_source->addSceneDamage(itemRect);
+        return;
+    }
+
+    wlr_surface *handle = surface->handle()->handle();
+    const auto &current = handle->current;
+    const auto last = m_commitSeqs.constFind(item);
+    // Buffer damage only describes the latest commit, it's useless if commits were missed.
+    const bool singleCommit = last != m_commitSeqs.cend() && current.seq == *last + 1;
+    m_commitSeqs.insert(item, current.seq);
+    trackItem(item);
+
+    if (!singleCommit || current.transform != WL_OUTPUT_TRANSFORM_NORMAL
+        || current.viewport.has_src || current.buffer_width <= 0 || current.buffer_height <= 0) {
+        m_source->addSceneDamage(itemRect);
+        return;
+    }
+
+    const qreal scaleX = item->width() / current.buffer_width;
+    const qreal scaleY = item->height() / current.buffer_height;
+    int count = 0;
+    const pixman_box32_t *boxes = pixman_region32_rectangles(&handle->buffer_damage, &count);
+    for (int i = 0; i < count; ++i) {
+        const QRectF rect(boxes[i].x1 * scaleX,
+                          boxes[i].y1 * scaleY,
+                          (boxes[i].x2 - boxes[i].x1) * scaleX,
+                          (boxes[i].y2 - boxes[i].y1) * scaleY);
+        m_source->addSceneDamage(item->mapRectToScene(rect));
+    }
+}
+
+void CaptureDamageTracker::recordItem(QQuickItem *item, const QRectF &sceneRect)
+{
+    QQuickItem *parent = item->parentItem();
+    m_itemRects.insert(item, parent ? parent->mapRectFromScene(sceneRect) : sceneRect);
+    trackItem(item);
+    if (sceneRect.isEmpty())
+        return;
+
+    // Remembered ancestor bounds must keep covering this subtree, otherwise a later move
+    // of the ancestor would miss the area this item has moved to.
+    for (QQuickItem *ancestor = parent; ancestor; ancestor = ancestor->parentItem()) {
+        auto it = m_itemRects.find(ancestor);
+        if (it == m_itemRects.end())
+            continue;
+        QQuickItem *ancestorParent = ancestor->parentItem();
+        *it |= ancestorParent ? ancestorParent->mapRectFromScene(sceneRect) : sceneRect;
+    }
+}
+
+void CaptureDamageTracker::forgetItem(QObject *item)
+{
+    m_itemRects.remove(item);
+    m_commitSeqs.remove(item);
+}
+
+void CaptureDamageTracker::trackItem(QQuickItem *item)
+{
+    // Direct: the item address must be forgotten before it can be reused.
+    connect(item,
+            &QObject::destroyed,
+            this,
+            &CaptureDamageTracker::forgetItem,
+            static_cast<Qt::ConnectionType>(Qt::DirectConnection | Qt::UniqueConnection));
+}
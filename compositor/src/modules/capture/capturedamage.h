@@ -0,0 +1,60 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <wglobal.h>
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QRectF>
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+class WOutputRenderWindow;
+WAYLIB_SERVER_END_NAMESPACE
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+class QQuickItem;
+class CaptureSource;
+
+/**
+ * @brief CaptureDamageTracker collects scene damage for output and region sources
+ *
+ * Items that are still dirty right before the render window synchronizes its scene
+ * graph are translated into scene rectangles and handed to the source:
+ * 1. surface commits - the client's buffer damage of the commit
+ * 2. other content updates - bounds of the item
+ * 3. geometry, visibility, opacity and children changes - union of the old and new
+ *    bounds of the item's subtree
+ *
+ * Whenever the previous bounds of a changed item are unknown (first change of an item,
+ * reparenting, effect references) the whole source is damaged instead, so damage is
+ * never under-reported. Cursors shown on a hardware plane aren't part of the captured
+ * buffers, their changes are ignored.
+ */
+class CaptureDamageTracker : public QObject
+{
+    Q_OBJECT
+public:
+    CaptureDamageTracker(WOutputRenderWindow *renderWindow,
+                         CaptureSource *source,
+                         QObject *parent = nullptr);
+
+private:
+    void collectDirtyItems();
+    bool damageItem(QQuickItem *item);
+    bool isHardwareCursor(QQuickItem *item) const;
+    void damageSurfaceContent(QQuickItem *item);
+    void recordItem(QQuickItem *item, const QRectF &sceneRect);
+    void forgetItem(QObject *item);
+    void trackItem(QQuickItem *item);
+
+    QPointer<WOutputRenderWindow> m_renderWindow;
+    QPointer<CaptureSource> m_source;
+    // Subtree bounds of items seen dirty before, in coordinates of their parent item.
+    QHash<const QObject *, QRectF> m_itemRects;
+    // Last commit sequence of surface contents seen dirty before.
+    QHash<const QObject *, uint32_t> m_commitSeqs;
+};
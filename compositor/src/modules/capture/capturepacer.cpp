@@ -0,0 +1,109 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "capturepacer.h"
+
+#include <algorithm>
+
+QVariantMap CaptureSessionStats::toVariantMap() const
+{
+    return {
+        { QStringLiteral("delivered"), delivered },
+        { QStringLiteral("skipped"), skipped },
+        { QStringLiteral("late"), late },
+        { QStringLiteral("lastAckLatencyUs"), lastAckLatencyUs },
+        { QStringLiteral("smoothedAckLatencyUs"), smoothedAckLatencyUs },
+        { QStringLiteral("maxAckLatencyUs"), maxAckLatencyUs },
+    };
+}
+
+CaptureFramePacer::CaptureFramePacer(QObject *parent)
+    : QObject(parent)
+    , m_timer(this)
+{
+    m_clock.start();
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &CaptureFramePacer::frameDue);
+}
+
+void CaptureFramePacer::setPacing(Mode mode, std::chrono::microseconds minInterval)
+{
+    m_mode = mode;
+    m_minInterval = std::max(minInterval, std::chrono::microseconds(0));
+    // Apply the new pacing from the next frame on, without waiting for the old interval.
+    m_nextFrameUs = 0;
+    if (m_timer.isActive())
+        m_timer.start(0);
+}
+
+void CaptureFramePacer::reset()
+{
+    m_timer.stop();
+    m_mode = Mode::Damage;
+    m_minInterval = std::chrono::microseconds(0);
+    m_nextFrameUs = 0;
+    m_sentAtUs = -1;
+    QMutexLocker locker(&m_statsMutex);
+    m_stats = {};
+}
+
+bool CaptureFramePacer::tryBeginFrame()
+{
+    const qint64 now = m_clock.nsecsElapsed() / 1000;
+    if (now >= m_nextFrameUs)
+        return true;
+    // Held back damage stays in the source and goes out with the next frame, it isn't
+    // dropped and doesn't count as skipped.
+    if (!m_timer.isActive()) {
+        m_timer.start(std::chrono::ceil<std::chrono::milliseconds>(
+            std::chrono::microseconds(m_nextFrameUs - now)));
+    }
+    return false;
+}
+
+void CaptureFramePacer::frameProduced()
+{
+    const qint64 now = m_clock.nsecsElapsed() / 1000;
+    const qint64 interval = m_minInterval.count();
+    // Stay on the cadence unless the source has been idle for more than an interval.
+    if (m_mode == Mode::Fixed && now - m_nextFrameUs < interval)
+        m_nextFrameUs += interval;
+    else
+        m_nextFrameUs = now + interval;
+}
+
+void CaptureFramePacer::frameReplaced()
+{
+    QMutexLocker locker(&m_statsMutex);
+    ++m_stats.skipped;
+}
+
+void CaptureFramePacer::frameSent(bool late)
+{
+    m_sentAtUs = m_clock.nsecsElapsed() / 1000;
+    QMutexLocker locker(&m_statsMutex);
+    ++m_stats.delivered;
+    if (late)
+        ++m_stats.late;
+}
+
+void CaptureFramePacer::frameAcked()
+{
+    if (m_sentAtUs < 0)
+        return;
+    const qint64 latency = m_clock.nsecsElapsed() / 1000 - m_sentAtUs;
+    m_sentAtUs = -1;
+    QMutexLocker locker(&m_statsMutex);
+    m_stats.lastAckLatencyUs = latency;
+    m_stats.smoothedAckLatencyUs = m_stats.smoothedAckLatencyUs
+        ? (m_stats.smoothedAckLatencyUs * 7 + latency) / 8
+        : latency;
+    m_stats.maxAckLatencyUs = std::max(m_stats.maxAckLatencyUs, latency);
+}
+
+CaptureSessionStats CaptureFramePacer::stats() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    return m_stats;
+}
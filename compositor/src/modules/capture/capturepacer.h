@@ -0,0 +1,83 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QTimer>
+#include <QVariantMap>
+
+#include <chrono>
+
+struct CaptureSessionStats
+{
+    // Frames sent to the client
+    quint64 delivered{ 0 };
+    // Produced frames that were never sent, replaced by a newer frame before the client
+    // was ready
+    quint64 skipped{ 0 };
+    // Frames that had to wait for the client to acknowledge the previous one
+    quint64 late{ 0 };
+    // Time between sending a frame and the client acknowledging it
+    qint64 lastAckLatencyUs{ 0 };
+    // Exponentially weighted (1/8 per sample), not a true mean
+    qint64 smoothedAckLatencyUs{ 0 };
+    qint64 maxAckLatencyUs{ 0 };
+
+    QVariantMap toVariantMap() const;
+};
+
+/**
+ * @brief CaptureFramePacer decides when a capture session may produce its next frame
+ *
+ * A session produces frames only for damage, the pacer additionally keeps them at least
+ * the minimum interval apart. Damage arriving earlier is held back and the pacer emits
+ * frameDue() once the frame may be produced, so the last change is never lost even if the
+ * output stops rendering. In Fixed mode the frames follow a steady cadence instead of the
+ * time the previous frame was produced.
+ *
+ * The pacer lives in the thread of its session, only stats() may be called from others.
+ */
+class CaptureFramePacer : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Mode
+    {
+        Damage,
+        Fixed,
+    };
+
+    explicit CaptureFramePacer(QObject *parent = nullptr);
+
+    void setPacing(Mode mode, std::chrono::microseconds minInterval);
+    // Forgets pacing and stats for a new session.
+    void reset();
+
+    // Whether a damaged frame may be produced now, schedules frameDue() if not.
+    bool tryBeginFrame();
+    void frameProduced();
+    // A produced frame was replaced by a newer one before it was sent.
+    void frameReplaced();
+    void frameSent(bool late);
+    void frameAcked();
+
+    CaptureSessionStats stats() const;
+
+Q_SIGNALS:
+    void frameDue();
+
+private:
+    Mode m_mode{ Mode::Damage };
+    std::chrono::microseconds m_minInterval{ 0 };
+    QElapsedTimer m_clock;
+    // Time the next frame may be produced at, relative to m_clock
+    qint64 m_nextFrameUs{ 0 };
+    qint64 m_sentAtUs{ -1 };
+    QTimer m_timer;
+
+    mutable QMutex m_statsMutex;
+    CaptureSessionStats m_stats;
+};
@@ -0,0 +1,210 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "capturerender.h"
+
+#include "common/treelandlogging.h"
+
+#include <QLoggingCategory>
+#include <QVarLengthArray>
+
+extern "C" {
+#include <drm_fourcc.h>
+#include <wlr/render/allocator.h>
+#include <wlr/render/drm_format_set.h>
+#include <wlr/render/pass.h>
+#include <wlr/render/wlr_renderer.h>
+#include <wlr/render/wlr_texture.h>
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_output.h>
+}
+
+static void initClipRegion(pixman_region32_t *region, const QRegion &clip)
+{
+    pixman_region32_init(region);
+    for (const QRect &rect : clip)
+        pixman_region32_union_rect(region, region, rect.x(), rect.y(), rect.width(), rect.height());
+}
+
+static wlr_scale_filter_mode filterMode(const wlr_fbox &sourceBox,
+                                        const QRect &targetRect,
+                                        wl_output_transform transform)
+{
+    QSize sourceSize(qRound(sourceBox.width), qRound(sourceBox.height));
+    if (transform & WL_OUTPUT_TRANSFORM_90)
+        sourceSize.transpose();
+    return sourceSize == targetRect.size() ? WLR_SCALE_FILTER_NEAREST : WLR_SCALE_FILTER_BILINEAR;
+}
+
+wlr_box captureOutputBufferBox(const QRect &rect,
+                               wl_output_transform transform,
+                               const QSize &bufferSize)
+{
+    QSize outputSize = bufferSize;
+    if (transform & WL_OUTPUT_TRANSFORM_90)
+        outputSize.transpose();
+    const QRect clipped = rect.intersected(QRect(QPoint(0, 0), outputSize));
+    if (clipped.isEmpty())
+        return {};
+    const wlr_box logicalBox{ clipped.x(), clipped.y(), clipped.width(), clipped.height() };
+    wlr_box bufferBox{};
+    wlr_box_transform(&bufferBox,
+                      &logicalBox,
+                      wlr_output_transform_invert(transform),
+                      outputSize.width(),
+                      outputSize.height());
+    return bufferBox;
+}
+
+bool captureBufferFormat(wlr_buffer *buffer, uint32_t *format, uint64_t *modifier)
+{
+    wlr_dmabuf_attributes dmabuf{};
+    wlr_shm_attributes shm{};
+    if (wlr_buffer_get_dmabuf(buffer, &dmabuf)) {
+        *format = dmabuf.format;
+        *modifier = dmabuf.modifier;
+        return true;
+    }
+    if (wlr_buffer_get_shm(buffer, &shm)) {
+        *format = shm.format;
+        *modifier = DRM_FORMAT_MOD_INVALID;
+        return true;
+    }
+    return false;
+}
+
+static wlr_buffer *createBuffer(wlr_allocator *allocator,
+                                const QSize &size,
+                                uint32_t format,
+                                uint64_t modifier)
+{
+    wlr_drm_format_set formats{};
+    wlr_drm_format_set_add(&formats, format, modifier);
+    wlr_buffer *buffer = wlr_allocator_create_buffer(allocator,
+                                                     size.width(),
+                                                     size.height(),
+                                                     wlr_drm_format_set_get(&formats, format));
+    wlr_drm_format_set_finish(&formats);
+    return buffer;
+}
+
+wlr_buffer *createCaptureBuffer(wlr_allocator *allocator,
+                                const QSize &size,
+                                uint32_t format,
+                                uint64_t modifier)
+{
+    wlr_buffer *buffer = createBuffer(allocator, size, format, modifier);
+    // The requested modifier may only be usable for scanout, let the allocator choose.
+    if (!buffer && modifier != DRM_FORMAT_MOD_INVALID)
+        buffer = createBuffer(allocator, size, format, DRM_FORMAT_MOD_INVALID);
+    if (!buffer)
+        qCWarning(treelandCapture) << "Failed to allocate capture buffer" << size;
+    return buffer;
+}
+
+bool renderCaptureTexture(wlr_renderer *renderer,
+                          wlr_texture *texture,
+                          wlr_buffer *target,
+                          const wlr_fbox &sourceBox,
+                          const QRect &targetRect,
+                          const QRegion &clip)
+{
+    wlr_render_pass *pass = wlr_renderer_begin_buffer_pass(renderer, target, nullptr);
+    if (!pass)
+        return false;
+
+    pixman_region32_t clipRegion;
+    initClipRegion(&clipRegion, clip);
+
+    wlr_render_texture_options options{};
+    options.texture = texture;
+    options.src_box = sourceBox;
+    options.dst_box = { targetRect.x(), targetRect.y(), targetRect.width(), targetRect.height() };
+    options.clip = clip.isEmpty() ? nullptr : &clipRegion;
+    options.filter_mode = filterMode(sourceBox, targetRect, WL_OUTPUT_TRANSFORM_NORMAL);
+    options.blend_mode = WLR_RENDER_BLEND_MODE_NONE;
+    wlr_render_pass_add_texture(pass, &options);
+    const bool ok = wlr_render_pass_submit(pass);
+
+    pixman_region32_fini(&clipRegion);
+    return ok;
+}
+
+bool renderCaptureParts(wlr_renderer *renderer,
+                        const QList<CaptureRenderPart> &parts,
+                        wlr_buffer *target,
+                        const QRegion &clip)
+{
+    wlr_render_pass *pass = wlr_renderer_begin_buffer_pass(renderer, target, nullptr);
+    if (!pass)
+        return false;
+
+    pixman_region32_t clipRegion;
+    initClipRegion(&clipRegion, clip);
+    const pixman_region32_t *clipPtr = clip.isEmpty() ? nullptr : &clipRegion;
+
+    if (parts.size() > 1) {
+        // Gaps between outputs of different sizes stay transparent.
+        wlr_render_rect_options clear{};
+        clear.box = { 0, 0, target->width, target->height };
+        clear.color = { 0, 0, 0, 0 };
+        clear.clip = clipPtr;
+        clear.blend_mode = WLR_RENDER_BLEND_MODE_NONE;
+        wlr_render_pass_add_rect(pass, &clear);
+    }
+
+    // Textures must outlive the pass, they are only used when it's submitted.
+    QVarLengthArray<wlr_texture *, 4> textures;
+    bool ok = true;
+    for (const auto &part : parts) {
+        if (!clip.isEmpty() && !clip.intersects(part.targetRect))
+            continue;
+        wlr_texture *texture = wlr_texture_from_buffer(renderer, part.buffer);
+        if (!texture) {
+            ok = false;
+            continue;
+        }
+        textures.append(texture);
+
+        wlr_render_texture_options options{};
+        options.texture = texture;
+        options.src_box = part.sourceBox;
+        options.dst_box = { part.targetRect.x(),
+                            part.targetRect.y(),
+                            part.targetRect.width(),
+                            part.targetRect.height() };
+        options.clip = clipPtr;
+        options.transform = part.transform;
+        options.filter_mode = filterMode(part.sourceBox, part.targetRect, part.transform);
+        options.blend_mode = WLR_RENDER_BLEND_MODE_NONE;
+        wlr_render_pass_add_texture(pass, &options);
+    }
+    ok = wlr_render_pass_submit(pass) && ok;
+
+    pixman_region32_fini(&clipRegion);
+    for (auto texture : std::as_const(textures))
+        wlr_texture_destroy(texture);
+    return ok;
+}
+
+bool readCaptureTexture(wlr_texture *texture, wlr_buffer *target)
+{
+    void *data = nullptr;
+    uint32_t format = 0;
+    size_t stride = 0;
+    if (!wlr_buffer_begin_data_ptr_access(target,
+                                          WLR_BUFFER_DATA_PTR_ACCESS_WRITE,
+                                          &data,
+                                          &format,
+                                          &stride)) {
+        return false;
+    }
+    wlr_texture_read_pixels_options options{};
+    options.data = data;
+    options.format = format;
+    options.stride = static_cast<uint32_t>(stride);
+    options.src_box = { 0, 0, target->width, target->height };
+    const bool ok = wlr_texture_read_pixels(texture, &options);
+    wlr_buffer_end_data_ptr_access(target);
+    return ok;
+}
@@ -0,0 +1,80 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+#include <QRect>
+#include <QRegion>
+
+extern "C" {
+#include <wayland-server-protocol.h>
+#include <wlr/util/box.h>
+}
+
+struct wlr_allocator;
+struct wlr_buffer;
+struct wlr_renderer;
+struct wlr_texture;
+
+// GPU helpers shared by capture sessions and one shot captures.
+
+// One buffer contributing to a captured frame
+struct CaptureRenderPart
+{
+    wlr_buffer *buffer{ nullptr };
+    // In buffer coordinates, before transform is applied
+    wlr_fbox sourceBox{};
+    QRect targetRect;
+    wl_output_transform transform{ WL_OUTPUT_TRANSFORM_NORMAL };
+};
+
+/**
+ * @brief Maps rect, in pixels of an output after its transform is applied, into the
+ * buffer of that output, which is in the physical orientation and has bufferSize. rect is
+ * clipped to the output first, the box is empty if nothing is left. A part built from the
+ * box renders upright with wlr_output_transform_invert(transform).
+ */
+wlr_box captureOutputBufferBox(const QRect &rect,
+                               wl_output_transform transform,
+                               const QSize &bufferSize);
+
+// Format and modifier of a dmabuf or shm buffer
+bool captureBufferFormat(wlr_buffer *buffer, uint32_t *format, uint64_t *modifier);
+
+/**
+ * @brief Allocates a renderable dmabuf, falls back to an implicit modifier if the
+ * allocator can't use the requested one.
+ */
+wlr_buffer *createCaptureBuffer(wlr_allocator *allocator,
+                                const QSize &size,
+                                uint32_t format,
+                                uint64_t modifier);
+
+/**
+ * @brief Renders sourceBox of texture into targetRect of target in one render pass,
+ * without blending. Crop, scale and format conversion all happen on the GPU. A non empty
+ * clip limits the pass to that region of target.
+ */
+bool renderCaptureTexture(wlr_renderer *renderer,
+                          wlr_texture *texture,
+                          wlr_buffer *target,
+                          const wlr_fbox &sourceBox,
+                          const QRect &targetRect,
+                          const QRegion &clip = {});
+
+/**
+ * @brief Renders all parts into target in one render pass, without blending. Areas not
+ * covered by any part are cleared if there are several parts. A non empty clip limits the
+ * pass to that region of target and skips parts outside of it.
+ */
+bool renderCaptureParts(wlr_renderer *renderer,
+                        const QList<CaptureRenderPart> &parts,
+                        wlr_buffer *target,
+                        const QRegion &clip = {});
+
+/**
+ * @brief Reads texture back into the memory of a shm target in the target's format,
+ * target and texture must have the same size.
+ */
+bool readCaptureTexture(wlr_texture *texture, wlr_buffer *target);
@@ -8,6 +8,10 @@
 
 #include <QDebug>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 extern "C" {
 #define static
 #include "wlr/types/wlr_compositor.h"
@@ -20,7 +24,9 @@ QW_USE_NAMESPACE
 static const struct treeland_capture_session_v1_interface session_impl = {
     .destroy = handle_treeland_capture_session_v1_destroy,
     .start = handle_treeland_capture_session_v1_start,
-    .frame_done = handle_treeland_capture_session_v1_frame_done
+    .frame_done = handle_treeland_capture_session_v1_frame_done,
+    .set_cursor_mode = handle_treeland_capture_session_v1_set_cursor_mode,
+    .set_frame_pacing = handle_treeland_capture_session_v1_set_frame_pacing
 };
 
 static const struct treeland_capture_manager_v1_interface manager_impl = {
@@ -129,7 +135,7 @@ treeland_capture_manager_v1::treeland_capture_manager_v1(wl_display *display, QO
     : QObject(parent)
     , global(wl_global_create(display,
                               &treeland_capture_manager_v1_interface,
-                              1,
+                              treeland_capture_manager_v1_interface.version,
                               this,
                               treeland_capture_manager_bind))
 {
@@ -345,6 +351,69 @@ void treeland_capture_session_v1::sendSourceResizeCancel()
                                             TREELAND_CAPTURE_SESSION_V1_CANCEL_REASON_RESIZING);
 }
 
+void treeland_capture_session_v1::sendDamage(const QRegion &damage)
+{
+    if (wl_resource_get_version(resource) < TREELAND_CAPTURE_SESSION_V1_DAMAGE_SINCE_VERSION)
+        return;
+    for (const QRect &rect : damage) {
+        treeland_capture_session_v1_send_damage(resource,
+                                                rect.x(),
+                                                rect.y(),
+                                                rect.width(),
+                                                rect.height());
+    }
+}
+
+void treeland_capture_session_v1::sendCursorImage(uint32_t serial,
+                                                  const QImage &image,
+                                                  const QPoint &hotspot)
+{
+    if (wl_resource_get_version(resource) < TREELAND_CAPTURE_SESSION_V1_CURSOR_IMAGE_SINCE_VERSION)
+        return;
+    // Matches WL_SHM_FORMAT_ARGB8888 on little endian.
+    const QImage argb = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const auto size = static_cast<size_t>(argb.sizeInBytes());
+    int fd = memfd_create("treeland-capture-cursor", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        qWarning() << "Failed to create memfd for cursor image";
+        return;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0
+        || pwrite(fd, argb.constBits(), size, 0) != static_cast<ssize_t>(size)) {
+        qWarning() << "Failed to write cursor image";
+        close(fd);
+        return;
+    }
+    // The client may map it, it must not change underneath.
+    fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+    treeland_capture_session_v1_send_cursor_image(resource,
+                                                  serial,
+                                                  fd,
+                                                  static_cast<uint32_t>(size),
+                                                  argb.width(),
+                                                  argb.height(),
+                                                  argb.bytesPerLine(),
+                                                  WL_SHM_FORMAT_ARGB8888,
+                                                  hotspot.x(),
+                                                  hotspot.y());
+    close(fd);
+}
+
+void treeland_capture_session_v1::sendCursorPosition(uint32_t serial, const QPoint &position)
+{
+    if (wl_resource_get_version(resource)
+        < TREELAND_CAPTURE_SESSION_V1_CURSOR_POSITION_SINCE_VERSION)
+        return;
+    treeland_capture_session_v1_send_cursor_position(resource, serial, position.x(), position.y());
+}
+
+void treeland_capture_session_v1::sendCursorLeave()
+{
+    if (wl_resource_get_version(resource) < TREELAND_CAPTURE_SESSION_V1_CURSOR_LEAVE_SINCE_VERSION)
+        return;
+    treeland_capture_session_v1_send_cursor_leave(resource);
+}
+
 void treeland_capture_frame_v1::setResource(wl_client *client, wl_resource *resource)
 {
     WClient *wClient = WClient::get(client);
@@ -387,3 +456,39 @@ void handle_treeland_capture_session_v1_frame_done(wl_client *,
     Q_ASSERT(session);
     Q_EMIT session->frameDone(tv_sec_hi, tv_sec_lo, tv_usec);
 }
+
+void handle_treeland_capture_session_v1_set_cursor_mode(wl_client *client,
+                                                        wl_resource *resource,
+                                                        uint32_t mode)
+{
+    auto session = capture_session_from_resource(resource);
+    Q_ASSERT(session);
+    if (mode != TREELAND_CAPTURE_SESSION_V1_CURSOR_MODE_EMBEDDED
+        && mode != TREELAND_CAPTURE_SESSION_V1_CURSOR_MODE_METADATA) {
+        wl_client_post_implementation_error(client, "Unknown cursor mode %u", mode);
+        return;
+    }
+    if (session->cursorMode == mode)
+        return;
+    session->cursorMode = mode;
+    Q_EMIT session->cursorModeChanged();
+}
+
+void handle_treeland_capture_session_v1_set_frame_pacing(wl_client *client,
+                                                         wl_resource *resource,
+                                                         uint32_t mode,
+                                                         uint32_t min_interval)
+{
+    auto session = capture_session_from_resource(resource);
+    Q_ASSERT(session);
+    if (mode != TREELAND_CAPTURE_SESSION_V1_PACING_MODE_DAMAGE
+        && mode != TREELAND_CAPTURE_SESSION_V1_PACING_MODE_FIXED) {
+        wl_client_post_implementation_error(client, "Unknown pacing mode %u", mode);
+        return;
+    }
+    if (session->pacingMode == mode && session->minInterval == min_interval)
+        return;
+    session->pacingMode = mode;
+    session->minInterval = min_interval;
+    Q_EMIT session->framePacingChanged();
+}
@@ -11,7 +11,9 @@
 
 #include <qwbuffer.h>
 
+#include <QImage>
 #include <QObject>
+#include <QRegion>
 
 Q_MOC_INCLUDE(<wsurface.h>)
 WAYLIB_SERVER_BEGIN_NAMESPACE
@@ -88,22 +90,41 @@ void handle_treeland_capture_session_v1_frame_done(wl_client *client,
                                                    uint32_t tv_sec_hi,
                                                    uint32_t tv_sec_lo,
                                                    uint32_t tv_usec);
+void handle_treeland_capture_session_v1_set_cursor_mode(wl_client *client,
+                                                        wl_resource *resource,
+                                                        uint32_t mode);
+void handle_treeland_capture_session_v1_set_frame_pacing(wl_client *client,
+                                                         wl_resource *resource,
+                                                         uint32_t mode,
+                                                         uint32_t min_interval);
 
 struct treeland_capture_session_v1 : public QObject
 {
     Q_OBJECT
 public:
     wl_resource *resource{ nullptr };
+    uint32_t cursorMode{ TREELAND_CAPTURE_SESSION_V1_CURSOR_MODE_EMBEDDED };
+    uint32_t pacingMode{ TREELAND_CAPTURE_SESSION_V1_PACING_MODE_DAMAGE };
+    // In microseconds, 0 for no limit
+    uint32_t minInterval{ 0 };
 
     void setResource(wl_client *client, wl_resource *resource);
     void sendProduceMoreCancel();
     void sendSourceDestroyCancel();
     void sendSourceResizeCancel();
+    // Sent between the objects and ready of a frame, ignored below version 2
+    void sendDamage(const QRegion &damage);
+    // Cursor events of the metadata cursor mode, ignored below version 3
+    void sendCursorImage(uint32_t serial, const QImage &image, const QPoint &hotspot);
+    void sendCursorPosition(uint32_t serial, const QPoint &position);
+    void sendCursorLeave();
 
 Q_SIGNALS:
     void beforeDestroy();
     void start();
     void frameDone(uint32_t tvSecHi, uint32_t tvSecLo, uint32_t tvUsec);
+    void cursorModeChanged();
+    void framePacingChanged();
 };
 
 void handle_treeland_capture_manager_v1_destroy([[maybe_unused]] wl_client *client,
@@ -0,0 +1,618 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "gamepadmanagerv1.h"
+
+#include "common/treelandlogging.h"
+
+#include <deckshell/deckgamepad/core/deckgamepadruntimeconfig.h>
+#include <deckshell/deckgamepad/service/deckgamepadservice.h>
+
+#include <wsocket.h>
+
+#include <qwdisplay.h>
+
+#include <QDBusAbstractAdaptor>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusContext>
+#include <QQuickWindow>
+#include <QRandomGenerator>
+
+#include <algorithm>
+
+using namespace deckshell::deckgamepad;
+
+#define TREELAND_GAMEPAD_MANAGER_V1_VERSION 2
+
+static const QString GamepadDBusPath = QStringLiteral("/org/deepin/Compositor1/Gamepad");
+
+static constexpr uint32_t kAllCapabilities = GamepadManagerV1::capability_listen_background
+    | GamepadManagerV1::capability_vibrate_background | GamepadManagerV1::capability_write_deadzone;
+
+// ---------------- Device -----------------
+
+GamepadDeviceV1::GamepadDeviceV1(GamepadManagerV1 *manager, int deviceId)
+    : m_manager(manager)
+    , m_deviceId(deviceId)
+{
+}
+
+void GamepadDeviceV1::setConnected(bool connected)
+{
+    m_connected = connected;
+    if (!connected) {
+        m_axisDirty = 0;
+        m_vibrationOwner = nullptr;
+        m_heldButtons = 0;
+        m_suppressedButtons = 0;
+        m_hatValues.fill(GAMEPAD_HAT_CENTER);
+        m_suppressedHats = 0;
+    }
+}
+
+void GamepadDeviceV1::addClient(wl_client *client, uint32_t id, int version)
+{
+    Resource *resource = add(client, id, version);
+    if (!resource || !m_connected) {
+        return;
+    }
+
+    if (resource->version() >= TREELAND_GAMEPAD_V1_DEVICE_INFO_SINCE_VERSION) {
+        send_device_info(resource->handle, m_manager->service()->deviceGuid(m_deviceId));
+    }
+}
+
+bool GamepadDeviceV1::shouldDeliver(Resource *resource) const
+{
+    wl_client *client = resource->client();
+    if (client == m_manager->focusedClient()) {
+        return true;
+    }
+    return listensInBackground(resource);
+}
+
+bool GamepadDeviceV1::listensInBackground(Resource *resource) const
+{
+    return m_manager->clientCapabilities(resource->client()) & GamepadManagerV1::capability_listen_background;
+}
+
+quint32 GamepadDeviceV1::heldHats() const
+{
+    quint32 held = 0;
+    for (uint32_t hat = 0; hat < kMaxHats; ++hat) {
+        if (m_hatValues[hat] != GAMEPAD_HAT_CENTER) {
+            held |= (1u << hat);
+        }
+    }
+    return held;
+}
+
+void GamepadDeviceV1::sendButton(uint32_t time, uint32_t button, bool pressed)
+{
+    // 保持与 axis 的先后顺序：先把本设备已合并的 axis 发出去。
+    flushAxes();
+
+    m_lastTime = time;
+    bool backgroundOnly = false;
+    if (button < 32) {
+        const quint32 bit = 1u << button;
+        if (pressed) {
+            m_heldButtons |= bit;
+        } else {
+            m_heldButtons &= ~bit;
+            // 焦点切换前按下的键：新焦点没收到按下，释放也不发给它。
+            backgroundOnly = m_suppressedButtons & bit;
+        }
+        m_suppressedButtons &= ~bit;
+    }
+
+    const auto &resources = resourceMap();
+    for (Resource *resource : resources) {
+        if (backgroundOnly ? listensInBackground(resource) : shouldDeliver(resource)) {
+            send_button(resource->handle, time, button, pressed ? 1 : 0);
+        }
+    }
+}
+
+void GamepadDeviceV1::sendHat(uint32_t time, uint32_t hat, int32_t value)
+{
+    flushAxes();
+
+    m_lastTime = time;
+    bool backgroundOnly = false;
+    if (hat < kMaxHats) {
+        const quint32 bit = 1u << hat;
+        // 焦点切换前的方向回中只发给后台监听者；换到新方向则照常发送。
+        backgroundOnly = (m_suppressedHats & bit) && value == GAMEPAD_HAT_CENTER;
+        m_suppressedHats &= ~bit;
+        m_hatValues[hat] = value;
+    }
+
+    const auto &resources = resourceMap();
+    for (Resource *resource : resources) {
+        if (backgroundOnly ? listensInBackground(resource) : shouldDeliver(resource)) {
+            send_hat(resource->handle, time, hat, value);
+        }
+    }
+}
+
+void GamepadDeviceV1::focusChanged(wl_client *oldFocus)
+{
+    const quint32 hats = heldHats();
+    if (!m_heldButtons && !hats) {
+        return;
+    }
+
+    // 后台监听者不受焦点影响，照常收到真实的释放；只有旧焦点需要补发。
+    const auto &resources = resourceMap();
+    for (Resource *resource : resources) {
+        if (resource->client() != oldFocus || listensInBackground(resource)) {
+            continue;
+        }
+        for (quint32 held = m_heldButtons; held; held &= held - 1) {
+            send_button(resource->handle, m_lastTime, qCountTrailingZeroBits(held), 0);
+        }
+        for (quint32 held = hats; held; held &= held - 1) {
+            send_hat(resource->handle, m_lastTime, qCountTrailingZeroBits(held), GAMEPAD_HAT_CENTER);
+        }
+    }
+
+    m_suppressedButtons = m_heldButtons;
+    m_suppressedHats = hats;
+}
+
+void GamepadDeviceV1::queueAxis(uint32_t time, uint32_t axis, double value)
+{
+    if (axis >= m_axisValues.size()) {
+        return;
+    }
+
+    m_axisDirty |= (1u << axis);
+    m_axisTimes[axis] = time;
+    m_axisValues[axis] = value;
+    m_manager->scheduleAxisFlush();
+}
+
+bool GamepadDeviceV1::flushAxes()
+{
+    if (!m_axisDirty) {
+        return false;
+    }
+
+    quint32 dirty = m_axisDirty;
+    m_axisDirty = 0;
+
+    const auto &resources = resourceMap();
+    if (resources.isEmpty()) {
+        return false;
+    }
+
+    while (dirty) {
+        const uint32_t axis = qCountTrailingZeroBits(dirty);
+        dirty &= dirty - 1;
+
+        const wl_fixed_t value = wl_fixed_from_double(std::clamp(m_axisValues[axis], -1.0, 1.0));
+        for (Resource *resource : resources) {
+            if (shouldDeliver(resource)) {
+                send_axis(resource->handle, m_axisTimes[axis], axis, value);
+            }
+        }
+    }
+    return true;
+}
+
+void GamepadDeviceV1::treeland_gamepad_v1_destroy_resource(Resource *resource)
+{
+    // 协议约定：release 时自动停止该客户端发起的振动。
+    if (m_vibrationOwner == resource) {
+        m_vibrationOwner = nullptr;
+        if (m_connected) {
+            m_manager->service()->stopVibration(m_deviceId);
+        }
+    }
+
+    // resourceMap() 此时已不含该资源；设备已断开且无人持有时交给 manager 释放。
+    if (!m_connected && resourceMap().isEmpty()) {
+        m_manager->scheduleDevicePrune(m_deviceId);
+    }
+}
+
+void GamepadDeviceV1::treeland_gamepad_v1_set_vibration(Resource *resource,
+                                                        wl_fixed_t weak_magnitude,
+                                                        wl_fixed_t strong_magnitude,
+                                                        int32_t duration_ms)
+{
+    if (!m_connected) {
+        return;
+    }
+
+    wl_client *client = resource->client();
+    if (client != m_manager->focusedClient()
+        && !(m_manager->clientCapabilities(client) & GamepadManagerV1::capability_vibrate_background)) {
+        return;
+    }
+
+    const float weak = std::clamp(static_cast<float>(wl_fixed_to_double(weak_magnitude)), 0.0f, 1.0f);
+    const float strong = std::clamp(static_cast<float>(wl_fixed_to_double(strong_magnitude)), 0.0f, 1.0f);
+    // duration_ms == 0 表示持续振动，直到 stop_vibration/release。
+    const int durationMs = duration_ms > 0 ? duration_ms : 0;
+    if (m_manager->service()->startVibration(m_deviceId, weak, strong, durationMs)) {
+        m_vibrationOwner = resource;
+    }
+}
+
+void GamepadDeviceV1::treeland_gamepad_v1_stop_vibration(Resource *resource)
+{
+    if (!m_connected || m_vibrationOwner != resource) {
+        return;
+    }
+
+    m_vibrationOwner = nullptr;
+    m_manager->service()->stopVibration(m_deviceId);
+}
+
+void GamepadDeviceV1::treeland_gamepad_v1_release(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void GamepadDeviceV1::treeland_gamepad_v1_set_axis_deadzone(Resource *resource,
+                                                            uint32_t axis,
+                                                            wl_fixed_t deadzone)
+{
+    if (!(m_manager->clientCapabilities(resource->client()) & GamepadManagerV1::capability_write_deadzone)) {
+        send_axis_deadzone_failed(resource->handle, axis, deadzone_error_denied);
+        return;
+    }
+
+    const double value = std::clamp(wl_fixed_to_double(deadzone), 0.0, 1.0);
+    m_manager->service()->setAxisDeadzone(m_deviceId, axis, static_cast<float>(value));
+    send_axis_deadzone_applied(resource->handle, axis, wl_fixed_from_double(value));
+}
+
+// ---------------- Manager -----------------
+
+GamepadManagerV1::GamepadManagerV1(QObject *parent)
+    : QObject(parent)
+{
+}
+
+GamepadManagerV1::~GamepadManagerV1()
+{
+    qDeleteAll(m_devices);
+}
+
+void GamepadManagerV1::setFocusedClient(wl_client *client)
+{
+    if (m_focusedClient == client) {
+        return;
+    }
+
+    // 焦点切换前把已合并的 axis 发给旧焦点，避免新焦点收到旧窗口的残留输入；
+    // 仍按住的键补发释放给旧焦点，新焦点不会收到没见过按下的释放。
+    flushAxes();
+    for (GamepadDeviceV1 *device : std::as_const(m_devices)) {
+        device->focusChanged(m_focusedClient);
+    }
+    m_focusedClient = client;
+}
+
+void GamepadManagerV1::setFrameWindow(QQuickWindow *window)
+{
+    if (m_frameWindow == window) {
+        return;
+    }
+
+    if (m_frameWindow) {
+        disconnect(m_frameWindow, &QQuickWindow::afterAnimating, this, &GamepadManagerV1::flushAxes);
+    }
+    m_frameWindow = window;
+    if (m_frameWindow) {
+        connect(m_frameWindow, &QQuickWindow::afterAnimating, this, &GamepadManagerV1::flushAxes);
+    }
+}
+
+void GamepadManagerV1::scheduleAxisFlush()
+{
+    if (!m_frameWindow) {
+        flushAxes();
+        return;
+    }
+
+    if (m_axisFlushScheduled) {
+        return;
+    }
+    m_axisFlushScheduled = true;
+    // 空闲时不会有帧：主动请求一帧，保证 axis 最迟在下一帧送达。
+    m_frameWindow->update();
+}
+
+void GamepadManagerV1::flushAxes()
+{
+    m_axisFlushScheduled = false;
+    for (GamepadDeviceV1 *device : std::as_const(m_devices)) {
+        device->flushAxes();
+    }
+}
+
+QString GamepadManagerV1::issueAuthorizationToken(uid_t uid, uint32_t capabilities, int ttlMs)
+{
+    capabilities &= kAllCapabilities;
+    if (!capabilities || ttlMs <= 0) {
+        return {};
+    }
+
+    // 顺带清理过期 token，避免表无限增长。
+    for (auto it = m_tokens.begin(); it != m_tokens.end();) {
+        it = it->expiry.hasExpired() ? m_tokens.erase(it) : std::next(it);
+    }
+
+    quint64 words[2];
+    QRandomGenerator::system()->fillRange(words);
+    const QString token = QString::fromLatin1(
+        QByteArray(reinterpret_cast<const char *>(words), sizeof(words)).toHex());
+
+    m_tokens.insert(token, PendingToken{ uid, capabilities, QDeadlineTimer(ttlMs) });
+    return token;
+}
+
+uint32_t GamepadManagerV1::clientCapabilities(wl_client *client) const
+{
+    return m_capabilities.value(client, 0);
+}
+
+void GamepadManagerV1::trackClient(wl_client *client)
+{
+    if (m_capabilities.contains(client)) {
+        return;
+    }
+
+    m_capabilities.insert(client, 0);
+    WClient *wClient = WClient::get(client);
+    connect(wClient, &WClient::destroyed, this, [this, client] {
+        m_capabilities.remove(client);
+        if (m_focusedClient == client) {
+            // 客户端已销毁，无需补发释放；仍需屏蔽后续释放，避免发给下一个焦点。
+            for (GamepadDeviceV1 *device : std::as_const(m_devices)) {
+                device->focusChanged(nullptr);
+            }
+            m_focusedClient = nullptr;
+        }
+    });
+}
+
+GamepadDeviceV1 *GamepadManagerV1::ensureDevice(int deviceId)
+{
+    GamepadDeviceV1 *device = m_devices.value(deviceId);
+    if (!device) {
+        device = new GamepadDeviceV1(this, deviceId);
+        m_devices.insert(deviceId, device);
+    }
+    return device;
+}
+
+void GamepadManagerV1::scheduleDevicePrune(int deviceId)
+{
+    // 在 destroy_resource 回调中删除设备对象会让生成代码在回调返回后访问已释放的对象。
+    QMetaObject::invokeMethod(this, [this, deviceId] {
+        pruneDevice(deviceId);
+    }, Qt::QueuedConnection);
+}
+
+void GamepadManagerV1::pruneDevice(int deviceId)
+{
+    GamepadDeviceV1 *device = m_devices.value(deviceId);
+    // 期间可能已重连或又被客户端获取。
+    if (!device || device->isConnected() || !device->resourceMap().isEmpty()) {
+        return;
+    }
+
+    m_devices.remove(deviceId);
+    delete device;
+}
+
+void GamepadManagerV1::handleGamepadConnected(int deviceId, const QString &name)
+{
+    ensureDevice(deviceId)->setConnected(true);
+
+    const auto &resources = resourceMap();
+    for (Resource *resource : resources) {
+        send_gamepad_added(resource->handle, deviceId, name);
+    }
+}
+
+void GamepadManagerV1::handleGamepadDisconnected(int deviceId)
+{
+    // 客户端仍持有的 treeland_gamepad_v1 资源在 release 前保持有效，最后一个资源销毁后再释放设备对象。
+    if (GamepadDeviceV1 *device = m_devices.value(deviceId)) {
+        device->setConnected(false);
+        pruneDevice(deviceId);
+    }
+
+    const auto &resources = resourceMap();
+    for (Resource *resource : resources) {
+        send_gamepad_removed(resource->handle, deviceId);
+    }
+}
+
+void GamepadManagerV1::treeland_gamepad_manager_v1_bind_resource(Resource *resource)
+{
+    trackClient(resource->client());
+
+    const QList<int> devices = m_service->connectedGamepads();
+    for (int deviceId : devices) {
+        send_gamepad_added(resource->handle, deviceId, m_service->deviceName(deviceId));
+    }
+}
+
+void GamepadManagerV1::treeland_gamepad_manager_v1_destroy(Resource *resource)
+{
+    wl_resource_destroy(resource->handle);
+}
+
+void GamepadManagerV1::treeland_gamepad_manager_v1_get_gamepad(Resource *resource,
+                                                               uint32_t id,
+                                                               int32_t device_id)
+{
+    // 未知/已断开设备同样创建资源（协议无错误事件），该资源不会收到任何输入。
+    GamepadDeviceV1 *device = m_devices.value(device_id);
+    if (!device) {
+        device = ensureDevice(device_id);
+        device->setConnected(m_service->connectedGamepads().contains(device_id));
+    }
+    device->addClient(resource->client(), id, resource->version());
+}
+
+void GamepadManagerV1::treeland_gamepad_manager_v1_authorize(Resource *resource, const QString &token)
+{
+    const auto it = m_tokens.constFind(token);
+    if (it == m_tokens.cend()) {
+        send_authorization_failed(resource->handle, authorize_error_invalid_token);
+        return;
+    }
+
+    // token 一次性：无论成功与否都作废。
+    const PendingToken pending = it.value();
+    m_tokens.erase(it);
+
+    if (pending.expiry.hasExpired()) {
+        send_authorization_failed(resource->handle, authorize_error_expired_token);
+        return;
+    }
+
+    uid_t uid = 0;
+    wl_client_get_credentials(resource->client(), nullptr, &uid, nullptr);
+    if (uid != pending.uid) {
+        send_authorization_failed(resource->handle, authorize_error_credential_mismatch);
+        return;
+    }
+
+    trackClient(resource->client());
+    uint32_t &granted = m_capabilities[resource->client()];
+    granted |= pending.capabilities;
+    qCInfo(treelandGamepad) << "Gamepad capabilities granted, uid:" << uid << "capabilities:" << granted;
+    send_authorized(resource->handle, granted);
+}
+
+// ---------------- D-Bus -----------------
+
+// authorize(token) 的 token 来源：系统总线上仅接受 root 调用方（例如基于 polkit 的系统服务），
+// 由它在完成鉴权后为目标用户申请，再交给该用户的客户端提交。
+class Gamepad1Adaptor
+    : public QDBusAbstractAdaptor
+    , protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.Compositor1.Gamepad")
+    Q_CLASSINFO("D-Bus Introspection",
+                "  <interface name=\"org.deepin.Compositor1.Gamepad\">\n"
+                "    <method name=\"IssueAuthorizationToken\">\n"
+                "      <arg direction=\"in\" type=\"u\" name=\"uid\"/>\n"
+                "      <arg direction=\"in\" type=\"u\" name=\"capabilities\"/>\n"
+                "      <arg direction=\"out\" type=\"s\" name=\"token\"/>\n"
+                "    </method>\n"
+                "  </interface>\n"
+                "")
+public:
+    explicit Gamepad1Adaptor(GamepadManagerV1 *parent)
+        : QDBusAbstractAdaptor(parent)
+    {
+    }
+
+    inline GamepadManagerV1 *parent() const
+    {
+        return static_cast<GamepadManagerV1 *>(QObject::parent());
+    }
+
+public Q_SLOTS:
+    QString IssueAuthorizationToken(uint uid, uint capabilities)
+    {
+        const uint caller = connection().interface()->serviceUid(message().service());
+        if (caller != 0) {
+            qCWarning(treelandGamepad) << "Rejected gamepad token request from uid" << caller;
+            sendErrorReply(QDBusError::AccessDenied,
+                           QStringLiteral("Only privileged callers may issue gamepad tokens"));
+            return {};
+        }
+
+        const QString token = parent()->issueAuthorizationToken(uid, capabilities);
+        if (token.isEmpty()) {
+            sendErrorReply(QDBusError::InvalidArgs, QStringLiteral("No known capability requested"));
+        }
+        return token;
+    }
+};
+
+// ---------------- WServerInterface -----------------
+
+void GamepadManagerV1::create(WServer *server)
+{
+    m_service = std::make_unique<DeckGamepadService>();
+
+    DeckGamepadRuntimeConfig config;
+    config.enableLegacyDeckShellPaths = false;
+    // compositor 自身就是 treeland 服务端：只能直接读 evdev。
+    // IO 线程模式：evdev 读取不占用主线程，帧经 SPSC ring 交付（仅该模式下生效）。
+    config.providerSelection = DeckGamepadProviderSelection::Evdev;
+    config.inputTransport = DeckGamepadInputTransport::SpscRing;
+    // axis 由本模块按输出帧合并，service 侧不再做时间窗整形。
+    config.axisCoalesceIntervalMs = 0;
+    config.hatCoalesceIntervalMs = 0;
+    m_service->setRuntimeConfig(config);
+
+    connect(m_service.get(), &DeckGamepadService::gamepadConnected,
+            this, &GamepadManagerV1::handleGamepadConnected);
+    connect(m_service.get(), &DeckGamepadService::gamepadDisconnected,
+            this, &GamepadManagerV1::handleGamepadDisconnected);
+    connect(m_service.get(), &DeckGamepadService::buttonEvent,
+            this, [this](int deviceId, DeckGamepadButtonEvent event) {
+                if (GamepadDeviceV1 *device = m_devices.value(deviceId)) {
+                    device->sendButton(event.time_msec, event.button, event.pressed);
+                }
+            });
+    connect(m_service.get(), &DeckGamepadService::axisEvent,
+            this, [this](int deviceId, DeckGamepadAxisEvent event) {
+                if (GamepadDeviceV1 *device = m_devices.value(deviceId)) {
+                    device->queueAxis(event.time_msec, event.axis, event.value);
+                }
+            });
+    connect(m_service.get(), &DeckGamepadService::hatEvent,
+            this, [this](int deviceId, DeckGamepadHatEvent event) {
+                if (GamepadDeviceV1 *device = m_devices.value(deviceId)) {
+                    device->sendHat(event.time_msec, event.hat, event.value);
+                }
+            });
+
+    init(server->handle()->handle(), TREELAND_GAMEPAD_MANAGER_V1_VERSION);
+
+    new Gamepad1Adaptor(this);
+    if (!QDBusConnection::systemBus().registerObject(GamepadDBusPath, this)) {
+        qCWarning(treelandGamepad) << "Failed to register" << GamepadDBusPath
+                                   << "on the system bus, authorize() will not succeed";
+    }
+
+    if (!m_service->start()) {
+        qCWarning(treelandGamepad) << "Failed to start gamepad service:" << m_service->lastErrorMessage();
+    }
+}
+
+void GamepadManagerV1::destroy([[maybe_unused]] WServer *server)
+{
+    QDBusConnection::systemBus().unregisterObject(GamepadDBusPath);
+    if (m_service) {
+        m_service->stop();
+    }
+}
+
+wl_global *GamepadManagerV1::global() const
+{
+    return treeland_gamepad_manager_v1::m_global;
+}
+
+QByteArrayView GamepadManagerV1::interfaceName() const
+{
+    return treeland_gamepad_manager_v1::interfaceName();
+}
+
+#include "gamepadmanagerv1.moc"
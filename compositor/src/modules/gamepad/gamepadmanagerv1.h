@@ -0,0 +1,151 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "qwayland-server-treeland-gamepad-v1.h"
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+
+#include <wserver.h>
+
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+
+#include <array>
+#include <memory>
+
+#include <sys/types.h>
+
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+QT_END_NAMESPACE
+
+namespace deckshell::deckgamepad {
+class DeckGamepadService;
+}
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+class GamepadManagerV1;
+
+// 单个手柄设备：同一设备的所有客户端 treeland_gamepad_v1 资源挂在同一对象上。
+class GamepadDeviceV1 : public QtWaylandServer::treeland_gamepad_v1
+{
+public:
+    GamepadDeviceV1(GamepadManagerV1 *manager, int deviceId);
+
+    int deviceId() const { return m_deviceId; }
+    bool isConnected() const { return m_connected; }
+    void setConnected(bool connected);
+
+    void addClient(wl_client *client, uint32_t id, int version);
+
+    void sendButton(uint32_t time, uint32_t button, bool pressed);
+    void sendHat(uint32_t time, uint32_t hat, int32_t value);
+    // 焦点切换：给失去焦点的客户端补发仍按住的键/hat 的释放；新焦点没见过这些按下，之后的释放不再发给它。
+    void focusChanged(wl_client *oldFocus);
+    // axis 按输出帧合并：同一帧内同一轴只发送最后一个值。
+    void queueAxis(uint32_t time, uint32_t axis, double value);
+    bool flushAxes();
+
+protected:
+    void treeland_gamepad_v1_destroy_resource(Resource *resource) override;
+    void treeland_gamepad_v1_set_vibration(Resource *resource,
+                                           wl_fixed_t weak_magnitude,
+                                           wl_fixed_t strong_magnitude,
+                                           int32_t duration_ms) override;
+    void treeland_gamepad_v1_stop_vibration(Resource *resource) override;
+    void treeland_gamepad_v1_release(Resource *resource) override;
+    void treeland_gamepad_v1_set_axis_deadzone(Resource *resource,
+                                               uint32_t axis,
+                                               wl_fixed_t deadzone) override;
+
+private:
+    static constexpr uint32_t kMaxHats = 4;
+
+    bool shouldDeliver(Resource *resource) const;
+    bool listensInBackground(Resource *resource) const;
+    quint32 heldHats() const;
+
+    GamepadManagerV1 *m_manager;
+    int m_deviceId;
+    bool m_connected = true;
+    Resource *m_vibrationOwner = nullptr;
+
+    // 按住状态（按位索引 button/hat）；suppressed 为焦点切换前按下、释放只发给后台监听者的部分。
+    quint32 m_heldButtons = 0;
+    quint32 m_suppressedButtons = 0;
+    std::array<int32_t, kMaxHats> m_hatValues{};
+    quint32 m_suppressedHats = 0;
+    uint32_t m_lastTime = 0;
+
+    quint32 m_axisDirty = 0;
+    std::array<uint32_t, deckshell::deckgamepad::GAMEPAD_AXIS_MAX> m_axisTimes{};
+    std::array<double, deckshell::deckgamepad::GAMEPAD_AXIS_MAX> m_axisValues{};
+};
+
+class GamepadManagerV1
+    : public QObject
+    , public QtWaylandServer::treeland_gamepad_manager_v1
+    , public WServerInterface
+{
+    Q_OBJECT
+public:
+    explicit GamepadManagerV1(QObject *parent = nullptr);
+    ~GamepadManagerV1() override;
+
+    deckshell::deckgamepad::DeckGamepadService *service() const { return m_service.get(); }
+
+    // 仅键盘焦点客户端接收输入（除非已授权 listen_background）。
+    void setFocusedClient(wl_client *client);
+    wl_client *focusedClient() const { return m_focusedClient; }
+
+    // axis 合并的帧节拍来源：每次 afterAnimating 刷新一次；为空时 axis 立即发送。
+    void setFrameWindow(QQuickWindow *window);
+
+    // 为指定用户签发一次性授权 token；经系统总线 org.deepin.Compositor1.Gamepad 供 root 调用方使用。
+    QString issueAuthorizationToken(uid_t uid, uint32_t capabilities, int ttlMs = 30000);
+    uint32_t clientCapabilities(wl_client *client) const;
+
+    void scheduleAxisFlush();
+    // 已断开且没有客户端资源的设备对象可以释放；资源销毁回调内不能直接删除，经此延后处理。
+    void scheduleDevicePrune(int deviceId);
+
+protected:
+    void treeland_gamepad_manager_v1_bind_resource(Resource *resource) override;
+    void treeland_gamepad_manager_v1_destroy(Resource *resource) override;
+    void treeland_gamepad_manager_v1_get_gamepad(Resource *resource,
+                                                 uint32_t id,
+                                                 int32_t device_id) override;
+    void treeland_gamepad_manager_v1_authorize(Resource *resource, const QString &token) override;
+
+    void create(WServer *server) override;
+    void destroy(WServer *server) override;
+    wl_global *global() const override;
+    QByteArrayView interfaceName() const override;
+
+private:
+    struct PendingToken {
+        uid_t uid = 0;
+        uint32_t capabilities = 0;
+        QDeadlineTimer expiry;
+    };
+
+    void handleGamepadConnected(int deviceId, const QString &name);
+    void handleGamepadDisconnected(int deviceId);
+    void flushAxes();
+    GamepadDeviceV1 *ensureDevice(int deviceId);
+    void pruneDevice(int deviceId);
+    void trackClient(wl_client *client);
+
+    std::unique_ptr<deckshell::deckgamepad::DeckGamepadService> m_service;
+    QHash<int, GamepadDeviceV1 *> m_devices;
+    QHash<QString, PendingToken> m_tokens;
+    QHash<wl_client *, uint32_t> m_capabilities;
+    wl_client *m_focusedClient = nullptr;
+    QPointer<QQuickWindow> m_frameWindow;
+    bool m_axisFlushScheduled = false;
+};
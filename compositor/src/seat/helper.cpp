@@ -30,6 +30,9 @@
 #include "modules/dde-shell/ddeshellattached.h"
 #include "modules/dde-shell/ddeshellmanagerinterfacev1.h"
 #include "modules/ddm/ddminterfacev1.h"
+#ifndef DISABLE_GAMEPAD
+#include "modules/gamepad/gamepadmanagerv1.h"
+#endif
 #include "modules/keystate/keystate.h"
 #include "modules/output-manager/outputmanagement.h"
 #include "modules/personalization/personalizationmanager.h"
@@ -387,6 +390,16 @@ WOutputRenderWindow *Helper::window() const
     return m_renderWindow;
 }
 
+qw_renderer *Helper::renderer() const
+{
+    return m_renderer;
+}
+
+qw_allocator *Helper::allocator() const
+{
+    return m_allocator;
+}
+
 SessionManager *Helper::sessionManager() const
 {
     return m_sessionManager;
@@ -402,6 +415,11 @@ Workspace *Helper::workspace() const
     return m_shellHandler->workspace();
 }
 
+CaptureManagerV1 *Helper::captureManager() const
+{
+    return m_captureManager;
+}
+
 void Helper::onOutputAdded(WOutput *output)
 {
     // TODO: 应该让helper发出Output的信号，每个需要output的单元单独connect。
@@ -1328,6 +1346,7 @@ void Helper::init(Treeland::Treeland *treeland)
 
     auto captureManagerV1 = m_server->attach<CaptureManagerV1>();
     captureManagerV1->setOutputRenderWindow(m_renderWindow);
+    m_captureManager = captureManagerV1;
 
     connect(
         captureManagerV1,
@@ -1568,6 +1587,19 @@ void Helper::init(Treeland::Treeland *treeland)
 
     m_server->attach<KeyStateV5>(m_seat);
 
+#ifndef DISABLE_GAMEPAD
+    // 手柄输入只路由给键盘焦点窗口所属的客户端；axis 按输出帧合并。
+    m_gamepadManager = m_server->attach<GamepadManagerV1>();
+    m_gamepadManager->setFrameWindow(m_renderWindow);
+    connect(this, &Helper::activatedSurfaceChanged, m_gamepadManager, [this] {
+        wl_client *client = nullptr;
+        if (m_activatedSurface && m_activatedSurface->surface()) {
+            client = wl_resource_get_client(m_activatedSurface->surface()->handle()->handle()->resource);
+        }
+        m_gamepadManager->setFocusedClient(client);
+    });
+#endif
+
 #if TREELANDCONFIG_DCONFIG_FILE_VERSION_MINOR > 0
     if (m_globalConfig->isInitializeSucceeded()) {
 #else
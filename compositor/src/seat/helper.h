@@ -89,11 +89,13 @@ QW_END_NAMESPACE
 WAYLIB_SERVER_USE_NAMESPACE
 QW_USE_NAMESPACE
 
+class CaptureManagerV1;
 class CaptureSourceSelector;
 class DDEShellManagerInterfaceV1;
 class DDMInterfaceV1;
 class ForeignToplevelV1;
 class FpsDisplayManager;
+class GamepadManagerV1;
 class GreeterProxy;
 class ILockScreen;
 class IMultitaskView;
@@ -145,6 +147,7 @@ class Helper : public WSeatEventFilter
     Q_PROPERTY(OutputMode outputMode READ outputMode WRITE setOutputMode NOTIFY outputModeChanged FINAL)
     Q_PROPERTY(SurfaceWrapper* activatedSurface READ activatedSurface NOTIFY activatedSurfaceChanged FINAL)
     Q_PROPERTY(Workspace* workspace READ workspace CONSTANT FINAL)
+    Q_PROPERTY(CaptureManagerV1* captureManager READ captureManager CONSTANT FINAL)
     Q_PROPERTY(TreelandUserConfig* config READ config CONSTANT FINAL)
     Q_PROPERTY(TreelandConfig* globalConfig READ globalConfig CONSTANT FINAL)
     Q_PROPERTY(bool blockActivateSurface READ blockActivateSurface WRITE setBlockActivateSurface NOTIFY blockActivateSurfaceChanged FINAL)
@@ -179,8 +182,11 @@ public:
     SessionManager *sessionManager() const;
     QmlEngine *qmlEngine() const;
     WOutputRenderWindow *window() const;
+    qw_renderer *renderer() const;
+    qw_allocator *allocator() const;
     ShellHandler *shellHandler() const;
     Workspace *workspace() const;
+    CaptureManagerV1 *captureManager() const;
 
     void init(Treeland::Treeland *treeland);
 
@@ -394,6 +400,9 @@ private:
     DDMInterfaceV1 *m_ddmInterfaceV1 = nullptr;
 #endif
     ScreensaverInterfaceV1 *m_screensaverInterfaceV1 = nullptr;
+#ifndef DISABLE_GAMEPAD
+    GamepadManagerV1 *m_gamepadManager = nullptr;
+#endif
     TreelandWallpaperManagerInterfaceV1 *m_wallpaperManagerInterfaceV1 = nullptr;
     TreelandWallpaperNotifierInterfaceV1 *m_wallpaperNotifierInterfaceV1 = nullptr;
 #ifdef EXT_SESSION_LOCK_V1
@@ -414,6 +423,7 @@ private:
     OutputMode m_mode = OutputMode::Extension;
     std::optional<QPointF> m_fakelastPressedPosition;
 
+    CaptureManagerV1 *m_captureManager = nullptr;
     QPointer<CaptureSourceSelector> m_captureSelector;
 
     QPropertyAnimation *m_workspaceScaleAnimation{ nullptr };
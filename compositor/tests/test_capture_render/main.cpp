@@ -0,0 +1,75 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "modules/capture/capturerender.h"
+
+#include <QObject>
+#include <QTest>
+
+extern "C" {
+#include <wlr/types/wlr_output.h>
+}
+
+Q_DECLARE_METATYPE(wl_output_transform)
+
+static QRect toRect(const wlr_box &box)
+{
+    return QRect(box.x, box.y, box.width, box.height);
+}
+
+class CaptureRenderTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void outputBufferBox_data()
+    {
+        QTest::addColumn<wl_output_transform>("transform");
+        QTest::addColumn<QSize>("bufferSize");
+        QTest::addColumn<QRect>("rect");
+        QTest::addColumn<QRect>("expected");
+
+        // Landscape panel, 2x scale already applied to the rect
+        QTest::newRow("normal") << WL_OUTPUT_TRANSFORM_NORMAL << QSize(3840, 2160)
+                                << QRect(200, 100, 400, 300) << QRect(200, 100, 400, 300);
+        // Portrait panel rotated into a 1920x1080 output
+        QTest::newRow("rotated 90") << WL_OUTPUT_TRANSFORM_90 << QSize(1080, 1920)
+                                    << QRect(0, 0, 100, 50) << QRect(0, 1820, 50, 100);
+        QTest::newRow("rotated 270") << WL_OUTPUT_TRANSFORM_270 << QSize(1080, 1920)
+                                     << QRect(0, 0, 100, 50) << QRect(1030, 0, 50, 100);
+        QTest::newRow("rotated 180") << WL_OUTPUT_TRANSFORM_180 << QSize(1920, 1080)
+                                     << QRect(0, 0, 100, 50) << QRect(1820, 1030, 100, 50);
+        // Clipped to the transformed output, not to the buffer
+        QTest::newRow("rotated 90 clipped") << WL_OUTPUT_TRANSFORM_90 << QSize(1080, 1920)
+                                            << QRect(1900, 1000, 100, 200)
+                                            << QRect(1000, 0, 80, 20);
+        QTest::newRow("outside") << WL_OUTPUT_TRANSFORM_90 << QSize(1080, 1920)
+                                 << QRect(0, 1080, 100, 100) << QRect();
+    }
+
+    void outputBufferBox()
+    {
+        QFETCH(wl_output_transform, transform);
+        QFETCH(QSize, bufferSize);
+        QFETCH(QRect, rect);
+        QFETCH(QRect, expected);
+
+        const wlr_box box = captureOutputBufferBox(rect, transform, bufferSize);
+        if (expected.isEmpty()) {
+            QVERIFY(wlr_box_empty(&box));
+            return;
+        }
+        QCOMPARE(toRect(box), expected);
+
+        // Rendering the box with the inverted transform gives back the clipped rect.
+        QSize outputSize = bufferSize;
+        if (transform & WL_OUTPUT_TRANSFORM_90)
+            outputSize.transpose();
+        wlr_box back{};
+        wlr_box_transform(&back, &box, transform, bufferSize.width(), bufferSize.height());
+        QCOMPARE(toRect(back), rect.intersected(QRect(QPoint(0, 0), outputSize)));
+    }
+};
+
+QTEST_MAIN(CaptureRenderTest)
+#include "main.moc"
@@ -7,49 +7,9 @@
 #include <deckshell/deckgamepad/mapping/deckgamepadcustommappingmanager.h>
 #include <deckshell/deckgamepad/service/deckgamepadservice.h>
 
-#include <QtCore/QMetaObject>
-#include <QtCore/QThread>
-
-#include <type_traits>
-#include <utility>
-
 using deckshell::deckgamepad::DeckGamepadService;
 using deckshell::deckgamepad::DeckGamepadCustomMappingManager;
 
-namespace {
-template <typename Func>
-auto invokeBlocking(DeckGamepadCustomMappingManager *manager, Func &&func)
-{
-    using Ret = std::invoke_result_t<Func>;
-
-    if (!manager) {
-        if constexpr (!std::is_void_v<Ret>) {
-            return Ret{};
-        } else {
-            return;
-        }
-    }
-
-    if (QThread::currentThread() == manager->thread()) {
-        if constexpr (!std::is_void_v<Ret>) {
-            return func();
-        } else {
-            func();
-            return;
-        }
-    }
-
-    if constexpr (std::is_void_v<Ret>) {
-        QMetaObject::invokeMethod(manager, std::forward<Func>(func), Qt::BlockingQueuedConnection);
-        return;
-    } else {
-        Ret result{};
-        QMetaObject::invokeMethod(manager, [&] { result = func(); }, Qt::BlockingQueuedConnection);
-        return result;
-    }
-}
-}
-
 CustomMappingManager::CustomMappingManager(QObject *parent)
     : QObject(parent)
 {
@@ -71,73 +31,73 @@ bool CustomMappingManager::supported() const
 QString CustomMappingManager::createCustomMapping(int deviceId)
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, deviceId] { return mgr->createCustomMapping(deviceId); });
+    return mgr ? mgr->createCustomMapping(deviceId) : QString();
 }
 
 bool CustomMappingManager::hasCustomMapping(int deviceId) const
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, deviceId] { return mgr->hasCustomMapping(deviceId); });
+    return mgr ? mgr->hasCustomMapping(deviceId) : false;
 }
 
 QStringList CustomMappingManager::availablePresets() const
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr] { return mgr->availablePresets(); });
+    return mgr ? mgr->availablePresets() : QStringList();
 }
 
 bool CustomMappingManager::loadPreset(int deviceId, const QString &presetName)
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, deviceId, presetName] { return mgr->loadPreset(deviceId, presetName); });
+    return mgr ? mgr->loadPreset(deviceId, presetName) : false;
 }
 
 bool CustomMappingManager::saveToFile(const QString &filePath)
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, filePath] { return mgr->saveToFile(filePath); });
+    return mgr ? mgr->saveToFile(filePath) : false;
 }
 
 int CustomMappingManager::loadFromFile(const QString &filePath)
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, filePath] { return mgr->loadFromFile(filePath); });
+    return mgr ? mgr->loadFromFile(filePath) : 0;
 }
 
 bool CustomMappingManager::applyMapping(int deviceId)
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, deviceId] { return mgr->applyMapping(deviceId); });
+    return mgr ? mgr->applyMapping(deviceId) : false;
 }
 
 bool CustomMappingManager::resetToSdlDefault(int deviceId)
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, deviceId] { return mgr->resetToSdlDefault(deviceId); });
+    return mgr ? mgr->resetToSdlDefault(deviceId) : false;
 }
 
 bool CustomMappingManager::isMappingComplete(int deviceId) const
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, deviceId] { return mgr->isMappingComplete(deviceId); });
+    return mgr ? mgr->isMappingComplete(deviceId) : false;
 }
 
 QStringList CustomMappingManager::getMissingMappings(int deviceId) const
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, deviceId] { return mgr->getMissingMappings(deviceId); });
+    return mgr ? mgr->getMissingMappings(deviceId) : QStringList();
 }
 
 QString CustomMappingManager::exportToSdlString(int deviceId) const
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, deviceId] { return mgr->exportToSdlString(deviceId); });
+    return mgr ? mgr->exportToSdlString(deviceId) : QString();
 }
 
 bool CustomMappingManager::importFromSdlString(int deviceId, const QString &sdlString)
 {
     auto *mgr = mappingManager();
-    return invokeBlocking(mgr, [mgr, deviceId, sdlString] { return mgr->importFromSdlString(deviceId, sdlString); });
+    return mgr ? mgr->importFromSdlString(deviceId, sdlString) : false;
 }
 
 void CustomMappingManager::syncFromService()
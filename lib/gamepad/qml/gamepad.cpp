@@ -10,8 +10,9 @@
 
 #include <QtCore/QDateTime>
 #include <QtQml/QQmlEngine>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickWindow>
 
-using deckshell::deckgamepad::DeckGamepadService;
 using deckshell::deckgamepad::GamepadAxis;
 using deckshell::deckgamepad::GamepadButton;
 
@@ -23,7 +24,12 @@ Gamepad::Gamepad(QObject *parent)
     connect(&m_coalesceTimer, &QTimer::timeout, this, &Gamepad::flushPendingChanges);
 }
 
-Gamepad::~Gamepad() = default;
+Gamepad::~Gamepad()
+{
+    if (m_manager) {
+        m_manager->unsubscribeGamepad(this, m_deviceId);
+    }
+}
 
 void Gamepad::classBegin()
 {
@@ -45,6 +51,10 @@ void Gamepad::setDeviceId(int deviceId)
     if (m_deviceId == deviceId) {
         return;
     }
+    if (m_manager) {
+        m_manager->unsubscribeGamepad(this, m_deviceId);
+        m_manager->subscribeGamepad(this, deviceId);
+    }
     m_deviceId = deviceId;
 
     resetState();
@@ -234,11 +244,7 @@ void Gamepad::handleAxisEvent(deckshell::deckgamepad::DeckGamepadAxisEvent event
     }
 
     m_pendingAxisMask |= (1u << static_cast<uint32_t>(axis));
-
-    if (!m_coalesceTimer.isActive()) {
-        m_pendingCoalesceStartWallclockMs = QDateTime::currentMSecsSinceEpoch();
-        m_coalesceTimer.start();
-    }
+    scheduleFlush();
 }
 
 void Gamepad::handleHatEvent(deckshell::deckgamepad::DeckGamepadHatEvent event)
@@ -298,21 +304,65 @@ void Gamepad::handleHatEvent(deckshell::deckgamepad::DeckGamepadHatEvent event)
 
     m_pendingHatMask |= static_cast<uint8_t>(1u << static_cast<uint32_t>(hat));
     m_pendingHatDirectionByHat[static_cast<size_t>(hat)] = value;
+    scheduleFlush();
+}
 
-    if (!m_coalesceTimer.isActive()) {
+void Gamepad::scheduleFlush()
+{
+    if (m_pendingCoalesceStartWallclockMs < 0) {
         m_pendingCoalesceStartWallclockMs = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    // 有窗口时挂到下一次 afterAnimating（GUI 线程、下一帧绑定求值之前）：一帧内的多次轴/hat 变化
+    // 只产生一次属性通知。这里不请求 update()，不会仅因输入事件让窗口多出帧。
+    if (!m_frameConnection) {
+        if (auto *window = resolveFrameWindow()) {
+            m_frameConnection = connect(window,
+                                        &QQuickWindow::afterAnimating,
+                                        this,
+                                        &Gamepad::flushPendingChanges,
+                                        Qt::SingleShotConnection);
+        }
+    }
+
+    // 窗口被遮挡/未暴露或本身没有重绘时不会出帧，定时器保证属性仍会在 coalesceIntervalMs 内更新。
+    if (!m_coalesceTimer.isActive()) {
         m_coalesceTimer.start();
     }
 }
 
+QQuickWindow *Gamepad::resolveFrameWindow()
+{
+    QQuickWindow *window = nullptr;
+    for (QObject *obj = parent(); obj; obj = obj->parent()) {
+        if (auto *item = qobject_cast<QQuickItem *>(obj)) {
+            window = item->window();
+            break;
+        }
+        if (auto *quickWindow = qobject_cast<QQuickWindow *>(obj)) {
+            window = quickWindow;
+            break;
+        }
+    }
+
+    m_frameWindow = window;
+    return window;
+}
+
 void Gamepad::flushPendingChanges()
 {
+    // 定时器兜底先触发时撤掉尚未触发的帧挂钩，下一批再重新挂。
+    disconnect(m_frameConnection);
+    m_frameConnection = {};
+
     const uint32_t pendingAxis = m_pendingAxisMask;
     const uint8_t pendingHats = m_pendingHatMask;
     if (pendingAxis == 0 && pendingHats == 0) {
         return;
     }
 
+    m_coalesceTimer.stop();
+
     const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
     if (m_pendingCoalesceStartWallclockMs >= 0) {
         m_lastCoalesceLatencyMs = static_cast<int>(qMax<qint64>(0, nowMs - m_pendingCoalesceStartWallclockMs));
@@ -511,9 +561,6 @@ void Gamepad::emitAxisNotify(GamepadAxis axis)
 void Gamepad::resetState()
 {
     m_coalesceTimer.stop();
-    m_buttonStates.fill(false);
-    m_axisValues.fill(0.0);
-    m_hatDirectionByHat.fill(deckshell::deckgamepad::GAMEPAD_HAT_CENTER);
     m_pendingAxisMask = 0;
     m_pendingHatMask = 0;
     m_pendingHatDirectionByHat.fill(deckshell::deckgamepad::GAMEPAD_HAT_CENTER);
@@ -525,36 +572,48 @@ void Gamepad::resetState()
     m_hatNotifyCount = 0;
     m_lastCoalesceLatencyMs = 0;
 
-    Q_EMIT hatDirectionChanged();
-    Q_EMIT hat1DirectionChanged();
-    Q_EMIT hat2DirectionChanged();
-    Q_EMIT hat3DirectionChanged();
-    Q_EMIT statsChanged();
+    // 只对实际发生变化的属性发通知，避免切换 deviceId 时整批唤醒 QML 绑定。
+    for (int hat = 0; hat < 4; ++hat) {
+        int &direction = m_hatDirectionByHat[static_cast<size_t>(hat)];
+        if (direction == deckshell::deckgamepad::GAMEPAD_HAT_CENTER) {
+            continue;
+        }
+        direction = deckshell::deckgamepad::GAMEPAD_HAT_CENTER;
+        switch (hat) {
+        case 0:
+            Q_EMIT hatDirectionChanged();
+            break;
+        case 1:
+            Q_EMIT hat1DirectionChanged();
+            break;
+        case 2:
+            Q_EMIT hat2DirectionChanged();
+            break;
+        case 3:
+            Q_EMIT hat3DirectionChanged();
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (int button = 0; button < static_cast<int>(m_buttonStates.size()); ++button) {
+        if (!m_buttonStates[static_cast<size_t>(button)]) {
+            continue;
+        }
+        m_buttonStates[static_cast<size_t>(button)] = false;
+        emitButtonNotify(static_cast<GamepadButton>(button));
+    }
 
-    Q_EMIT buttonAChanged();
-    Q_EMIT buttonBChanged();
-    Q_EMIT buttonXChanged();
-    Q_EMIT buttonYChanged();
-    Q_EMIT buttonL1Changed();
-    Q_EMIT buttonR1Changed();
-    Q_EMIT buttonL2Changed();
-    Q_EMIT buttonR2Changed();
-    Q_EMIT buttonSelectChanged();
-    Q_EMIT buttonStartChanged();
-    Q_EMIT buttonL3Changed();
-    Q_EMIT buttonR3Changed();
-    Q_EMIT buttonGuideChanged();
-    Q_EMIT buttonDpadUpChanged();
-    Q_EMIT buttonDpadDownChanged();
-    Q_EMIT buttonDpadLeftChanged();
-    Q_EMIT buttonDpadRightChanged();
-
-    Q_EMIT axisLeftXChanged();
-    Q_EMIT axisLeftYChanged();
-    Q_EMIT axisRightXChanged();
-    Q_EMIT axisRightYChanged();
-    Q_EMIT axisTriggerLeftChanged();
-    Q_EMIT axisTriggerRightChanged();
+    for (int axis = 0; axis < static_cast<int>(m_axisValues.size()); ++axis) {
+        if (m_axisValues[static_cast<size_t>(axis)] == 0.0) {
+            continue;
+        }
+        m_axisValues[static_cast<size_t>(axis)] = 0.0;
+        emitAxisNotify(static_cast<GamepadAxis>(axis));
+    }
+
+    Q_EMIT statsChanged();
 }
 
 void Gamepad::syncDeviceInfo()
@@ -608,10 +667,7 @@ void Gamepad::rebuildSubscriptions(GamepadManager *mgr)
 
     if (m_manager) {
         disconnect(m_manager, nullptr, this, nullptr);
-    }
-
-    if (auto *prevSvc = m_manager ? m_manager->service() : nullptr) {
-        disconnect(prevSvc, nullptr, this, nullptr);
+        m_manager->unsubscribeGamepad(this, m_deviceId);
     }
 
     m_manager = mgr;
@@ -619,32 +675,8 @@ void Gamepad::rebuildSubscriptions(GamepadManager *mgr)
     connect(m_manager, &GamepadManager::gamepadConnected, this, &Gamepad::handleDeviceConnected);
     connect(m_manager, &GamepadManager::gamepadDisconnected, this, &Gamepad::handleDeviceDisconnected);
 
-    if (auto *svc = m_manager->service()) {
-        connect(svc,
-                &DeckGamepadService::buttonEvent,
-                this,
-                [this](int deviceId, deckshell::deckgamepad::DeckGamepadButtonEvent event) {
-                    if (deviceId == m_deviceId) {
-                        handleButtonEvent(event);
-                    }
-                });
-        connect(svc,
-                &DeckGamepadService::axisEvent,
-                this,
-                [this](int deviceId, deckshell::deckgamepad::DeckGamepadAxisEvent event) {
-                    if (deviceId == m_deviceId) {
-                        handleAxisEvent(event);
-                    }
-                });
-        connect(svc,
-                &DeckGamepadService::hatEvent,
-                this,
-                [this](int deviceId, deckshell::deckgamepad::DeckGamepadHatEvent event) {
-                    if (deviceId == m_deviceId) {
-                        handleHatEvent(event);
-                    }
-                });
-    }
+    // 原始事件由 GamepadManager 按 deviceId 直接投递（见 GamepadManager::subscribeGamepad）。
+    m_manager->subscribeGamepad(this, m_deviceId);
 
     syncDeviceInfo();
 }
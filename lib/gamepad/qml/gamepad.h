@@ -8,6 +8,7 @@
 
 #include <array>
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
 #include <QtCore/QTimer>
 #include <QtCore/QString>
 #include <QtQml/QQmlParserStatus>
@@ -15,6 +16,10 @@
 
 class GamepadManager;
 
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+QT_END_NAMESPACE
+
 class Gamepad : public QObject, public QQmlParserStatus
 {
     Q_OBJECT
@@ -28,6 +33,8 @@ class Gamepad : public QObject, public QQmlParserStatus
     // 高频轴/hat 的属性通知合并（coalesce）配置与可观测性。
     // - coalesceIntervalMs <= 0：不合并，收到事件后立即发出属性通知。
     // - coalesceIntervalMs > 0：按窗口合并，窗口结束时批量发出属性通知（raw event 信号不受影响）。
+    //   所在 QQuickWindow 可用时改为按帧合并（挂到下一次 afterAnimating，不主动请求重绘），
+    //   interval 仅作窗口不出帧时的兜底。
     Q_PROPERTY(int coalesceIntervalMs READ coalesceIntervalMs WRITE setCoalesceIntervalMs NOTIFY coalesceIntervalMsChanged FINAL)
     Q_PROPERTY(quint64 axisRawEventCount READ axisRawEventCount NOTIFY statsChanged FINAL)
     Q_PROPERTY(quint64 axisNotifyCount READ axisNotifyCount NOTIFY statsChanged FINAL)
@@ -170,6 +177,8 @@ Q_SIGNALS:
     void hatEvent(int hat, int value, int timeMs);
 
 private:
+    friend class GamepadManager;
+
     void ensureManagerResolved();
     void rebuildSubscriptions(GamepadManager *mgr);
 
@@ -180,7 +189,9 @@ private:
     void handleAxisEvent(deckshell::deckgamepad::DeckGamepadAxisEvent event);
     void handleHatEvent(deckshell::deckgamepad::DeckGamepadHatEvent event);
 
+    void scheduleFlush();
     void flushPendingChanges();
+    QQuickWindow *resolveFrameWindow();
 
     bool buttonState(deckshell::deckgamepad::GamepadButton button) const;
     void setButtonState(deckshell::deckgamepad::GamepadButton button, bool pressed);
@@ -193,7 +204,7 @@ private:
     void resetState();
     void syncDeviceInfo();
 
-    GamepadManager *m_manager = nullptr;
+    QPointer<GamepadManager> m_manager;
 
     int m_deviceId = -1;
     bool m_connected = false;
@@ -215,6 +226,8 @@ private:
 
     int m_coalesceIntervalMs = 16;
     QTimer m_coalesceTimer;
+    QPointer<QQuickWindow> m_frameWindow;
+    QMetaObject::Connection m_frameConnection;
     qint64 m_pendingCoalesceStartWallclockMs = -1;
 
     quint64 m_axisRawEventCount = 0;
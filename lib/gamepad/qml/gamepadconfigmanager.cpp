@@ -7,6 +7,9 @@
 #include <deckshell/deckgamepad/extras/keyboardmappingprofile.h>
 #include <deckshell/deckgamepad/service/deckgamepadservice.h>
 
+#include <QCborMap>
+#include <QCborValue>
+#include <QCryptographicHash>
 #include <QFile>
 #include <QSaveFile>
 #include <QJsonDocument>
@@ -19,6 +22,8 @@
 #include <QTimer>
 #include <QtQml/QQmlContext>
 
+#include <sys/stat.h>
+
 using namespace deckshell::deckgamepad;
 
 namespace {
@@ -41,31 +46,37 @@ bool ensureParentDirExists(const QString &filePath, QString *errorMessage)
     return false;
 }
 
-bool backupExistingFile(const QString &filePath, QString *errorMessage)
-{
-    if (!QFile::exists(filePath)) {
-        return true;
-    }
+// 源文件 size + mtime(ns)：解析结果缓存的有效性校验依据。
+struct ConfigSourceStamp {
+    qint64 size = -1;
+    qint64 mtimeNs = -1;
 
-    const QString backupPath = filePath + QStringLiteral(".bak");
-    if (QFile::exists(backupPath) && !QFile::remove(backupPath)) {
-        if (errorMessage) {
-            *errorMessage = QStringLiteral("Failed to remove existing backup: %1").arg(backupPath);
-        }
-        return false;
-    }
+    bool isValid() const { return size >= 0; }
+    bool operator==(const ConfigSourceStamp &other) const { return size == other.size && mtimeNs == other.mtimeNs; }
+    bool operator!=(const ConfigSourceStamp &other) const { return !(*this == other); }
+};
 
-    if (!QFile::copy(filePath, backupPath)) {
-        if (errorMessage) {
-            *errorMessage = QStringLiteral("Failed to create backup: %1").arg(backupPath);
-        }
-        return false;
-    }
+ConfigSourceStamp stampFromStat(const struct stat &st)
+{
+    ConfigSourceStamp stamp;
+    stamp.size = static_cast<qint64>(st.st_size);
+    stamp.mtimeNs = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return stamp;
+}
 
-    return true;
+ConfigSourceStamp statConfigSource(const QString &path)
+{
+    struct stat st {};
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0) {
+        return {};
+    }
+    return stampFromStat(st);
 }
 
-bool writeJsonAtomically(const QString &filePath, const QJsonObject &json, QString *errorMessage)
+// committedStamp 取自 commit 前的临时文件描述符：rename 不改变 size/mtime，
+// 因此它就是本次写入内容的 stamp，不会混入 commit 之后其他写者的改动。
+bool writeJsonAtomically(const QString &filePath, const QJsonObject &json, QString *errorMessage,
+                         ConfigSourceStamp *committedStamp)
 {
     QSaveFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
@@ -84,6 +95,11 @@ bool writeJsonAtomically(const QString &filePath, const QJsonObject &json, QStri
         return false;
     }
 
+    if (committedStamp) {
+        struct stat st {};
+        *committedStamp = file.flush() && ::fstat(file.handle(), &st) == 0 ? stampFromStat(st) : ConfigSourceStamp{};
+    }
+
     if (!file.commit()) {
         if (errorMessage) {
             *errorMessage = file.errorString();
@@ -94,17 +110,133 @@ bool writeJsonAtomically(const QString &filePath, const QJsonObject &json, QStri
     return true;
 }
 
-bool writeJsonWithBackupAtomic(const QString &filePath, const QJsonObject &json, QString *errorMessage)
+// QSaveFile 写临时文件后 rename 覆盖：读者只会看到旧文件或完整的新文件，不再额外复制 .bak。
+bool writeJsonFileAtomic(const QString &filePath, const QJsonObject &json, QString *errorMessage,
+                         ConfigSourceStamp *committedStamp = nullptr)
 {
     if (!ensureParentDirExists(filePath, errorMessage)) {
         return false;
     }
 
-    if (!backupExistingFile(filePath, errorMessage)) {
+    return writeJsonAtomically(filePath, json, errorMessage, committedStamp);
+}
+
+// ========== 解析结果二进制缓存 ==========
+// $XDG_CACHE_HOME/deckshell-gamepad/config-<hash(源文件绝对路径)>.cbor，以源文件 size + mtime(ns) 校验；
+// 命中时冷启动跳过 JSON 解析，源文件变化（含外部编辑/热更新）时重新解析并刷新缓存。
+
+constexpr int kConfigCacheVersion = 1;
+
+QString configCachePath(const QString &sourcePath)
+{
+    const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (cacheRoot.isEmpty()) {
+        return {};
+    }
+
+    const QByteArray absolutePath = QFileInfo(sourcePath).absoluteFilePath().toUtf8();
+    const QByteArray key = QCryptographicHash::hash(absolutePath, QCryptographicHash::Sha1).toHex().left(16);
+    return QDir(cacheRoot).filePath(QStringLiteral("deckshell-gamepad/config-%1.cbor").arg(QString::fromLatin1(key)));
+}
+
+bool readConfigCache(const QString &sourcePath, const ConfigSourceStamp &stamp, QJsonObject *config)
+{
+    const QString cachePath = configCachePath(sourcePath);
+    if (cachePath.isEmpty() || !stamp.isValid()) {
+        return false;
+    }
+
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QCborParserError error;
+    const QCborValue root = QCborValue::fromCbor(file.readAll(), &error);
+    if (error.error != QCborError::NoError || !root.isMap()) {
+        return false;
+    }
+
+    const QCborMap map = root.toMap();
+    if (map.value(QStringLiteral("version")).toInteger() != kConfigCacheVersion
+        || map.value(QStringLiteral("size")).toInteger(-1) != stamp.size
+        || map.value(QStringLiteral("mtimeNs")).toInteger(-1) != stamp.mtimeNs) {
+        return false;
+    }
+
+    const QCborValue value = map.value(QStringLiteral("config"));
+    if (!value.isMap()) {
+        return false;
+    }
+    *config = value.toJsonValue().toObject();
+    return true;
+}
+
+// stamp 为读取源文件之前、或写入时在 commit 之前取得的状态；源文件在此期间又被改动时不写缓存，
+// 否则旧内容会带着新 size/mtime 入缓存，下次冷启动命中过期配置。
+void writeConfigCache(const QString &sourcePath, const QJsonObject &config, const ConfigSourceStamp &stamp)
+{
+    const QString cachePath = configCachePath(sourcePath);
+    if (cachePath.isEmpty() || !stamp.isValid() || statConfigSource(sourcePath) != stamp) {
+        return;
+    }
+    if (!ensureParentDirExists(cachePath, nullptr)) {
+        return;
+    }
+
+    QCborMap map;
+    map.insert(QStringLiteral("version"), kConfigCacheVersion);
+    map.insert(QStringLiteral("size"), stamp.size);
+    map.insert(QStringLiteral("mtimeNs"), stamp.mtimeNs);
+    map.insert(QStringLiteral("config"), QCborValue::fromJsonValue(config));
+
+    // 缓存写失败只影响下次冷启动速度，不上报错误。
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    if (file.write(map.toCborValue().toCbor()) == -1) {
+        file.cancelWriting();
+        return;
+    }
+    file.commit();
+}
+
+// 读取配置：优先命中二进制缓存，否则解析 JSON 并刷新缓存。
+bool readConfigFile(const QString &path, QJsonObject *config, QString *errorMessage)
+{
+    const ConfigSourceStamp stamp = statConfigSource(path);
+    if (!stamp.isValid()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Failed to open gamepad config file");
+        }
+        return false;
+    }
+
+    if (readConfigCache(path, stamp, config)) {
+        return true;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Failed to open gamepad config file");
+        }
         return false;
     }
 
-    return writeJsonAtomically(filePath, json, errorMessage);
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+    if (doc.isNull() || !doc.isObject()) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Invalid gamepad config JSON");
+        }
+        return false;
+    }
+
+    *config = doc.object();
+    writeConfigCache(path, *config, stamp);
+    return true;
 }
 
 } // namespace
@@ -115,6 +247,8 @@ GamepadConfigManager::GamepadConfigManager(QObject *parent)
     : QObject(parent)
     , m_hotReloadEnabled(false)
     , m_fileWatcher(new QFileSystemWatcher(this))
+    , m_reloadTimer(new QTimer(this))
+    , m_saveTimer(new QTimer(this))
     , m_deadzoneTrialTimer(new QTimer(this))
     , m_autoAssignPlayer(true)
     , m_defaultDeadzone(0.15f)
@@ -126,6 +260,17 @@ GamepadConfigManager::GamepadConfigManager(QObject *parent)
     connect(m_fileWatcher, &QFileSystemWatcher::fileChanged,
             this, &GamepadConfigManager::onFileChanged);
 
+    // 编辑器保存常是多次写/rename：合并为一次重载
+    m_reloadTimer->setSingleShot(true);
+    m_reloadTimer->setInterval(kReloadDebounceMs);
+    connect(m_reloadTimer, &QTimer::timeout, this, &GamepadConfigManager::reloadIfChanged);
+
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(kSaveDebounceMs);
+    connect(m_saveTimer, &QTimer::timeout, this, [this] {
+        saveConfig();
+    });
+
     if (m_deadzoneTrialTimer) {
         m_deadzoneTrialTimer->setSingleShot(true);
         connect(m_deadzoneTrialTimer, &QTimer::timeout, this, [this] {
@@ -161,6 +306,10 @@ QString GamepadConfigManager::configDir() const
 
 GamepadConfigManager::~GamepadConfigManager()
 {
+    // 尚未落盘的防抖保存在析构时补写
+    if (m_saveTimer->isActive()) {
+        saveConfig();
+    }
     m_instance = nullptr;
 }
 
@@ -209,12 +358,15 @@ void GamepadConfigManager::setService(DeckGamepadService *service)
     }
 
     m_service = service;
+    m_appliedAxes.clear();
     if (!m_service) {
         return;
     }
 
     connect(m_service, &DeckGamepadService::gamepadConnected,
             this, &GamepadConfigManager::onGamepadConnected);
+    connect(m_service, &DeckGamepadService::gamepadDisconnected,
+            this, &GamepadConfigManager::onGamepadDisconnected);
 
     // 同步已连接设备（避免注入发生在 service 已启动之后时漏应用配置）
     const auto deviceIds = m_service->connectedGamepads();
@@ -302,33 +454,31 @@ bool GamepadConfigManager::loadConfig(const QString &filePath)
         pathToLoad = legacyPath;
     }
 
-    QFile file(pathToLoad);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Failed to open gamepad config file:" << pathToLoad;
-        loadDefaultConfig();
-        return false;
-    }
-
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull() || !doc.isObject()) {
-        qWarning() << "Invalid gamepad config JSON:" << pathToLoad;
+    QJsonObject json;
+    QString errorMessage;
+    if (!readConfigFile(pathToLoad, &json, &errorMessage)) {
+        qWarning() << errorMessage << pathToLoad;
         loadDefaultConfig();
         return false;
     }
 
-    if (!fromJson(doc.object())) {
+    const QJsonObject previous = m_config;
+    if (!fromJson(json)) {
         qWarning() << "Failed to parse gamepad config:" << pathToLoad;
         loadDefaultConfig();
         return false;
     }
 
+    // 试用中的 deadzone 被丢弃：按完整配置重算（m_appliedAxes 过滤未变化的轴）；否则只重应用差异部分。
+    const bool hadTrial = hasDeadzoneTrial();
     clearDeadzoneTrialState();
 
     m_configFilePath = filePath.isEmpty() ? preferredPath : pathToLoad;
-    applyConfig();
+    if (hadTrial) {
+        applyConfig();
+    } else {
+        applyConfigChanges(previous);
+    }
 
     qInfo() << "Loaded gamepad config from:" << pathToLoad;
     Q_EMIT configLoaded();
@@ -343,11 +493,17 @@ bool GamepadConfigManager::saveConfig(const QString &filePath)
         path = getDefaultConfigPath();
     }
 
+    // 显式保存覆盖尚未触发的防抖保存
+    m_saveTimer->stop();
+
     QString errorMessage;
-    if (!writeJsonWithBackupAtomic(path, toJson(), &errorMessage)) {
+    ConfigSourceStamp committedStamp;
+    if (!writeJsonFileAtomic(path, toJson(), &errorMessage, &committedStamp)) {
         qWarning() << "Failed to save gamepad config file:" << path << errorMessage;
         return false;
     }
+    // 取不到写入时的 stamp 则不写缓存（writeConfigCache 忽略无效 stamp），下次加载重新解析。
+    writeConfigCache(path, m_config, committedStamp);
 
     m_configFilePath = path;
     qInfo() << "Saved gamepad config to:" << path;
@@ -355,6 +511,11 @@ bool GamepadConfigManager::saveConfig(const QString &filePath)
     return true;
 }
 
+void GamepadConfigManager::requestSave()
+{
+    m_saveTimer->start();
+}
+
 void GamepadConfigManager::loadDefaultConfig()
 {
     // Embedded default config
@@ -389,10 +550,16 @@ void GamepadConfigManager::loadDefaultConfig()
 
     config["devices"] = QJsonObject();
 
+    const QJsonObject previous = m_config;
     fromJson(config);
 
+    const bool hadTrial = hasDeadzoneTrial();
     clearDeadzoneTrialState();
-    applyConfig();
+    if (hadTrial) {
+        applyConfig();
+    } else {
+        applyConfigChanges(previous);
+    }
 
     qInfo() << "Loaded default gamepad config";
 }
@@ -418,12 +585,35 @@ void GamepadConfigManager::onFileChanged(const QString &path)
     if (path != m_configFilePath)
         return;
 
-    qInfo() << "Gamepad config file changed, reloading...";
+    m_reloadTimer->start();
+}
 
-    // Re-add the watch (it's automatically removed after the file is modified)
-    m_fileWatcher->addPath(m_configFilePath);
+void GamepadConfigManager::reloadIfChanged()
+{
+    if (!m_hotReloadEnabled || m_configFilePath.isEmpty()) {
+        return;
+    }
 
-    // Reload configuration
+    // 原子替换（rename）后 inotify 监视随旧 inode 失效：重新添加
+    if (!m_fileWatcher->files().contains(m_configFilePath)) {
+        m_fileWatcher->addPath(m_configFilePath);
+    }
+
+    QJsonObject json;
+    QString errorMessage;
+    if (!readConfigFile(m_configFilePath, &json, &errorMessage)) {
+        // 编辑中途的半成品/暂时缺失：保留当前配置，等下一次变更
+        qWarning() << "Gamepad config hot reload skipped:" << errorMessage << m_configFilePath;
+        return;
+    }
+
+    // 自身保存引起的通知，或内容未变化的写入
+    if (json == m_config) {
+        return;
+    }
+
+    qInfo() << "Gamepad config file changed, applying differences...";
+    m_saveTimer->stop();
     if (loadConfig(m_configFilePath)) {
         Q_EMIT hotReloadTriggered();
     }
@@ -433,6 +623,9 @@ void GamepadConfigManager::onGamepadConnected(int deviceId, const QString &name)
 {
     Q_UNUSED(name);
 
+    // 新打开的设备参数为后端默认值：不沿用旧的下发记录
+    m_appliedAxes.remove(deviceId);
+
     // Apply device-specific configuration if available
     applyDeviceConfig(deviceId);
 
@@ -445,6 +638,11 @@ void GamepadConfigManager::onGamepadConnected(int deviceId, const QString &name)
     }
 }
 
+void GamepadConfigManager::onGamepadDisconnected(int deviceId)
+{
+    m_appliedAxes.remove(deviceId);
+}
+
 bool GamepadConfigManager::autoAssignPlayer() const
 {
     return m_autoAssignPlayer;
@@ -564,7 +762,7 @@ void GamepadConfigManager::setKeyboardMappingEnabled(bool enabled)
     Q_EMIT configChanged();
     
     // Auto-save configuration
-    saveConfig();
+    requestSave();
 }
 
 float GamepadConfigManager::deviceDeadzone(int deviceId, uint32_t axis) const
@@ -598,9 +796,7 @@ void GamepadConfigManager::setDeviceDeadzone(int deviceId, uint32_t axis, float
 {
     deadzone = qBound(0.0f, deadzone, 1.0f);
 
-    if (m_service) {
-        m_service->setAxisDeadzone(deviceId, axis, deadzone);
-    }
+    applyAxisDeadzone(deviceId, axis, deadzone);
 }
 
 float GamepadConfigManager::persistedDeviceDeadzone(int deviceId, uint32_t axis) const
@@ -688,9 +884,7 @@ bool GamepadConfigManager::beginDeadzoneTrialDeviceAxis(int deviceId,
 
     refreshDeadzoneTrialTimer(ttlMs);
 
-    if (m_service) {
-        m_service->setAxisDeadzone(deviceId, axis, deadzone);
-    }
+    applyAxisDeadzone(deviceId, axis, deadzone);
 
     Q_EMIT configChanged();
     return true;
@@ -811,9 +1005,7 @@ void GamepadConfigManager::setDeviceSensitivity(int deviceId, uint32_t axis, flo
     devices[deviceKey] = device;
     m_config["devices"] = devices;
 
-    if (m_service) {
-        m_service->setAxisSensitivity(deviceId, axis, sensitivity);
-    }
+    applyAxisSensitivity(deviceId, axis, sensitivity);
 
     Q_EMIT configChanged();
 }
@@ -872,21 +1064,82 @@ void GamepadConfigManager::applyDeviceConfig(int deviceId)
     if (!m_service)
         return;
 
-    // For now, apply default deadzone and sensitivity to all axes
-    // In the future, this could be more sophisticated with per-axis config
-    const int NUM_AXES = 6;  // Typical gamepad has 6 axes (LX, LY, RX, RY, LT, RT)
+    for (int axis = 0; axis < kConfigAxisCount; ++axis) {
+        applyAxisDeadzone(deviceId, axis, deviceDeadzone(deviceId, axis));
+        applyAxisSensitivity(deviceId, axis, deviceSensitivity(deviceId, axis));
+    }
+}
+
+void GamepadConfigManager::applyConfigChanges(const QJsonObject &previous)
+{
+    if (!m_service)
+        return;
+
+    const QJsonObject oldGlobal = previous.value("global").toObject();
+    const QJsonObject newGlobal = m_config.value("global").toObject();
+
+    if (oldGlobal.value("enableVibration").toBool(true) && !m_vibrationEnabled) {
+        const auto deviceIds = m_service->connectedGamepads();
+        for (int deviceId : deviceIds) {
+            m_service->stopVibration(deviceId);
+        }
+    }
+
+    // 全局默认值作用于所有未单独配置的轴：逐设备重算；否则只处理 devices 下内容变化的条目。
+    const bool defaultsChanged = oldGlobal.value("defaultDeadzone") != newGlobal.value("defaultDeadzone")
+        || oldGlobal.value("defaultSensitivity") != newGlobal.value("defaultSensitivity");
+    const QJsonObject oldDevices = previous.value("devices").toObject();
+    const QJsonObject newDevices = m_config.value("devices").toObject();
+
+    int appliedCount = 0;
+    const auto deviceIds = m_service->connectedGamepads();
+    for (int deviceId : deviceIds) {
+        if (!defaultsChanged) {
+            const QString preferredKey = getDeviceKey(deviceId);
+            const QString legacyKey = getLegacyDeviceKey(deviceId);
+            const bool sectionChanged = oldDevices.value(preferredKey) != newDevices.value(preferredKey)
+                || (!legacyKey.isEmpty() && oldDevices.value(legacyKey) != newDevices.value(legacyKey));
+            if (!sectionChanged) {
+                continue;
+            }
+        }
+        applyDeviceConfig(deviceId);
+        ++appliedCount;
+    }
+
+    if (appliedCount > 0) {
+        qInfo() << "Applied gamepad configuration changes to" << appliedCount << "device(s)";
+    }
+}
 
-    for (int axis = 0; axis < NUM_AXES; ++axis) {
-        float deadzone = deviceDeadzone(deviceId, axis);
-        float sensitivity = deviceSensitivity(deviceId, axis);
+void GamepadConfigManager::applyAxisDeadzone(int deviceId, uint32_t axis, float deadzone)
+{
+    if (!m_service)
+        return;
 
-        m_service->setAxisDeadzone(deviceId, axis, deadzone);
-        m_service->setAxisSensitivity(deviceId, axis, sensitivity);
+    if (axis < static_cast<uint32_t>(kConfigAxisCount)) {
+        std::optional<float> &applied = m_appliedAxes[deviceId].deadzone[axis];
+        if (applied && *applied == deadzone) {
+            return;
+        }
+        applied = deadzone;
     }
+    m_service->setAxisDeadzone(deviceId, axis, deadzone);
+}
+
+void GamepadConfigManager::applyAxisSensitivity(int deviceId, uint32_t axis, float sensitivity)
+{
+    if (!m_service)
+        return;
 
-    qDebug() << "Applied config for gamepad" << deviceId
-                           << "deadzone:" << m_defaultDeadzone
-                           << "sensitivity:" << m_defaultSensitivity;
+    if (axis < static_cast<uint32_t>(kConfigAxisCount)) {
+        std::optional<float> &applied = m_appliedAxes[deviceId].sensitivity[axis];
+        if (applied && *applied == sensitivity) {
+            return;
+        }
+        applied = sensitivity;
+    }
+    m_service->setAxisSensitivity(deviceId, axis, sensitivity);
 }
 
 QJsonObject GamepadConfigManager::toJson() const
@@ -1119,7 +1372,7 @@ bool GamepadConfigManager::renameProfile(const QString &oldName, const QString &
         QJsonObject km = m_config["keyboard_mapping"].toObject();
         km["current_profile"] = newName;
         m_config["keyboard_mapping"] = km;
-        saveConfig();
+        requestSave();
         emit currentProfileChanged(newName);
     }
     
@@ -1181,7 +1434,7 @@ bool GamepadConfigManager::saveProfile(const KeyboardMappingProfile &profile)
     updatedProfile.modifiedAt = QDateTime::currentDateTime();
     
     QString errorMessage;
-    if (!writeJsonWithBackupAtomic(profilePath, updatedProfile.toJson(), &errorMessage)) {
+    if (!writeJsonFileAtomic(profilePath, updatedProfile.toJson(), &errorMessage)) {
         qWarning() << "Failed to save profile:" << profilePath << errorMessage;
         return false;
     }
@@ -9,8 +9,12 @@
 #include <QJsonObject>
 #include <QFileSystemWatcher>
 #include <QQmlEngine>
+#include <QHash>
 #include <QMap>
 
+#include <array>
+#include <optional>
+
 #include <deckshell/deckgamepad/extras/keyboardmappingprofile.h>
 
 class QTimer;
@@ -45,6 +49,8 @@ public:
     // 配置加载/保存
     Q_INVOKABLE bool loadConfig(const QString &filePath = QString());
     Q_INVOKABLE bool saveConfig(const QString &filePath = QString());
+    // 防抖保存：连续修改只在最后一次修改 kSaveDebounceMs 后写一次（QSaveFile 原子替换）
+    Q_INVOKABLE void requestSave();
     Q_INVOKABLE void loadDefaultConfig();
 
     // 热更新
@@ -136,6 +142,7 @@ Q_SIGNALS:
 private Q_SLOTS:
     void onFileChanged(const QString &path);
     void onGamepadConnected(int deviceId, const QString &name);
+    void onGamepadDisconnected(int deviceId);
 
 private:
     QString configDir() const;
@@ -144,6 +151,12 @@ private:
     QString getLegacyDeviceKey(int deviceId) const;
     QString getDeviceKeyForRead(int deviceId) const;
     void applyDeviceConfig(int deviceId);
+    // 按新旧文档差异只重应用受影响的设备（全局默认值变化时逐设备重算）
+    void applyConfigChanges(const QJsonObject &previous);
+    // 下发前与 m_appliedAxes 比较，值未变化的轴不再调用 service
+    void applyAxisDeadzone(int deviceId, uint32_t axis, float deadzone);
+    void applyAxisSensitivity(int deviceId, uint32_t axis, float sensitivity);
+    void reloadIfChanged();
     float persistedDeviceDeadzone(int deviceId, uint32_t axis) const;
     void clearDeadzoneTrialState();
     void refreshDeadzoneTrialTimer(int ttlMs);
@@ -160,6 +173,10 @@ private:
 
     static GamepadConfigManager *m_instance;
 
+    static constexpr int kConfigAxisCount = 6; // LX, LY, RX, RY, LT, RT
+    static constexpr int kSaveDebounceMs = 300;
+    static constexpr int kReloadDebounceMs = 100;
+
     deckshell::deckgamepad::DeckGamepadService *m_service = nullptr;
 
     // 配置数据
@@ -169,6 +186,15 @@ private:
     // 热更新
     bool m_hotReloadEnabled;
     QFileSystemWatcher *m_fileWatcher;
+    QTimer *m_reloadTimer = nullptr;
+    QTimer *m_saveTimer = nullptr;
+
+    // 已下发到 service 的每设备轴参数（设备重连时清空）
+    struct AppliedDeviceAxes {
+        std::array<std::optional<float>, kConfigAxisCount> deadzone;
+        std::array<std::optional<float>, kConfigAxisCount> sensitivity;
+    };
+    QHash<int, AppliedDeviceAxes> m_appliedAxes;
 
     struct DeadzoneTrialAxisEntry {
         float baseline = 0.0f;
@@ -5,6 +5,7 @@
 #include "gamepadmanager.h"
 
 #include "custommappingmanager.h"
+#include "gamepad.h"
 #include "gamepaddevicemodel.h"
 
 #include <deckshell/deckgamepad/service/deckgamepadservice.h>
@@ -465,6 +466,109 @@ void GamepadManager::refreshDeviceModel()
     }
 }
 
+void GamepadManager::subscribeGamepad(Gamepad *gamepad, int deviceId)
+{
+    if (!gamepad || deviceId < 0) {
+        return;
+    }
+    QList<QPointer<Gamepad>> &subscribers = m_gamepadSubscribers[deviceId];
+    for (const QPointer<Gamepad> &existing : std::as_const(subscribers)) {
+        if (existing == gamepad) {
+            return;
+        }
+    }
+    subscribers.append(gamepad);
+}
+
+void GamepadManager::unsubscribeGamepad(Gamepad *gamepad, int deviceId)
+{
+    auto it = m_gamepadSubscribers.find(deviceId);
+    if (it == m_gamepadSubscribers.end()) {
+        return;
+    }
+    it->removeIf([gamepad](const QPointer<Gamepad> &entry) {
+        return entry.isNull() || entry == gamepad;
+    });
+    if (it->isEmpty()) {
+        m_gamepadSubscribers.erase(it);
+    }
+}
+
+int GamepadManager::gamepadSubscriberCount(int deviceId) const
+{
+    return static_cast<int>(m_gamepadSubscribers.value(deviceId).size());
+}
+
+void GamepadManager::dispatchButtonEvent(int deviceId, const deckshell::deckgamepad::DeckGamepadButtonEvent &event)
+{
+    const int button = static_cast<int>(event.button);
+    Q_EMIT buttonEvent(deviceId, button, event.pressed);
+    if (event.pressed) {
+        Q_EMIT buttonPressed(deviceId, button);
+    } else {
+        Q_EMIT buttonReleased(deviceId, button);
+    }
+
+    const auto it = m_gamepadSubscribers.constFind(deviceId);
+    if (it == m_gamepadSubscribers.cend()) {
+        return;
+    }
+    const QList<QPointer<Gamepad>> subscribers = it.value();
+    for (const QPointer<Gamepad> &gamepad : subscribers) {
+        if (gamepad && gamepad->deviceId() == deviceId) {
+            gamepad->handleButtonEvent(event);
+        }
+    }
+}
+
+void GamepadManager::dispatchAxisEvent(int deviceId, const deckshell::deckgamepad::DeckGamepadAxisEvent &event)
+{
+    const int axis = static_cast<int>(event.axis);
+    Q_EMIT axisEvent(deviceId, axis, event.value);
+    if (axis >= 0 && axis < deckshell::deckgamepad::GAMEPAD_AXIS_MAX) {
+        double &last = m_deviceSignalState[deviceId].axes[static_cast<size_t>(axis)];
+        if (last != event.value) {
+            last = event.value;
+            Q_EMIT axisChanged(deviceId, axis, event.value);
+        }
+    }
+
+    const auto it = m_gamepadSubscribers.constFind(deviceId);
+    if (it == m_gamepadSubscribers.cend()) {
+        return;
+    }
+    const QList<QPointer<Gamepad>> subscribers = it.value();
+    for (const QPointer<Gamepad> &gamepad : subscribers) {
+        if (gamepad && gamepad->deviceId() == deviceId) {
+            gamepad->handleAxisEvent(event);
+        }
+    }
+}
+
+void GamepadManager::dispatchHatEvent(int deviceId, const deckshell::deckgamepad::DeckGamepadHatEvent &event)
+{
+    const int hat = static_cast<int>(event.hat);
+    Q_EMIT hatEvent(deviceId, hat, event.value);
+    if (hat >= 0 && hat < 4) {
+        int &last = m_deviceSignalState[deviceId].hats[static_cast<size_t>(hat)];
+        if (last != event.value) {
+            last = event.value;
+            Q_EMIT hatChanged(deviceId, hat, event.value);
+        }
+    }
+
+    const auto it = m_gamepadSubscribers.constFind(deviceId);
+    if (it == m_gamepadSubscribers.cend()) {
+        return;
+    }
+    const QList<QPointer<Gamepad>> subscribers = it.value();
+    for (const QPointer<Gamepad> &gamepad : subscribers) {
+        if (gamepad && gamepad->deviceId() == deviceId) {
+            gamepad->handleHatEvent(event);
+        }
+    }
+}
+
 void GamepadManager::bindService(DeckGamepadService *service)
 {
     if (m_service == service) {
@@ -479,6 +583,7 @@ void GamepadManager::bindService(DeckGamepadService *service)
     }
 
     m_service = service;
+    m_deviceSignalState.clear();
 
     if (m_customMapping) {
         m_customMapping->setService(m_service);
@@ -499,6 +604,7 @@ void GamepadManager::bindService(DeckGamepadService *service)
         Q_EMIT gamepadConnected(deviceId, name);
     });
     connect(m_service, &DeckGamepadService::gamepadDisconnected, this, [this](int deviceId) {
+        m_deviceSignalState.remove(deviceId);
         refreshDeviceModel();
         Q_EMIT connectedCountChanged();
         Q_EMIT gamepadDisconnected(deviceId);
@@ -513,34 +619,9 @@ void GamepadManager::bindService(DeckGamepadService *service)
         Q_EMIT playerUnassigned(deviceId);
     });
 
-    connect(m_service,
-            &DeckGamepadService::buttonEvent,
-            this,
-            [this](int deviceId, deckshell::deckgamepad::DeckGamepadButtonEvent event) {
-                const int button = static_cast<int>(event.button);
-                Q_EMIT buttonEvent(deviceId, button, event.pressed);
-                if (event.pressed) {
-                    Q_EMIT buttonPressed(deviceId, button);
-                } else {
-                    Q_EMIT buttonReleased(deviceId, button);
-                }
-            });
-    connect(m_service,
-            &DeckGamepadService::axisEvent,
-            this,
-            [this](int deviceId, deckshell::deckgamepad::DeckGamepadAxisEvent event) {
-                const int axis = static_cast<int>(event.axis);
-                Q_EMIT axisEvent(deviceId, axis, event.value);
-                Q_EMIT axisChanged(deviceId, axis, event.value);
-            });
-    connect(m_service,
-            &DeckGamepadService::hatEvent,
-            this,
-            [this](int deviceId, deckshell::deckgamepad::DeckGamepadHatEvent event) {
-                const int hat = static_cast<int>(event.hat);
-                Q_EMIT hatEvent(deviceId, hat, event.value);
-                Q_EMIT hatChanged(deviceId, hat, event.value);
-            });
+    connect(m_service, &DeckGamepadService::buttonEvent, this, &GamepadManager::dispatchButtonEvent);
+    connect(m_service, &DeckGamepadService::axisEvent, this, &GamepadManager::dispatchAxisEvent);
+    connect(m_service, &DeckGamepadService::hatEvent, this, &GamepadManager::dispatchHatEvent);
 
     connect(m_service, &DeckGamepadService::lastErrorChanged, this, [this]() {
         updateErrorDiagnosticFromService();
@@ -4,19 +4,27 @@
 
 #pragma once
 
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QVariant>
 #include <QtQml/QQmlEngine>
 #include <QtQml/qqml.h>
 
+#include <array>
+
 namespace deckshell::deckgamepad {
 class DeckGamepadService;
 class IDeckGamepadProvider;
 }
 
 class CustomMappingManager;
+class Gamepad;
 class GamepadDeviceModel;
 
 class GamepadManager : public QObject
@@ -112,6 +120,11 @@ public:
 
     deckshell::deckgamepad::DeckGamepadService *service() const;
 
+    // 每设备订阅表：原始事件只投递给 deviceId 匹配的 Gamepad，不再由每个实例订阅全局信号后自行过滤。
+    void subscribeGamepad(Gamepad *gamepad, int deviceId);
+    void unsubscribeGamepad(Gamepad *gamepad, int deviceId);
+    int gamepadSubscriberCount(int deviceId) const;
+
 Q_SIGNALS:
     void backendModeChanged();
     void providerSelectionChanged();
@@ -134,6 +147,7 @@ Q_SIGNALS:
     void playerUnassigned(int deviceId);
     void buttonPressed(int deviceId, int button);
     void buttonReleased(int deviceId, int button);
+    // axisChanged/hatChanged 仅在值变化时发出（原始事件见 axisEvent/hatEvent）。
     void axisChanged(int deviceId, int axis, double value);
     void hatChanged(int deviceId, int hat, int direction);
 
@@ -141,6 +155,9 @@ private:
     static GamepadManager *s_instance;
 
     void refreshDeviceModel();
+    void dispatchButtonEvent(int deviceId, const deckshell::deckgamepad::DeckGamepadButtonEvent &event);
+    void dispatchAxisEvent(int deviceId, const deckshell::deckgamepad::DeckGamepadAxisEvent &event);
+    void dispatchHatEvent(int deviceId, const deckshell::deckgamepad::DeckGamepadHatEvent &event);
     void bindService(deckshell::deckgamepad::DeckGamepadService *service);
     bool hasExternalServiceInjected() const;
     bool startAuto();
@@ -175,4 +192,12 @@ private:
     DiagnosticKind m_diagnosticKind = DiagnosticKind::Ok;
 
     bool m_externalServiceInjected = false;
+
+    // 投递期间订阅者可能被销毁或切换 deviceId：以 QPointer 保存并在投递前复制列表。
+    QHash<int, QList<QPointer<Gamepad>>> m_gamepadSubscribers;
+    struct DeviceSignalState {
+        std::array<double, deckshell::deckgamepad::GAMEPAD_AXIS_MAX> axes{};
+        std::array<int, 4> hats{};
+    };
+    QHash<int, DeviceSignalState> m_deviceSignalState;
 };
@@ -0,0 +1,273 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "gamepadstate.h"
+
+#include "gamepadmanager.h"
+
+#include <deckshell/deckgamepad/service/deckgamepadservice.h>
+
+#include <QtCore/QThread>
+#include <QtQml/QQmlEngine>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickWindow>
+
+using deckshell::deckgamepad::DeckGamepadService;
+using deckshell::deckgamepad::DeckGamepadStateSample;
+namespace dg = deckshell::deckgamepad;
+
+namespace {
+constexpr int kFallbackPollIntervalMs = 16;
+
+bool sameSample(const DeckGamepadStateSample &a, const DeckGamepadStateSample &b)
+{
+    // frameCounter 随每次提交递增；设备切换时 deviceId 不同。
+    return a.deviceId == b.deviceId && a.frameCounter == b.frameCounter && a.timestampNs == b.timestampNs;
+}
+} // namespace
+
+GamepadState::GamepadState(QObject *parent)
+    : QObject(parent)
+{
+    m_fallbackTimer.setInterval(kFallbackPollIntervalMs);
+    connect(&m_fallbackTimer, &QTimer::timeout, this, &GamepadState::sampleFrame);
+}
+
+GamepadState::~GamepadState()
+{
+    // 先断开渲染线程上的直连，再释放映射。
+    disconnect(m_frameConnection);
+    disconnect(m_windowChangedConnection);
+}
+
+void GamepadState::classBegin()
+{
+}
+
+void GamepadState::componentComplete()
+{
+    m_componentComplete = true;
+    attach();
+    resolveFrameWindow();
+}
+
+int GamepadState::deviceId() const
+{
+    return m_deviceId;
+}
+
+void GamepadState::setDeviceId(int deviceId)
+{
+    if (m_deviceId == deviceId) {
+        return;
+    }
+    m_deviceId = deviceId;
+    Q_EMIT deviceIdChanged();
+    if (m_componentComplete) {
+        sampleFrame();
+    }
+}
+
+QString GamepadState::source() const
+{
+    return m_source;
+}
+
+void GamepadState::setSource(const QString &source)
+{
+    if (m_source == source) {
+        return;
+    }
+    m_source = source;
+    Q_EMIT sourceChanged();
+    if (m_componentComplete) {
+        attach();
+    }
+}
+
+bool GamepadState::available() const
+{
+    return m_available;
+}
+
+QString GamepadState::errorString() const
+{
+    return m_errorString;
+}
+
+quint32 GamepadState::buttons() const
+{
+    return m_sample.buttons;
+}
+
+quint64 GamepadState::frameCounter() const
+{
+    return m_sample.frameCounter;
+}
+
+qint64 GamepadState::timestampNs() const
+{
+    return m_sample.timestampNs;
+}
+
+double GamepadState::axisLeftX() const
+{
+    return m_sample.axis(dg::GAMEPAD_AXIS_LEFT_X);
+}
+
+double GamepadState::axisLeftY() const
+{
+    return m_sample.axis(dg::GAMEPAD_AXIS_LEFT_Y);
+}
+
+double GamepadState::axisRightX() const
+{
+    return m_sample.axis(dg::GAMEPAD_AXIS_RIGHT_X);
+}
+
+double GamepadState::axisRightY() const
+{
+    return m_sample.axis(dg::GAMEPAD_AXIS_RIGHT_Y);
+}
+
+double GamepadState::axisTriggerLeft() const
+{
+    return m_sample.axis(dg::GAMEPAD_AXIS_TRIGGER_LEFT);
+}
+
+double GamepadState::axisTriggerRight() const
+{
+    return m_sample.axis(dg::GAMEPAD_AXIS_TRIGGER_RIGHT);
+}
+
+int GamepadState::hatDirection() const
+{
+    return m_sample.hat(0);
+}
+
+bool GamepadState::button(int button) const
+{
+    return m_sample.button(button);
+}
+
+double GamepadState::axis(int axis) const
+{
+    return m_sample.axis(axis);
+}
+
+int GamepadState::hat(int hat) const
+{
+    return m_sample.hat(hat);
+}
+
+void GamepadState::attach()
+{
+    // 重新映射期间不能有渲染线程读取：attach 只在 GUI 线程调用，且 sync 阶段 GUI 线程阻塞，二者互斥。
+    m_reader.detach();
+
+    if (!m_source.isEmpty()) {
+        if (!m_reader.attach(m_source)) {
+            setErrorString(m_reader.errorString());
+        } else {
+            setErrorString(QString());
+        }
+        sampleFrame();
+        return;
+    }
+
+    GamepadManager *mgr = nullptr;
+    if (auto *engine = qmlEngine(this)) {
+        mgr = engine->singletonInstance<GamepadManager *>(QStringLiteral("DeckShell.DeckGamepad"),
+                                                          QStringLiteral("GamepadManager"));
+        if (!mgr) {
+            mgr = GamepadManager::create(engine, nullptr);
+        }
+    } else {
+        mgr = GamepadManager::instance();
+    }
+    DeckGamepadService *svc = mgr ? mgr->service() : nullptr;
+    if (!svc) {
+        setErrorString(QStringLiteral("GamepadManager service unavailable"));
+    } else if (!svc->enableSharedState()) {
+        setErrorString(svc->lastErrorMessage());
+    } else if (!m_reader.attach(svc->sharedStateFd())) {
+        setErrorString(m_reader.errorString());
+    } else {
+        setErrorString(QString());
+    }
+    sampleFrame();
+}
+
+void GamepadState::setErrorString(const QString &error)
+{
+    if (m_errorString == error) {
+        return;
+    }
+    m_errorString = error;
+    Q_EMIT errorStringChanged();
+}
+
+void GamepadState::resolveFrameWindow()
+{
+    QQuickWindow *window = nullptr;
+    QQuickItem *ownerItem = nullptr;
+    for (QObject *obj = parent(); obj; obj = obj->parent()) {
+        if (auto *item = qobject_cast<QQuickItem *>(obj)) {
+            ownerItem = item;
+            window = item->window();
+            break;
+        }
+        if (auto *quickWindow = qobject_cast<QQuickWindow *>(obj)) {
+            window = quickWindow;
+            break;
+        }
+    }
+
+    if (ownerItem && !m_windowChangedConnection) {
+        m_windowChangedConnection = connect(ownerItem, &QQuickItem::windowChanged, this, &GamepadState::resolveFrameWindow);
+    }
+
+    if (window != m_frameWindow || !window) {
+        disconnect(m_frameConnection);
+        m_frameConnection = {};
+        m_frameWindow = window;
+        if (window) {
+            // 直连：threaded render loop 下在渲染线程执行，GUI 线程此时阻塞，读取到的是本帧将要同步的状态。
+            m_frameConnection =
+                connect(window, &QQuickWindow::beforeSynchronizing, this, &GamepadState::sampleFrame, Qt::DirectConnection);
+        }
+    }
+
+    if (window) {
+        m_fallbackTimer.stop();
+    } else if (!m_fallbackTimer.isActive()) {
+        m_fallbackTimer.start();
+    }
+}
+
+void GamepadState::sampleFrame()
+{
+    DeckGamepadStateSample next;
+    const bool ok = m_reader.isAttached() && m_reader.read(m_deviceId, &next);
+    if (!ok) {
+        next = DeckGamepadStateSample{};
+    }
+    if (ok == m_available && sameSample(next, m_sample)) {
+        return;
+    }
+
+    m_sample = next;
+    m_available = ok;
+
+    if (QThread::currentThread() == thread()) {
+        publish();
+    } else {
+        QMetaObject::invokeMethod(this, &GamepadState::publish, Qt::QueuedConnection);
+    }
+}
+
+void GamepadState::publish()
+{
+    Q_EMIT sampled();
+}
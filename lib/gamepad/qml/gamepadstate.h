@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepadsharedstate.h>
+
+#include <QtCore/QMetaObject>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtQml/QQmlParserStatus>
+#include <QtQml/qqml.h>
+
+class GamepadManager;
+
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+QT_END_NAMESPACE
+
+// 轮询型手柄状态：每帧（QQuickWindow::beforeSynchronizing）从共享状态块读取一次一致快照，
+// 而不是逐事件更新属性。适合游戏循环/可视化等只关心“当前状态”的场景。
+// - source 为空：使用进程内 DeckGamepadService（自动 enableSharedState）。
+// - source 非空：只读映射其他进程发布的状态块（DeckGamepadService::sharedStatePath()）。
+class GamepadState : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+    QML_ELEMENT
+
+    Q_PROPERTY(int deviceId READ deviceId WRITE setDeviceId NOTIFY deviceIdChanged FINAL)
+    Q_PROPERTY(QString source READ source WRITE setSource NOTIFY sourceChanged FINAL)
+    Q_PROPERTY(bool available READ available NOTIFY sampled FINAL)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY errorStringChanged FINAL)
+
+    // 以下属性共用 sampled 通知：一帧内的全部变化只触发一次绑定重算。
+    Q_PROPERTY(quint32 buttons READ buttons NOTIFY sampled FINAL)
+    Q_PROPERTY(quint64 frameCounter READ frameCounter NOTIFY sampled FINAL)
+    Q_PROPERTY(qint64 timestampNs READ timestampNs NOTIFY sampled FINAL)
+    Q_PROPERTY(double axisLeftX READ axisLeftX NOTIFY sampled FINAL)
+    Q_PROPERTY(double axisLeftY READ axisLeftY NOTIFY sampled FINAL)
+    Q_PROPERTY(double axisRightX READ axisRightX NOTIFY sampled FINAL)
+    Q_PROPERTY(double axisRightY READ axisRightY NOTIFY sampled FINAL)
+    Q_PROPERTY(double axisTriggerLeft READ axisTriggerLeft NOTIFY sampled FINAL)
+    Q_PROPERTY(double axisTriggerRight READ axisTriggerRight NOTIFY sampled FINAL)
+    Q_PROPERTY(int hatDirection READ hatDirection NOTIFY sampled FINAL)
+
+public:
+    explicit GamepadState(QObject *parent = nullptr);
+    ~GamepadState() override;
+
+    void classBegin() override;
+    void componentComplete() override;
+
+    int deviceId() const;
+    void setDeviceId(int deviceId);
+
+    QString source() const;
+    void setSource(const QString &source);
+
+    bool available() const;
+    QString errorString() const;
+
+    quint32 buttons() const;
+    quint64 frameCounter() const;
+    qint64 timestampNs() const;
+    double axisLeftX() const;
+    double axisLeftY() const;
+    double axisRightX() const;
+    double axisRightY() const;
+    double axisTriggerLeft() const;
+    double axisTriggerRight() const;
+    int hatDirection() const;
+
+    Q_INVOKABLE bool button(int button) const;
+    Q_INVOKABLE double axis(int axis) const;
+    Q_INVOKABLE int hat(int hat) const;
+
+Q_SIGNALS:
+    void deviceIdChanged();
+    void sourceChanged();
+    void errorStringChanged();
+    void sampled();
+
+private:
+    void attach();
+    void setErrorString(const QString &error);
+    void resolveFrameWindow();
+    // 可能在渲染线程调用（此时 GUI 线程阻塞于 sync）；只写 m_sample/m_available，通知回投 GUI 线程。
+    void sampleFrame();
+    void publish();
+
+    int m_deviceId = 0;
+    QString m_source;
+    QString m_errorString;
+    bool m_componentComplete = false;
+
+    deckshell::deckgamepad::DeckGamepadSharedStateReader m_reader;
+    deckshell::deckgamepad::DeckGamepadStateSample m_sample;
+    bool m_available = false;
+
+    QPointer<QQuickWindow> m_frameWindow;
+    QMetaObject::Connection m_frameConnection;
+    QMetaObject::Connection m_windowChangedConnection;
+    QTimer m_fallbackTimer; // 无窗口时的兜底轮询
+};
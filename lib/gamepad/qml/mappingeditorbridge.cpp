@@ -11,55 +11,16 @@
 #include <deckshell/deckgamepad/mapping/deckgamepadcustommappingmanager.h>
 
 #include <QtCore/QDebug>
-#include <QtCore/QMetaObject>
 #include <QtCore/QRegularExpression>
-#include <QtCore/QThread>
 #include <QtGui/QClipboard>
 #include <QtGui/QGuiApplication>
 
-#include <type_traits>
-#include <utility>
-
 extern "C" {
 #include <linux/input.h>
 }
 
 using namespace deckshell::deckgamepad;
 
-namespace {
-template <typename Func>
-auto invokeBlocking(DeckGamepadCustomMappingManager *manager, Func &&func)
-{
-    using Ret = std::invoke_result_t<Func>;
-
-    if (!manager) {
-        if constexpr (!std::is_void_v<Ret>) {
-            return Ret{};
-        } else {
-            return;
-        }
-    }
-
-    if (QThread::currentThread() == manager->thread()) {
-        if constexpr (!std::is_void_v<Ret>) {
-            return func();
-        } else {
-            func();
-            return;
-        }
-    }
-
-    if constexpr (std::is_void_v<Ret>) {
-        QMetaObject::invokeMethod(manager, std::forward<Func>(func), Qt::BlockingQueuedConnection);
-        return;
-    } else {
-        Ret result{};
-        QMetaObject::invokeMethod(manager, [&] { result = func(); }, Qt::BlockingQueuedConnection);
-        return result;
-    }
-}
-}
-
 MappingEditorBridge::MappingEditorBridge(QObject *parent)
     : QObject(parent)
     , m_captureTimer(new QTimer(this))
@@ -154,7 +115,7 @@ bool MappingEditorBridge::hasCustomMapping() const
         return false;
     }
 
-    return invokeBlocking(mgr, [mgr, deviceId = m_deviceId] { return mgr->hasCustomMapping(deviceId); });
+    return mgr->hasCustomMapping(m_deviceId);
 }
 
 bool MappingEditorBridge::isMappingComplete() const
@@ -164,7 +125,7 @@ bool MappingEditorBridge::isMappingComplete() const
         return false;
     }
 
-    return invokeBlocking(mgr, [mgr, deviceId = m_deviceId] { return mgr->isMappingComplete(deviceId); });
+    return mgr->isMappingComplete(m_deviceId);
 }
 
 void MappingEditorBridge::createMapping()
@@ -175,7 +136,7 @@ void MappingEditorBridge::createMapping()
         return;
     }
 
-    const QString guid = invokeBlocking(mgr, [mgr, deviceId = m_deviceId] { return mgr->createCustomMapping(deviceId); });
+    const QString guid = mgr->createCustomMapping(m_deviceId);
     if (guid.isEmpty()) {
         Q_EMIT captureFailed(QStringLiteral("Failed to create mapping"));
         return;
@@ -193,9 +154,9 @@ bool MappingEditorBridge::saveMapping()
         return false;
     }
 
-    if (invokeBlocking(mgr, [mgr] { return mgr->saveToFile(); })) {
+    if (mgr->saveToFile()) {
         if (m_deviceId >= 0) {
-            invokeBlocking(mgr, [mgr, deviceId = m_deviceId] { return mgr->applyMapping(deviceId); });
+            mgr->applyMapping(m_deviceId);
         }
         Q_EMIT mappingSaved();
         qDebug() << "Saved custom mappings";
@@ -213,7 +174,7 @@ void MappingEditorBridge::removeMapping()
         return;
     }
 
-    invokeBlocking(mgr, [mgr, deviceId = m_deviceId] { mgr->removeCustomMapping(deviceId); });
+    mgr->removeCustomMapping(m_deviceId);
     Q_EMIT mappingChanged();
     qDebug() << "Removed custom mapping for device" << m_deviceId;
 }
@@ -225,7 +186,7 @@ bool MappingEditorBridge::loadPreset(const QString &presetName)
         return false;
     }
 
-    if (invokeBlocking(mgr, [mgr, deviceId = m_deviceId, presetName] { return mgr->loadPreset(deviceId, presetName); })) {
+    if (mgr->loadPreset(m_deviceId, presetName)) {
         Q_EMIT mappingChanged();
         qDebug() << "Loaded preset" << presetName << "for device" << m_deviceId;
         return true;
@@ -241,7 +202,7 @@ QStringList MappingEditorBridge::availablePresets()
         return QStringList();
     }
 
-    return invokeBlocking(mgr, [mgr] { return mgr->availablePresets(); });
+    return mgr->availablePresets();
 }
 
 QString MappingEditorBridge::getButtonMapping(int logicalButton)
@@ -251,8 +212,7 @@ QString MappingEditorBridge::getButtonMapping(int logicalButton)
         return QString();
     }
 
-    const DeviceMapping mapping =
-        invokeBlocking(mgr, [mgr, deviceId = m_deviceId] { return mgr->getCustomMapping(deviceId); });
+    const DeviceMapping mapping = mgr->getCustomMapping(m_deviceId);
 
     for (auto it = mapping.buttonMap.constBegin(); it != mapping.buttonMap.constEnd(); ++it) {
         if (it.value() == static_cast<GamepadButton>(logicalButton)) {
@@ -270,8 +230,7 @@ QString MappingEditorBridge::getAxisMapping(int logicalAxis)
         return QString();
     }
 
-    const DeviceMapping mapping =
-        invokeBlocking(mgr, [mgr, deviceId = m_deviceId] { return mgr->getCustomMapping(deviceId); });
+    const DeviceMapping mapping = mgr->getCustomMapping(m_deviceId);
 
     for (auto it = mapping.axisMap.constBegin(); it != mapping.axisMap.constEnd(); ++it) {
         if (it.value() == static_cast<GamepadAxis>(logicalAxis)) {
@@ -292,9 +251,7 @@ void MappingEditorBridge::clearButtonMapping(int logicalButton)
         return;
     }
 
-    invokeBlocking(mgr, [mgr, deviceId = m_deviceId, logicalButton] {
-        mgr->clearButtonMapping(deviceId, static_cast<GamepadButton>(logicalButton));
-    });
+    mgr->clearButtonMapping(m_deviceId, static_cast<GamepadButton>(logicalButton));
     Q_EMIT mappingChanged();
 }
 
@@ -305,9 +262,7 @@ void MappingEditorBridge::clearAxisMapping(int logicalAxis)
         return;
     }
 
-    invokeBlocking(mgr, [mgr, deviceId = m_deviceId, logicalAxis] {
-        mgr->clearAxisMapping(deviceId, static_cast<GamepadAxis>(logicalAxis));
-    });
+    mgr->clearAxisMapping(m_deviceId, static_cast<GamepadAxis>(logicalAxis));
     Q_EMIT mappingChanged();
 }
 
@@ -385,7 +340,7 @@ QStringList MappingEditorBridge::getMissingMappings()
         return QStringList();
     }
 
-    return invokeBlocking(mgr, [mgr, deviceId = m_deviceId] { return mgr->getMissingMappings(deviceId); });
+    return mgr->getMissingMappings(m_deviceId);
 }
 
 QString MappingEditorBridge::exportToSdl()
@@ -395,7 +350,7 @@ QString MappingEditorBridge::exportToSdl()
         return QString();
     }
 
-    return invokeBlocking(mgr, [mgr, deviceId = m_deviceId] { return mgr->exportToSdlString(deviceId); });
+    return mgr->exportToSdlString(m_deviceId);
 }
 
 bool MappingEditorBridge::importFromSdl(const QString &sdlString)
@@ -405,7 +360,7 @@ bool MappingEditorBridge::importFromSdl(const QString &sdlString)
         return false;
     }
 
-    if (invokeBlocking(mgr, [mgr, deviceId = m_deviceId, sdlString] { return mgr->importFromSdlString(deviceId, sdlString); })) {
+    if (mgr->importFromSdlString(m_deviceId, sdlString)) {
         Q_EMIT mappingChanged();
         return true;
     }
@@ -509,9 +464,7 @@ void MappingEditorBridge::onButtonPressed(int deviceId, int button)
         return;
     }
 
-    invokeBlocking(mgr, [mgr, deviceId = m_deviceId, logicalButton = m_captureLogicalButton, evdevCode] {
-        mgr->setButtonMapping(deviceId, static_cast<GamepadButton>(logicalButton), evdevCode);
-    });
+    mgr->setButtonMapping(m_deviceId, static_cast<GamepadButton>(m_captureLogicalButton), evdevCode);
 
     const QString inputName = buttonCodeToName(evdevCode);
     Q_EMIT inputCaptured(evdevCode, inputName);
@@ -550,9 +503,7 @@ void MappingEditorBridge::onAxisChanged(int deviceId, int axis, double value)
 
     const bool inverted = (value < -0.5);
 
-    invokeBlocking(mgr, [mgr, deviceId = m_deviceId, logicalAxis = m_captureLogicalAxis, evdevCode, inverted] {
-        mgr->setAxisMapping(deviceId, static_cast<GamepadAxis>(logicalAxis), evdevCode, inverted);
-    });
+    mgr->setAxisMapping(m_deviceId, static_cast<GamepadAxis>(m_captureLogicalAxis), evdevCode, inverted);
 
     QString inputName = axisCodeToName(evdevCode);
     if (inverted) {
@@ -583,8 +534,7 @@ int MappingEditorBridge::resolvePhysicalButtonCode(int deviceId, int logicalButt
         return -1;
     }
 
-    const DeviceMapping mapping =
-        invokeBlocking(mgr, [mgr, deviceId] { return mgr->getCustomMapping(deviceId); });
+    const DeviceMapping mapping = mgr->getCustomMapping(deviceId);
     const auto logical = static_cast<GamepadButton>(logicalButton);
     for (auto it = mapping.buttonMap.constBegin(); it != mapping.buttonMap.constEnd(); ++it) {
         if (it.value() == logical) {
@@ -632,8 +582,7 @@ int MappingEditorBridge::resolvePhysicalAxisCode(int deviceId, int logicalAxis)
         return -1;
     }
 
-    const DeviceMapping mapping =
-        invokeBlocking(mgr, [mgr, deviceId] { return mgr->getCustomMapping(deviceId); });
+    const DeviceMapping mapping = mgr->getCustomMapping(deviceId);
     const auto logical = static_cast<GamepadAxis>(logicalAxis);
     for (auto it = mapping.axisMap.constBegin(); it != mapping.axisMap.constEnd(); ++it) {
         if (it.value() == logical) {
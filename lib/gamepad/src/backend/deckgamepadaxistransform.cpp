@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/backend/deckgamepadaxistransform_p.h>
+
+#include <QtCore/QtGlobal>
+
+#include <cmath>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+static double applyAxisCalibrationValue(const AxisCalibration &cal, double value)
+{
+    const double min = qBound(-1.0, double(cal.min), 1.0);
+    const double max = qBound(-1.0, double(cal.max), 1.0);
+    if (max <= min) {
+        return value;
+    }
+
+    switch (cal.mode) {
+    case AxisCalibrationMode::MinMax: {
+        const double out = 2.0 * (value - min) / (max - min) - 1.0;
+        return qBound(-1.0, out, 1.0);
+    }
+    case AxisCalibrationMode::CenterMinMax: {
+        const double center = qBound(min, double(cal.centerOffset), max);
+        if (value >= center) {
+            const double denom = max - center;
+            if (denom <= 0.0) {
+                return 0.0;
+            }
+            return qBound(0.0, (value - center) / denom, 1.0);
+        }
+
+        const double denom = center - min;
+        if (denom <= 0.0) {
+            return 0.0;
+        }
+        return qBound(-1.0, (value - center) / denom, 0.0);
+    }
+    }
+    return value;
+}
+
+double DeckGamepadAxisTransform::evaluate(int value) const
+{
+    if (max == min) {
+        return 0.0;
+    }
+
+    double normalized = 2.0 * (value - min) / (max - min) - 1.0;
+
+    if (inverted) {
+        normalized = -normalized;
+    }
+
+    if (hasCalibration) {
+        normalized = applyAxisCalibrationValue(calibration, normalized);
+    }
+
+    if (flatThreshold > 0.0 && std::abs(normalized) <= flatThreshold) {
+        normalized = 0.0;
+    }
+
+    if (hasDeadzone) {
+        if (std::abs(normalized) <= deadzone) {
+            normalized = 0.0;
+        } else {
+            double sign = (normalized > 0) ? 1.0 : -1.0;
+            normalized = sign * (std::abs(normalized) - deadzone) / (1.0 - deadzone);
+        }
+    }
+
+    if (hasSensitivity) {
+        normalized *= sensitivity;
+        normalized = qBound(-1.0, normalized, 1.0);
+    }
+
+    return normalized;
+}
+
+void DeckGamepadAxisTransform::buildLut()
+{
+    lut.clear();
+
+    const long long range = static_cast<long long>(max) - min + 1;
+    if (max <= min || range > kMaxLutEntries) {
+        lut.shrink_to_fit();
+        return;
+    }
+
+    lut.resize(static_cast<size_t>(range));
+    for (long long i = 0; i < range; ++i) {
+        lut[static_cast<size_t>(i)] = evaluate(static_cast<int>(min + i));
+    }
+}
+
+DECKGAMEPAD_END_NAMESPACE
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// 预编译的单轴变换：归一化 → 反转 → 校准 → flat → 自定义死区 → 灵敏度。
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+#include <deckshell/deckgamepad/mapping/deckgamepadcalibrationstore.h>
+
+#include <vector>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+/**
+ * @brief Flattened per-evdev-code axis transform record
+ *
+ * 在设备打开、映射重载、校准重载或轴调参变更时由 DeckGamepadDevice 重新生成；
+ * EV_ABS 热路径只做数组索引，不再查询 SDL 映射/校准/调参哈希表。
+ * 内核量程不超过 kMaxLutEntries 时预先求出整张查找表（按 raw value - min 索引）。
+ */
+struct DeckGamepadAxisTransform {
+    static constexpr int kMaxLutEntries = 1024;
+
+    GamepadAxis axis = GAMEPAD_AXIS_INVALID; ///< 输出轴；仅映射为半轴按键时为 INVALID
+    bool halfAxisMapped = false;             ///< SDL 映射中存在 +a/-a 半轴按键
+
+    int min = 0;
+    int max = 0;
+    bool inverted = false;
+
+    bool hasCalibration = false;
+    AxisCalibration calibration;
+
+    double flatThreshold = 0.0; ///< 内核 flat 换算到 [-1, 1] 的阈值，0 表示不启用
+
+    bool hasDeadzone = false;
+    float deadzone = 0.0f;
+    bool hasSensitivity = false;
+    float sensitivity = 1.0f;
+
+    std::vector<double> lut;
+
+    // 逐步求值（与旧 normalizeAxisValue 逐位一致）；用于生成查找表及超量程值。
+    double evaluate(int value) const;
+    void buildLut();
+
+    double apply(int value) const
+    {
+        const long long idx = static_cast<long long>(value) - min;
+        if (idx >= 0 && idx < static_cast<long long>(lut.size())) {
+            return lut[static_cast<size_t>(idx)];
+        }
+        return evaluate(value);
+    }
+};
+
+DECKGAMEPAD_END_NAMESPACE
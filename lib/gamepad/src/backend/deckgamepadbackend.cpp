@@ -6,6 +6,7 @@
  * 以及 Godot 4.0 的 joypad_linux
  */
 
+#include "deckgamepadaxistransform_p.h"
 #include "deviceaccessbroker.h"
 #include "deviceuidgenerator.h"
 #include "sessiongate.h"
@@ -16,10 +17,16 @@
 #include <deckshell/deckgamepad/mapping/deckgamepadsdlcontrollerdb.h>
 
 #include <QtCore/QDateTime>
+#include <QtCore/QDeadlineTimer>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QMetaType>
+#include <QtCore/QPointer>
+#include <QtCore/QThreadPool>
+
+#include <algorithm>
+#include <utility>
 
 extern "C" {
 #include <libudev.h>
@@ -50,12 +57,48 @@ static void registerGamepadEventMetaTypes()
     (void)qRegisterMetaType<DeckGamepadButtonEvent>();
     (void)qRegisterMetaType<DeckGamepadAxisEvent>();
     (void)qRegisterMetaType<DeckGamepadHatEvent>();
+    (void)qRegisterMetaType<DeckGamepadFrameEvent>();
     (void)qRegisterMetaType<DeckGamepadRuntimeConfig>();
     (void)qRegisterMetaType<DeckGamepadError>();
     (void)qRegisterMetaType<DeckGamepadErrorCode>();
     (void)qRegisterMetaType<DeckGamepadDeviceAvailability>();
+    (void)qRegisterMetaType<DeckGamepadProbeHistogram>();
 }
 
+struct DeckGamepadBackend::ProbeOutcome {
+    ProbeOutcome() = default;
+    Q_DISABLE_COPY_MOVE(ProbeOutcome)
+
+    ~ProbeOutcome() { releaseFd(); }
+
+    void releaseFd()
+    {
+        if (openResult.releaseDevice) {
+            openResult.releaseDevice();
+            openResult.releaseDevice = {};
+        }
+        if (openResult.fd >= 0) {
+            ::close(openResult.fd);
+            openResult.fd = -1;
+        }
+    }
+
+    quint64 ticket = 0;
+    int deviceId = -1;             // -1：尚未登记，需先通过能力检测
+    QString devpath;
+    KnownDevice pendingKnown;      // deviceId == -1 时，确认后登记使用
+    bool checkCapabilities = false;
+    bool hasGamepadHint = false;
+    bool recordTiming = false;
+    QElapsedTimer elapsed;
+
+    bool candidate = true;
+    DeckGamepadDeviceOpenResult openResult;
+    int grabErrno = 0;             // EVIOCGRAB 失败时的 errno
+    bool probed = false;
+    DeckGamepadDevice::ProbeSnapshot snapshot;
+};
+
 DeckGamepadDevice::DeckGamepadDevice(int id,
                                      const QString &devpath,
                                      DeckGamepadSdlControllerDb *sdlDb,
@@ -71,6 +114,10 @@ DeckGamepadDevice::DeckGamepadDevice(int id,
 	{
 	    memset(m_keyMap, 0, sizeof(m_keyMap));
     memset(m_absInfo, 0, sizeof(m_absInfo));
+    m_axisTransforms.resize(MAX_ABS);
+    m_rumble = new DeckGamepadRumbleScheduler(
+        [this](float weak, float strong, int durationMs) { return writeRumble(weak, strong, durationMs); },
+        this);
 }
 
 DeckGamepadDevice::~DeckGamepadDevice()
@@ -94,6 +141,15 @@ bool DeckGamepadDevice::open()
 }
 
 bool DeckGamepadDevice::openWithFd(int fd, std::function<void()> releaseDevice)
+{
+    if (fd < 0) {
+        return false;
+    }
+
+    return openWithProbe(fd, probeFd(fd, m_devpath, m_sdlDb != nullptr), std::move(releaseDevice));
+}
+
+bool DeckGamepadDevice::openWithProbe(int fd, ProbeSnapshot probe, std::function<void()> releaseDevice)
 {
     if (fd < 0) {
         return false;
@@ -105,7 +161,9 @@ bool DeckGamepadDevice::openWithFd(int fd, std::function<void()> releaseDevice)
     m_fd = fd;
     m_releaseDevice = std::move(releaseDevice);
 
-    setupDevice();
+    applyProbe(std::move(probe));
+    setupSdlMapping();
+    rebuildAxisTransforms();
 
     m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
     connect(m_notifier, &QSocketNotifier::activated, this, &DeckGamepadDevice::handleReadyRead);
@@ -129,10 +187,8 @@ void DeckGamepadDevice::close()
         return;
     }
 
-    // 关闭前停止振动
-    if (m_ffEffectId != -1) {
-        stopVibration();
-    }
+    // 关闭前停止振动并释放槽位
+    releaseRumbleSlot();
 
     if (m_notifier) {
         m_notifier->setEnabled(false);
@@ -142,6 +198,9 @@ void DeckGamepadDevice::close()
 
     closeDeviceFd(m_fd);
 
+    m_frame.clear();
+    m_syncDropped = false;
+
     if (m_releaseDevice) {
         m_releaseDevice();
         m_releaseDevice = {};
@@ -158,44 +217,55 @@ void DeckGamepadDevice::closeForIoError()
     emit disconnected(m_id);
 }
 
-void DeckGamepadDevice::setupDevice()
+DeckGamepadDevice::ProbeSnapshot DeckGamepadDevice::probeFd(int fd, const QString &devpath, bool resolveGuid)
 {
+    ProbeSnapshot probe;
+
     char namebuf[128] = { 0 };
-    if (ioctl(m_fd, EVIOCGNAME(sizeof(namebuf)), namebuf) >= 0) {
-        m_name = QString::fromUtf8(namebuf);
+    if (ioctl(fd, EVIOCGNAME(sizeof(namebuf)), namebuf) >= 0) {
+        probe.name = QString::fromUtf8(namebuf);
     } else {
-        m_name = "Unknown Gamepad";
+        probe.name = QStringLiteral("Unknown Gamepad");
     }
 
-    if (m_sdlDb) {
-        m_guid = DeckGamepadSdlControllerDb::extractGuid(m_devpath, m_name);
-        qDebug() << "Device GUID:" << m_guid << "Name:" << m_name;
+    if (resolveGuid) {
+        probe.guid = DeckGamepadSdlControllerDb::extractGuid(devpath, probe.name);
+        qDebug() << "Device GUID:" << probe.guid << "Name:" << probe.name;
     }
 
     unsigned long keybit[NBITS(KEY_MAX)] = { 0 };
-    if (ioctl(m_fd, EVIOCGBIT(EV_KEY, sizeof(keybit)), keybit) >= 0) {
+    if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keybit)), keybit) >= 0) {
         int num_buttons = 0;
         int sdlButtonIndex = 0;
 
         for (int i = BTN_JOYSTICK; i < KEY_MAX; ++i) {
             if (test_bit(i, keybit)) {
-                m_keyMap[i] = num_buttons++;
-                m_physicalButtonMap[i] = sdlButtonIndex++; // SDL button index
+                probe.keyMap[static_cast<size_t>(i)] = num_buttons++;
+                probe.physicalButtonMap[i] = sdlButtonIndex++; // SDL button index
             }
         }
 
         for (int i = BTN_MISC; i < BTN_JOYSTICK; ++i) {
             if (test_bit(i, keybit)) {
-                m_keyMap[i] = num_buttons++;
-                m_physicalButtonMap[i] = sdlButtonIndex++; // SDL button index
+                probe.keyMap[static_cast<size_t>(i)] = num_buttons++;
+                probe.physicalButtonMap[i] = sdlButtonIndex++; // SDL button index
             }
         }
 
         qDebug() << "Detected" << sdlButtonIndex << "physical buttons";
     }
 
+    unsigned long keyState[NBITS(KEY_MAX)] = { 0 };
+    if (ioctl(fd, EVIOCGKEY(sizeof(keyState)), keyState) >= 0) {
+        for (int i = 0; i < MAX_KEY; ++i) {
+            if (test_bit(i, keyState)) {
+                probe.keyDown.set(static_cast<size_t>(i));
+            }
+        }
+    }
+
     unsigned long absbit[NBITS(ABS_MAX)] = { 0 };
-    if (ioctl(m_fd, EVIOCGBIT(EV_ABS, sizeof(absbit)), absbit) >= 0) {
+    if (ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absbit)), absbit) >= 0) {
         int sdlAxisIndex = 0;
 
         for (int i = 0; i < ABS_MISC; ++i) {
@@ -206,12 +276,25 @@ void DeckGamepadDevice::setupDevice()
 
             if (test_bit(i, absbit)) {
                 struct input_absinfo absInfo;
-                if (ioctl(m_fd, EVIOCGABS(i), &absInfo) >= 0) {
-                    m_absInfo[i].min = absInfo.minimum;
-                    m_absInfo[i].max = absInfo.maximum;
-                    m_absInfo[i].flat = absInfo.flat;
+                if (ioctl(fd, EVIOCGABS(i), &absInfo) >= 0) {
+                    probe.absInfo[static_cast<size_t>(i)].min = absInfo.minimum;
+                    probe.absInfo[static_cast<size_t>(i)].max = absInfo.maximum;
+                    probe.absInfo[static_cast<size_t>(i)].flat = absInfo.flat;
+                    probe.absValue[static_cast<size_t>(i)] = absInfo.value;
                 }
-                m_physicalAxisMap[i] = sdlAxisIndex++; // SDL axis index
+                probe.absSupported.set(static_cast<size_t>(i));
+                probe.physicalAxisMap[i] = sdlAxisIndex++; // SDL axis index
+            }
+        }
+
+        for (int i = ABS_HAT0X; i <= ABS_HAT3Y; ++i) {
+            if (!test_bit(i, absbit)) {
+                continue;
+            }
+            probe.absSupported.set(static_cast<size_t>(i));
+            struct input_absinfo absInfo;
+            if (ioctl(fd, EVIOCGABS(i), &absInfo) >= 0) {
+                probe.absValue[static_cast<size_t>(i)] = absInfo.value;
             }
         }
 
@@ -219,11 +302,25 @@ void DeckGamepadDevice::setupDevice()
     }
 
     unsigned long ffbit[NBITS(FF_CNT)] = { 0 };
-    if (ioctl(m_fd, EVIOCGBIT(EV_FF, sizeof(ffbit)), ffbit) >= 0) {
-        m_hasFF = test_bit(FF_RUMBLE, ffbit);
+    if (ioctl(fd, EVIOCGBIT(EV_FF, sizeof(ffbit)), ffbit) >= 0) {
+        probe.hasFF = test_bit(FF_RUMBLE, ffbit);
     }
 
-    setupSdlMapping();
+    return probe;
+}
+
+void DeckGamepadDevice::applyProbe(ProbeSnapshot probe)
+{
+    m_name = std::move(probe.name);
+    m_guid = std::move(probe.guid);
+    std::copy(probe.keyMap.cbegin(), probe.keyMap.cend(), m_keyMap);
+    m_physicalButtonMap = std::move(probe.physicalButtonMap);
+    m_physicalAxisMap = std::move(probe.physicalAxisMap);
+    std::copy(probe.absInfo.cbegin(), probe.absInfo.cend(), m_absInfo);
+    m_keyDown = probe.keyDown;
+    m_absSupported = probe.absSupported;
+    m_absValue = probe.absValue;
+    m_hasFF = probe.hasFF;
 }
 
 void DeckGamepadDevice::reloadMapping()
@@ -234,9 +331,10 @@ void DeckGamepadDevice::reloadMapping()
     }
 
     m_deviceMapping = DeviceMapping();
-    m_halfAxisStateByCode.clear();
+    m_halfAxisStateByCode.fill(0);
 
     setupSdlMapping();
+    rebuildAxisTransforms();
 
     qDebug() << "Reloaded mapping for device" << m_id << m_name;
 }
@@ -292,154 +390,32 @@ void DeckGamepadDevice::processEvents()
             uint32_t time_msec = ev.time.tv_sec * 1000 + ev.time.tv_usec / 1000;
 
             switch (ev.type) {
-            case EV_KEY: {
-                if (ev.code >= MAX_KEY) {
-                    qDebug() << "Button code out of range:" << ev.code;
-                    continue;
+            case EV_SYN:
+                if (ev.code == SYN_DROPPED) {
+                    // 内核缓冲溢出：本帧已不完整，丢弃并等待下一个 SYN_REPORT 后重同步。
+                    m_frame.clear();
+                    m_syncDropped = true;
+                } else if (ev.code == SYN_REPORT) {
+                    if (m_syncDropped) {
+                        m_syncDropped = false;
+                        resyncAfterDrop(time_msec);
+                    }
+                    flushFrame(time_msec);
                 }
+                break;
 
-                DeckGamepadButtonEvent event;
-                event.time_msec = time_msec;
-                event.button = mapButton(ev.code);
-                event.pressed = (ev.value != 0);
-
-                if (event.button != GAMEPAD_BUTTON_INVALID) {
-                    emit buttonEvent(m_id, event);
+            case EV_KEY:
+                if (!m_syncDropped) {
+                    handleKeyEvent(ev.code, ev.value, time_msec);
                 }
                 break;
-            }
-
-	            case EV_ABS: {
-	                int hatIndex = -1;
-	                bool isHatX = false;
-	                bool isHatY = false;
-	                switch (ev.code) {
-	                case ABS_HAT0X:
-	                    hatIndex = 0;
-	                    isHatX = true;
-	                    break;
-	                case ABS_HAT0Y:
-	                    hatIndex = 0;
-	                    isHatY = true;
-	                    break;
-	                case ABS_HAT1X:
-	                    hatIndex = 1;
-	                    isHatX = true;
-	                    break;
-	                case ABS_HAT1Y:
-	                    hatIndex = 1;
-	                    isHatY = true;
-	                    break;
-	                case ABS_HAT2X:
-	                    hatIndex = 2;
-	                    isHatX = true;
-	                    break;
-	                case ABS_HAT2Y:
-	                    hatIndex = 2;
-	                    isHatY = true;
-	                    break;
-	                case ABS_HAT3X:
-	                    hatIndex = 3;
-	                    isHatX = true;
-	                    break;
-	                case ABS_HAT3Y:
-	                    hatIndex = 3;
-	                    isHatY = true;
-	                    break;
-	                default:
-	                    break;
-	                }
 
-	                if (hatIndex >= 0) {
-	                    if (isHatX) {
-	                        m_hatXByHat[static_cast<size_t>(hatIndex)] = ev.value;
-	                    } else if (isHatY) {
-	                        m_hatYByHat[static_cast<size_t>(hatIndex)] = ev.value;
-	                    }
-
-	                    const int hatX = m_hatXByHat[static_cast<size_t>(hatIndex)];
-	                    const int hatY = m_hatYByHat[static_cast<size_t>(hatIndex)];
-
-	                    DeckGamepadHatEvent event;
-	                    event.time_msec = time_msec;
-	                    event.hat = static_cast<uint32_t>(hatIndex);
-	                    event.value = GAMEPAD_HAT_CENTER;
-
-	                    if (hatX < 0) {
-	                        event.value |= GAMEPAD_HAT_LEFT;
-	                    } else if (hatX > 0) {
-	                        event.value |= GAMEPAD_HAT_RIGHT;
-	                    }
-
-	                    if (hatY < 0) {
-	                        event.value |= GAMEPAD_HAT_UP;
-	                    } else if (hatY > 0) {
-	                        event.value |= GAMEPAD_HAT_DOWN;
-	                    }
-
-	                    emit hatEvent(m_id, event);
-
-                } else if (ev.code < MAX_ABS) {
-                    const bool halfAxisMapped = m_deviceMapping.isValid()
-                        && (m_deviceMapping.halfAxisPosButtonMap.contains(ev.code)
-                            || m_deviceMapping.halfAxisNegButtonMap.contains(ev.code));
-
-                    DeckGamepadAxisEvent event;
-                    event.time_msec = time_msec;
-                    event.axis = mapAxis(ev.code);
-                    event.value = normalizeAxisValue(ev.code, ev.value);
-
-                    if (halfAxisMapped && !m_deviceMapping.axisMap.contains(ev.code)) {
-                        event.axis = GAMEPAD_AXIS_INVALID;
-                    }
-
-                    if (halfAxisMapped) {
-                        static constexpr double kHalfAxisButtonThreshold = 0.5;
-                        int nextState = 0;
-                        if (event.value > kHalfAxisButtonThreshold) {
-                            nextState = 1;
-                        } else if (event.value < -kHalfAxisButtonThreshold) {
-                            nextState = -1;
-                        }
-
-                        const int prevState = m_halfAxisStateByCode.value(ev.code, 0);
-                        if (prevState != nextState) {
-                            auto emitMappedButton = [&](int state, bool pressed) {
-                                GamepadButton button = GAMEPAD_BUTTON_INVALID;
-                                if (state > 0) {
-                                    button = m_deviceMapping.halfAxisPosButtonMap.value(ev.code, GAMEPAD_BUTTON_INVALID);
-                                } else if (state < 0) {
-                                    button = m_deviceMapping.halfAxisNegButtonMap.value(ev.code, GAMEPAD_BUTTON_INVALID);
-                                }
-
-                                if (button == GAMEPAD_BUTTON_INVALID) {
-                                    return;
-                                }
-
-                                DeckGamepadButtonEvent btnEvent;
-                                btnEvent.time_msec = time_msec;
-                                btnEvent.button = button;
-                                btnEvent.pressed = pressed;
-                                emit buttonEvent(m_id, btnEvent);
-                            };
-
-                            if (prevState != 0) {
-                                emitMappedButton(prevState, false);
-                            }
-                            if (nextState != 0) {
-                                emitMappedButton(nextState, true);
-                            }
-
-                            m_halfAxisStateByCode.insert(ev.code, nextState);
-                        }
-                    }
-
-                    if (event.axis != GAMEPAD_AXIS_INVALID) {
-                        emit axisEvent(m_id, event);
-                    }
+            case EV_ABS:
+                if (!m_syncDropped) {
+                    handleAbsEvent(ev.code, ev.value, time_msec);
                 }
                 break;
-            }
+
             default:
                 break;
             }
@@ -447,88 +423,274 @@ void DeckGamepadDevice::processEvents()
     }
 }
 
-static double applyAxisCalibrationValue(const AxisCalibration &cal, double value)
+static int hatIndexForAbsCode(int code, bool *isX)
+{
+    switch (code) {
+    case ABS_HAT0X:
+    case ABS_HAT1X:
+    case ABS_HAT2X:
+    case ABS_HAT3X:
+        *isX = true;
+        return (code - ABS_HAT0X) / 2;
+    case ABS_HAT0Y:
+    case ABS_HAT1Y:
+    case ABS_HAT2Y:
+    case ABS_HAT3Y:
+        *isX = false;
+        return (code - ABS_HAT0Y) / 2;
+    default:
+        return -1;
+    }
+}
+
+void DeckGamepadDevice::handleKeyEvent(int code, int value, uint32_t timeMsec)
 {
-    const double min = qBound(-1.0, double(cal.min), 1.0);
-    const double max = qBound(-1.0, double(cal.max), 1.0);
-    if (max <= min) {
-        return value;
+    if (code < 0 || code >= MAX_KEY) {
+        qDebug() << "Button code out of range:" << code;
+        return;
     }
 
-    switch (cal.mode) {
-    case AxisCalibrationMode::MinMax: {
-        const double out = 2.0 * (value - min) / (max - min) - 1.0;
-        return qBound(-1.0, out, 1.0);
+    m_keyDown.set(static_cast<size_t>(code), value != 0);
+
+    DeckGamepadButtonEvent event;
+    event.time_msec = timeMsec;
+    event.button = mapButton(code);
+    event.pressed = (value != 0);
+
+    if (event.button != GAMEPAD_BUTTON_INVALID) {
+        m_frame.buttons.append(event);
     }
-    case AxisCalibrationMode::CenterMinMax: {
-        const double center = qBound(min, double(cal.centerOffset), max);
-        if (value >= center) {
-            const double denom = max - center;
-            if (denom <= 0.0) {
-                return 0.0;
-            }
-            return qBound(0.0, (value - center) / denom, 1.0);
+}
+
+void DeckGamepadDevice::handleAbsEvent(int code, int value, uint32_t timeMsec)
+{
+    if (code < 0 || code >= MAX_ABS) {
+        return;
+    }
+
+    m_absValue[static_cast<size_t>(code)] = value;
+
+    bool isHatX = false;
+    const int hatIndex = hatIndexForAbsCode(code, &isHatX);
+    if (hatIndex >= 0) {
+        if (isHatX) {
+            m_hatXByHat[static_cast<size_t>(hatIndex)] = value;
+        } else {
+            m_hatYByHat[static_cast<size_t>(hatIndex)] = value;
+        }
+
+        const int hatX = m_hatXByHat[static_cast<size_t>(hatIndex)];
+        const int hatY = m_hatYByHat[static_cast<size_t>(hatIndex)];
+
+        DeckGamepadHatEvent event;
+        event.time_msec = timeMsec;
+        event.hat = static_cast<uint32_t>(hatIndex);
+        event.value = GAMEPAD_HAT_CENTER;
+
+        if (hatX < 0) {
+            event.value |= GAMEPAD_HAT_LEFT;
+        } else if (hatX > 0) {
+            event.value |= GAMEPAD_HAT_RIGHT;
+        }
+
+        if (hatY < 0) {
+            event.value |= GAMEPAD_HAT_UP;
+        } else if (hatY > 0) {
+            event.value |= GAMEPAD_HAT_DOWN;
+        }
+
+        appendHatToFrame(event);
+        return;
+    }
+
+    const DeckGamepadAxisTransform &transform = m_axisTransforms[static_cast<size_t>(code)];
+    const bool halfAxisMapped = transform.halfAxisMapped;
+
+    DeckGamepadAxisEvent event;
+    event.time_msec = timeMsec;
+    event.axis = transform.axis;
+    event.value = transform.apply(value);
+
+    if (halfAxisMapped) {
+        static constexpr double kHalfAxisButtonThreshold = 0.5;
+        int nextState = 0;
+        if (event.value > kHalfAxisButtonThreshold) {
+            nextState = 1;
+        } else if (event.value < -kHalfAxisButtonThreshold) {
+            nextState = -1;
         }
 
-        const double denom = center - min;
-        if (denom <= 0.0) {
-            return 0.0;
+        const int prevState = m_halfAxisStateByCode[static_cast<size_t>(code)];
+        if (prevState != nextState) {
+            auto appendMappedButton = [&](int state, bool pressed) {
+                GamepadButton button = GAMEPAD_BUTTON_INVALID;
+                if (state > 0) {
+                    button = m_deviceMapping.halfAxisPosButtonMap.value(code, GAMEPAD_BUTTON_INVALID);
+                } else if (state < 0) {
+                    button = m_deviceMapping.halfAxisNegButtonMap.value(code, GAMEPAD_BUTTON_INVALID);
+                }
+
+                if (button == GAMEPAD_BUTTON_INVALID) {
+                    return;
+                }
+
+                DeckGamepadButtonEvent btnEvent;
+                btnEvent.time_msec = timeMsec;
+                btnEvent.button = button;
+                btnEvent.pressed = pressed;
+                m_frame.buttons.append(btnEvent);
+            };
+
+            if (prevState != 0) {
+                appendMappedButton(prevState, false);
+            }
+            if (nextState != 0) {
+                appendMappedButton(nextState, true);
+            }
+
+            m_halfAxisStateByCode[static_cast<size_t>(code)] = nextState;
         }
-        return qBound(-1.0, (value - center) / denom, 0.0);
     }
+
+    if (event.axis != GAMEPAD_AXIS_INVALID) {
+        appendAxisToFrame(event);
     }
-    return value;
 }
 
-double DeckGamepadDevice::normalizeAxisValue(int code, int value)
+void DeckGamepadDevice::appendAxisToFrame(const DeckGamepadAxisEvent &event)
 {
-    const AxisInfo &info = m_absInfo[code];
+    // 同帧内同一轴只保留最终值（帧内条目很少，线性查找即可）。
+    for (DeckGamepadAxisEvent &pending : m_frame.axes) {
+        if (pending.axis == event.axis) {
+            pending = event;
+            return;
+        }
+    }
+    m_frame.axes.append(event);
+}
 
-    if (info.max == info.min) {
-        return 0.0;
+void DeckGamepadDevice::appendHatToFrame(const DeckGamepadHatEvent &event)
+{
+    // HATnX/HATnY 同帧到达时合并为一个 hat 事件。
+    for (DeckGamepadHatEvent &pending : m_frame.hats) {
+        if (pending.hat == event.hat) {
+            pending = event;
+            return;
+        }
+    }
+    m_frame.hats.append(event);
+}
+
+void DeckGamepadDevice::flushFrame(uint32_t timeMsec)
+{
+    if (m_frame.isEmpty()) {
+        return;
     }
 
-    double normalized = 2.0 * (value - info.min) / (info.max - info.min) - 1.0;
+    m_frame.time_msec = timeMsec;
+    m_frame.monotonicNs = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+    emit frameEvent(m_id, m_frame);
+    m_frame.clear();
+}
 
-    if (isAxisInverted(code)) {
-        normalized = -normalized;
+void DeckGamepadDevice::resyncAfterDrop(uint32_t timeMsec)
+{
+    if (m_fd == -1) {
+        return;
     }
 
-    GamepadAxis axis = mapAxis(code);
-    if (axis != GAMEPAD_AXIS_INVALID && m_calibrationData && !m_guid.isEmpty()) {
-        const auto devIt = m_calibrationData->devices.constFind(m_guid);
-        if (devIt != m_calibrationData->devices.constEnd()) {
-            const auto axisIt = devIt->axes.constFind(axis);
-            if (axisIt != devIt->axes.constEnd()) {
-                normalized = applyAxisCalibrationValue(axisIt.value(), normalized);
+    // 与 libevdev 的 SYN_DROPPED 处理一致：读取当前内核状态，只为与已上报状态不同的 code 合成事件。
+    unsigned long keyState[NBITS(KEY_MAX)] = { 0 };
+    if (ioctl(m_fd, EVIOCGKEY(sizeof(keyState)), keyState) >= 0) {
+        for (auto it = m_physicalButtonMap.constBegin(); it != m_physicalButtonMap.constEnd(); ++it) {
+            const int code = it.key();
+            if (code < 0 || code >= MAX_KEY) {
+                continue;
+            }
+            const bool down = test_bit(code, keyState);
+            if (down != m_keyDown.test(static_cast<size_t>(code))) {
+                handleKeyEvent(code, down ? 1 : 0, timeMsec);
             }
         }
     }
 
-    if (info.flat > 0) {
-        double flat_threshold = std::abs(info.flat / double(info.max - info.min));
-        if (std::abs(normalized) <= flat_threshold) {
-            normalized = 0.0;
+    for (int code = 0; code < MAX_ABS; ++code) {
+        if (!m_absSupported.test(static_cast<size_t>(code))) {
+            continue;
+        }
+        struct input_absinfo absInfo;
+        if (ioctl(m_fd, EVIOCGABS(code), &absInfo) < 0) {
+            continue;
+        }
+        if (absInfo.value != m_absValue[static_cast<size_t>(code)]) {
+            handleAbsEvent(code, absInfo.value, timeMsec);
         }
     }
+}
 
-    if (axis != GAMEPAD_AXIS_INVALID && m_customDeadzones.contains(axis)) {
-        float customDeadzone = m_customDeadzones.value(axis);
-        if (std::abs(normalized) <= customDeadzone) {
-            normalized = 0.0;
-        } else {
-            double sign = (normalized > 0) ? 1.0 : -1.0;
-            normalized = sign * (std::abs(normalized) - customDeadzone) / (1.0 - customDeadzone);
+void DeckGamepadDevice::rebuildAxisTransforms()
+{
+    const DeviceCalibration *calibration = nullptr;
+    if (m_calibrationData && !m_guid.isEmpty()) {
+        const auto devIt = m_calibrationData->devices.constFind(m_guid);
+        if (devIt != m_calibrationData->devices.constEnd()) {
+            calibration = &devIt.value();
         }
     }
 
-    if (axis != GAMEPAD_AXIS_INVALID && m_axisSensitivity.contains(axis)) {
-        float sensitivity = m_axisSensitivity.value(axis);
-        normalized *= sensitivity;
-        normalized = qBound(-1.0, normalized, 1.0);
-    }
+    for (int code = 0; code < MAX_ABS; ++code) {
+        DeckGamepadAxisTransform &transform = m_axisTransforms[static_cast<size_t>(code)];
+        transform = DeckGamepadAxisTransform{};
+
+        bool isHatX = false;
+        if (hatIndexForAbsCode(code, &isHatX) >= 0) {
+            continue;
+        }
+
+        const AxisInfo &info = m_absInfo[code];
+        transform.min = info.min;
+        transform.max = info.max;
+        if (info.flat > 0 && info.max != info.min) {
+            transform.flatThreshold = std::abs(info.flat / double(info.max - info.min));
+        }
+
+        const GamepadAxis axis = mapAxis(code);
+        transform.axis = axis;
+        transform.inverted = m_deviceMapping.invertedAxes.contains(code);
+        transform.halfAxisMapped = m_deviceMapping.isValid()
+            && (m_deviceMapping.halfAxisPosButtonMap.contains(code)
+                || m_deviceMapping.halfAxisNegButtonMap.contains(code));
+        if (transform.halfAxisMapped && !m_deviceMapping.axisMap.contains(code)) {
+            transform.axis = GAMEPAD_AXIS_INVALID;
+        }
+
+        // 校准/死区/灵敏度按映射后的轴生效（与半轴按键是否另行输出无关）。
+        if (axis != GAMEPAD_AXIS_INVALID) {
+            if (calibration) {
+                const auto axisIt = calibration->axes.constFind(axis);
+                if (axisIt != calibration->axes.constEnd()) {
+                    transform.hasCalibration = true;
+                    transform.calibration = axisIt.value();
+                }
+            }
+
+            const auto deadzoneIt = m_customDeadzones.constFind(axis);
+            if (deadzoneIt != m_customDeadzones.constEnd()) {
+                transform.hasDeadzone = true;
+                transform.deadzone = deadzoneIt.value();
+            }
+
+            const auto sensitivityIt = m_axisSensitivity.constFind(axis);
+            if (sensitivityIt != m_axisSensitivity.constEnd()) {
+                transform.hasSensitivity = true;
+                transform.sensitivity = sensitivityIt.value();
+            }
+        }
 
-    return normalized;
+        if (m_absSupported.test(static_cast<size_t>(code))) {
+            transform.buildLut();
+        }
+    }
 }
 
 GamepadButton DeckGamepadDevice::mapButton(int evdev_code) const
@@ -603,11 +765,6 @@ GamepadAxis DeckGamepadDevice::mapAxis(int evdev_code) const
     }
 }
 
-bool DeckGamepadDevice::isAxisInverted(int evdev_code) const
-{
-    return m_deviceMapping.invertedAxes.contains(evdev_code);
-}
-
 bool DeckGamepadDevice::startVibration(float weakMagnitude, float strongMagnitude, int duration_ms)
 {
     if (!m_hasFF || m_fd == -1) {
@@ -620,55 +777,114 @@ bool DeckGamepadDevice::startVibration(float weakMagnitude, float strongMagnitud
         return false;
     }
 
-    if (m_ffEffectId != -1) {
-        stopVibration();
+    return m_rumble->setLevel(weakMagnitude, strongMagnitude, qMax(0, duration_ms));
+}
+
+bool DeckGamepadDevice::playVibrationPattern(const DeckGamepadRumblePattern &pattern)
+{
+    if (!m_hasFF || m_fd == -1) {
+        return false;
     }
 
-    struct ff_effect effect;
-    memset(&effect, 0, sizeof(effect));
-    effect.type = FF_RUMBLE;
-    effect.id = -1; // -1 means create new effect
-    effect.u.rumble.weak_magnitude = static_cast<uint16_t>(weakMagnitude * 0xFFFF);
-    effect.u.rumble.strong_magnitude = static_cast<uint16_t>(strongMagnitude * 0xFFFF);
-    effect.replay.length = duration_ms; // Duration in milliseconds
-    effect.replay.delay = 0;
+    if (!pattern.isValid()) {
+        qWarning() << "Invalid vibration pattern for device" << m_id;
+        return false;
+    }
+
+    return m_rumble->play(pattern);
+}
+
+void DeckGamepadDevice::stopVibration()
+{
+    m_rumble->stop();
+}
 
-    if (ioctl(m_fd, EVIOCSFF, &effect) < 0) {
-        qWarning() << "Failed to upload vibration effect:" << strerror(errno);
+bool DeckGamepadDevice::writeRumble(float weakMagnitude, float strongMagnitude, int durationMs)
+{
+    if (!m_hasFF || m_fd == -1) {
         return false;
     }
 
     struct input_event play;
     memset(&play, 0, sizeof(play));
     play.type = EV_FF;
-    play.code = effect.id;
+
+    if (weakMagnitude <= 0.0f && strongMagnitude <= 0.0f) {
+        if (m_ffEffectId == -1 || !m_ffPlaying) {
+            return true;
+        }
+        play.code = m_ffEffectId;
+        play.value = 0; // Stop
+        m_ffPlaying = false;
+        if (write(m_fd, &play, sizeof(play)) == -1) {
+            qWarning() << "Failed to stop vibration effect:" << strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    const auto weak = static_cast<quint16>(weakMagnitude * 0xFFFF);
+    const auto strong = static_cast<quint16>(strongMagnitude * 0xFFFF);
+    const auto length = static_cast<quint16>(qBound(0, durationMs, 0xFFFF)); // 0 表示持续
+
+    // 同一槽位原地更新（effect.id 复用）；参数未变时只重新触发播放。
+    if (m_ffEffectId == -1 || m_ffUploaded.weak != weak || m_ffUploaded.strong != strong
+        || m_ffUploaded.length != length) {
+        struct ff_effect effect;
+        memset(&effect, 0, sizeof(effect));
+        effect.type = FF_RUMBLE;
+        effect.id = static_cast<qint16>(m_ffEffectId); // -1 means create new effect
+        effect.u.rumble.weak_magnitude = weak;
+        effect.u.rumble.strong_magnitude = strong;
+        effect.replay.length = length;
+        effect.replay.delay = 0;
+
+        int rc = ioctl(m_fd, EVIOCSFF, &effect);
+        if (rc < 0 && m_ffEffectId != -1) {
+            // 槽位可能已被驱动回收：重新分配一次。
+            effect.id = -1;
+            rc = ioctl(m_fd, EVIOCSFF, &effect);
+        }
+        if (rc < 0) {
+            qWarning() << "Failed to upload vibration effect:" << strerror(errno);
+            m_ffEffectId = -1;
+            m_ffPlaying = false;
+            return false;
+        }
+
+        m_ffEffectId = effect.id;
+        m_ffUploaded.weak = weak;
+        m_ffUploaded.strong = strong;
+        m_ffUploaded.length = length;
+    }
+
+    play.code = m_ffEffectId;
     play.value = 1; // Play once
 
     if (write(m_fd, &play, sizeof(play)) == -1) {
         qWarning() << "Failed to play vibration effect:" << strerror(errno);
-        ioctl(m_fd, EVIOCRMFF, effect.id);
+        m_ffPlaying = false;
         return false;
     }
 
-    m_ffEffectId = effect.id;
-    qDebug() << "Started vibration on device" << m_id << "weak:" << weakMagnitude
-             << "strong:" << strongMagnitude << "duration:" << duration_ms << "ms";
+    m_ffPlaying = true;
     return true;
 }
 
-void DeckGamepadDevice::stopVibration()
+void DeckGamepadDevice::releaseRumbleSlot()
 {
-    if (!m_hasFF || m_fd == -1 || m_ffEffectId == -1) {
+    m_rumble->stop();
+
+    if (m_ffEffectId == -1) {
         return;
     }
 
-    if (ioctl(m_fd, EVIOCRMFF, m_ffEffectId) < 0) {
+    if (m_fd != -1 && ioctl(m_fd, EVIOCRMFF, m_ffEffectId) < 0) {
         qWarning() << "Failed to remove vibration effect:" << strerror(errno);
-        return;
     }
-
-    qDebug() << "Stopped vibration on device" << m_id;
     m_ffEffectId = -1;
+    m_ffPlaying = false;
+    m_ffUploaded = FfRumbleParams{};
 }
 
 DeckGamepadBackend *DeckGamepadBackend::s_instance = nullptr;
@@ -694,6 +910,15 @@ DeckGamepadBackend::DeckGamepadBackend(QObject *parent)
 
     m_accessBroker = std::make_unique<DeviceAccessBroker>();
     m_sessionGate = std::make_unique<SessionGate>();
+    // SessionGate 已解析的 session 直接复用：TakeDevice 前无需再次 GetSessionByPID。
+    m_accessBroker->setSessionPath(m_sessionGate->sessionPath());
+    connect(m_sessionGate.get(),
+            &SessionGate::sessionPathChanged,
+            m_accessBroker.get(),
+            &DeviceAccessBroker::setSessionPath);
+
+    m_probePool.setMaxThreadCount(qMax(1, m_runtimeConfig.probeConcurrency));
+    m_probePool.setExpiryTimeout(5000);
 
     qDebug() << "DeckGamepadBackend initialized";
 }
@@ -701,6 +926,8 @@ DeckGamepadBackend::DeckGamepadBackend(QObject *parent)
 DeckGamepadBackend::~DeckGamepadBackend()
 {
     stop();
+    // 在途探测的结果投递给 this；等待完成后未处理的投递随 QObject 析构一并丢弃（fd 由 ProbeOutcome 归还）。
+    m_probePool.waitForDone();
 
     if (s_instance == this) {
         s_instance = nullptr;
@@ -730,6 +957,8 @@ void DeckGamepadBackend::setRuntimeConfig(const DeckGamepadRuntimeConfig &config
                                   == DeckGamepadCapturePolicy::ActiveSessionOnly);
     }
 
+    m_probePool.setMaxThreadCount(qMax(1, m_runtimeConfig.probeConcurrency));
+
     if (m_customMappingMgr) {
         m_customMappingMgr->setLegacyDirName(m_runtimeConfig.legacyDataDirName);
         m_customMappingMgr->setLegacyFallbackEnabled(m_runtimeConfig.enableLegacyDeckShellPaths);
@@ -799,6 +1028,10 @@ bool DeckGamepadBackend::start()
     }
     loadCalibration();
 
+    m_probeHistogram = DeckGamepadProbeHistogram{};
+    m_startupTimer.start();
+    m_startupProbePending = true;
+
     probeGamepads();
 
     if (m_runtimeConfig.enableAutoRetryOpen) {
@@ -814,7 +1047,9 @@ bool DeckGamepadBackend::start()
     }
 
     m_running = true;
-    qDebug() << "Gamepad backend started, found" << m_devices.count() << "gamepads";
+    qDebug() << "Gamepad backend started, found" << m_devices.count() << "gamepads,"
+             << m_pendingProbes.size() << "probing";
+    maybeFinishStartupProbe();
     return true;
 }
 
@@ -822,6 +1057,11 @@ void DeckGamepadBackend::stop()
 {
     m_running = false;
 
+    // 尚未开始的探测直接取消；在途探测的结果因票据失效在发布时丢弃。
+    m_probePool.clear();
+    m_pendingProbes.clear();
+    m_startupProbePending = false;
+
     // 关闭所有设备
     for (auto it = m_devices.begin(); it != m_devices.end(); ++it) {
         if (it.value()) {
@@ -832,6 +1072,9 @@ void DeckGamepadBackend::stop()
     m_devices.clear();
     m_devicePaths.clear();
     m_knownDevices.clear();
+    if (m_customMappingMgr) {
+        m_customMappingMgr->retractAllDeviceSnapshots();
+    }
 
     if (m_udevNotifier) {
         m_udevNotifier->setEnabled(false);
@@ -867,39 +1110,21 @@ void DeckGamepadBackend::probeGamepads()
     struct udev_list_entry *devices = udev_enumerate_get_list_entry(enumerate);
     struct udev_list_entry *entry = nullptr;
 
-	    udev_list_entry_foreach(entry, devices)
-	    {
-	        const char *path = udev_list_entry_get_name(entry);
-	        struct udev_device *dev = udev_device_new_from_syspath(m_udev, path);
-	        if (!dev) {
-	            continue;
-	        }
-	        const char *devnode = udev_device_get_devnode(dev);
-
-	        if (devnode) {
-	            QString devpath(devnode);
-
-	            if (!devpath.contains("/js")) {
-	                const char *isJoystick = udev_device_get_property_value(dev, "ID_INPUT_JOYSTICK");
-	                const char *isGamepad = udev_device_get_property_value(dev, "ID_INPUT_GAMEPAD");
-	                const bool hasGamepadHint = (isJoystick != nullptr) || (isGamepad != nullptr);
-	                const bool udevCandidate = (isJoystick && strcmp(isJoystick, "1") == 0)
-	                    || (isGamepad && strcmp(isGamepad, "1") == 0);
-
-	                bool candidate = udevCandidate;
-	                int probeErrno = 0;
-	                if (!candidate) {
-	                    candidate = isGamepadDevice(devpath, &probeErrno);
-	                    if (!candidate && (probeErrno == EACCES || probeErrno == EPERM) && !hasGamepadHint) {
-	                        candidate = true;
-	                    }
-	                }
+    udev_list_entry_foreach(entry, devices)
+    {
+        const char *path = udev_list_entry_get_name(entry);
+        struct udev_device *dev = udev_device_new_from_syspath(m_udev, path);
+        if (!dev) {
+            continue;
+        }
+        const char *devnode = udev_device_get_devnode(dev);
 
-	                if (candidate) {
-	                    openGamepad(dev, devpath);
-	                }
-	            }
-	        }
+        if (devnode) {
+            const QString devpath = QString::fromUtf8(devnode);
+            if (!devpath.contains(QStringLiteral("/js"))) {
+                handleUdevCandidate(dev, devpath);
+            }
+        }
 
         udev_device_unref(dev);
     }
@@ -907,20 +1132,20 @@ void DeckGamepadBackend::probeGamepads()
     udev_enumerate_unref(enumerate);
 }
 
-	bool DeckGamepadBackend::isGamepadDevice(const QString &devpath, int *openErrno)
-	{
-	    if (openErrno) {
-	        *openErrno = 0;
-	    }
+bool DeckGamepadBackend::isGamepadDevice(const QString &devpath, int *openErrno)
+{
+    if (openErrno) {
+        *openErrno = 0;
+    }
 
-	    errno = 0;
-	    int fd = ::open(devpath.toUtf8().constData(), O_RDONLY | O_NONBLOCK);
-	    if (fd == -1) {
-	        if (openErrno) {
-	            *openErrno = errno;
-	        }
-	        return false;
-	    }
+    errno = 0;
+    int fd = ::open(devpath.toUtf8().constData(), O_RDONLY | O_NONBLOCK);
+    if (fd == -1) {
+        if (openErrno) {
+            *openErrno = errno;
+        }
+        return false;
+    }
 
     unsigned long evbit[NBITS(EV_MAX)] = { 0 };
     unsigned long absbit[NBITS(ABS_MAX)] = { 0 };
@@ -984,51 +1209,127 @@ QString DeckGamepadBackend::udevDeviceName(struct udev_device *dev) const
     return QString{};
 }
 
-void DeckGamepadBackend::openGamepad(struct udev_device *dev, const QString &devpath)
+void DeckGamepadBackend::handleUdevCandidate(struct udev_device *dev, const QString &devpath)
 {
-    int id = m_devicePaths.value(devpath, -1);
-    if (id == -1) {
-        id = getUnusedDeviceId();
-        if (id == -1) {
-            qWarning() << "Maximum number of gamepads reached";
+    const char *isJoystick = udev_device_get_property_value(dev, "ID_INPUT_JOYSTICK");
+    const char *isGamepad = udev_device_get_property_value(dev, "ID_INPUT_GAMEPAD");
+    const bool hasGamepadHint = (isJoystick != nullptr) || (isGamepad != nullptr);
+    const bool udevCandidate = (isJoystick && strcmp(isJoystick, "1") == 0)
+        || (isGamepad && strcmp(isGamepad, "1") == 0);
+
+    if (asyncProbeEnabled()) {
+        const int knownId = m_devicePaths.value(devpath, -1);
+        if (m_pendingProbes.contains(devpath) || (knownId != -1 && m_devices.contains(knownId))) {
             return;
         }
 
-        KnownDevice known;
-        known.devpath = devpath;
-        known.info.name = udevDeviceName(dev);
-        if (dev) {
-            QHash<QString, QString> props;
-            const char *keys[] = { "ID_VENDOR_ID", "ID_MODEL_ID", "ID_BUS", "ID_SERIAL_SHORT",
-                                   "ID_SERIAL",    "ID_PATH",     "DEVPATH" };
-            for (const char *k : keys) {
-                const char *v = udev_device_get_property_value(dev, k);
-                if (v && *v) {
-                    props.insert(QString::fromLatin1(k), QString::fromUtf8(v));
-                }
+        auto outcome = std::make_shared<ProbeOutcome>();
+        outcome->devpath = devpath;
+        // 仅统计新发现的设备（周期性重扫/重试不计入直方图）
+        outcome->recordTiming = (knownId == -1);
+        outcome->elapsed.start();
+        if (udevCandidate || knownId != -1) {
+            // udev 已标记为手柄：立即登记（deviceId 按枚举顺序分配），打开交给探测线程池。
+            outcome->deviceId = knownId != -1 ? knownId : registerKnownDevice(knownDeviceFromUdev(dev, devpath));
+            if (outcome->deviceId == -1 || m_devices.contains(outcome->deviceId)
+                || applySessionGate(outcome->deviceId)) {
+                return;
             }
+        } else {
+            // 无 udev 标记：能力检测（open + ioctl）也在线程池中完成，确认后再登记。
+            outcome->checkCapabilities = true;
+            outcome->hasGamepadHint = hasGamepadHint;
+            outcome->pendingKnown = knownDeviceFromUdev(dev, devpath);
+        }
+        scheduleProbe(std::move(outcome));
+        return;
+    }
 
-            const QString vendorIdHex = props.value(QStringLiteral("ID_VENDOR_ID"));
-            const QString productIdHex = props.value(QStringLiteral("ID_MODEL_ID"));
-            bool okVid = false;
-            bool okPid = false;
-            const uint16_t vid = vendorIdHex.toUShort(&okVid, 16);
-            const uint16_t pid = productIdHex.toUShort(&okPid, 16);
-            if (okVid) {
-                known.info.vendorId = vid;
-            }
-            if (okPid) {
-                known.info.productId = pid;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    const bool isNew = !m_devicePaths.contains(devpath);
+
+    bool candidate = udevCandidate;
+    int probeErrno = 0;
+    if (!candidate) {
+        candidate = isGamepadDevice(devpath, &probeErrno);
+        if (!candidate && (probeErrno == EACCES || probeErrno == EPERM) && !hasGamepadHint) {
+            candidate = true;
+        }
+    }
+
+    if (candidate) {
+        openGamepad(dev, devpath);
+        if (isNew) {
+            recordProbeTiming(elapsed.nsecsElapsed() / 1000);
+        }
+    }
+}
+
+DeckGamepadBackend::KnownDevice DeckGamepadBackend::knownDeviceFromUdev(struct udev_device *dev,
+                                                                        const QString &devpath) const
+{
+    KnownDevice known;
+    known.devpath = devpath;
+    known.info.name = udevDeviceName(dev);
+    if (dev) {
+        QHash<QString, QString> props;
+        const char *keys[] = { "ID_VENDOR_ID", "ID_MODEL_ID", "ID_BUS", "ID_SERIAL_SHORT",
+                               "ID_SERIAL",    "ID_PATH",     "DEVPATH" };
+        for (const char *k : keys) {
+            const char *v = udev_device_get_property_value(dev, k);
+            if (v && *v) {
+                props.insert(QString::fromLatin1(k), QString::fromUtf8(v));
             }
-            known.info.transport = props.value(QStringLiteral("ID_BUS"));
-            known.info.deviceUid = DeckGamepadDeviceUidGenerator::generateFromUdevProperties(props);
         }
-        known.availability = DeckGamepadDeviceAvailability::Unavailable;
-        m_knownDevices.insert(id, known);
-        m_devicePaths.insert(devpath, id);
 
-        Q_EMIT deviceInfoChanged(id, known.info);
-        Q_EMIT deviceAvailabilityChanged(id, DeckGamepadDeviceAvailability::Unavailable);
+        const QString vendorIdHex = props.value(QStringLiteral("ID_VENDOR_ID"));
+        const QString productIdHex = props.value(QStringLiteral("ID_MODEL_ID"));
+        bool okVid = false;
+        bool okPid = false;
+        const uint16_t vid = vendorIdHex.toUShort(&okVid, 16);
+        const uint16_t pid = productIdHex.toUShort(&okPid, 16);
+        if (okVid) {
+            known.info.vendorId = vid;
+        }
+        if (okPid) {
+            known.info.productId = pid;
+        }
+        known.info.transport = props.value(QStringLiteral("ID_BUS"));
+        known.info.deviceUid = DeckGamepadDeviceUidGenerator::generateFromUdevProperties(props);
+    }
+    known.availability = DeckGamepadDeviceAvailability::Unavailable;
+    return known;
+}
+
+int DeckGamepadBackend::registerKnownDevice(KnownDevice known)
+{
+    int id = m_devicePaths.value(known.devpath, -1);
+    if (id != -1) {
+        return id;
+    }
+
+    id = getUnusedDeviceId();
+    if (id == -1) {
+        qWarning() << "Maximum number of gamepads reached";
+        return -1;
+    }
+
+    const QString devpath = known.devpath;
+    const DeckGamepadDeviceInfo info = known.info;
+    m_knownDevices.insert(id, std::move(known));
+    m_devicePaths.insert(devpath, id);
+
+    Q_EMIT deviceInfoChanged(id, info);
+    Q_EMIT deviceAvailabilityChanged(id, DeckGamepadDeviceAvailability::Unavailable);
+    return id;
+}
+
+void DeckGamepadBackend::openGamepad(struct udev_device *dev, const QString &devpath)
+{
+    const int id = registerKnownDevice(knownDeviceFromUdev(dev, devpath));
+    if (id == -1) {
+        return;
     }
 
     (void)tryOpenGamepad(id, devpath);
@@ -1040,32 +1341,98 @@ bool DeckGamepadBackend::tryOpenGamepad(int deviceId, const QString &devpath)
         return true;
     }
 
-    auto itKnown = m_knownDevices.find(deviceId);
-    if (itKnown == m_knownDevices.end()) {
+    if (!m_knownDevices.contains(deviceId)) {
         return false;
     }
 
-    if (m_sessionGate && m_sessionGate->enabled() && !m_sessionGate->isActive()) {
-        DeckGamepadError err;
-        err.code = DeckGamepadErrorCode::Io;
-        err.message = QStringLiteral("Session inactive (input gated)");
-        err.context = QStringLiteral("SessionGate");
-        err.recoverable = true;
-        itKnown->availability = DeckGamepadDeviceAvailability::Unavailable;
-        setDeviceAvailability(deviceId, DeckGamepadDeviceAvailability::Unavailable);
-        setDeviceError(deviceId, err);
+    if (applySessionGate(deviceId)) {
         return false;
     }
 
-    DeckGamepadDeviceOpenResult openResult;
+    ProbeOutcome outcome;
+    outcome.devpath = devpath;
     if (m_accessBroker) {
-        openResult = m_accessBroker->openDevice(devpath);
+        runOpenPipeline(outcome, *m_accessBroker, m_runtimeConfig, m_sdlDb != nullptr);
     } else {
         DeviceAccessBroker fallback;
         fallback.setRuntimeConfig(m_runtimeConfig);
-        openResult = fallback.openDevice(devpath);
+        runOpenPipeline(outcome, fallback, m_runtimeConfig, m_sdlDb != nullptr);
+    }
+
+    return publishOpenOutcome(deviceId, devpath, outcome);
+}
+
+bool DeckGamepadBackend::applySessionGate(int deviceId)
+{
+    if (!m_sessionGate || !m_sessionGate->enabled() || m_sessionGate->isActive()) {
+        return false;
+    }
+
+    auto itKnown = m_knownDevices.find(deviceId);
+    if (itKnown == m_knownDevices.end()) {
+        return true;
     }
 
+    DeckGamepadError err;
+    err.code = DeckGamepadErrorCode::Io;
+    err.message = QStringLiteral("Session inactive (input gated)");
+    err.context = QStringLiteral("SessionGate");
+    err.recoverable = true;
+    itKnown->availability = DeckGamepadDeviceAvailability::Unavailable;
+    setDeviceAvailability(deviceId, DeckGamepadDeviceAvailability::Unavailable);
+    setDeviceError(deviceId, err);
+    return true;
+}
+
+void DeckGamepadBackend::runOpenPipeline(ProbeOutcome &outcome,
+                                         DeviceAccessBroker &broker,
+                                         const DeckGamepadRuntimeConfig &config,
+                                         bool resolveGuid,
+                                         bool deferLogind)
+{
+    // 已由 logind 完成打开（异步第二段）：直接进入 grab/probe。
+    if (!outcome.openResult.ok()) {
+        if (outcome.checkCapabilities) {
+            int probeErrno = 0;
+            outcome.candidate = isGamepadDevice(outcome.devpath, &probeErrno);
+            if (!outcome.candidate && (probeErrno == EACCES || probeErrno == EPERM) && !outcome.hasGamepadHint) {
+                outcome.candidate = true;
+            }
+            if (!outcome.candidate) {
+                return;
+            }
+        }
+
+        outcome.openResult = deferLogind ? broker.openDeviceDeferringLogind(outcome.devpath)
+                                         : broker.openDevice(outcome.devpath);
+        if (!outcome.openResult.ok()) {
+            return;
+        }
+    }
+
+    if (config.grabMode == DeckGamepadEvdevGrabMode::Exclusive
+        || config.grabMode == DeckGamepadEvdevGrabMode::Auto) {
+        errno = 0;
+        if (ioctl(outcome.openResult.fd, EVIOCGRAB, 1) < 0) {
+            outcome.grabErrno = errno;
+            if (config.grabMode == DeckGamepadEvdevGrabMode::Exclusive) {
+                return;
+            }
+        }
+    }
+
+    outcome.snapshot = DeckGamepadDevice::probeFd(outcome.openResult.fd, outcome.devpath, resolveGuid);
+    outcome.probed = true;
+}
+
+bool DeckGamepadBackend::publishOpenOutcome(int deviceId, const QString &devpath, ProbeOutcome &outcome)
+{
+    auto itKnown = m_knownDevices.find(deviceId);
+    if (itKnown == m_knownDevices.end()) {
+        return false;
+    }
+
+    DeckGamepadDeviceOpenResult &openResult = outcome.openResult;
     if (!openResult.ok()) {
         DeckGamepadError err = openResult.error;
         if (err.isOk()) {
@@ -1093,54 +1460,45 @@ bool DeckGamepadBackend::tryOpenGamepad(int deviceId, const QString &devpath)
         return false;
     }
 
-    int fd = openResult.fd;
-
     bool autoGrabFailed = false;
     DeckGamepadError autoGrabError;
 
-    if (m_runtimeConfig.grabMode == DeckGamepadEvdevGrabMode::Exclusive
-        || m_runtimeConfig.grabMode == DeckGamepadEvdevGrabMode::Auto) {
-        errno = 0;
-        if (ioctl(fd, EVIOCGRAB, 1) < 0) {
-            const int grabErrno = errno;
-            if (m_runtimeConfig.grabMode == DeckGamepadEvdevGrabMode::Exclusive) {
-                if (openResult.releaseDevice) {
-                    openResult.releaseDevice();
-                    openResult.releaseDevice = {};
-                }
-                ::close(fd);
-
-                DeckGamepadError err;
-                err.code = DeckGamepadErrorCode::Io;
-                err.sysErrno = grabErrno;
-                err.message = QStringLiteral("Failed to grab gamepad device (EVIOCGRAB)");
-                err.context = QStringLiteral("EVIOCGRAB");
-                err.recoverable = m_runtimeConfig.enableAutoRetryOpen;
-
-                itKnown->availability = DeckGamepadDeviceAvailability::Unavailable;
-                setDeviceAvailability(deviceId, DeckGamepadDeviceAvailability::Unavailable);
-                setDeviceError(deviceId, err);
-                scheduleNextRetry();
-                return false;
-            }
+    if (outcome.grabErrno != 0) {
+        if (m_runtimeConfig.grabMode == DeckGamepadEvdevGrabMode::Exclusive) {
+            outcome.releaseFd();
+
+            DeckGamepadError err;
+            err.code = DeckGamepadErrorCode::Io;
+            err.sysErrno = outcome.grabErrno;
+            err.message = QStringLiteral("Failed to grab gamepad device (EVIOCGRAB)");
+            err.context = QStringLiteral("EVIOCGRAB");
+            err.recoverable = m_runtimeConfig.enableAutoRetryOpen;
 
-            // grabMode=Auto: prefer exclusive grab, but fall back to shared mode if grabbing fails.
-            autoGrabFailed = true;
-            autoGrabError.code = DeckGamepadErrorCode::Io;
-            autoGrabError.sysErrno = grabErrno;
-            autoGrabError.message = QStringLiteral("Failed to grab gamepad device (EVIOCGRAB), falling back to shared");
-            autoGrabError.context = QStringLiteral("EVIOCGRAB");
-            autoGrabError.hint = QStringLiteral("running in shared mode (grabMode=Auto fallback)");
-            autoGrabError.recoverable = false;
+            itKnown->availability = DeckGamepadDeviceAvailability::Unavailable;
+            setDeviceAvailability(deviceId, DeckGamepadDeviceAvailability::Unavailable);
+            setDeviceError(deviceId, err);
+            scheduleNextRetry();
+            return false;
         }
+
+        // grabMode=Auto: prefer exclusive grab, but fall back to shared mode if grabbing fails.
+        autoGrabFailed = true;
+        autoGrabError.code = DeckGamepadErrorCode::Io;
+        autoGrabError.sysErrno = outcome.grabErrno;
+        autoGrabError.message = QStringLiteral("Failed to grab gamepad device (EVIOCGRAB), falling back to shared");
+        autoGrabError.context = QStringLiteral("EVIOCGRAB");
+        autoGrabError.hint = QStringLiteral("running in shared mode (grabMode=Auto fallback)");
+        autoGrabError.recoverable = false;
     }
 
     DeckGamepadDevice *device = new DeckGamepadDevice(deviceId, devpath, m_sdlDb, this);
     device->m_calibrationData = m_calibrationData.get();
-    if (!device->openWithFd(fd, std::move(openResult.releaseDevice))) {
-        if (openResult.releaseDevice) {
-            openResult.releaseDevice();
-        }
+    if (!outcome.probed) {
+        outcome.snapshot = DeckGamepadDevice::probeFd(openResult.fd, devpath, m_sdlDb != nullptr);
+    }
+    // fd 与 releaseDevice 的所有权转交给 device
+    const int fd = std::exchange(openResult.fd, -1);
+    if (!device->openWithProbe(fd, std::move(outcome.snapshot), std::exchange(openResult.releaseDevice, {}))) {
         ::close(fd);
         device->deleteLater();
 
@@ -1157,6 +1515,7 @@ bool DeckGamepadBackend::tryOpenGamepad(int deviceId, const QString &devpath)
         return false;
     }
 
+    device->m_rumble->setMinIntervalMs(m_runtimeConfig.rumbleMinIntervalMs);
     m_devices.insert(deviceId, device);
 
     itKnown->availability = DeckGamepadDeviceAvailability::Available;
@@ -1173,15 +1532,16 @@ bool DeckGamepadBackend::tryOpenGamepad(int deviceId, const QString &devpath)
     }
     Q_EMIT deviceInfoChanged(deviceId, itKnown->info);
 
-    connect(device, &DeckGamepadDevice::buttonEvent, this, &DeckGamepadBackend::buttonEvent);
-    connect(device, &DeckGamepadDevice::axisEvent, this, &DeckGamepadBackend::axisEvent);
-    connect(device, &DeckGamepadDevice::hatEvent, this, &DeckGamepadBackend::hatEvent);
+    connect(device, &DeckGamepadDevice::frameEvent, this, &DeckGamepadBackend::handleDeviceFrame);
     connect(device, &DeckGamepadDevice::disconnected, this, [this, deviceId, devpath]() {
         auto it = m_devices.find(deviceId);
         if (it != m_devices.end()) {
             it.value()->deleteLater();
             m_devices.erase(it);
         }
+        if (m_customMappingMgr) {
+            m_customMappingMgr->retractDeviceSnapshot(deviceId);
+        }
 
         auto itKnown = m_knownDevices.find(deviceId);
         if (itKnown != m_knownDevices.end()) {
@@ -1199,10 +1559,162 @@ bool DeckGamepadBackend::tryOpenGamepad(int deviceId, const QString &devpath)
         scheduleNextRetry();
     });
 
+    // 先发布物理表快照：收到 gamepadConnected 的线程可立即使用映射编辑接口。
+    if (m_customMappingMgr) {
+        m_customMappingMgr->publishDeviceSnapshot(device);
+    }
+
     emit gamepadConnected(deviceId, device->name());
     return true;
 }
 
+void DeckGamepadBackend::scheduleOpen(int deviceId, const QString &devpath, bool recordTiming)
+{
+    if (m_devices.contains(deviceId) || m_pendingProbes.contains(devpath)) {
+        return;
+    }
+    if (applySessionGate(deviceId)) {
+        return;
+    }
+
+    auto outcome = std::make_shared<ProbeOutcome>();
+    outcome->deviceId = deviceId;
+    outcome->devpath = devpath;
+    outcome->recordTiming = recordTiming;
+    outcome->elapsed.start();
+    scheduleProbe(std::move(outcome));
+}
+
+void DeckGamepadBackend::scheduleProbe(std::shared_ptr<ProbeOutcome> outcome)
+{
+    outcome->ticket = ++m_nextProbeTicket;
+    m_pendingProbes.insert(outcome->devpath, outcome->ticket);
+    submitProbeTask(std::move(outcome));
+}
+
+void DeckGamepadBackend::submitProbeTask(std::shared_ptr<ProbeOutcome> outcome)
+{
+    const DeckGamepadRuntimeConfig config = m_runtimeConfig;
+    const bool resolveGuid = m_sdlDb != nullptr;
+    m_probePool.start([this, outcome, config, resolveGuid]() {
+        // 每个任务使用独立的 broker 副本：不与 backend 线程共享可变状态。
+        // logind TakeDevice 推迟到 backend 线程异步发起（见 continueProbeViaLogind）。
+        DeviceAccessBroker broker;
+        broker.setRuntimeConfig(config);
+        runOpenPipeline(*outcome, broker, config, resolveGuid, true);
+
+        QMetaObject::invokeMethod(
+            this,
+            [this, outcome]() {
+                handleProbeFinished(outcome);
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void DeckGamepadBackend::handleProbeFinished(const std::shared_ptr<ProbeOutcome> &outcome)
+{
+    // stop()/设备移除/重复提交后到达的结果：票据不匹配，丢弃（fd 随 outcome 析构归还）。
+    const auto it = m_pendingProbes.constFind(outcome->devpath);
+    if (it == m_pendingProbes.cend() || it.value() != outcome->ticket) {
+        return;
+    }
+
+    if (outcome->candidate && outcome->openResult.needsLogind) {
+        outcome->openResult.needsLogind = false;
+        continueProbeViaLogind(outcome);
+        return;
+    }
+    m_pendingProbes.erase(it);
+
+    if (outcome->candidate) {
+        int deviceId = outcome->deviceId;
+        if (deviceId == -1) {
+            deviceId = registerKnownDevice(std::move(outcome->pendingKnown));
+        }
+
+        const auto itKnown = m_knownDevices.constFind(deviceId);
+        if (deviceId != -1 && itKnown != m_knownDevices.cend() && itKnown->devpath == outcome->devpath
+            && !m_devices.contains(deviceId) && !applySessionGate(deviceId)) {
+            (void)publishOpenOutcome(deviceId, outcome->devpath, *outcome);
+        }
+
+        if (outcome->recordTiming) {
+            recordProbeTiming(outcome->elapsed.nsecsElapsed() / 1000);
+        }
+    }
+
+    maybeFinishStartupProbe();
+}
+
+void DeckGamepadBackend::continueProbeViaLogind(const std::shared_ptr<ProbeOutcome> &outcome)
+{
+    // TakeDevice 以异步 D-Bus 调用发出：多设备的请求同时在途，不阻塞 backend 线程。
+    m_accessBroker->completeOpenViaLogind(outcome->devpath, [this, outcome](DeckGamepadDeviceOpenResult result) {
+        outcome->openResult = std::move(result);
+        const auto it = m_pendingProbes.constFind(outcome->devpath);
+        if (outcome->openResult.ok() && it != m_pendingProbes.cend() && it.value() == outcome->ticket) {
+            submitProbeTask(outcome);
+            return;
+        }
+        handleProbeFinished(outcome);
+    });
+}
+
+void DeckGamepadBackend::recordProbeTiming(qint64 elapsedUs)
+{
+    m_probeHistogram.record(elapsedUs);
+    Q_EMIT probeHistogramChanged(m_probeHistogram);
+}
+
+void DeckGamepadBackend::maybeFinishStartupProbe()
+{
+    if (!m_startupProbePending || !m_pendingProbes.isEmpty()) {
+        return;
+    }
+
+    m_startupProbePending = false;
+    m_probeHistogram.startupUs = qMax<qint64>(1, m_startupTimer.nsecsElapsed() / 1000);
+    qInfo() << "Gamepad startup probe finished:" << m_probeHistogram.samples << "device(s) in"
+            << m_probeHistogram.startupUs << "us, max" << m_probeHistogram.maxUs << "us";
+    Q_EMIT probeHistogramChanged(m_probeHistogram);
+}
+
+void DeckGamepadBackend::setFrameSink(FrameSink sink)
+{
+    m_frameSink = std::move(sink);
+}
+
+void DeckGamepadBackend::setFrameTap(FrameSink tap)
+{
+    m_frameTap = std::move(tap);
+}
+
+void DeckGamepadBackend::handleDeviceFrame(int deviceId, const DeckGamepadFrameEvent &frame)
+{
+    if (m_frameTap) {
+        m_frameTap(deviceId, frame);
+    }
+
+    if (m_frameSink) {
+        m_frameSink(deviceId, frame);
+        return;
+    }
+
+    Q_EMIT frameEvent(deviceId, frame);
+
+    // 逐事件信号：与 device 同线程 direct 发出，供直接连接 backend 的调用方使用。
+    for (const DeckGamepadButtonEvent &event : frame.buttons) {
+        Q_EMIT buttonEvent(deviceId, event);
+    }
+    for (const DeckGamepadAxisEvent &event : frame.axes) {
+        Q_EMIT axisEvent(deviceId, event);
+    }
+    for (const DeckGamepadHatEvent &event : frame.hats) {
+        Q_EMIT hatEvent(deviceId, event);
+    }
+}
+
 void DeckGamepadBackend::closeGamepad(int deviceId)
 {
     auto it = m_devices.find(deviceId);
@@ -1210,6 +1722,9 @@ void DeckGamepadBackend::closeGamepad(int deviceId)
         it.value()->close();
         it.value()->deleteLater();
         m_devices.erase(it);
+        if (m_customMappingMgr) {
+            m_customMappingMgr->retractDeviceSnapshot(deviceId);
+        }
         emit gamepadDisconnected(deviceId);
     }
 }
@@ -1242,25 +1757,13 @@ void DeckGamepadBackend::handleUdevEvent()
 	    QString devpath(devnode);
 	    if (!devpath.contains("/js")) {
 	        if (strcmp(action, "add") == 0) {
-	            const char *isJoystick = udev_device_get_property_value(dev, "ID_INPUT_JOYSTICK");
-	            const char *isGamepad = udev_device_get_property_value(dev, "ID_INPUT_GAMEPAD");
-	            const bool hasGamepadHint = (isJoystick != nullptr) || (isGamepad != nullptr);
-	            const bool udevCandidate = (isJoystick && strcmp(isJoystick, "1") == 0)
-	                || (isGamepad && strcmp(isGamepad, "1") == 0);
-
-	            bool candidate = udevCandidate;
-	            int probeErrno = 0;
-	            if (!candidate) {
-	                candidate = isGamepadDevice(devpath, &probeErrno);
-	                if (!candidate && (probeErrno == EACCES || probeErrno == EPERM) && !hasGamepadHint) {
-	                    candidate = true;
-	                }
+	            handleUdevCandidate(dev, devpath);
+	        } else if (strcmp(action, "remove") == 0) {
+	            // 在途探测作废：结果到达时按票据丢弃。
+	            if (m_pendingProbes.remove(devpath) > 0) {
+	                maybeFinishStartupProbe();
 	            }
 
-	            if (candidate) {
-	                openGamepad(dev, devpath);
-	            }
-	        } else if (strcmp(action, "remove") == 0) {
 	            auto it = m_devicePaths.find(devpath);
 	            if (it != m_devicePaths.end()) {
 	                const int deviceId = it.value();
@@ -1336,7 +1839,11 @@ void DeckGamepadBackend::retryUnavailableDevices()
             continue;
         }
 
-        (void)tryOpenGamepad(it.key(), it.value().devpath);
+        if (asyncProbeEnabled()) {
+            scheduleOpen(it.key(), it.value().devpath, false);
+        } else {
+            (void)tryOpenGamepad(it.key(), it.value().devpath);
+        }
     }
 
     scheduleNextRetry();
@@ -1492,6 +1999,7 @@ void DeckGamepadBackend::setAxisDeadzone(int deviceId, uint32_t axis, float dead
     deadzone = qBound(0.0f, deadzone, 1.0f);
 
     dev->m_customDeadzones[axis] = deadzone;
+    dev->rebuildAxisTransforms();
     qDebug() << "Set axis" << axis << "deadzone to" << deadzone << "for device" << deviceId;
 }
 
@@ -1506,6 +2014,7 @@ void DeckGamepadBackend::setAxisSensitivity(int deviceId, uint32_t axis, float s
     sensitivity = qBound(0.1f, sensitivity, 5.0f);
 
     dev->m_axisSensitivity[axis] = sensitivity;
+    dev->rebuildAxisTransforms();
     qDebug() << "Set axis" << axis << "sensitivity to" << sensitivity << "for device" << deviceId;
 }
 
@@ -1519,6 +2028,7 @@ void DeckGamepadBackend::resetAxisSettings(int deviceId, uint32_t axis)
 
     dev->m_customDeadzones.remove(axis);
     dev->m_axisSensitivity.remove(axis);
+    dev->rebuildAxisTransforms();
     qDebug() << "Reset axis" << axis << "settings for device" << deviceId;
 }
 
@@ -1536,6 +2046,17 @@ bool DeckGamepadBackend::startVibration(int deviceId,
     return dev->startVibration(weakMagnitude, strongMagnitude, duration_ms);
 }
 
+bool DeckGamepadBackend::playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern)
+{
+    DeckGamepadDevice *dev = m_devices.value(deviceId, nullptr);
+    if (!dev) {
+        qWarning() << "Cannot play vibration pattern: device" << deviceId << "not found";
+        return false;
+    }
+
+    return dev->playVibrationPattern(pattern);
+}
+
 void DeckGamepadBackend::stopVibration(int deviceId)
 {
     DeckGamepadDevice *dev = m_devices.value(deviceId, nullptr);
@@ -1566,6 +2087,10 @@ void DeckGamepadBackend::loadCalibration()
         m_calibrationData = std::make_unique<CalibrationData>();
     }
     *m_calibrationData = data;
+
+    for (DeckGamepadDevice *device : std::as_const(m_devices)) {
+        device->rebuildAxisTransforms();
+    }
 }
 
 int DeckGamepadBackend::reloadSdlDb(const QString &path)
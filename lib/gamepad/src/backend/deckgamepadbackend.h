@@ -11,18 +11,24 @@
 #include <deckshell/deckgamepad/core/deckgamepad.h>
 #include <deckshell/deckgamepad/core/deckgamepaderror.h>
 #include <deckshell/deckgamepad/core/deckgamepaddeviceinfo.h>
+#include <deckshell/deckgamepad/core/deckgamepaddiagnostic.h>
+#include <deckshell/deckgamepad/core/deckgamepadrumble.h>
 #include <deckshell/deckgamepad/core/deckgamepadruntimeconfig.h>
 #include <deckshell/deckgamepad/mapping/deckgamepadmapping.h>
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QSocketNotifier>
 #include <QtCore/QHash>
+#include <QtCore/QThreadPool>
 #include <QtCore/QTimer>
 #include <QtCore/QString>
 
 #include <array>
+#include <bitset>
 #include <functional>
 #include <memory>
+#include <vector>
 
 extern "C" {
 struct udev;
@@ -38,6 +44,7 @@ class JsonCalibrationStore;
 struct CalibrationData;
 class DeviceAccessBroker;
 class SessionGate;
+struct DeckGamepadAxisTransform;
 
 class DECKGAMEPAD_EXPORT DeckGamepadDevice : public QObject
 {
@@ -76,9 +83,8 @@ public:
     void reloadMapping();
 
 Q_SIGNALS:
-    void buttonEvent(int deviceId, DeckGamepadButtonEvent event);
-    void axisEvent(int deviceId, DeckGamepadAxisEvent event);
-    void hatEvent(int deviceId, DeckGamepadHatEvent event);
+    // 每个 SYN_REPORT 发出一次（空帧不发出）；仅供同线程 direct 连接，避免逐帧拷贝。
+    void frameEvent(int deviceId, const DeckGamepadFrameEvent &frame);
     void disconnected(int deviceId);
 
 private Q_SLOTS:
@@ -97,17 +103,43 @@ private:
         int flat = 0; // Deadzone
     };
 
-    void setupDevice();
+    // 打开阶段的 ioctl 探测结果：不依赖 QObject/SDL DB，可在探测线程池中生成后交回 backend 线程应用。
+    struct ProbeSnapshot {
+        QString name;
+        QString guid;
+        std::array<int, MAX_KEY> keyMap{};
+        QHash<int, int> physicalButtonMap;
+        QHash<int, int> physicalAxisMap;
+        std::array<AxisInfo, MAX_ABS> absInfo{};
+        std::bitset<MAX_KEY> keyDown;
+        std::bitset<MAX_ABS> absSupported;
+        std::array<int, MAX_ABS> absValue{};
+        bool hasFF = false;
+    };
+
+    static ProbeSnapshot probeFd(int fd, const QString &devpath, bool resolveGuid);
+    bool openWithProbe(int fd, ProbeSnapshot probe, std::function<void()> releaseDevice);
+    void applyProbe(ProbeSnapshot probe);
     void setupSdlMapping();
     void processEvents();
-    double normalizeAxisValue(int code, int value);
+    void handleKeyEvent(int code, int value, uint32_t timeMsec);
+    void handleAbsEvent(int code, int value, uint32_t timeMsec);
+    void appendAxisToFrame(const DeckGamepadAxisEvent &event);
+    void appendHatToFrame(const DeckGamepadHatEvent &event);
+    void flushFrame(uint32_t timeMsec);
+    void resyncAfterDrop(uint32_t timeMsec);
+    // 映射/校准/调参变更后调用，重新生成 m_axisTransforms。
+    void rebuildAxisTransforms();
     GamepadButton mapButton(int evdev_code) const;
     GamepadAxis mapAxis(int evdev_code) const;
-    bool isAxisInverted(int evdev_code) const;
 
     // 高级功能（轴调参/振动）
+    // 振动经 m_rumble 调度：合并高频更新，设备侧只保留一个原地更新的 FF_RUMBLE 槽位。
     bool startVibration(float weakMagnitude, float strongMagnitude, int duration_ms);
+    bool playVibrationPattern(const DeckGamepadRumblePattern &pattern);
     void stopVibration();
+    bool writeRumble(float weakMagnitude, float strongMagnitude, int durationMs);
+    void releaseRumbleSlot();
 
     int m_id;
     QString m_devpath;
@@ -133,12 +165,32 @@ private:
     std::array<int, 4> m_hatXByHat{};
     std::array<int, 4> m_hatYByHat{};
 
-    // 半轴（+a/-a）数字化状态：evdev axis code -> {-1,0,1}
-    QHash<int, int> m_halfAxisStateByCode;
+    // 预编译轴变换：evdev abs code -> transform（大小为 MAX_ABS，hat code 不使用）
+    std::vector<DeckGamepadAxisTransform> m_axisTransforms;
 
-    // 力反馈
+    // 半轴（+a/-a）数字化状态：evdev axis code -> {-1,0,1}
+    std::array<int, MAX_ABS> m_halfAxisStateByCode{};
+
+    // 帧累积：SYN_REPORT 前的变化先进入 m_frame，再整体发出
+    DeckGamepadFrameEvent m_frame;
+    // 收到 SYN_DROPPED 后丢弃事件直到下一个 SYN_REPORT，再用 ioctl 快照重同步
+    bool m_syncDropped = false;
+    // 最近一次已上报的原始状态（SYN_DROPPED 重同步时求差）
+    std::bitset<MAX_KEY> m_keyDown;
+    std::bitset<MAX_ABS> m_absSupported;
+    std::array<int, MAX_ABS> m_absValue{};
+
+    // 力反馈：m_ffEffectId 为已上传的槽位（-1 表示未上传），m_ffUploaded 为其当前参数
     bool m_hasFF;
     int m_ffEffectId;
+    bool m_ffPlaying = false;
+    struct FfRumbleParams {
+        quint16 weak = 0;
+        quint16 strong = 0;
+        quint16 length = 0;
+    };
+    FfRumbleParams m_ffUploaded;
+    DeckGamepadRumbleScheduler *m_rumble = nullptr;
 
     std::function<void()> m_releaseDevice;
 
@@ -189,6 +241,7 @@ public:
                         float weakMagnitude,
                         float strongMagnitude,
                         int duration_ms = 1000);
+    bool playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern);
     void stopVibration(int deviceId);
 
     // SDL GameController DB
@@ -202,6 +255,21 @@ public:
         return m_customMappingMgr;
     }
 
+    // 帧旁路：设置后设备帧在 backend 线程内直接交给 sink，不再发出 frameEvent/*Event 信号。
+    // 用于 provider 自行实现跨线程传输（例如 SPSC ring）；传空函数恢复信号投递。
+    using FrameSink = std::function<void(int deviceId, const DeckGamepadFrameEvent &frame)>;
+    void setFrameSink(FrameSink sink);
+    // 帧旁听：在 sink/信号投递之前于 backend 线程内同步调用，不改变投递路径（例如 uinput 键盘输出）。
+    void setFrameTap(FrameSink tap);
+
+    // deviceId 取值范围为 [0, maxGamepads())。
+    static constexpr int maxGamepads() { return MAX_GAMEPADS; }
+
+    // 设备探测耗时（发现设备节点 → 发布结果），start() 时重置。
+    DeckGamepadProbeHistogram probeHistogram() const { return m_probeHistogram; }
+    // 已提交到探测线程池、尚未发布结果的设备数。
+    int pendingProbeCount() const { return static_cast<int>(m_pendingProbes.size()); }
+
 Q_SIGNALS:
     void lastErrorChanged(DeckGamepadError error);
     void deviceInfoChanged(int deviceId, DeckGamepadDeviceInfo info);
@@ -210,12 +278,16 @@ Q_SIGNALS:
 
     void gamepadConnected(int deviceId, const QString &name);
     void gamepadDisconnected(int deviceId);
+    // 帧级批量信号（推荐跨线程消费）；逐事件信号保留给直接使用 backend 的调用方。
+    void frameEvent(int deviceId, DeckGamepadFrameEvent frame);
     void buttonEvent(int deviceId, DeckGamepadButtonEvent event);
     void axisEvent(int deviceId, DeckGamepadAxisEvent event);
     void hatEvent(int deviceId, DeckGamepadHatEvent event);
     void sdlDatabaseLoaded(int count);
+    void probeHistogramChanged(DeckGamepadProbeHistogram histogram);
 
 private Q_SLOTS:
+    void handleDeviceFrame(int deviceId, const DeckGamepadFrameEvent &frame);
     void handleUdevEvent();
     void retryUnavailableDevices();
     void handleSessionGateActiveChanged(bool active);
@@ -230,12 +302,34 @@ private:
         qint64 nextRetryWallclockMs = 0;
     };
 
+    // 打开流水线的单设备状态：探测线程池中执行 能力检测 → DeviceAccessBroker → EVIOCGRAB → ioctl 探测，
+    // 结果投递回 backend 线程发布。未被消费的 fd 在析构时归还。
+    struct ProbeOutcome;
+
     void probeGamepads();
     bool isGamepadUdevDevice(struct udev_device *dev) const;
     QString udevDeviceName(struct udev_device *dev) const;
-    bool isGamepadDevice(const QString &devpath, int *openErrno = nullptr);
+    static bool isGamepadDevice(const QString &devpath, int *openErrno = nullptr);
+    void handleUdevCandidate(struct udev_device *dev, const QString &devpath);
+    KnownDevice knownDeviceFromUdev(struct udev_device *dev, const QString &devpath) const;
+    int registerKnownDevice(KnownDevice known);
     void openGamepad(struct udev_device *dev, const QString &devpath);
     bool tryOpenGamepad(int deviceId, const QString &devpath);
+    bool applySessionGate(int deviceId);
+    static void runOpenPipeline(ProbeOutcome &outcome,
+                                DeviceAccessBroker &broker,
+                                const DeckGamepadRuntimeConfig &config,
+                                bool resolveGuid,
+                                bool deferLogind = false);
+    bool publishOpenOutcome(int deviceId, const QString &devpath, ProbeOutcome &outcome);
+    bool asyncProbeEnabled() const { return m_runtimeConfig.probeConcurrency > 0; }
+    void scheduleOpen(int deviceId, const QString &devpath, bool recordTiming);
+    void scheduleProbe(std::shared_ptr<ProbeOutcome> outcome);
+    void submitProbeTask(std::shared_ptr<ProbeOutcome> outcome);
+    void continueProbeViaLogind(const std::shared_ptr<ProbeOutcome> &outcome);
+    void handleProbeFinished(const std::shared_ptr<ProbeOutcome> &outcome);
+    void recordProbeTiming(qint64 elapsedUs);
+    void maybeFinishStartupProbe();
     void closeGamepad(int deviceId);
     int getUnusedDeviceId();
     QString findDefaultSdlDatabase();
@@ -275,6 +369,17 @@ private:
     std::unique_ptr<DeviceAccessBroker> m_accessBroker;
     std::unique_ptr<SessionGate> m_sessionGate;
 
+    FrameSink m_frameSink;
+    FrameSink m_frameTap;
+
+    // 异步设备探测：devpath → 当前有效的探测票据（stop()/remove 后到达的旧结果直接丢弃）
+    QThreadPool m_probePool;
+    QHash<QString, quint64> m_pendingProbes;
+    quint64 m_nextProbeTicket = 0;
+    QElapsedTimer m_startupTimer;
+    bool m_startupProbePending = false;
+    DeckGamepadProbeHistogram m_probeHistogram;
+
     static constexpr int MAX_GAMEPADS = 16;
 };
 
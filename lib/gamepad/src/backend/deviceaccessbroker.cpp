@@ -15,19 +15,35 @@ extern "C" {
 }
 
 #if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+#include "logindbus.h"
+
 #include <QtDBus/QDBusConnection>
-#include <QtDBus/QDBusInterface>
+#include <QtDBus/QDBusMessage>
 #include <QtDBus/QDBusObjectPath>
+#include <QtDBus/QDBusPendingCallWatcher>
 #include <QtDBus/QDBusReply>
 #include <QtDBus/QDBusUnixFileDescriptor>
 #endif
 
 DECKGAMEPAD_BEGIN_NAMESPACE
 
+#if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
 DeviceAccessBroker::DeviceAccessBroker(QObject *parent)
+    : DeviceAccessBroker(LogindBus::connection(), parent)
+{
+}
+
+DeviceAccessBroker::DeviceAccessBroker(const QDBusConnection &logindBus, QObject *parent)
     : QObject(parent)
+    , m_logindBus(logindBus)
 {
 }
+#else
+DeviceAccessBroker::DeviceAccessBroker(QObject *parent)
+    : QObject(parent)
+{
+}
+#endif
 
 void DeviceAccessBroker::setRuntimeConfig(const DeckGamepadRuntimeConfig &config)
 {
@@ -39,7 +55,16 @@ DeckGamepadRuntimeConfig DeviceAccessBroker::runtimeConfig() const
     return m_config;
 }
 
-DeckGamepadDeviceOpenResult DeviceAccessBroker::openDevice(const QString &devpath) const
+DeckGamepadDeviceOpenResult DeviceAccessBroker::openDevice(const QString &devpath)
+{
+    DeckGamepadDeviceOpenResult r = openDeviceDeferringLogind(devpath);
+    if (!r.needsLogind) {
+        return r;
+    }
+    return finishAfterLogind(devpath, openViaLogind(devpath));
+}
+
+DeckGamepadDeviceOpenResult DeviceAccessBroker::openDeviceDeferringLogind(const QString &devpath) const
 {
     switch (m_config.deviceAccessMode) {
     case DeckGamepadDeviceAccessMode::DirectOpen:
@@ -59,7 +84,12 @@ DeckGamepadDeviceOpenResult DeviceAccessBroker::openDevice(const QString &devpat
         return direct;
     }
     case DeckGamepadDeviceAccessMode::LogindTakeDevice:
-        return openViaLogind(devpath);
+    {
+        DeckGamepadDeviceOpenResult r;
+        r.method = QStringLiteral("logind");
+        r.needsLogind = true;
+        return r;
+    }
     case DeckGamepadDeviceAccessMode::Auto:
     default: {
         DeckGamepadDeviceOpenResult direct = openDirect(devpath);
@@ -68,29 +98,43 @@ DeckGamepadDeviceOpenResult DeviceAccessBroker::openDevice(const QString &devpat
         }
 
         if (direct.error.sysErrno == EACCES || direct.error.sysErrno == EPERM) {
-            DeckGamepadDeviceOpenResult logind = openViaLogind(devpath);
-            if (logind.ok()) {
-                return logind;
-            }
-
-            // logind 不可用：允许退化为只读打开，以便至少具备输入读取能力（rumble 可能不可用）。
-            DeckGamepadDeviceOpenResult ro = openDirectReadOnly(devpath);
-            if (ro.ok()) {
-                return ro;
-            }
-
-            // direct 被拒绝且 logind 不可用：优先返回 logind 分支以便上层给出可操作引导。
-            if (!logind.error.isOk()) {
-                logind.error.message = QStringLiteral("Permission denied and logind TakeDevice failed");
-            }
-            return logind;
+            direct.needsLogind = true;
         }
-
         return direct;
     }
     }
 }
 
+DeckGamepadDeviceOpenResult DeviceAccessBroker::finishAfterLogind(const QString &devpath,
+                                                                  DeckGamepadDeviceOpenResult logind) const
+{
+    if (logind.ok() || m_config.deviceAccessMode != DeckGamepadDeviceAccessMode::Auto) {
+        return logind;
+    }
+
+    // logind 不可用：允许退化为只读打开，以便至少具备输入读取能力（rumble 可能不可用）。
+    DeckGamepadDeviceOpenResult ro = openDirectReadOnly(devpath);
+    if (ro.ok()) {
+        return ro;
+    }
+
+    // direct 被拒绝且 logind 不可用：优先返回 logind 分支以便上层给出可操作引导。
+    if (!logind.error.isOk()) {
+        logind.error.message = QStringLiteral("Permission denied and logind TakeDevice failed");
+    }
+    return logind;
+}
+
+QString DeviceAccessBroker::sessionPath() const
+{
+    return m_sessionPath;
+}
+
+void DeviceAccessBroker::setSessionPath(const QString &sessionPath)
+{
+    m_sessionPath = sessionPath;
+}
+
 DeckGamepadDeviceOpenResult DeviceAccessBroker::openDirect(const QString &devpath) const
 {
     DeckGamepadDeviceOpenResult r;
@@ -151,87 +195,68 @@ DeckGamepadDeviceOpenResult DeviceAccessBroker::openDirectReadOnly(const QString
     return r;
 }
 
-DeckGamepadDeviceOpenResult DeviceAccessBroker::openViaLogind(const QString &devpath) const
-{
-    DeckGamepadDeviceOpenResult r;
-    r.method = QStringLiteral("logind");
-
 #if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+namespace {
+
+bool statDeviceNumbers(const QString &devpath,
+                       uint32_t *majorNum,
+                       uint32_t *minorNum,
+                       DeckGamepadDeviceOpenResult *r,
+                       bool recoverable)
+{
     struct stat st { };
     if (::stat(devpath.toUtf8().constData(), &st) != 0) {
-        r.error.code = DeckGamepadErrorCode::Io;
-        r.error.sysErrno = errno;
-        r.error.message = QStringLiteral("stat() failed for device node");
-        r.error.context = QStringLiteral("logind.stat(%1)").arg(devpath);
-        r.error.recoverable = m_config.enableAutoRetryOpen;
-        return r;
-    }
-
-    const uint32_t majorNum = static_cast<uint32_t>(major(st.st_rdev));
-    const uint32_t minorNum = static_cast<uint32_t>(minor(st.st_rdev));
-
-    QDBusConnection bus = QDBusConnection::systemBus();
-    if (!bus.isConnected()) {
-        r.error.code = DeckGamepadErrorCode::NotSupported;
-        r.error.message = QStringLiteral("System D-Bus not available");
-        r.error.context = QStringLiteral("logind.systemBus");
-        r.error.recoverable = true;
-        return r;
+        r->error.code = DeckGamepadErrorCode::Io;
+        r->error.sysErrno = errno;
+        r->error.message = QStringLiteral("stat() failed for device node");
+        r->error.context = QStringLiteral("logind.stat(%1)").arg(devpath);
+        r->error.recoverable = recoverable;
+        return false;
     }
 
-    QDBusInterface manager(QStringLiteral("org.freedesktop.login1"),
-                           QStringLiteral("/org/freedesktop/login1"),
-                           QStringLiteral("org.freedesktop.login1.Manager"),
-                           bus);
-    if (!manager.isValid()) {
-        r.error.code = DeckGamepadErrorCode::NotSupported;
-        r.error.message = QStringLiteral("logind manager not available");
-        r.error.context = QStringLiteral("logind.Manager");
-        r.error.recoverable = true;
-        return r;
-    }
+    *majorNum = static_cast<uint32_t>(major(st.st_rdev));
+    *minorNum = static_cast<uint32_t>(minor(st.st_rdev));
+    return true;
+}
 
-    const uint32_t pid = static_cast<uint32_t>(QCoreApplication::applicationPid());
-    QDBusReply<QDBusObjectPath> sessionReply = manager.call(QStringLiteral("GetSessionByPID"), pid);
-    if (!sessionReply.isValid()) {
-        r.error.code = DeckGamepadErrorCode::NotSupported;
-        r.error.message = QStringLiteral("logind session not available");
-        r.error.context = QStringLiteral("logind.GetSessionByPID");
-        r.error.recoverable = true;
-        return r;
-    }
+QDBusMessage takeDeviceCall(const QString &sessionPath, uint32_t majorNum, uint32_t minorNum)
+{
+    QDBusMessage call = QDBusMessage::createMethodCall(QLatin1StringView(LogindBus::Service),
+                                                       sessionPath,
+                                                       QLatin1StringView(LogindBus::SessionInterface),
+                                                       QStringLiteral("TakeDevice"));
+    call << majorNum << minorNum;
+    return call;
+}
 
-    const QString sessionPath = sessionReply.value().path();
-    if (sessionPath.isEmpty()) {
-        r.error.code = DeckGamepadErrorCode::NotSupported;
-        r.error.message = QStringLiteral("logind session path is empty");
-        r.error.context = QStringLiteral("logind.sessionPath");
-        r.error.recoverable = true;
-        return r;
-    }
+// session 已失效（注销/切换）：缓存的路径不能再用。
+bool isSessionGone(const QDBusMessage &reply)
+{
+    const QString name = reply.errorName();
+    return name == QLatin1StringView(LogindBus::NoSuchSessionError)
+        || name == QStringLiteral("org.freedesktop.DBus.Error.UnknownObject");
+}
 
-    QDBusInterface session(QStringLiteral("org.freedesktop.login1"),
-                           sessionPath,
-                           QStringLiteral("org.freedesktop.login1.Session"),
-                           bus);
-    if (!session.isValid()) {
-        r.error.code = DeckGamepadErrorCode::NotSupported;
-        r.error.message = QStringLiteral("logind session interface not available");
-        r.error.context = QStringLiteral("logind.Session");
-        r.error.recoverable = true;
-        return r;
-    }
+// 解析 TakeDevice 回复（h fd, b inactive）并登记 ReleaseDevice。
+DeckGamepadDeviceOpenResult takeDeviceResult(const QDBusMessage &reply,
+                                             const QDBusConnection &bus,
+                                             const QString &sessionPath,
+                                             uint32_t majorNum,
+                                             uint32_t minorNum)
+{
+    DeckGamepadDeviceOpenResult r;
+    r.method = QStringLiteral("logind");
 
-    QDBusReply<QDBusUnixFileDescriptor> fdReply = session.call(QStringLiteral("TakeDevice"), majorNum, minorNum);
-    if (!fdReply.isValid()) {
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
         r.error.code = DeckGamepadErrorCode::PermissionDenied;
         r.error.message = QStringLiteral("logind TakeDevice failed");
-        r.error.context = QStringLiteral("logind.TakeDevice");
+        r.error.context = reply.errorName().isEmpty() ? QStringLiteral("logind.TakeDevice")
+                                                      : QStringLiteral("logind.TakeDevice(%1)").arg(reply.errorName());
         r.error.recoverable = true;
         return r;
     }
 
-    QDBusUnixFileDescriptor fd = fdReply.value();
+    QDBusUnixFileDescriptor fd = qvariant_cast<QDBusUnixFileDescriptor>(reply.arguments().constFirst());
     const int rawFd = fd.takeFileDescriptor();
     if (rawFd < 0) {
         r.error.code = DeckGamepadErrorCode::Io;
@@ -249,23 +274,141 @@ DeckGamepadDeviceOpenResult DeviceAccessBroker::openViaLogind(const QString &dev
 
     r.fd = rawFd;
     r.releaseDevice = [bus, sessionPath, majorNum, minorNum]() mutable {
-        QDBusInterface session(QStringLiteral("org.freedesktop.login1"),
-                               sessionPath,
-                               QStringLiteral("org.freedesktop.login1.Session"),
-                               bus);
-        if (session.isValid()) {
-            (void)session.call(QStringLiteral("ReleaseDevice"), majorNum, minorNum);
-        }
+        QDBusMessage call = QDBusMessage::createMethodCall(QLatin1StringView(LogindBus::Service),
+                                                           sessionPath,
+                                                           QLatin1StringView(LogindBus::SessionInterface),
+                                                           QStringLiteral("ReleaseDevice"));
+        call << majorNum << minorNum;
+        // 不等待回复：释放可能发生在任意线程（设备析构），send() 线程安全。
+        (void)bus.send(call);
     };
     return r;
+}
+
+} // namespace
+#endif
+
+QString DeviceAccessBroker::resolveSessionPath(DeckGamepadError *error)
+{
+    if (!m_sessionPath.isEmpty()) {
+        return m_sessionPath;
+    }
+
+#if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+    QDBusConnection bus = m_logindBus;
+    if (!bus.isConnected()) {
+        error->code = DeckGamepadErrorCode::NotSupported;
+        error->message = QStringLiteral("System D-Bus not available");
+        error->context = QStringLiteral("logind.systemBus");
+        error->recoverable = true;
+        return {};
+    }
+
+    // 直接构造方法调用，避免 QDBusInterface 的同步 introspection 往返。
+    QDBusMessage call = QDBusMessage::createMethodCall(QLatin1StringView(LogindBus::Service),
+                                                       QLatin1StringView(LogindBus::ManagerPath),
+                                                       QLatin1StringView(LogindBus::ManagerInterface),
+                                                       QStringLiteral("GetSessionByPID"));
+    call << static_cast<uint32_t>(QCoreApplication::applicationPid());
+    QDBusReply<QDBusObjectPath> sessionReply = bus.call(call);
+    if (!sessionReply.isValid()) {
+        error->code = DeckGamepadErrorCode::NotSupported;
+        error->message = QStringLiteral("logind session not available");
+        error->context = QStringLiteral("logind.GetSessionByPID");
+        error->recoverable = true;
+        return {};
+    }
+
+    const QString sessionPath = sessionReply.value().path();
+    if (sessionPath.isEmpty()) {
+        error->code = DeckGamepadErrorCode::NotSupported;
+        error->message = QStringLiteral("logind session path is empty");
+        error->context = QStringLiteral("logind.sessionPath");
+        error->recoverable = true;
+        return {};
+    }
+
+    m_sessionPath = sessionPath;
+    return m_sessionPath;
+#else
+    error->code = DeckGamepadErrorCode::NotSupported;
+    error->message = QStringLiteral("logind support is not built (Qt6::DBus missing)");
+    error->context = QStringLiteral("logind");
+    error->recoverable = true;
+    return {};
+#endif
+}
+
+DeckGamepadDeviceOpenResult DeviceAccessBroker::openViaLogind(const QString &devpath)
+{
+    DeckGamepadDeviceOpenResult r;
+    r.method = QStringLiteral("logind");
+
+#if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+    uint32_t majorNum = 0;
+    uint32_t minorNum = 0;
+    if (!statDeviceNumbers(devpath, &majorNum, &minorNum, &r, m_config.enableAutoRetryOpen)) {
+        return r;
+    }
+
+    const QString sessionPath = resolveSessionPath(&r.error);
+    if (sessionPath.isEmpty()) {
+        return r;
+    }
+
+    QDBusConnection bus = m_logindBus;
+    const QDBusMessage reply = bus.call(takeDeviceCall(sessionPath, majorNum, minorNum));
+    if (isSessionGone(reply) && m_sessionPath == sessionPath) {
+        m_sessionPath.clear();
+    }
+    return takeDeviceResult(reply, bus, sessionPath, majorNum, minorNum);
 #else
-    r.error.code = DeckGamepadErrorCode::NotSupported;
-    r.error.message = QStringLiteral("logind support is not built (Qt6::DBus missing)");
-    r.error.context = QStringLiteral("logind");
-    r.error.recoverable = true;
+    const QString sessionPath = resolveSessionPath(&r.error);
+    Q_UNUSED(sessionPath);
     Q_UNUSED(devpath);
     return r;
 #endif
 }
 
+void DeviceAccessBroker::completeOpenViaLogind(const QString &devpath, OpenCallback done)
+{
+#if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+    DeckGamepadDeviceOpenResult r;
+    r.method = QStringLiteral("logind");
+
+    uint32_t majorNum = 0;
+    uint32_t minorNum = 0;
+    if (!statDeviceNumbers(devpath, &majorNum, &minorNum, &r, m_config.enableAutoRetryOpen)) {
+        done(finishAfterLogind(devpath, std::move(r)));
+        return;
+    }
+
+    // session 路径通常已由 SessionGate 注入或此前解析过；仅首次需要一次同步 GetSessionByPID。
+    const QString sessionPath = resolveSessionPath(&r.error);
+    if (sessionPath.isEmpty()) {
+        done(finishAfterLogind(devpath, std::move(r)));
+        return;
+    }
+
+    QDBusConnection bus = m_logindBus;
+    auto *watcher = new QDBusPendingCallWatcher(bus.asyncCall(takeDeviceCall(sessionPath, majorNum, minorNum)), this);
+    ++m_pendingTakeDevice;
+    connect(watcher,
+            &QDBusPendingCallWatcher::finished,
+            this,
+            [this, bus, devpath, sessionPath, majorNum, minorNum, done = std::move(done)](QDBusPendingCallWatcher *w) {
+                w->deleteLater();
+                --m_pendingTakeDevice;
+
+                const QDBusMessage reply = w->reply();
+                if (isSessionGone(reply) && m_sessionPath == sessionPath) {
+                    m_sessionPath.clear();
+                }
+                done(finishAfterLogind(devpath, takeDeviceResult(reply, bus, sessionPath, majorNum, minorNum)));
+            });
+#else
+    done(finishAfterLogind(devpath, openViaLogind(devpath)));
+#endif
+}
+
 DECKGAMEPAD_END_NAMESPACE
@@ -12,6 +12,10 @@
 #include <QtCore/QObject>
 #include <QtCore/QString>
 
+#if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+#include <QtDBus/QDBusConnection>
+#endif
+
 #include <functional>
 
 DECKGAMEPAD_BEGIN_NAMESPACE
@@ -21,6 +25,7 @@ struct DeckGamepadDeviceOpenResult {
     QString method; // "direct" | "logind"
     DeckGamepadError error;
     std::function<void()> releaseDevice; // logind ReleaseDevice（如有）
+    bool needsLogind = false; // openDeviceDeferringLogind：direct 被拒绝，需由 completeOpenViaLogind 完成
 
     bool ok() const { return fd >= 0; }
 };
@@ -31,18 +36,42 @@ class DeviceAccessBroker final : public QObject
 
 public:
     explicit DeviceAccessBroker(QObject *parent = nullptr);
+#if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+    // logind 调用改走指定连接（例如测试中挂 fake logind 的 session bus）；默认使用 system bus。
+    explicit DeviceAccessBroker(const QDBusConnection &logindBus, QObject *parent = nullptr);
+#endif
 
     void setRuntimeConfig(const DeckGamepadRuntimeConfig &config);
     DeckGamepadRuntimeConfig runtimeConfig() const;
 
-    DeckGamepadDeviceOpenResult openDevice(const QString &devpath) const;
+    using OpenCallback = std::function<void(DeckGamepadDeviceOpenResult result)>;
+
+    // 同步打开：direct → logind TakeDevice → 只读（按 deviceAccessMode）。
+    DeckGamepadDeviceOpenResult openDevice(const QString &devpath);
+
+    // 只执行不需要 D-Bus 的步骤，可在探测线程池中调用；需要 logind 时返回 needsLogind=true。
+    DeckGamepadDeviceOpenResult openDeviceDeferringLogind(const QString &devpath) const;
+    // 异步 TakeDevice：多个请求可同时在途，done 在 broker 所在线程回调（Auto 模式失败时回退只读）。
+    void completeOpenViaLogind(const QString &devpath, OpenCallback done);
+
+    // logind session 路径只解析一次；SessionGate 已知时直接注入，空字符串表示失效（下次按需重新解析）。
+    QString sessionPath() const;
+    void setSessionPath(const QString &sessionPath);
+    int pendingTakeDeviceCount() const { return m_pendingTakeDevice; }
 
 private:
     DeckGamepadDeviceOpenResult openDirect(const QString &devpath) const;
     DeckGamepadDeviceOpenResult openDirectReadOnly(const QString &devpath) const;
-    DeckGamepadDeviceOpenResult openViaLogind(const QString &devpath) const;
+    DeckGamepadDeviceOpenResult openViaLogind(const QString &devpath);
+    DeckGamepadDeviceOpenResult finishAfterLogind(const QString &devpath, DeckGamepadDeviceOpenResult logind) const;
+    QString resolveSessionPath(DeckGamepadError *error);
 
     DeckGamepadRuntimeConfig m_config;
+#if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+    QDBusConnection m_logindBus;
+#endif
+    QString m_sessionPath;
+    int m_pendingTakeDevice = 0;
 };
 
 DECKGAMEPAD_END_NAMESPACE
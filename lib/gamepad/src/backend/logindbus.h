@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// logind D-Bus 常量与连接选择（SessionGate / DeviceAccessBroker 共用）。
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+
+#if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+#include <QtDBus/QDBusConnection>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+namespace LogindBus {
+inline constexpr char Service[] = "org.freedesktop.login1";
+inline constexpr char ManagerPath[] = "/org/freedesktop/login1";
+inline constexpr char ManagerInterface[] = "org.freedesktop.login1.Manager";
+inline constexpr char SessionInterface[] = "org.freedesktop.login1.Session";
+inline constexpr char PropertiesInterface[] = "org.freedesktop.DBus.Properties";
+inline constexpr char NoSuchSessionError[] = "org.freedesktop.login1.NoSuchSession";
+
+// 默认连接；需要其他连接（如测试中的 fake logind）时由调用方注入，见 DeviceAccessBroker。
+inline QDBusConnection connection()
+{
+    return QDBusConnection::systemBus();
+}
+} // namespace LogindBus
+
+DECKGAMEPAD_END_NAMESPACE
+#endif
@@ -7,6 +7,8 @@
 #include <QtCore/QCoreApplication>
 
 #if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+#include "logindbus.h"
+
 #include <QtDBus/QDBusInterface>
 #include <QtDBus/QDBusObjectPath>
 #include <QtDBus/QDBusReply>
@@ -17,7 +19,7 @@ DECKGAMEPAD_BEGIN_NAMESPACE
 SessionGate::SessionGate(QObject *parent)
     : QObject(parent)
 #if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
-    , m_systemBus(QDBusConnection::systemBus())
+    , m_systemBus(LogindBus::connection())
 #endif
 {
 #if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
@@ -54,6 +56,15 @@ bool SessionGate::isActive() const
     return !m_enabled ? true : m_active;
 }
 
+QString SessionGate::sessionPath() const
+{
+#if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
+    return m_sessionPath;
+#else
+    return {};
+#endif
+}
+
 #if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
 void SessionGate::initLogind()
 {
@@ -90,6 +101,7 @@ void SessionGate::initLogind()
 
     m_supported = true;
     Q_EMIT supportedChanged(m_supported);
+    Q_EMIT sessionPathChanged(m_sessionPath);
 
     // query current Active
     QDBusInterface props(QStringLiteral("org.freedesktop.login1"),
@@ -112,6 +124,14 @@ void SessionGate::initLogind()
                               QStringLiteral("PropertiesChanged"),
                               this,
                               SLOT(handlePropertiesChanged(QString,QVariantMap,QStringList)));
+
+    // session 被移除后路径失效：通知 broker 丢弃缓存，下次 TakeDevice 前重新解析。
+    (void)m_systemBus.connect(QStringLiteral("org.freedesktop.login1"),
+                              QStringLiteral("/org/freedesktop/login1"),
+                              QStringLiteral("org.freedesktop.login1.Manager"),
+                              QStringLiteral("SessionRemoved"),
+                              this,
+                              SLOT(handleSessionRemoved(QString,QDBusObjectPath)));
 }
 
 void SessionGate::updateActive(bool active)
@@ -139,6 +159,16 @@ void SessionGate::handlePropertiesChanged(const QString &interfaceName,
         updateActive(it.value().toBool());
     }
 }
+
+void SessionGate::handleSessionRemoved(const QString &sessionId, const QDBusObjectPath &sessionPath)
+{
+    Q_UNUSED(sessionId);
+    if (m_sessionPath.isEmpty() || sessionPath.path() != m_sessionPath) {
+        return;
+    }
+    m_sessionPath.clear();
+    Q_EMIT sessionPathChanged(m_sessionPath);
+}
 #endif
 
 DECKGAMEPAD_END_NAMESPACE
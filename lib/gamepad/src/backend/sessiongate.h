@@ -13,6 +13,7 @@
 #if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
 #include <QtCore/QVariantMap>
 #include <QtDBus/QDBusConnection>
+#include <QtDBus/QDBusObjectPath>
 #endif
 
 DECKGAMEPAD_BEGIN_NAMESPACE
@@ -30,9 +31,13 @@ public:
     bool supported() const;
     bool isActive() const;
 
+    // 当前 logind session 对象路径（未解析/不支持/已移除时为空），供 DeviceAccessBroker 复用。
+    QString sessionPath() const;
+
 Q_SIGNALS:
     void activeChanged(bool active);
     void supportedChanged(bool supported);
+    void sessionPathChanged(const QString &sessionPath);
 
 private:
 #if defined(DECKGAMEPAD_ENABLE_LOGIND) && DECKGAMEPAD_ENABLE_LOGIND
@@ -41,6 +46,7 @@ private:
 
 private Q_SLOTS:
     void handlePropertiesChanged(const QString &interfaceName, const QVariantMap &changed, const QStringList &invalidated);
+    void handleSessionRemoved(const QString &sessionId, const QDBusObjectPath &sessionPath);
 private:
 #endif
 
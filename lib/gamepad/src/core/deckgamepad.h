@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <QtCore/QList>
 #include <QtCore/QMetaType>
 #include <QtCore/qglobal.h>
 
@@ -47,6 +48,29 @@ struct DeckGamepadHatEvent {
     int32_t value;
 };
 
+// 设备帧事件：同一 SYN_REPORT 内累积的全部变化，作为一个原子批次向上投递。
+// - buttons 按到达顺序保留（同帧内的 press/release 都会送达）
+// - axes/hats 同帧内仅保留每个 axis/hat 的最终值
+struct DeckGamepadFrameEvent {
+    uint32_t time_msec = 0;
+    qint64 monotonicNs = 0; // 成帧时刻（QDeadlineTimer 单调时钟，ns）；0 表示未知，用于端到端投递延迟统计
+    QList<DeckGamepadButtonEvent> buttons;
+    QList<DeckGamepadAxisEvent> axes;
+    QList<DeckGamepadHatEvent> hats;
+
+    bool isEmpty() const { return buttons.isEmpty() && axes.isEmpty() && hats.isEmpty(); }
+    int eventCount() const { return int(buttons.size() + axes.size() + hats.size()); }
+
+    void clear()
+    {
+        time_msec = 0;
+        monotonicNs = 0;
+        buttons.clear();
+        axes.clear();
+        hats.clear();
+    }
+};
+
 // 按键枚举（对齐 SDL2/Xbox 常用布局）。
 enum GamepadButton {
     GAMEPAD_BUTTON_INVALID = -1,
@@ -106,3 +130,4 @@ using namespace deckgamepad;
 Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadButtonEvent)
 Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadAxisEvent)
 Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadHatEvent)
+Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadFrameEvent)
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/core/deckgamepadaction.h>
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QReadWriteLock>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+namespace {
+// 顺序必须与 DeckGamepadBuiltinAction 一致。
+constexpr const char *kBuiltinActionIds[] = {
+    DeckGamepadActionId::NavUp,
+    DeckGamepadActionId::NavDown,
+    DeckGamepadActionId::NavLeft,
+    DeckGamepadActionId::NavRight,
+    DeckGamepadActionId::NavAccept,
+    DeckGamepadActionId::NavBack,
+    DeckGamepadActionId::NavMenu,
+    DeckGamepadActionId::NavTabNext,
+    DeckGamepadActionId::NavTabPrev,
+    DeckGamepadActionId::NavPageNext,
+    DeckGamepadActionId::NavPagePrev,
+};
+static_assert(sizeof(kBuiltinActionIds) / sizeof(kBuiltinActionIds[0]) == DECKGAMEPAD_ACTION_BUILTIN_COUNT,
+              "kBuiltinActionIds must match DeckGamepadBuiltinAction");
+
+struct ActionRegistryData {
+    ActionRegistryData()
+    {
+        names.reserve(DECKGAMEPAD_ACTION_BUILTIN_COUNT);
+        for (int i = 0; i < DECKGAMEPAD_ACTION_BUILTIN_COUNT; ++i) {
+            const QString name = QString::fromLatin1(kBuiltinActionIds[i]);
+            names.append(name);
+            idByName.insert(name, i);
+        }
+    }
+
+    QReadWriteLock lock;
+    QList<QString> names;
+    QHash<QString, int> idByName;
+};
+
+ActionRegistryData &registryData()
+{
+    static ActionRegistryData data;
+    return data;
+}
+} // namespace
+
+int DeckGamepadActionRegistry::intern(const QString &actionId)
+{
+    if (actionId.isEmpty()) {
+        return DECKGAMEPAD_ACTION_INVALID;
+    }
+
+    ActionRegistryData &data = registryData();
+    {
+        QReadLocker locker(&data.lock);
+        const auto it = data.idByName.constFind(actionId);
+        if (it != data.idByName.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&data.lock);
+    const auto it = data.idByName.constFind(actionId);
+    if (it != data.idByName.constEnd()) {
+        return it.value();
+    }
+    const int id = static_cast<int>(data.names.size());
+    data.names.append(actionId);
+    data.idByName.insert(actionId, id);
+    return id;
+}
+
+int DeckGamepadActionRegistry::lookup(const QString &actionId)
+{
+    if (actionId.isEmpty()) {
+        return DECKGAMEPAD_ACTION_INVALID;
+    }
+
+    ActionRegistryData &data = registryData();
+    QReadLocker locker(&data.lock);
+    return data.idByName.value(actionId, DECKGAMEPAD_ACTION_INVALID);
+}
+
+QString DeckGamepadActionRegistry::name(int id)
+{
+    ActionRegistryData &data = registryData();
+    QReadLocker locker(&data.lock);
+    if (id < 0 || id >= data.names.size()) {
+        return QString{};
+    }
+    return data.names.at(id);
+}
+
+int DeckGamepadActionRegistry::count()
+{
+    ActionRegistryData &data = registryData();
+    QReadLocker locker(&data.lock);
+    return static_cast<int>(data.names.size());
+}
+
+DECKGAMEPAD_END_NAMESPACE
@@ -42,8 +42,41 @@ inline constexpr char HelpRetry[] = "help.retry";
 inline constexpr char HelpDisableGrab[] = "help.disable_grab";
 } // namespace DeckGamepadActionId
 
+// 内置 action 的整数 id：与 DeckGamepadActionId 导航常量一一对应（编译期固定）。
+// 自定义 actionId 由 DeckGamepadActionRegistry::intern() 分配，从 DECKGAMEPAD_ACTION_BUILTIN_COUNT 起递增。
+enum DeckGamepadBuiltinAction {
+    DECKGAMEPAD_ACTION_INVALID = -1,
+    DECKGAMEPAD_ACTION_NAV_UP = 0,
+    DECKGAMEPAD_ACTION_NAV_DOWN,
+    DECKGAMEPAD_ACTION_NAV_LEFT,
+    DECKGAMEPAD_ACTION_NAV_RIGHT,
+    DECKGAMEPAD_ACTION_NAV_ACCEPT,
+    DECKGAMEPAD_ACTION_NAV_BACK,
+    DECKGAMEPAD_ACTION_NAV_MENU,
+    DECKGAMEPAD_ACTION_NAV_TAB_NEXT,
+    DECKGAMEPAD_ACTION_NAV_TAB_PREV,
+    DECKGAMEPAD_ACTION_NAV_PAGE_NEXT,
+    DECKGAMEPAD_ACTION_NAV_PAGE_PREV,
+    DECKGAMEPAD_ACTION_BUILTIN_COUNT
+};
+
+// 进程级 actionId 字符串 ↔ 整数 id 注册表（线程安全）。
+// 约定：intern 只在加载/应用 profile 时调用；热路径只使用整数 id。
+class DECKGAMEPAD_EXPORT DeckGamepadActionRegistry
+{
+public:
+    // 返回 actionId 对应的整数 id；未注册时分配新 id。空字符串返回 DECKGAMEPAD_ACTION_INVALID。
+    static int intern(const QString &actionId);
+    // 仅查询，不分配；未注册返回 DECKGAMEPAD_ACTION_INVALID。
+    static int lookup(const QString &actionId);
+    // id → actionId；无效 id 返回空字符串。
+    static QString name(int id);
+    static int count();
+};
+
 struct DeckGamepadActionEvent {
     QString actionId;
+    int numericId = DECKGAMEPAD_ACTION_INVALID; // DeckGamepadActionRegistry 整数 id
     bool pressed = false;
     bool repeated = false;
     int timeMs = 0;
@@ -11,8 +11,11 @@
 #include <QtCore/QMetaType>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
+#include <QtCore/QVariantList>
 #include <QtCore/QVariantMap>
 
+#include <array>
+
 DECKGAMEPAD_BEGIN_NAMESPACE
 
 namespace DeckGamepadDiagnosticKey {
@@ -25,15 +28,75 @@ inline constexpr char WaylandFocusGated[] = "deckgamepad.wayland.focus_gated";
 inline constexpr char WaylandNotAuthorized[] = "deckgamepad.wayland.not_authorized";
 } // namespace DeckGamepadDiagnosticKey
 
+// 设备探测耗时直方图：从发现设备节点到发布（gamepadConnected 或确认不可用）的单设备耗时。
+struct DeckGamepadProbeHistogram {
+    static constexpr int kBucketCount = 8;
+
+    std::array<int, kBucketCount> buckets{};
+    int samples = 0;
+    qint64 totalUs = 0;
+    qint64 maxUs = 0;
+    qint64 startupUs = 0; // start() 到首轮枚举全部发布完成（0 表示尚未完成）
+
+    // 桶上界（微秒，含）；最后一个桶无上界。
+    static constexpr qint64 bucketUpperBoundUs(int bucket)
+    {
+        constexpr qint64 bounds[kBucketCount - 1] = { 1000, 2000, 5000, 10000, 25000, 50000, 100000 };
+        return (bucket >= 0 && bucket < kBucketCount - 1) ? bounds[bucket] : -1;
+    }
+
+    void record(qint64 us)
+    {
+        us = qMax<qint64>(0, us);
+        int bucket = 0;
+        while (bucket < kBucketCount - 1 && us > bucketUpperBoundUs(bucket)) {
+            ++bucket;
+        }
+        ++buckets[static_cast<size_t>(bucket)];
+        ++samples;
+        totalUs += us;
+        maxUs = qMax(maxUs, us);
+    }
+
+    bool isEmpty() const { return samples == 0; }
+
+    QVariantMap toVariantMap() const
+    {
+        QVariantList counts;
+        QVariantList bounds;
+        for (int i = 0; i < kBucketCount; ++i) {
+            counts.append(buckets[static_cast<size_t>(i)]);
+            bounds.append(bucketUpperBoundUs(i));
+        }
+        return {
+            { QStringLiteral("buckets"), counts },
+            { QStringLiteral("bucketUpperBoundsUs"), bounds },
+            { QStringLiteral("samples"), samples },
+            { QStringLiteral("totalUs"), totalUs },
+            { QStringLiteral("maxUs"), maxUs },
+            { QStringLiteral("startupUs"), startupUs },
+        };
+    }
+
+    bool operator==(const DeckGamepadProbeHistogram &other) const
+    {
+        return buckets == other.buckets && samples == other.samples && totalUs == other.totalUs
+            && maxUs == other.maxUs && startupUs == other.startupUs;
+    }
+    bool operator!=(const DeckGamepadProbeHistogram &other) const { return !(*this == other); }
+};
+
 struct DeckGamepadDiagnostic {
     QString key;            // 稳定诊断 key（空表示 OK）
     QVariantMap details;    // 可变上下文（脱敏）
     QStringList suggestedActions; // 建议动作（稳定 actionId 集合）
+    DeckGamepadProbeHistogram startupProbe; // 设备探测耗时（不参与 isOk 判定）
 
     bool isOk() const { return key.isEmpty(); }
 };
 
 DECKGAMEPAD_END_NAMESPACE
 
+Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadProbeHistogram)
 Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadDiagnostic)
 
@@ -0,0 +1,288 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/core/deckgamepadrumble.h>
+
+#include <QtCore/QtGlobal>
+
+#include <limits>
+#include <utility>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+namespace {
+bool validMagnitude(float value)
+{
+    return value >= 0.0f && value <= 1.0f;
+}
+} // namespace
+
+// ============================================================================
+// DeckGamepadRumblePattern
+// ============================================================================
+
+bool DeckGamepadRumblePattern::isValid() const
+{
+    if (steps.isEmpty()) {
+        return false;
+    }
+    for (const DeckGamepadRumbleStep &step : steps) {
+        if (step.durationMs <= 0 || !validMagnitude(step.weakMagnitude) || !validMagnitude(step.strongMagnitude)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int DeckGamepadRumblePattern::cycleDurationMs() const
+{
+    int total = 0;
+    for (const DeckGamepadRumbleStep &step : steps) {
+        total += qMax(0, step.durationMs);
+    }
+    return total;
+}
+
+DeckGamepadRumblePattern DeckGamepadRumblePattern::constant(float weakMagnitude, float strongMagnitude, int durationMs)
+{
+    DeckGamepadRumblePattern pattern;
+    pattern.steps.append(DeckGamepadRumbleStep{ weakMagnitude, strongMagnitude, durationMs, false });
+    return pattern;
+}
+
+DeckGamepadRumblePattern DeckGamepadRumblePattern::envelope(float weakMagnitude,
+                                                            float strongMagnitude,
+                                                            int attackMs,
+                                                            int sustainMs,
+                                                            int releaseMs)
+{
+    DeckGamepadRumblePattern pattern;
+    if (attackMs > 0) {
+        pattern.steps.append(DeckGamepadRumbleStep{ weakMagnitude, strongMagnitude, attackMs, true });
+    }
+    if (sustainMs > 0) {
+        pattern.steps.append(DeckGamepadRumbleStep{ weakMagnitude, strongMagnitude, sustainMs, false });
+    }
+    if (releaseMs > 0) {
+        pattern.steps.append(DeckGamepadRumbleStep{ 0.0f, 0.0f, releaseMs, true });
+    }
+    return pattern;
+}
+
+// ============================================================================
+// DeckGamepadRumbleScheduler
+// ============================================================================
+
+DeckGamepadRumbleScheduler::DeckGamepadRumbleScheduler(Output output, QObject *parent)
+    : QObject(parent)
+    , m_output(std::move(output))
+{
+    m_clock.start();
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &DeckGamepadRumbleScheduler::service);
+}
+
+// 析构时不再输出：Output 通常引用所属设备，设备应在析构前自行 stop()。
+DeckGamepadRumbleScheduler::~DeckGamepadRumbleScheduler() = default;
+
+void DeckGamepadRumbleScheduler::setMinIntervalMs(int intervalMs)
+{
+    m_minIntervalMs = qMax(0, intervalMs);
+}
+
+bool DeckGamepadRumbleScheduler::setLevel(float weakMagnitude, float strongMagnitude, int durationMs)
+{
+    if (!validMagnitude(weakMagnitude) || !validMagnitude(strongMagnitude) || durationMs < 0) {
+        return false;
+    }
+
+    if (weakMagnitude <= 0.0f && strongMagnitude <= 0.0f) {
+        stop();
+        return true;
+    }
+
+    // durationMs == 0：单步无限保持（步长仅占位）。
+    submit(DeckGamepadRumblePattern::constant(weakMagnitude, strongMagnitude, durationMs > 0 ? durationMs : 1),
+           durationMs == 0);
+    return true;
+}
+
+bool DeckGamepadRumbleScheduler::play(const DeckGamepadRumblePattern &pattern)
+{
+    if (!pattern.isValid()) {
+        return false;
+    }
+
+    submit(pattern, false);
+    return true;
+}
+
+void DeckGamepadRumbleScheduler::stop()
+{
+    m_active = false;
+    m_pending = false;
+    service();
+}
+
+void DeckGamepadRumbleScheduler::submit(const DeckGamepadRumblePattern &pattern, bool holdLast)
+{
+    // 上一请求尚未输出即被覆盖：计为一次合并。
+    if (m_pending) {
+        ++m_coalescedCount;
+    }
+
+    m_pattern = pattern;
+    m_holdLast = holdLast;
+    m_startMs = m_clock.elapsed();
+    m_active = true;
+    m_pending = true;
+    service();
+}
+
+DeckGamepadRumbleScheduler::Sample DeckGamepadRumbleScheduler::sampleAt(qint64 nowMs) const
+{
+    Sample sample;
+    if (!m_active || m_pattern.steps.isEmpty()) {
+        sample.finished = true;
+        return sample;
+    }
+
+    if (m_holdLast) {
+        const DeckGamepadRumbleStep &step = m_pattern.steps.constFirst();
+        sample.weak = step.weakMagnitude;
+        sample.strong = step.strongMagnitude;
+        return sample;
+    }
+
+    const qint64 cycle = m_pattern.cycleDurationMs();
+    const qint64 elapsed = nowMs - m_startMs;
+    const bool infinite = m_pattern.repeatCount < 0;
+    const qint64 plays = infinite ? 0 : qint64(m_pattern.repeatCount) + 1;
+    if (cycle <= 0 || (!infinite && elapsed >= cycle * plays)) {
+        sample.finished = true;
+        return sample;
+    }
+
+    const qint64 cycleIndex = elapsed / cycle;
+    const qint64 inCycle = elapsed % cycle;
+    const qint64 cycleStartMs = m_startMs + cycleIndex * cycle;
+    const bool finalCycle = !infinite && cycleIndex == plays - 1;
+
+    // 循环播放时第一步的过渡起点为上一轮的最后一步。
+    float prevWeak = 0.0f;
+    float prevStrong = 0.0f;
+    if (cycleIndex > 0) {
+        prevWeak = m_pattern.steps.constLast().weakMagnitude;
+        prevStrong = m_pattern.steps.constLast().strongMagnitude;
+    }
+
+    qint64 stepStart = 0;
+    for (qsizetype i = 0; i < m_pattern.steps.size(); ++i) {
+        const DeckGamepadRumbleStep &step = m_pattern.steps.at(i);
+        const qint64 stepEnd = stepStart + step.durationMs;
+        if (inCycle < stepEnd) {
+            const qint64 stepEndMs = cycleStartMs + stepEnd;
+            if (step.ramp) {
+                const float t = float(inCycle - stepStart) / float(step.durationMs);
+                sample.weak = prevWeak + (step.weakMagnitude - prevWeak) * t;
+                sample.strong = prevStrong + (step.strongMagnitude - prevStrong) * t;
+                sample.nextChangeMs = qMin(nowMs + qMax(1, m_minIntervalMs), stepEndMs);
+            } else {
+                sample.weak = step.weakMagnitude;
+                sample.strong = step.strongMagnitude;
+                sample.nextChangeMs = stepEndMs;
+            }
+            sample.holdUntilMs = stepEndMs;
+            sample.lastSegment = finalCycle && i == m_pattern.steps.size() - 1;
+            return sample;
+        }
+        prevWeak = step.weakMagnitude;
+        prevStrong = step.strongMagnitude;
+        stepStart = stepEnd;
+    }
+
+    sample.finished = true;
+    return sample;
+}
+
+void DeckGamepadRumbleScheduler::service()
+{
+    m_timer.stop();
+
+    const qint64 now = m_clock.elapsed();
+    const Sample sample = sampleAt(now);
+    const bool deviceRunning = (m_appliedWeak > 0.0f || m_appliedStrong > 0.0f)
+        && (m_appliedUntilMs < 0 || m_appliedUntilMs > now);
+
+    if (sample.finished) {
+        // 停止不受输出间隔限制；设备侧时长已到期时无需再写。
+        m_active = false;
+        m_pending = false;
+        if (deviceRunning) {
+            emitOutput(0.0f, 0.0f, 0, now);
+        } else {
+            m_appliedWeak = 0.0f;
+            m_appliedStrong = 0.0f;
+        }
+        return;
+    }
+
+    if (m_lastOutputMs >= 0 && now - m_lastOutputMs < m_minIntervalMs) {
+        m_timer.start(int(m_lastOutputMs + m_minIntervalMs - now));
+        return;
+    }
+
+    const bool silent = sample.weak <= 0.0f && sample.strong <= 0.0f;
+    if (silent) {
+        if (deviceRunning) {
+            emitOutput(0.0f, 0.0f, 0, now);
+        }
+    } else {
+        const bool sameLevel = deviceRunning && sample.weak == m_appliedWeak && sample.strong == m_appliedStrong;
+        const bool covered = m_appliedUntilMs < 0 || (sample.holdUntilMs >= 0 && m_appliedUntilMs >= sample.holdUntilMs);
+        if (!sameLevel || !covered) {
+            int durationMs = 0;
+            if (sample.holdUntilMs >= 0) {
+                // 中间段多给一个输出间隔，避免与下一段衔接处出现空档；最后一段精确结束。
+                const qint64 margin = sample.lastSegment ? 0 : qMax(1, m_minIntervalMs);
+                durationMs = int(qBound<qint64>(1, sample.holdUntilMs - now + margin, kMaxOutputDurationMs));
+            }
+            emitOutput(sample.weak, sample.strong, durationMs, now);
+        }
+    }
+    m_pending = false;
+
+    qint64 wakeMs = sample.nextChangeMs;
+    // 设备侧时长短于需求（超出 16 位上限）时提前续期。
+    if (m_appliedUntilMs >= 0 && (m_appliedWeak > 0.0f || m_appliedStrong > 0.0f)
+        && (sample.holdUntilMs < 0 || m_appliedUntilMs < sample.holdUntilMs)) {
+        const qint64 renewMs = m_appliedUntilMs - qMax(1, m_minIntervalMs);
+        wakeMs = wakeMs < 0 ? renewMs : qMin(wakeMs, renewMs);
+    }
+    if (wakeMs >= 0) {
+        m_timer.start(int(qBound<qint64>(0, wakeMs - now, std::numeric_limits<int>::max())));
+    }
+}
+
+bool DeckGamepadRumbleScheduler::emitOutput(float weak, float strong, int durationMs, qint64 nowMs)
+{
+    const bool ok = m_output && m_output(weak, strong, durationMs);
+    m_lastOutputMs = nowMs;
+    ++m_outputCount;
+
+    const bool silent = weak <= 0.0f && strong <= 0.0f;
+    if (ok && !silent) {
+        m_appliedWeak = weak;
+        m_appliedStrong = strong;
+        m_appliedUntilMs = durationMs > 0 ? nowMs + durationMs : -1;
+    } else {
+        m_appliedWeak = 0.0f;
+        m_appliedStrong = 0.0f;
+        m_appliedUntilMs = 0;
+    }
+    return ok;
+}
+
+DECKGAMEPAD_END_NAMESPACE
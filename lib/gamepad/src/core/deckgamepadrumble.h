@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// 振动片段与调度器：调用方一次提交整段触觉片段（序列/包络），或按帧更新幅度；
+// 调度器按最小输出间隔合并更新，并只在幅度/时长确实变化时写设备。
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <functional>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+struct DeckGamepadRumbleStep {
+    float weakMagnitude = 0.0f;   // 0.0 - 1.0
+    float strongMagnitude = 0.0f; // 0.0 - 1.0
+    int durationMs = 0;           // > 0
+    // true：在本步时长内从上一步的幅度线性过渡到本步幅度（包络）；false：本步开始即为目标幅度。
+    bool ramp = false;
+};
+
+struct DECKGAMEPAD_EXPORT DeckGamepadRumblePattern {
+    QList<DeckGamepadRumbleStep> steps;
+    // 额外重复次数；< 0 表示无限循环，直到 stop 或新的请求。
+    int repeatCount = 0;
+
+    bool isValid() const;
+    // 单轮时长（不含重复）。
+    int cycleDurationMs() const;
+
+    static DeckGamepadRumblePattern constant(float weakMagnitude, float strongMagnitude, int durationMs);
+    // 起振（attack，线性上升）→ 保持（sustain）→ 衰减（release，线性归零）。
+    static DeckGamepadRumblePattern envelope(float weakMagnitude,
+                                             float strongMagnitude,
+                                             int attackMs,
+                                             int sustainMs,
+                                             int releaseMs);
+};
+
+/**
+ * @brief 每设备振动调度器（单线程，运行在所属对象线程）
+ *
+ * - setLevel()/play() 覆盖当前请求；两次输出之间至少间隔 minIntervalMs，期间的请求只保留最新一次。
+ * - 输出时幅度不变且设备侧时长仍覆盖需求时不写设备；包络按 minIntervalMs 采样。
+ * - Output 的 durationMs 为本次输出的最长持续时间（设备侧兜底停止），0 表示持续到下一次输出；
+ *   weak/strong 均为 0 表示停止。
+ */
+class DECKGAMEPAD_EXPORT DeckGamepadRumbleScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Output = std::function<bool(float weakMagnitude, float strongMagnitude, int durationMs)>;
+
+    static constexpr int kDefaultMinIntervalMs = 8;
+    // ff_effect::replay.length 为 16 位。
+    static constexpr int kMaxOutputDurationMs = 0xFFFF;
+
+    explicit DeckGamepadRumbleScheduler(Output output, QObject *parent = nullptr);
+    ~DeckGamepadRumbleScheduler() override;
+
+    void setMinIntervalMs(int intervalMs);
+    int minIntervalMs() const { return m_minIntervalMs; }
+
+    // durationMs == 0 表示持续，直到 stop() 或新的请求。
+    bool setLevel(float weakMagnitude, float strongMagnitude, int durationMs);
+    bool play(const DeckGamepadRumblePattern &pattern);
+    void stop();
+
+    bool isActive() const { return m_active; }
+
+    // 统计：实际写设备次数 / 被合并（未输出即被覆盖）的请求数。
+    quint64 outputCount() const { return m_outputCount; }
+    quint64 coalescedCount() const { return m_coalescedCount; }
+
+private:
+    struct Sample {
+        float weak = 0.0f;
+        float strong = 0.0f;
+        qint64 holdUntilMs = -1;   // 当前幅度至少保持到的时刻；-1 表示无限
+        qint64 nextChangeMs = -1;  // 下一次需要重新采样的时刻；-1 表示无需
+        bool lastSegment = false;  // holdUntilMs 即片段结束：设备侧时长不加余量
+        bool finished = false;
+    };
+
+    void submit(const DeckGamepadRumblePattern &pattern, bool holdLast);
+    Sample sampleAt(qint64 nowMs) const;
+    void service();
+    bool emitOutput(float weak, float strong, int durationMs, qint64 nowMs);
+
+    Output m_output;
+    int m_minIntervalMs = kDefaultMinIntervalMs;
+
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+
+    DeckGamepadRumblePattern m_pattern;
+    bool m_holdLast = false; // setLevel(…, 0)：最后一步无限保持
+    qint64 m_startMs = 0;
+    bool m_active = false;
+    bool m_pending = false;
+
+    float m_appliedWeak = 0.0f;
+    float m_appliedStrong = 0.0f;
+    qint64 m_appliedUntilMs = 0; // -1 表示设备侧无限保持
+    qint64 m_lastOutputMs = -1;
+
+    quint64 m_outputCount = 0;
+    quint64 m_coalescedCount = 0;
+};
+
+DECKGAMEPAD_END_NAMESPACE
@@ -46,6 +46,14 @@ enum class DeckGamepadProviderSelection {
     Evdev,
 };
 
+// 输入传输方式：evdev IO 线程 → Service 线程的事件投递通道（仅 IO 线程模式生效）。
+// - QueuedSignal：每帧一次 Qt::QueuedConnection（默认，行为与历史一致）
+// - SpscRing：每设备一个无锁 SPSC 环形缓冲，IO 线程写入定长记录，Service 线程按批唤醒（eventfd）后一次性排空
+enum class DeckGamepadInputTransport {
+    QueuedSignal = 0,
+    SpscRing,
+};
+
 struct DeckGamepadRuntimeConfig {
     // SDL GameController DB（gamecontrollerdb.txt）
     QString sdlDbPathOverride;
@@ -75,16 +83,33 @@ struct DeckGamepadRuntimeConfig {
     DeckGamepadCapturePolicy capturePolicy = DeckGamepadCapturePolicy::ActiveSessionOnly;
     DeckGamepadEvdevGrabMode grabMode = DeckGamepadEvdevGrabMode::Shared;
 
+    // 设备探测并发度：>0 时设备打开（能力检测/DeviceAccessBroker/EVIOCGRAB/ioctl 探测）在线程池中并行执行，
+    // 单个慢节点不阻塞其它设备，就绪即发布；0 为同步逐个探测（历史行为，便于排查）。
+    int probeConcurrency = 4;
+
     // ========== Provider 选择/回滚通道 ==========
     // Auto：使用构建期默认选择（见 CMake: DECKGAMEPAD_DEFAULT_PROVIDER）。
     // 仅在 DeckGamepadService “自动选择 provider”模式下生效；手动 setProvider() 的场景会忽略该字段。
     DeckGamepadProviderSelection providerSelection = DeckGamepadProviderSelection::Auto;
 
+    // 输入传输方式（仅 EvdevProvider IO 线程模式生效；单线程调试模式下始终为直接信号）。
+    DeckGamepadInputTransport inputTransport = DeckGamepadInputTransport::QueuedSignal;
+
     // ========== compositor/转发相关 ==========
     // axis/hat 高频事件整形（默认关闭）。>0 时按窗口合并（仅 axis/hat；button 不合并）。
     int axisCoalesceIntervalMs = 0;
     int hatCoalesceIntervalMs = 0;
 
+    // 振动输出最小间隔（evdev / treeland 每设备调度器）：间隔内的多次 startVibration 只输出最新一次；0 为不合并。
+    int rumbleMinIntervalMs = 8;
+
+    // ========== treeland provider ==========
+    // 异步连接：start() 不等待 compositor（无 wl_display_roundtrip），协议绑定/设备到达后再经信号发布；
+    // compositor 不提供 treeland_gamepad_manager_v1 时经 lastErrorChanged 上报 BackendStartFailed。
+    bool treelandAsyncConnect = false;
+    // 读取线程：Wayland socket 的 poll/read 在专用线程完成，每批事件只唤醒 provider 所在线程一次做分发。
+    bool treelandReaderThread = false;
+
     QString defaultCustomMappingPath() const
     {
         const QString configDir = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
@@ -219,3 +244,4 @@ Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadDeviceAccessMode)
 Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadCapturePolicy)
 Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadEvdevGrabMode)
 Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadProviderSelection)
+Q_DECLARE_METATYPE(deckshell::deckgamepad::DeckGamepadInputTransport)
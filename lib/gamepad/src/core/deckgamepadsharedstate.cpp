@@ -0,0 +1,444 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "deckgamepadsharedstate_p.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QFile>
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef F_SEAL_FUTURE_WRITE
+#define F_SEAL_FUTURE_WRITE 0x0010
+#endif
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+namespace {
+// 写端持续占用时读端的最大重试次数（写端单次提交仅几十 ns，正常情况下 1~2 次即成功）。
+constexpr int kMaxReadRetries = 64;
+
+QString errnoString(const char *what)
+{
+    return QStringLiteral("%1: %2").arg(QString::fromLatin1(what), QString::fromLocal8Bit(std::strerror(errno)));
+}
+
+const DeckGamepadSharedStateSlot *readerSlotAt(const unsigned char *base, int index)
+{
+    return reinterpret_cast<const DeckGamepadSharedStateSlot *>(base + kDeckGamepadSharedStateHeaderSize
+                                                                + sizeof(DeckGamepadSharedStateSlot) * size_t(index));
+}
+} // namespace
+
+// ---- Writer ----
+
+DeckGamepadSharedStateWriter::~DeckGamepadSharedStateWriter()
+{
+    if (m_base) {
+        ::munmap(m_base, kDeckGamepadSharedStateSize);
+        m_base = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool DeckGamepadSharedStateWriter::create(QString *errorMessage)
+{
+    if (m_base) {
+        return true;
+    }
+
+    const int fd = ::memfd_create("deckgamepad-state", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        if (errorMessage) {
+            *errorMessage = errnoString("memfd_create");
+        }
+        return false;
+    }
+    if (::ftruncate(fd, off_t(kDeckGamepadSharedStateSize)) != 0) {
+        if (errorMessage) {
+            *errorMessage = errnoString("ftruncate");
+        }
+        ::close(fd);
+        return false;
+    }
+    void *mapped = ::mmap(nullptr, kDeckGamepadSharedStateSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        if (errorMessage) {
+            *errorMessage = errnoString("mmap");
+        }
+        ::close(fd);
+        return false;
+    }
+
+    // 固定大小：读端无需防御 SIGBUS。F_SEAL_FUTURE_WRITE（5.1+）禁止之后再以可写方式映射，
+    // 已有的写映射不受影响；旧内核返回 EINVAL 时退化为仅限制大小。
+    ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW);
+    ::fcntl(fd, F_ADD_SEALS, F_SEAL_FUTURE_WRITE);
+
+    m_fd = fd;
+    m_base = static_cast<unsigned char *>(mapped);
+
+    auto *hdr = new (m_base) DeckGamepadSharedStateHeader{};
+    hdr->magic = kDeckGamepadSharedStateMagic;
+    hdr->version = kDeckGamepadSharedStateVersion;
+    hdr->slotCount = quint16(kDeckGamepadSharedStateMaxDevices);
+    hdr->headerSize = quint32(kDeckGamepadSharedStateHeaderSize);
+    hdr->slotSize = quint32(sizeof(DeckGamepadSharedStateSlot));
+    hdr->generation.store(0, std::memory_order_relaxed);
+
+    for (int i = 0; i < kDeckGamepadSharedStateMaxDevices; ++i) {
+        auto *slot = new (m_base + kDeckGamepadSharedStateHeaderSize + sizeof(DeckGamepadSharedStateSlot) * size_t(i))
+            DeckGamepadSharedStateSlot{};
+        slot->deviceId.store(-1, std::memory_order_relaxed);
+    }
+    m_deviceBySlot.fill(-1);
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+}
+
+DeckGamepadSharedStateHeader *DeckGamepadSharedStateWriter::header() const
+{
+    return reinterpret_cast<DeckGamepadSharedStateHeader *>(m_base);
+}
+
+DeckGamepadSharedStateSlot *DeckGamepadSharedStateWriter::slotAt(int index) const
+{
+    return reinterpret_cast<DeckGamepadSharedStateSlot *>(m_base + kDeckGamepadSharedStateHeaderSize
+                                                          + sizeof(DeckGamepadSharedStateSlot) * size_t(index));
+}
+
+int DeckGamepadSharedStateWriter::slotIndexFor(int deviceId) const
+{
+    for (int i = 0; i < kDeckGamepadSharedStateMaxDevices; ++i) {
+        if (m_deviceBySlot[size_t(i)] == deviceId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int DeckGamepadSharedStateWriter::acquireSlot(int deviceId)
+{
+    if (!m_base || deviceId < 0) {
+        return -1;
+    }
+    const int existing = slotIndexFor(deviceId);
+    if (existing >= 0) {
+        return existing;
+    }
+    const int index = slotIndexFor(-1);
+    if (index < 0) {
+        return -1;
+    }
+
+    // 新设备从零状态开始；deviceId 在同一 seqlock 提交内写入，读端不会把旧设备的状态归到新设备上。
+    DeckGamepadSharedStateSlot *slot = slotAt(index);
+    const quint32 seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->deviceId.store(deviceId, std::memory_order_relaxed);
+    slot->buttons.store(0, std::memory_order_relaxed);
+    slot->timeMsec.store(0, std::memory_order_relaxed);
+    slot->frameCounter.store(0, std::memory_order_relaxed);
+    slot->timestampNs.store(QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs(), std::memory_order_relaxed);
+    for (auto &axis : slot->axes) {
+        axis.store(0.0f, std::memory_order_relaxed);
+    }
+    for (auto &hat : slot->hats) {
+        hat.store(0, std::memory_order_relaxed);
+    }
+    slot->seq.store(seq + 2, std::memory_order_release);
+
+    m_deviceBySlot[size_t(index)] = deviceId;
+    header()->generation.fetch_add(1, std::memory_order_release);
+    return index;
+}
+
+void DeckGamepadSharedStateWriter::releaseSlot(int deviceId)
+{
+    const int index = (m_base && deviceId >= 0) ? slotIndexFor(deviceId) : -1;
+    if (index < 0) {
+        return;
+    }
+
+    DeckGamepadSharedStateSlot *slot = slotAt(index);
+    const quint32 seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->deviceId.store(-1, std::memory_order_relaxed);
+    slot->seq.store(seq + 2, std::memory_order_release);
+
+    m_deviceBySlot[size_t(index)] = -1;
+    header()->generation.fetch_add(1, std::memory_order_release);
+}
+
+void DeckGamepadSharedStateWriter::releaseAll()
+{
+    for (int i = 0; i < kDeckGamepadSharedStateMaxDevices; ++i) {
+        const int deviceId = m_deviceBySlot[size_t(i)];
+        if (deviceId >= 0) {
+            releaseSlot(deviceId);
+        }
+    }
+}
+
+DeckGamepadSharedStateSlot *DeckGamepadSharedStateWriter::beginWrite(int deviceId)
+{
+    if (!m_base) {
+        return nullptr;
+    }
+    const int index = slotIndexFor(deviceId);
+    if (index < 0) {
+        return nullptr;
+    }
+    DeckGamepadSharedStateSlot *slot = slotAt(index);
+    const quint32 seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return slot;
+}
+
+void DeckGamepadSharedStateWriter::commit(DeckGamepadSharedStateSlot *slot, quint32 timeMsec)
+{
+    slot->timeMsec.store(timeMsec, std::memory_order_relaxed);
+    slot->frameCounter.store(slot->frameCounter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot->timestampNs.store(QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs(), std::memory_order_relaxed);
+    // seq 在 beginWrite 中已置为奇数，此处 +1 回到偶数并以 release 发布全部字段。
+    slot->seq.store(slot->seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+namespace {
+void storeButton(DeckGamepadSharedStateSlot *slot, const DeckGamepadButtonEvent &event)
+{
+    if (event.button >= 32) {
+        return;
+    }
+    const quint32 bit = 1u << event.button;
+    const quint32 buttons = slot->buttons.load(std::memory_order_relaxed);
+    slot->buttons.store(event.pressed ? (buttons | bit) : (buttons & ~bit), std::memory_order_relaxed);
+}
+
+void storeAxis(DeckGamepadSharedStateSlot *slot, const DeckGamepadAxisEvent &event)
+{
+    if (event.axis < uint32_t(kDeckGamepadSharedStateAxes)) {
+        slot->axes[event.axis].store(float(event.value), std::memory_order_relaxed);
+    }
+}
+
+void storeHat(DeckGamepadSharedStateSlot *slot, const DeckGamepadHatEvent &event)
+{
+    if (event.hat < uint32_t(kDeckGamepadSharedStateHats)) {
+        slot->hats[event.hat].store(event.value, std::memory_order_relaxed);
+    }
+}
+} // namespace
+
+void DeckGamepadSharedStateWriter::publishButton(int deviceId, const DeckGamepadButtonEvent &event)
+{
+    if (auto *slot = beginWrite(deviceId)) {
+        storeButton(slot, event);
+        commit(slot, event.time_msec);
+    }
+}
+
+void DeckGamepadSharedStateWriter::publishAxis(int deviceId, const DeckGamepadAxisEvent &event)
+{
+    if (auto *slot = beginWrite(deviceId)) {
+        storeAxis(slot, event);
+        commit(slot, event.time_msec);
+    }
+}
+
+void DeckGamepadSharedStateWriter::publishHat(int deviceId, const DeckGamepadHatEvent &event)
+{
+    if (auto *slot = beginWrite(deviceId)) {
+        storeHat(slot, event);
+        commit(slot, event.time_msec);
+    }
+}
+
+void DeckGamepadSharedStateWriter::publishFrame(int deviceId, const DeckGamepadFrameEvent &frame)
+{
+    if (frame.isEmpty()) {
+        return;
+    }
+    if (auto *slot = beginWrite(deviceId)) {
+        // 同帧内按钮按到达顺序应用：press+release 同帧时最终状态为释放（与事件流一致）。
+        for (const auto &event : frame.buttons) {
+            storeButton(slot, event);
+        }
+        for (const auto &event : frame.axes) {
+            storeAxis(slot, event);
+        }
+        for (const auto &event : frame.hats) {
+            storeHat(slot, event);
+        }
+        commit(slot, frame.time_msec);
+    }
+}
+
+// ---- Reader ----
+
+DeckGamepadSharedStateReader::~DeckGamepadSharedStateReader()
+{
+    detach();
+}
+
+bool DeckGamepadSharedStateReader::attach(int fd)
+{
+    detach();
+
+    struct stat st {};
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+        m_errorString = fd < 0 ? QStringLiteral("invalid fd") : errnoString("fstat");
+        return false;
+    }
+    if (size_t(st.st_size) < kDeckGamepadSharedStateHeaderSize) {
+        m_errorString = QStringLiteral("shared state too small (%1 bytes)").arg(qint64(st.st_size));
+        return false;
+    }
+
+    const size_t size = size_t(st.st_size);
+    void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        m_errorString = errnoString("mmap");
+        return false;
+    }
+
+    const auto *hdr = static_cast<const DeckGamepadSharedStateHeader *>(mapped);
+    QString error;
+    if (hdr->magic != kDeckGamepadSharedStateMagic) {
+        error = QStringLiteral("bad magic");
+    } else if (hdr->version != kDeckGamepadSharedStateVersion) {
+        error = QStringLiteral("unsupported version %1").arg(hdr->version);
+    } else if (hdr->headerSize != kDeckGamepadSharedStateHeaderSize || hdr->slotSize != sizeof(DeckGamepadSharedStateSlot)
+               || hdr->slotCount != kDeckGamepadSharedStateMaxDevices || size < kDeckGamepadSharedStateSize) {
+        error = QStringLiteral("layout mismatch");
+    }
+    if (!error.isEmpty()) {
+        ::munmap(mapped, size);
+        m_errorString = error;
+        return false;
+    }
+
+    m_base = static_cast<const unsigned char *>(mapped);
+    m_size = size;
+    m_errorString.clear();
+    return true;
+}
+
+bool DeckGamepadSharedStateReader::attach(const QString &path)
+{
+    const QByteArray encoded = QFile::encodeName(path);
+    const int fd = ::open(encoded.constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        detach();
+        m_errorString = errnoString("open");
+        return false;
+    }
+    const bool ok = attach(fd);
+    ::close(fd);
+    return ok;
+}
+
+void DeckGamepadSharedStateReader::detach()
+{
+    if (m_base) {
+        ::munmap(const_cast<unsigned char *>(m_base), m_size);
+        m_base = nullptr;
+        m_size = 0;
+    }
+}
+
+quint64 DeckGamepadSharedStateReader::generation() const
+{
+    if (!m_base) {
+        return 0;
+    }
+    return reinterpret_cast<const DeckGamepadSharedStateHeader *>(m_base)->generation.load(std::memory_order_acquire);
+}
+
+QList<int> DeckGamepadSharedStateReader::deviceIds() const
+{
+    QList<int> ids;
+    if (!m_base) {
+        return ids;
+    }
+    for (int i = 0; i < kDeckGamepadSharedStateMaxDevices; ++i) {
+        const int id = readerSlotAt(m_base, i)->deviceId.load(std::memory_order_acquire);
+        if (id >= 0) {
+            ids.append(id);
+        }
+    }
+    return ids;
+}
+
+bool DeckGamepadSharedStateReader::read(int deviceId, DeckGamepadStateSample *sample) const
+{
+    if (!m_base || !sample || deviceId < 0) {
+        return false;
+    }
+    for (int i = 0; i < kDeckGamepadSharedStateMaxDevices; ++i) {
+        if (readerSlotAt(m_base, i)->deviceId.load(std::memory_order_relaxed) != deviceId) {
+            continue;
+        }
+        // 读取过程中槽位可能被释放/复用：readSlot 校验 deviceId 未变。
+        if (readSlot(i, sample) && sample->deviceId == deviceId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DeckGamepadSharedStateReader::readSlot(int index, DeckGamepadStateSample *sample) const
+{
+    const DeckGamepadSharedStateSlot *slot = readerSlotAt(m_base, index);
+    for (int attempt = 0; attempt < kMaxReadRetries; ++attempt) {
+        const quint32 begin = slot->seq.load(std::memory_order_acquire);
+        if (begin & 1u) {
+            continue;
+        }
+
+        DeckGamepadStateSample copy;
+        copy.deviceId = slot->deviceId.load(std::memory_order_relaxed);
+        copy.buttons = slot->buttons.load(std::memory_order_relaxed);
+        copy.timeMsec = slot->timeMsec.load(std::memory_order_relaxed);
+        copy.frameCounter = slot->frameCounter.load(std::memory_order_relaxed);
+        copy.timestampNs = slot->timestampNs.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < copy.axes.size(); ++i) {
+            copy.axes[i] = slot->axes[i].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < copy.hats.size(); ++i) {
+            copy.hats[i] = slot->hats[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->seq.load(std::memory_order_relaxed) == begin) {
+            if (copy.deviceId < 0) {
+                return false;
+            }
+            *sample = copy;
+            return true;
+        }
+    }
+    return false;
+}
+
+DECKGAMEPAD_END_NAMESPACE
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// 共享内存手柄状态快照：DeckGamepadService 在 memfd 中发布每设备的当前状态块（seqlock 保护），
+// 轮询型消费者（游戏循环、QML GamepadState、其他进程）每帧读取一次即可，无需订阅逐事件信号。
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+#include <array>
+#include <cstddef>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+// 布局常量（v1）：槽位数/轴数/hat 数固定，保证跨进程、跨版本的读取端不依赖枚举增长。
+inline constexpr int kDeckGamepadSharedStateMaxDevices = 16;
+inline constexpr int kDeckGamepadSharedStateAxes = 8;
+inline constexpr int kDeckGamepadSharedStateHats = 4;
+
+static_assert(GAMEPAD_AXIS_MAX <= kDeckGamepadSharedStateAxes, "shared state axis slots too small");
+static_assert(GAMEPAD_BUTTON_MAX <= 32, "shared state button mask is 32 bits");
+
+// 单设备状态的一致性副本（一次 seqlock 读取的结果）。
+struct DeckGamepadStateSample {
+    int deviceId = -1;
+    quint32 buttons = 0; // bit n = GamepadButton n
+    std::array<float, kDeckGamepadSharedStateAxes> axes{}; // GamepadAxis 索引，[-1, 1]
+    std::array<int, kDeckGamepadSharedStateHats> hats{};   // GamepadHatMask
+    quint64 frameCounter = 0; // 每次提交（一帧或一个独立事件）递增
+    qint64 timestampNs = 0;   // 提交时刻（QDeadlineTimer 单调时钟）
+    quint32 timeMsec = 0;     // 最近一次输入事件的 time_msec
+
+    bool button(int index) const { return index >= 0 && index < 32 && ((buttons >> index) & 1u); }
+    double axis(int index) const { return (index >= 0 && index < kDeckGamepadSharedStateAxes) ? axes[size_t(index)] : 0.0; }
+    int hat(int index) const { return (index >= 0 && index < kDeckGamepadSharedStateHats) ? hats[size_t(index)] : 0; }
+};
+
+/**
+ * @brief 只读映射共享状态块的读取端
+ *
+ * - attach(fd)：同进程直接使用 DeckGamepadService::sharedStateFd()；attach(path)：其他进程打开
+ *   DeckGamepadService::sharedStatePath()（/proc/<pid>/fd/<n>）或经 SCM_RIGHTS 传来的 fd。
+ * - 映射为 PROT_READ；读取无锁、无分配，可在任意线程调用（写端在提交中时短暂重试）。
+ * - 写端重建（服务重启）后需重新 attach。
+ */
+class DECKGAMEPAD_EXPORT DeckGamepadSharedStateReader
+{
+public:
+    DeckGamepadSharedStateReader() = default;
+    ~DeckGamepadSharedStateReader();
+
+    DeckGamepadSharedStateReader(const DeckGamepadSharedStateReader &) = delete;
+    DeckGamepadSharedStateReader &operator=(const DeckGamepadSharedStateReader &) = delete;
+
+    // 不接管 fd 所有权（映射建立后 fd 可由调用方关闭）。
+    bool attach(int fd);
+    bool attach(const QString &path);
+    void detach();
+
+    bool isAttached() const { return m_base != nullptr; }
+    QString errorString() const { return m_errorString; }
+
+    // 槽位占用变化计数（设备连接/断开时递增），可用于判断是否需要刷新 deviceIds()。
+    quint64 generation() const;
+    QList<int> deviceIds() const;
+
+    // 读取指定设备的一致性快照；设备不存在或写端持续占用（极少见）时返回 false。
+    bool read(int deviceId, DeckGamepadStateSample *sample) const;
+
+private:
+    bool readSlot(int slot, DeckGamepadStateSample *sample) const;
+
+    const unsigned char *m_base = nullptr;
+    size_t m_size = 0;
+    QString m_errorString;
+};
+
+DECKGAMEPAD_END_NAMESPACE
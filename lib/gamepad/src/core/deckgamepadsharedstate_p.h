@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// 共享状态块的内存布局与写端（仅 DeckGamepadService 使用）。
+//
+// memfd 布局（v1，小端/本机 ABI）：
+//   [0, 64)                      DeckGamepadSharedStateHeader
+//   [64 + i * slotSize, ...)     DeckGamepadSharedStateSlot[i]，i < slotCount
+// 每个槽位独立 seqlock：seq 为奇数表示写入中；读端前后两次读到相同偶数 seq 即为一致快照。
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+#include <deckshell/deckgamepad/core/deckgamepadsharedstate.h>
+
+#include <QtCore/QString>
+
+#include <array>
+#include <atomic>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+inline constexpr quint32 kDeckGamepadSharedStateMagic = 0x53504744; // "DGPS"
+inline constexpr quint16 kDeckGamepadSharedStateVersion = 1;
+inline constexpr size_t kDeckGamepadSharedStateHeaderSize = 64;
+
+struct DeckGamepadSharedStateHeader {
+    quint32 magic;
+    quint16 version;
+    quint16 slotCount;
+    quint32 headerSize;
+    quint32 slotSize;
+    std::atomic<quint64> generation;
+};
+
+struct alignas(64) DeckGamepadSharedStateSlot {
+    std::atomic<quint32> seq;
+    std::atomic<qint32> deviceId; // -1 表示空槽
+    std::atomic<quint32> buttons;
+    std::atomic<quint32> timeMsec;
+    std::atomic<quint64> frameCounter;
+    std::atomic<qint64> timestampNs;
+    std::array<std::atomic<float>, kDeckGamepadSharedStateAxes> axes;
+    std::array<std::atomic<qint32>, kDeckGamepadSharedStateHats> hats;
+};
+
+static_assert(sizeof(DeckGamepadSharedStateHeader) <= kDeckGamepadSharedStateHeaderSize, "header overflows its page slot");
+static_assert(std::atomic<quint32>::is_always_lock_free && std::atomic<quint64>::is_always_lock_free
+                  && std::atomic<float>::is_always_lock_free,
+              "shared state requires address-free lock-free atomics");
+
+inline constexpr size_t kDeckGamepadSharedStateSize =
+    kDeckGamepadSharedStateHeaderSize + sizeof(DeckGamepadSharedStateSlot) * kDeckGamepadSharedStateMaxDevices;
+
+/**
+ * @brief 共享状态写端（单写者，Service 所在线程）
+ *
+ * publish*() 各自构成一次 seqlock 提交；publishFrame() 把同一 SYN_REPORT 的全部变化作为一次提交，
+ * 读端不会看到半帧状态。
+ */
+class DeckGamepadSharedStateWriter
+{
+public:
+    DeckGamepadSharedStateWriter() = default;
+    ~DeckGamepadSharedStateWriter();
+
+    DeckGamepadSharedStateWriter(const DeckGamepadSharedStateWriter &) = delete;
+    DeckGamepadSharedStateWriter &operator=(const DeckGamepadSharedStateWriter &) = delete;
+
+    bool create(QString *errorMessage);
+    int fd() const { return m_fd; }
+
+    // 槽位满时返回 -1（该设备不发布）。
+    int acquireSlot(int deviceId);
+    void releaseSlot(int deviceId);
+    void releaseAll();
+
+    void publishButton(int deviceId, const DeckGamepadButtonEvent &event);
+    void publishAxis(int deviceId, const DeckGamepadAxisEvent &event);
+    void publishHat(int deviceId, const DeckGamepadHatEvent &event);
+    void publishFrame(int deviceId, const DeckGamepadFrameEvent &frame);
+
+private:
+    DeckGamepadSharedStateHeader *header() const;
+    DeckGamepadSharedStateSlot *slotAt(int index) const;
+    int slotIndexFor(int deviceId) const;
+
+    DeckGamepadSharedStateSlot *beginWrite(int deviceId);
+    void commit(DeckGamepadSharedStateSlot *slot, quint32 timeMsec);
+
+    int m_fd = -1;
+    unsigned char *m_base = nullptr;
+    std::array<int, kDeckGamepadSharedStateMaxDevices> m_deviceBySlot{};
+};
+
+DECKGAMEPAD_END_NAMESPACE
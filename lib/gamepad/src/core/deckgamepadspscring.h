@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// 单生产者/单消费者无锁环形缓冲：定长 POD 记录，固定容量，运行期零分配。
+// - 生产者：stage() 暂存若干记录后 commit() 一次性发布（消费者不会看到半批数据）
+// - 消费者：drain() 读取已发布的全部记录
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+template <typename T, size_t Capacity>
+class DeckGamepadSpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "records must be trivially copyable");
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // ========== 生产者侧（仅限单一线程）==========
+    size_t writableCount() const
+    {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return Capacity - (m_stagedTail - head);
+    }
+
+    // 调用方需先用 writableCount() 确认空间。
+    void stage(const T &record)
+    {
+        m_buffer[m_stagedTail & kMask] = record;
+        ++m_stagedTail;
+    }
+
+    void commit() { m_tail.store(m_stagedTail, std::memory_order_release); }
+    void discardStaged() { m_stagedTail = m_tail.load(std::memory_order_relaxed); }
+
+    // ========== 消费者侧（仅限单一线程）==========
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+    }
+
+    template <typename Fn>
+    size_t drain(Fn &&fn)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t count = tail - head;
+        for (; head != tail; ++head) {
+            fn(m_buffer[head & kMask]);
+        }
+        m_head.store(head, std::memory_order_release);
+        return count;
+    }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr size_t kCacheLine = 64;
+
+    alignas(kCacheLine) std::atomic<size_t> m_head{ 0 }; // 消费者写
+    alignas(kCacheLine) std::atomic<size_t> m_tail{ 0 }; // 生产者写
+    alignas(kCacheLine) size_t m_stagedTail = 0;         // 生产者私有
+    std::array<T, Capacity> m_buffer{};
+};
+
+DECKGAMEPAD_END_NAMESPACE
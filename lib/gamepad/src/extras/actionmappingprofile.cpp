@@ -18,6 +18,7 @@ static DeckGamepadActionBinding bindingFromJsonValue(const QJsonValue &value)
 
     if (value.isString()) {
         binding.actionId = value.toString();
+        binding.numericId = DeckGamepadActionRegistry::intern(binding.actionId);
         return binding;
     }
 
@@ -27,6 +28,7 @@ static DeckGamepadActionBinding bindingFromJsonValue(const QJsonValue &value)
         if (binding.actionId.isEmpty()) {
             binding.actionId = obj.value(QStringLiteral("actionId")).toString();
         }
+        binding.numericId = DeckGamepadActionRegistry::intern(binding.actionId);
         return binding;
     }
 
@@ -35,6 +37,14 @@ static DeckGamepadActionBinding bindingFromJsonValue(const QJsonValue &value)
     return binding;
 }
 
+static DeckGamepadActionBinding builtinBinding(DeckGamepadBuiltinAction action)
+{
+    DeckGamepadActionBinding binding;
+    binding.numericId = action;
+    binding.actionId = DeckGamepadActionRegistry::name(action);
+    return binding;
+}
+
 static QJsonValue bindingToJsonValue(const DeckGamepadActionBinding &binding)
 {
     // 简化输出：以字符串为主（空字符串表示显式解绑）
@@ -169,33 +179,33 @@ ActionMappingProfile ActionMappingProfile::createNavigationPreset()
     profile.navigationPriority = NavigationPriority::DpadOverLeftStick;
 
     // DPad
-    profile.buttonBindings[GAMEPAD_BUTTON_DPAD_UP].actionId = QString::fromLatin1(DeckGamepadActionId::NavUp);
-    profile.buttonBindings[GAMEPAD_BUTTON_DPAD_DOWN].actionId = QString::fromLatin1(DeckGamepadActionId::NavDown);
-    profile.buttonBindings[GAMEPAD_BUTTON_DPAD_LEFT].actionId = QString::fromLatin1(DeckGamepadActionId::NavLeft);
-    profile.buttonBindings[GAMEPAD_BUTTON_DPAD_RIGHT].actionId = QString::fromLatin1(DeckGamepadActionId::NavRight);
+    profile.buttonBindings[GAMEPAD_BUTTON_DPAD_UP] = builtinBinding(DECKGAMEPAD_ACTION_NAV_UP);
+    profile.buttonBindings[GAMEPAD_BUTTON_DPAD_DOWN] = builtinBinding(DECKGAMEPAD_ACTION_NAV_DOWN);
+    profile.buttonBindings[GAMEPAD_BUTTON_DPAD_LEFT] = builtinBinding(DECKGAMEPAD_ACTION_NAV_LEFT);
+    profile.buttonBindings[GAMEPAD_BUTTON_DPAD_RIGHT] = builtinBinding(DECKGAMEPAD_ACTION_NAV_RIGHT);
 
     // Buttons
-    profile.buttonBindings[GAMEPAD_BUTTON_A].actionId = QString::fromLatin1(DeckGamepadActionId::NavAccept);
-    profile.buttonBindings[GAMEPAD_BUTTON_B].actionId = QString::fromLatin1(DeckGamepadActionId::NavBack);
-    profile.buttonBindings[GAMEPAD_BUTTON_START].actionId = QString::fromLatin1(DeckGamepadActionId::NavMenu);
-    profile.buttonBindings[GAMEPAD_BUTTON_L1].actionId = QString::fromLatin1(DeckGamepadActionId::NavTabPrev);
-    profile.buttonBindings[GAMEPAD_BUTTON_R1].actionId = QString::fromLatin1(DeckGamepadActionId::NavTabNext);
+    profile.buttonBindings[GAMEPAD_BUTTON_A] = builtinBinding(DECKGAMEPAD_ACTION_NAV_ACCEPT);
+    profile.buttonBindings[GAMEPAD_BUTTON_B] = builtinBinding(DECKGAMEPAD_ACTION_NAV_BACK);
+    profile.buttonBindings[GAMEPAD_BUTTON_START] = builtinBinding(DECKGAMEPAD_ACTION_NAV_MENU);
+    profile.buttonBindings[GAMEPAD_BUTTON_L1] = builtinBinding(DECKGAMEPAD_ACTION_NAV_TAB_PREV);
+    profile.buttonBindings[GAMEPAD_BUTTON_R1] = builtinBinding(DECKGAMEPAD_ACTION_NAV_TAB_NEXT);
 
     // Left stick → directions（threshold 作为 release 阈值；press 阈值由 mapper 的 hysteresis 决定）
     {
         DeckGamepadAxisActionBinding x;
         x.hasNegative = true;
-        x.negative.actionId = QString::fromLatin1(DeckGamepadActionId::NavLeft);
+        x.negative = builtinBinding(DECKGAMEPAD_ACTION_NAV_LEFT);
         x.hasPositive = true;
-        x.positive.actionId = QString::fromLatin1(DeckGamepadActionId::NavRight);
+        x.positive = builtinBinding(DECKGAMEPAD_ACTION_NAV_RIGHT);
         profile.axisBindings[GAMEPAD_AXIS_LEFT_X] = x;
     }
     {
         DeckGamepadAxisActionBinding y;
         y.hasNegative = true;
-        y.negative.actionId = QString::fromLatin1(DeckGamepadActionId::NavUp);
+        y.negative = builtinBinding(DECKGAMEPAD_ACTION_NAV_UP);
         y.hasPositive = true;
-        y.positive.actionId = QString::fromLatin1(DeckGamepadActionId::NavDown);
+        y.positive = builtinBinding(DECKGAMEPAD_ACTION_NAV_DOWN);
         profile.axisBindings[GAMEPAD_AXIS_LEFT_Y] = y;
     }
 
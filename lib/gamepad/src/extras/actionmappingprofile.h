@@ -7,6 +7,7 @@
 #pragma once
 
 #include <deckshell/deckgamepad/core/deckgamepad.h>
+#include <deckshell/deckgamepad/core/deckgamepadaction.h>
 
 #include <QtCore/QJsonObject>
 #include <QtCore/QMap>
@@ -16,6 +17,8 @@ DECKGAMEPAD_BEGIN_NAMESPACE
 
 struct DeckGamepadActionBinding {
     QString actionId; // 空字符串表示显式解绑
+    // 加载时 intern 的整数 id（DeckGamepadActionRegistry）；手工修改 actionId 后由 mapper 重新解析。
+    int numericId = DECKGAMEPAD_ACTION_INVALID;
 };
 
 struct DeckGamepadAxisActionBinding {
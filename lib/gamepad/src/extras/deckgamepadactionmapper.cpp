@@ -4,8 +4,11 @@
 
 #include "deckgamepadactionmapper.h"
 
+#include <QtCore/QMetaMethod>
 #include <QtCore/qmath.h>
 
+#include <algorithm>
+
 DECKGAMEPAD_BEGIN_NAMESPACE
 
 static double clamp01(double v)
@@ -29,7 +32,7 @@ DeckGamepadActionMapper::DeckGamepadActionMapper(QObject *parent)
 
     connect(&m_repeatDelayTimer, &QTimer::timeout, this, [this]() {
         emitRepeatTick();
-        if (m_repeatEnabled && m_repeatIntervalMs > 0 && !m_repeatActiveDirections.isEmpty()) {
+        if (m_repeatEnabled && m_repeatIntervalMs > 0 && m_repeatDirectionCount > 0) {
             m_repeatIntervalTimer.setInterval(qMax(1, m_repeatIntervalMs));
             m_repeatIntervalTimer.start();
         }
@@ -173,18 +176,17 @@ void DeckGamepadActionMapper::setRepeatIntervalMs(int intervalMs)
 void DeckGamepadActionMapper::reset()
 {
     stopRepeat();
-    m_repeatActiveDirections.clear();
+    m_repeatDirectionCount = 0;
     m_outUp = DirectionOutput{};
     m_outDown = DirectionOutput{};
     m_outLeft = DirectionOutput{};
     m_outRight = DirectionOutput{};
-    m_axisState.clear();
+    m_axisState.fill(AxisState{});
 
     // release all merged actions
-    const auto keys = m_actionPressed.keys();
-    for (const QString &k : keys) {
-        if (m_actionPressed.value(k)) {
-            setActionPressed(k, false, false, 0);
+    for (size_t actionId = 0; actionId < m_actionPressed.size(); ++actionId) {
+        if (m_actionPressed[actionId]) {
+            setActionPressed(static_cast<int>(actionId), false, false, 0);
         }
     }
 
@@ -221,47 +223,67 @@ void DeckGamepadActionMapper::applyActionMappingProfile(const ActionMappingProfi
         setRepeatEnabled(profile.repeat.enabled);
     }
 
-    m_buttonBindings.clear();
+    // 预置：内置 action 槽位（便于 reset 时统一 release）；自定义 actionId 在解析绑定时分配槽位。
+    ensureActionSlots(DECKGAMEPAD_ACTION_BUILTIN_COUNT);
+
+    m_buttonBindings.fill(DECKGAMEPAD_ACTION_INVALID);
     for (auto it = profile.buttonBindings.constBegin(); it != profile.buttonBindings.constEnd(); ++it) {
-        if (it.value().actionId.isEmpty()) {
+        if (it.key() < 0 || it.key() >= GAMEPAD_BUTTON_MAX) {
             continue;
         }
-        m_buttonBindings.insert(it.key(), it.value().actionId);
+        m_buttonBindings[static_cast<size_t>(it.key())] = resolveActionId(it.value());
     }
 
-    m_axisBindings.clear();
+    m_axisBindings.fill(AxisBinding{});
     for (auto it = profile.axisBindings.constBegin(); it != profile.axisBindings.constEnd(); ++it) {
+        if (it.key() < 0 || it.key() >= GAMEPAD_AXIS_MAX) {
+            continue;
+        }
+
         AxisBinding dst;
         dst.hasThreshold = it.value().hasThreshold;
         dst.threshold = it.value().threshold;
 
-        if (it.value().hasNegative && !it.value().negative.actionId.isEmpty()) {
-            dst.hasNegative = true;
-            dst.negativeActionId = it.value().negative.actionId;
+        if (it.value().hasNegative) {
+            dst.negativeActionId = resolveActionId(it.value().negative);
+            dst.hasNegative = dst.negativeActionId != DECKGAMEPAD_ACTION_INVALID;
         }
-        if (it.value().hasPositive && !it.value().positive.actionId.isEmpty()) {
-            dst.hasPositive = true;
-            dst.positiveActionId = it.value().positive.actionId;
+        if (it.value().hasPositive) {
+            dst.positiveActionId = resolveActionId(it.value().positive);
+            dst.hasPositive = dst.positiveActionId != DECKGAMEPAD_ACTION_INVALID;
         }
 
-        if (dst.hasThreshold || dst.hasNegative || dst.hasPositive) {
-            m_axisBindings.insert(it.key(), dst);
-        }
+        m_axisBindings[static_cast<size_t>(it.key())] = dst;
+    }
+}
+
+int DeckGamepadActionMapper::resolveActionId(const DeckGamepadActionBinding &binding)
+{
+    if (binding.actionId.isEmpty()) {
+        return DECKGAMEPAD_ACTION_INVALID;
     }
 
-    // 预置：初始化输出集合（便于 reset 时统一 release）
-    // 注意：此处仅初始化常用 actionId；动态 actionId 会在首次触发时自动加入。
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavUp), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavDown), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavLeft), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavRight), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavAccept), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavBack), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavMenu), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavTabNext), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavTabPrev), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavPageNext), false);
-    m_actionPressed.insert(QString::fromLatin1(DeckGamepadActionId::NavPagePrev), false);
+    // profile 加载时已 intern；仅在 numericId 缺失或与 actionId 不一致（手工改写）时重新 intern。
+    int actionId = binding.numericId;
+    if (actionId < 0 || DeckGamepadActionRegistry::name(actionId) != binding.actionId) {
+        actionId = DeckGamepadActionRegistry::intern(binding.actionId);
+    }
+    ensureActionSlots(actionId + 1);
+    return actionId;
+}
+
+void DeckGamepadActionMapper::ensureActionSlots(int count)
+{
+    const int oldCount = static_cast<int>(m_actionPressed.size());
+    if (count <= oldCount) {
+        return;
+    }
+
+    m_actionPressed.resize(static_cast<size_t>(count), 0);
+    m_actionNames.reserve(count);
+    for (int actionId = oldCount; actionId < count; ++actionId) {
+        m_actionNames.append(DeckGamepadActionRegistry::name(actionId));
+    }
 }
 
 void DeckGamepadActionMapper::processButton(GamepadButton button, bool pressed, int timeMs)
@@ -293,8 +315,11 @@ void DeckGamepadActionMapper::processButton(GamepadButton button, bool pressed,
         break;
     }
 
-    const QString actionId = m_buttonBindings.value(button);
-    if (actionId.isEmpty()) {
+    if (button < 0 || button >= GAMEPAD_BUTTON_MAX) {
+        return;
+    }
+    const int actionId = m_buttonBindings[static_cast<size_t>(button)];
+    if (actionId == DECKGAMEPAD_ACTION_INVALID) {
         return;
     }
     setActionPressed(actionId, pressed, repeated, timeMs);
@@ -319,7 +344,11 @@ void DeckGamepadActionMapper::processAxis(GamepadAxis axis, double value, int ti
         break;
     }
 
-    const AxisBinding binding = m_axisBindings.value(axis);
+    if (axis < 0 || axis >= GAMEPAD_AXIS_MAX) {
+        return;
+    }
+
+    const AxisBinding &binding = m_axisBindings[static_cast<size_t>(axis)];
     if (!binding.hasNegative && !binding.hasPositive) {
         return;
     }
@@ -327,7 +356,7 @@ void DeckGamepadActionMapper::processAxis(GamepadAxis axis, double value, int ti
     const double releaseThreshold = clamp01(binding.hasThreshold ? binding.threshold : m_deadzone);
     const double pressThreshold = clamp01(releaseThreshold + m_hysteresis);
 
-    AxisState &state = m_axisState[axis];
+    AxisState &state = m_axisState[static_cast<size_t>(axis)];
 
     const double v = qBound(-1.0, value, 1.0);
 
@@ -353,14 +382,14 @@ void DeckGamepadActionMapper::processAxis(GamepadAxis axis, double value, int ti
         }
     }
 
-    if (binding.hasNegative && !binding.negativeActionId.isEmpty() && nextNegative != state.negativeActive) {
+    if (binding.hasNegative && nextNegative != state.negativeActive) {
         state.negativeActive = nextNegative;
         setActionPressed(binding.negativeActionId, nextNegative, false, timeMs);
     } else {
         state.negativeActive = nextNegative;
     }
 
-    if (binding.hasPositive && !binding.positiveActionId.isEmpty() && nextPositive != state.positiveActive) {
+    if (binding.hasPositive && nextPositive != state.positiveActive) {
         state.positiveActive = nextPositive;
         setActionPressed(binding.positiveActionId, nextPositive, false, timeMs);
     } else {
@@ -368,22 +397,71 @@ void DeckGamepadActionMapper::processAxis(GamepadAxis axis, double value, int ti
     }
 }
 
-void DeckGamepadActionMapper::setActionPressed(const QString &actionId, bool pressed, bool repeated, int timeMs)
+void DeckGamepadActionMapper::processAxes(const QList<DeckGamepadAxisEvent> &events, int timeMs)
 {
-    const bool prev = m_actionPressed.value(actionId, false);
-    if (prev == pressed && !repeated) {
+    if (!m_enabled) {
+        return;
+    }
+
+    bool leftStickChanged = false;
+    for (const DeckGamepadAxisEvent &event : events) {
+        switch (event.axis) {
+        case GAMEPAD_AXIS_LEFT_X:
+            m_leftX = qBound(-1.0, event.value, 1.0);
+            leftStickChanged = true;
+            break;
+        case GAMEPAD_AXIS_LEFT_Y:
+            m_leftY = qBound(-1.0, event.value, 1.0);
+            leftStickChanged = true;
+            break;
+        default:
+            if (event.axis < static_cast<uint32_t>(GAMEPAD_AXIS_MAX)) {
+                processAxis(static_cast<GamepadAxis>(event.axis), event.value, timeMs);
+            }
+            break;
+        }
+    }
+
+    if (leftStickChanged) {
+        updateFromLeftStick(timeMs);
+    }
+}
+
+void DeckGamepadActionMapper::setActionPressed(int actionId, bool pressed, bool repeated, int timeMs)
+{
+    if (actionId < 0) {
         return;
     }
+    ensureActionSlots(actionId + 1);
 
-    m_actionPressed.insert(actionId, pressed);
+    const bool prev = m_actionPressed[static_cast<size_t>(actionId)] != 0;
+    if (prev == pressed && !repeated) {
+        return;
+    }
 
-    DeckGamepadActionEvent ev;
-    ev.actionId = actionId;
-    ev.pressed = pressed;
-    ev.repeated = repeated;
-    ev.timeMs = timeMs;
-    Q_EMIT actionEvent(ev);
-    Q_EMIT actionTriggered(actionId, pressed, repeated);
+    m_actionPressed[static_cast<size_t>(actionId)] = pressed ? 1 : 0;
+
+    // 字符串版信号仅在有连接时构造（兼容层）；整数 id 信号始终发出。
+    static const QMetaMethod actionEventSignal = QMetaMethod::fromSignal(&DeckGamepadActionMapper::actionEvent);
+    static const QMetaMethod actionTriggeredSignal = QMetaMethod::fromSignal(&DeckGamepadActionMapper::actionTriggered);
+    const bool wantsEvent = isSignalConnected(actionEventSignal);
+    const bool wantsTriggered = isSignalConnected(actionTriggeredSignal);
+    if (wantsEvent || wantsTriggered) {
+        const QString name = m_actionNames.at(actionId);
+        if (wantsEvent) {
+            DeckGamepadActionEvent ev;
+            ev.actionId = name;
+            ev.numericId = actionId;
+            ev.pressed = pressed;
+            ev.repeated = repeated;
+            ev.timeMs = timeMs;
+            Q_EMIT actionEvent(ev);
+        }
+        if (wantsTriggered) {
+            Q_EMIT actionTriggered(name, pressed, repeated);
+        }
+    }
+    Q_EMIT actionTriggeredId(actionId, pressed, repeated);
 }
 
 void DeckGamepadActionMapper::stopRepeat()
@@ -400,7 +478,7 @@ void DeckGamepadActionMapper::startRepeatIfConfigured()
     if (m_repeatIntervalMs <= 0) {
         return;
     }
-    if (m_repeatActiveDirections.isEmpty()) {
+    if (m_repeatDirectionCount == 0) {
         return;
     }
 
@@ -421,7 +499,7 @@ void DeckGamepadActionMapper::emitRepeatTick()
     if (!m_repeatEnabled) {
         return;
     }
-    if (m_repeatActiveDirections.isEmpty()) {
+    if (m_repeatDirectionCount == 0) {
         return;
     }
     if (m_repeatIntervalMs <= 0) {
@@ -432,8 +510,11 @@ void DeckGamepadActionMapper::emitRepeatTick()
     const bool repeated = true;
     const int timeMs = 0;
 
-    for (const QString &actionId : m_repeatActiveDirections) {
-        setActionPressed(actionId, pressed, repeated, timeMs);
+    // 拷贝一份：槽函数里改变方向状态不会影响本次 tick 的遍历。
+    const std::array<int, kMaxRepeatDirections> directions = m_repeatDirections;
+    const int count = m_repeatDirectionCount;
+    for (int i = 0; i < count; ++i) {
+        setActionPressed(directions[static_cast<size_t>(i)], pressed, repeated, timeMs);
     }
 }
 
@@ -444,8 +525,8 @@ void DeckGamepadActionMapper::updateFromDpad(int timeMs)
 
 void DeckGamepadActionMapper::updateFromLeftStick(int timeMs)
 {
-    const AxisBinding xBinding = m_axisBindings.value(GAMEPAD_AXIS_LEFT_X);
-    const AxisBinding yBinding = m_axisBindings.value(GAMEPAD_AXIS_LEFT_Y);
+    const AxisBinding &xBinding = m_axisBindings[GAMEPAD_AXIS_LEFT_X];
+    const AxisBinding &yBinding = m_axisBindings[GAMEPAD_AXIS_LEFT_Y];
 
     const double releaseThresholdX = clamp01(xBinding.hasThreshold ? xBinding.threshold : m_deadzone);
     const double releaseThresholdY = clamp01(yBinding.hasThreshold ? yBinding.threshold : m_deadzone);
@@ -562,25 +643,27 @@ void DeckGamepadActionMapper::updateFromLeftStick(int timeMs)
 
 void DeckGamepadActionMapper::updateMergedNavigation(int timeMs)
 {
-    const QString dpadUpId = m_buttonBindings.value(GAMEPAD_BUTTON_DPAD_UP);
-    const QString dpadDownId = m_buttonBindings.value(GAMEPAD_BUTTON_DPAD_DOWN);
-    const QString dpadLeftId = m_buttonBindings.value(GAMEPAD_BUTTON_DPAD_LEFT);
-    const QString dpadRightId = m_buttonBindings.value(GAMEPAD_BUTTON_DPAD_RIGHT);
+    constexpr int kNone = DECKGAMEPAD_ACTION_INVALID;
 
-    const AxisBinding stickX = m_axisBindings.value(GAMEPAD_AXIS_LEFT_X);
-    const AxisBinding stickY = m_axisBindings.value(GAMEPAD_AXIS_LEFT_Y);
+    const int dpadUpId = m_buttonBindings[GAMEPAD_BUTTON_DPAD_UP];
+    const int dpadDownId = m_buttonBindings[GAMEPAD_BUTTON_DPAD_DOWN];
+    const int dpadLeftId = m_buttonBindings[GAMEPAD_BUTTON_DPAD_LEFT];
+    const int dpadRightId = m_buttonBindings[GAMEPAD_BUTTON_DPAD_RIGHT];
 
-    const QString stickLeftId = stickX.hasNegative ? stickX.negativeActionId : QString{};
-    const QString stickRightId = stickX.hasPositive ? stickX.positiveActionId : QString{};
-    const QString stickUpId = stickY.hasNegative ? stickY.negativeActionId : QString{};
-    const QString stickDownId = stickY.hasPositive ? stickY.positiveActionId : QString{};
+    const AxisBinding &stickX = m_axisBindings[GAMEPAD_AXIS_LEFT_X];
+    const AxisBinding &stickY = m_axisBindings[GAMEPAD_AXIS_LEFT_Y];
+
+    const int stickLeftId = stickX.hasNegative ? stickX.negativeActionId : kNone;
+    const int stickRightId = stickX.hasPositive ? stickX.positiveActionId : kNone;
+    const int stickUpId = stickY.hasNegative ? stickY.negativeActionId : kNone;
+    const int stickDownId = stickY.hasPositive ? stickY.positiveActionId : kNone;
 
     const bool dpadActive =
-        (m_dpadUp && !dpadUpId.isEmpty()) || (m_dpadDown && !dpadDownId.isEmpty())
-        || (m_dpadLeft && !dpadLeftId.isEmpty()) || (m_dpadRight && !dpadRightId.isEmpty());
+        (m_dpadUp && dpadUpId != kNone) || (m_dpadDown && dpadDownId != kNone)
+        || (m_dpadLeft && dpadLeftId != kNone) || (m_dpadRight && dpadRightId != kNone);
     const bool stickActive =
-        (m_stickUp && !stickUpId.isEmpty()) || (m_stickDown && !stickDownId.isEmpty())
-        || (m_stickLeft && !stickLeftId.isEmpty()) || (m_stickRight && !stickRightId.isEmpty());
+        (m_stickUp && stickUpId != kNone) || (m_stickDown && stickDownId != kNone)
+        || (m_stickLeft && stickLeftId != kNone) || (m_stickRight && stickRightId != kNone);
 
     bool useDpad = false;
     if (m_navigationPriority == ActionMappingProfile::NavigationPriority::LeftStickOverDpad) {
@@ -589,19 +672,19 @@ void DeckGamepadActionMapper::updateMergedNavigation(int timeMs)
         useDpad = dpadActive;
     }
 
-    const bool nextUpPressed = useDpad ? (m_dpadUp && !dpadUpId.isEmpty()) : (m_stickUp && !stickUpId.isEmpty());
-    const bool nextDownPressed = useDpad ? (m_dpadDown && !dpadDownId.isEmpty()) : (m_stickDown && !stickDownId.isEmpty());
-    const bool nextLeftPressed = useDpad ? (m_dpadLeft && !dpadLeftId.isEmpty()) : (m_stickLeft && !stickLeftId.isEmpty());
-    const bool nextRightPressed = useDpad ? (m_dpadRight && !dpadRightId.isEmpty()) : (m_stickRight && !stickRightId.isEmpty());
+    const bool nextUpPressed = useDpad ? (m_dpadUp && dpadUpId != kNone) : (m_stickUp && stickUpId != kNone);
+    const bool nextDownPressed = useDpad ? (m_dpadDown && dpadDownId != kNone) : (m_stickDown && stickDownId != kNone);
+    const bool nextLeftPressed = useDpad ? (m_dpadLeft && dpadLeftId != kNone) : (m_stickLeft && stickLeftId != kNone);
+    const bool nextRightPressed = useDpad ? (m_dpadRight && dpadRightId != kNone) : (m_stickRight && stickRightId != kNone);
 
-    const QString nextUpId = useDpad ? dpadUpId : stickUpId;
-    const QString nextDownId = useDpad ? dpadDownId : stickDownId;
-    const QString nextLeftId = useDpad ? dpadLeftId : stickLeftId;
-    const QString nextRightId = useDpad ? dpadRightId : stickRightId;
+    const int nextUpId = useDpad ? dpadUpId : stickUpId;
+    const int nextDownId = useDpad ? dpadDownId : stickDownId;
+    const int nextLeftId = useDpad ? dpadLeftId : stickLeftId;
+    const int nextRightId = useDpad ? dpadRightId : stickRightId;
 
-    auto updateDirection = [this](DirectionOutput &out, const QString &nextId, bool pressed, int timeMs) {
+    auto updateDirection = [this](DirectionOutput &out, int nextId, bool pressed, int timeMs) {
         if (out.actionId != nextId) {
-            if (out.pressed && !out.actionId.isEmpty()) {
+            if (out.pressed && out.actionId != kNone) {
                 setActionPressed(out.actionId, false, false, timeMs);
             }
             out.actionId = nextId;
@@ -613,7 +696,7 @@ void DeckGamepadActionMapper::updateMergedNavigation(int timeMs)
         }
 
         out.pressed = pressed;
-        if (!out.actionId.isEmpty()) {
+        if (out.actionId != kNone) {
             setActionPressed(out.actionId, pressed, false, timeMs);
         }
     };
@@ -623,22 +706,28 @@ void DeckGamepadActionMapper::updateMergedNavigation(int timeMs)
     updateDirection(m_outLeft, nextLeftId, nextLeftPressed, timeMs);
     updateDirection(m_outRight, nextRightId, nextRightPressed, timeMs);
 
-    QSet<QString> nextRepeatDirections;
-    if (m_outUp.pressed && !m_outUp.actionId.isEmpty()) {
-        nextRepeatDirections.insert(m_outUp.actionId);
-    }
-    if (m_outDown.pressed && !m_outDown.actionId.isEmpty()) {
-        nextRepeatDirections.insert(m_outDown.actionId);
-    }
-    if (m_outLeft.pressed && !m_outLeft.actionId.isEmpty()) {
-        nextRepeatDirections.insert(m_outLeft.actionId);
-    }
-    if (m_outRight.pressed && !m_outRight.actionId.isEmpty()) {
-        nextRepeatDirections.insert(m_outRight.actionId);
-    }
-
-    if (m_repeatActiveDirections != nextRepeatDirections) {
-        m_repeatActiveDirections = nextRepeatDirections;
+    std::array<int, kMaxRepeatDirections> nextDirections{};
+    int nextCount = 0;
+    auto addRepeatDirection = [&nextDirections, &nextCount](const DirectionOutput &out) {
+        if (!out.pressed || out.actionId == kNone) {
+            return;
+        }
+        for (int i = 0; i < nextCount; ++i) {
+            if (nextDirections[static_cast<size_t>(i)] == out.actionId) {
+                return;
+            }
+        }
+        nextDirections[static_cast<size_t>(nextCount++)] = out.actionId;
+    };
+    addRepeatDirection(m_outUp);
+    addRepeatDirection(m_outDown);
+    addRepeatDirection(m_outLeft);
+    addRepeatDirection(m_outRight);
+
+    if (nextCount != m_repeatDirectionCount
+        || !std::equal(nextDirections.begin(), nextDirections.begin() + nextCount, m_repeatDirections.begin())) {
+        m_repeatDirections = nextDirections;
+        m_repeatDirectionCount = nextCount;
         stopRepeat();
         startRepeatIfConfigured();
     }
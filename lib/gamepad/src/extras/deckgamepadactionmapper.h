@@ -10,12 +10,14 @@
 #include <deckshell/deckgamepad/core/deckgamepad.h>
 #include <deckshell/deckgamepad/extras/actionmappingprofile.h>
 
-#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QObject>
-#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QTimer>
 
+#include <array>
+#include <vector>
+
 DECKGAMEPAD_BEGIN_NAMESPACE
 
 class DECKGAMEPAD_EXPORT DeckGamepadActionMapper final : public QObject
@@ -62,12 +64,16 @@ public:
 
     void processButton(GamepadButton button, bool pressed, int timeMs = 0);
     void processAxis(GamepadAxis axis, double value, int timeMs = 0);
+    // 同一设备帧内的多轴更新：左摇杆 X/Y 先全部写入再统一判定，避免对角输入被拆成两次判定。
+    void processAxes(const QList<DeckGamepadAxisEvent> &events, int timeMs = 0);
 
 Q_SIGNALS:
     void enabledChanged();
 
     void actionEvent(DeckGamepadActionEvent event);
     void actionTriggered(const QString &actionId, bool pressed, bool repeated);
+    // 整数 id 版本（DeckGamepadActionRegistry）：热路径推荐使用，避免字符串比较/拷贝。
+    void actionTriggeredId(int actionId, bool pressed, bool repeated);
 
 private:
     enum class StickLockAxis {
@@ -76,7 +82,9 @@ private:
         Vertical,
     };
 
-    void setActionPressed(const QString &actionId, bool pressed, bool repeated, int timeMs);
+    int resolveActionId(const DeckGamepadActionBinding &binding);
+    void ensureActionSlots(int count);
+    void setActionPressed(int actionId, bool pressed, bool repeated, int timeMs);
 
     void updateFromDpad(int timeMs);
     void updateFromLeftStick(int timeMs);
@@ -99,19 +107,20 @@ private:
     ActionMappingProfile::NavigationPriority m_navigationPriority = ActionMappingProfile::NavigationPriority::DpadOverLeftStick;
 
     struct AxisBinding {
-        QString negativeActionId;
-        QString positiveActionId;
+        int negativeActionId = DECKGAMEPAD_ACTION_INVALID;
+        int positiveActionId = DECKGAMEPAD_ACTION_INVALID;
         float threshold = 0.0f;
         bool hasNegative = false;
         bool hasPositive = false;
         bool hasThreshold = false;
     };
 
-    QHash<GamepadButton, QString> m_buttonBindings;
-    QHash<GamepadAxis, AxisBinding> m_axisBindings;
+    // 绑定/状态均为按枚举索引的平铺数组；actionId 为 DeckGamepadActionRegistry 整数 id。
+    std::array<int, GAMEPAD_BUTTON_MAX> m_buttonBindings{};
+    std::array<AxisBinding, GAMEPAD_AXIS_MAX> m_axisBindings{};
 
     struct DirectionOutput {
-        QString actionId;
+        int actionId = DECKGAMEPAD_ACTION_INVALID;
         bool pressed = false;
     };
 
@@ -124,11 +133,14 @@ private:
         bool negativeActive = false;
         bool positiveActive = false;
     };
-    QHash<GamepadAxis, AxisState> m_axisState;
+    std::array<AxisState, GAMEPAD_AXIS_MAX> m_axisState{};
 
     QTimer m_repeatDelayTimer;
     QTimer m_repeatIntervalTimer;
-    QSet<QString> m_repeatActiveDirections; // 当前处于“方向激活”的 actionId 集合（repeat tick 的目标）
+    // 当前处于“方向激活”的 actionId（repeat tick 的目标；按 up/down/left/right 顺序，已去重）
+    static constexpr int kMaxRepeatDirections = 4;
+    std::array<int, kMaxRepeatDirections> m_repeatDirections{};
+    int m_repeatDirectionCount = 0;
 
     // sources
     bool m_dpadUp = false;
@@ -144,8 +156,9 @@ private:
     bool m_stickRight = false;
     StickLockAxis m_stickLock = StickLockAxis::None;
 
-    // merged output state
-    QHash<QString, bool> m_actionPressed;
+    // merged output state（按整数 id 索引；m_actionNames 缓存兼容信号所需的字符串）
+    std::vector<quint8> m_actionPressed;
+    QList<QString> m_actionNames;
 };
 
 DECKGAMEPAD_END_NAMESPACE
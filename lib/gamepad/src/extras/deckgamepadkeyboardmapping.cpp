@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include <deckshell/deckgamepad/extras/deckgamepadkeyboardmapping.h>
+#include <deckshell/deckgamepad/extras/deckgamepaduinputkeyboard.h>
 
 #include <QDebug>
 #include <QFile>
@@ -53,6 +54,11 @@ DeckGamepadKeyboardMappingManager::DeckGamepadKeyboardMappingManager(QObject *pa
     , m_enabled(false)
 {
     qDebug() << "DeckGamepadKeyboardMappingManager created";
+
+    connect(this, &DeckGamepadKeyboardMappingManager::mappingChanged,
+            this, &DeckGamepadKeyboardMappingManager::publishUinputMappings);
+    connect(this, &DeckGamepadKeyboardMappingManager::enabledChanged,
+            this, &DeckGamepadKeyboardMappingManager::publishUinputMappings);
 }
 
 DeckGamepadKeyboardMappingManager::~DeckGamepadKeyboardMappingManager()
@@ -335,11 +341,41 @@ bool DeckGamepadKeyboardMappingManager::loadFromFile(const QString &path)
     return true;
 }
 
+void DeckGamepadKeyboardMappingManager::setUinputKeyboard(DeckGamepadUinputKeyboard *keyboard)
+{
+    if (m_uinputKeyboard == keyboard) {
+        return;
+    }
+
+    if (m_uinputKeyboard) {
+        m_uinputKeyboard->clearMappings();
+    }
+    m_uinputKeyboard = keyboard;
+    publishUinputMappings();
+}
+
+DeckGamepadUinputKeyboard *DeckGamepadKeyboardMappingManager::uinputKeyboard() const
+{
+    return m_uinputKeyboard;
+}
+
+void DeckGamepadKeyboardMappingManager::publishUinputMappings()
+{
+    if (!m_uinputKeyboard) {
+        return;
+    }
+
+    if (m_enabled) {
+        m_uinputKeyboard->setMappings(m_buttonMappings, m_axisMappings);
+    } else {
+        m_uinputKeyboard->clearMappings();
+    }
+}
+
 void DeckGamepadKeyboardMappingManager::emitKeyEvent(const KeyMapping &mapping, bool pressed)
 {
+    // 热路径：不在此处打日志。
     emit keyEvent(mapping.qtKey, mapping.modifiers, pressed);
-
-    qDebug() << "Key event:" << mapping.description << (pressed ? "pressed" : "released");
 }
 
 QString DeckGamepadKeyboardMappingManager::buttonToString(GamepadButton button) const
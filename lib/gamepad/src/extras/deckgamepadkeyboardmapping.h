@@ -8,6 +8,7 @@
 #include <QObject>
 #include <QHash>
 #include <QJsonObject>
+#include <QPointer>
 
 DECKGAMEPAD_BEGIN_NAMESPACE
 
@@ -41,7 +42,9 @@ struct AxisKeyMapping {
     static AxisKeyMapping fromJson(const QJsonObject &obj);
 };
 
-// 将手柄输入映射为键盘事件信号（本类不负责实际注入）。
+class DeckGamepadUinputKeyboard;
+
+// 将手柄输入映射为键盘事件信号；内核级注入由可选的 DeckGamepadUinputKeyboard 完成。
 class DeckGamepadKeyboardMappingManager : public QObject
 {
     Q_OBJECT
@@ -81,6 +84,11 @@ public:
 
     void clearAll();
 
+    // uinput 输出：映射/启用状态变化时把快照推送给 keyboard（禁用时推送空映射）。
+    // keyboard 自身在 backend 线程处理帧，不经过 processButton/processAxis。
+    void setUinputKeyboard(DeckGamepadUinputKeyboard *keyboard);
+    DeckGamepadUinputKeyboard *uinputKeyboard() const;
+
     // 序列化
 
     QJsonObject toJson() const;
@@ -97,6 +105,7 @@ Q_SIGNALS:
 
 private:
     void emitKeyEvent(const KeyMapping &mapping, bool pressed);
+    void publishUinputMappings();
     QString buttonToString(GamepadButton button) const;
     QString axisToString(GamepadAxis axis) const;
 
@@ -112,6 +121,8 @@ private:
         bool positiveActive = false;
     };
     QHash<GamepadAxis, AxisState> m_axisStates;
+
+    QPointer<DeckGamepadUinputKeyboard> m_uinputKeyboard;
 };
 
 DECKGAMEPAD_END_NAMESPACE
@@ -0,0 +1,598 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/extras/deckgamepaduinputkeyboard.h>
+
+#include <deckshell/deckgamepad/service/deckgamepadservice.h>
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QVarLengthArray>
+
+#include <Qt>
+
+#include <linux/input.h>
+#include <linux/uinput.h>
+
+#include <array>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+namespace {
+struct KeyCodeEntry {
+    int qtKey;
+    quint16 code;
+};
+
+// 主键区按 US 布局的物理位置；实际字符由合成器/客户端的键盘布局决定。
+constexpr KeyCodeEntry kKeyCodes[] = {
+    { Qt::Key_A, KEY_A }, { Qt::Key_B, KEY_B }, { Qt::Key_C, KEY_C }, { Qt::Key_D, KEY_D },
+    { Qt::Key_E, KEY_E }, { Qt::Key_F, KEY_F }, { Qt::Key_G, KEY_G }, { Qt::Key_H, KEY_H },
+    { Qt::Key_I, KEY_I }, { Qt::Key_J, KEY_J }, { Qt::Key_K, KEY_K }, { Qt::Key_L, KEY_L },
+    { Qt::Key_M, KEY_M }, { Qt::Key_N, KEY_N }, { Qt::Key_O, KEY_O }, { Qt::Key_P, KEY_P },
+    { Qt::Key_Q, KEY_Q }, { Qt::Key_R, KEY_R }, { Qt::Key_S, KEY_S }, { Qt::Key_T, KEY_T },
+    { Qt::Key_U, KEY_U }, { Qt::Key_V, KEY_V }, { Qt::Key_W, KEY_W }, { Qt::Key_X, KEY_X },
+    { Qt::Key_Y, KEY_Y }, { Qt::Key_Z, KEY_Z },
+    { Qt::Key_0, KEY_0 }, { Qt::Key_1, KEY_1 }, { Qt::Key_2, KEY_2 }, { Qt::Key_3, KEY_3 },
+    { Qt::Key_4, KEY_4 }, { Qt::Key_5, KEY_5 }, { Qt::Key_6, KEY_6 }, { Qt::Key_7, KEY_7 },
+    { Qt::Key_8, KEY_8 }, { Qt::Key_9, KEY_9 },
+    { Qt::Key_F1, KEY_F1 }, { Qt::Key_F2, KEY_F2 }, { Qt::Key_F3, KEY_F3 }, { Qt::Key_F4, KEY_F4 },
+    { Qt::Key_F5, KEY_F5 }, { Qt::Key_F6, KEY_F6 }, { Qt::Key_F7, KEY_F7 }, { Qt::Key_F8, KEY_F8 },
+    { Qt::Key_F9, KEY_F9 }, { Qt::Key_F10, KEY_F10 }, { Qt::Key_F11, KEY_F11 }, { Qt::Key_F12, KEY_F12 },
+    { Qt::Key_Escape, KEY_ESC },
+    { Qt::Key_Tab, KEY_TAB },
+    { Qt::Key_Backtab, KEY_TAB },
+    { Qt::Key_Backspace, KEY_BACKSPACE },
+    { Qt::Key_Return, KEY_ENTER },
+    { Qt::Key_Enter, KEY_KPENTER },
+    { Qt::Key_Space, KEY_SPACE },
+    { Qt::Key_Insert, KEY_INSERT },
+    { Qt::Key_Delete, KEY_DELETE },
+    { Qt::Key_Pause, KEY_PAUSE },
+    { Qt::Key_Print, KEY_SYSRQ },
+    { Qt::Key_Home, KEY_HOME },
+    { Qt::Key_End, KEY_END },
+    { Qt::Key_PageUp, KEY_PAGEUP },
+    { Qt::Key_PageDown, KEY_PAGEDOWN },
+    { Qt::Key_Left, KEY_LEFT },
+    { Qt::Key_Up, KEY_UP },
+    { Qt::Key_Right, KEY_RIGHT },
+    { Qt::Key_Down, KEY_DOWN },
+    { Qt::Key_Shift, KEY_LEFTSHIFT },
+    { Qt::Key_Control, KEY_LEFTCTRL },
+    { Qt::Key_Alt, KEY_LEFTALT },
+    { Qt::Key_Meta, KEY_LEFTMETA },
+    { Qt::Key_Menu, KEY_COMPOSE },
+    { Qt::Key_CapsLock, KEY_CAPSLOCK },
+    { Qt::Key_NumLock, KEY_NUMLOCK },
+    { Qt::Key_ScrollLock, KEY_SCROLLLOCK },
+    { Qt::Key_Minus, KEY_MINUS },
+    { Qt::Key_Equal, KEY_EQUAL },
+    { Qt::Key_BracketLeft, KEY_LEFTBRACE },
+    { Qt::Key_BracketRight, KEY_RIGHTBRACE },
+    { Qt::Key_Backslash, KEY_BACKSLASH },
+    { Qt::Key_Semicolon, KEY_SEMICOLON },
+    { Qt::Key_Apostrophe, KEY_APOSTROPHE },
+    { Qt::Key_QuoteLeft, KEY_GRAVE },
+    { Qt::Key_Comma, KEY_COMMA },
+    { Qt::Key_Period, KEY_DOT },
+    { Qt::Key_Slash, KEY_SLASH },
+    { Qt::Key_Back, KEY_BACK },
+    { Qt::Key_Forward, KEY_FORWARD },
+    { Qt::Key_VolumeUp, KEY_VOLUMEUP },
+    { Qt::Key_VolumeDown, KEY_VOLUMEDOWN },
+    { Qt::Key_VolumeMute, KEY_MUTE },
+    { Qt::Key_MediaPlay, KEY_PLAYPAUSE },
+    { Qt::Key_MediaNext, KEY_NEXTSONG },
+    { Qt::Key_MediaPrevious, KEY_PREVIOUSSONG },
+};
+
+// Qt::KeypadModifier 下的小键盘按键。
+constexpr KeyCodeEntry kKeypadCodes[] = {
+    { Qt::Key_0, KEY_KP0 }, { Qt::Key_1, KEY_KP1 }, { Qt::Key_2, KEY_KP2 }, { Qt::Key_3, KEY_KP3 },
+    { Qt::Key_4, KEY_KP4 }, { Qt::Key_5, KEY_KP5 }, { Qt::Key_6, KEY_KP6 }, { Qt::Key_7, KEY_KP7 },
+    { Qt::Key_8, KEY_KP8 }, { Qt::Key_9, KEY_KP9 },
+    { Qt::Key_Plus, KEY_KPPLUS },
+    { Qt::Key_Minus, KEY_KPMINUS },
+    { Qt::Key_Asterisk, KEY_KPASTERISK },
+    { Qt::Key_Slash, KEY_KPSLASH },
+    { Qt::Key_Period, KEY_KPDOT },
+    { Qt::Key_Enter, KEY_KPENTER },
+    { Qt::Key_Return, KEY_KPENTER },
+};
+
+struct ModifierEntry {
+    int qtModifier;
+    quint16 code;
+};
+
+// 修饰键按下顺序；松开按逆序。
+constexpr ModifierEntry kModifiers[] = {
+    { Qt::ControlModifier, KEY_LEFTCTRL },
+    { Qt::AltModifier, KEY_LEFTALT },
+    { Qt::ShiftModifier, KEY_LEFTSHIFT },
+    { Qt::MetaModifier, KEY_LEFTMETA },
+};
+constexpr int kModifierCount = int(sizeof(kModifiers) / sizeof(kModifiers[0]));
+
+struct Binding {
+    quint16 code = 0;
+    quint8 modifiers = 0; // kModifiers 下标位
+
+    bool isValid() const { return code != 0; }
+};
+
+struct AxisBinding {
+    Binding negative;
+    Binding positive;
+    float threshold = 0.5f;
+};
+
+struct DeviceKeyState {
+    quint32 buttons = 0;      // 已按下（并已输出）的 GamepadButton 位
+    quint8 negativeAxes = 0;  // 已越过负向阈值的 GamepadAxis 位
+    quint8 positiveAxes = 0;
+    int hat0 = GAMEPAD_HAT_CENTER;
+};
+
+using KeyChangeBuffer = QVarLengthArray<DeckGamepadKeyboardKeyChange, 32>;
+
+static_assert(GAMEPAD_BUTTON_MAX <= 32, "DeviceKeyState::buttons is a 32-bit mask");
+static_assert(GAMEPAD_AXIS_MAX <= 8, "DeviceKeyState axis masks are 8-bit");
+
+Binding toBinding(const KeyMapping &mapping)
+{
+    Binding binding;
+    if (!mapping.isValid()) {
+        return binding;
+    }
+    binding.code = quint16(DeckGamepadUinputKeyboard::linuxKeyCode(mapping.qtKey, mapping.modifiers));
+    if (!binding.isValid()) {
+        return binding;
+    }
+    for (int i = 0; i < kModifierCount; ++i) {
+        // 映射到修饰键本身时不重复按下同一修饰键。
+        if ((mapping.modifiers & kModifiers[i].qtModifier) && kModifiers[i].code != binding.code) {
+            binding.modifiers |= quint8(1u << i);
+        }
+    }
+    return binding;
+}
+} // namespace
+
+struct DeckGamepadUinputKeyboard::State {
+    QMutex mutex;
+    int fd = -1;
+    Output output;
+
+    std::array<Binding, GAMEPAD_BUTTON_MAX> buttons{};
+    std::array<AxisBinding, GAMEPAD_AXIS_MAX> axes{};
+    std::array<quint16, KEY_CNT> keyRefs{};
+    QHash<int, DeviceKeyState> devices;
+
+    quint64 reportCount = 0;
+    quint64 keyEventCount = 0;
+
+    void pressKey(quint16 code, KeyChangeBuffer &changes)
+    {
+        if (keyRefs[code]++ == 0) {
+            changes.append(DeckGamepadKeyboardKeyChange{ code, true });
+        }
+    }
+
+    void releaseKey(quint16 code, KeyChangeBuffer &changes)
+    {
+        if (keyRefs[code] > 0 && --keyRefs[code] == 0) {
+            changes.append(DeckGamepadKeyboardKeyChange{ code, false });
+        }
+    }
+
+    void press(const Binding &binding, KeyChangeBuffer &changes)
+    {
+        for (int i = 0; i < kModifierCount; ++i) {
+            if (binding.modifiers & (1u << i)) {
+                pressKey(kModifiers[i].code, changes);
+            }
+        }
+        pressKey(binding.code, changes);
+    }
+
+    void release(const Binding &binding, KeyChangeBuffer &changes)
+    {
+        releaseKey(binding.code, changes);
+        for (int i = kModifierCount - 1; i >= 0; --i) {
+            if (binding.modifiers & (1u << i)) {
+                releaseKey(kModifiers[i].code, changes);
+            }
+        }
+    }
+
+    void setButton(DeviceKeyState &device, int button, bool pressed, KeyChangeBuffer &changes)
+    {
+        if (button < 0 || button >= GAMEPAD_BUTTON_MAX) {
+            return;
+        }
+        const quint32 bit = 1u << button;
+        const Binding &binding = buttons[size_t(button)];
+        if (pressed == bool(device.buttons & bit) || !binding.isValid()) {
+            return;
+        }
+        if (pressed) {
+            device.buttons |= bit;
+            press(binding, changes);
+        } else {
+            device.buttons &= ~bit;
+            release(binding, changes);
+        }
+    }
+
+    void setAxis(DeviceKeyState &device, int axis, double value, KeyChangeBuffer &changes)
+    {
+        if (axis < 0 || axis >= GAMEPAD_AXIS_MAX) {
+            return;
+        }
+        const AxisBinding &binding = axes[size_t(axis)];
+        const quint8 bit = quint8(1u << axis);
+
+        const bool negative = binding.negative.isValid() && value < -binding.threshold;
+        if (negative != bool(device.negativeAxes & bit)) {
+            if (negative) {
+                device.negativeAxes |= bit;
+                press(binding.negative, changes);
+            } else {
+                device.negativeAxes &= quint8(~bit);
+                release(binding.negative, changes);
+            }
+        }
+
+        const bool positive = binding.positive.isValid() && value > binding.threshold;
+        if (positive != bool(device.positiveAxes & bit)) {
+            if (positive) {
+                device.positiveAxes |= bit;
+                press(binding.positive, changes);
+            } else {
+                device.positiveAxes &= quint8(~bit);
+                release(binding.positive, changes);
+            }
+        }
+    }
+
+    void setHat0(DeviceKeyState &device, int value, KeyChangeBuffer &changes)
+    {
+        const int previous = device.hat0;
+        device.hat0 = value;
+        auto update = [&](int button, int mask) {
+            if ((previous & mask) != (value & mask)) {
+                setButton(device, button, value & mask, changes);
+            }
+        };
+        update(GAMEPAD_BUTTON_DPAD_UP, GAMEPAD_HAT_UP);
+        update(GAMEPAD_BUTTON_DPAD_DOWN, GAMEPAD_HAT_DOWN);
+        update(GAMEPAD_BUTTON_DPAD_LEFT, GAMEPAD_HAT_LEFT);
+        update(GAMEPAD_BUTTON_DPAD_RIGHT, GAMEPAD_HAT_RIGHT);
+    }
+
+    void releaseDevice(DeviceKeyState &device, KeyChangeBuffer &changes)
+    {
+        for (int button = 0; button < GAMEPAD_BUTTON_MAX; ++button) {
+            setButton(device, button, false, changes);
+        }
+        for (int axis = 0; axis < GAMEPAD_AXIS_MAX; ++axis) {
+            setAxis(device, axis, 0.0, changes);
+        }
+        device.hat0 = GAMEPAD_HAT_CENTER;
+    }
+
+    void releaseAll(KeyChangeBuffer &changes)
+    {
+        for (DeviceKeyState &device : devices) {
+            releaseDevice(device, changes);
+        }
+        devices.clear();
+    }
+
+    void processFrame(int deviceId, const DeckGamepadFrameEvent &frame)
+    {
+        KeyChangeBuffer changes;
+        DeviceKeyState &device = devices[deviceId];
+        for (const DeckGamepadButtonEvent &event : frame.buttons) {
+            setButton(device, int(event.button), event.pressed, changes);
+        }
+        for (const DeckGamepadAxisEvent &event : frame.axes) {
+            setAxis(device, int(event.axis), event.value, changes);
+        }
+        for (const DeckGamepadHatEvent &event : frame.hats) {
+            if (event.hat == 0) {
+                setHat0(device, event.value, changes);
+            }
+        }
+        flush(changes);
+    }
+
+    // 一批变化 = 一次 write()：全部 EV_KEY 后接单个 SYN_REPORT。
+    void flush(const KeyChangeBuffer &changes)
+    {
+        if (changes.isEmpty()) {
+            return;
+        }
+
+        bool ok = false;
+        if (output) {
+            ok = output(changes.constData(), int(changes.size()));
+        } else if (fd >= 0) {
+            QVarLengthArray<input_event, 33> events;
+            for (const DeckGamepadKeyboardKeyChange &change : changes) {
+                input_event ev = {};
+                ev.type = EV_KEY;
+                ev.code = change.code;
+                ev.value = change.pressed ? 1 : 0;
+                events.append(ev);
+            }
+            input_event syn = {};
+            syn.type = EV_SYN;
+            syn.code = SYN_REPORT;
+            events.append(syn);
+
+            const size_t bytes = size_t(events.size()) * sizeof(input_event);
+            ssize_t wrote = -1;
+            do {
+                wrote = ::write(fd, events.constData(), bytes);
+            } while (wrote < 0 && errno == EINTR);
+            ok = wrote == ssize_t(bytes);
+        }
+
+        if (ok) {
+            ++reportCount;
+            keyEventCount += quint64(changes.size());
+        }
+    }
+};
+
+DeckGamepadUinputKeyboard::DeckGamepadUinputKeyboard(QObject *parent)
+    : QObject(parent)
+    , m_state(std::make_shared<State>())
+{
+}
+
+DeckGamepadUinputKeyboard::~DeckGamepadUinputKeyboard()
+{
+    detach();
+    close();
+}
+
+bool DeckGamepadUinputKeyboard::open(QString *errorString)
+{
+    auto fail = [errorString](int fd, const char *step) {
+        const int err = errno;
+        if (errorString) {
+            *errorString = QStringLiteral("uinput %1 failed: %2").arg(QLatin1String(step), QString::fromLocal8Bit(strerror(err)));
+        }
+        if (fd >= 0) {
+            (void)::close(fd);
+        }
+        return false;
+    };
+
+    QMutexLocker locker(&m_state->mutex);
+    if (m_state->fd >= 0) {
+        return true;
+    }
+
+    const int fd = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return fail(-1, "open");
+    }
+
+    if (ioctl(fd, UI_SET_EVBIT, EV_KEY) < 0 || ioctl(fd, UI_SET_EVBIT, EV_SYN) < 0) {
+        return fail(fd, "UI_SET_EVBIT");
+    }
+
+    // 声明全部可转换按键：映射替换时无需重建设备。
+    auto enableKey = [fd](int code) { return ioctl(fd, UI_SET_KEYBIT, code) >= 0; };
+    for (const KeyCodeEntry &entry : kKeyCodes) {
+        if (!enableKey(entry.code)) {
+            return fail(fd, "UI_SET_KEYBIT");
+        }
+    }
+    for (const KeyCodeEntry &entry : kKeypadCodes) {
+        if (!enableKey(entry.code)) {
+            return fail(fd, "UI_SET_KEYBIT");
+        }
+    }
+
+    static const char kDeviceName[] = "DeckShell Gamepad Keyboard";
+#ifdef UI_DEV_SETUP
+    struct uinput_setup setup = {};
+    (void)snprintf(setup.name, sizeof(setup.name), "%s", kDeviceName);
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.version = 1;
+    const bool setupOk = ioctl(fd, UI_DEV_SETUP, &setup) >= 0;
+#else
+    const bool setupOk = false;
+#endif
+    if (!setupOk) {
+        // 旧内核（< 4.5）：写 uinput_user_dev。
+        struct uinput_user_dev uidev = {};
+        (void)snprintf(uidev.name, sizeof(uidev.name), "%s", kDeviceName);
+        uidev.id.bustype = BUS_VIRTUAL;
+        uidev.id.version = 1;
+        if (::write(fd, &uidev, sizeof(uidev)) != ssize_t(sizeof(uidev))) {
+            return fail(fd, "device setup");
+        }
+    }
+
+    if (ioctl(fd, UI_DEV_CREATE) < 0) {
+        return fail(fd, "UI_DEV_CREATE");
+    }
+
+    m_state->fd = fd;
+    return true;
+}
+
+void DeckGamepadUinputKeyboard::close()
+{
+    QMutexLocker locker(&m_state->mutex);
+    if (m_state->fd < 0) {
+        return;
+    }
+
+    KeyChangeBuffer changes;
+    m_state->releaseAll(changes);
+    m_state->flush(changes);
+
+    (void)ioctl(m_state->fd, UI_DEV_DESTROY);
+    (void)::close(m_state->fd);
+    m_state->fd = -1;
+}
+
+bool DeckGamepadUinputKeyboard::isOpen() const
+{
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->fd >= 0;
+}
+
+void DeckGamepadUinputKeyboard::setOutput(Output output)
+{
+    QMutexLocker locker(&m_state->mutex);
+    m_state->output = std::move(output);
+}
+
+void DeckGamepadUinputKeyboard::setMappings(const QHash<GamepadButton, KeyMapping> &buttons,
+                                            const QHash<GamepadAxis, AxisKeyMapping> &axes)
+{
+    std::array<Binding, GAMEPAD_BUTTON_MAX> buttonBindings{};
+    for (auto it = buttons.constBegin(); it != buttons.constEnd(); ++it) {
+        if (it.key() >= 0 && it.key() < GAMEPAD_BUTTON_MAX) {
+            buttonBindings[size_t(it.key())] = toBinding(it.value());
+        }
+    }
+
+    std::array<AxisBinding, GAMEPAD_AXIS_MAX> axisBindings{};
+    for (auto it = axes.constBegin(); it != axes.constEnd(); ++it) {
+        if (it.key() >= 0 && it.key() < GAMEPAD_AXIS_MAX) {
+            AxisBinding &binding = axisBindings[size_t(it.key())];
+            binding.negative = toBinding(it.value().negative);
+            binding.positive = toBinding(it.value().positive);
+            binding.threshold = it.value().threshold;
+        }
+    }
+
+    QMutexLocker locker(&m_state->mutex);
+    // 先按旧映射释放：已按下的按键必须用按下时的绑定松开。
+    KeyChangeBuffer changes;
+    m_state->releaseAll(changes);
+    m_state->flush(changes);
+    m_state->buttons = buttonBindings;
+    m_state->axes = axisBindings;
+}
+
+void DeckGamepadUinputKeyboard::clearMappings()
+{
+    setMappings({}, {});
+}
+
+void DeckGamepadUinputKeyboard::processFrame(int deviceId, const DeckGamepadFrameEvent &frame)
+{
+    QMutexLocker locker(&m_state->mutex);
+    m_state->processFrame(deviceId, frame);
+}
+
+void DeckGamepadUinputKeyboard::releaseDevice(int deviceId)
+{
+    QMutexLocker locker(&m_state->mutex);
+    auto it = m_state->devices.find(deviceId);
+    if (it == m_state->devices.end()) {
+        return;
+    }
+
+    KeyChangeBuffer changes;
+    m_state->releaseDevice(it.value(), changes);
+    m_state->devices.erase(it);
+    m_state->flush(changes);
+}
+
+void DeckGamepadUinputKeyboard::releaseAll()
+{
+    QMutexLocker locker(&m_state->mutex);
+    KeyChangeBuffer changes;
+    m_state->releaseAll(changes);
+    m_state->flush(changes);
+}
+
+bool DeckGamepadUinputKeyboard::attach(DeckGamepadService *service)
+{
+    detach();
+    if (!service) {
+        return false;
+    }
+
+    // tap 持有 State 的共享引用：backend 线程上的最后一次调用可晚于本对象析构。
+    std::shared_ptr<State> state = m_state;
+    const bool ok = service->setFrameTap([state](int deviceId, const DeckGamepadFrameEvent &frame) {
+        QMutexLocker locker(&state->mutex);
+        state->processFrame(deviceId, frame);
+    });
+    if (!ok) {
+        service->setFrameTap({});
+        return false;
+    }
+
+    m_service = service;
+    m_disconnectConnection = connect(service,
+                                     &DeckGamepadService::gamepadDisconnected,
+                                     this,
+                                     &DeckGamepadUinputKeyboard::releaseDevice);
+    return true;
+}
+
+void DeckGamepadUinputKeyboard::detach()
+{
+    if (m_disconnectConnection) {
+        disconnect(m_disconnectConnection);
+        m_disconnectConnection = {};
+    }
+    if (m_service) {
+        m_service->setFrameTap({});
+    }
+    m_service.clear();
+    releaseAll();
+}
+
+int DeckGamepadUinputKeyboard::linuxKeyCode(int qtKey, int modifiers)
+{
+    if (modifiers & Qt::KeypadModifier) {
+        for (const KeyCodeEntry &entry : kKeypadCodes) {
+            if (entry.qtKey == qtKey) {
+                return entry.code;
+            }
+        }
+    }
+    for (const KeyCodeEntry &entry : kKeyCodes) {
+        if (entry.qtKey == qtKey) {
+            return entry.code;
+        }
+    }
+    return 0;
+}
+
+quint64 DeckGamepadUinputKeyboard::reportCount() const
+{
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->reportCount;
+}
+
+quint64 DeckGamepadUinputKeyboard::keyEventCount() const
+{
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->keyEventCount;
+}
+
+DECKGAMEPAD_END_NAMESPACE
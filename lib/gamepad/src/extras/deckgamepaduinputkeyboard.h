@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// uinput 虚拟键盘：把键盘映射（按键/轴阈值）直接转换为内核按键事件，
+// 对任意应用（含 XWayland 游戏）生效，无需宿主进程自行合成 QKeyEvent。
+
+#pragma once
+
+#include <deckshell/deckgamepad/extras/deckgamepadkeyboardmapping.h>
+
+#include <QtCore/QHash>
+#include <QtCore/QMetaObject>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+
+#include <functional>
+#include <memory>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+class DeckGamepadService;
+
+// 单个内核按键变化（code 为 Linux KEY_*）。
+struct DeckGamepadKeyboardKeyChange {
+    quint16 code = 0;
+    bool pressed = false;
+};
+
+/**
+ * @brief uinput 虚拟键盘输出
+ *
+ * - processFrame() 线程安全，通常由 backend IO 线程经帧旁路（attach()）直接调用，不经过 Qt 事件循环。
+ * - 一个设备帧内的全部按键变化合成一次 write()，以单个 SYN_REPORT 结尾。
+ * - 多设备/多映射共用同一按键时按引用计数合并：首次按下才输出按下，最后一次松开才输出松开。
+ * - 映射替换、断开设备、detach/close 时释放对应的已按下按键，不留卡键。
+ */
+class DECKGAMEPAD_EXPORT DeckGamepadUinputKeyboard : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 返回 false 表示本批次写出失败（不影响内部按键状态）。
+    using Output = std::function<bool(const DeckGamepadKeyboardKeyChange *changes, int count)>;
+
+    explicit DeckGamepadUinputKeyboard(QObject *parent = nullptr);
+    ~DeckGamepadUinputKeyboard() override;
+
+    // 创建 /dev/uinput 虚拟键盘（声明 linuxKeyCode() 支持的全部按键）；失败时返回 false。
+    bool open(QString *errorString = nullptr);
+    void close();
+    bool isOpen() const;
+
+    // 替换输出端（测试或自定义注入）；设置非空 Output 后不再写 uinput。
+    void setOutput(Output output);
+
+    // 映射快照（通常由 DeckGamepadKeyboardMappingManager 推送）；替换前先释放全部已按下的按键。
+    void setMappings(const QHash<GamepadButton, KeyMapping> &buttons,
+                     const QHash<GamepadAxis, AxisKeyMapping> &axes);
+    void clearMappings();
+
+    // 可在任意线程调用；hat 0 按 D-pad 按键处理。
+    void processFrame(int deviceId, const DeckGamepadFrameEvent &frame);
+    void releaseDevice(int deviceId);
+    void releaseAll();
+
+    // 安装为 service 的帧旁路，并在设备断开时释放其按键；provider 不支持帧旁路时返回 false。
+    bool attach(DeckGamepadService *service);
+    void detach();
+
+    // Qt::Key_*（Qt::KeypadModifier 选择小键盘）→ Linux KEY_*；不支持时返回 0。
+    static int linuxKeyCode(int qtKey, int modifiers = 0);
+
+    // 统计：写出的 SYN_REPORT 批次数 / 按键事件数。
+    quint64 reportCount() const;
+    quint64 keyEventCount() const;
+
+private:
+    struct State;
+
+    std::shared_ptr<State> m_state;
+    QPointer<DeckGamepadService> m_service;
+    QMetaObject::Connection m_disconnectConnection;
+};
+
+DECKGAMEPAD_END_NAMESPACE
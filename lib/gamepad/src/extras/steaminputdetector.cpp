@@ -2,10 +2,10 @@
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include <deckshell/deckgamepad/extras/steaminputdetector.h>
+#include <deckshell/deckgamepad/extras/steamprocesswatcher_p.h>
 
 #include <QDir>
 #include <QFile>
-#include <QFileInfo>
 #include <QProcess>
 #include <QStandardPaths>
 #include <QTextStream>
@@ -19,8 +19,16 @@ DECKGAMEPAD_BEGIN_NAMESPACE
 SteamInputDetector::SteamInputDetector(QObject *parent)
     : QObject(parent)
     , m_detectTimer(new QTimer(this))
+    , m_processWatcher(new SteamProcessWatcher(this))
 {
+    m_processWatcher->setProcessNames(getSteamProcessNames());
+    // 先建立初始快照：未开启自动检测、未调用 detectSteamInput() 时查询同样反映当前进程。
+    m_processWatcher->refresh();
     connect(m_detectTimer, &QTimer::timeout, this, &SteamInputDetector::onAutoDetectTimer);
+    connect(m_processWatcher,
+            &SteamProcessWatcher::steamRunningChanged,
+            this,
+            &SteamInputDetector::onSteamRunningChanged);
 }
 
 SteamInputDetector::~SteamInputDetector()
@@ -60,37 +68,11 @@ SteamInputDetector::DetectionResult SteamInputDetector::detectSteamInput()
 
 bool SteamInputDetector::isSteamProcessRunning() const
 {
-    QDir procDir(QStringLiteral("/proc"));
-    if (!procDir.exists()) {
-        return false;
-    }
-
-    const QStringList steamProcs = getSteamProcessNames();
-    const QFileInfoList entries = procDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-
-    for (const QFileInfo &entry : entries) {
-        bool ok = false;
-        const int pid = entry.fileName().toInt(&ok);
-        if (!ok) {
-            continue;
-        }
-
-        QFile cmdlineFile(QStringLiteral("/proc/%1/cmdline").arg(pid));
-        if (!cmdlineFile.open(QIODevice::ReadOnly)) {
-            continue;
-        }
-
-        QString cmdline = QString::fromLatin1(cmdlineFile.readAll());
-        cmdline.replace(QLatin1Char('\0'), QLatin1Char(' '));
-
-        for (const QString &procName : steamProcs) {
-            if (cmdline.contains(procName, Qt::CaseInsensitive)) {
-                return true;
-            }
-        }
+    // 观察器未启动（自动检测关闭）时没有事件来源，先增量刷新一次（只检查新出现的 pid）。
+    if (m_processWatcher->mode() == SteamProcessWatcher::Mode::Idle) {
+        m_processWatcher->refresh();
     }
-
-    return false;
+    return m_processWatcher->isSteamRunning();
 }
 
 bool SteamInputDetector::hasSteamEnvironment() const
@@ -113,6 +95,10 @@ bool SteamInputDetector::hasSteamEnvironment() const
 
 bool SteamInputDetector::checkDeviceConflict(const QString &devicePath) const
 {
+    if (!isSteamProcessRunning()) {
+        return false;
+    }
+
     const int fd = open(devicePath.toUtf8().constData(), O_RDONLY | O_NONBLOCK);
     if (fd < 0) {
         return errno == EBUSY;
@@ -150,39 +136,7 @@ QStringList SteamInputDetector::steamProcesses() const
     if (!isSteamProcessRunning()) {
         return {};
     }
-
-    QStringList foundProcesses;
-    const QStringList steamProcs = getSteamProcessNames();
-
-    QDir procDir(QStringLiteral("/proc"));
-    if (!procDir.exists()) {
-        return {};
-    }
-
-    const QFileInfoList entries = procDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QFileInfo &entry : entries) {
-        bool ok = false;
-        const int pid = entry.fileName().toInt(&ok);
-        if (!ok) {
-            continue;
-        }
-
-        QFile cmdlineFile(QStringLiteral("/proc/%1/cmdline").arg(pid));
-        if (!cmdlineFile.open(QIODevice::ReadOnly)) {
-            continue;
-        }
-
-        QString cmdline = QString::fromLatin1(cmdlineFile.readAll());
-        cmdline.replace(QLatin1Char('\0'), QLatin1Char(' '));
-
-        for (const QString &procName : steamProcs) {
-            if (cmdline.contains(procName, Qt::CaseInsensitive) && !foundProcesses.contains(procName)) {
-                foundProcesses << procName;
-            }
-        }
-    }
-
-    return foundProcesses;
+    return m_processWatcher->matchedNames();
 }
 
 QString SteamInputDetector::detectionResultToString(DetectionResult result) const
@@ -212,12 +166,20 @@ void SteamInputDetector::setAutoDetect(bool enable)
     }
 
     if (enable) {
-        m_detectTimer->start(m_autoDetectInterval * 1000);
-        detectSteamInput();
+        // proc connector 可用时完全事件驱动；否则按间隔增量扫描。
+        const bool wasRunning = m_processWatcher->isSteamRunning();
+        if (m_processWatcher->start() == SteamProcessWatcher::Mode::Polling) {
+            m_detectTimer->start(m_autoDetectInterval * 1000);
+        }
+        // 首次全量扫描改变状态时已由 onSteamRunningChanged 检测过。
+        if (m_processWatcher->isSteamRunning() == wasRunning) {
+            detectSteamInput();
+        }
         return;
     }
 
     m_detectTimer->stop();
+    m_processWatcher->stop();
 }
 
 void SteamInputDetector::setAutoDetectInterval(int seconds)
@@ -262,10 +224,16 @@ QString SteamInputDetector::getConflictAdvice() const
 
 void SteamInputDetector::onAutoDetectTimer()
 {
-    const DetectionResult oldResult = m_lastResult;
-    const DetectionResult newResult = detectSteamInput();
-    Q_UNUSED(oldResult);
-    Q_UNUSED(newResult);
+    // 状态变化经 steamRunningChanged 触发重新检测。
+    m_processWatcher->refresh();
+}
+
+void SteamInputDetector::onSteamRunningChanged(bool running)
+{
+    Q_EMIT steamRunningChanged(running);
+    if (m_autoDetect) {
+        detectSteamInput();
+    }
 }
 
 bool SteamInputDetector::checkProcess(const QString &processName) const
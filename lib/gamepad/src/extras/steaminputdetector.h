@@ -12,6 +12,8 @@
 
 DECKGAMEPAD_BEGIN_NAMESPACE
 
+class SteamProcessWatcher;
+
 /**
  * @brief Steam Input 冲突检测器
  *
@@ -20,11 +22,13 @@ DECKGAMEPAD_BEGIN_NAMESPACE
  *
  * 说明：
  * - 该类只做“检测与提示”，不做任何系统级干预。
- * - 自动检测默认关闭；开启后会以定时器间隔执行检测并发出信号。
+ * - 自动检测默认关闭；开启后 Steam 进程状态由事件驱动更新（proc connector），
+ *   无权限时退化为按间隔增量扫描 /proc；仅在状态变化时重新检测并发出信号。
  */
 class DECKGAMEPAD_EXPORT SteamInputDetector : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(bool steamRunning READ isSteamProcessRunning NOTIFY steamRunningChanged)
 
 public:
     enum DetectionResult {
@@ -44,11 +48,19 @@ public:
      */
     DetectionResult detectSteamInput();
 
+    /**
+     * @brief Steam 进程是否在运行
+     *
+     * 自动检测开启时直接返回事件驱动维护的状态；关闭时先对 /proc 做一次增量刷新
+     * （只读取新出现 pid 的 cmdline，已匹配 pid 仅 stat 复核）。
+     */
     bool isSteamProcessRunning() const;
     bool hasSteamEnvironment() const;
 
     /**
      * @brief 检测设备节点是否被占用（EBUSY）
+     *
+     * Steam 未运行时直接返回 false（不触碰设备节点）。
      */
     bool checkDeviceConflict(const QString &devicePath) const;
 
@@ -70,18 +82,21 @@ public:
     QString getConflictAdvice() const;
 
 Q_SIGNALS:
+    void steamRunningChanged(bool running);
     void steamInputDetected(DetectionResult result);
     void conflictWarning(const QString &message);
 
 private Q_SLOTS:
     void onAutoDetectTimer();
+    void onSteamRunningChanged(bool running);
 
 private:
     bool m_autoDetect = false;
     int m_autoDetectInterval = 30; // seconds
 
     DetectionResult m_lastResult = NotDetected;
-    QTimer *m_detectTimer = nullptr;
+    QTimer *m_detectTimer = nullptr;            // 仅 Polling 模式使用
+    SteamProcessWatcher *m_processWatcher = nullptr;
 
     bool checkProcess(const QString &processName) const;
     QString readEnvironmentVariable(const QString &name) const;
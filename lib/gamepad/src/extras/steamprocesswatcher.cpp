@@ -0,0 +1,402 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/extras/steamprocesswatcher_p.h>
+
+#include <QtCore/QDebug>
+#include <QtCore/QSocketNotifier>
+
+#include <string_view>
+
+extern "C" {
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+namespace {
+
+// proc_event::what 的取值（内核 6.6 起该枚举移出 struct，按数值比较以兼容新旧头文件）。
+constexpr quint32 kProcEventExec = 0x00000002;
+constexpr quint32 kProcEventExit = 0x80000000;
+
+bool parsePid(const char *name, pid_t *pid)
+{
+    if (!name || *name < '1' || *name > '9') {
+        return false;
+    }
+    long value = 0;
+    for (const char *p = name; *p; ++p) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        value = value * 10 + (*p - '0');
+        if (value > 0x3fffffff) {
+            return false;
+        }
+    }
+    *pid = static_cast<pid_t>(value);
+    return true;
+}
+
+} // namespace
+
+SteamProcessWatcher::SteamProcessWatcher(QObject *parent, const QString &procRoot)
+    : QObject(parent)
+    , m_procRoot(procRoot)
+    , m_procRootPath(procRoot.toLocal8Bit())
+{
+}
+
+SteamProcessWatcher::~SteamProcessWatcher()
+{
+    closeProcConnector();
+}
+
+void SteamProcessWatcher::setProcessNames(const QStringList &names)
+{
+    m_displayNames = names;
+    m_names.clear();
+    m_names.reserve(names.size());
+    for (const QString &name : names) {
+        m_names.append(name.toLatin1().toLower());
+    }
+
+    // 规则变化后需重新全量扫描。
+    const bool wasRunning = isSteamRunning();
+    m_candidates.clear();
+    m_seenPids.clear();
+    m_primed = false;
+    if (m_mode != Mode::Idle) {
+        scan(true);
+    }
+    notifyIfChanged(wasRunning);
+}
+
+SteamProcessWatcher::Mode SteamProcessWatcher::start(bool allowProcConnector)
+{
+    if (m_mode != Mode::Idle) {
+        return m_mode;
+    }
+
+    // proc connector 事件描述的是真实 /proc：自定义根目录（测试）只能轮询。
+    const bool realProc = m_procRoot == QLatin1StringView("/proc");
+    m_mode = (allowProcConnector && realProc && openProcConnector()) ? Mode::ProcConnector : Mode::Polling;
+
+    // 先订阅再全量扫描：扫描期间 exec 的进程由事件补齐（重复检查无副作用）。
+    const bool wasRunning = isSteamRunning();
+    scan(true);
+    notifyIfChanged(wasRunning);
+    return m_mode;
+}
+
+void SteamProcessWatcher::stop()
+{
+    closeProcConnector();
+    m_mode = Mode::Idle;
+}
+
+void SteamProcessWatcher::refresh()
+{
+    const bool wasRunning = isSteamRunning();
+    if (m_mode == Mode::ProcConnector) {
+        handleProcConnectorEvents();
+        notifyIfChanged(wasRunning);
+        return;
+    }
+
+    const bool full = !m_primed || ++m_scansSinceFull >= kFullRescanEvery;
+    scan(full);
+    notifyIfChanged(wasRunning);
+}
+
+QStringList SteamProcessWatcher::matchedNames() const
+{
+    QList<bool> matched(m_displayNames.size(), false);
+    for (const Candidate &candidate : m_candidates) {
+        if (candidate.nameIndex >= 0 && candidate.nameIndex < matched.size()) {
+            matched[candidate.nameIndex] = true;
+        }
+    }
+
+    QStringList out;
+    for (int i = 0; i < matched.size(); ++i) {
+        if (matched.at(i)) {
+            out.append(m_displayNames.at(i));
+        }
+    }
+    return out;
+}
+
+bool SteamProcessWatcher::openProcConnector()
+{
+    const int fd = ::socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct sockaddr_nl addr { };
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    addr.nl_pid = 0;
+    if (::bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        // 非特权进程通常为 EPERM：正常退化为轮询。
+        qDebug() << "SteamProcessWatcher: proc connector unavailable:" << strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    alignas(struct nlmsghdr) char buf[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))] = {};
+    auto *nlh = reinterpret_cast<struct nlmsghdr *>(buf);
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+    nlh->nlmsg_type = NLMSG_DONE;
+    nlh->nlmsg_pid = static_cast<__u32>(::getpid());
+
+    auto *msg = static_cast<struct cn_msg *>(NLMSG_DATA(nlh));
+    msg->id.idx = CN_IDX_PROC;
+    msg->id.val = CN_VAL_PROC;
+    msg->len = sizeof(enum proc_cn_mcast_op);
+    const enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+    memcpy(msg->data, &op, sizeof(op));
+
+    if (::send(fd, nlh, nlh->nlmsg_len, 0) < 0) {
+        qDebug() << "SteamProcessWatcher: proc connector subscribe failed:" << strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    m_netlinkFd = fd;
+    m_netlinkNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(m_netlinkNotifier, &QSocketNotifier::activated, this, [this]() {
+        const bool wasRunning = isSteamRunning();
+        handleProcConnectorEvents();
+        notifyIfChanged(wasRunning);
+    });
+    return true;
+}
+
+void SteamProcessWatcher::closeProcConnector()
+{
+    if (m_netlinkNotifier) {
+        m_netlinkNotifier->setEnabled(false);
+        delete m_netlinkNotifier;
+        m_netlinkNotifier = nullptr;
+    }
+    if (m_netlinkFd >= 0) {
+        ::close(m_netlinkFd);
+        m_netlinkFd = -1;
+    }
+}
+
+void SteamProcessWatcher::handleProcConnectorEvents()
+{
+    if (m_netlinkFd < 0) {
+        return;
+    }
+
+    alignas(struct nlmsghdr) char buf[8192];
+    for (;;) {
+        const ssize_t n = ::recv(m_netlinkFd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ENOBUFS) {
+                // 事件溢出：丢失的 exec/exit 只能通过一次全量扫描补齐。
+                scan(true);
+                continue;
+            }
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+
+        int len = static_cast<int>(n);
+        for (auto *nlh = reinterpret_cast<struct nlmsghdr *>(buf); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == NLMSG_NOOP) {
+                continue;
+            }
+            if (nlh->nlmsg_type == NLMSG_ERROR || nlh->nlmsg_type == NLMSG_OVERRUN) {
+                scan(true);
+                continue;
+            }
+
+            const auto *msg = static_cast<const struct cn_msg *>(NLMSG_DATA(nlh));
+            if (msg->id.idx != CN_IDX_PROC || msg->id.val != CN_VAL_PROC) {
+                continue;
+            }
+
+            const auto *event = reinterpret_cast<const struct proc_event *>(msg->data);
+            switch (static_cast<quint32>(event->what)) {
+            case kProcEventExec:
+                // 只关心线程组 leader：/proc/<tgid>/cmdline 即进程命令行。
+                if (event->event_data.exec.process_pid == event->event_data.exec.process_tgid) {
+                    forgetPid(event->event_data.exec.process_pid);
+                    examinePid(event->event_data.exec.process_pid);
+                }
+                break;
+            case kProcEventExit:
+                if (event->event_data.exit.process_pid == event->event_data.exit.process_tgid) {
+                    forgetPid(event->event_data.exit.process_pid);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+void SteamProcessWatcher::scan(bool full)
+{
+    // 已知候选只复核 stat：进程退出或 pid 被复用时移除（复用时作为新 pid 重新检查）。
+    for (auto it = m_candidates.begin(); it != m_candidates.end();) {
+        qint64 startKey = 0;
+        if (!statPid(it.key(), &startKey) || startKey != it->startKey) {
+            m_seenPids.remove(it.key());
+            it = m_candidates.erase(it);
+            continue;
+        }
+        ++it;
+    }
+
+    if (full) {
+        m_seenPids.clear();
+        m_scansSinceFull = 0;
+    }
+
+    DIR *dir = ::opendir(m_procRootPath.constData());
+    if (!dir) {
+        m_primed = true;
+        return;
+    }
+
+    QSet<pid_t> present;
+    present.reserve(m_seenPids.size() + 16);
+    while (const struct dirent *entry = ::readdir(dir)) {
+        pid_t pid = 0;
+        if (!parsePid(entry->d_name, &pid)) {
+            continue;
+        }
+        present.insert(pid);
+        if (!m_seenPids.contains(pid)) {
+            examinePid(pid);
+        }
+    }
+    ::closedir(dir);
+
+    m_seenPids = std::move(present);
+    m_primed = true;
+}
+
+void SteamProcessWatcher::examinePid(pid_t pid)
+{
+    if (m_candidates.contains(pid)) {
+        return;
+    }
+
+    const int nameIndex = matchCmdline(pid);
+    if (nameIndex < 0) {
+        return;
+    }
+
+    Candidate candidate;
+    candidate.nameIndex = nameIndex;
+    if (!statPid(pid, &candidate.startKey)) {
+        return;
+    }
+    m_candidates.insert(pid, candidate);
+}
+
+void SteamProcessWatcher::forgetPid(pid_t pid)
+{
+    m_candidates.remove(pid);
+    m_seenPids.remove(pid);
+}
+
+bool SteamProcessWatcher::statPid(pid_t pid, qint64 *startKey) const
+{
+    char path[PATH_MAX];
+    const int len = snprintf(path, sizeof(path), "%s/%d", m_procRootPath.constData(), static_cast<int>(pid));
+    if (len <= 0 || len >= static_cast<int>(sizeof(path))) {
+        return false;
+    }
+
+    struct stat st { };
+    if (::stat(path, &st) != 0) {
+        return false;
+    }
+    *startKey = static_cast<qint64>(st.st_ctim.tv_sec) * 1000000000LL + st.st_ctim.tv_nsec;
+    return true;
+}
+
+int SteamProcessWatcher::matchCmdline(pid_t pid)
+{
+    if (m_names.isEmpty()) {
+        return -1;
+    }
+
+    char path[PATH_MAX];
+    const int len = snprintf(path, sizeof(path), "%s/%d/cmdline", m_procRootPath.constData(), static_cast<int>(pid));
+    if (len <= 0 || len >= static_cast<int>(sizeof(path))) {
+        return -1;
+    }
+
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    ++m_cmdlineReads;
+
+    // 栈上缓冲：匹配名称都很短，截断超长 cmdline 不影响结果（与旧实现相比仅忽略 4KiB 之后的部分）。
+    char buf[4096];
+    ssize_t n = 0;
+    do {
+        n = ::read(fd, buf, sizeof(buf));
+    } while (n < 0 && errno == EINTR);
+    ::close(fd);
+    if (n <= 0) {
+        return -1;
+    }
+
+    for (ssize_t i = 0; i < n; ++i) {
+        const char c = buf[i];
+        if (c == '\0') {
+            buf[i] = ' ';
+        } else if (c >= 'A' && c <= 'Z') {
+            buf[i] = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+
+    const std::string_view cmdline(buf, static_cast<size_t>(n));
+    for (int i = 0; i < m_names.size(); ++i) {
+        const QByteArray &name = m_names.at(i);
+        if (cmdline.find(std::string_view(name.constData(), static_cast<size_t>(name.size()))) != std::string_view::npos) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void SteamProcessWatcher::notifyIfChanged(bool wasRunning)
+{
+    const bool running = isSteamRunning();
+    if (running != wasRunning) {
+        Q_EMIT steamRunningChanged(running);
+    }
+}
+
+DECKGAMEPAD_END_NAMESPACE
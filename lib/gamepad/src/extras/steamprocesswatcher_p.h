@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// Steam 进程观察器：proc connector 事件驱动，不可用时退化为增量 /proc 扫描。
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <sys/types.h>
+
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+QT_END_NAMESPACE
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+/**
+ * @brief Tracks processes whose cmdline matches a set of Steam process names
+ *
+ * - ProcConnector：netlink proc connector（需要 CAP_NET_ADMIN），仅在 exec/exit 时检查对应 pid。
+ * - Polling：由调用方定时 refresh()；每次仅读取新出现 pid 的 cmdline，已匹配 pid 只做 stat 复核，
+ *   每 kFullRescanEvery 次做一次全量扫描以覆盖 pid 复用。
+ */
+class SteamProcessWatcher final : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        Idle,
+        ProcConnector,
+        Polling,
+    };
+
+    static constexpr int kFullRescanEvery = 20;
+
+    explicit SteamProcessWatcher(QObject *parent = nullptr, const QString &procRoot = QStringLiteral("/proc"));
+    ~SteamProcessWatcher() override;
+
+    // 匹配规则与旧实现一致：cmdline（NUL 替换为空格）大小写不敏感包含任一名称。
+    void setProcessNames(const QStringList &names);
+
+    // 启动事件源：优先 proc connector，失败时进入 Polling（由调用方驱动 refresh()）。
+    Mode start(bool allowProcConnector = true);
+    void stop();
+    Mode mode() const { return m_mode; }
+
+    // 同步刷新：ProcConnector 模式下仅排空待处理事件；其余模式执行一次增量扫描（首次为全量）。
+    void refresh();
+
+    bool isSteamRunning() const { return !m_candidates.isEmpty(); }
+    QStringList matchedNames() const;
+
+    quint64 cmdlineReadCount() const { return m_cmdlineReads; }
+
+Q_SIGNALS:
+    void steamRunningChanged(bool running);
+
+private:
+    struct Candidate {
+        int nameIndex = -1;
+        qint64 startKey = 0; // /proc/<pid> 的 ctime：用于识别 pid 复用
+    };
+
+    bool openProcConnector();
+    void closeProcConnector();
+    void handleProcConnectorEvents();
+    void scan(bool full);
+    void examinePid(pid_t pid);
+    void forgetPid(pid_t pid);
+    bool statPid(pid_t pid, qint64 *startKey) const;
+    int matchCmdline(pid_t pid);
+    void notifyIfChanged(bool wasRunning);
+
+    QString m_procRoot;
+    QByteArray m_procRootPath;
+    QList<QByteArray> m_names; // 小写
+    QStringList m_displayNames;
+
+    Mode m_mode = Mode::Idle;
+    bool m_primed = false;
+    int m_scansSinceFull = 0;
+    QHash<pid_t, Candidate> m_candidates;
+    QSet<pid_t> m_seenPids;
+    quint64 m_cmdlineReads = 0;
+
+    int m_netlinkFd = -1;
+    QSocketNotifier *m_netlinkNotifier = nullptr;
+};
+
+DECKGAMEPAD_END_NAMESPACE
@@ -12,9 +12,9 @@
 #include <QtCore/QFile>
 #include <QtCore/QDir>
 #include <QtCore/QMetaObject>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTextStream>
-#include <QtCore/QThread>
 
 extern "C" {
 #include <linux/input.h>
@@ -49,52 +49,25 @@ DeckGamepadCustomMappingManager::~DeckGamepadCustomMappingManager()
 
 QString DeckGamepadCustomMappingManager::createCustomMapping(int deviceId)
 {
-    QString guid = getDeviceGuid(deviceId);
-    if (guid.isEmpty()) {
+    const auto snapshot = deviceSnapshot(deviceId);
+    if (!snapshot || snapshot->guid.isEmpty()) {
         qWarning() << "Cannot create mapping: invalid device ID" << deviceId;
         return QString();
     }
-    
-    const QString deviceName = getDeviceName(deviceId);
 
-    DeviceMapping mapping;
-    mapping.guid = guid;
-    mapping.name = deviceName;
+    const QString guid = snapshot->guid;
+    const QString deviceName = snapshot->name;
 
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
+    DeviceMapping mapping;
 
     // Try to load SDL DB default mapping as starting point
-    if (m_backend && m_sdlDb) {
-        DeviceMapping sdlMapping;
-        auto loadFromSdlDb = [&] {
-            auto *device = m_backend->device(deviceId);
-            if (!device) {
-                return;
-            }
-
-            physicalButtons = device->physicalButtonMap();
-            physicalAxes = device->physicalAxisMap();
-
-            if (m_sdlDb->hasMapping(guid)) {
-                sdlMapping = m_sdlDb->createDeviceMapping(guid, physicalButtons, physicalAxes);
-            }
-        };
-
-        if (QThread::currentThread() == m_backend->thread()) {
-            loadFromSdlDb();
-        } else {
-            QMetaObject::invokeMethod(m_backend, loadFromSdlDb, Qt::BlockingQueuedConnection);
-        }
-
-        if (!sdlMapping.isEmpty()) {
-            mapping = std::move(sdlMapping);
-            mapping.guid = guid;
-            mapping.name = deviceName;
-            qDebug() << "Created custom mapping from SDL DB for" << mapping.name;
-        }
+    if (!snapshot->sdlDbMapping.isEmpty()) {
+        mapping = snapshot->sdlDbMapping;
+        mapping.guid = guid;
+        mapping.name = deviceName;
+        qDebug() << "Created custom mapping from SDL DB for" << mapping.name;
     }
-    
+
     // If no SDL mapping, use generic template
     if (mapping.isEmpty()) {
         mapping = createGenericMapping();
@@ -105,10 +78,13 @@ QString DeckGamepadCustomMappingManager::createCustomMapping(int deviceId)
 
     StoredCustomMapping stored;
     stored.cachedEvdevMapping = mapping;
-    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, physicalButtons, physicalAxes);
-    m_customMappings[guid] = stored;
+    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, snapshot->physicalButtons, snapshot->physicalAxes);
+    {
+        QMutexLocker locker(&m_stateMutex);
+        m_customMappings[guid] = stored;
+    }
     emit mappingCreated(guid);
-    
+
     return guid;
 }
 
@@ -120,59 +96,47 @@ bool DeckGamepadCustomMappingManager::hasCustomMapping(int deviceId) const
 
 bool DeckGamepadCustomMappingManager::hasCustomMapping(const QString &guid) const
 {
+    QMutexLocker locker(&m_stateMutex);
     return m_customMappings.contains(guid);
 }
 
 DeviceMapping DeckGamepadCustomMappingManager::getCustomMapping(int deviceId) const
 {
-    QString guid = getDeviceGuid(deviceId);
-    if (guid.isEmpty()) {
-        return {};
-    }
-
-    const auto it = m_customMappings.constFind(guid);
-    if (it == m_customMappings.constEnd()) {
+    const auto snapshot = deviceSnapshot(deviceId);
+    if (!snapshot || snapshot->guid.isEmpty()) {
         return {};
     }
 
-    const StoredCustomMapping &stored = it.value();
-    if (!stored.cachedEvdevMapping.isEmpty()) {
-        return stored.cachedEvdevMapping;
+    QString sdlString;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        const auto it = m_customMappings.constFind(snapshot->guid);
+        if (it == m_customMappings.constEnd()) {
+            return {};
+        }
+        if (!it->cachedEvdevMapping.isEmpty()) {
+            return it->cachedEvdevMapping;
+        }
+        sdlString = it->sdlString;
     }
 
-    if (!m_backend || stored.sdlString.isEmpty()) {
+    if (sdlString.isEmpty()) {
         return {};
     }
 
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
-    auto collectPhysicalMaps = [&] {
-        auto *device = m_backend->device(deviceId);
-        if (!device) {
-            return;
-        }
-        physicalButtons = device->physicalButtonMap();
-        physicalAxes = device->physicalAxisMap();
-    };
-
-    if (QThread::currentThread() == m_backend->thread()) {
-        collectPhysicalMaps();
-    } else {
-        QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-    }
-
-    DeviceMapping parsed = deckGamepadParseSdlMappingString(stored.sdlString, physicalButtons, physicalAxes);
+    DeviceMapping parsed = deckGamepadParseSdlMappingString(sdlString, snapshot->physicalButtons, snapshot->physicalAxes);
     if (parsed.isEmpty()) {
         return {};
     }
 
-    parsed.guid = guid;
-    parsed.name = getDeviceName(deviceId);
+    parsed.guid = snapshot->guid;
+    parsed.name = snapshot->name;
     return parsed;
 }
 
 DeviceMapping DeckGamepadCustomMappingManager::getCustomMapping(const QString &guid) const
 {
+    QMutexLocker locker(&m_stateMutex);
     const auto it = m_customMappings.constFind(guid);
     if (it == m_customMappings.constEnd()) {
         return {};
@@ -188,7 +152,12 @@ void DeckGamepadCustomMappingManager::removeCustomMapping(int deviceId)
 
 void DeckGamepadCustomMappingManager::removeCustomMapping(const QString &guid)
 {
-    if (m_customMappings.remove(guid) > 0) {
+    qsizetype removed = 0;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        removed = m_customMappings.remove(guid);
+    }
+    if (removed > 0) {
         emit mappingRemoved(guid);
         qDebug() << "Removed custom mapping for GUID:" << guid;
     }
@@ -196,260 +165,160 @@ void DeckGamepadCustomMappingManager::removeCustomMapping(const QString &guid)
 
 // ========== Mapping Editing ==========
 
-void DeckGamepadCustomMappingManager::setButtonMapping(int deviceId, GamepadButton logicalButton, int physicalCode)
+DeckGamepadCustomMappingManager::StoredCustomMapping *DeckGamepadCustomMappingManager::materializeLocked(
+    int deviceId,
+    const DeckGamepadPhysicalMapSnapshot &snapshot,
+    const char *operation)
 {
-    QString guid = getDeviceGuid(deviceId);
-    if (guid.isEmpty() || !m_customMappings.contains(guid)) {
-        qWarning() << "Cannot set button mapping: no custom mapping for device" << deviceId;
-        return;
-    }
-
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
-    if (m_backend) {
-        auto collectPhysicalMaps = [&] {
-            auto *device = m_backend->device(deviceId);
-            if (!device) {
-                return;
-            }
-            physicalButtons = device->physicalButtonMap();
-            physicalAxes = device->physicalAxisMap();
-        };
-
-        if (QThread::currentThread() == m_backend->thread()) {
-            collectPhysicalMaps();
-        } else {
-            QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-        }
+    const auto it = m_customMappings.find(snapshot.guid);
+    if (snapshot.guid.isEmpty() || it == m_customMappings.end()) {
+        qWarning() << "Cannot" << operation << ": no custom mapping for device" << deviceId;
+        return nullptr;
     }
 
-    StoredCustomMapping &stored = m_customMappings[guid];
+    StoredCustomMapping &stored = it.value();
     if (stored.cachedEvdevMapping.isEmpty() && !stored.sdlString.isEmpty()) {
-        DeviceMapping parsed = deckGamepadParseSdlMappingString(stored.sdlString, physicalButtons, physicalAxes);
+        DeviceMapping parsed =
+            deckGamepadParseSdlMappingString(stored.sdlString, snapshot.physicalButtons, snapshot.physicalAxes);
         if (parsed.isEmpty()) {
-            qWarning() << "Cannot set button mapping: failed to parse stored SDL mapping for device" << deviceId;
-            return;
+            qWarning() << "Cannot" << operation << ": failed to parse stored SDL mapping for device" << deviceId;
+            return nullptr;
         }
-        parsed.guid = guid;
-        parsed.name = getDeviceName(deviceId);
+        parsed.guid = snapshot.guid;
+        parsed.name = snapshot.name;
         stored.cachedEvdevMapping = parsed;
     }
-
-    DeviceMapping &mapping = stored.cachedEvdevMapping;
-    mapping.buttonMap[physicalCode] = logicalButton;
-    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, physicalButtons, physicalAxes);
-
-    emit mappingChanged(guid);
-    qDebug() << "Set button mapping:" << logicalButton << "->" << physicalCode;
+    return &stored;
 }
 
-void DeckGamepadCustomMappingManager::setAxisMapping(int deviceId, GamepadAxis logicalAxis, int physicalCode, bool inverted)
+bool DeckGamepadCustomMappingManager::applyEditsLocked(int deviceId,
+                                                       const QList<DeckGamepadMappingEdit> &edits,
+                                                       QString *changedGuid)
 {
-    QString guid = getDeviceGuid(deviceId);
-    if (guid.isEmpty() || !m_customMappings.contains(guid)) {
-        qWarning() << "Cannot set axis mapping: no custom mapping for device" << deviceId;
-        return;
+    const auto snapshot = deviceSnapshot(deviceId);
+    if (!snapshot) {
+        qWarning() << "Cannot edit mapping: unknown device" << deviceId;
+        return false;
     }
 
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
-    if (m_backend) {
-        auto collectPhysicalMaps = [&] {
-            auto *device = m_backend->device(deviceId);
-            if (!device) {
-                return;
-            }
-            physicalButtons = device->physicalButtonMap();
-            physicalAxes = device->physicalAxisMap();
-        };
-
-        if (QThread::currentThread() == m_backend->thread()) {
-            collectPhysicalMaps();
-        } else {
-            QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-        }
+    StoredCustomMapping *stored = materializeLocked(deviceId, *snapshot, "edit mapping");
+    if (!stored) {
+        return false;
     }
 
-    StoredCustomMapping &stored = m_customMappings[guid];
-    if (stored.cachedEvdevMapping.isEmpty() && !stored.sdlString.isEmpty()) {
-        DeviceMapping parsed = deckGamepadParseSdlMappingString(stored.sdlString, physicalButtons, physicalAxes);
-        if (parsed.isEmpty()) {
-            qWarning() << "Cannot set axis mapping: failed to parse stored SDL mapping for device" << deviceId;
-            return;
+    // 在副本上应用，任一条无效时整体放弃，避免半生效。
+    DeviceMapping mapping = stored->cachedEvdevMapping;
+    for (const DeckGamepadMappingEdit &edit : edits) {
+        switch (edit.kind) {
+        case DeckGamepadMappingEdit::Kind::SetButton:
+            if (edit.logical < 0 || edit.logical >= GAMEPAD_BUTTON_MAX || edit.code < 0) {
+                qWarning() << "Invalid button edit:" << edit.logical << "->" << edit.code;
+                return false;
+            }
+            mapping.buttonMap[edit.code] = static_cast<GamepadButton>(edit.logical);
+            break;
+        case DeckGamepadMappingEdit::Kind::SetAxis:
+            if (edit.logical < 0 || edit.logical >= GAMEPAD_AXIS_MAX || edit.code < 0) {
+                qWarning() << "Invalid axis edit:" << edit.logical << "->" << edit.code;
+                return false;
+            }
+            mapping.axisMap[edit.code] = static_cast<GamepadAxis>(edit.logical);
+            if (edit.inverted) {
+                mapping.invertedAxes.insert(edit.code);
+            } else {
+                mapping.invertedAxes.remove(edit.code);
+            }
+            break;
+        case DeckGamepadMappingEdit::Kind::SetHat:
+            if (edit.logical < 0 || edit.logical >= GAMEPAD_BUTTON_MAX || edit.code < 0) {
+                qWarning() << "Invalid HAT edit:" << edit.logical << "-> HAT" << edit.code;
+                return false;
+            }
+            // HAT mapping: store in hatButtonMap with combined key (hatCode << 8 | hatMask)
+            mapping.hatButtonMap[(edit.code << 8) | edit.hatMask] = static_cast<GamepadButton>(edit.logical);
+            break;
+        case DeckGamepadMappingEdit::Kind::ClearButton:
+            for (auto it = mapping.buttonMap.begin(); it != mapping.buttonMap.end();) {
+                if (it.value() == edit.logical) {
+                    it = mapping.buttonMap.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            break;
+        case DeckGamepadMappingEdit::Kind::ClearAxis:
+            for (auto it = mapping.axisMap.begin(); it != mapping.axisMap.end();) {
+                if (it.value() == edit.logical) {
+                    mapping.invertedAxes.remove(it.key());
+                    it = mapping.axisMap.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            break;
         }
-        parsed.guid = guid;
-        parsed.name = getDeviceName(deviceId);
-        stored.cachedEvdevMapping = parsed;
     }
 
-    DeviceMapping &mapping = stored.cachedEvdevMapping;
-    mapping.axisMap[physicalCode] = logicalAxis;
-
-    if (inverted) {
-        mapping.invertedAxes.insert(physicalCode);
-    } else {
-        mapping.invertedAxes.remove(physicalCode);
+    stored->cachedEvdevMapping = std::move(mapping);
+    stored->sdlString =
+        deckGamepadComposeSdlMappingString(stored->cachedEvdevMapping, snapshot->physicalButtons, snapshot->physicalAxes);
+    if (changedGuid) {
+        *changedGuid = snapshot->guid;
     }
-
-    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, physicalButtons, physicalAxes);
-
-    emit mappingChanged(guid);
-    qDebug() << "Set axis mapping:" << logicalAxis << "->" << physicalCode << "inverted:" << inverted;
+    return true;
 }
 
-void DeckGamepadCustomMappingManager::setHatMapping(int deviceId, GamepadButton logicalButton, int hatCode, int hatMask)
+bool DeckGamepadCustomMappingManager::applyEdits(int deviceId, const QList<DeckGamepadMappingEdit> &edits)
 {
-    QString guid = getDeviceGuid(deviceId);
-    if (guid.isEmpty() || !m_customMappings.contains(guid)) {
-        qWarning() << "Cannot set HAT mapping: no custom mapping for device" << deviceId;
-        return;
-    }
-
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
-    if (m_backend) {
-        auto collectPhysicalMaps = [&] {
-            auto *device = m_backend->device(deviceId);
-            if (!device) {
-                return;
-            }
-            physicalButtons = device->physicalButtonMap();
-            physicalAxes = device->physicalAxisMap();
-        };
-
-        if (QThread::currentThread() == m_backend->thread()) {
-            collectPhysicalMaps();
-        } else {
-            QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-        }
-    }
-
-    StoredCustomMapping &stored = m_customMappings[guid];
-    if (stored.cachedEvdevMapping.isEmpty() && !stored.sdlString.isEmpty()) {
-        DeviceMapping parsed = deckGamepadParseSdlMappingString(stored.sdlString, physicalButtons, physicalAxes);
-        if (parsed.isEmpty()) {
-            qWarning() << "Cannot set hat mapping: failed to parse stored SDL mapping for device" << deviceId;
-            return;
+    QString guid;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        if (!applyEditsLocked(deviceId, edits, &guid)) {
+            return false;
         }
-        parsed.guid = guid;
-        parsed.name = getDeviceName(deviceId);
-        stored.cachedEvdevMapping = parsed;
     }
 
-    DeviceMapping &mapping = stored.cachedEvdevMapping;
-
-    // HAT mapping: store in hatButtonMap with combined key (hatCode << 8 | hatMask)
-    int hatKey = (hatCode << 8) | hatMask;
-    mapping.hatButtonMap[hatKey] = logicalButton;
-
-    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, physicalButtons, physicalAxes);
-
     emit mappingChanged(guid);
-    qDebug() << "Set HAT mapping:" << logicalButton << "-> HAT" << hatCode << "mask" << hatMask;
+    return true;
 }
 
-void DeckGamepadCustomMappingManager::clearButtonMapping(int deviceId, GamepadButton logicalButton)
+quint64 DeckGamepadCustomMappingManager::commitEdits(int deviceId, const QList<DeckGamepadMappingEdit> &edits)
 {
-    QString guid = getDeviceGuid(deviceId);
-    if (guid.isEmpty() || !m_customMappings.contains(guid)) {
-        return;
+    if (!applyEdits(deviceId, edits)) {
+        return 0;
     }
+    return applyMappingAsync(deviceId);
+}
 
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
-    if (m_backend) {
-        auto collectPhysicalMaps = [&] {
-            auto *device = m_backend->device(deviceId);
-            if (!device) {
-                return;
-            }
-            physicalButtons = device->physicalButtonMap();
-            physicalAxes = device->physicalAxisMap();
-        };
-
-        if (QThread::currentThread() == m_backend->thread()) {
-            collectPhysicalMaps();
-        } else {
-            QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-        }
+void DeckGamepadCustomMappingManager::setButtonMapping(int deviceId, GamepadButton logicalButton, int physicalCode)
+{
+    if (applyEdits(deviceId, { DeckGamepadMappingEdit::setButton(logicalButton, physicalCode) })) {
+        qDebug() << "Set button mapping:" << logicalButton << "->" << physicalCode;
     }
+}
 
-    StoredCustomMapping &stored = m_customMappings[guid];
-    if (stored.cachedEvdevMapping.isEmpty() && !stored.sdlString.isEmpty()) {
-        DeviceMapping parsed = deckGamepadParseSdlMappingString(stored.sdlString, physicalButtons, physicalAxes);
-        if (!parsed.isEmpty()) {
-            parsed.guid = guid;
-            parsed.name = getDeviceName(deviceId);
-            stored.cachedEvdevMapping = parsed;
-        }
+void DeckGamepadCustomMappingManager::setAxisMapping(int deviceId, GamepadAxis logicalAxis, int physicalCode, bool inverted)
+{
+    if (applyEdits(deviceId, { DeckGamepadMappingEdit::setAxis(logicalAxis, physicalCode, inverted) })) {
+        qDebug() << "Set axis mapping:" << logicalAxis << "->" << physicalCode << "inverted:" << inverted;
     }
+}
 
-    DeviceMapping &mapping = stored.cachedEvdevMapping;
-
-    // Find and remove the mapping
-    for (auto it = mapping.buttonMap.begin(); it != mapping.buttonMap.end(); ) {
-        if (it.value() == logicalButton) {
-            it = mapping.buttonMap.erase(it);
-        } else {
-            ++it;
-        }
+void DeckGamepadCustomMappingManager::setHatMapping(int deviceId, GamepadButton logicalButton, int hatCode, int hatMask)
+{
+    if (applyEdits(deviceId, { DeckGamepadMappingEdit::setHat(logicalButton, hatCode, hatMask) })) {
+        qDebug() << "Set HAT mapping:" << logicalButton << "-> HAT" << hatCode << "mask" << hatMask;
     }
+}
 
-    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, physicalButtons, physicalAxes);
-    emit mappingChanged(guid);
+void DeckGamepadCustomMappingManager::clearButtonMapping(int deviceId, GamepadButton logicalButton)
+{
+    applyEdits(deviceId, { DeckGamepadMappingEdit::clearButton(logicalButton) });
 }
 
 void DeckGamepadCustomMappingManager::clearAxisMapping(int deviceId, GamepadAxis logicalAxis)
 {
-    QString guid = getDeviceGuid(deviceId);
-    if (guid.isEmpty() || !m_customMappings.contains(guid)) {
-        return;
-    }
-
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
-    if (m_backend) {
-        auto collectPhysicalMaps = [&] {
-            auto *device = m_backend->device(deviceId);
-            if (!device) {
-                return;
-            }
-            physicalButtons = device->physicalButtonMap();
-            physicalAxes = device->physicalAxisMap();
-        };
-
-        if (QThread::currentThread() == m_backend->thread()) {
-            collectPhysicalMaps();
-        } else {
-            QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-        }
-    }
-
-    StoredCustomMapping &stored = m_customMappings[guid];
-    if (stored.cachedEvdevMapping.isEmpty() && !stored.sdlString.isEmpty()) {
-        DeviceMapping parsed = deckGamepadParseSdlMappingString(stored.sdlString, physicalButtons, physicalAxes);
-        if (!parsed.isEmpty()) {
-            parsed.guid = guid;
-            parsed.name = getDeviceName(deviceId);
-            stored.cachedEvdevMapping = parsed;
-        }
-    }
-
-    DeviceMapping &mapping = stored.cachedEvdevMapping;
-
-    // Find and remove the mapping
-    for (auto it = mapping.axisMap.begin(); it != mapping.axisMap.end(); ) {
-        if (it.value() == logicalAxis) {
-            int code = it.key();
-            it = mapping.axisMap.erase(it);
-            mapping.invertedAxes.remove(code);
-        } else {
-            ++it;
-        }
-    }
-
-    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, physicalButtons, physicalAxes);
-    emit mappingChanged(guid);
+    applyEdits(deviceId, { DeckGamepadMappingEdit::clearAxis(logicalAxis) });
 }
 
 // ========== Preset Templates ==========
@@ -461,31 +330,13 @@ bool DeckGamepadCustomMappingManager::loadPreset(int deviceId, const QString &pr
         return false;
     }
     
-    QString guid = getDeviceGuid(deviceId);
-    if (guid.isEmpty()) {
+    const auto snapshot = deviceSnapshot(deviceId);
+    if (!snapshot || snapshot->guid.isEmpty()) {
         return false;
     }
 
-    const QString deviceName = getDeviceName(deviceId);
-
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
-    if (m_backend) {
-        auto collectPhysicalMaps = [&] {
-            auto *device = m_backend->device(deviceId);
-            if (!device) {
-                return;
-            }
-            physicalButtons = device->physicalButtonMap();
-            physicalAxes = device->physicalAxisMap();
-        };
-
-        if (QThread::currentThread() == m_backend->thread()) {
-            collectPhysicalMaps();
-        } else {
-            QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-        }
-    }
+    const QString &guid = snapshot->guid;
+    const QString &deviceName = snapshot->name;
 
     const QString rawPreset = m_presetTemplates[presetName];
     QStringList parts = rawPreset.split(QLatin1Char(','), Qt::KeepEmptyParts);
@@ -498,7 +349,8 @@ bool DeckGamepadCustomMappingManager::loadPreset(int deviceId, const QString &pr
     parts[1] = deviceName;
     const QString normalizedSdlString = parts.join(QLatin1Char(','));
 
-    DeviceMapping mapping = deckGamepadParseSdlMappingString(normalizedSdlString, physicalButtons, physicalAxes);
+    DeviceMapping mapping =
+        deckGamepadParseSdlMappingString(normalizedSdlString, snapshot->physicalButtons, snapshot->physicalAxes);
     if (mapping.isEmpty()) {
         qWarning() << "Failed to parse preset:" << presetName;
         return false;
@@ -509,8 +361,11 @@ bool DeckGamepadCustomMappingManager::loadPreset(int deviceId, const QString &pr
 
     StoredCustomMapping stored;
     stored.cachedEvdevMapping = mapping;
-    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, physicalButtons, physicalAxes);
-    m_customMappings[guid] = stored;
+    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, snapshot->physicalButtons, snapshot->physicalAxes);
+    {
+        QMutexLocker locker(&m_stateMutex);
+        m_customMappings[guid] = stored;
+    }
     emit mappingChanged(guid);
     
     qDebug() << "Loaded preset" << presetName << "for device" << deviceId;
@@ -550,11 +405,14 @@ bool DeckGamepadCustomMappingManager::saveToFile(const QString &filePath)
     out << "# Generated: " << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n\n";
     
     int count = 0;
-    for (auto it = m_customMappings.constBegin(); it != m_customMappings.constEnd(); ++it) {
-        const QString sdlString = it.value().sdlString.trimmed();
-        if (!sdlString.isEmpty()) {
-            out << sdlString << "\n";
-            count++;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        for (auto it = m_customMappings.constBegin(); it != m_customMappings.constEnd(); ++it) {
+            const QString sdlString = it.value().sdlString.trimmed();
+            if (!sdlString.isEmpty()) {
+                out << sdlString << "\n";
+                count++;
+            }
         }
     }
     
@@ -617,6 +475,7 @@ int DeckGamepadCustomMappingManager::loadFromFile(const QString &filePath)
 
         StoredCustomMapping stored;
         stored.sdlString = line;
+        QMutexLocker locker(&m_stateMutex);
         m_customMappings[guid] = stored;
         count++;
     }
@@ -669,128 +528,167 @@ QString DeckGamepadCustomMappingManager::legacyDirName() const
 
 bool DeckGamepadCustomMappingManager::applyMapping(int deviceId)
 {
-    QString guid = getDeviceGuid(deviceId);
-    const auto it = m_customMappings.find(guid);
+    return applyMappingAsync(deviceId) != 0;
+}
+
+QString DeckGamepadCustomMappingManager::resolveApplySdlStringLocked(int deviceId, QString *guid)
+{
+    const auto snapshot = deviceSnapshot(deviceId);
+    const auto it = snapshot ? m_customMappings.find(snapshot->guid) : m_customMappings.end();
     if (it == m_customMappings.end()) {
         qWarning() << "No custom mapping to apply for device" << deviceId;
-        return false;
+        return {};
     }
 
     StoredCustomMapping &stored = it.value();
 
     QString sdlString = stored.sdlString.trimmed();
     if (sdlString.isEmpty() && !stored.cachedEvdevMapping.isEmpty()) {
-        QHash<int, int> physicalButtons;
-        QHash<int, int> physicalAxes;
-        if (m_backend) {
-            auto collectPhysicalMaps = [&] {
-                auto *device = m_backend->device(deviceId);
-                if (!device) {
-                    return;
-                }
-                physicalButtons = device->physicalButtonMap();
-                physicalAxes = device->physicalAxisMap();
-            };
-
-            if (QThread::currentThread() == m_backend->thread()) {
-                collectPhysicalMaps();
-            } else {
-                QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-            }
-        }
-
-        sdlString = deckGamepadComposeSdlMappingString(stored.cachedEvdevMapping, physicalButtons, physicalAxes);
+        sdlString = deckGamepadComposeSdlMappingString(stored.cachedEvdevMapping,
+                                                       snapshot->physicalButtons,
+                                                       snapshot->physicalAxes);
     }
 
     if (sdlString.isEmpty()) {
         qWarning() << "Failed to apply mapping: empty SDL mapping string";
-        return false;
-    }
-
-    {
-        QStringList parts = sdlString.split(QLatin1Char(','), Qt::KeepEmptyParts);
-        if (parts.size() >= 3) {
-            parts[0] = guid;
-            parts[1] = getDeviceName(deviceId);
-            sdlString = parts.join(QLatin1Char(','));
-        }
-        stored.sdlString = sdlString;
+        return {};
     }
 
-    if (!m_backend) {
-        return false;
+    QStringList parts = sdlString.split(QLatin1Char(','), Qt::KeepEmptyParts);
+    if (parts.size() >= 3) {
+        parts[0] = snapshot->guid;
+        parts[1] = snapshot->name;
+        sdlString = parts.join(QLatin1Char(','));
     }
+    stored.sdlString = sdlString;
 
-    bool ok = false;
-    auto applyToDevice = [&] {
-        if (!m_sdlDb || !m_sdlDb->addMapping(sdlString)) {
-            return;
-        }
-
-        auto *device = m_backend->device(deviceId);
-        if (!device) {
-            return;
-        }
-
-        device->reloadMapping();
-        ok = true;
-    };
+    *guid = snapshot->guid;
+    return sdlString;
+}
 
-    if (QThread::currentThread() == m_backend->thread()) {
-        applyToDevice();
-    } else {
-        QMetaObject::invokeMethod(m_backend, applyToDevice, Qt::BlockingQueuedConnection);
+quint64 DeckGamepadCustomMappingManager::applyMappingAsync(int deviceId)
+{
+    QString guid;
+    QString sdlString;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        sdlString = resolveApplySdlStringLocked(deviceId, &guid);
     }
-
-    if (!ok) {
-        qWarning() << "Failed to apply mapping to device" << deviceId;
-        return false;
+    if (sdlString.isEmpty()) {
+        return 0;
     }
 
-    emit mappingApplied(deviceId);
-    qDebug() << "Applied custom mapping to device" << deviceId;
-    return true;
+    return enqueueDeviceTransaction(deviceId, guid, sdlString);
 }
 
 bool DeckGamepadCustomMappingManager::resetToSdlDefault(int deviceId)
 {
-    QString guid = getDeviceGuid(deviceId);
+    return resetToSdlDefaultAsync(deviceId) != 0;
+}
+
+quint64 DeckGamepadCustomMappingManager::resetToSdlDefaultAsync(int deviceId)
+{
+    const QString guid = getDeviceGuid(deviceId);
+    if (guid.isEmpty()) {
+        return 0;
+    }
     
     // Remove custom mapping
     removeCustomMapping(guid);
     
     // Reload device mapping (will use SDL DB default)
+    return enqueueDeviceTransaction(deviceId, guid, QString());
+}
+
+quint64 DeckGamepadCustomMappingManager::enqueueDeviceTransaction(int deviceId,
+                                                                  const QString &guid,
+                                                                  const QString &sdlString)
+{
     if (!m_backend) {
-        return false;
+        return 0;
     }
 
-    bool ok = false;
-    auto reloadDevice = [&] {
-        if (m_sdlDb) {
-            m_sdlDb->removeMapping(guid);
-        }
+    const quint64 transactionId = m_nextTransactionId.fetch_add(1, std::memory_order_relaxed);
 
-        auto *device = m_backend->device(deviceId);
-        if (!device) {
-            return;
-        }
+    // 始终排队（即便已在 backend 线程）：调用方不会因设备 reload 被阻塞，事务之间按提交顺序执行。
+    QMetaObject::invokeMethod(
+        m_backend,
+        [this, transactionId, deviceId, guid, sdlString] {
+            bool ok = false;
+            if (sdlString.isEmpty()) {
+                if (m_sdlDb) {
+                    m_sdlDb->removeMapping(guid);
+                }
+                ok = true;
+            } else {
+                ok = m_sdlDb && m_sdlDb->addMapping(sdlString);
+            }
 
-        device->reloadMapping();
-        ok = true;
-    };
+            auto *device = ok ? m_backend->device(deviceId) : nullptr;
+            if (device) {
+                device->reloadMapping();
+                publishDeviceSnapshot(device);
+            } else {
+                ok = false;
+            }
+
+            if (!sdlString.isEmpty()) {
+                if (ok) {
+                    emit mappingApplied(deviceId);
+                    qDebug() << "Applied custom mapping to device" << deviceId;
+                } else {
+                    qWarning() << "Failed to apply mapping to device" << deviceId;
+                }
+            } else if (ok) {
+                qDebug() << "Reset device" << deviceId << "to SDL DB default";
+            }
+
+            emit transactionFinished(transactionId, deviceId, ok);
+        },
+        Qt::QueuedConnection);
+
+    return transactionId;
+}
+
+// ========== Device Snapshots ==========
 
-    if (QThread::currentThread() == m_backend->thread()) {
-        reloadDevice();
-    } else {
-        QMetaObject::invokeMethod(m_backend, reloadDevice, Qt::BlockingQueuedConnection);
+void DeckGamepadCustomMappingManager::publishDeviceSnapshot(const DeckGamepadDevice *device)
+{
+    if (!device) {
+        return;
     }
 
-    if (!ok) {
-        return false;
+    auto snapshot = std::make_shared<DeckGamepadPhysicalMapSnapshot>();
+    snapshot->deviceId = device->deviceId();
+    snapshot->guid = device->guid();
+    snapshot->name = device->name();
+    snapshot->physicalButtons = device->physicalButtonMap();
+    snapshot->physicalAxes = device->physicalAxisMap();
+    if (m_sdlDb && m_sdlDb->hasMapping(snapshot->guid)) {
+        snapshot->sdlDbMapping =
+            m_sdlDb->createDeviceMapping(snapshot->guid, snapshot->physicalButtons, snapshot->physicalAxes);
     }
 
-    qDebug() << "Reset device" << deviceId << "to SDL DB default";
-    return true;
+    QMutexLocker locker(&m_snapshotMutex);
+    m_snapshots.insert(snapshot->deviceId, std::move(snapshot));
+}
+
+void DeckGamepadCustomMappingManager::retractDeviceSnapshot(int deviceId)
+{
+    QMutexLocker locker(&m_snapshotMutex);
+    m_snapshots.remove(deviceId);
+}
+
+void DeckGamepadCustomMappingManager::retractAllDeviceSnapshots()
+{
+    QMutexLocker locker(&m_snapshotMutex);
+    m_snapshots.clear();
+}
+
+std::shared_ptr<const DeckGamepadPhysicalMapSnapshot> DeckGamepadCustomMappingManager::deviceSnapshot(int deviceId) const
+{
+    QMutexLocker locker(&m_snapshotMutex);
+    return m_snapshots.value(deviceId);
 }
 
 // ========== Validation ==========
@@ -802,8 +700,7 @@ bool DeckGamepadCustomMappingManager::isMappingComplete(int deviceId) const
 
 QStringList DeckGamepadCustomMappingManager::getMissingMappings(int deviceId) const
 {
-    QString guid = getDeviceGuid(deviceId);
-    if (!m_customMappings.contains(guid)) {
+    if (!hasCustomMapping(deviceId)) {
         return QStringList() << "No custom mapping exists";
     }
 
@@ -856,50 +753,42 @@ QStringList DeckGamepadCustomMappingManager::getMissingMappings(int deviceId) co
 
 QString DeckGamepadCustomMappingManager::exportToSdlString(int deviceId) const
 {
-    QString guid = getDeviceGuid(deviceId);
-    const auto it = m_customMappings.constFind(guid);
-    if (it == m_customMappings.constEnd()) {
+    const auto snapshot = deviceSnapshot(deviceId);
+    if (!snapshot) {
         return {};
     }
 
-    const StoredCustomMapping &stored = it.value();
+    StoredCustomMapping stored;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        const auto it = m_customMappings.constFind(snapshot->guid);
+        if (it == m_customMappings.constEnd()) {
+            return {};
+        }
+        stored = it.value();
+    }
+
     const QString sdlString = stored.sdlString.trimmed();
     if (!sdlString.isEmpty()) {
         return sdlString;
     }
 
-    if (!m_backend || stored.cachedEvdevMapping.isEmpty()) {
+    if (stored.cachedEvdevMapping.isEmpty()) {
         return {};
     }
 
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
-    auto collectPhysicalMaps = [&] {
-        auto *device = m_backend->device(deviceId);
-        if (!device) {
-            return;
-        }
-        physicalButtons = device->physicalButtonMap();
-        physicalAxes = device->physicalAxisMap();
-    };
-
-    if (QThread::currentThread() == m_backend->thread()) {
-        collectPhysicalMaps();
-    } else {
-        QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-    }
-
-    return deckGamepadComposeSdlMappingString(stored.cachedEvdevMapping, physicalButtons, physicalAxes);
+    return deckGamepadComposeSdlMappingString(stored.cachedEvdevMapping, snapshot->physicalButtons, snapshot->physicalAxes);
 }
 
 bool DeckGamepadCustomMappingManager::importFromSdlString(int deviceId, const QString &sdlString)
 {
-    const QString guid = getDeviceGuid(deviceId);
-    if (guid.isEmpty()) {
+    const auto snapshot = deviceSnapshot(deviceId);
+    if (!snapshot || snapshot->guid.isEmpty()) {
         return false;
     }
 
-    const QString deviceName = getDeviceName(deviceId);
+    const QString &guid = snapshot->guid;
+    const QString &deviceName = snapshot->name;
 
     QStringList parts = sdlString.split(QLatin1Char(','), Qt::KeepEmptyParts);
     if (parts.size() < 3) {
@@ -910,26 +799,8 @@ bool DeckGamepadCustomMappingManager::importFromSdlString(int deviceId, const QS
     parts[1] = deviceName;
     const QString normalizedSdlString = parts.join(QLatin1Char(','));
 
-    QHash<int, int> physicalButtons;
-    QHash<int, int> physicalAxes;
-    if (m_backend) {
-        auto collectPhysicalMaps = [&] {
-            auto *device = m_backend->device(deviceId);
-            if (!device) {
-                return;
-            }
-            physicalButtons = device->physicalButtonMap();
-            physicalAxes = device->physicalAxisMap();
-        };
-
-        if (QThread::currentThread() == m_backend->thread()) {
-            collectPhysicalMaps();
-        } else {
-            QMetaObject::invokeMethod(m_backend, collectPhysicalMaps, Qt::BlockingQueuedConnection);
-        }
-    }
-
-    DeviceMapping mapping = deckGamepadParseSdlMappingString(normalizedSdlString, physicalButtons, physicalAxes);
+    DeviceMapping mapping =
+        deckGamepadParseSdlMappingString(normalizedSdlString, snapshot->physicalButtons, snapshot->physicalAxes);
     if (mapping.isEmpty()) {
         return false;
     }
@@ -939,8 +810,11 @@ bool DeckGamepadCustomMappingManager::importFromSdlString(int deviceId, const QS
 
     StoredCustomMapping stored;
     stored.cachedEvdevMapping = mapping;
-    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, physicalButtons, physicalAxes);
-    m_customMappings[guid] = stored;
+    stored.sdlString = deckGamepadComposeSdlMappingString(mapping, snapshot->physicalButtons, snapshot->physicalAxes);
+    {
+        QMutexLocker locker(&m_stateMutex);
+        m_customMappings[guid] = stored;
+    }
     emit mappingChanged(guid);
     
     return true;
@@ -950,40 +824,14 @@ bool DeckGamepadCustomMappingManager::importFromSdlString(int deviceId, const QS
 
 QString DeckGamepadCustomMappingManager::getDeviceGuid(int deviceId) const
 {
-    if (!m_backend) {
-        return QString();
-    }
-
-    if (QThread::currentThread() == m_backend->thread()) {
-        auto *device = m_backend->device(deviceId);
-        return device ? device->guid() : QString();
-    }
-
-    QString guid;
-    QMetaObject::invokeMethod(m_backend, [&] {
-        auto *device = m_backend->device(deviceId);
-        guid = device ? device->guid() : QString();
-    }, Qt::BlockingQueuedConnection);
-    return guid;
+    const auto snapshot = deviceSnapshot(deviceId);
+    return snapshot ? snapshot->guid : QString();
 }
 
 QString DeckGamepadCustomMappingManager::getDeviceName(int deviceId) const
 {
-    if (!m_backend) {
-        return QString();
-    }
-
-    if (QThread::currentThread() == m_backend->thread()) {
-        auto *device = m_backend->device(deviceId);
-        return device ? device->name() : QString();
-    }
-
-    QString name;
-    QMetaObject::invokeMethod(m_backend, [&] {
-        auto *device = m_backend->device(deviceId);
-        name = device ? device->name() : QString();
-    }, Qt::BlockingQueuedConnection);
-    return name;
+    const auto snapshot = deviceSnapshot(deviceId);
+    return snapshot ? snapshot->name : QString();
 }
 
 DeviceMapping DeckGamepadCustomMappingManager::createGenericMapping() const
@@ -10,15 +10,71 @@
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QRecursiveMutex>
 #include <QtCore/QStringList>
 
+#include <atomic>
+#include <memory>
+
 DECKGAMEPAD_BEGIN_NAMESPACE
 
 class DeckGamepadSdlControllerDb;
 class DeckGamepadBackend;
+class DeckGamepadDevice;
+
+/// 设备物理键/轴表快照：backend 线程在设备打开、映射重载后发布，发布后不可变。
+/// 编辑路径只读取快照，不再与 backend 线程往返。
+struct DeckGamepadPhysicalMapSnapshot {
+    int deviceId = -1;
+    QString guid;
+    QString name;
+    QHash<int, int> physicalButtons; // evdev code → SDL button index
+    QHash<int, int> physicalAxes;    // evdev code → SDL axis index
+    DeviceMapping sdlDbMapping;      // 发布时 SDL DB 中该 GUID 的映射（无则为空），作为新建自定义映射的起点
+};
+
+/// 批量编辑中的一条绑定变更（见 applyEdits / commitEdits）。
+struct DeckGamepadMappingEdit {
+    enum class Kind {
+        SetButton,
+        SetAxis,
+        SetHat,
+        ClearButton,
+        ClearAxis,
+    };
+
+    Kind kind = Kind::SetButton;
+    int logical = -1;   // GamepadButton / GamepadAxis
+    int code = -1;      // evdev code（SetHat 时为 hat 索引）
+    int hatMask = 0;    // 仅 SetHat
+    bool inverted = false; // 仅 SetAxis
+
+    static DeckGamepadMappingEdit setButton(GamepadButton button, int physicalCode)
+    {
+        return { Kind::SetButton, int(button), physicalCode, 0, false };
+    }
+    static DeckGamepadMappingEdit setAxis(GamepadAxis axis, int physicalCode, bool inverted = false)
+    {
+        return { Kind::SetAxis, int(axis), physicalCode, 0, inverted };
+    }
+    static DeckGamepadMappingEdit setHat(GamepadButton button, int hatCode, int hatMask)
+    {
+        return { Kind::SetHat, int(button), hatCode, hatMask, false };
+    }
+    static DeckGamepadMappingEdit clearButton(GamepadButton button) { return { Kind::ClearButton, int(button), -1, 0, false }; }
+    static DeckGamepadMappingEdit clearAxis(GamepadAxis axis) { return { Kind::ClearAxis, int(axis), -1, 0, false }; }
+};
 
 /// 自定义映射管理器（SDL mapping 格式，优先于 SDL DB）。
 /// 负责加载/保存映射文件，并可将映射应用到运行中设备。
+///
+/// 线程模型：
+/// - 编辑/查询接口可在任意线程直接调用（内部加锁），设备 GUID/名称/物理表取自 backend 发布的快照，
+///   不会阻塞等待 backend 线程。
+/// - 作用到设备的操作（applyMapping / resetToSdlDefault / commitEdits）以事务形式排队到 backend 线程异步执行，
+///   立即返回事务 ID；完成后发出 transactionFinished（成功的 apply 另发 mappingApplied）。
 class DECKGAMEPAD_EXPORT DeckGamepadCustomMappingManager : public QObject
 {
     Q_OBJECT
@@ -52,6 +108,11 @@ public:
     void clearButtonMapping(int deviceId, GamepadButton logicalButton);
     void clearAxisMapping(int deviceId, GamepadAxis logicalAxis);
 
+    // 批量编辑：一次物化、一次重组 SDL 字符串、一次 mappingChanged；任一条无效时整体不生效。
+    bool applyEdits(int deviceId, const QList<DeckGamepadMappingEdit> &edits);
+    // applyEdits 后排队一次设备重载；返回事务 ID（0 表示失败）。
+    quint64 commitEdits(int deviceId, const QList<DeckGamepadMappingEdit> &edits);
+
     // 预设模板
 
     bool loadPreset(int deviceId, const QString &presetName);
@@ -78,11 +139,21 @@ public:
     void setLegacyDirName(const QString &dirName);
     QString legacyDirName() const;
 
-    // 应用/重置
+    // 应用/重置（异步事务，见类说明）
 
+    // 返回 true 表示事务已排队；结果见 transactionFinished / mappingApplied。
     bool applyMapping(int deviceId);
+    quint64 applyMappingAsync(int deviceId);
 
     bool resetToSdlDefault(int deviceId);
+    quint64 resetToSdlDefaultAsync(int deviceId);
+
+    // 物理表快照（由 backend 在其线程调用发布/撤回；读取可在任意线程）
+
+    void publishDeviceSnapshot(const DeckGamepadDevice *device);
+    void retractDeviceSnapshot(int deviceId);
+    void retractAllDeviceSnapshots();
+    std::shared_ptr<const DeckGamepadPhysicalMapSnapshot> deviceSnapshot(int deviceId) const;
 
     // 校验
 
@@ -102,21 +173,40 @@ Q_SIGNALS:
     void mappingRemoved(const QString &guid);
     void mappingSaved(const QString &filePath);
     void mappingApplied(int deviceId);
+    // 设备事务完成（在 backend 线程发出）；ok=false 表示设备已不存在或 SDL 映射无效。
+    void transactionFinished(quint64 transactionId, int deviceId, bool ok);
 
 private:
+    struct StoredCustomMapping {
+        QString sdlString;
+        DeviceMapping cachedEvdevMapping;
+    };
+
     QString getDeviceGuid(int deviceId) const;
     QString getDeviceName(int deviceId) const;
     DeviceMapping createGenericMapping() const;
     void initializePresets();
 
-    struct StoredCustomMapping {
-        QString sdlString;
-        DeviceMapping cachedEvdevMapping;
-    };
-    
+    // 以下 *Locked 需持有 m_stateMutex。
+    StoredCustomMapping *materializeLocked(int deviceId,
+                                           const DeckGamepadPhysicalMapSnapshot &snapshot,
+                                           const char *operation);
+    bool applyEditsLocked(int deviceId, const QList<DeckGamepadMappingEdit> &edits, QString *changedGuid);
+    QString resolveApplySdlStringLocked(int deviceId, QString *guid);
+
+    // sdlString 为空表示移除自定义映射（回到 SDL DB 默认）。
+    quint64 enqueueDeviceTransaction(int deviceId, const QString &guid, const QString &sdlString);
+
     DeckGamepadBackend *m_backend;
     DeckGamepadSdlControllerDb *m_sdlDb;
 
+    mutable QRecursiveMutex m_stateMutex;
+
+    mutable QMutex m_snapshotMutex;
+    QHash<int, std::shared_ptr<const DeckGamepadPhysicalMapSnapshot>> m_snapshots;
+
+    std::atomic<quint64> m_nextTransactionId{ 1 };
+
     // 自定义映射：GUID -> SDL mapping string（并在需要时按 device physical map 物化为 DeviceMapping）
     QHash<QString, StoredCustomMapping> m_customMappings;
 
@@ -4,12 +4,13 @@
 
 #include <deckshell/deckgamepad/mapping/deckgamepadsdlcontrollerdb.h>
 #include <deckshell/deckgamepad/mapping/deckgamepadsdlcontrollerdb_p.h>
+#include <deckshell/deckgamepad/mapping/deckgamepadsdldbimage_p.h>
 
 #include <QtCore/QFile>
-#include <QtCore/QTextStream>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
 
 #include <libudev.h>
 #include <linux/input.h>
@@ -22,91 +23,138 @@ DECKGAMEPAD_BEGIN_NAMESPACE
 
 // ========== DeckGamepadSdlControllerDbPrivate Implementation ==========
 
-bool DeckGamepadSdlControllerDbPrivate::parseMappingLine(const QString &line, SdlRawMapping &out)
+namespace {
+
+struct SdlButtonKey {
+    const char *key;
+    GamepadButton button;
+};
+
+struct SdlAxisKey {
+    const char *key;
+    GamepadAxis axis;
+};
+
+constexpr SdlButtonKey kSdlButtonKeys[] = {
+    { "a", GAMEPAD_BUTTON_A },
+    { "b", GAMEPAD_BUTTON_B },
+    { "x", GAMEPAD_BUTTON_X },
+    { "y", GAMEPAD_BUTTON_Y },
+    { "back", GAMEPAD_BUTTON_SELECT },
+    { "start", GAMEPAD_BUTTON_START },
+    { "guide", GAMEPAD_BUTTON_GUIDE },
+    { "leftshoulder", GAMEPAD_BUTTON_L1 },
+    { "rightshoulder", GAMEPAD_BUTTON_R1 },
+    { "leftstick", GAMEPAD_BUTTON_L3 },
+    { "rightstick", GAMEPAD_BUTTON_R3 },
+    { "dpup", GAMEPAD_BUTTON_DPAD_UP },
+    { "dpdown", GAMEPAD_BUTTON_DPAD_DOWN },
+    { "dpleft", GAMEPAD_BUTTON_DPAD_LEFT },
+    { "dpright", GAMEPAD_BUTTON_DPAD_RIGHT },
+};
+
+constexpr SdlAxisKey kSdlAxisKeys[] = {
+    { "leftx", GAMEPAD_AXIS_LEFT_X },
+    { "lefty", GAMEPAD_AXIS_LEFT_Y },
+    { "rightx", GAMEPAD_AXIS_RIGHT_X },
+    { "righty", GAMEPAD_AXIS_RIGHT_Y },
+    { "lefttrigger", GAMEPAD_AXIS_TRIGGER_LEFT },
+    { "righttrigger", GAMEPAD_AXIS_TRIGGER_RIGHT },
+};
+
+bool isLinuxMapping(const SdlRawMapping &mapping)
 {
-    // Skip comments and empty lines
-    QString trimmed = line.trimmed();
-    if (trimmed.isEmpty() || trimmed.startsWith('#')) {
+    return mapping.platform.isEmpty() || mapping.platform.compare(QLatin1String("Linux"), Qt::CaseInsensitive) == 0;
+}
+
+bool writeIndexFile(const QString &indexPath, const QByteArray &bytes)
+{
+    const QFileInfo info(indexPath);
+    if (!QDir().mkpath(info.absolutePath())) {
         return false;
     }
-    
-    QStringList parts = trimmed.split(',');
-    if (parts.size() < 3) {
+
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (file.write(bytes) != bytes.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+} // namespace
+
+DeckGamepadSdlControllerDbPrivate::DeckGamepadSdlControllerDbPrivate()
+    : loadedCount(0)
+{
+}
+
+DeckGamepadSdlControllerDbPrivate::~DeckGamepadSdlControllerDbPrivate() = default;
+
+bool DeckGamepadSdlControllerDbPrivate::parseMappingLine(QStringView line, SdlRawMapping &out)
+{
+    // Skip comments and empty lines
+    const QStringView trimmed = line.trimmed();
+    if (trimmed.isEmpty() || trimmed.startsWith(u'#')) {
         return false;
     }
     
-    out.guid = parts[0].trimmed().toLower();
-    out.name = parts[1].trimmed();
-    
-    // Parse mapping items
-    for (int i = 2; i < parts.size(); ++i) {
-        QString item = parts[i].trimmed();
-        QStringList kv = item.split(':');
-        if (kv.size() != 2) {
-            continue;
-        }
-        
-        QString key = kv[0].toLower();
-        QString value = kv[1];
-        
-        // Platform identifier
-        if (key == "platform") {
-            out.platform = value;
-            continue;
-        }
-        
-        // Parse button mappings
-        if (key == "a") {
-            out.buttons[GAMEPAD_BUTTON_A] = parseInputBinding(value);
-        } else if (key == "b") {
-            out.buttons[GAMEPAD_BUTTON_B] = parseInputBinding(value);
-        } else if (key == "x") {
-            out.buttons[GAMEPAD_BUTTON_X] = parseInputBinding(value);
-        } else if (key == "y") {
-            out.buttons[GAMEPAD_BUTTON_Y] = parseInputBinding(value);
-        } else if (key == "back") {
-            out.buttons[GAMEPAD_BUTTON_SELECT] = parseInputBinding(value);
-        } else if (key == "start") {
-            out.buttons[GAMEPAD_BUTTON_START] = parseInputBinding(value);
-        } else if (key == "guide") {
-            out.buttons[GAMEPAD_BUTTON_GUIDE] = parseInputBinding(value);
-        } else if (key == "leftshoulder") {
-            out.buttons[GAMEPAD_BUTTON_L1] = parseInputBinding(value);
-        } else if (key == "rightshoulder") {
-            out.buttons[GAMEPAD_BUTTON_R1] = parseInputBinding(value);
-        } else if (key == "leftstick") {
-            out.buttons[GAMEPAD_BUTTON_L3] = parseInputBinding(value);
-        } else if (key == "rightstick") {
-            out.buttons[GAMEPAD_BUTTON_R3] = parseInputBinding(value);
-        } else if (key == "dpup") {
-            out.buttons[GAMEPAD_BUTTON_DPAD_UP] = parseInputBinding(value);
-        } else if (key == "dpdown") {
-            out.buttons[GAMEPAD_BUTTON_DPAD_DOWN] = parseInputBinding(value);
-        } else if (key == "dpleft") {
-            out.buttons[GAMEPAD_BUTTON_DPAD_LEFT] = parseInputBinding(value);
-        } else if (key == "dpright") {
-            out.buttons[GAMEPAD_BUTTON_DPAD_RIGHT] = parseInputBinding(value);
-        }
-        // Parse axis mappings
-        else if (key == "leftx") {
-            out.axes[GAMEPAD_AXIS_LEFT_X] = parseInputBinding(value);
-        } else if (key == "lefty") {
-            out.axes[GAMEPAD_AXIS_LEFT_Y] = parseInputBinding(value);
-        } else if (key == "rightx") {
-            out.axes[GAMEPAD_AXIS_RIGHT_X] = parseInputBinding(value);
-        } else if (key == "righty") {
-            out.axes[GAMEPAD_AXIS_RIGHT_Y] = parseInputBinding(value);
-        } else if (key == "lefttrigger") {
-            out.axes[GAMEPAD_AXIS_TRIGGER_LEFT] = parseInputBinding(value);
-        } else if (key == "righttrigger") {
-            out.axes[GAMEPAD_AXIS_TRIGGER_RIGHT] = parseInputBinding(value);
+    // 逐字段切分，不构造中间 QStringList：GUID,Name,key:value,...
+    int field = 0;
+    for (QStringView part : trimmed.tokenize(u',')) {
+        const QStringView item = part.trimmed();
+        if (field == 0) {
+            out.guid = item.toString().toLower();
+        } else if (field == 1) {
+            out.name = item.toString();
+        } else {
+            const qsizetype colon = item.indexOf(u':');
+            if (colon < 0 || item.indexOf(u':', colon + 1) >= 0) {
+                ++field;
+                continue;
+            }
+
+            const QStringView key = item.left(colon);
+            const QStringView value = item.mid(colon + 1);
+
+            // Platform identifier
+            if (key.compare(QLatin1String("platform"), Qt::CaseInsensitive) == 0) {
+                out.platform = value.toString();
+                ++field;
+                continue;
+            }
+
+            bool matched = false;
+            for (const SdlButtonKey &entry : kSdlButtonKeys) {
+                if (key.compare(QLatin1String(entry.key), Qt::CaseInsensitive) == 0) {
+                    out.buttons[entry.button] = parseInputBinding(value);
+                    matched = true;
+                    break;
+                }
+            }
+            if (!matched) {
+                for (const SdlAxisKey &entry : kSdlAxisKeys) {
+                    if (key.compare(QLatin1String(entry.key), Qt::CaseInsensitive) == 0) {
+                        out.axes[entry.axis] = parseInputBinding(value);
+                        break;
+                    }
+                }
+            }
         }
+        ++field;
+    }
+
+    if (field < 3) {
+        return false;
     }
     
     return out.isValid();
 }
 
-SdlInputBinding DeckGamepadSdlControllerDbPrivate::parseInputBinding(const QString &value)
+SdlInputBinding DeckGamepadSdlControllerDbPrivate::parseInputBinding(QStringView value)
 {
     SdlInputBinding binding;
     
@@ -114,37 +162,38 @@ SdlInputBinding DeckGamepadSdlControllerDbPrivate::parseInputBinding(const QStri
         return binding;
     }
     
-    if (value.startsWith('b')) {
+    if (value.startsWith(u'b')) {
         // Button: b0, b1, b2, ...
         binding.type = SdlInputBinding::Button;
         binding.index = value.mid(1).toInt();
     }
-    else if (value.startsWith('h')) {
+    else if (value.startsWith(u'h')) {
         // HAT: h0.1, h0.2, h0.4, h0.8
         binding.type = SdlInputBinding::Hat;
-        QStringList hatParts = value.mid(1).split('.');
-        if (hatParts.size() == 2) {
-            binding.index = hatParts[0].toInt();
-            binding.hatMask = hatParts[1].toInt();
+        const QStringView hat = value.mid(1);
+        const qsizetype dot = hat.indexOf(u'.');
+        if (dot >= 0 && hat.indexOf(u'.', dot + 1) < 0) {
+            binding.index = hat.left(dot).toInt();
+            binding.hatMask = hat.mid(dot + 1).toInt();
         }
     }
-    else if (value.startsWith('+')) {
+    else if (value.startsWith(u'+')) {
         // Positive half-axis: +a0, +a1
         binding.type = SdlInputBinding::HalfAxisPos;
         binding.index = value.mid(2).toInt();  // skip "+a"
     }
-    else if (value.startsWith('-')) {
+    else if (value.startsWith(u'-')) {
         // Negative half-axis: -a0, -a1
         binding.type = SdlInputBinding::HalfAxisNeg;
         binding.index = value.mid(2).toInt();  // skip "-a"
     }
-    else if (value.startsWith('~')) {
+    else if (value.startsWith(u'~')) {
         // Inverted axis: ~a0, ~a1
         binding.type = SdlInputBinding::Axis;
         binding.index = value.mid(2).toInt();  // skip "~a"
         binding.inverted = true;
     }
-    else if (value.startsWith('a')) {
+    else if (value.startsWith(u'a')) {
         // Normal axis: a0, a1, a2, ...
         binding.type = SdlInputBinding::Axis;
         binding.index = value.mid(1).toInt();
@@ -153,6 +202,68 @@ SdlInputBinding DeckGamepadSdlControllerDbPrivate::parseInputBinding(const QStri
     return binding;
 }
 
+int DeckGamepadSdlControllerDbPrivate::parseDatabaseText(const QByteArray &content,
+                                                         QHash<QString, SdlRawMapping> &out)
+{
+    const QString text = QString::fromUtf8(content);
+    int loadedCount = 0;
+
+    for (QStringView line : QStringView(text).tokenize(u'\n')) {
+        SdlRawMapping mapping;
+        // Only load Linux mappings
+        if (parseMappingLine(line, mapping) && isLinuxMapping(mapping)) {
+            const QString guid = mapping.guid;
+            out.insert(guid, std::move(mapping));
+            loadedCount++;
+        }
+    }
+
+    return loadedCount;
+}
+
+bool DeckGamepadSdlControllerDbPrivate::baseContains(const QString &guid) const
+{
+    return baseImage && baseImage->indexOf(guid) >= 0;
+}
+
+bool DeckGamepadSdlControllerDbPrivate::containsMapping(const QString &guid) const
+{
+    if (mappings.contains(guid)) {
+        return true;
+    }
+    return !removedBaseGuids.contains(guid) && baseContains(guid);
+}
+
+bool DeckGamepadSdlControllerDbPrivate::findMapping(const QString &guid, SdlRawMapping &out) const
+{
+    const auto it = mappings.constFind(guid);
+    if (it != mappings.cend()) {
+        out = it.value();
+        return true;
+    }
+
+    if (!baseImage || removedBaseGuids.contains(guid)) {
+        return false;
+    }
+    // 仅在真正需要时解码单条记录
+    return baseImage->decode(baseImage->indexOf(guid), out);
+}
+
+int DeckGamepadSdlControllerDbPrivate::totalMappingCount() const
+{
+    int count = mappings.size();
+    if (baseImage) {
+        // removedBaseGuids 与 overlay 不相交（addMapping 会从 removed 中移除）
+        count += baseImage->count() - removedBaseGuids.size();
+        for (auto it = mappings.cbegin(); it != mappings.cend(); ++it) {
+            if (baseContains(it.key())) {
+                --count;
+            }
+        }
+    }
+    return count;
+}
+
 DeviceMapping DeckGamepadSdlControllerDbPrivate::convertToDeviceMapping(
     const SdlRawMapping &rawMapping,
     const QHash<int, int> &physicalButtonMap,
@@ -239,39 +350,74 @@ int DeckGamepadSdlControllerDb::loadDatabase(const QString &filePath)
     // Clear existing mappings
     clear();
     
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    SdlDbSourceStamp stamp = SdlDbSourceStamp::forFile(filePath);
+    if (!stamp.isValid()) {
         qWarning() << "Failed to open SDL GameController DB:" << filePath;
         return -1;
     }
-    
-    d->databasePath = filePath;
-    
-    QTextStream in(&file);
-    int lineNum = 0;
-    int loadedCount = 0;
-    
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        lineNum++;
-        
-        SdlRawMapping mapping;
-        if (d->parseMappingLine(line, mapping)) {
-            // Only load Linux mappings
-            if (mapping.platform.isEmpty() || 
-                mapping.platform.compare("Linux", Qt::CaseInsensitive) == 0) {
-                d->mappings[mapping.guid] = mapping;
-                loadedCount++;
+
+    // 1) 预编译 index：运行期缓存优先（mtime 命中时无需读取源文件），其次是构建期生成的同名 .bin
+    const QString cachePath = DeckGamepadSdlDbImage::userCachePath(filePath);
+    const QString candidates[] = { cachePath, DeckGamepadSdlDbImage::precompiledSiblingPath(filePath) };
+    for (const QString &candidate : candidates) {
+        if (candidate.isEmpty() || !QFileInfo::exists(candidate)) {
+            continue;
+        }
+        auto image = std::make_unique<DeckGamepadSdlDbImage>();
+        if (image->open(candidate) && image->matchesSource(filePath, stamp)) {
+            // 安装的只读 .bin 与源文件 mtime 总是不同，每次启动都要重算内容哈希；
+            // 哈希确认后写一份带当前 mtime 的运行期缓存，下次启动在缓存上直接命中。
+            if (candidate != cachePath && stamp.contentHash != 0 && !cachePath.isEmpty()
+                && !writeIndexFile(cachePath, image->restamped(stamp))) {
+                qWarning() << "Failed to write SDL DB index cache:" << cachePath;
             }
+            d->baseImage = std::move(image);
+            break;
+        }
+    }
+
+    // 2) 未命中：解析文本并写入运行期缓存，下次启动直接 mmap
+    if (!d->baseImage) {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Failed to open SDL GameController DB:" << filePath;
+            return -1;
+        }
+
+        const QByteArray content = file.readAll();
+        stamp.contentHash = SdlDbSourceStamp::hashBytes(content);
+
+        QHash<QString, SdlRawMapping> parsed;
+        d->parseDatabaseText(content, parsed);
+
+        if (!cachePath.isEmpty() && writeIndexFile(cachePath, DeckGamepadSdlDbImage::serialize(parsed, stamp))) {
+            auto image = std::make_unique<DeckGamepadSdlDbImage>();
+            if (image->open(cachePath)) {
+                d->baseImage = std::move(image);
+            }
+        }
+
+        if (d->baseImage) {
+            // index 无法表示的条目（非常规 GUID）留在内存覆盖层
+            for (auto it = parsed.begin(); it != parsed.end(); ++it) {
+                if (!DeckGamepadSdlDbImage::canSerializeGuid(it.key())) {
+                    d->mappings.insert(it.key(), std::move(it.value()));
+                }
+            }
+        } else {
+            qWarning() << "Failed to write SDL DB index cache, keeping mappings in memory:" << cachePath;
+            d->mappings = std::move(parsed);
         }
     }
     
-    d->loadedCount = loadedCount;
+    d->databasePath = filePath;
+    d->loadedCount = d->totalMappingCount();
     
-    qInfo() << "Loaded" << loadedCount << "SDL mappings from" << filePath;
-    emit databaseLoaded(loadedCount);
+    qInfo() << "Loaded" << d->loadedCount << "SDL mappings from" << filePath
+            << "index:" << (d->baseImage ? d->baseImage->path() : QStringLiteral("<memory>"));
+    emit databaseLoaded(d->loadedCount);
     
-    return loadedCount;
+    return d->loadedCount;
 }
 
 int DeckGamepadSdlControllerDb::appendDatabase(const QString &filePath)
@@ -279,28 +425,20 @@ int DeckGamepadSdlControllerDb::appendDatabase(const QString &filePath)
     Q_D(DeckGamepadSdlControllerDb);
     
     QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open SDL GameController DB:" << filePath;
         return -1;
     }
     
-    QTextStream in(&file);
-    int loadedCount = 0;
-    
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        
-        SdlRawMapping mapping;
-        if (d->parseMappingLine(line, mapping)) {
-            if (mapping.platform.isEmpty() || 
-                mapping.platform.compare("Linux", Qt::CaseInsensitive) == 0) {
-                d->mappings[mapping.guid] = mapping;
-                loadedCount++;
-            }
-        }
+    // 覆盖层叠加在 mmap 的基础 index 之上
+    QHash<QString, SdlRawMapping> parsed;
+    const int loadedCount = d->parseDatabaseText(file.readAll(), parsed);
+    for (auto it = parsed.begin(); it != parsed.end(); ++it) {
+        d->removedBaseGuids.remove(it.key());
+        d->mappings.insert(it.key(), std::move(it.value()));
     }
     
-    d->loadedCount = d->mappings.size();
+    d->loadedCount = d->totalMappingCount();
     
     qInfo() << "Appended" << loadedCount << "SDL mappings from" << filePath;
     emit databaseLoaded(loadedCount);
@@ -312,6 +450,8 @@ void DeckGamepadSdlControllerDb::clear()
 {
     Q_D(DeckGamepadSdlControllerDb);
     d->mappings.clear();
+    d->baseImage.reset();
+    d->removedBaseGuids.clear();
     d->loadedCount = 0;
     d->databasePath.clear();
 }
@@ -319,22 +459,51 @@ void DeckGamepadSdlControllerDb::clear()
 int DeckGamepadSdlControllerDb::mappingCount() const
 {
     Q_D(const DeckGamepadSdlControllerDb);
-    return d->mappings.size();
+    return d->totalMappingCount();
+}
+
+QString DeckGamepadSdlControllerDb::indexPath() const
+{
+    Q_D(const DeckGamepadSdlControllerDb);
+    return d->baseImage ? d->baseImage->path() : QString();
+}
+
+bool DeckGamepadSdlControllerDb::compileDatabase(const QString &sourcePath, const QString &outputPath)
+{
+    QFile file(sourcePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open SDL GameController DB:" << sourcePath;
+        return false;
+    }
+
+    SdlDbSourceStamp stamp = SdlDbSourceStamp::forFile(sourcePath);
+    const QByteArray content = file.readAll();
+    stamp.contentHash = SdlDbSourceStamp::hashBytes(content);
+
+    DeckGamepadSdlControllerDbPrivate parser;
+    QHash<QString, SdlRawMapping> parsed;
+    parser.parseDatabaseText(content, parsed);
+
+    if (!writeIndexFile(outputPath, DeckGamepadSdlDbImage::serialize(parsed, stamp))) {
+        qWarning() << "Failed to write SDL DB index:" << outputPath;
+        return false;
+    }
+    return true;
 }
 
 bool DeckGamepadSdlControllerDb::hasMapping(const QString &guid) const
 {
     Q_D(const DeckGamepadSdlControllerDb);
-    return d->mappings.contains(guid.toLower());
+    return d->containsMapping(guid.toLower());
 }
 
 QString DeckGamepadSdlControllerDb::getDeviceName(const QString &guid) const
 {
     Q_D(const DeckGamepadSdlControllerDb);
-    QString lowerGuid = guid.toLower();
     
-    if (d->mappings.contains(lowerGuid)) {
-        return d->mappings[lowerGuid].name;
+    SdlRawMapping rawMapping;
+    if (d->findMapping(guid.toLower(), rawMapping)) {
+        return rawMapping.name;
     }
     
     return QString();
@@ -347,13 +516,11 @@ DeviceMapping DeckGamepadSdlControllerDb::createDeviceMapping(
 {
     Q_D(const DeckGamepadSdlControllerDb);
     
-    QString lowerGuid = guid.toLower();
-    
-    if (!d->mappings.contains(lowerGuid)) {
+    SdlRawMapping rawMapping;
+    if (!d->findMapping(guid.toLower(), rawMapping)) {
         return DeviceMapping();  // Empty mapping
     }
     
-    const SdlRawMapping &rawMapping = d->mappings[lowerGuid];
     return d->convertToDeviceMapping(rawMapping, physicalButtonMap, physicalAxisMap);
 }
 
@@ -582,10 +749,12 @@ bool DeckGamepadSdlControllerDb::addMapping(const QString &mappingString)
         return false;
     }
     
-    d->mappings[mapping.guid] = mapping;
-    d->loadedCount = d->mappings.size();
+    const QString guid = mapping.guid;
+    d->removedBaseGuids.remove(guid);
+    d->mappings[guid] = std::move(mapping);
+    d->loadedCount = d->totalMappingCount();
     
-    emit mappingAdded(mapping.guid);
+    emit mappingAdded(guid);
     return true;
 }
 
@@ -594,8 +763,14 @@ void DeckGamepadSdlControllerDb::removeMapping(const QString &guid)
     Q_D(DeckGamepadSdlControllerDb);
     
     QString lowerGuid = guid.toLower();
-    if (d->mappings.remove(lowerGuid)) {
-        d->loadedCount = d->mappings.size();
+    bool removed = d->mappings.remove(lowerGuid);
+    if (d->baseContains(lowerGuid) && !d->removedBaseGuids.contains(lowerGuid)) {
+        d->removedBaseGuids.insert(lowerGuid);
+        removed = true;
+    }
+
+    if (removed) {
+        d->loadedCount = d->totalMappingCount();
         emit mappingRemoved(guid);
     }
 }
@@ -608,8 +783,17 @@ QStringList DeckGamepadSdlControllerDb::exportMappings() const
     
     // This would require reversing the mapping back to SDL format
     // For now, just return GUIDs
-    for (const QString &guid : d->mappings.keys()) {
-        result.append(guid);
+    result.reserve(d->totalMappingCount());
+    for (auto it = d->mappings.cbegin(); it != d->mappings.cend(); ++it) {
+        result.append(it.key());
+    }
+    if (d->baseImage) {
+        for (int i = 0; i < d->baseImage->count(); ++i) {
+            const QString guid = d->baseImage->guidAt(i);
+            if (!d->mappings.contains(guid) && !d->removedBaseGuids.contains(guid)) {
+                result.append(guid);
+            }
+        }
     }
     
     return result;
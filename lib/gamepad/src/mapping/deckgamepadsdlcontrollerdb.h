@@ -65,6 +65,24 @@ public:
      */
     int mappingCount() const;
     
+    /**
+     * @brief Path of the memory-mapped precompiled index backing the database
+     * @return Index path, or empty when mappings are held in memory only
+     * 
+     * loadDatabase() first tries the per-user cache index and then the
+     * build-time sibling index (gamecontrollerdb.bin); on a miss the text
+     * database is parsed once and the cache index is (re)written.
+     */
+    QString indexPath() const;
+    
+    /**
+     * @brief Compile a text database into a binary index (build-time helper)
+     * @param sourcePath Path to gamecontrollerdb.txt
+     * @param outputPath Path of the index file to write
+     * @return true on success
+     */
+    static bool compileDatabase(const QString &sourcePath, const QString &outputPath);
+    
     // ========== Query API ==========
     
     /**
@@ -6,7 +6,11 @@
 
 #include <deckshell/deckgamepad/mapping/deckgamepadmapping.h>
 #include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QString>
+#include <QtCore/QStringView>
+
+#include <memory>
 
 DECKGAMEPAD_BEGIN_NAMESPACE
 
@@ -63,24 +67,41 @@ struct SdlRawMapping {
     }
 };
 
+class DeckGamepadSdlDbImage;
+
 /**
  * @brief Private data for DeckGamepadSdlControllerDb
+ *
+ * 查询顺序：内存覆盖层（mappings，来自 appendDatabase/addMapping 或无法写缓存时的文本解析结果）
+ * → 已删除集合（removedBaseGuids）→ mmap 的预编译 index（baseImage，按需解码）。
  */
 class DeckGamepadSdlControllerDbPrivate
 {
 public:
-    DeckGamepadSdlControllerDbPrivate() : loadedCount(0) {}
+    DeckGamepadSdlControllerDbPrivate();
+    ~DeckGamepadSdlControllerDbPrivate();
     
-    // Database storage: GUID → raw mapping
+    // Overlay storage: GUID → raw mapping
     QHash<QString, SdlRawMapping> mappings;
+
+    // Precompiled base index (mmap), plus base GUIDs hidden by removeMapping()
+    std::unique_ptr<DeckGamepadSdlDbImage> baseImage;
+    QSet<QString> removedBaseGuids;
     
     // Metadata
     QString databasePath;
     int loadedCount;
     
     // Parsing helpers
-    bool parseMappingLine(const QString &line, SdlRawMapping &out);
-    SdlInputBinding parseInputBinding(const QString &value);
+    bool parseMappingLine(QStringView line, SdlRawMapping &out);
+    SdlInputBinding parseInputBinding(QStringView value);
+    int parseDatabaseText(const QByteArray &content, QHash<QString, SdlRawMapping> &out);
+
+    // Lookup helpers (guid must be lowercase)
+    bool baseContains(const QString &guid) const;
+    bool containsMapping(const QString &guid) const;
+    bool findMapping(const QString &guid, SdlRawMapping &out) const;
+    int totalMappingCount() const;
     
     // Conversion helper
     DeviceMapping convertToDeviceMapping(
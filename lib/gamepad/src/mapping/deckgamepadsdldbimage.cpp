@@ -0,0 +1,421 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/mapping/deckgamepadsdldbimage_p.h>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+namespace {
+
+constexpr char kMagic[8] = { 'D', 'G', 'S', 'D', 'L', 'D', 'B', '\0' };
+constexpr quint32 kFormatVersion = 1;
+
+constexpr quint8 kAxisTargetFlag = 0x80;
+constexpr quint8 kInvertedFlag = 0x80;
+constexpr int kRecordHeaderSize = 4; // nameLength(u16) + bindingCount(u8) + reserved(u8)
+constexpr int kBindingSize = 6;      // target(u8) + type|flags(u8) + index(u16) + hatMask(u8) + pad(u8)
+
+template <typename T>
+T readValue(const uchar *p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void appendValue(QByteArray &out, T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void appendBinding(QByteArray &out, quint8 target, const SdlInputBinding &binding)
+{
+    appendValue<quint8>(out, target);
+    appendValue<quint8>(out, static_cast<quint8>(binding.type) | (binding.inverted ? kInvertedFlag : 0));
+    appendValue<quint16>(out, static_cast<quint16>(binding.index));
+    appendValue<quint8>(out, static_cast<quint8>(binding.hatMask));
+    appendValue<quint8>(out, 0);
+}
+
+QByteArray guidKey(const QString &lowerGuid)
+{
+    QByteArray key = lowerGuid.toLatin1();
+    key.resize(DeckGamepadSdlDbImage::kGuidLength, '\0');
+    return key;
+}
+
+quint64 fnv1a64(const uchar *data, qint64 size)
+{
+    quint64 hash = 0xcbf29ce484222325ULL;
+    for (qint64 i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+struct DeckGamepadSdlDbImage::Header {
+    char magic[8];
+    quint32 version;
+    quint32 entryCount;
+    qint64 sourceSize;
+    qint64 sourceMtimeNs;
+    quint64 sourceHash;
+    quint32 indexOffset;
+    quint32 recordsOffset;
+    quint32 totalSize;
+    quint32 reserved[3];
+};
+
+struct DeckGamepadSdlDbImage::IndexEntry {
+    char guid[kGuidLength];
+    quint32 recordOffset; // 相对 records 段起点
+    quint32 recordSize;
+};
+
+// ========== SdlDbSourceStamp ==========
+
+SdlDbSourceStamp SdlDbSourceStamp::forFile(const QString &filePath)
+{
+    SdlDbSourceStamp stamp;
+    struct stat st;
+    if (::stat(QFile::encodeName(filePath).constData(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return stamp;
+    }
+
+    stamp.size = static_cast<qint64>(st.st_size);
+    stamp.mtimeNs = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return stamp;
+}
+
+quint64 SdlDbSourceStamp::hashFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    const qint64 size = file.size();
+    if (size == 0) {
+        return fnv1a64(nullptr, 0);
+    }
+    if (const uchar *data = file.map(0, size)) {
+        const quint64 hash = fnv1a64(data, size);
+        file.unmap(const_cast<uchar *>(data));
+        return hash;
+    }
+
+    const QByteArray bytes = file.readAll();
+    return hashBytes(bytes);
+}
+
+quint64 SdlDbSourceStamp::hashBytes(QByteArrayView bytes)
+{
+    return fnv1a64(reinterpret_cast<const uchar *>(bytes.data()), bytes.size());
+}
+
+// ========== DeckGamepadSdlDbImage ==========
+
+DeckGamepadSdlDbImage::~DeckGamepadSdlDbImage()
+{
+    close();
+}
+
+void DeckGamepadSdlDbImage::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+    m_entryCount = 0;
+    m_indexOffset = 0;
+    m_recordsOffset = 0;
+    m_sourceSize = -1;
+    m_sourceMtimeNs = 0;
+    m_sourceHash = 0;
+}
+
+bool DeckGamepadSdlDbImage::open(const QString &indexPath)
+{
+    static_assert(sizeof(Header) == 64, "SDL DB index header must stay 64 bytes");
+    static_assert(sizeof(IndexEntry) == 40, "SDL DB index entry must stay 40 bytes");
+
+    close();
+
+    m_file.setFileName(indexPath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    if (size < static_cast<qint64>(sizeof(Header))) {
+        m_file.close();
+        return false;
+    }
+
+    const uchar *data = m_file.map(0, size);
+    if (!data) {
+        m_file.close();
+        return false;
+    }
+
+    const Header header = readValue<Header>(data);
+    const qint64 indexEnd = qint64(header.indexOffset) + qint64(header.entryCount) * qint64(sizeof(IndexEntry));
+    const bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+        && header.version == kFormatVersion
+        && header.totalSize == size
+        && header.indexOffset >= sizeof(Header)
+        && header.indexOffset % alignof(IndexEntry) == 0
+        && indexEnd <= header.recordsOffset
+        && header.recordsOffset <= size;
+    if (!valid) {
+        qWarning() << "Ignoring invalid SDL DB index:" << indexPath;
+        m_file.unmap(const_cast<uchar *>(data));
+        m_file.close();
+        return false;
+    }
+
+    m_data = data;
+    m_size = size;
+    m_entryCount = header.entryCount;
+    m_indexOffset = header.indexOffset;
+    m_recordsOffset = header.recordsOffset;
+    m_sourceSize = header.sourceSize;
+    m_sourceMtimeNs = header.sourceMtimeNs;
+    m_sourceHash = header.sourceHash;
+    return true;
+}
+
+bool DeckGamepadSdlDbImage::matchesSource(const QString &sourcePath, SdlDbSourceStamp &stamp) const
+{
+    if (!m_data || !stamp.isValid() || m_sourceSize != stamp.size) {
+        return false;
+    }
+    if (m_sourceMtimeNs == stamp.mtimeNs) {
+        return true;
+    }
+
+    if (stamp.contentHash == 0) {
+        stamp.contentHash = SdlDbSourceStamp::hashFile(sourcePath);
+    }
+    return stamp.contentHash == m_sourceHash;
+}
+
+QByteArray DeckGamepadSdlDbImage::restamped(const SdlDbSourceStamp &stamp) const
+{
+    if (!m_data) {
+        return {};
+    }
+
+    QByteArray out(reinterpret_cast<const char *>(m_data), m_size);
+    Header header = readValue<Header>(m_data);
+    header.sourceSize = stamp.size;
+    header.sourceMtimeNs = stamp.mtimeNs;
+    std::memcpy(out.data(), &header, sizeof(header));
+    return out;
+}
+
+const DeckGamepadSdlDbImage::IndexEntry *DeckGamepadSdlDbImage::entryAt(int index) const
+{
+    return reinterpret_cast<const IndexEntry *>(m_data + m_indexOffset) + index;
+}
+
+int DeckGamepadSdlDbImage::indexOf(const QString &lowerGuid) const
+{
+    if (!m_data || !canSerializeGuid(lowerGuid)) {
+        return -1;
+    }
+
+    const QByteArray key = guidKey(lowerGuid);
+    const IndexEntry *begin = entryAt(0);
+    const IndexEntry *end = begin + m_entryCount;
+    const IndexEntry *it = std::lower_bound(begin, end, key, [](const IndexEntry &entry, const QByteArray &k) {
+        return std::memcmp(entry.guid, k.constData(), kGuidLength) < 0;
+    });
+    if (it == end || std::memcmp(it->guid, key.constData(), kGuidLength) != 0) {
+        return -1;
+    }
+    return static_cast<int>(it - begin);
+}
+
+QString DeckGamepadSdlDbImage::guidAt(int index) const
+{
+    if (!m_data || index < 0 || index >= count()) {
+        return {};
+    }
+
+    const IndexEntry *entry = entryAt(index);
+    return QString::fromLatin1(entry->guid, qstrnlen(entry->guid, kGuidLength));
+}
+
+bool DeckGamepadSdlDbImage::decode(int index, SdlRawMapping &out) const
+{
+    if (!m_data || index < 0 || index >= count()) {
+        return false;
+    }
+
+    const IndexEntry *entry = entryAt(index);
+    const qint64 begin = qint64(m_recordsOffset) + entry->recordOffset;
+    const qint64 end = begin + entry->recordSize;
+    if (entry->recordSize < kRecordHeaderSize || end > m_size) {
+        return false;
+    }
+
+    const uchar *p = m_data + begin;
+    const quint16 nameLength = readValue<quint16>(p);
+    const quint8 bindingCount = p[2];
+    if (kRecordHeaderSize + nameLength + bindingCount * kBindingSize > int(entry->recordSize)) {
+        return false;
+    }
+    p += kRecordHeaderSize;
+
+    out = SdlRawMapping();
+    out.guid = guidAt(index);
+    out.name = QString::fromUtf8(reinterpret_cast<const char *>(p), nameLength);
+    p += nameLength;
+
+    for (int i = 0; i < bindingCount; ++i, p += kBindingSize) {
+        const quint8 target = p[0];
+        SdlInputBinding binding;
+        binding.type = static_cast<SdlInputBinding::Type>(p[1] & ~kInvertedFlag);
+        binding.inverted = (p[1] & kInvertedFlag) != 0;
+        binding.index = readValue<quint16>(p + 2);
+        binding.hatMask = p[4];
+
+        if (target & kAxisTargetFlag) {
+            const int axis = target & ~kAxisTargetFlag;
+            if (axis < GAMEPAD_AXIS_MAX) {
+                out.axes.insert(static_cast<GamepadAxis>(axis), binding);
+            }
+        } else if (target < GAMEPAD_BUTTON_MAX) {
+            out.buttons.insert(static_cast<GamepadButton>(target), binding);
+        }
+    }
+    return true;
+}
+
+bool DeckGamepadSdlDbImage::canSerializeGuid(const QString &lowerGuid)
+{
+    if (lowerGuid.isEmpty() || lowerGuid.size() > kGuidLength) {
+        return false;
+    }
+    for (QChar ch : lowerGuid) {
+        if (ch.unicode() == 0 || ch.unicode() > 0x7f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QByteArray DeckGamepadSdlDbImage::serialize(const QHash<QString, SdlRawMapping> &mappings,
+                                            const SdlDbSourceStamp &stamp)
+{
+    std::vector<std::pair<QByteArray, const SdlRawMapping *>> sorted;
+    sorted.reserve(static_cast<size_t>(mappings.size()));
+    for (auto it = mappings.constBegin(); it != mappings.constEnd(); ++it) {
+        if (canSerializeGuid(it.key())) {
+            sorted.emplace_back(guidKey(it.key()), &it.value());
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        return std::memcmp(a.first.constData(), b.first.constData(), kGuidLength) < 0;
+    });
+
+    QByteArray records;
+    QByteArray index;
+    index.reserve(static_cast<qsizetype>(sorted.size() * sizeof(IndexEntry)));
+
+    for (const auto &[key, mapping] : sorted) {
+        const QByteArray name = mapping->name.toUtf8().left(0xffff);
+
+        QList<GamepadButton> buttons = mapping->buttons.keys();
+        QList<GamepadAxis> axes = mapping->axes.keys();
+        std::sort(buttons.begin(), buttons.end());
+        std::sort(axes.begin(), axes.end());
+        const int bindingCount = std::min<int>(buttons.size() + axes.size(), 0xff);
+
+        const qsizetype recordOffset = records.size();
+        appendValue<quint16>(records, static_cast<quint16>(name.size()));
+        appendValue<quint8>(records, static_cast<quint8>(bindingCount));
+        appendValue<quint8>(records, 0);
+        records.append(name);
+
+        int written = 0;
+        for (GamepadButton button : std::as_const(buttons)) {
+            if (written++ < bindingCount) {
+                appendBinding(records, static_cast<quint8>(button), mapping->buttons.value(button));
+            }
+        }
+        for (GamepadAxis axis : std::as_const(axes)) {
+            if (written++ < bindingCount) {
+                appendBinding(records, kAxisTargetFlag | static_cast<quint8>(axis), mapping->axes.value(axis));
+            }
+        }
+
+        IndexEntry entry;
+        std::memcpy(entry.guid, key.constData(), kGuidLength);
+        entry.recordOffset = static_cast<quint32>(recordOffset);
+        entry.recordSize = static_cast<quint32>(records.size() - recordOffset);
+        index.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.entryCount = static_cast<quint32>(sorted.size());
+    header.sourceSize = stamp.size;
+    header.sourceMtimeNs = stamp.mtimeNs;
+    header.sourceHash = stamp.contentHash;
+    header.indexOffset = sizeof(Header);
+    header.recordsOffset = static_cast<quint32>(sizeof(Header) + index.size());
+    header.totalSize = static_cast<quint32>(header.recordsOffset + records.size());
+
+    QByteArray out;
+    out.reserve(header.totalSize);
+    out.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.append(index);
+    out.append(records);
+    return out;
+}
+
+QString DeckGamepadSdlDbImage::userCachePath(const QString &sourcePath)
+{
+    const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (cacheRoot.isEmpty()) {
+        return {};
+    }
+
+    const QByteArray absolutePath = QFileInfo(sourcePath).absoluteFilePath().toUtf8();
+    const QByteArray key = QCryptographicHash::hash(absolutePath, QCryptographicHash::Sha1).toHex().left(16);
+    return QDir(cacheRoot).filePath(QStringLiteral("deckshell-gamepad/sdldb-%1.bin").arg(QString::fromLatin1(key)));
+}
+
+QString DeckGamepadSdlDbImage::precompiledSiblingPath(const QString &sourcePath)
+{
+    const QFileInfo info(sourcePath);
+    return info.dir().filePath(info.completeBaseName() + QStringLiteral(".bin"));
+}
+
+DECKGAMEPAD_END_NAMESPACE
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <deckshell/deckgamepad/mapping/deckgamepadsdlcontrollerdb_p.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+/**
+ * @brief Source file stamp used to validate a precompiled SDL DB index
+ *
+ * size + mtime 命中即视为有效；mtime 不同（例如安装后时间戳变化）时再比较内容哈希，
+ * 哈希命中的只读预编译 index 会以当前 stamp 复制到运行期缓存，避免每次启动重复哈希。
+ */
+struct SdlDbSourceStamp {
+    qint64 size = -1;
+    qint64 mtimeNs = 0;
+    quint64 contentHash = 0; ///< FNV-1a 64，按需计算（0 表示尚未计算）
+
+    bool isValid() const { return size >= 0; }
+
+    static SdlDbSourceStamp forFile(const QString &filePath);
+    static quint64 hashFile(const QString &filePath);
+    static quint64 hashBytes(QByteArrayView bytes);
+};
+
+/**
+ * @brief Read-only view of a precompiled SDL GameController DB index
+ *
+ * 文件布局（小端，本机字节序）：
+ * - Header（64 字节）：magic / version / entryCount / 源文件 stamp / 各段偏移
+ * - Index：entryCount 个定长条目（32 字节小写 GUID + record 偏移/长度），按 GUID 升序
+ * - Records：name（UTF-8）+ 紧凑 binding 表
+ *
+ * 文件整体 mmap，查找为 GUID 二分；只有真正连接的设备才解码为 SdlRawMapping。
+ */
+class DeckGamepadSdlDbImage
+{
+public:
+    static constexpr int kGuidLength = 32;
+
+    DeckGamepadSdlDbImage() = default;
+    ~DeckGamepadSdlDbImage();
+
+    Q_DISABLE_COPY_MOVE(DeckGamepadSdlDbImage)
+
+    // 打开并校验 index 文件；失败时对象保持空状态。
+    bool open(const QString &indexPath);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    QString path() const { return m_file.fileName(); }
+
+    // 与源文件 stamp 对比：size 必须一致；mtime 不一致时回退到内容哈希（按需计算并缓存到 stamp）。
+    bool matchesSource(const QString &sourcePath, SdlDbSourceStamp &stamp) const;
+    // 复制整个 index 并把源文件 stamp 换成 stamp（用于已按内容哈希确认、仅 mtime 不同的只读 index）。
+    QByteArray restamped(const SdlDbSourceStamp &stamp) const;
+
+    int count() const { return static_cast<int>(m_entryCount); }
+    int indexOf(const QString &lowerGuid) const;
+    QString guidAt(int index) const;
+    bool decode(int index, SdlRawMapping &out) const;
+
+    // 序列化：entries 仅包含 Linux/无平台条目；GUID 超过 32 字符的条目被跳过（调用方保留在内存覆盖层）。
+    static QByteArray serialize(const QHash<QString, SdlRawMapping> &mappings, const SdlDbSourceStamp &stamp);
+    static bool canSerializeGuid(const QString &lowerGuid);
+
+    // 运行期缓存路径：$XDG_CACHE_HOME/deckshell-gamepad/sdldb-<hash(源文件绝对路径)>.bin
+    static QString userCachePath(const QString &sourcePath);
+    // 构建期预编译文件：与源文件同目录、同名 .bin（gamecontrollerdb.txt → gamecontrollerdb.bin）
+    static QString precompiledSiblingPath(const QString &sourcePath);
+
+private:
+    struct Header;
+    struct IndexEntry;
+
+    const IndexEntry *entryAt(int index) const;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    quint32 m_entryCount = 0;
+    quint32 m_indexOffset = 0;
+    quint32 m_recordsOffset = 0;
+    qint64 m_sourceSize = -1;
+    qint64 m_sourceMtimeNs = 0;
+    quint64 m_sourceHash = 0;
+};
+
+DECKGAMEPAD_END_NAMESPACE
@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "evdevinputring.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QSocketNotifier>
+
+#include <algorithm>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+EvdevInputRing::EvdevInputRing(QObject *parent)
+    : QObject(parent)
+{
+    m_eventFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_eventFd < 0) {
+        qWarning() << "Failed to create eventfd for evdev input ring:" << strerror(errno);
+        return;
+    }
+
+    m_notifier = new QSocketNotifier(m_eventFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &EvdevInputRing::handleWakeup);
+}
+
+EvdevInputRing::~EvdevInputRing()
+{
+    // 调用方需保证生产者已停止（backend 已销毁或已撤销 frame sink）。
+    for (std::atomic<Ring *> &slot : m_rings) {
+        delete slot.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+    }
+    if (m_eventFd >= 0) {
+        ::close(m_eventFd);
+        m_eventFd = -1;
+    }
+}
+
+EvdevInputRing::Ring *EvdevInputRing::producerRing(int deviceId)
+{
+    if (deviceId < 0 || deviceId >= kMaxDevices) {
+        return nullptr;
+    }
+
+    std::atomic<Ring *> &slot = m_rings[static_cast<size_t>(deviceId)];
+    Ring *ring = slot.load(std::memory_order_relaxed);
+    if (!ring) {
+        // 每个 deviceId 槽位只分配一次，之后复用到对象销毁。
+        ring = new Ring();
+        slot.store(ring, std::memory_order_release);
+    }
+    return ring;
+}
+
+bool EvdevInputRing::pushFrame(int deviceId, const DeckGamepadFrameEvent &frame)
+{
+    Ring *ring = producerRing(deviceId);
+    if (!ring) {
+        m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const size_t needed = static_cast<size_t>(frame.eventCount()) + 1;
+    Overflow &overflow = m_overflow[static_cast<size_t>(deviceId)];
+    if (overflow.pending.load(std::memory_order_acquire) || ring->writableCount() < needed) {
+        pushOverflow(deviceId, frame);
+        wakeConsumer();
+        return true;
+    }
+
+    EvdevInputRecord record;
+    for (const DeckGamepadButtonEvent &event : frame.buttons) {
+        record = EvdevInputRecord{};
+        record.kind = EvdevInputRecord::Button;
+        record.code = event.button;
+        record.timeMsec = event.time_msec;
+        record.pressed = event.pressed ? 1 : 0;
+        ring->stage(record);
+    }
+    for (const DeckGamepadAxisEvent &event : frame.axes) {
+        record = EvdevInputRecord{};
+        record.kind = EvdevInputRecord::Axis;
+        record.code = event.axis;
+        record.timeMsec = event.time_msec;
+        record.axisValue = event.value;
+        ring->stage(record);
+    }
+    for (const DeckGamepadHatEvent &event : frame.hats) {
+        record = EvdevInputRecord{};
+        record.kind = EvdevInputRecord::Hat;
+        record.code = event.hat;
+        record.timeMsec = event.time_msec;
+        record.hatValue = event.value;
+        ring->stage(record);
+    }
+
+    record = EvdevInputRecord{};
+    record.kind = EvdevInputRecord::FrameEnd;
+    record.timeMsec = frame.time_msec;
+    record.monotonicNs = frame.monotonicNs;
+    ring->stage(record);
+    ring->commit();
+
+    wakeConsumer();
+    return true;
+}
+
+void EvdevInputRing::pushOverflow(int deviceId, const DeckGamepadFrameEvent &frame)
+{
+    Overflow &overflow = m_overflow[static_cast<size_t>(deviceId)];
+    QMutexLocker locker(&overflow.mutex);
+
+    DeckGamepadFrameEvent &merged = overflow.frame;
+    if (overflow.pending.load(std::memory_order_relaxed)) {
+        m_coalescedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 跳变（按键、hat）必须逐个送达，否则丢失的 release 会让按键一直处于按下状态。
+    merged.buttons.append(frame.buttons);
+    merged.hats.append(frame.hats);
+    for (const DeckGamepadAxisEvent &event : frame.axes) {
+        auto it = std::find_if(merged.axes.begin(), merged.axes.end(), [&event](const DeckGamepadAxisEvent &e) {
+            return e.axis == event.axis;
+        });
+        if (it != merged.axes.end()) {
+            *it = event;
+        } else {
+            merged.axes.append(event);
+        }
+    }
+    merged.time_msec = frame.time_msec;
+    merged.monotonicNs = frame.monotonicNs;
+
+    overflow.pending.store(true, std::memory_order_release);
+}
+
+void EvdevInputRing::wakeConsumer()
+{
+    // 与 handleWakeup() 配对：仅在 pending 由 false → true 时写 eventfd，一批帧只唤醒一次。
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_wakeupPending.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    const uint64_t one = 1;
+    ssize_t n;
+    do {
+        n = ::write(m_eventFd, &one, sizeof(one));
+    } while (n < 0 && errno == EINTR);
+}
+
+void EvdevInputRing::handleWakeup()
+{
+    uint64_t counter = 0;
+    ssize_t n;
+    do {
+        n = ::read(m_eventFd, &counter, sizeof(counter));
+    } while (n < 0 && errno == EINTR);
+
+    // 先清 pending 再排空：排空期间新提交的帧会重新触发一次唤醒，不会遗漏。
+    m_wakeupPending.store(false, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    drain();
+}
+
+int EvdevInputRing::drain()
+{
+    int frames = 0;
+    for (int deviceId = 0; deviceId < kMaxDevices; ++deviceId) {
+        Ring *ring = m_rings[static_cast<size_t>(deviceId)].load(std::memory_order_acquire);
+        if (!ring) {
+            continue;
+        }
+        if (!ring->isEmpty()) {
+            drainRing(deviceId, ring, &frames);
+        }
+        drainOverflow(deviceId, ring, &frames);
+    }
+    return frames;
+}
+
+void EvdevInputRing::drainOverflow(int deviceId, Ring *ring, int *frames)
+{
+    Overflow &overflow = m_overflow[static_cast<size_t>(deviceId)];
+    if (!overflow.pending.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // pending 期间生产者只写溢出帧：此时 ring 中剩下的帧都早于溢出帧，先全部交付。
+    if (!ring->isEmpty()) {
+        drainRing(deviceId, ring, frames);
+    }
+
+    DeckGamepadFrameEvent frame;
+    {
+        QMutexLocker locker(&overflow.mutex);
+        frame = std::move(overflow.frame);
+        overflow.frame.clear();
+        overflow.pending.store(false, std::memory_order_release);
+    }
+    Q_EMIT frameEvent(deviceId, frame);
+    ++*frames;
+}
+
+void EvdevInputRing::drainRing(int deviceId, Ring *ring, int *frames)
+{
+    m_scratch.clear();
+    ring->drain([this, deviceId, frames](const EvdevInputRecord &record) {
+        switch (record.kind) {
+        case EvdevInputRecord::Button:
+            m_scratch.buttons.append(DeckGamepadButtonEvent{ record.timeMsec, record.code, record.pressed != 0 });
+            break;
+        case EvdevInputRecord::Axis:
+            m_scratch.axes.append(DeckGamepadAxisEvent{ record.timeMsec, record.code, record.axisValue });
+            break;
+        case EvdevInputRecord::Hat:
+            m_scratch.hats.append(DeckGamepadHatEvent{ record.timeMsec, record.code, record.hatValue });
+            break;
+        case EvdevInputRecord::FrameEnd:
+            m_scratch.time_msec = record.timeMsec;
+            m_scratch.monotonicNs = record.monotonicNs;
+            Q_EMIT frameEvent(deviceId, m_scratch);
+            m_scratch.clear();
+            ++*frames;
+            break;
+        default:
+            break;
+        }
+    });
+}
+
+DECKGAMEPAD_END_NAMESPACE
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// Evdev 输入环形传输：IO 线程把设备帧写成定长记录放入每设备 SPSC ring，
+// 消费线程经 eventfd 按批唤醒后一次性排空，并还原为 DeckGamepadFrameEvent。
+// 稳态下每个输入事件零堆分配（对比 QueuedConnection 的逐帧 QMetaCallEvent + 参数拷贝）。
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+#include <deckshell/deckgamepad/core/deckgamepadspscring.h>
+
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+class QSocketNotifier;
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+struct EvdevInputRecord {
+    enum Kind : quint8 {
+        Button = 0,
+        Axis,
+        Hat,
+        FrameEnd,
+    };
+
+    quint8 kind = Button;
+    quint8 pressed = 0;
+    quint16 reserved = 0;
+    uint32_t code = 0; // button/axis/hat 索引
+    uint32_t timeMsec = 0;
+    int32_t hatValue = 0;
+    double axisValue = 0.0;
+    qint64 monotonicNs = 0; // 仅 FrameEnd 使用
+};
+
+class EvdevInputRing final : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kMaxDevices = 16;
+    static constexpr size_t kRecordsPerDevice = 1024;
+
+    // 必须在消费线程构造（eventfd 通知器挂在该线程的事件循环上）。
+    explicit EvdevInputRing(QObject *parent = nullptr);
+    ~EvdevInputRing() override;
+
+    bool isValid() const { return m_eventFd >= 0; }
+
+    // ========== 生产者侧（IO 线程）==========
+    // 整帧写入，不会出现半帧。ring 空间不足时帧转入该设备的溢出帧：按键/hat 跳变按序保留，
+    // 轴只保留最新值（多帧合并计入 coalescedFrameCount）；溢出帧待消费者取走前，后续帧继续并入，
+    // 保证与 ring 中的帧顺序一致。
+    bool pushFrame(int deviceId, const DeckGamepadFrameEvent &frame);
+
+    // ========== 消费者侧 ==========
+    // 排空全部设备 ring 并逐帧发出 frameEvent；返回发出的帧数。
+    int drain();
+
+    // 被拒绝的帧（deviceId 越界）。
+    quint64 droppedFrameCount() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+    // 溢出时并入前一帧的帧数（仅丢失中间轴采样，不丢跳变）。
+    quint64 coalescedFrameCount() const { return m_coalescedFrames.load(std::memory_order_relaxed); }
+
+Q_SIGNALS:
+    void frameEvent(int deviceId, DeckGamepadFrameEvent frame);
+
+private:
+    using Ring = DeckGamepadSpscRing<EvdevInputRecord, kRecordsPerDevice>;
+
+    void handleWakeup();
+    Ring *producerRing(int deviceId);
+    void wakeConsumer();
+    void pushOverflow(int deviceId, const DeckGamepadFrameEvent &frame);
+    void drainRing(int deviceId, Ring *ring, int *frames);
+    void drainOverflow(int deviceId, Ring *ring, int *frames);
+
+    // ring 满时的慢路径；pending 为 true 期间生产者不再写 ring，只由消费者清除。
+    struct Overflow {
+        std::atomic<bool> pending{ false };
+        QMutex mutex;
+        DeckGamepadFrameEvent frame;
+    };
+
+    std::array<std::atomic<Ring *>, kMaxDevices> m_rings{};
+    std::atomic<bool> m_wakeupPending{ false };
+    std::atomic<quint64> m_droppedFrames{ 0 };
+    std::atomic<quint64> m_coalescedFrames{ 0 };
+    std::array<Overflow, kMaxDevices> m_overflow;
+
+    int m_eventFd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    DeckGamepadFrameEvent m_scratch; // 消费侧复用，稳态下不再分配
+};
+
+DECKGAMEPAD_END_NAMESPACE
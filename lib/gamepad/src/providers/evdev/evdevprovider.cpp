@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "evdevprovider.h"
+#include "evdevinputring.h"
 
 #include <deckshell/deckgamepad/backend/deckgamepadbackend.h>
 #include <deckshell/deckgamepad/mapping/deckgamepadcalibrationstore.h>
@@ -197,6 +198,10 @@ void EvdevProvider::stop()
             invokeBlocking(backend, [backend] { backend->stop(); });
         }
     }
+    if (m_inputRing) {
+        // backend 已停止：把 ring 中剩余帧交付完，避免丢失最后的 release。
+        m_inputRing->drain();
+    }
     m_running = false;
     clearCaches();
 }
@@ -262,9 +267,38 @@ bool EvdevProvider::startVibration(int deviceId, float weakMagnitude, float stro
     if (m_backendMode == BackendMode::SingleThreadDebug) {
         return backend->startVibration(deviceId, weakMagnitude, strongMagnitude, durationMs);
     }
-    return invokeBlocking(backend, [backend, deviceId, weakMagnitude, strongMagnitude, durationMs] {
-        return backend->startVibration(deviceId, weakMagnitude, strongMagnitude, durationMs);
+    // 高频调用路径：按缓存的设备能力预判后排队到 IO 线程，由设备调度器合并输出，不阻塞调用线程。
+    if (!canVibrate(deviceId)) {
+        return false;
+    }
+    if (weakMagnitude < 0.0f || weakMagnitude > 1.0f || strongMagnitude < 0.0f || strongMagnitude > 1.0f) {
+        return false;
+    }
+    invokeQueued(backend, [backend, deviceId, weakMagnitude, strongMagnitude, durationMs] {
+        backend->startVibration(deviceId, weakMagnitude, strongMagnitude, durationMs);
     });
+    return true;
+}
+
+bool EvdevProvider::playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern)
+{
+    auto *backend = m_backend;
+    if (!backend || !pattern.isValid()) {
+        return false;
+    }
+    if (m_backendMode == BackendMode::SingleThreadDebug) {
+        return backend->playVibrationPattern(deviceId, pattern);
+    }
+    if (!canVibrate(deviceId)) {
+        return false;
+    }
+    invokeQueued(backend, [backend, deviceId, pattern] { backend->playVibrationPattern(deviceId, pattern); });
+    return true;
+}
+
+bool EvdevProvider::canVibrate(int deviceId) const
+{
+    return m_connectedIds.contains(deviceId) && m_deviceInfoCache.value(deviceId).supportsRumble;
 }
 
 void EvdevProvider::stopVibration(int deviceId)
@@ -273,6 +307,13 @@ void EvdevProvider::stopVibration(int deviceId)
     invokeQueued(backend, [backend, deviceId] { backend->stopVibration(deviceId); });
 }
 
+bool EvdevProvider::setFrameTap(FrameTap tap)
+{
+    m_frameTap = std::move(tap);
+    applyFrameTap();
+    return true;
+}
+
 DeckGamepadCustomMappingManager *EvdevProvider::customMappingManager() const
 {
     return m_customMappingManager;
@@ -290,7 +331,9 @@ DeckGamepadError EvdevProvider::lastError() const
 
 DeckGamepadDiagnostic EvdevProvider::diagnostic() const
 {
-    return DeckGamepadDiagnostic{};
+    DeckGamepadDiagnostic diag;
+    diag.startupProbe = m_probeHistogram;
+    return diag;
 }
 
 void EvdevProvider::ensureBackendConnections()
@@ -323,19 +366,15 @@ void EvdevProvider::ensureBackendConnections()
             &EvdevProvider::handleBackendGamepadDisconnected,
             Qt::UniqueConnection);
     connect(m_backend,
-            &DeckGamepadBackend::buttonEvent,
-            this,
-            &EvdevProvider::buttonEvent,
-            Qt::UniqueConnection);
-    connect(m_backend,
-            &DeckGamepadBackend::axisEvent,
+            &DeckGamepadBackend::probeHistogramChanged,
             this,
-            &EvdevProvider::axisEvent,
+            &EvdevProvider::handleBackendProbeHistogramChanged,
             Qt::UniqueConnection);
+    // 输入事件按设备帧转发：IO 线程模式下每个 SYN_REPORT 只产生一次跨线程投递。
     connect(m_backend,
-            &DeckGamepadBackend::hatEvent,
+            &DeckGamepadBackend::frameEvent,
             this,
-            &EvdevProvider::hatEvent,
+            &EvdevProvider::frameEvent,
             Qt::UniqueConnection);
 
     connect(m_backend,
@@ -397,8 +436,21 @@ void EvdevProvider::handleBackendGamepadConnected(int deviceId, const QString &n
     Q_EMIT gamepadConnected(deviceId, name);
 }
 
+void EvdevProvider::handleBackendProbeHistogramChanged(DeckGamepadProbeHistogram histogram)
+{
+    if (m_probeHistogram == histogram) {
+        return;
+    }
+    m_probeHistogram = std::move(histogram);
+    Q_EMIT diagnosticChanged(diagnostic());
+}
+
 void EvdevProvider::handleBackendGamepadDisconnected(int deviceId)
 {
+    if (m_inputRing) {
+        // 断开信号走 QueuedConnection、帧走 ring：先排空，保证该设备的帧先于 disconnected 送达。
+        m_inputRing->drain();
+    }
     m_connectedIds.remove(deviceId);
     Q_EMIT gamepadDisconnected(deviceId);
 }
@@ -463,6 +515,7 @@ bool EvdevProvider::ensureBackendForConfig(const DeckGamepadRuntimeConfig &confi
     const BackendMode desiredMode = wantIoThread ? BackendMode::IoThread : BackendMode::SingleThreadDebug;
 
     if (m_backend && desiredMode == m_backendMode) {
+        applyInputTransport(config);
         return true;
     }
 
@@ -506,9 +559,63 @@ bool EvdevProvider::ensureBackendForConfig(const DeckGamepadRuntimeConfig &confi
         m_customMappingManager = invokeBlocking(backend, [backend] { return backend->customMappingManager(); });
     }
     ensureCalibrationStore();
+    applyInputTransport(config);
+    applyFrameTap();
     return true;
 }
 
+void EvdevProvider::applyFrameTap()
+{
+    auto *backend = m_backend;
+    if (!backend) {
+        return;
+    }
+
+    // backend 在自身线程调用 tap，替换必须在同一线程完成。
+    invokeBlocking(backend, [backend, tap = m_frameTap] { backend->setFrameTap(tap); });
+}
+
+void EvdevProvider::applyInputTransport(const DeckGamepadRuntimeConfig &config)
+{
+    auto *backend = m_backend;
+    if (!backend) {
+        return;
+    }
+
+    // 单线程调试模式下 backend 与 provider 同线程，信号本身就是直接调用，无需 ring。
+    const bool wantRing = m_backendMode == BackendMode::IoThread
+        && config.inputTransport == DeckGamepadInputTransport::SpscRing;
+
+    if (!wantRing) {
+        if (m_inputRing) {
+            invokeBlocking(backend, [backend] { backend->setFrameSink({}); });
+            m_inputRing->drain();
+            m_inputRing.reset();
+        }
+        return;
+    }
+
+    if (m_inputRing) {
+        return;
+    }
+
+    auto ring = std::make_unique<EvdevInputRing>();
+    if (!ring->isValid()) {
+        // eventfd 不可用时回退到 QueuedSignal，不影响功能。
+        return;
+    }
+
+    connect(ring.get(), &EvdevInputRing::frameEvent, this, &EvdevProvider::frameEvent);
+    m_inputRing = std::move(ring);
+
+    auto *inputRing = m_inputRing.get();
+    invokeBlocking(backend, [backend, inputRing] {
+        backend->setFrameSink([inputRing](int deviceId, const DeckGamepadFrameEvent &frame) {
+            (void)inputRing->pushFrame(deviceId, frame);
+        });
+    });
+}
+
 void EvdevProvider::destroyBackend()
 {
     stop();
@@ -528,6 +635,8 @@ void EvdevProvider::destroyBackend()
     m_backend = nullptr;
 
     m_singleThreadBackend.reset();
+    // 生产者（backend）已销毁后才能释放 ring。
+    m_inputRing.reset();
 
     if (m_ioThread) {
         m_ioThread->quit();
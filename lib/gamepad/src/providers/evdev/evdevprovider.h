@@ -21,6 +21,7 @@ class DeckGamepadBackend;
 class DeckGamepadCustomMappingManager;
 class JsonCalibrationStore;
 class EvdevProviderWorker;
+class EvdevInputRing;
 
 class EvdevProvider final : public IDeckGamepadProvider
 {
@@ -52,7 +53,9 @@ public:
     void setAxisSensitivity(int deviceId, uint32_t axis, float sensitivity) override;
 
     bool startVibration(int deviceId, float weakMagnitude, float strongMagnitude, int durationMs) override;
+    bool playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern) override;
     void stopVibration(int deviceId) override;
+    bool setFrameTap(FrameTap tap) override;
 
     DeckGamepadCustomMappingManager *customMappingManager() const override;
     ICalibrationStore *calibrationStore() const override;
@@ -66,6 +69,7 @@ private Q_SLOTS:
     void handleBackendDeviceErrorChanged(int deviceId, DeckGamepadError error);
     void handleBackendGamepadConnected(int deviceId, const QString &name);
     void handleBackendGamepadDisconnected(int deviceId);
+    void handleBackendProbeHistogramChanged(DeckGamepadProbeHistogram histogram);
 
 private:
     enum class BackendMode {
@@ -77,8 +81,11 @@ private:
     void ensureCalibrationStore();
     bool wantsIoThread(const DeckGamepadRuntimeConfig &config) const;
     bool ensureBackendForConfig(const DeckGamepadRuntimeConfig &config);
+    void applyInputTransport(const DeckGamepadRuntimeConfig &config);
+    void applyFrameTap();
     void destroyBackend();
     QList<int> sortedDeviceIds(const QSet<int> &ids) const;
+    bool canVibrate(int deviceId) const;
     void clearCaches();
     void syncSnapshotFromBackend();
     void setError(DeckGamepadError error);
@@ -90,7 +97,9 @@ private:
     EvdevProviderWorker *m_worker = nullptr;
     std::unique_ptr<DeckGamepadBackend> m_singleThreadBackend;
     DeckGamepadBackend *m_backend = nullptr; // lives in IO thread, owned by worker
+    std::unique_ptr<EvdevInputRing> m_inputRing; // SpscRing 传输：lives in provider thread
     DeckGamepadCustomMappingManager *m_customMappingManager = nullptr;
+    FrameTap m_frameTap; // 跨 backend 重建保留
     bool m_running = false;
 
     DeckGamepadRuntimeConfig m_config;
@@ -102,6 +111,7 @@ private:
     QHash<int, DeckGamepadDeviceInfo> m_deviceInfoCache;
     QHash<int, DeckGamepadDeviceAvailability> m_deviceAvailabilityCache;
     QHash<int, DeckGamepadError> m_deviceLastErrorCache;
+    DeckGamepadProbeHistogram m_probeHistogram;
 };
 
 DECKGAMEPAD_END_NAMESPACE
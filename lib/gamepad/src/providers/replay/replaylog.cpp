@@ -0,0 +1,335 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "replaylog_p.h"
+
+#include <limits>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+namespace {
+constexpr int kMaxFrameEntries = 4096; // 防御损坏日志导致的超大 reserve
+
+void prepareStream(QDataStream *stream)
+{
+    stream->setVersion(QDataStream::Qt_6_0);
+    stream->setByteOrder(QDataStream::LittleEndian);
+    stream->setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+void writeInfo(QDataStream &out, const DeckGamepadDeviceInfo &info)
+{
+    out << info.deviceUid << info.guid << info.name << quint16(info.vendorId) << quint16(info.productId) << info.transport
+        << info.supportsRumble;
+}
+
+void readInfo(QDataStream &in, DeckGamepadDeviceInfo *info)
+{
+    quint16 vendorId = 0;
+    quint16 productId = 0;
+    in >> info->deviceUid >> info->guid >> info->name >> vendorId >> productId >> info->transport >> info->supportsRumble;
+    info->vendorId = vendorId;
+    info->productId = productId;
+}
+
+void writeError(QDataStream &out, const DeckGamepadError &error)
+{
+    out << qint32(error.code) << error.message << qint32(error.sysErrno) << error.context << error.hint << error.recoverable;
+}
+
+void readError(QDataStream &in, DeckGamepadError *error)
+{
+    qint32 code = 0;
+    qint32 sysErrno = 0;
+    in >> code >> error->message >> sysErrno >> error->context >> error->hint >> error->recoverable;
+    error->code = static_cast<DeckGamepadErrorCode>(code);
+    error->sysErrno = sysErrno;
+}
+} // namespace
+
+bool ReplayLogWriter::open(const QString &path, const QString &providerName, qint64 recordedAtMs, QString *errorMessage)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) {
+            *errorMessage = m_file.errorString();
+        }
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    prepareStream(&m_stream);
+    m_stream.resetStatus();
+    m_lastOffsetUs = 0;
+    m_recordCount = 0;
+
+    m_stream << kReplayLogMagic << kReplayLogVersion << providerName << recordedAtMs;
+    return true;
+}
+
+bool ReplayLogWriter::close(QString *errorMessage)
+{
+    if (!m_file.isOpen()) {
+        return true;
+    }
+
+    const bool streamOk = m_stream.status() == QDataStream::Ok;
+    const bool flushed = m_file.flush();
+    if ((!streamOk || !flushed) && errorMessage) {
+        *errorMessage = m_file.errorString();
+    }
+    m_stream.setDevice(nullptr);
+    m_file.close();
+    return streamOk && flushed;
+}
+
+void ReplayLogWriter::beginRecord(ReplayLogRecordType type, qint64 offsetUs)
+{
+    // 记录必须单调：跨线程排队等原因导致的回退按 0 间隔处理。
+    const qint64 delta = qMax<qint64>(0, offsetUs - m_lastOffsetUs);
+    m_lastOffsetUs = qMax(m_lastOffsetUs, offsetUs);
+    const auto deltaUs = static_cast<quint32>(qMin<qint64>(delta, std::numeric_limits<quint32>::max()));
+    m_stream << quint8(type) << deltaUs;
+    m_recordCount++;
+}
+
+void ReplayLogWriter::writeDeviceSnapshot(qint64 offsetUs,
+                                          int deviceId,
+                                          bool connected,
+                                          DeckGamepadDeviceAvailability availability,
+                                          const QString &name,
+                                          const DeckGamepadDeviceInfo &info,
+                                          const DeckGamepadError &error)
+{
+    beginRecord(ReplayLogRecordType::DeviceSnapshot, offsetUs);
+    m_stream << qint32(deviceId) << connected << quint8(availability) << name;
+    writeInfo(m_stream, info);
+    writeError(m_stream, error);
+}
+
+void ReplayLogWriter::writeConnected(qint64 offsetUs, int deviceId, const QString &name, const DeckGamepadDeviceInfo &info)
+{
+    beginRecord(ReplayLogRecordType::Connected, offsetUs);
+    m_stream << qint32(deviceId) << name;
+    writeInfo(m_stream, info);
+}
+
+void ReplayLogWriter::writeDisconnected(qint64 offsetUs, int deviceId)
+{
+    beginRecord(ReplayLogRecordType::Disconnected, offsetUs);
+    m_stream << qint32(deviceId);
+}
+
+void ReplayLogWriter::writeAvailability(qint64 offsetUs, int deviceId, DeckGamepadDeviceAvailability availability)
+{
+    beginRecord(ReplayLogRecordType::Availability, offsetUs);
+    m_stream << qint32(deviceId) << quint8(availability);
+}
+
+void ReplayLogWriter::writeDeviceError(qint64 offsetUs, int deviceId, const DeckGamepadError &error)
+{
+    beginRecord(ReplayLogRecordType::DeviceError, offsetUs);
+    m_stream << qint32(deviceId);
+    writeError(m_stream, error);
+}
+
+void ReplayLogWriter::writeProviderError(qint64 offsetUs, const DeckGamepadError &error)
+{
+    beginRecord(ReplayLogRecordType::ProviderError, offsetUs);
+    writeError(m_stream, error);
+}
+
+void ReplayLogWriter::writeButton(qint64 offsetUs, int deviceId, const DeckGamepadButtonEvent &event)
+{
+    beginRecord(ReplayLogRecordType::Button, offsetUs);
+    m_stream << qint32(deviceId) << quint32(event.time_msec) << quint32(event.button) << event.pressed;
+}
+
+void ReplayLogWriter::writeAxis(qint64 offsetUs, int deviceId, const DeckGamepadAxisEvent &event)
+{
+    beginRecord(ReplayLogRecordType::Axis, offsetUs);
+    m_stream << qint32(deviceId) << quint32(event.time_msec) << quint32(event.axis) << event.value;
+}
+
+void ReplayLogWriter::writeHat(qint64 offsetUs, int deviceId, const DeckGamepadHatEvent &event)
+{
+    beginRecord(ReplayLogRecordType::Hat, offsetUs);
+    m_stream << qint32(deviceId) << quint32(event.time_msec) << quint32(event.hat) << qint32(event.value);
+}
+
+void ReplayLogWriter::writeFrame(qint64 offsetUs, int deviceId, const DeckGamepadFrameEvent &frame)
+{
+    beginRecord(ReplayLogRecordType::Frame, offsetUs);
+    m_stream << qint32(deviceId) << quint32(frame.time_msec) << quint16(frame.buttons.size()) << quint16(frame.axes.size())
+             << quint16(frame.hats.size());
+    for (const DeckGamepadButtonEvent &event : frame.buttons) {
+        m_stream << quint32(event.time_msec) << quint32(event.button) << event.pressed;
+    }
+    for (const DeckGamepadAxisEvent &event : frame.axes) {
+        m_stream << quint32(event.time_msec) << quint32(event.axis) << event.value;
+    }
+    for (const DeckGamepadHatEvent &event : frame.hats) {
+        m_stream << quint32(event.time_msec) << quint32(event.hat) << qint32(event.value);
+    }
+}
+
+bool ReplayLogReader::open(const QByteArray &data, QString *errorMessage)
+{
+    auto fail = [errorMessage](const QString &message) {
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return false;
+    };
+
+    m_buffer.close();
+    m_buffer.setData(data);
+    if (!m_buffer.open(QIODevice::ReadOnly)) {
+        return fail(QStringLiteral("cannot open replay buffer"));
+    }
+
+    m_stream.setDevice(&m_buffer);
+    prepareStream(&m_stream);
+    m_stream.resetStatus();
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    m_stream >> magic >> version;
+    if (m_stream.status() != QDataStream::Ok || magic != kReplayLogMagic) {
+        return fail(QStringLiteral("not a gamepad replay log"));
+    }
+    if (version != kReplayLogVersion) {
+        return fail(QStringLiteral("unsupported replay log version %1").arg(version));
+    }
+
+    m_stream >> m_providerName >> m_recordedAtMs;
+    if (m_stream.status() != QDataStream::Ok) {
+        return fail(QStringLiteral("truncated replay log header"));
+    }
+
+    m_bodyPos = m_buffer.pos();
+    m_offsetUs = 0;
+    return true;
+}
+
+void ReplayLogReader::rewind()
+{
+    m_buffer.seek(m_bodyPos);
+    m_stream.resetStatus();
+    m_offsetUs = 0;
+}
+
+bool ReplayLogReader::atEnd() const
+{
+    return m_buffer.atEnd();
+}
+
+bool ReplayLogReader::readNext(ReplayLogRecord *record)
+{
+    quint8 type = 0;
+    quint32 deltaUs = 0;
+    m_stream >> type >> deltaUs;
+    if (m_stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    m_offsetUs += deltaUs;
+    record->type = static_cast<ReplayLogRecordType>(type);
+    record->offsetUs = m_offsetUs;
+
+    qint32 deviceId = -1;
+    quint8 availability = 0;
+    quint32 timeMsec = 0;
+    quint32 code = 0;
+
+    switch (record->type) {
+    case ReplayLogRecordType::DeviceSnapshot:
+        m_stream >> deviceId >> record->connected >> availability >> record->name;
+        readInfo(m_stream, &record->info);
+        readError(m_stream, &record->error);
+        record->availability = static_cast<DeckGamepadDeviceAvailability>(availability);
+        break;
+    case ReplayLogRecordType::Connected:
+        m_stream >> deviceId >> record->name;
+        readInfo(m_stream, &record->info);
+        break;
+    case ReplayLogRecordType::Disconnected:
+        m_stream >> deviceId;
+        break;
+    case ReplayLogRecordType::Availability:
+        m_stream >> deviceId >> availability;
+        record->availability = static_cast<DeckGamepadDeviceAvailability>(availability);
+        break;
+    case ReplayLogRecordType::DeviceError:
+        m_stream >> deviceId;
+        readError(m_stream, &record->error);
+        break;
+    case ReplayLogRecordType::ProviderError:
+        readError(m_stream, &record->error);
+        break;
+    case ReplayLogRecordType::Button:
+        m_stream >> deviceId >> timeMsec >> code >> record->button.pressed;
+        record->button.time_msec = timeMsec;
+        record->button.button = code;
+        break;
+    case ReplayLogRecordType::Axis:
+        m_stream >> deviceId >> timeMsec >> code >> record->axis.value;
+        record->axis.time_msec = timeMsec;
+        record->axis.axis = code;
+        break;
+    case ReplayLogRecordType::Hat: {
+        qint32 value = 0;
+        m_stream >> deviceId >> timeMsec >> code >> value;
+        record->hat.time_msec = timeMsec;
+        record->hat.hat = code;
+        record->hat.value = value;
+        break;
+    }
+    case ReplayLogRecordType::Frame: {
+        quint16 buttonCount = 0;
+        quint16 axisCount = 0;
+        quint16 hatCount = 0;
+        m_stream >> deviceId >> timeMsec >> buttonCount >> axisCount >> hatCount;
+        if (m_stream.status() != QDataStream::Ok || buttonCount > kMaxFrameEntries || axisCount > kMaxFrameEntries
+            || hatCount > kMaxFrameEntries) {
+            return false;
+        }
+
+        DeckGamepadFrameEvent &frame = record->frame;
+        frame.clear();
+        frame.time_msec = timeMsec;
+        for (quint16 i = 0; i < buttonCount; ++i) {
+            DeckGamepadButtonEvent event{};
+            m_stream >> timeMsec >> code >> event.pressed;
+            event.time_msec = timeMsec;
+            event.button = code;
+            frame.buttons.append(event);
+        }
+        for (quint16 i = 0; i < axisCount; ++i) {
+            DeckGamepadAxisEvent event{};
+            m_stream >> timeMsec >> code >> event.value;
+            event.time_msec = timeMsec;
+            event.axis = code;
+            frame.axes.append(event);
+        }
+        for (quint16 i = 0; i < hatCount; ++i) {
+            DeckGamepadHatEvent event{};
+            qint32 value = 0;
+            m_stream >> timeMsec >> code >> value;
+            event.time_msec = timeMsec;
+            event.hat = code;
+            event.value = value;
+            frame.hats.append(event);
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+
+    record->deviceId = deviceId;
+    return m_stream.status() == QDataStream::Ok;
+}
+
+DECKGAMEPAD_END_NAMESPACE
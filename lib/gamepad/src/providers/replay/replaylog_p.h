@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// 输入录制日志（二进制，小端）：ReplayRecorder 写入，ReplayProvider 读取。
+//
+// 布局：
+//   header  = magic(u32 'DGRL') version(u16) providerName(QString) recordedAtMs(i64)
+//   record* = type(u8) deltaUs(u32) payload
+// deltaUs 为相对上一条记录的间隔（微秒，超过 u32 上限时截断）；payload 按 type 决定，见 ReplayLogRecordType。
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+#include <deckshell/deckgamepad/core/deckgamepaddeviceinfo.h>
+#include <deckshell/deckgamepad/core/deckgamepaderror.h>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+inline constexpr quint32 kReplayLogMagic = 0x4C524744; // "DGRL"
+inline constexpr quint16 kReplayLogVersion = 1;
+
+enum class ReplayLogRecordType : quint8 {
+    DeviceSnapshot = 1, // 开始录制时 provider 已知的设备（id, connected, availability, name, info, lastError）
+    Connected = 2,      // id, name, info
+    Disconnected = 3,   // id
+    Availability = 4,   // id, availability
+    DeviceError = 5,    // id, error
+    ProviderError = 6,  // error
+    Button = 7,         // id, time_msec, button, pressed
+    Axis = 8,           // id, time_msec, axis, value
+    Hat = 9,            // id, time_msec, hat, value
+    Frame = 10,         // id, time_msec, buttons[], axes[], hats[]（每项带自身 time_msec）
+};
+
+// 解码后的单条记录；读取端复用同一实例，避免逐条分配。
+struct ReplayLogRecord {
+    ReplayLogRecordType type = ReplayLogRecordType::DeviceSnapshot;
+    qint64 offsetUs = 0; // 相对录制开始
+
+    int deviceId = -1;
+    bool connected = false;
+    DeckGamepadDeviceAvailability availability = DeckGamepadDeviceAvailability::Available;
+    QString name;
+    DeckGamepadDeviceInfo info;
+    DeckGamepadError error;
+
+    DeckGamepadButtonEvent button{};
+    DeckGamepadAxisEvent axis{};
+    DeckGamepadHatEvent hat{};
+    DeckGamepadFrameEvent frame;
+};
+
+class ReplayLogWriter
+{
+public:
+    bool open(const QString &path, const QString &providerName, qint64 recordedAtMs, QString *errorMessage);
+    bool close(QString *errorMessage);
+    bool isOpen() const { return m_file.isOpen(); }
+    quint64 recordCount() const { return m_recordCount; }
+
+    void writeDeviceSnapshot(qint64 offsetUs,
+                             int deviceId,
+                             bool connected,
+                             DeckGamepadDeviceAvailability availability,
+                             const QString &name,
+                             const DeckGamepadDeviceInfo &info,
+                             const DeckGamepadError &error);
+    void writeConnected(qint64 offsetUs, int deviceId, const QString &name, const DeckGamepadDeviceInfo &info);
+    void writeDisconnected(qint64 offsetUs, int deviceId);
+    void writeAvailability(qint64 offsetUs, int deviceId, DeckGamepadDeviceAvailability availability);
+    void writeDeviceError(qint64 offsetUs, int deviceId, const DeckGamepadError &error);
+    void writeProviderError(qint64 offsetUs, const DeckGamepadError &error);
+    void writeButton(qint64 offsetUs, int deviceId, const DeckGamepadButtonEvent &event);
+    void writeAxis(qint64 offsetUs, int deviceId, const DeckGamepadAxisEvent &event);
+    void writeHat(qint64 offsetUs, int deviceId, const DeckGamepadHatEvent &event);
+    void writeFrame(qint64 offsetUs, int deviceId, const DeckGamepadFrameEvent &frame);
+
+private:
+    void beginRecord(ReplayLogRecordType type, qint64 offsetUs);
+
+    QFile m_file;
+    QDataStream m_stream;
+    qint64 m_lastOffsetUs = 0;
+    quint64 m_recordCount = 0;
+};
+
+class ReplayLogReader
+{
+public:
+    // 解析并校验 header（data 为隐式共享拷贝）。
+    bool open(const QByteArray &data, QString *errorMessage);
+    void rewind();
+
+    bool atEnd() const;
+    // 读取下一条记录到 record；截断/未知类型返回 false。
+    bool readNext(ReplayLogRecord *record);
+
+    QString providerName() const { return m_providerName; }
+    qint64 recordedAtMs() const { return m_recordedAtMs; }
+
+private:
+    QBuffer m_buffer;
+    QDataStream m_stream;
+    qint64 m_bodyPos = 0;
+    qint64 m_offsetUs = 0;
+    QString m_providerName;
+    qint64 m_recordedAtMs = 0;
+};
+
+DECKGAMEPAD_END_NAMESPACE
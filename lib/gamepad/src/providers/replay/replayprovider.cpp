@@ -0,0 +1,450 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "replayprovider.h"
+#include "replaylog_p.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QFile>
+
+#include <algorithm>
+#include <cmath>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+namespace {
+// 单次 pump 最多派发的记录数：尽快模式/追帧时分批让出事件循环，避免饿死其他事件源。
+constexpr int kMaxRecordsPerPump = 256;
+
+QList<int> sortedDeviceIds(QList<int> ids)
+{
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+} // namespace
+
+ReplayProvider::ReplayProvider(QObject *parent)
+    : IDeckGamepadProvider(parent)
+    , m_pending(std::make_unique<ReplayLogRecord>())
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &ReplayProvider::pump);
+}
+
+ReplayProvider::~ReplayProvider()
+{
+    stop();
+}
+
+void ReplayProvider::setLogPath(const QString &path)
+{
+    m_logPath = path;
+}
+
+QString ReplayProvider::logPath() const
+{
+    return m_logPath;
+}
+
+void ReplayProvider::setSpeed(double speed)
+{
+    speed = std::isfinite(speed) ? qMax(0.0, speed) : 1.0;
+    if (speed == m_speed) {
+        return;
+    }
+
+    // 运行中变速：以当前回放位置为新起点重排时间表，已过去的时长不按新倍速重算。
+    if (m_running) {
+        m_baseOffsetUs = replayPositionUs();
+        m_clock.restart();
+        m_timer.start(0);
+    }
+    m_speed = speed;
+}
+
+double ReplayProvider::speed() const
+{
+    return m_speed;
+}
+
+bool ReplayProvider::isFinished() const
+{
+    return m_finished;
+}
+
+quint64 ReplayProvider::replayedRecordCount() const
+{
+    return m_replayedCount;
+}
+
+qint64 ReplayProvider::logDurationUs() const
+{
+    return m_durationUs;
+}
+
+QString ReplayProvider::recordedProviderName() const
+{
+    return m_recordedProviderName;
+}
+
+QString ReplayProvider::name() const
+{
+    return QStringLiteral("replay");
+}
+
+bool ReplayProvider::setRuntimeConfig(const DeckGamepadRuntimeConfig &config)
+{
+    m_runtimeConfig = config;
+    return true;
+}
+
+DeckGamepadRuntimeConfig ReplayProvider::runtimeConfig() const
+{
+    return m_runtimeConfig;
+}
+
+bool ReplayProvider::start()
+{
+    if (m_running) {
+        return true;
+    }
+
+    auto fail = [this](DeckGamepadErrorCode code, const QString &message) {
+        DeckGamepadError err;
+        err.code = code;
+        err.message = message;
+        err.context = QStringLiteral("ReplayProvider::start");
+        err.hint = QStringLiteral("record a log with ReplayRecorder and pass it via setLogPath");
+        err.recoverable = true;
+        setError(err);
+        m_reader.reset();
+        return false;
+    };
+
+    if (m_logPath.isEmpty()) {
+        return fail(DeckGamepadErrorCode::InvalidConfig, QStringLiteral("No replay log configured"));
+    }
+
+    QFile file(m_logPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(DeckGamepadErrorCode::Io,
+                    QStringLiteral("Cannot open replay log %1: %2").arg(m_logPath, file.errorString()));
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    auto reader = std::make_unique<ReplayLogReader>();
+    QString errorMessage;
+    if (!reader->open(data, &errorMessage)) {
+        return fail(DeckGamepadErrorCode::InvalidConfig,
+                    QStringLiteral("Invalid replay log %1: %2").arg(m_logPath, errorMessage));
+    }
+
+    // 先完整校验一遍：截断/损坏的日志在 start 阶段失败，而不是回放到一半才停下。
+    quint64 count = 0;
+    while (!reader->atEnd()) {
+        if (!reader->readNext(m_pending.get())) {
+            return fail(DeckGamepadErrorCode::InvalidConfig,
+                        QStringLiteral("Corrupt replay log %1 at record %2").arg(m_logPath).arg(count));
+        }
+        ++count;
+    }
+    m_durationUs = count > 0 ? m_pending->offsetUs : 0;
+    m_recordedProviderName = reader->providerName();
+    reader->rewind();
+
+    m_reader = std::move(reader);
+    resetDevices();
+    m_replayedCount = 0;
+    m_finished = false;
+    m_running = true;
+
+    if (!m_lastError.isOk()) {
+        setError(DeckGamepadError{});
+    }
+
+    // 录制开始时已存在的设备同步恢复（与 evdev provider start 后即可查询到已有设备一致）。
+    readPending();
+    while (m_running && m_hasPending && m_pending->type == ReplayLogRecordType::DeviceSnapshot) {
+        dispatch(*m_pending);
+        readPending();
+    }
+    if (!m_running) {
+        return false;
+    }
+
+    m_baseOffsetUs = 0;
+    m_clock.start();
+    m_timer.start(0);
+    return true;
+}
+
+void ReplayProvider::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_timer.stop();
+    m_running = false;
+    m_hasPending = false;
+    m_reader.reset();
+    resetDevices();
+}
+
+QList<int> ReplayProvider::knownGamepads() const
+{
+    return sortedDeviceIds(m_known);
+}
+
+QList<int> ReplayProvider::connectedGamepads() const
+{
+    return sortedDeviceIds(m_connected);
+}
+
+QString ReplayProvider::deviceName(int deviceId) const
+{
+    return m_deviceName.value(deviceId);
+}
+
+QString ReplayProvider::deviceGuid(int deviceId) const
+{
+    return m_deviceInfo.value(deviceId).guid;
+}
+
+DeckGamepadDeviceInfo ReplayProvider::deviceInfo(int deviceId) const
+{
+    return m_deviceInfo.value(deviceId);
+}
+
+QString ReplayProvider::deviceUid(int deviceId) const
+{
+    return m_deviceInfo.value(deviceId).deviceUid;
+}
+
+DeckGamepadDeviceAvailability ReplayProvider::deviceAvailability(int deviceId) const
+{
+    return m_deviceAvailability.value(deviceId, DeckGamepadDeviceAvailability::Removed);
+}
+
+DeckGamepadError ReplayProvider::deviceLastError(int deviceId) const
+{
+    return m_deviceLastError.value(deviceId);
+}
+
+void ReplayProvider::setAxisDeadzone(int deviceId, uint32_t axis, float deadzone)
+{
+    Q_UNUSED(deviceId);
+    Q_UNUSED(axis);
+    Q_UNUSED(deadzone);
+}
+
+void ReplayProvider::setAxisSensitivity(int deviceId, uint32_t axis, float sensitivity)
+{
+    Q_UNUSED(deviceId);
+    Q_UNUSED(axis);
+    Q_UNUSED(sensitivity);
+}
+
+bool ReplayProvider::startVibration(int deviceId, float weakMagnitude, float strongMagnitude, int durationMs)
+{
+    Q_UNUSED(deviceId);
+    Q_UNUSED(weakMagnitude);
+    Q_UNUSED(strongMagnitude);
+    Q_UNUSED(durationMs);
+    return false;
+}
+
+bool ReplayProvider::playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern)
+{
+    Q_UNUSED(deviceId);
+    Q_UNUSED(pattern);
+    return false;
+}
+
+void ReplayProvider::stopVibration(int deviceId)
+{
+    Q_UNUSED(deviceId);
+}
+
+DeckGamepadCustomMappingManager *ReplayProvider::customMappingManager() const
+{
+    return nullptr;
+}
+
+ICalibrationStore *ReplayProvider::calibrationStore() const
+{
+    return nullptr;
+}
+
+DeckGamepadError ReplayProvider::lastError() const
+{
+    return m_lastError;
+}
+
+DeckGamepadDiagnostic ReplayProvider::diagnostic() const
+{
+    return DeckGamepadDiagnostic{};
+}
+
+void ReplayProvider::pump()
+{
+    int dispatched = 0;
+
+    if (m_speed <= 0.0) {
+        while (m_running && m_hasPending && dispatched < kMaxRecordsPerPump) {
+            dispatch(*m_pending);
+            readPending();
+            ++dispatched;
+        }
+        if (!m_running) {
+            return;
+        }
+        if (m_hasPending) {
+            m_timer.start(0);
+        } else {
+            finish();
+        }
+        return;
+    }
+
+    const qint64 replayUs = replayPositionUs();
+    while (m_running && m_hasPending && m_pending->offsetUs <= replayUs) {
+        if (dispatched >= kMaxRecordsPerPump) {
+            m_timer.start(0);
+            return;
+        }
+        dispatch(*m_pending);
+        readPending();
+        ++dispatched;
+    }
+    if (!m_running) {
+        return;
+    }
+    if (!m_hasPending) {
+        finish();
+        return;
+    }
+
+    const double waitUs = static_cast<double>(m_pending->offsetUs - replayUs) / m_speed;
+    m_timer.start(static_cast<int>(qMin(std::ceil(waitUs / 1000.0), 60.0 * 60.0 * 1000.0)));
+}
+
+qint64 ReplayProvider::replayPositionUs() const
+{
+    if (m_speed <= 0.0) {
+        // 尽快模式下已发出的记录都在待发记录之前。
+        return m_hasPending ? m_pending->offsetUs : m_durationUs;
+    }
+    return m_baseOffsetUs + static_cast<qint64>(static_cast<double>(m_clock.nsecsElapsed()) / 1000.0 * m_speed);
+}
+
+void ReplayProvider::dispatch(ReplayLogRecord &record)
+{
+    const int id = record.deviceId;
+    m_replayedCount++;
+
+    switch (record.type) {
+    case ReplayLogRecordType::DeviceSnapshot:
+        if (!m_known.contains(id)) {
+            m_known.append(id);
+        }
+        m_deviceName.insert(id, record.name);
+        m_deviceInfo.insert(id, record.info);
+        m_deviceAvailability.insert(id, record.availability);
+        m_deviceLastError.insert(id, record.error);
+        if (record.connected && !m_connected.contains(id)) {
+            m_connected.append(id);
+            Q_EMIT gamepadConnected(id, record.name);
+        }
+        if (record.availability != DeckGamepadDeviceAvailability::Available) {
+            Q_EMIT deviceAvailabilityChanged(id, record.availability);
+        }
+        if (!record.error.isOk()) {
+            Q_EMIT deviceLastErrorChanged(id, record.error);
+        }
+        break;
+    case ReplayLogRecordType::Connected:
+        if (!m_known.contains(id)) {
+            m_known.append(id);
+        }
+        if (!m_connected.contains(id)) {
+            m_connected.append(id);
+        }
+        m_deviceName.insert(id, record.name);
+        m_deviceInfo.insert(id, record.info);
+        Q_EMIT gamepadConnected(id, record.name);
+        break;
+    case ReplayLogRecordType::Disconnected:
+        m_connected.removeAll(id);
+        Q_EMIT gamepadDisconnected(id);
+        break;
+    case ReplayLogRecordType::Availability:
+        if (!m_known.contains(id)) {
+            m_known.append(id);
+        }
+        m_deviceAvailability.insert(id, record.availability);
+        Q_EMIT deviceAvailabilityChanged(id, record.availability);
+        break;
+    case ReplayLogRecordType::DeviceError:
+        if (!m_known.contains(id)) {
+            m_known.append(id);
+        }
+        m_deviceLastError.insert(id, record.error);
+        Q_EMIT deviceLastErrorChanged(id, record.error);
+        break;
+    case ReplayLogRecordType::ProviderError:
+        setError(record.error);
+        break;
+    case ReplayLogRecordType::Button:
+        Q_EMIT buttonEvent(id, record.button);
+        break;
+    case ReplayLogRecordType::Axis:
+        Q_EMIT axisEvent(id, record.axis);
+        break;
+    case ReplayLogRecordType::Hat:
+        Q_EMIT hatEvent(id, record.hat);
+        break;
+    case ReplayLogRecordType::Frame:
+        // 投递延迟统计以回放发出时刻为起点（录制值属于另一时钟域）。
+        record.frame.monotonicNs = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+        Q_EMIT frameEvent(id, record.frame);
+        break;
+    }
+}
+
+bool ReplayProvider::readPending()
+{
+    m_hasPending = m_reader && !m_reader->atEnd() && m_reader->readNext(m_pending.get());
+    return m_hasPending;
+}
+
+void ReplayProvider::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_timer.stop();
+    Q_EMIT replayFinished();
+}
+
+void ReplayProvider::resetDevices()
+{
+    m_known.clear();
+    m_connected.clear();
+    m_deviceName.clear();
+    m_deviceInfo.clear();
+    m_deviceAvailability.clear();
+    m_deviceLastError.clear();
+}
+
+void ReplayProvider::setError(const DeckGamepadError &error)
+{
+    m_lastError = error;
+    Q_EMIT lastErrorChanged(m_lastError);
+}
+
+DECKGAMEPAD_END_NAMESPACE
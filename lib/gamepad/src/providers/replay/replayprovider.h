@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// Replay Provider：回放 ReplayRecorder 录制的事件日志（无需硬件），用于复现现场问题与可重复的性能基准。
+
+#pragma once
+
+#include <deckshell/deckgamepad/service/ideckgamepadprovider.h>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+
+#include <memory>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+class ReplayLogReader;
+struct ReplayLogRecord;
+
+/**
+ * @brief 从录制日志回放输入事件的 Provider
+ *
+ * - speed：1.0 为原速，N 为 N 倍速；<= 0 表示尽快回放（分批让出事件循环）。
+ * - 设备表随记录推进更新，再发出对应信号，满足 connectedGamepads() 与连接信号的一致性契约。
+ * - 帧事件的 monotonicNs 以回放发出时刻重写，time_msec 保持录制值。
+ * - 振动/死区/灵敏度等控制接口为 no-op（日志中已是 provider 处理后的值）。
+ * - 只能显式注入（DeckGamepadService::setProvider）：服务不会根据环境变量等隐式改用回放。
+ */
+class DECKGAMEPAD_EXPORT ReplayProvider final : public IDeckGamepadProvider
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayProvider(QObject *parent = nullptr);
+    ~ReplayProvider() override;
+
+    // 日志路径：start 前设置；运行中修改在下次 start 生效。
+    void setLogPath(const QString &path);
+    QString logPath() const;
+    // 倍速：运行中修改立即生效，从当前回放位置起按新倍速继续。
+    void setSpeed(double speed);
+    double speed() const;
+
+    bool isFinished() const;
+    quint64 replayedRecordCount() const;
+    // 日志覆盖的时长（最后一条记录相对录制开始的偏移），start 成功后有效。
+    qint64 logDurationUs() const;
+    QString recordedProviderName() const;
+
+    QString name() const override;
+
+    bool setRuntimeConfig(const DeckGamepadRuntimeConfig &config) override;
+    DeckGamepadRuntimeConfig runtimeConfig() const override;
+
+    bool start() override;
+    void stop() override;
+
+    QList<int> knownGamepads() const override;
+    QList<int> connectedGamepads() const override;
+    QString deviceName(int deviceId) const override;
+    QString deviceGuid(int deviceId) const override;
+    DeckGamepadDeviceInfo deviceInfo(int deviceId) const override;
+    QString deviceUid(int deviceId) const override;
+
+    DeckGamepadDeviceAvailability deviceAvailability(int deviceId) const override;
+    DeckGamepadError deviceLastError(int deviceId) const override;
+
+    void setAxisDeadzone(int deviceId, uint32_t axis, float deadzone) override;
+    void setAxisSensitivity(int deviceId, uint32_t axis, float sensitivity) override;
+
+    bool startVibration(int deviceId, float weakMagnitude, float strongMagnitude, int durationMs) override;
+    bool playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern) override;
+    void stopVibration(int deviceId) override;
+
+    DeckGamepadCustomMappingManager *customMappingManager() const override;
+    ICalibrationStore *calibrationStore() const override;
+    DeckGamepadError lastError() const override;
+    DeckGamepadDiagnostic diagnostic() const override;
+
+Q_SIGNALS:
+    // 日志播放完毕（stop() 不会发出）。
+    void replayFinished();
+
+private:
+    void pump();
+    qint64 replayPositionUs() const;
+    void dispatch(ReplayLogRecord &record);
+    bool readPending();
+    void finish();
+    void resetDevices();
+    void setError(const DeckGamepadError &error);
+
+    QString m_logPath;
+    double m_speed = 1.0;
+    DeckGamepadRuntimeConfig m_runtimeConfig;
+    DeckGamepadError m_lastError;
+
+    std::unique_ptr<ReplayLogReader> m_reader;
+    std::unique_ptr<ReplayLogRecord> m_pending;
+    bool m_hasPending = false;
+    bool m_running = false;
+    bool m_finished = false;
+    quint64 m_replayedCount = 0;
+    qint64 m_durationUs = 0;
+    QString m_recordedProviderName;
+
+    QElapsedTimer m_clock;
+    qint64 m_baseOffsetUs = 0; // m_clock 起点对应的日志偏移（变速时重设）
+    QTimer m_timer;
+
+    QList<int> m_known;
+    QList<int> m_connected;
+    QHash<int, QString> m_deviceName;
+    QHash<int, DeckGamepadDeviceInfo> m_deviceInfo;
+    QHash<int, DeckGamepadDeviceAvailability> m_deviceAvailability;
+    QHash<int, DeckGamepadError> m_deviceLastError;
+};
+
+DECKGAMEPAD_END_NAMESPACE
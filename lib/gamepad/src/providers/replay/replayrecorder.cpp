@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "replayrecorder.h"
+#include "replaylog_p.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDeadlineTimer>
+
+#include <utility>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+static qint64 monotonicNowNs()
+{
+    return QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+}
+
+ReplayRecorder::ReplayRecorder(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+    (void)stop();
+}
+
+bool ReplayRecorder::start(IDeckGamepadProvider *provider, const QString &path)
+{
+    if (isRecording()) {
+        m_errorString = QStringLiteral("recording already in progress");
+        return false;
+    }
+    if (!provider) {
+        m_errorString = QStringLiteral("no provider");
+        return false;
+    }
+
+    auto writer = std::make_unique<ReplayLogWriter>();
+    QString error;
+    if (!writer->open(path, provider->name(), QDateTime::currentMSecsSinceEpoch(), &error)) {
+        m_errorString = QStringLiteral("cannot open %1: %2").arg(path, error);
+        return false;
+    }
+
+    m_errorString.clear();
+    m_writer = std::move(writer);
+    m_provider = provider;
+    m_startNs = monotonicNowNs();
+
+    const QList<int> known = provider->knownGamepads();
+    const QList<int> connected = provider->connectedGamepads();
+    for (int id : known) {
+        m_writer->writeDeviceSnapshot(0,
+                                      id,
+                                      connected.contains(id),
+                                      provider->deviceAvailability(id),
+                                      provider->deviceName(id),
+                                      provider->deviceInfo(id),
+                                      provider->deviceLastError(id));
+    }
+    // knownGamepads 可能未覆盖 connected（provider 实现差异），补齐。
+    for (int id : connected) {
+        if (!known.contains(id)) {
+            m_writer->writeDeviceSnapshot(0,
+                                          id,
+                                          true,
+                                          provider->deviceAvailability(id),
+                                          provider->deviceName(id),
+                                          provider->deviceInfo(id),
+                                          provider->deviceLastError(id));
+        }
+    }
+
+    ReplayLogWriter *log = m_writer.get();
+    m_connections << connect(provider, &IDeckGamepadProvider::lastErrorChanged, this, [this, log](DeckGamepadError error) {
+        log->writeProviderError(offsetUs(), error);
+    });
+    m_connections << connect(provider,
+                             &IDeckGamepadProvider::deviceAvailabilityChanged,
+                             this,
+                             [this, log](int deviceId, DeckGamepadDeviceAvailability availability) {
+                                 log->writeAvailability(offsetUs(), deviceId, availability);
+                             });
+    m_connections << connect(provider,
+                             &IDeckGamepadProvider::deviceLastErrorChanged,
+                             this,
+                             [this, log](int deviceId, DeckGamepadError error) {
+                                 log->writeDeviceError(offsetUs(), deviceId, error);
+                             });
+    m_connections << connect(provider,
+                             &IDeckGamepadProvider::gamepadConnected,
+                             this,
+                             [this, log](int deviceId, const QString &name) {
+                                 const DeckGamepadDeviceInfo info = m_provider ? m_provider->deviceInfo(deviceId)
+                                                                               : DeckGamepadDeviceInfo{};
+                                 log->writeConnected(offsetUs(), deviceId, name, info);
+                             });
+    m_connections << connect(provider, &IDeckGamepadProvider::gamepadDisconnected, this, [this, log](int deviceId) {
+        log->writeDisconnected(offsetUs(), deviceId);
+    });
+    m_connections << connect(provider,
+                             &IDeckGamepadProvider::buttonEvent,
+                             this,
+                             [this, log](int deviceId, DeckGamepadButtonEvent event) {
+                                 log->writeButton(offsetUs(), deviceId, event);
+                             });
+    m_connections << connect(provider,
+                             &IDeckGamepadProvider::axisEvent,
+                             this,
+                             [this, log](int deviceId, DeckGamepadAxisEvent event) {
+                                 log->writeAxis(offsetUs(), deviceId, event);
+                             });
+    m_connections << connect(provider,
+                             &IDeckGamepadProvider::hatEvent,
+                             this,
+                             [this, log](int deviceId, DeckGamepadHatEvent event) {
+                                 log->writeHat(offsetUs(), deviceId, event);
+                             });
+    m_connections << connect(provider,
+                             &IDeckGamepadProvider::frameEvent,
+                             this,
+                             [this, log](int deviceId, DeckGamepadFrameEvent frame) {
+                                 log->writeFrame(offsetUsForFrame(frame), deviceId, frame);
+                             });
+    m_connections << connect(provider, &QObject::destroyed, this, [this]() {
+        (void)stop();
+    });
+
+    return true;
+}
+
+bool ReplayRecorder::stop()
+{
+    if (!m_writer) {
+        return m_errorString.isEmpty();
+    }
+
+    disconnectProvider();
+
+    QString error;
+    const bool ok = m_writer->close(&error);
+    if (!ok) {
+        m_errorString = QStringLiteral("failed to write replay log: %1").arg(error);
+    }
+    m_recordCount = m_writer->recordCount();
+    m_writer.reset();
+    return ok;
+}
+
+bool ReplayRecorder::isRecording() const
+{
+    return m_writer != nullptr;
+}
+
+quint64 ReplayRecorder::recordCount() const
+{
+    return m_writer ? m_writer->recordCount() : m_recordCount;
+}
+
+QString ReplayRecorder::errorString() const
+{
+    return m_errorString;
+}
+
+qint64 ReplayRecorder::offsetUs() const
+{
+    return (monotonicNowNs() - m_startNs) / 1000;
+}
+
+qint64 ReplayRecorder::offsetUsForFrame(const DeckGamepadFrameEvent &frame) const
+{
+    // 成帧时刻比信号到达时刻更接近内核节奏（IO 线程排队抖动不计入回放间隔）。
+    if (frame.monotonicNs >= m_startNs) {
+        return (frame.monotonicNs - m_startNs) / 1000;
+    }
+    return offsetUs();
+}
+
+void ReplayRecorder::disconnectProvider()
+{
+    for (const QMetaObject::Connection &connection : std::as_const(m_connections)) {
+        disconnect(connection);
+    }
+    m_connections.clear();
+    m_provider.clear();
+}
+
+DECKGAMEPAD_END_NAMESPACE
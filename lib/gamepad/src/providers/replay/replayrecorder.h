@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// 输入录制：订阅任意 IDeckGamepadProvider 的信号，把事件流（含设备信息/热插拔/可用性）写入二进制日志，供 ReplayProvider 回放。
+
+#pragma once
+
+#include <deckshell/deckgamepad/service/ideckgamepadprovider.h>
+
+#include <QtCore/QList>
+#include <QtCore/QMetaObject>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+
+#include <memory>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+class ReplayLogWriter;
+
+/**
+ * @brief 录制 provider 输出的原始事件流
+ *
+ * - start() 时先写入 provider 已知设备的快照（connected/availability/name/info/lastError），再持续追加信号事件。
+ * - 时间戳为相对录制开始的单调时钟偏移；帧事件优先使用 DeckGamepadFrameEvent::monotonicNs（成帧时刻）。
+ * - 录制的是 provider 层（合并/动作映射之前）的事件，回放时 Service 的合并与映射逻辑会照常执行。
+ * - 需与 provider 位于同一线程（信号以 direct connection 接收）。
+ */
+class DECKGAMEPAD_EXPORT ReplayRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayRecorder(QObject *parent = nullptr);
+    ~ReplayRecorder() override;
+
+    bool start(IDeckGamepadProvider *provider, const QString &path);
+    // 停止并落盘；写入失败时返回 false（见 errorString()）。
+    bool stop();
+
+    bool isRecording() const;
+    quint64 recordCount() const;
+    QString errorString() const;
+
+private:
+    qint64 offsetUs() const;
+    qint64 offsetUsForFrame(const DeckGamepadFrameEvent &frame) const;
+    void disconnectProvider();
+
+    QPointer<IDeckGamepadProvider> m_provider;
+    QList<QMetaObject::Connection> m_connections;
+    std::unique_ptr<ReplayLogWriter> m_writer;
+    qint64 m_startNs = 0;
+    quint64 m_recordCount = 0;
+    QString m_errorString;
+};
+
+DECKGAMEPAD_END_NAMESPACE
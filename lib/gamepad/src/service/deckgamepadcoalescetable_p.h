@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// Service 的 axis/hat 合并槽位表：每设备固定 [axis]/[hat] 槽 + dirty 位图；
+// take*() 按 (deviceId, 索引) 升序遍历置位，不做哈希/排序/分配。
+
+#pragma once
+
+#include <deckshell/deckgamepad/core/deckgamepad.h>
+
+#include <QtCore/QtAlgorithms>
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+DECKGAMEPAD_BEGIN_NAMESPACE
+
+class DeckGamepadCoalesceTable
+{
+public:
+    static constexpr int kMaxHats = 4;
+
+    // 索引超出槽位范围时返回 false，调用方应直接透传该事件。
+    bool enqueueAxis(int deviceId, const DeckGamepadAxisEvent &event)
+    {
+        if (event.axis >= static_cast<uint32_t>(GAMEPAD_AXIS_MAX)) {
+            return false;
+        }
+        Slots &slots = slotsForDevice(deviceId);
+        const quint32 bit = 1u << event.axis;
+        if (!(slots.axisDirty & bit)) {
+            slots.axisDirty |= bit;
+            m_pendingAxisCount++;
+        }
+        slots.axes[event.axis] = event;
+        return true;
+    }
+
+    bool enqueueHat(int deviceId, const DeckGamepadHatEvent &event)
+    {
+        if (event.hat >= static_cast<uint32_t>(kMaxHats)) {
+            return false;
+        }
+        Slots &slots = slotsForDevice(deviceId);
+        const quint32 bit = 1u << event.hat;
+        if (!(slots.hatDirty & bit)) {
+            slots.hatDirty |= bit;
+            m_pendingHatCount++;
+        }
+        slots.hats[event.hat] = event;
+        return true;
+    }
+
+    int pendingAxisCount() const { return m_pendingAxisCount; }
+    int pendingHatCount() const { return m_pendingHatCount; }
+
+    // 设备表在 clear() 前只增不删。
+    void clear()
+    {
+        m_slots.clear();
+        m_pendingAxisCount = 0;
+        m_pendingHatCount = 0;
+    }
+
+    // 取出全部待发 axis 事件并按 (deviceId, axis) 升序调用 fn(deviceId, event)。
+    // 先取出该设备的 dirty 位与事件副本再回调，回调里重新入队不会干扰本轮遍历。
+    template <typename Fn>
+    void takeAxes(Fn &&fn)
+    {
+        m_pendingAxisCount = 0;
+        std::array<DeckGamepadAxisEvent, GAMEPAD_AXIS_MAX> events;
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            Slots &slots = m_slots[i];
+            quint32 dirty = std::exchange(slots.axisDirty, 0u);
+            if (!dirty) {
+                continue;
+            }
+            const int deviceId = slots.deviceId;
+            events = slots.axes;
+
+            while (dirty) {
+                const int axis = qCountTrailingZeroBits(dirty);
+                dirty &= dirty - 1;
+                fn(deviceId, events[static_cast<size_t>(axis)]);
+            }
+        }
+    }
+
+    // 取出全部待发 hat 事件，规则同 takeAxes()。
+    template <typename Fn>
+    void takeHats(Fn &&fn)
+    {
+        m_pendingHatCount = 0;
+        std::array<DeckGamepadHatEvent, kMaxHats> events;
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            Slots &slots = m_slots[i];
+            quint32 dirty = std::exchange(slots.hatDirty, 0u);
+            if (!dirty) {
+                continue;
+            }
+            const int deviceId = slots.deviceId;
+            events = slots.hats;
+
+            while (dirty) {
+                const int hat = qCountTrailingZeroBits(dirty);
+                dirty &= dirty - 1;
+                fn(deviceId, events[static_cast<size_t>(hat)]);
+            }
+        }
+    }
+
+private:
+    struct Slots {
+        int deviceId = -1;
+        quint32 axisDirty = 0;
+        quint32 hatDirty = 0;
+        std::array<DeckGamepadAxisEvent, GAMEPAD_AXIS_MAX> axes{};
+        std::array<DeckGamepadHatEvent, kMaxHats> hats{};
+    };
+
+    // 表按 deviceId 升序保存。
+    Slots &slotsForDevice(int deviceId)
+    {
+        auto it = std::lower_bound(m_slots.begin(), m_slots.end(), deviceId, [](const Slots &slots, int id) {
+            return slots.deviceId < id;
+        });
+        if (it == m_slots.end() || it->deviceId != deviceId) {
+            Slots slots;
+            slots.deviceId = deviceId;
+            it = m_slots.insert(it, slots);
+        }
+        return *it;
+    }
+
+    std::vector<Slots> m_slots;
+    int m_pendingAxisCount = 0;
+    int m_pendingHatCount = 0;
+};
+
+DECKGAMEPAD_END_NAMESPACE
@@ -5,14 +5,20 @@
 #include <deckshell/deckgamepad/service/deckgamepadservice.h>
 
 #include <deckshell/deckgamepad/core/deckgamepadaction.h>
+#include <deckshell/deckgamepad/core/deckgamepadsharedstate_p.h>
 #include <deckshell/deckgamepad/extras/actionmappingprofile.h>
 #include <deckshell/deckgamepad/extras/deckgamepadactionmapper.h>
 #include <deckshell/deckgamepad/providers/evdev/evdevprovider.h>
+#include <deckshell/deckgamepad/service/deckgamepadcoalescetable_p.h>
 
+#include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QMetaMethod>
 #include <QtCore/QMetaType>
 
 #include <algorithm>
+#include <utility>
 #include <errno.h>
 
 DECKGAMEPAD_BEGIN_NAMESPACE
@@ -32,18 +38,21 @@ static void registerDeckGamepadEventMetaTypes()
     (void)qRegisterMetaType<DeckGamepadButtonEvent>();
     (void)qRegisterMetaType<DeckGamepadAxisEvent>();
     (void)qRegisterMetaType<DeckGamepadHatEvent>();
+    (void)qRegisterMetaType<DeckGamepadFrameEvent>();
     (void)qRegisterMetaType<DeckGamepadActionEvent>();
     (void)qRegisterMetaType<DeckGamepadRuntimeConfig>();
     (void)qRegisterMetaType<DeckGamepadError>();
     (void)qRegisterMetaType<DeckGamepadErrorCode>();
     (void)qRegisterMetaType<DeckGamepadErrorKind>();
     (void)qRegisterMetaType<DeckGamepadDeviceAvailability>();
+    (void)qRegisterMetaType<DeckGamepadProbeHistogram>();
     (void)qRegisterMetaType<DeckGamepadDiagnostic>();
     (void)qRegisterMetaType<DeckGamepadDeviceInfo>();
     (void)qRegisterMetaType<DeckGamepadDeviceAccessMode>();
     (void)qRegisterMetaType<DeckGamepadCapturePolicy>();
     (void)qRegisterMetaType<DeckGamepadEvdevGrabMode>();
     (void)qRegisterMetaType<DeckGamepadProviderSelection>();
+    (void)qRegisterMetaType<DeckGamepadInputTransport>();
 }
 
 static DeckGamepadError decorateServiceError(DeckGamepadError error)
@@ -120,6 +129,7 @@ static IDeckGamepadProvider *createProviderForSelection(DeckGamepadProviderSelec
 
 DeckGamepadService::DeckGamepadService(QObject *parent)
     : QObject(parent)
+    , m_coalesceTable(std::make_unique<DeckGamepadCoalesceTable>())
 {
     registerDeckGamepadEventMetaTypes();
     m_actionMappingProfile = std::make_unique<ActionMappingProfile>(ActionMappingProfile::createNavigationPreset());
@@ -136,6 +146,7 @@ DeckGamepadService::DeckGamepadService(QObject *parent)
 
 DeckGamepadService::DeckGamepadService(IDeckGamepadProvider *provider, QObject *parent)
     : QObject(parent)
+    , m_coalesceTable(std::make_unique<DeckGamepadCoalesceTable>())
 {
     registerDeckGamepadEventMetaTypes();
     m_actionMappingProfile = std::make_unique<ActionMappingProfile>(ActionMappingProfile::createNavigationPreset());
@@ -194,15 +205,96 @@ void DeckGamepadService::clearActionMappers()
         delete mapper;
     }
     m_actionMapperByDevice.clear();
+    m_actionStringConnectionByDevice.clear();
     m_hat0ValueByDevice.clear();
 }
 
+bool DeckGamepadService::wantsActionStrings() const
+{
+    static const QMetaMethod actionEventSignal = QMetaMethod::fromSignal(&DeckGamepadService::actionEvent);
+    static const QMetaMethod actionTriggeredSignal = QMetaMethod::fromSignal(&DeckGamepadService::actionTriggered);
+    return isSignalConnected(actionEventSignal) || isSignalConnected(actionTriggeredSignal);
+}
+
+void DeckGamepadService::updateActionStringForwarding()
+{
+    const bool wanted = wantsActionStrings();
+    for (auto it = m_actionMapperByDevice.constBegin(); it != m_actionMapperByDevice.constEnd(); ++it) {
+        updateActionStringForwarding(it.key(), it.value(), wanted);
+    }
+}
+
+void DeckGamepadService::scheduleActionStringForwardingUpdate()
+{
+    if (m_actionStringForwardingDirty.exchange(true)) {
+        return;
+    }
+    QMetaObject::invokeMethod(
+        this,
+        [this] {
+            if (m_actionStringForwardingDirty.exchange(false)) {
+                updateActionStringForwarding();
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+void DeckGamepadService::updateActionStringForwarding(int deviceId, DeckGamepadActionMapper *mapper, bool wanted)
+{
+    const bool connected = m_actionStringConnectionByDevice.contains(deviceId);
+    if (wanted == connected) {
+        return;
+    }
+
+    if (!wanted) {
+        disconnect(m_actionStringConnectionByDevice.take(deviceId));
+        return;
+    }
+
+    m_actionStringConnectionByDevice.insert(
+        deviceId,
+        connect(mapper, &DeckGamepadActionMapper::actionEvent, this, [this, deviceId](DeckGamepadActionEvent event) {
+            // 接收方析构不经过 disconnectNotify()，在此补做一次退订。
+            if (!wantsActionStrings()) {
+                updateActionStringForwarding();
+                return;
+            }
+            Q_EMIT actionEvent(deviceId, event);
+            Q_EMIT actionTriggered(deviceId, event.actionId, event.pressed, event.repeated);
+        }));
+}
+
+void DeckGamepadService::connectNotify(const QMetaMethod &signal)
+{
+    if (signal == QMetaMethod::fromSignal(&DeckGamepadService::actionEvent)
+        || signal == QMetaMethod::fromSignal(&DeckGamepadService::actionTriggered)) {
+        scheduleActionStringForwardingUpdate();
+    }
+    QObject::connectNotify(signal);
+}
+
+void DeckGamepadService::disconnectNotify(const QMetaMethod &signal)
+{
+    // 断开全部连接时 signal 无效，同样需要重新判定。
+    if (!signal.isValid()
+        || signal == QMetaMethod::fromSignal(&DeckGamepadService::actionEvent)
+        || signal == QMetaMethod::fromSignal(&DeckGamepadService::actionTriggered)) {
+        scheduleActionStringForwardingUpdate();
+    }
+    QObject::disconnectNotify(signal);
+}
+
 DeckGamepadActionMapper *DeckGamepadService::ensureActionMapper(int deviceId)
 {
     if (deviceId < 0) {
         return nullptr;
     }
 
+    // 输入路径先于排队的判定生效：刚连接的监听者不会错过紧随其后的事件。
+    if (m_actionStringForwardingDirty.exchange(false)) {
+        updateActionStringForwarding();
+    }
+
     if (DeckGamepadActionMapper *existing = m_actionMapperByDevice.value(deviceId)) {
         return existing;
     }
@@ -216,12 +308,14 @@ DeckGamepadActionMapper *DeckGamepadService::ensureActionMapper(int deviceId)
         mapper->applyNavigationPreset();
     }
 
-    connect(mapper, &DeckGamepadActionMapper::actionEvent, this, [this, deviceId](DeckGamepadActionEvent event) {
-        Q_EMIT actionEvent(deviceId, event);
-    });
-    connect(mapper, &DeckGamepadActionMapper::actionTriggered, this, [this, deviceId](const QString &actionId, bool pressed, bool repeated) {
-        Q_EMIT actionTriggered(deviceId, actionId, pressed, repeated);
-    });
+    // 整数 id 信号始终转发；字符串信号按需订阅，无人监听时 mapper 不会构造 DeckGamepadActionEvent。
+    connect(mapper,
+            &DeckGamepadActionMapper::actionTriggeredId,
+            this,
+            [this, deviceId](int actionId, bool pressed, bool repeated) {
+                Q_EMIT actionTriggeredId(deviceId, actionId, pressed, repeated);
+            });
+    updateActionStringForwarding(deviceId, mapper, wantsActionStrings());
 
     m_actionMapperByDevice.insert(deviceId, mapper);
     m_hat0ValueByDevice.insert(deviceId, GAMEPAD_HAT_CENTER);
@@ -357,6 +451,16 @@ int DeckGamepadService::lastCoalesceLatencyMs() const
     return m_lastCoalesceLatencyMs;
 }
 
+int DeckGamepadService::lastTransportLatencyUs() const
+{
+    return m_lastTransportLatencyUs;
+}
+
+int DeckGamepadService::maxTransportLatencyUs() const
+{
+    return m_maxTransportLatencyUs;
+}
+
 bool DeckGamepadService::hasCustomMappingManager() const
 {
     return customMappingManager() != nullptr;
@@ -469,6 +573,9 @@ void DeckGamepadService::stop()
     }
 
     flushCoalescedAxisHatEvents();
+    m_coalesceTable->clear();
+    resetTransportLatency();
+    m_maxTransportLatencyUs = -1;
 
     if (m_provider) {
         m_provider->stop();
@@ -476,6 +583,9 @@ void DeckGamepadService::stop()
 
     clearActionMappers();
     clearPlayerAssignments();
+    if (m_sharedState) {
+        m_sharedState->releaseAll();
+    }
     setState(State::Stopped);
     Q_EMIT capabilitiesChanged();
 }
@@ -511,6 +621,9 @@ bool DeckGamepadService::setProviderInternal(IDeckGamepadProvider *provider, boo
     }
 
     IDeckGamepadProvider *previousProvider = m_provider;
+    if (previousProvider && m_frameTap) {
+        previousProvider->setFrameTap({});
+    }
 
     clearPlayerAssignments();
     clearActionMappers();
@@ -524,6 +637,9 @@ bool DeckGamepadService::setProviderInternal(IDeckGamepadProvider *provider, boo
     }
 
     ensureProviderConnections();
+    if (m_provider && m_frameTap) {
+        m_provider->setFrameTap(m_frameTap);
+    }
 
     Q_EMIT providerChanged();
     Q_EMIT capabilitiesChanged();
@@ -671,6 +787,14 @@ bool DeckGamepadService::startVibration(int deviceId, float weakMagnitude, float
     return m_provider->startVibration(deviceId, weakMagnitude, strongMagnitude, durationMs);
 }
 
+bool DeckGamepadService::playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern)
+{
+    if (!m_provider) {
+        return false;
+    }
+    return m_provider->playVibrationPattern(deviceId, pattern);
+}
+
 void DeckGamepadService::stopVibration(int deviceId)
 {
     if (!m_provider) {
@@ -679,6 +803,16 @@ void DeckGamepadService::stopVibration(int deviceId)
     m_provider->stopVibration(deviceId);
 }
 
+bool DeckGamepadService::setFrameTap(IDeckGamepadProvider::FrameTap tap)
+{
+    // 保留到 provider 切换后重新安装。
+    m_frameTap = std::move(tap);
+    if (!m_provider) {
+        return false;
+    }
+    return m_provider->setFrameTap(m_frameTap);
+}
+
 DeckGamepadCustomMappingManager *DeckGamepadService::customMappingManager() const
 {
     return m_provider ? m_provider->customMappingManager() : nullptr;
@@ -713,7 +847,8 @@ void DeckGamepadService::ensureProviderConnections()
 	                if (!diagnostic.isOk()) {
 	                    // provider 级诊断优先于 error（例如 focused gating / authorize 语义）
 	                    if (m_diagnostic.key == diagnostic.key && m_diagnostic.details == diagnostic.details
-	                        && m_diagnostic.suggestedActions == diagnostic.suggestedActions) {
+	                        && m_diagnostic.suggestedActions == diagnostic.suggestedActions
+	                        && m_diagnostic.startupProbe == diagnostic.startupProbe) {
 	                        return;
 	                    }
 	                    m_diagnostic = std::move(diagnostic);
@@ -742,7 +877,12 @@ void DeckGamepadService::ensureProviderConnections()
 	    connect(m_provider,
 	            &IDeckGamepadProvider::gamepadConnected,
 	            this,
-	            &DeckGamepadService::gamepadConnected);
+	            [this](int deviceId, const QString &name) {
+	                if (m_sharedState) {
+	                    m_sharedState->acquireSlot(deviceId);
+	                }
+	                Q_EMIT gamepadConnected(deviceId, name);
+	            });
 	    connect(m_provider,
 	            &IDeckGamepadProvider::gamepadDisconnected,
 	            this,
@@ -751,87 +891,213 @@ void DeckGamepadService::ensureProviderConnections()
 	                    mapper->reset();
 	                    delete mapper;
 	                }
+	                m_actionStringConnectionByDevice.remove(deviceId);
 	                m_hat0ValueByDevice.remove(deviceId);
 	                m_deviceAvailabilityCache.remove(deviceId);
 	                m_deviceErrorCache.remove(deviceId);
 	                unassignPlayer(deviceId);
+	                if (deviceId == m_lastTransportDeviceId) {
+	                    resetTransportLatency();
+	                }
+	                if (m_sharedState) {
+	                    m_sharedState->releaseSlot(deviceId);
+	                }
 	                Q_EMIT gamepadDisconnected(deviceId);
 	                updateDiagnostic();
 	            });
 
-    connect(m_provider,
-            &IDeckGamepadProvider::buttonEvent,
-            this,
-            [this](int deviceId, DeckGamepadButtonEvent event) {
-                m_totalEventCount++;
-                m_lastEventWallclockMs = QDateTime::currentMSecsSinceEpoch();
-                Q_EMIT buttonEvent(deviceId, event);
-
-                if (event.button < static_cast<uint32_t>(GAMEPAD_BUTTON_MAX)) {
-                    if (DeckGamepadActionMapper *mapper = ensureActionMapper(deviceId)) {
-                        mapper->processButton(static_cast<GamepadButton>(event.button),
-                                              event.pressed,
-                                              static_cast<int>(event.time_msec));
-                    }
-                }
-            });
-	    connect(m_provider,
-	            &IDeckGamepadProvider::axisEvent,
-	            this,
-	            [this](int deviceId, DeckGamepadAxisEvent event) {
-	                m_totalEventCount++;
-	                m_lastEventWallclockMs = QDateTime::currentMSecsSinceEpoch();
-	                m_axisRawEventCount++;
-
-	                const int intervalMs = m_runtimeConfig.axisCoalesceIntervalMs;
-	                if (intervalMs <= 0) {
-	                    m_axisEmittedEventCount++;
-	                    Q_EMIT axisEvent(deviceId, event);
-
-	                    if (event.axis < static_cast<uint32_t>(GAMEPAD_AXIS_MAX)) {
-	                        if (DeckGamepadActionMapper *mapper = ensureActionMapper(deviceId)) {
-	                            mapper->processAxis(static_cast<GamepadAxis>(event.axis),
-	                                                event.value,
-	                                                static_cast<int>(event.time_msec));
-	                        }
-	                    }
-	                    return;
-	                }
+    // 共享状态在 coalesce 之前发布（原始值），轮询方每帧看到的是最新状态而非节流后的输出。
+    connect(m_provider, &IDeckGamepadProvider::buttonEvent, this, [this](int deviceId, DeckGamepadButtonEvent event) {
+        if (m_sharedState) {
+            m_sharedState->publishButton(deviceId, event);
+        }
+        handleProviderButtonEvent(deviceId, event);
+    });
+    connect(m_provider, &IDeckGamepadProvider::axisEvent, this, [this](int deviceId, DeckGamepadAxisEvent event) {
+        if (m_sharedState) {
+            m_sharedState->publishAxis(deviceId, event);
+        }
+        handleProviderAxisEvent(deviceId, event);
+    });
+    connect(m_provider, &IDeckGamepadProvider::hatEvent, this, [this](int deviceId, DeckGamepadHatEvent event) {
+        if (m_sharedState) {
+            m_sharedState->publishHat(deviceId, event);
+        }
+        handleProviderHatEvent(deviceId, event);
+    });
+    connect(m_provider, &IDeckGamepadProvider::frameEvent, this, [this](int deviceId, DeckGamepadFrameEvent frame) {
+        if (m_sharedState) {
+            m_sharedState->publishFrame(deviceId, frame);
+        }
+        handleProviderFrameEvent(deviceId, std::move(frame));
+    });
+}
 
-	                const quint64 key = (static_cast<quint64>(static_cast<uint32_t>(deviceId)) << 32)
-	                    | static_cast<quint64>(event.axis);
-	                m_pendingAxisEvents.insert(key, event);
+bool DeckGamepadService::enableSharedState()
+{
+    if (m_sharedState) {
+        return true;
+    }
 
-	                if (!m_axisCoalesceTimer.isActive()) {
-	                    m_axisCoalesceStartWallclockMs = QDateTime::currentMSecsSinceEpoch();
-	                    m_axisCoalesceTimer.start(intervalMs);
-	                }
-	            });
-	    connect(m_provider,
-	            &IDeckGamepadProvider::hatEvent,
-	            this,
-	            [this](int deviceId, DeckGamepadHatEvent event) {
-	                m_totalEventCount++;
-	                m_lastEventWallclockMs = QDateTime::currentMSecsSinceEpoch();
-	                m_hatRawEventCount++;
-
-	                const int intervalMs = m_runtimeConfig.hatCoalesceIntervalMs;
-	                if (intervalMs <= 0) {
-	                    m_hatEmittedEventCount++;
-	                    Q_EMIT hatEvent(deviceId, event);
-	                    handleHatAsVirtualDpadButtons(deviceId, event);
-	                    return;
-	                }
+    auto writer = std::make_unique<DeckGamepadSharedStateWriter>();
+    QString errorMessage;
+    if (!writer->create(&errorMessage)) {
+        DeckGamepadError err;
+        err.code = DeckGamepadErrorCode::Io;
+        err.message = QStringLiteral("Failed to create shared state: %1").arg(errorMessage);
+        err.context = QStringLiteral("DeckGamepadService::enableSharedState");
+        err.recoverable = true;
+        setError(err);
+        return false;
+    }
 
-	                const quint64 key = (static_cast<quint64>(static_cast<uint32_t>(deviceId)) << 32)
-	                    | static_cast<quint64>(event.hat);
-	                m_pendingHatEvents.insert(key, event);
+    // 运行中启用：为已连接设备补占槽位（状态从零开始，随下一次输入更新）。
+    if (m_state == State::Running && m_provider) {
+        const QList<int> devices = m_provider->connectedGamepads();
+        for (int deviceId : devices) {
+            writer->acquireSlot(deviceId);
+        }
+    }
+    m_sharedState = std::move(writer);
+    return true;
+}
 
-	                if (!m_hatCoalesceTimer.isActive()) {
-	                    m_hatCoalesceStartWallclockMs = QDateTime::currentMSecsSinceEpoch();
-	                    m_hatCoalesceTimer.start(intervalMs);
-	                }
-	            });
+int DeckGamepadService::sharedStateFd() const
+{
+    return m_sharedState ? m_sharedState->fd() : -1;
+}
+
+QString DeckGamepadService::sharedStatePath() const
+{
+    if (!m_sharedState) {
+        return {};
+    }
+    return QStringLiteral("/proc/%1/fd/%2").arg(QCoreApplication::applicationPid()).arg(m_sharedState->fd());
+}
+
+void DeckGamepadService::handleProviderButtonEvent(int deviceId, DeckGamepadButtonEvent event)
+{
+    m_totalEventCount++;
+    m_lastEventWallclockMs = QDateTime::currentMSecsSinceEpoch();
+    Q_EMIT buttonEvent(deviceId, event);
+
+    if (event.button < static_cast<uint32_t>(GAMEPAD_BUTTON_MAX)) {
+        if (DeckGamepadActionMapper *mapper = ensureActionMapper(deviceId)) {
+            mapper->processButton(static_cast<GamepadButton>(event.button),
+                                  event.pressed,
+                                  static_cast<int>(event.time_msec));
+        }
+    }
+}
+
+void DeckGamepadService::handleProviderAxisEvent(int deviceId, DeckGamepadAxisEvent event)
+{
+    m_totalEventCount++;
+    m_lastEventWallclockMs = QDateTime::currentMSecsSinceEpoch();
+    m_axisRawEventCount++;
+
+    if (m_runtimeConfig.axisCoalesceIntervalMs <= 0) {
+        m_axisEmittedEventCount++;
+        Q_EMIT axisEvent(deviceId, event);
+
+        if (event.axis < static_cast<uint32_t>(GAMEPAD_AXIS_MAX)) {
+            if (DeckGamepadActionMapper *mapper = ensureActionMapper(deviceId)) {
+                mapper->processAxis(static_cast<GamepadAxis>(event.axis),
+                                    event.value,
+                                    static_cast<int>(event.time_msec));
+            }
+        }
+        return;
+    }
+
+    enqueueCoalescedAxisEvent(deviceId, event);
+}
+
+void DeckGamepadService::handleProviderHatEvent(int deviceId, DeckGamepadHatEvent event)
+{
+    m_totalEventCount++;
+    m_lastEventWallclockMs = QDateTime::currentMSecsSinceEpoch();
+    m_hatRawEventCount++;
+
+    const int intervalMs = m_runtimeConfig.hatCoalesceIntervalMs;
+    if (intervalMs <= 0) {
+        m_hatEmittedEventCount++;
+        Q_EMIT hatEvent(deviceId, event);
+        handleHatAsVirtualDpadButtons(deviceId, event);
+        return;
+    }
+
+    enqueueCoalescedHatEvent(deviceId, event);
+}
+
+void DeckGamepadService::handleProviderFrameEvent(int deviceId, DeckGamepadFrameEvent frame)
+{
+    if (frame.monotonicNs > 0) {
+        const qint64 nowNs = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+        m_lastTransportLatencyUs = static_cast<int>(qMax<qint64>(0, nowNs - frame.monotonicNs) / 1000);
+        m_lastTransportDeviceId = deviceId;
+        m_maxTransportLatencyUs = qMax(m_maxTransportLatencyUs, m_lastTransportLatencyUs);
+        updateLastCoalesceLatency();
+    }
+
+    for (const DeckGamepadButtonEvent &event : std::as_const(frame.buttons)) {
+        handleProviderButtonEvent(deviceId, event);
+    }
+
+    if (!frame.axes.isEmpty()) {
+        m_totalEventCount += static_cast<quint64>(frame.axes.size());
+        m_lastEventWallclockMs = QDateTime::currentMSecsSinceEpoch();
+        m_axisRawEventCount += static_cast<quint64>(frame.axes.size());
+
+        if (m_runtimeConfig.axisCoalesceIntervalMs <= 0) {
+            for (const DeckGamepadAxisEvent &event : std::as_const(frame.axes)) {
+                m_axisEmittedEventCount++;
+                Q_EMIT axisEvent(deviceId, event);
+            }
+            // 整帧交给 mapper：左摇杆 X/Y 同帧变化时只做一次方向判定。
+            if (DeckGamepadActionMapper *mapper = ensureActionMapper(deviceId)) {
+                mapper->processAxes(frame.axes, static_cast<int>(frame.time_msec));
+            }
+        } else {
+            for (const DeckGamepadAxisEvent &event : std::as_const(frame.axes)) {
+                enqueueCoalescedAxisEvent(deviceId, event);
+            }
+        }
+    }
+
+    for (const DeckGamepadHatEvent &event : std::as_const(frame.hats)) {
+        handleProviderHatEvent(deviceId, event);
+    }
+}
+
+void DeckGamepadService::enqueueCoalescedAxisEvent(int deviceId, const DeckGamepadAxisEvent &event)
+{
+    if (!m_coalesceTable->enqueueAxis(deviceId, event)) {
+        // 超出标准轴范围的事件无槽位可合并，直接透传。
+        m_axisEmittedEventCount++;
+        Q_EMIT axisEvent(deviceId, event);
+        return;
+    }
+
+    if (!m_axisCoalesceTimer.isActive()) {
+        m_axisCoalesceStartWallclockMs = QDateTime::currentMSecsSinceEpoch();
+        m_axisCoalesceTimer.start(m_runtimeConfig.axisCoalesceIntervalMs);
+    }
+}
+
+void DeckGamepadService::enqueueCoalescedHatEvent(int deviceId, const DeckGamepadHatEvent &event)
+{
+    if (!m_coalesceTable->enqueueHat(deviceId, event)) {
+        m_hatEmittedEventCount++;
+        Q_EMIT hatEvent(deviceId, event);
+        handleHatAsVirtualDpadButtons(deviceId, event);
+        return;
+    }
+
+    if (!m_hatCoalesceTimer.isActive()) {
+        m_hatCoalesceStartWallclockMs = QDateTime::currentMSecsSinceEpoch();
+        m_hatCoalesceTimer.start(m_runtimeConfig.hatCoalesceIntervalMs);
+    }
 }
 
 void DeckGamepadService::clearPlayerAssignments()
@@ -864,7 +1130,7 @@ void DeckGamepadService::flushCoalescedAxisHatEvents()
 
 void DeckGamepadService::flushCoalescedAxisEvents()
 {
-    if (m_pendingAxisEvents.isEmpty()) {
+    if (m_coalesceTable->pendingAxisCount() == 0) {
         return;
     }
 
@@ -874,31 +1140,38 @@ void DeckGamepadService::flushCoalescedAxisEvents()
     }
     m_axisCoalesceStartWallclockMs = -1;
 
-    // flush axis（按 key 排序，避免 QHash 迭代顺序导致测试不稳定）
-    QList<quint64> keys = m_pendingAxisEvents.keys();
-    std::sort(keys.begin(), keys.end());
-    for (const quint64 key : keys) {
-        const int deviceId = static_cast<int>((key >> 32) & 0xffffffffu);
+    // 按 (deviceId, axis) 升序输出；同一设备的轴攒成一批交给 processAxes()，摇杆 X/Y 一起生效（与帧路径一致）。
+    int batchDeviceId = -1;
+    uint32_t batchTimeMs = 0;
+    const auto flushBatch = [this, &batchDeviceId, &batchTimeMs]() {
+        if (m_axisFlushBatch.isEmpty()) {
+            return;
+        }
+        if (DeckGamepadActionMapper *mapper = ensureActionMapper(batchDeviceId)) {
+            mapper->processAxes(m_axisFlushBatch, static_cast<int>(batchTimeMs));
+        }
+        m_axisFlushBatch.clear();
+        batchTimeMs = 0;
+    };
+    m_coalesceTable->takeAxes([this, &batchDeviceId, &batchTimeMs, &flushBatch](int deviceId, const DeckGamepadAxisEvent &event) {
         m_axisEmittedEventCount++;
-        const DeckGamepadAxisEvent event = m_pendingAxisEvents.value(key);
         Q_EMIT axisEvent(deviceId, event);
 
-        if (event.axis < static_cast<uint32_t>(GAMEPAD_AXIS_MAX)) {
-            if (DeckGamepadActionMapper *mapper = ensureActionMapper(deviceId)) {
-                mapper->processAxis(static_cast<GamepadAxis>(event.axis),
-                                    event.value,
-                                    static_cast<int>(event.time_msec));
-            }
+        if (deviceId != batchDeviceId) {
+            flushBatch();
+            batchDeviceId = deviceId;
         }
-    }
-    m_pendingAxisEvents.clear();
+        m_axisFlushBatch.append(event);
+        batchTimeMs = qMax(batchTimeMs, event.time_msec);
+    });
+    flushBatch();
 
-    m_lastCoalesceLatencyMs = qMax(m_lastAxisCoalesceLatencyMs, m_lastHatCoalesceLatencyMs);
+    updateLastCoalesceLatency();
 }
 
 void DeckGamepadService::flushCoalescedHatEvents()
 {
-    if (m_pendingHatEvents.isEmpty()) {
+    if (m_coalesceTable->pendingHatCount() == 0) {
         return;
     }
 
@@ -908,19 +1181,28 @@ void DeckGamepadService::flushCoalescedHatEvents()
     }
     m_hatCoalesceStartWallclockMs = -1;
 
-    // flush hat（按 key 排序，避免 QHash 迭代顺序导致测试不稳定）
-    QList<quint64> keys = m_pendingHatEvents.keys();
-    std::sort(keys.begin(), keys.end());
-    for (const quint64 key : keys) {
-        const int deviceId = static_cast<int>((key >> 32) & 0xffffffffu);
+    // 按 (deviceId, hat) 升序输出。
+    m_coalesceTable->takeHats([this](int deviceId, const DeckGamepadHatEvent &event) {
         m_hatEmittedEventCount++;
-        const DeckGamepadHatEvent event = m_pendingHatEvents.value(key);
         Q_EMIT hatEvent(deviceId, event);
         handleHatAsVirtualDpadButtons(deviceId, event);
-    }
-    m_pendingHatEvents.clear();
+    });
+
+    updateLastCoalesceLatency();
+}
+
+void DeckGamepadService::updateLastCoalesceLatency()
+{
+    const int transportLatencyMs = m_lastTransportLatencyUs > 0 ? (m_lastTransportLatencyUs + 999) / 1000 : 0;
+    m_lastCoalesceLatencyMs = qMax(qMax(m_lastAxisCoalesceLatencyMs, m_lastHatCoalesceLatencyMs), transportLatencyMs);
+}
 
-    m_lastCoalesceLatencyMs = qMax(m_lastAxisCoalesceLatencyMs, m_lastHatCoalesceLatencyMs);
+void DeckGamepadService::resetTransportLatency()
+{
+    // 设备移除或传输重建后旧值不再代表当前链路。
+    m_lastTransportLatencyUs = -1;
+    m_lastTransportDeviceId = -1;
+    updateLastCoalesceLatency();
 }
 
 void DeckGamepadService::clearError()
@@ -949,9 +1231,11 @@ void DeckGamepadService::setState(State state)
 void DeckGamepadService::updateDiagnostic()
 {
     DeckGamepadDiagnostic next;
+    DeckGamepadProbeHistogram startupProbe;
 
     if (m_provider) {
         next = m_provider->diagnostic();
+        startupProbe = next.startupProbe;
     }
 
     if (next.isOk()) {
@@ -982,8 +1266,10 @@ void DeckGamepadService::updateDiagnostic()
         }
     }
 
+    next.startupProbe = startupProbe;
+
     if (m_diagnostic.key == next.key && m_diagnostic.details == next.details
-        && m_diagnostic.suggestedActions == next.suggestedActions) {
+        && m_diagnostic.suggestedActions == next.suggestedActions && m_diagnostic.startupProbe == next.startupProbe) {
         return;
     }
 
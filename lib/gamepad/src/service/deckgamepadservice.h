@@ -11,6 +11,7 @@
 #include <deckshell/deckgamepad/core/deckgamepadaction.h>
 #include <deckshell/deckgamepad/core/deckgamepaddiagnostic.h>
 #include <array>
+#include <atomic>
 #include <memory>
 #include <QtCore/QHash>
 #include <QtCore/QObject>
@@ -24,6 +25,8 @@ DECKGAMEPAD_BEGIN_NAMESPACE
 class DeckGamepadCustomMappingManager;
 class ICalibrationStore;
 class DeckGamepadActionMapper;
+class DeckGamepadSharedStateWriter;
+class DeckGamepadCoalesceTable;
 struct ActionMappingProfile;
 
 class DECKGAMEPAD_EXPORT DeckGamepadService final : public QObject
@@ -67,7 +70,13 @@ public:
     quint64 hatRawEventCount() const;
     quint64 hatEmittedEventCount() const;
     quint64 hatDroppedEventCount() const;
+    // 含 provider → Service 的帧投递延迟（IO 线程成帧到 Service 收到，见 DeckGamepadFrameEvent::monotonicNs），
+    // 向上取整到毫秒：亚毫秒的投递延迟记为 1 而不是 0。
     int lastCoalesceLatencyMs() const;
+    // 最近一帧的投递延迟（微秒精度；-1 表示 provider 未提供成帧时刻）。
+    int lastTransportLatencyUs() const;
+    // start() 以来投递延迟的最大值（微秒；-1 表示尚无样本），用于观察偶发的长尾。
+    int maxTransportLatencyUs() const;
 
     bool hasCustomMappingManager() const;
     bool hasCalibrationStore() const;
@@ -98,8 +107,12 @@ public:
     void setAxisSensitivity(int deviceId, uint32_t axis, float sensitivity);
 
     bool startVibration(int deviceId, float weakMagnitude, float strongMagnitude, int durationMs = 1000);
+    bool playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern);
     void stopVibration(int deviceId);
 
+    // 帧旁路：转发给 provider（见 IDeckGamepadProvider::setFrameTap），tap 运行在 provider 输入线程。
+    bool setFrameTap(IDeckGamepadProvider::FrameTap tap);
+
     DeckGamepadCustomMappingManager *customMappingManager() const;
     ICalibrationStore *calibrationStore() const;
 
@@ -109,6 +122,14 @@ public:
     void unassignPlayer(int deviceId);
     int playerIndex(int deviceId) const;
 
+    // ========== 共享状态快照 ==========
+    // 在 memfd 中发布每设备当前状态（seqlock），供轮询型消费者用 DeckGamepadSharedStateReader 只读映射。
+    // 幂等；可在运行中启用。启用后直到 Service 析构都保持同一 fd（stop/start 只清空槽位）。
+    bool enableSharedState();
+    int sharedStateFd() const; // 未启用返回 -1
+    // 供其他进程打开的路径（/proc/<pid>/fd/<n>，受 ptrace 访问规则约束）；未启用返回空。
+    QString sharedStatePath() const;
+
 Q_SIGNALS:
     void stateChanged(DeckGamepadService::State state);
     void lastErrorChanged();
@@ -132,6 +153,12 @@ Q_SIGNALS:
     // 直接输出稳定 actionId（可配置 mapping profile），避免上层重复实现 mapper/priority/repeat。
     void actionEvent(int deviceId, DeckGamepadActionEvent event);
     void actionTriggered(int deviceId, const QString &actionId, bool pressed, bool repeated);
+    // 整数 id 版本（DeckGamepadActionRegistry::name() 可还原字符串）。
+    void actionTriggeredId(int deviceId, int actionId, bool pressed, bool repeated);
+
+protected:
+    void connectNotify(const QMetaMethod &signal) override;
+    void disconnectNotify(const QMetaMethod &signal) override;
 
 private:
     bool setProviderInternal(IDeckGamepadProvider *provider, bool disableAutoSelect);
@@ -139,14 +166,26 @@ private:
     void clearProviderConnections();
     void updateDiagnostic();
     static DeckGamepadDiagnostic diagnosticFromError(const DeckGamepadError &error);
+    void handleProviderButtonEvent(int deviceId, DeckGamepadButtonEvent event);
+    void handleProviderAxisEvent(int deviceId, DeckGamepadAxisEvent event);
+    void handleProviderHatEvent(int deviceId, DeckGamepadHatEvent event);
+    void handleProviderFrameEvent(int deviceId, DeckGamepadFrameEvent frame);
+    void enqueueCoalescedAxisEvent(int deviceId, const DeckGamepadAxisEvent &event);
+    void enqueueCoalescedHatEvent(int deviceId, const DeckGamepadHatEvent &event);
     void flushCoalescedAxisHatEvents();
     void flushCoalescedAxisEvents();
     void flushCoalescedHatEvents();
+    void updateLastCoalesceLatency();
+    void resetTransportLatency();
 
     void clearPlayerAssignments();
 
     bool reloadActionMappingProfile();
     void clearActionMappers();
+    void updateActionStringForwarding();
+    void scheduleActionStringForwardingUpdate();
+    void updateActionStringForwarding(int deviceId, DeckGamepadActionMapper *mapper, bool wanted);
+    bool wantsActionStrings() const;
     DeckGamepadActionMapper *ensureActionMapper(int deviceId);
     void handleHatAsVirtualDpadButtons(int deviceId, const DeckGamepadHatEvent &event);
 
@@ -170,16 +209,23 @@ private:
 
     bool m_providerConnectionsReady = false;
 
+    // coalesce 槽位表（见 deckgamepadcoalescetable_p.h），stop() 时清空。
+    std::unique_ptr<DeckGamepadCoalesceTable> m_coalesceTable;
+
     QTimer m_axisCoalesceTimer;
+    // flushCoalescedAxisEvents() 的单设备批次缓冲（复用容量）。
+    QList<DeckGamepadAxisEvent> m_axisFlushBatch;
     qint64 m_axisCoalesceStartWallclockMs = -1;
-    QHash<quint64, DeckGamepadAxisEvent> m_pendingAxisEvents;
 
     QTimer m_hatCoalesceTimer;
     qint64 m_hatCoalesceStartWallclockMs = -1;
-    QHash<quint64, DeckGamepadHatEvent> m_pendingHatEvents;
 
     std::unique_ptr<ActionMappingProfile> m_actionMappingProfile;
     QHash<int, DeckGamepadActionMapper *> m_actionMapperByDevice;
+    // 仅在 actionEvent/actionTriggered 有连接时订阅 mapper 的字符串信号（见 updateActionStringForwarding()）。
+    QHash<int, QMetaObject::Connection> m_actionStringConnectionByDevice;
+    // connectNotify/disconnectNotify 可能在其它线程、持有连接锁时调用：只置位并投递到服务线程重新判定。
+    std::atomic<bool> m_actionStringForwardingDirty{ false };
     QHash<int, int> m_hat0ValueByDevice;
 
     static constexpr int kMaxPlayerSlots = 4;
@@ -192,7 +238,13 @@ private:
     quint64 m_hatEmittedEventCount = 0;
     int m_lastAxisCoalesceLatencyMs = 0;
     int m_lastHatCoalesceLatencyMs = 0;
+    int m_lastTransportLatencyUs = -1;
+    int m_maxTransportLatencyUs = -1;
+    int m_lastTransportDeviceId = -1;
     int m_lastCoalesceLatencyMs = 0;
+
+    std::unique_ptr<DeckGamepadSharedStateWriter> m_sharedState;
+    IDeckGamepadProvider::FrameTap m_frameTap;
 };
 
 DECKGAMEPAD_END_NAMESPACE
@@ -11,12 +11,15 @@
 #include <deckshell/deckgamepad/core/deckgamepaddiagnostic.h>
 #include <deckshell/deckgamepad/core/deckgamepaderror.h>
 #include <deckshell/deckgamepad/core/deckgamepaddeviceinfo.h>
+#include <deckshell/deckgamepad/core/deckgamepadrumble.h>
 #include <deckshell/deckgamepad/core/deckgamepadruntimeconfig.h>
 
 #include <QtCore/QList>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 
+#include <functional>
+
 DECKGAMEPAD_BEGIN_NAMESPACE
 
 class DeckGamepadCustomMappingManager;
@@ -68,12 +71,29 @@ public:
     virtual void setAxisDeadzone(int deviceId, uint32_t axis, float deadzone) = 0;
     virtual void setAxisSensitivity(int deviceId, uint32_t axis, float sensitivity) = 0;
 
+    // 振动：startVibration 可按帧高频调用（provider 负责合并输出）；durationMs == 0 表示持续到 stop。
     virtual bool startVibration(int deviceId,
                                 float weakMagnitude,
                                 float strongMagnitude,
                                 int durationMs) = 0;
+    // 一次提交整段片段（序列/包络），覆盖当前振动；不支持时返回 false（默认实现）。
+    virtual bool playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern)
+    {
+        Q_UNUSED(deviceId);
+        Q_UNUSED(pattern);
+        return false;
+    }
     virtual void stopVibration(int deviceId) = 0;
 
+    // 帧旁路（可选）：tap 在 provider 的输入线程内对每个设备帧同步调用，早于跨线程投递；
+    // tap 必须线程安全且不可阻塞。传空函数移除；不支持时返回 false（默认实现）。
+    using FrameTap = std::function<void(int deviceId, const DeckGamepadFrameEvent &frame)>;
+    virtual bool setFrameTap(FrameTap tap)
+    {
+        Q_UNUSED(tap);
+        return false;
+    }
+
     // 可选能力端口：不可用时返回 nullptr；端口对象生命周期必须清晰（推荐与 Service 绑定）。
     virtual DeckGamepadCustomMappingManager *customMappingManager() const = 0;
     virtual ICalibrationStore *calibrationStore() const = 0;
@@ -94,6 +114,9 @@ Q_SIGNALS:
     void buttonEvent(int deviceId, DeckGamepadButtonEvent event);
     void axisEvent(int deviceId, DeckGamepadAxisEvent event);
     void hatEvent(int deviceId, DeckGamepadHatEvent event);
+    // 可选：设备帧批量事件（一次投递同一 SYN_REPORT 内的全部变化）。
+    // 发出 frameEvent 的 provider 不应再为同一批变化重复发出逐事件信号。
+    void frameEvent(int deviceId, DeckGamepadFrameEvent frame);
 };
 
 DECKGAMEPAD_END_NAMESPACE
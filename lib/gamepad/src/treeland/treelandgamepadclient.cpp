@@ -9,25 +9,167 @@
 #include <wayland-client.h>
 
 #include <QDebug>
+#include <QMutex>
 #include <QPointer>
 #include <QSocketNotifier>
+#include <QThread>
 #include <QTimer>
+#include <QWaitCondition>
 
+#include <atomic>
+#include <cerrno>
 #include <cstring>
+#include <functional>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace TreelandGamepad {
 
+namespace {
+
+// Wayland 读取线程：只做 prepare_read/poll/read_events（libwayland 的多线程读取接口），
+// 协议回调仍在 client 所在线程分发——gamepad 对象的创建/释放与请求都发生在该线程，分发必须与之同线程。
+// 每次读取后投递一次分发，分发完成前不再读取：事件在 socket/队列中按批积累，GUI 线程每批只被唤醒一次。
+class WaylandReaderThread final : public QThread
+{
+public:
+    WaylandReaderThread(wl_display *display,
+                        std::function<void()> postDispatch,
+                        std::function<void(const QString &)> postFailure)
+        : m_display(display)
+        , m_postDispatch(std::move(postDispatch))
+        , m_postFailure(std::move(postFailure))
+        , m_wakeFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+    {
+        setObjectName(QStringLiteral("TreelandGamepadReader"));
+    }
+
+    ~WaylandReaderThread() override
+    {
+        stopReading();
+        if (m_wakeFd >= 0) {
+            ::close(m_wakeFd);
+        }
+    }
+
+    bool isValid() const { return m_wakeFd >= 0; }
+
+    void stopReading()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stopping = true;
+            m_cond.wakeAll();
+        }
+        if (m_wakeFd >= 0) {
+            const uint64_t one = 1;
+            (void)::write(m_wakeFd, &one, sizeof(one));
+        }
+        wait();
+    }
+
+    void batchDispatched()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_dispatchPending = false;
+        m_cond.wakeAll();
+    }
+
+protected:
+    void run() override
+    {
+        const int displayFd = wl_display_get_fd(m_display);
+
+        for (;;) {
+            {
+                QMutexLocker locker(&m_mutex);
+                while (m_dispatchPending && !m_stopping) {
+                    m_cond.wait(&m_mutex);
+                }
+                if (m_stopping) {
+                    return;
+                }
+            }
+
+            if (wl_display_prepare_read(m_display) != 0) {
+                // 队列中已有未分发事件（例如 connect 阶段 roundtrip 留下的）：先交给所属线程分发。
+                postBatch();
+                continue;
+            }
+
+            wl_display_flush(m_display);
+
+            pollfd fds[2] = {
+                { displayFd, POLLIN, 0 },
+                { m_wakeFd, POLLIN, 0 },
+            };
+            const int ret = ::poll(fds, 2, -1);
+            if (ret < 0 && errno == EINTR) {
+                wl_display_cancel_read(m_display);
+                continue;
+            }
+            if (ret < 0 || (fds[1].revents & POLLIN)) {
+                const int error = errno;
+                wl_display_cancel_read(m_display);
+                if (ret < 0) {
+                    // display 本身没有出错，dispatch_pending 不会失败：需显式通知所属线程断开。
+                    m_postFailure(QStringLiteral("Wayland reader poll failed: %1")
+                                      .arg(QString::fromLocal8Bit(strerror(error))));
+                }
+                return;
+            }
+
+            if (wl_display_read_events(m_display) < 0) {
+                // 连接已断开：分发侧的 dispatch_pending 会返回错误并断开连接。
+                postBatch();
+                return;
+            }
+            postBatch();
+        }
+    }
+
+private:
+    void postBatch()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_dispatchPending = true;
+        }
+        m_postDispatch();
+    }
+
+    wl_display *m_display = nullptr;
+    std::function<void()> m_postDispatch;
+    std::function<void(const QString &)> m_postFailure;
+    int m_wakeFd = -1;
+
+    QMutex m_mutex;
+    QWaitCondition m_cond;
+    bool m_dispatchPending = false;
+    bool m_stopping = false;
+};
+
+} // namespace
+
 struct TreelandGamepadClient::Private
 {
     TreelandGamepadClient *q = nullptr;
 
     wl_display *display = nullptr;
     wl_registry *registry = nullptr;
+    wl_callback *syncCallback = nullptr;
     QSocketNotifier *socketNotifier = nullptr;
+    std::unique_ptr<WaylandReaderThread> reader;
 
     QPointer<TreelandGamepadManager> manager;
     QHash<int, TreelandGamepadDevice *> devices;
     bool protocolReady = false;
+    bool connected = false;
+    bool asyncConnect = false;
+    int vibrationMinIntervalMs = 8;
+    quint64 connectGeneration = 0;
 
     quint64 totalEventCount = 0;
     QString lastDiagnostic;
@@ -79,6 +221,11 @@ struct TreelandGamepadClient::Private
                              [d](uint32_t error) {
                                  Q_EMIT d->q->authorizationFailed(error);
                              });
+
+            if (d->asyncConnect) {
+                d->connected = true;
+                Q_EMIT d->q->connectedChanged(true);
+            }
         }
     }
 
@@ -89,6 +236,32 @@ struct TreelandGamepadClient::Private
         Q_UNUSED(name)
         // 如需处理移除
     }
+
+    // 异步连接：wl_display_sync 的 done 表示初始 globals 已全部送达
+    static const struct wl_callback_listener syncListener;
+
+    static void syncDone(void *data, wl_callback *callback, uint32_t callbackData)
+    {
+        Q_UNUSED(callbackData)
+
+        auto *d = static_cast<Private *>(data);
+        wl_callback_destroy(callback);
+        d->syncCallback = nullptr;
+
+        if (!d->protocolReady) {
+            // 正处于 dispatch 中，不能在此断开 display：排队到下一轮事件循环。
+            QMetaObject::invokeMethod(
+                d->q,
+                [q = d->q, generation = d->connectGeneration]() {
+                    if (q->d->connectGeneration != generation || q->d->protocolReady) {
+                        return;
+                    }
+                    q->failConnect(QStringLiteral(
+                        "treeland_gamepad_manager_v1 protocol is not available on this compositor"));
+                },
+                Qt::QueuedConnection);
+        }
+    }
 };
 
 const struct wl_registry_listener TreelandGamepadClient::Private::registryListener = {
@@ -96,6 +269,10 @@ const struct wl_registry_listener TreelandGamepadClient::Private::registryListen
     &TreelandGamepadClient::Private::registryGlobalRemove
 };
 
+const struct wl_callback_listener TreelandGamepadClient::Private::syncListener = {
+    &TreelandGamepadClient::Private::syncDone
+};
+
 TreelandGamepadClient::TreelandGamepadClient(QObject *parent)
     : QObject(parent)
     , d(std::make_unique<Private>())
@@ -113,6 +290,11 @@ TreelandGamepadClient::~TreelandGamepadClient()
 }
 
 bool TreelandGamepadClient::connectToCompositor(const QString &socketName)
+{
+    return connectToCompositor(socketName, ConnectOptions{});
+}
+
+bool TreelandGamepadClient::connectToCompositor(const QString &socketName, const ConnectOptions &options)
 {
     if (d->display) {
         qWarning() << "Already connected to compositor";
@@ -126,20 +308,38 @@ bool TreelandGamepadClient::connectToCompositor(const QString &socketName)
         d->display = wl_display_connect(socketName.toUtf8().constData());
     }
 
+    ++d->connectGeneration;
+
     if (!d->display) {
         qWarning() << "Failed to connect to Wayland display" << socketName;
+        if (options.async) {
+            // 异步调用方只观察信号：失败同样经事件循环投递，与协议缺失的路径一致。
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation = d->connectGeneration, socketName]() {
+                    if (d->connectGeneration != generation || d->display) {
+                        return;
+                    }
+                    Q_EMIT connectFailed(QStringLiteral("Failed to connect to Wayland display %1").arg(socketName));
+                },
+                Qt::QueuedConnection);
+            return true;
+        }
         return false;
     }
 
+    d->asyncConnect = options.async;
+    d->vibrationMinIntervalMs = options.vibrationMinIntervalMs;
     setupRegistry();
 
-    // 接入 Qt 事件循环
-    int fd = wl_display_get_fd(d->display);
-    d->socketNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
-    connect(d->socketNotifier,
-            &QSocketNotifier::activated,
-            this,
-            &TreelandGamepadClient::handleWaylandEvents);
+    if (options.async) {
+        // 不等待 compositor：globals 与设备随后经事件循环到达，sync done 时仍未见协议则判定失败。
+        d->syncCallback = wl_display_sync(d->display);
+        wl_callback_add_listener(d->syncCallback, &Private::syncListener, d.get());
+        wl_display_flush(d->display);
+        startEventDispatch(options.dispatchMode);
+        return true;
+    }
 
     // 首次 roundtrip 获取 globals
     wl_display_roundtrip(d->display);
@@ -154,6 +354,10 @@ bool TreelandGamepadClient::connectToCompositor(const QString &socketName)
     wl_display_roundtrip(d->display);
     wl_display_dispatch_pending(d->display);
 
+    // roundtrip 完成后再接入事件循环/读取线程，避免与阻塞读取交叉。
+    startEventDispatch(options.dispatchMode);
+
+    d->connected = true;
     Q_EMIT connectedChanged(true);
     return true;
 }
@@ -164,6 +368,11 @@ void TreelandGamepadClient::disconnectFromCompositor()
         return;
     }
 
+    const bool wasConnected = d->connected;
+
+    // 先停止读取线程/socket notifier，之后的清理不再与读取并发。
+    stopEventDispatch();
+
     // 清理设备
     for (auto it = d->devices.cbegin(); it != d->devices.cend(); ++it) {
         if (it.value()) {
@@ -182,17 +391,12 @@ void TreelandGamepadClient::disconnectFromCompositor()
     // 清理 registry
     teardownRegistry();
 
-    // 清理 socket notifier
-    if (d->socketNotifier) {
-        d->socketNotifier->setEnabled(false);
-        d->socketNotifier->deleteLater();
-        d->socketNotifier = nullptr;
-    }
-
     // 断开 display 连接
     wl_display_disconnect(d->display);
     d->display = nullptr;
     d->protocolReady = false;
+    d->connected = false;
+    d->asyncConnect = false;
 
     if (d->totalEventCount != 0) {
         d->totalEventCount = 0;
@@ -212,12 +416,19 @@ void TreelandGamepadClient::disconnectFromCompositor()
     d->focusDiagnosticEmitted = false;
     d->focusDiagnosticScheduled = false;
 
-    Q_EMIT connectedChanged(false);
+    if (wasConnected) {
+        Q_EMIT connectedChanged(false);
+    }
 }
 
 bool TreelandGamepadClient::isConnected() const
 {
-    return d->display != nullptr;
+    return d->connected;
+}
+
+bool TreelandGamepadClient::isConnecting() const
+{
+    return d->display != nullptr && !d->connected;
 }
 
 quint64 TreelandGamepadClient::totalEventCount() const
@@ -255,6 +466,12 @@ void TreelandGamepadClient::setVibration(int deviceId,
     }
 }
 
+bool TreelandGamepadClient::playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern)
+{
+    auto *device = gamepad(deviceId);
+    return device && device->playVibrationPattern(pattern);
+}
+
 void TreelandGamepadClient::stopVibration(int deviceId)
 {
     if (auto *device = gamepad(deviceId)) {
@@ -305,6 +522,109 @@ void TreelandGamepadClient::handleWaylandEvents()
 
     // 分发事件
     wl_display_dispatch_pending(d->display);
+
+    // 回调中产生的请求（bind/get_gamepad 等）立即发出，不等下一次 socket 可读。
+    flushRequests();
+}
+
+void TreelandGamepadClient::dispatchReadEvents()
+{
+    if (!d->display || !d->reader) {
+        return;
+    }
+
+    // 读取线程已把一批事件读入队列：一次分发完，再放行下一次读取。
+    if (wl_display_dispatch_pending(d->display) < 0) {
+        const int error = wl_display_get_error(d->display);
+        handleConnectionLost(
+            QStringLiteral("Wayland connection error: %1").arg(QString::fromLocal8Bit(strerror(error))));
+        return;
+    }
+    flushRequests();
+
+    // 分发过程中可能已断开（例如回调里触发了 disconnect）。
+    if (d->reader) {
+        d->reader->batchDispatched();
+    }
+}
+
+void TreelandGamepadClient::handleConnectionLost(const QString &reason)
+{
+    if (d->connected) {
+        // 已建立的连接中断：按普通断开处理（connectedChanged(false)）。
+        qWarning() << "Treeland gamepad:" << reason;
+        disconnectFromCompositor();
+    } else {
+        failConnect(reason);
+    }
+}
+
+void TreelandGamepadClient::startEventDispatch(DispatchMode mode)
+{
+    if (mode == DispatchMode::ReaderThread) {
+        auto reader = std::make_unique<WaylandReaderThread>(
+            d->display,
+            [this]() {
+                QMetaObject::invokeMethod(this, &TreelandGamepadClient::dispatchReadEvents, Qt::QueuedConnection);
+            },
+            [this, generation = d->connectGeneration](const QString &reason) {
+                // 投递到达前可能已断开并重连：只处理本次连接的读取线程上报的错误。
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, generation, reason]() {
+                        if (d->display && d->reader && generation == d->connectGeneration) {
+                            handleConnectionLost(reason);
+                        }
+                    },
+                    Qt::QueuedConnection);
+            });
+        if (reader->isValid()) {
+            d->reader = std::move(reader);
+            d->reader->start();
+            return;
+        }
+        qWarning() << "Treeland gamepad: failed to create reader thread wakeup fd, falling back to GUI thread dispatch";
+    }
+
+    // 接入 Qt 事件循环
+    const int fd = wl_display_get_fd(d->display);
+    d->socketNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(d->socketNotifier,
+            &QSocketNotifier::activated,
+            this,
+            &TreelandGamepadClient::handleWaylandEvents);
+}
+
+void TreelandGamepadClient::stopEventDispatch()
+{
+    if (d->reader) {
+        d->reader->stopReading();
+        d->reader.reset();
+    }
+
+    if (d->socketNotifier) {
+        d->socketNotifier->setEnabled(false);
+        d->socketNotifier->deleteLater();
+        d->socketNotifier = nullptr;
+    }
+}
+
+void TreelandGamepadClient::failConnect(const QString &reason)
+{
+    if (!d->display) {
+        return;
+    }
+
+    qWarning() << "Treeland gamepad:" << reason;
+    disconnectFromCompositor();
+    Q_EMIT connectFailed(reason);
+}
+
+void TreelandGamepadClient::flushRequests()
+{
+    if (d->display) {
+        wl_display_flush(d->display);
+    }
 }
 
 void TreelandGamepadClient::setupRegistry()
@@ -315,6 +635,10 @@ void TreelandGamepadClient::setupRegistry()
 
 void TreelandGamepadClient::teardownRegistry()
 {
+    if (d->syncCallback) {
+        wl_callback_destroy(d->syncCallback);
+        d->syncCallback = nullptr;
+    }
     if (d->registry) {
         wl_registry_destroy(d->registry);
         d->registry = nullptr;
@@ -329,6 +653,7 @@ void TreelandGamepadClient::handleGamepadAdded(int deviceId, const QString &name
 
     // 创建设备包装对象
     auto device = new TreelandGamepadDevice(this, deviceId, name);
+    device->setVibrationMinIntervalMs(d->vibrationMinIntervalMs);
 
     // 连接设备信号到全局信号
     connect(device,
@@ -13,6 +13,7 @@ QT_BEGIN_NAMESPACE
 class QSocketNotifier;
 QT_END_NAMESPACE
 
+struct wl_callback;
 struct wl_display;
 struct wl_registry;
 struct treeland_gamepad_manager_v1;
@@ -31,13 +32,33 @@ class TREELAND_GAMEPAD_EXPORT TreelandGamepadClient : public QObject
     Q_PROPERTY(uint32_t grantedCapabilities READ grantedCapabilities NOTIFY grantedCapabilitiesChanged)
 
 public:
+    // Wayland 事件的读取/分发位置
+    enum class DispatchMode {
+        GuiThread,    // QSocketNotifier：在本对象所在线程读取并分发（默认）
+        ReaderThread, // 专用线程 poll/read socket，每批事件投递一次到本对象所在线程分发
+    };
+    Q_ENUM(DispatchMode)
+
+    struct ConnectOptions {
+        // true：不做 wl_display_roundtrip，立即返回；协议绑定后发 connectedChanged(true)，
+        // 设备随 gamepad_added 到达发 gamepadAdded；连不上 display 或 compositor 不提供协议时
+        // 都经事件循环发 connectFailed（此时 connectToCompositor 仍返回 true）。
+        bool async = false;
+        DispatchMode dispatchMode = DispatchMode::GuiThread;
+        // 每设备振动调度的最小发送间隔（见 DeckGamepadRumbleScheduler）；0 为不合并。
+        int vibrationMinIntervalMs = 8;
+    };
+
     explicit TreelandGamepadClient(QObject *parent = nullptr);
     ~TreelandGamepadClient();
 
     // Connection management
     bool connectToCompositor(const QString &socketName = QString());
+    bool connectToCompositor(const QString &socketName, const ConnectOptions &options);
     void disconnectFromCompositor();
     bool isConnected() const;
+    // 异步连接已发起、协议尚未就绪
+    bool isConnecting() const;
 
     // Diagnostics / observability
     quint64 totalEventCount() const;
@@ -50,6 +71,7 @@ public:
 
     // Global vibration control (convenience methods)
     void setVibration(int deviceId, double weakMagnitude, double strongMagnitude, int durationMs = 0);
+    bool playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern);
     void stopVibration(int deviceId);
     void stopAllVibration();
 
@@ -59,6 +81,7 @@ public:
 
 Q_SIGNALS:
     void connectedChanged(bool connected);
+    void connectFailed(const QString &reason);
     void totalEventCountChanged(quint64 count);
     void lastDiagnosticChanged(const QString &message);
     void grantedCapabilitiesChanged(uint32_t capabilities);
@@ -75,10 +98,16 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void handleWaylandEvents();
+    void dispatchReadEvents();
 
 private:
     void setupRegistry();
     void teardownRegistry();
+    void startEventDispatch(DispatchMode mode);
+    void stopEventDispatch();
+    void failConnect(const QString &reason);
+    void handleConnectionLost(const QString &reason);
+    void flushRequests();
     void handleGamepadAdded(int deviceId, const QString &name);
     void handleGamepadRemoved(int deviceId);
 
@@ -5,6 +5,8 @@
 #include "treelandgamepadclient.h"
 #include "treelandgamepadmanager.h"
 
+#include <deckshell/deckgamepad/core/deckgamepadrumble.h>
+
 #include <wayland-util.h>
 #include "treeland-gamepad-v1-client-protocol.h"
 
@@ -24,6 +26,9 @@ struct TreelandGamepadDevice::Private
     QHash<GamepadButton, bool> buttonStates;
     QHash<GamepadAxis, double> axisValues;
     int hatDirection = deckshell::deckgamepad::GAMEPAD_HAT_CENTER;
+
+    // Vibration: 合并高频 setVibration 并在客户端展开片段，按最小间隔发送 set_vibration
+    deckshell::deckgamepad::DeckGamepadRumbleScheduler *rumble = nullptr;
     
     // Convert fixed-point to double
     static double fixedToDouble(wl_fixed_t value) {
@@ -49,6 +54,10 @@ TreelandGamepadDevice::TreelandGamepadDevice(TreelandGamepadClient *client, int
     for (int i = 0; i < deckshell::deckgamepad::GAMEPAD_AXIS_MAX; ++i) {
         d->axisValues[static_cast<GamepadAxis>(i)] = 0.0;
     }
+
+    d->rumble = new deckshell::deckgamepad::DeckGamepadRumbleScheduler(
+        [this](float weak, float strong, int durationMs) { return sendVibration(weak, strong, durationMs); },
+        this);
 }
 
 TreelandGamepadDevice::~TreelandGamepadDevice()
@@ -89,12 +98,16 @@ void TreelandGamepadDevice::setVibration(double weakMagnitude, double strongMagn
     strongMagnitude = qBound(0.0, strongMagnitude, 1.0);
     durationMs = qMax(0, durationMs);
     
-    treeland_gamepad_v1_set_vibration(
-        d->gamepad,
-        Private::doubleToFixed(weakMagnitude),
-        Private::doubleToFixed(strongMagnitude),
-        durationMs
-    );
+    d->rumble->setLevel(float(weakMagnitude), float(strongMagnitude), durationMs);
+}
+
+bool TreelandGamepadDevice::playVibrationPattern(const DeckGamepadRumblePattern &pattern)
+{
+    if (!d->gamepad) {
+        return false;
+    }
+
+    return d->rumble->play(pattern);
 }
 
 void TreelandGamepadDevice::stopVibration()
@@ -103,7 +116,36 @@ void TreelandGamepadDevice::stopVibration()
         return;
     }
     
-    treeland_gamepad_v1_stop_vibration(d->gamepad);
+    d->rumble->stop();
+}
+
+void TreelandGamepadDevice::setVibrationMinIntervalMs(int intervalMs)
+{
+    d->rumble->setMinIntervalMs(intervalMs);
+}
+
+bool TreelandGamepadDevice::sendVibration(float weakMagnitude, float strongMagnitude, int durationMs)
+{
+    if (!d->gamepad) {
+        return false;
+    }
+
+    if (weakMagnitude <= 0.0f && strongMagnitude <= 0.0f) {
+        treeland_gamepad_v1_stop_vibration(d->gamepad);
+        d->client->flushRequests();
+        return true;
+    }
+
+    // duration_ms == 0 表示持续振动，直到 stop_vibration/release（与调度器输出语义一致）。
+    treeland_gamepad_v1_set_vibration(
+        d->gamepad,
+        Private::doubleToFixed(weakMagnitude),
+        Private::doubleToFixed(strongMagnitude),
+        durationMs
+    );
+    // 调度器在定时器中输出，之后未必有 socket 活动：立即发出。
+    d->client->flushRequests();
+    return true;
 }
 
 void TreelandGamepadDevice::setAxisDeadzone(uint32_t axis, double deadzone)
@@ -118,6 +160,7 @@ void TreelandGamepadDevice::setAxisDeadzone(uint32_t axis, double deadzone)
 
     deadzone = qBound(0.0, deadzone, 1.0);
     treeland_gamepad_v1_set_axis_deadzone(d->gamepad, axis, Private::doubleToFixed(deadzone));
+    d->client->flushRequests();
 }
 
 bool TreelandGamepadDevice::isButtonPressed(GamepadButton button) const
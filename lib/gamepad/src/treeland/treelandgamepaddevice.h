@@ -31,9 +31,12 @@ public:
     QString guid() const;
     bool isConnected() const;
 
-    // Vibration control
+    // Vibration control（客户端侧合并与片段展开，按最小间隔发送 set_vibration）
     void setVibration(double weakMagnitude, double strongMagnitude, int durationMs = 0);
+    bool playVibrationPattern(const DeckGamepadRumblePattern &pattern);
     void stopVibration();
+    // 两次 set_vibration 之间的最小间隔（连接时取 ConnectOptions::vibrationMinIntervalMs）；0 为不合并。
+    void setVibrationMinIntervalMs(int intervalMs);
 
     // Global tuning (compositor-side; requires authorization)
     void setAxisDeadzone(uint32_t axis, double deadzone);
@@ -76,6 +79,7 @@ private:
     void setConnected(bool connected);
     void setGamepadHandle(struct treeland_gamepad_v1 *gamepad);
     void setGuid(const QString &guid);
+    bool sendVibration(float weakMagnitude, float strongMagnitude, int durationMs);
     void handleAxisDeadzoneApplied(uint32_t axis, double deadzone);
     void handleAxisDeadzoneFailed(uint32_t axis, uint32_t error);
 
@@ -14,7 +14,12 @@
 #  define TREELAND_GAMEPAD_EXPORT Q_DECL_IMPORT
 #endif
 
+namespace deckshell::deckgamepad {
+struct DeckGamepadRumblePattern;
+}
+
 namespace TreelandGamepad {
+using deckshell::deckgamepad::DeckGamepadRumblePattern;
 using deckshell::deckgamepad::GamepadAxis;
 using deckshell::deckgamepad::GamepadButton;
 using deckshell::deckgamepad::GamepadHatMask;
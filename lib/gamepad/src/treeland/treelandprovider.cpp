@@ -63,6 +63,21 @@ TreelandProvider::TreelandProvider(QObject *parent)
                 Q_EMIT hatEvent(deviceId, event);
             });
 
+    connect(m_client,
+            &TreelandGamepad::TreelandGamepadClient::connectFailed,
+            this,
+            [this](const QString &reason) {
+                // 仅异步连接会走到这里：start() 已返回 true，失败改由 lastErrorChanged 上报。
+                m_running = false;
+                DeckGamepadError err;
+                err.code = DeckGamepadErrorCode::BackendStartFailed;
+                err.message = reason;
+                err.context = QStringLiteral("TreelandGamepadClient::connectToCompositor");
+                err.hint = QStringLiteral("ensure running in a Wayland session and compositor provides treeland_gamepad_manager_v1");
+                err.recoverable = true;
+                setError(err);
+            });
+
     connect(m_client,
             &TreelandGamepad::TreelandGamepadClient::lastDiagnosticChanged,
             this,
@@ -127,7 +142,14 @@ bool TreelandProvider::start()
     setError(DeckGamepadError{});
     setDiagnostic(DeckGamepadDiagnostic{});
 
-    const bool ok = m_client->connectToCompositor();
+    TreelandGamepad::TreelandGamepadClient::ConnectOptions options;
+    options.async = m_config.treelandAsyncConnect;
+    options.dispatchMode = m_config.treelandReaderThread
+        ? TreelandGamepad::TreelandGamepadClient::DispatchMode::ReaderThread
+        : TreelandGamepad::TreelandGamepadClient::DispatchMode::GuiThread;
+    options.vibrationMinIntervalMs = m_config.rumbleMinIntervalMs;
+
+    const bool ok = m_client->connectToCompositor(QString(), options);
     if (!ok) {
         DeckGamepadError err;
         err.code = DeckGamepadErrorCode::BackendStartFailed;
@@ -141,7 +163,7 @@ bool TreelandProvider::start()
 
     m_running = true;
 
-    // initial availability signals
+    // initial availability signals（异步连接时此处为空，设备随 gamepadAdded 逐个发布）
     for (int id : m_client->availableGamepads()) {
         Q_EMIT deviceAvailabilityChanged(id, DeckGamepadDeviceAvailability::Available);
     }
@@ -282,6 +304,14 @@ bool TreelandProvider::startVibration(int deviceId, float weakMagnitude, float s
     return true;
 }
 
+bool TreelandProvider::playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern)
+{
+    if (!m_client || !m_client->gamepad(deviceId)) {
+        return false;
+    }
+    return m_client->playVibrationPattern(deviceId, pattern);
+}
+
 void TreelandProvider::stopVibration(int deviceId)
 {
     if (!m_client || !m_client->gamepad(deviceId)) {
@@ -290,6 +320,13 @@ void TreelandProvider::stopVibration(int deviceId)
     m_client->stopVibration(deviceId);
 }
 
+bool TreelandProvider::setFrameTap(FrameTap tap)
+{
+    // Treeland 协议按事件投递，不成帧；输入已经过合成器，无需再走内核旁路。
+    Q_UNUSED(tap);
+    return false;
+}
+
 DeckGamepadCustomMappingManager *TreelandProvider::customMappingManager() const
 {
     return nullptr;
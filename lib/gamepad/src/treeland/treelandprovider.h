@@ -46,7 +46,9 @@ public:
     void setAxisSensitivity(int deviceId, uint32_t axis, float sensitivity) override;
 
     bool startVibration(int deviceId, float weakMagnitude, float strongMagnitude, int durationMs) override;
+    bool playVibrationPattern(int deviceId, const DeckGamepadRumblePattern &pattern) override;
     void stopVibration(int deviceId) override;
+    bool setFrameTap(FrameTap tap) override;
 
     DeckGamepadCustomMappingManager *customMappingManager() const override;
     ICalibrationStore *calibrationStore() const override;
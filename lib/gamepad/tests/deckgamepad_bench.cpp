@@ -0,0 +1,991 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// deckgamepad-bench：uinput 虚拟手柄 → EvdevProvider → DeckGamepadService →（可选）QML Gamepad 的吞吐/延迟基准。
+// --replay 模式改由 ReplayProvider 回放录制日志（无需 uinput/硬件，可重复）；--record 把测量阶段的事件流录制下来。
+// 输出 JSON（schema: deckgamepad-bench/1）；/dev/uinput 不可用时输出 skipped 并以 77 退出（ctest SKIP_RETURN_CODE）。
+
+#include "uinput_test_device.h"
+
+#include <deckshell/deckgamepad/providers/evdev/evdevprovider.h>
+#include <deckshell/deckgamepad/providers/replay/replayprovider.h>
+#include <deckshell/deckgamepad/providers/replay/replayrecorder.h>
+#include <deckshell/deckgamepad/service/deckgamepadservice.h>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+
+#if defined(DECKGAMEPAD_BENCH_WITH_QML)
+#include <QtGui/QGuiApplication>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlEngine>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/input.h>
+#include <unistd.h>
+#endif
+
+using namespace deckshell::deckgamepad;
+
+namespace {
+
+constexpr int kExitSkipped = 77;
+
+// ---------------------------------------------------------------------------
+// 分配计数：glibc 下在可执行文件中插桩 malloc 族（operator new 与 Qt 容器最终都落到这里），
+// 统计所有线程的分配次数。非 glibc 平台不统计（JSON 中 allocations.supported=false）。
+// ---------------------------------------------------------------------------
+std::atomic<quint64> g_allocationCount{ 0 };
+std::atomic<bool> g_countAllocations{ false };
+
+inline void countAllocation()
+{
+    if (g_countAllocations.load(std::memory_order_relaxed)) {
+        g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    countAllocation();
+    return __libc_realloc(ptr, size);
+}
+}
+constexpr bool kAllocationCountingSupported = true;
+#else
+constexpr bool kAllocationCountingSupported = false;
+#endif
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// 延迟样本：测量前按预计事件数 reserve，测量窗口内不扩容（避免污染分配计数）。
+// ---------------------------------------------------------------------------
+class LatencyRecorder
+{
+public:
+    explicit LatencyRecorder(QString name, int resolutionUs = 1)
+        : m_name(std::move(name))
+        , m_resolutionUs(resolutionUs)
+    {
+    }
+
+    void reserve(size_t count) { m_samplesUs.reserve(count); }
+    void clear() { m_samplesUs.clear(); }
+
+    void add(qint64 us)
+    {
+        if (us < 0) {
+            return;
+        }
+        if (m_samplesUs.size() == m_samplesUs.capacity()) {
+            m_overflow++;
+            return;
+        }
+        m_samplesUs.push_back(us);
+    }
+
+    QJsonObject toJson() const
+    {
+        QJsonObject out;
+        out.insert(QStringLiteral("name"), m_name);
+        out.insert(QStringLiteral("unit"), QStringLiteral("us"));
+        out.insert(QStringLiteral("resolutionUs"), m_resolutionUs);
+        out.insert(QStringLiteral("count"), static_cast<qint64>(m_samplesUs.size()));
+        out.insert(QStringLiteral("unrecorded"), static_cast<qint64>(m_overflow));
+        if (m_samplesUs.empty()) {
+            return out;
+        }
+
+        std::vector<qint64> sorted = m_samplesUs;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double p) {
+            const size_t idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+            return sorted[std::min(idx, sorted.size() - 1)];
+        };
+
+        double sum = 0.0;
+        for (qint64 v : sorted) {
+            sum += static_cast<double>(v);
+        }
+
+        out.insert(QStringLiteral("min"), sorted.front());
+        out.insert(QStringLiteral("p50"), percentile(0.50));
+        out.insert(QStringLiteral("p90"), percentile(0.90));
+        out.insert(QStringLiteral("p99"), percentile(0.99));
+        out.insert(QStringLiteral("max"), sorted.back());
+        out.insert(QStringLiteral("mean"), sum / static_cast<double>(sorted.size()));
+
+        // log2 桶：leUs = 1, 2, 4, ... ；最后一个桶兜底。
+        QJsonArray histogram;
+        qint64 bound = 1;
+        size_t idx = 0;
+        while (idx < sorted.size()) {
+            qint64 count = 0;
+            while (idx < sorted.size() && sorted[idx] <= bound) {
+                ++count;
+                ++idx;
+            }
+            if (count > 0) {
+                histogram.append(QJsonObject{
+                    { QStringLiteral("leUs"), bound },
+                    { QStringLiteral("count"), count },
+                });
+            }
+            bound *= 2;
+        }
+        out.insert(QStringLiteral("histogram"), histogram);
+        return out;
+    }
+
+private:
+    QString m_name;
+    int m_resolutionUs = 1;
+    std::vector<qint64> m_samplesUs;
+    quint64 m_overflow = 0;
+};
+
+enum class Pattern {
+    StickSweep,
+    ButtonMash,
+    HatSpam,
+    Mixed,
+};
+
+bool parsePattern(const QString &text, Pattern *out)
+{
+    if (text == QLatin1String("sweep")) {
+        *out = Pattern::StickSweep;
+    } else if (text == QLatin1String("mash")) {
+        *out = Pattern::ButtonMash;
+    } else if (text == QLatin1String("hat")) {
+        *out = Pattern::HatSpam;
+    } else if (text == QLatin1String("mixed")) {
+        *out = Pattern::Mixed;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+struct BenchConfig {
+    int pads = 1;
+    Pattern pattern = Pattern::Mixed;
+    QString patternName = QStringLiteral("mixed");
+    int rateHz = 500; // 每个 pad 每秒的 SYN_REPORT 数
+    int durationMs = 3000;
+    int warmupMs = 500;
+    int axisCoalesceMs = 0;
+    int hatCoalesceMs = 0;
+    int qmlCoalesceMs = 16;
+    bool ringTransport = false;
+    bool qml = true;
+    QString outputPath;
+    QString recordPath;
+    QString replayPath;
+    double replaySpeed = 0.0; // 0 = 尽快
+};
+
+// 单个虚拟 pad 的脚本状态：每次 step() 写入一个报告（若干 EV_KEY/EV_ABS + SYN_REPORT）。
+class PadDriver
+{
+public:
+    explicit PadDriver(UinputTestDevice device)
+        : m_device(std::move(device))
+    {
+    }
+
+    const UinputTestDevice &device() const { return m_device; }
+
+    // 返回本次写入的输入事件数（不含 SYN）。
+    int step(Pattern pattern)
+    {
+        if (pattern == Pattern::Mixed) {
+            static constexpr std::array<Pattern, 3> kRotation = {
+                Pattern::StickSweep,
+                Pattern::ButtonMash,
+                Pattern::HatSpam,
+            };
+            pattern = kRotation[static_cast<size_t>(m_step % kRotation.size())];
+        }
+        ++m_step;
+
+        int written = 0;
+        switch (pattern) {
+        case Pattern::StickSweep:
+            written = stepSweep();
+            break;
+        case Pattern::ButtonMash:
+            written = stepMash();
+            break;
+        case Pattern::HatSpam:
+            written = stepHat();
+            break;
+        case Pattern::Mixed:
+            break;
+        }
+        (void)m_device.sync();
+        return written;
+    }
+
+private:
+#if defined(__linux__)
+    int stepSweep()
+    {
+        // 三角波扫过整个量程；Y 相位错开半周期，保证每个报告两轴都有变化。
+        static constexpr int kStep = 2048;
+        m_sweep += m_sweepDir * kStep;
+        if (m_sweep >= 32767 || m_sweep <= -32768) {
+            m_sweep = qBound(-32768, m_sweep, 32767);
+            m_sweepDir = -m_sweepDir;
+        }
+        int written = 0;
+        written += m_device.emitAbs(ABS_X, m_sweep) ? 1 : 0;
+        written += m_device.emitAbs(ABS_Y, -m_sweep - 1) ? 1 : 0;
+        return written;
+    }
+
+    int stepMash()
+    {
+        static constexpr std::array<int, 8> kKeys = {
+            BTN_SOUTH, BTN_EAST, BTN_NORTH, BTN_WEST, BTN_TL, BTN_TR, BTN_SELECT, BTN_START,
+        };
+        const int key = kKeys[static_cast<size_t>(m_mashIndex % kKeys.size())];
+        m_mashDown = !m_mashDown;
+        if (!m_mashDown) {
+            ++m_mashIndex;
+        }
+        return m_device.emitKey(key, m_mashDown ? 1 : 0) ? 1 : 0;
+    }
+
+    int stepHat()
+    {
+        static constexpr std::array<std::array<int, 2>, 9> kDirections = { {
+            { 0, -1 }, { 1, -1 }, { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, 0 },
+        } };
+        const auto &dir = kDirections[static_cast<size_t>(m_hatIndex++ % kDirections.size())];
+        int written = 0;
+        written += m_device.emitAbs(ABS_HAT0X, dir[0]) ? 1 : 0;
+        written += m_device.emitAbs(ABS_HAT0Y, dir[1]) ? 1 : 0;
+        return written;
+    }
+#else
+    int stepSweep() { return 0; }
+    int stepMash() { return 0; }
+    int stepHat() { return 0; }
+#endif
+
+    UinputTestDevice m_device;
+    quint64 m_step = 0;
+    int m_sweep = 0;
+    int m_sweepDir = 1;
+    quint64 m_mashIndex = 0;
+    bool m_mashDown = false;
+    quint64 m_hatIndex = 0;
+};
+
+qint64 monotonicUs()
+{
+    static QElapsedTimer clock = [] {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return clock.nsecsElapsed() / 1000;
+}
+
+// 事件的 time_msec 来自内核 input_event 时间戳（CLOCK_REALTIME，截断为 uint32 毫秒）。
+qint64 kernelAgeUs(uint32_t eventTimeMsec)
+{
+    const auto nowMs = static_cast<uint32_t>(QDateTime::currentMSecsSinceEpoch());
+    const auto deltaMs = static_cast<int32_t>(nowMs - eventTimeMsec);
+    return static_cast<qint64>(deltaMs) * 1000;
+}
+
+struct StageRecorders {
+    LatencyRecorder kernelToService{ QStringLiteral("kernelToService"), 1000 };
+    LatencyRecorder providerTransport{ QStringLiteral("providerTransport") };
+    LatencyRecorder serviceToQmlEvent{ QStringLiteral("serviceToQmlEvent") };
+    LatencyRecorder serviceToQmlNotify{ QStringLiteral("serviceToQmlNotify") };
+
+    void reserve(size_t count)
+    {
+        kernelToService.reserve(count);
+        providerTransport.reserve(count);
+        serviceToQmlEvent.reserve(count);
+        serviceToQmlNotify.reserve(count);
+    }
+
+    void clear()
+    {
+        kernelToService.clear();
+        providerTransport.clear();
+        serviceToQmlEvent.clear();
+        serviceToQmlNotify.clear();
+    }
+
+    QJsonObject toJson() const
+    {
+        return QJsonObject{
+            { QStringLiteral("kernelToService"), kernelToService.toJson() },
+            { QStringLiteral("providerTransport"), providerTransport.toJson() },
+            { QStringLiteral("serviceToQmlEvent"), serviceToQmlEvent.toJson() },
+            { QStringLiteral("serviceToQmlNotify"), serviceToQmlNotify.toJson() },
+        };
+    }
+};
+
+// 每设备每轴最近一次 Service 发出时刻：QML raw 事件取最近值，属性通知取首个未通知值。
+struct AxisStamp {
+    qint64 lastEmitUs = -1;
+    qint64 firstPendingUs = -1;
+};
+
+struct DeviceStamps {
+    std::array<AxisStamp, GAMEPAD_AXIS_MAX> axes{};
+};
+
+#if defined(DECKGAMEPAD_BENCH_WITH_QML)
+// QML Gamepad 以字符串连接观测（QML 插件不作为链接依赖）。
+class QmlStageProbe final : public QObject
+{
+    Q_OBJECT
+
+public:
+    QmlStageProbe(DeviceStamps *stamps, StageRecorders *recorders, QObject *parent = nullptr)
+        : QObject(parent)
+        , m_stamps(stamps)
+        , m_recorders(recorders)
+    {
+    }
+
+public Q_SLOTS:
+    void onAxisEvent(int axis, double value, int timeMs)
+    {
+        Q_UNUSED(value);
+        Q_UNUSED(timeMs);
+        if (axis < 0 || axis >= GAMEPAD_AXIS_MAX) {
+            return;
+        }
+        const AxisStamp &stamp = m_stamps->axes[static_cast<size_t>(axis)];
+        if (stamp.lastEmitUs >= 0) {
+            m_recorders->serviceToQmlEvent.add(monotonicUs() - stamp.lastEmitUs);
+        }
+    }
+
+    void onAxisChanged(int axis, double value)
+    {
+        Q_UNUSED(value);
+        if (axis < 0 || axis >= GAMEPAD_AXIS_MAX) {
+            return;
+        }
+        AxisStamp &stamp = m_stamps->axes[static_cast<size_t>(axis)];
+        if (stamp.firstPendingUs >= 0) {
+            m_recorders->serviceToQmlNotify.add(monotonicUs() - stamp.firstPendingUs);
+            stamp.firstPendingUs = -1;
+        }
+    }
+
+private:
+    DeviceStamps *m_stamps = nullptr;
+    StageRecorders *m_recorders = nullptr;
+};
+#endif
+
+struct Counters {
+    quint64 serviceAxisRaw = 0;
+    quint64 serviceAxisEmitted = 0;
+    quint64 serviceAxisDropped = 0;
+    quint64 serviceHatRaw = 0;
+    quint64 serviceHatEmitted = 0;
+    quint64 serviceHatDropped = 0;
+    quint64 serviceButtons = 0;
+
+    quint64 qmlAxisRaw = 0;
+    quint64 qmlAxisNotify = 0;
+    quint64 qmlAxisDropped = 0;
+    quint64 qmlHatRaw = 0;
+    quint64 qmlHatNotify = 0;
+    quint64 qmlHatDropped = 0;
+};
+
+QJsonObject skippedReport(const QString &reason)
+{
+    return QJsonObject{
+        { QStringLiteral("schema"), QStringLiteral("deckgamepad-bench/1") },
+        { QStringLiteral("version"), QStringLiteral(DECKGAMEPAD_BENCH_VERSION) },
+        { QStringLiteral("skipped"), true },
+        { QStringLiteral("reason"), reason },
+    };
+}
+
+bool writeReport(const QJsonObject &report, const QString &outputPath)
+{
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (outputPath.isEmpty() || outputPath == QLatin1String("-")) {
+        QFile out;
+        if (!out.open(stdout, QIODevice::WriteOnly)) {
+            return false;
+        }
+        return out.write(json) == json.size();
+    }
+
+    QFile out(outputPath);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "deckgamepad-bench: cannot write" << outputPath << out.errorString();
+        return false;
+    }
+    return out.write(json) == json.size();
+}
+
+bool uinputAvailable(QString *reason)
+{
+#if !defined(__linux__)
+    *reason = QStringLiteral("requires Linux uinput");
+    return false;
+#else
+    const int fd = ::open("/dev/uinput", O_RDWR | O_NONBLOCK);
+    if (fd < 0) {
+        *reason = QStringLiteral("missing /dev/uinput access");
+        return false;
+    }
+    (void)::close(fd);
+    return true;
+#endif
+}
+
+// 回放模式：ReplayProvider → DeckGamepadService。测量窗口为整段日志（start → replayFinished）。
+int runReplayBench(const BenchConfig &config)
+{
+    auto *provider = new ReplayProvider();
+    provider->setLogPath(config.replayPath);
+    provider->setSpeed(config.replaySpeed);
+    DeckGamepadService service(provider);
+
+    DeckGamepadRuntimeConfig cfg = service.runtimeConfig();
+    cfg.axisCoalesceIntervalMs = config.axisCoalesceMs;
+    cfg.hatCoalesceIntervalMs = config.hatCoalesceMs;
+    if (!service.setRuntimeConfig(cfg)) {
+        qCritical() << "deckgamepad-bench: invalid runtime config:" << service.lastErrorMessage();
+        return 1;
+    }
+
+    // 日志中每条输入记录至少 ~17 字节；按文件大小估算样本上限，测量窗口内不扩容。
+    StageRecorders recorders;
+    recorders.reserve(static_cast<size_t>(QFileInfo(config.replayPath).size() / 16 + 1024));
+    quint64 serviceButtons = 0;
+    QObject::connect(&service, &DeckGamepadService::buttonEvent, &service, [&](int, DeckGamepadButtonEvent) {
+        serviceButtons++;
+    });
+    QObject::connect(&service, &DeckGamepadService::axisEvent, &service, [&](int, DeckGamepadAxisEvent) {
+        const int transportUs = service.lastTransportLatencyUs();
+        if (transportUs >= 0) {
+            recorders.providerTransport.add(transportUs);
+        }
+    });
+
+    QEventLoop loop;
+    QObject::connect(provider, &ReplayProvider::replayFinished, &loop, &QEventLoop::quit);
+
+    QElapsedTimer clock;
+    g_allocationCount.store(0, std::memory_order_relaxed);
+    g_countAllocations.store(true, std::memory_order_relaxed);
+    clock.start();
+    if (!service.start()) {
+        g_countAllocations.store(false, std::memory_order_relaxed);
+        qCritical() << "deckgamepad-bench: replay failed to start:" << service.lastErrorMessage();
+        return 1;
+    }
+    if (!provider->isFinished()) {
+        loop.exec();
+    }
+    const qint64 runUs = clock.nsecsElapsed() / 1000;
+
+    const int drainMs = qMax(50, qMax(config.axisCoalesceMs, config.hatCoalesceMs) * 3);
+    QElapsedTimer drain;
+    drain.start();
+    while (drain.elapsed() < drainMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+    g_countAllocations.store(false, std::memory_order_relaxed);
+    const quint64 allocations = g_allocationCount.load(std::memory_order_relaxed);
+
+    const double seconds = static_cast<double>(runUs) / 1e6;
+    const quint64 records = provider->replayedRecordCount();
+    const quint64 serviceRaw = service.axisRawEventCount() + service.hatRawEventCount() + serviceButtons;
+    const quint64 serviceEmitted = service.axisEmittedEventCount() + service.hatEmittedEventCount() + serviceButtons;
+
+    const QJsonObject configJson{
+        { QStringLiteral("workload"), QStringLiteral("replay") },
+        { QStringLiteral("replayLog"), config.replayPath },
+        { QStringLiteral("replaySpeed"), config.replaySpeed },
+        { QStringLiteral("recordedProvider"), provider->recordedProviderName() },
+        { QStringLiteral("logDurationUs"), provider->logDurationUs() },
+        { QStringLiteral("axisCoalesceMs"), config.axisCoalesceMs },
+        { QStringLiteral("hatCoalesceMs"), config.hatCoalesceMs },
+        { QStringLiteral("qml"), false },
+        { QStringLiteral("provider"), service.activeProviderName() },
+    };
+
+    const QJsonObject throughput{
+        { QStringLiteral("measuredUs"), runUs },
+        { QStringLiteral("replayedRecords"), static_cast<qint64>(records) },
+        { QStringLiteral("replayedRecordsPerSec"), seconds > 0 ? static_cast<double>(records) / seconds : 0.0 },
+        { QStringLiteral("serviceRawEvents"), static_cast<qint64>(serviceRaw) },
+        { QStringLiteral("serviceEmittedEvents"), static_cast<qint64>(serviceEmitted) },
+        { QStringLiteral("serviceEventsPerSec"), seconds > 0 ? static_cast<double>(serviceEmitted) / seconds : 0.0 },
+    };
+
+    const QJsonObject serviceJson{
+        { QStringLiteral("axisRawEventCount"), static_cast<qint64>(service.axisRawEventCount()) },
+        { QStringLiteral("axisEmittedEventCount"), static_cast<qint64>(service.axisEmittedEventCount()) },
+        { QStringLiteral("axisDroppedEventCount"), static_cast<qint64>(service.axisDroppedEventCount()) },
+        { QStringLiteral("hatRawEventCount"), static_cast<qint64>(service.hatRawEventCount()) },
+        { QStringLiteral("hatEmittedEventCount"), static_cast<qint64>(service.hatEmittedEventCount()) },
+        { QStringLiteral("hatDroppedEventCount"), static_cast<qint64>(service.hatDroppedEventCount()) },
+        { QStringLiteral("buttonEventCount"), static_cast<qint64>(serviceButtons) },
+    };
+
+    const QJsonObject allocationsJson{
+        { QStringLiteral("supported"), kAllocationCountingSupported },
+        { QStringLiteral("total"), static_cast<qint64>(allocations) },
+        { QStringLiteral("perReplayedRecord"), records > 0 ? static_cast<double>(allocations) / static_cast<double>(records) : 0.0 },
+    };
+
+    const QJsonObject report{
+        { QStringLiteral("schema"), QStringLiteral("deckgamepad-bench/1") },
+        { QStringLiteral("version"), QStringLiteral(DECKGAMEPAD_BENCH_VERSION) },
+        { QStringLiteral("skipped"), false },
+        { QStringLiteral("timestamp"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+        { QStringLiteral("config"), configJson },
+        { QStringLiteral("throughput"), throughput },
+        { QStringLiteral("service"), serviceJson },
+        { QStringLiteral("qml"), QJsonValue::Null },
+        { QStringLiteral("allocations"), allocationsJson },
+        { QStringLiteral("latency"), recorders.toJson() },
+    };
+
+    service.stop();
+    return writeReport(report, config.outputPath) ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+#if defined(DECKGAMEPAD_BENCH_WITH_QML)
+    QGuiApplication app(argc, argv);
+#else
+    QCoreApplication app(argc, argv);
+#endif
+    QCoreApplication::setApplicationName(QStringLiteral("deckgamepad-bench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("DeckShellGamepad input throughput/latency benchmark (JSON output)"));
+    parser.addHelpOption();
+    const QCommandLineOption padsOpt(QStringLiteral("pads"), QStringLiteral("Number of virtual uinput pads."), QStringLiteral("n"), QStringLiteral("1"));
+    const QCommandLineOption patternOpt(QStringLiteral("pattern"), QStringLiteral("sweep | mash | hat | mixed."), QStringLiteral("name"), QStringLiteral("mixed"));
+    const QCommandLineOption rateOpt(QStringLiteral("rate"), QStringLiteral("Reports (SYN_REPORT) per second per pad."), QStringLiteral("hz"), QStringLiteral("500"));
+    const QCommandLineOption durationOpt(QStringLiteral("duration-ms"), QStringLiteral("Measured run length."), QStringLiteral("ms"), QStringLiteral("3000"));
+    const QCommandLineOption warmupOpt(QStringLiteral("warmup-ms"), QStringLiteral("Unmeasured warmup before the run."), QStringLiteral("ms"), QStringLiteral("500"));
+    const QCommandLineOption axisCoalesceOpt(QStringLiteral("axis-coalesce-ms"), QStringLiteral("DeckGamepadRuntimeConfig::axisCoalesceIntervalMs."), QStringLiteral("ms"), QStringLiteral("0"));
+    const QCommandLineOption hatCoalesceOpt(QStringLiteral("hat-coalesce-ms"), QStringLiteral("DeckGamepadRuntimeConfig::hatCoalesceIntervalMs."), QStringLiteral("ms"), QStringLiteral("0"));
+    const QCommandLineOption qmlCoalesceOpt(QStringLiteral("qml-coalesce-ms"), QStringLiteral("Gamepad.coalesceIntervalMs for the QML stage."), QStringLiteral("ms"), QStringLiteral("16"));
+    const QCommandLineOption ringOpt(QStringLiteral("ring"), QStringLiteral("Use the SPSC ring input transport."));
+    const QCommandLineOption noQmlOpt(QStringLiteral("no-qml"), QStringLiteral("Skip the QML Gamepad stage."));
+    const QCommandLineOption outputOpt(QStringLiteral("output"), QStringLiteral("Write JSON to file ('-' for stdout)."), QStringLiteral("path"));
+    const QCommandLineOption recordOpt(QStringLiteral("record"), QStringLiteral("Record the measured run's provider event stream to a replay log."), QStringLiteral("path"));
+    const QCommandLineOption replayOpt(QStringLiteral("replay"), QStringLiteral("Replay a recorded log instead of driving uinput pads."), QStringLiteral("path"));
+    const QCommandLineOption replaySpeedOpt(QStringLiteral("replay-speed"), QStringLiteral("Replay speed multiplier (0 = as fast as possible)."), QStringLiteral("x"), QStringLiteral("0"));
+    parser.addOptions({ padsOpt, patternOpt, rateOpt, durationOpt, warmupOpt, axisCoalesceOpt, hatCoalesceOpt,
+                        qmlCoalesceOpt, ringOpt, noQmlOpt, outputOpt, recordOpt, replayOpt, replaySpeedOpt });
+    parser.process(app);
+
+    BenchConfig config;
+    config.pads = qBound(1, parser.value(padsOpt).toInt(), 16);
+    config.patternName = parser.value(patternOpt);
+    if (!parsePattern(config.patternName, &config.pattern)) {
+        qCritical() << "deckgamepad-bench: unknown pattern" << config.patternName;
+        return 2;
+    }
+    config.rateHz = qBound(1, parser.value(rateOpt).toInt(), 20000);
+    config.durationMs = qMax(100, parser.value(durationOpt).toInt());
+    config.warmupMs = qMax(0, parser.value(warmupOpt).toInt());
+    config.axisCoalesceMs = qMax(0, parser.value(axisCoalesceOpt).toInt());
+    config.hatCoalesceMs = qMax(0, parser.value(hatCoalesceOpt).toInt());
+    config.qmlCoalesceMs = parser.value(qmlCoalesceOpt).toInt();
+    config.ringTransport = parser.isSet(ringOpt);
+    config.outputPath = parser.value(outputOpt);
+    config.recordPath = parser.value(recordOpt);
+    config.replayPath = parser.value(replayOpt);
+    config.replaySpeed = qMax(0.0, parser.value(replaySpeedOpt).toDouble());
+#if defined(DECKGAMEPAD_BENCH_WITH_QML)
+    config.qml = !parser.isSet(noQmlOpt);
+#else
+    config.qml = false;
+#endif
+
+    if (!config.replayPath.isEmpty()) {
+        return runReplayBench(config);
+    }
+
+    QString skipReason;
+    if (!uinputAvailable(&skipReason)) {
+        return writeReport(skippedReport(skipReason), config.outputPath) ? kExitSkipped : 1;
+    }
+
+    // DeckGamepadService 接管 provider 生命周期（见 test_qml_keynavigation_evdev_e2e）。
+    auto *provider = new EvdevProvider();
+    DeckGamepadService service(provider);
+
+    DeckGamepadRuntimeConfig cfg = service.runtimeConfig();
+    cfg.providerSelection = DeckGamepadProviderSelection::Evdev;
+    cfg.deviceAccessMode = DeckGamepadDeviceAccessMode::DirectOpen;
+    cfg.capturePolicy = DeckGamepadCapturePolicy::Always;
+    cfg.grabMode = DeckGamepadEvdevGrabMode::Shared;
+    cfg.enableAutoRetryOpen = false;
+    cfg.axisCoalesceIntervalMs = config.axisCoalesceMs;
+    cfg.hatCoalesceIntervalMs = config.hatCoalesceMs;
+    cfg.inputTransport = config.ringTransport ? DeckGamepadInputTransport::SpscRing
+                                              : DeckGamepadInputTransport::QueuedSignal;
+    if (!service.setRuntimeConfig(cfg) || !service.start()) {
+        return writeReport(skippedReport(QStringLiteral("DeckGamepadService failed to start: %1").arg(service.lastErrorMessage())),
+                           config.outputPath)
+            ? kExitSkipped
+            : 1;
+    }
+
+    // ---- 创建虚拟 pad 并等待 Service 发现 ----
+    const QString namePrefix = QStringLiteral("DeckGamepadBench-%1-").arg(QCoreApplication::applicationPid());
+    QHash<QString, int> deviceIdByName;
+    QObject::connect(&service, &DeckGamepadService::gamepadConnected, &service, [&](int id, const QString &name) {
+        if (name.startsWith(namePrefix)) {
+            deviceIdByName.insert(name, id);
+        }
+    });
+
+    std::vector<std::unique_ptr<PadDriver>> pads;
+    for (int i = 0; i < config.pads; ++i) {
+        UinputTestDevice device = UinputTestDevice::createGamepad(namePrefix + QString::number(i));
+        if (!device.isValid()) {
+            return writeReport(skippedReport(QStringLiteral("failed to create uinput gamepad device")), config.outputPath)
+                ? kExitSkipped
+                : 1;
+        }
+        pads.push_back(std::make_unique<PadDriver>(std::move(device)));
+    }
+
+    QElapsedTimer connectTimer;
+    connectTimer.start();
+    while (deviceIdByName.size() < config.pads && connectTimer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+    }
+    if (deviceIdByName.size() < config.pads) {
+        return writeReport(skippedReport(QStringLiteral("virtual pads not discovered (check /dev/input permissions)")),
+                           config.outputPath)
+            ? kExitSkipped
+            : 1;
+    }
+
+    std::vector<int> deviceIds;
+    for (int i = 0; i < config.pads; ++i) {
+        deviceIds.push_back(deviceIdByName.value(namePrefix + QString::number(i)));
+    }
+
+    // ---- 观测点 ----
+    StageRecorders recorders;
+    QHash<int, DeviceStamps> stampsByDevice;
+    for (int id : deviceIds) {
+        stampsByDevice.insert(id, DeviceStamps{});
+    }
+    Counters counters;
+
+    QObject::connect(&service, &DeckGamepadService::axisEvent, &service, [&](int deviceId, DeckGamepadAxisEvent event) {
+        auto it = stampsByDevice.find(deviceId);
+        if (it == stampsByDevice.end()) {
+            return;
+        }
+        recorders.kernelToService.add(kernelAgeUs(event.time_msec));
+        const int transportUs = service.lastTransportLatencyUs();
+        if (transportUs >= 0) {
+            recorders.providerTransport.add(transportUs);
+        }
+        if (event.axis < static_cast<uint32_t>(GAMEPAD_AXIS_MAX)) {
+            AxisStamp &stamp = it->axes[event.axis];
+            stamp.lastEmitUs = monotonicUs();
+            if (stamp.firstPendingUs < 0) {
+                stamp.firstPendingUs = stamp.lastEmitUs;
+            }
+        }
+    });
+    QObject::connect(&service, &DeckGamepadService::hatEvent, &service, [&](int deviceId, DeckGamepadHatEvent event) {
+        if (stampsByDevice.contains(deviceId)) {
+            recorders.kernelToService.add(kernelAgeUs(event.time_msec));
+        }
+    });
+    QObject::connect(&service, &DeckGamepadService::buttonEvent, &service, [&](int deviceId, DeckGamepadButtonEvent event) {
+        if (stampsByDevice.contains(deviceId)) {
+            counters.serviceButtons++;
+            recorders.kernelToService.add(kernelAgeUs(event.time_msec));
+        }
+    });
+
+#if defined(DECKGAMEPAD_BENCH_WITH_QML)
+    std::unique_ptr<QQmlEngine> engine;
+    QList<QPointer<QObject>> qmlGamepads;
+    if (config.qml) {
+        engine = std::make_unique<QQmlEngine>();
+#if defined(DECKGAMEPAD_QML_IMPORT_ROOT)
+        engine->addImportPath(QStringLiteral(DECKGAMEPAD_QML_IMPORT_ROOT));
+#endif
+        engine->rootContext()->setContextProperty(QStringLiteral("_deckGamepadService"), &service);
+
+        QQmlComponent component(engine.get());
+        component.setData(QByteArrayLiteral("import QtQml\nimport DeckShell.DeckGamepad 1.0\nGamepad {}\n"),
+                          QUrl(QStringLiteral("qrc:/deckgamepad_bench.qml")));
+        if (!component.isReady()) {
+            qWarning() << "deckgamepad-bench: QML stage disabled:" << component.errorString();
+            config.qml = false;
+        }
+
+        for (int i = 0; config.qml && i < config.pads; ++i) {
+            QObject *gamepad = component.create(engine->rootContext());
+            if (!gamepad) {
+                qWarning() << "deckgamepad-bench: QML stage disabled:" << component.errorString();
+                config.qml = false;
+                break;
+            }
+            gamepad->setParent(engine.get());
+            gamepad->setProperty("coalesceIntervalMs", config.qmlCoalesceMs);
+            gamepad->setProperty("deviceId", deviceIds[static_cast<size_t>(i)]);
+
+            auto *probe = new QmlStageProbe(&stampsByDevice[deviceIds[static_cast<size_t>(i)]], &recorders, gamepad);
+            QObject::connect(gamepad, SIGNAL(axisEvent(int, double, int)), probe, SLOT(onAxisEvent(int, double, int)));
+            QObject::connect(gamepad, SIGNAL(axisChanged(int, double)), probe, SLOT(onAxisChanged(int, double)));
+            qmlGamepads.append(gamepad);
+        }
+    }
+#endif
+
+    auto snapshotCounters = [&]() {
+        Counters c = counters;
+        c.serviceAxisRaw = service.axisRawEventCount();
+        c.serviceAxisEmitted = service.axisEmittedEventCount();
+        c.serviceAxisDropped = service.axisDroppedEventCount();
+        c.serviceHatRaw = service.hatRawEventCount();
+        c.serviceHatEmitted = service.hatEmittedEventCount();
+        c.serviceHatDropped = service.hatDroppedEventCount();
+#if defined(DECKGAMEPAD_BENCH_WITH_QML)
+        for (const QPointer<QObject> &gamepad : std::as_const(qmlGamepads)) {
+            if (!gamepad) {
+                continue;
+            }
+            c.qmlAxisRaw += gamepad->property("axisRawEventCount").toULongLong();
+            c.qmlAxisNotify += gamepad->property("axisNotifyCount").toULongLong();
+            c.qmlAxisDropped += gamepad->property("axisDroppedEventCount").toULongLong();
+            c.qmlHatRaw += gamepad->property("hatRawEventCount").toULongLong();
+            c.qmlHatNotify += gamepad->property("hatNotifyCount").toULongLong();
+            c.qmlHatDropped += gamepad->property("hatDroppedEventCount").toULongLong();
+        }
+#endif
+        return c;
+    };
+
+    // ---- 驱动：1ms 精确定时器按 rate 补齐应写报告数 ----
+    quint64 injectedEvents = 0;
+    quint64 injectedReports = 0;
+    auto runPhase = [&](int phaseMs) {
+        QElapsedTimer phaseClock;
+        phaseClock.start();
+        quint64 reportsDone = 0;
+        QEventLoop loop;
+        QTimer ticker;
+        ticker.setTimerType(Qt::PreciseTimer);
+        ticker.setInterval(1);
+        QObject::connect(&ticker, &QTimer::timeout, &loop, [&]() {
+            const qint64 elapsedUs = phaseClock.nsecsElapsed() / 1000;
+            const quint64 due = static_cast<quint64>(elapsedUs) * static_cast<quint64>(config.rateHz) / 1000000u;
+            while (reportsDone < due) {
+                for (const auto &pad : pads) {
+                    injectedEvents += static_cast<quint64>(pad->step(config.pattern));
+                    injectedReports++;
+                }
+                reportsDone++;
+            }
+            if (elapsedUs >= static_cast<qint64>(phaseMs) * 1000) {
+                loop.quit();
+            }
+        });
+        ticker.start();
+        loop.exec();
+        ticker.stop();
+        const qint64 injectUs = phaseClock.nsecsElapsed() / 1000;
+
+        // 排空在途事件与合并窗口。
+        const int drainMs = qMax(50, qMax(config.axisCoalesceMs, qMax(config.hatCoalesceMs, config.qmlCoalesceMs)) * 3);
+        QElapsedTimer drain;
+        drain.start();
+        while (drain.elapsed() < drainMs) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+        }
+        return injectUs;
+    };
+
+    if (config.warmupMs > 0) {
+        runPhase(config.warmupMs);
+    }
+
+    const quint64 expectedEvents = static_cast<quint64>(config.pads) * static_cast<quint64>(config.rateHz)
+        * static_cast<quint64>(config.durationMs) / 1000u * 2u + 1024u;
+    recorders.clear();
+    recorders.reserve(static_cast<size_t>(expectedEvents));
+    for (DeviceStamps &stamps : stampsByDevice) {
+        stamps = DeviceStamps{};
+    }
+
+    const Counters before = snapshotCounters();
+    injectedEvents = 0;
+    injectedReports = 0;
+
+    // 录制覆盖测量阶段（开始时已连接的虚拟 pad 写入快照）；录制本身的写入也会计入分配。
+    ReplayRecorder recorder;
+    if (!config.recordPath.isEmpty() && !recorder.start(provider, config.recordPath)) {
+        qWarning() << "deckgamepad-bench: recording disabled:" << recorder.errorString();
+    }
+
+    // 分配计数覆盖注入阶段与排空阶段（在途事件的分配也计入）；吞吐只按注入阶段计时。
+    g_allocationCount.store(0, std::memory_order_relaxed);
+    g_countAllocations.store(true, std::memory_order_relaxed);
+    const qint64 runUs = runPhase(config.durationMs);
+    g_countAllocations.store(false, std::memory_order_relaxed);
+    const quint64 allocations = g_allocationCount.load(std::memory_order_relaxed);
+
+    if (recorder.isRecording() && !recorder.stop()) {
+        qWarning() << "deckgamepad-bench:" << recorder.errorString();
+    }
+
+    const Counters after = snapshotCounters();
+    const double seconds = static_cast<double>(runUs) / 1e6;
+
+    const quint64 serviceRaw = (after.serviceAxisRaw - before.serviceAxisRaw) + (after.serviceHatRaw - before.serviceHatRaw)
+        + (after.serviceButtons - before.serviceButtons);
+    const quint64 serviceEmitted = (after.serviceAxisEmitted - before.serviceAxisEmitted)
+        + (after.serviceHatEmitted - before.serviceHatEmitted) + (after.serviceButtons - before.serviceButtons);
+
+    QJsonObject configJson{
+        { QStringLiteral("workload"), QStringLiteral("uinput") },
+        { QStringLiteral("pads"), config.pads },
+        { QStringLiteral("pattern"), config.patternName },
+        { QStringLiteral("rateHz"), config.rateHz },
+        { QStringLiteral("durationMs"), config.durationMs },
+        { QStringLiteral("warmupMs"), config.warmupMs },
+        { QStringLiteral("axisCoalesceMs"), config.axisCoalesceMs },
+        { QStringLiteral("hatCoalesceMs"), config.hatCoalesceMs },
+        { QStringLiteral("qmlCoalesceMs"), config.qmlCoalesceMs },
+        { QStringLiteral("transport"), config.ringTransport ? QStringLiteral("spscRing") : QStringLiteral("queuedSignal") },
+        { QStringLiteral("qml"), config.qml },
+        { QStringLiteral("provider"), service.activeProviderName() },
+    };
+
+    QJsonObject throughput{
+        { QStringLiteral("measuredUs"), runUs },
+        { QStringLiteral("injectedReports"), static_cast<qint64>(injectedReports) },
+        { QStringLiteral("injectedEvents"), static_cast<qint64>(injectedEvents) },
+        { QStringLiteral("injectedEventsPerSec"), seconds > 0 ? static_cast<double>(injectedEvents) / seconds : 0.0 },
+        { QStringLiteral("serviceRawEvents"), static_cast<qint64>(serviceRaw) },
+        { QStringLiteral("serviceEmittedEvents"), static_cast<qint64>(serviceEmitted) },
+        { QStringLiteral("serviceEventsPerSec"), seconds > 0 ? static_cast<double>(serviceEmitted) / seconds : 0.0 },
+    };
+
+    QJsonObject serviceJson{
+        { QStringLiteral("axisRawEventCount"), static_cast<qint64>(after.serviceAxisRaw - before.serviceAxisRaw) },
+        { QStringLiteral("axisEmittedEventCount"), static_cast<qint64>(after.serviceAxisEmitted - before.serviceAxisEmitted) },
+        { QStringLiteral("axisDroppedEventCount"), static_cast<qint64>(after.serviceAxisDropped - before.serviceAxisDropped) },
+        { QStringLiteral("hatRawEventCount"), static_cast<qint64>(after.serviceHatRaw - before.serviceHatRaw) },
+        { QStringLiteral("hatEmittedEventCount"), static_cast<qint64>(after.serviceHatEmitted - before.serviceHatEmitted) },
+        { QStringLiteral("hatDroppedEventCount"), static_cast<qint64>(after.serviceHatDropped - before.serviceHatDropped) },
+        { QStringLiteral("buttonEventCount"), static_cast<qint64>(after.serviceButtons - before.serviceButtons) },
+    };
+
+    QJsonValue qmlJson = QJsonValue::Null;
+    if (config.qml) {
+        qmlJson = QJsonObject{
+            { QStringLiteral("axisRawEventCount"), static_cast<qint64>(after.qmlAxisRaw - before.qmlAxisRaw) },
+            { QStringLiteral("axisNotifyCount"), static_cast<qint64>(after.qmlAxisNotify - before.qmlAxisNotify) },
+            { QStringLiteral("axisDroppedEventCount"), static_cast<qint64>(after.qmlAxisDropped - before.qmlAxisDropped) },
+            { QStringLiteral("hatRawEventCount"), static_cast<qint64>(after.qmlHatRaw - before.qmlHatRaw) },
+            { QStringLiteral("hatNotifyCount"), static_cast<qint64>(after.qmlHatNotify - before.qmlHatNotify) },
+            { QStringLiteral("hatDroppedEventCount"), static_cast<qint64>(after.qmlHatDropped - before.qmlHatDropped) },
+        };
+    }
+
+    QJsonObject allocationsJson{
+        { QStringLiteral("supported"), kAllocationCountingSupported },
+        { QStringLiteral("total"), static_cast<qint64>(allocations) },
+        { QStringLiteral("perInjectedEvent"), injectedEvents > 0 ? static_cast<double>(allocations) / static_cast<double>(injectedEvents) : 0.0 },
+    };
+
+    const QJsonObject report{
+        { QStringLiteral("schema"), QStringLiteral("deckgamepad-bench/1") },
+        { QStringLiteral("version"), QStringLiteral(DECKGAMEPAD_BENCH_VERSION) },
+        { QStringLiteral("skipped"), false },
+        { QStringLiteral("timestamp"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+        { QStringLiteral("config"), configJson },
+        { QStringLiteral("throughput"), throughput },
+        { QStringLiteral("service"), serviceJson },
+        { QStringLiteral("qml"), qmlJson },
+        { QStringLiteral("allocations"), allocationsJson },
+        { QStringLiteral("latency"), recorders.toJson() },
+    };
+
+#if defined(DECKGAMEPAD_BENCH_WITH_QML)
+    qmlGamepads.clear();
+    engine.reset();
+#endif
+    service.stop();
+
+    return writeReport(report, config.outputPath) ? 0 : 1;
+}
+
+#include "deckgamepad_bench.moc"
@@ -4,6 +4,7 @@
 
 #include <deckshell/deckgamepad/extras/deckgamepadactionmapper.h>
 
+#include <QtCore/QJsonObject>
 #include <QtTest/QSignalSpy>
 #include <QtTest/QTest>
 
@@ -110,6 +111,78 @@ private Q_SLOTS:
         mapper.processAxis(GAMEPAD_AXIS_LEFT_Y, 0.0, 1);
         QVERIFY(spy.count() >= 2);
     }
+
+    void builtinActionIdsMatchRegistry()
+    {
+        QCOMPARE(DeckGamepadActionRegistry::name(DECKGAMEPAD_ACTION_NAV_UP), QString::fromLatin1(DeckGamepadActionId::NavUp));
+        QCOMPARE(DeckGamepadActionRegistry::name(DECKGAMEPAD_ACTION_NAV_PAGE_PREV),
+                 QString::fromLatin1(DeckGamepadActionId::NavPagePrev));
+        QCOMPARE(DeckGamepadActionRegistry::lookup(QString::fromLatin1(DeckGamepadActionId::NavAccept)),
+                 int(DECKGAMEPAD_ACTION_NAV_ACCEPT));
+        QCOMPARE(DeckGamepadActionRegistry::lookup(QStringLiteral("test.never_interned")), int(DECKGAMEPAD_ACTION_INVALID));
+        QCOMPARE(DeckGamepadActionRegistry::intern(QString{}), int(DECKGAMEPAD_ACTION_INVALID));
+
+        const int custom = DeckGamepadActionRegistry::intern(QStringLiteral("test.custom"));
+        QVERIFY(custom >= DECKGAMEPAD_ACTION_BUILTIN_COUNT);
+        QCOMPARE(DeckGamepadActionRegistry::intern(QStringLiteral("test.custom")), custom);
+        QCOMPARE(DeckGamepadActionRegistry::name(custom), QStringLiteral("test.custom"));
+    }
+
+    void actionTriggeredIdMatchesStringSignal()
+    {
+        DeckGamepadActionMapper mapper;
+        QSignalSpy idSpy(&mapper, &DeckGamepadActionMapper::actionTriggeredId);
+        QSignalSpy eventSpy(&mapper, &DeckGamepadActionMapper::actionEvent);
+
+        mapper.processButton(GAMEPAD_BUTTON_A, true, 1);
+        QCOMPARE(idSpy.count(), 1);
+        QCOMPARE(idSpy.at(0).at(0).toInt(), int(DECKGAMEPAD_ACTION_NAV_ACCEPT));
+        QCOMPARE(idSpy.at(0).at(1).toBool(), true);
+
+        QCOMPARE(eventSpy.count(), 1);
+        const auto ev = qvariant_cast<DeckGamepadActionEvent>(eventSpy.at(0).at(0));
+        QCOMPARE(ev.actionId, QString::fromLatin1(DeckGamepadActionId::NavAccept));
+        QCOMPARE(ev.numericId, int(DECKGAMEPAD_ACTION_NAV_ACCEPT));
+    }
+
+    void profileCustomActionIsInternedOnLoad()
+    {
+        QJsonObject buttons;
+        buttons[QString::number(GAMEPAD_BUTTON_X)] = QStringLiteral("test.game.jump");
+        QJsonObject root;
+        root[QStringLiteral("button_bindings")] = buttons;
+
+        const ActionMappingProfile profile = ActionMappingProfile::fromJson(root);
+        const int jumpId = profile.buttonBindings.value(GAMEPAD_BUTTON_X).numericId;
+        QVERIFY(jumpId >= DECKGAMEPAD_ACTION_BUILTIN_COUNT);
+        QCOMPARE(DeckGamepadActionRegistry::lookup(QStringLiteral("test.game.jump")), jumpId);
+
+        DeckGamepadActionMapper mapper;
+        mapper.applyActionMappingProfile(profile);
+        QSignalSpy idSpy(&mapper, &DeckGamepadActionMapper::actionTriggeredId);
+        QSignalSpy spy(&mapper, &DeckGamepadActionMapper::actionTriggered);
+
+        mapper.processButton(GAMEPAD_BUTTON_X, true, 1);
+        QCOMPARE(idSpy.count(), 1);
+        QCOMPARE(idSpy.at(0).at(0).toInt(), jumpId);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toString(), QStringLiteral("test.game.jump"));
+    }
+
+    void editedBindingIsReResolved()
+    {
+        // 手工改写 actionId 后 numericId 过期：mapper 应以 actionId 为准重新 intern。
+        ActionMappingProfile profile = ActionMappingProfile::createNavigationPreset();
+        profile.buttonBindings[GAMEPAD_BUTTON_A].actionId = QStringLiteral("test.edited");
+
+        DeckGamepadActionMapper mapper;
+        mapper.applyActionMappingProfile(profile);
+        QSignalSpy spy(&mapper, &DeckGamepadActionMapper::actionTriggered);
+
+        mapper.processButton(GAMEPAD_BUTTON_A, true, 1);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toString(), QStringLiteral("test.edited"));
+    }
 };
 
 QTEST_MAIN(TestActionMapper)
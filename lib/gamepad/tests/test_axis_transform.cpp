@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/backend/deckgamepadaxistransform_p.h>
+
+#include <QtTest/QTest>
+
+using namespace deckshell::deckgamepad;
+
+class TestAxisTransform : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void normalizesKernelRange()
+    {
+        DeckGamepadAxisTransform transform;
+        transform.min = 0;
+        transform.max = 255;
+
+        QCOMPARE(transform.evaluate(0), -1.0);
+        QCOMPARE(transform.evaluate(255), 1.0);
+
+        transform.inverted = true;
+        QCOMPARE(transform.evaluate(0), 1.0);
+    }
+
+    void degenerateRangeYieldsZero()
+    {
+        DeckGamepadAxisTransform transform;
+        transform.min = 5;
+        transform.max = 5;
+        transform.buildLut();
+
+        QVERIFY(transform.lut.empty());
+        QCOMPARE(transform.apply(5), 0.0);
+    }
+
+    void lutMatchesStepwiseEvaluation()
+    {
+        DeckGamepadAxisTransform transform;
+        transform.min = -512;
+        transform.max = 511;
+        transform.inverted = true;
+        transform.hasCalibration = true;
+        transform.calibration.mode = AxisCalibrationMode::CenterMinMax;
+        transform.calibration.min = -0.9f;
+        transform.calibration.max = 0.8f;
+        transform.calibration.centerOffset = 0.05f;
+        transform.flatThreshold = 0.01;
+        transform.hasDeadzone = true;
+        transform.deadzone = 0.1f;
+        transform.hasSensitivity = true;
+        transform.sensitivity = 1.5f;
+        transform.buildLut();
+
+        QCOMPARE(static_cast<int>(transform.lut.size()), 1024);
+        for (int value = transform.min; value <= transform.max; ++value) {
+            QCOMPARE(transform.apply(value), transform.evaluate(value));
+        }
+    }
+
+    void wideRangeSkipsLut()
+    {
+        DeckGamepadAxisTransform transform;
+        transform.min = -32768;
+        transform.max = 32767;
+        transform.buildLut();
+
+        QVERIFY(transform.lut.empty());
+        QCOMPARE(transform.apply(-32768), -1.0);
+        QCOMPARE(transform.apply(32767), 1.0);
+    }
+
+    void outOfRangeFallsBackToEvaluate()
+    {
+        DeckGamepadAxisTransform transform;
+        transform.min = 0;
+        transform.max = 255;
+        transform.hasSensitivity = true;
+        transform.sensitivity = 2.0f;
+        transform.buildLut();
+
+        QVERIFY(!transform.lut.empty());
+        QCOMPARE(transform.apply(300), transform.evaluate(300));
+        QCOMPARE(transform.apply(-10), -1.0);
+    }
+
+    void deadzoneRescalesOutsideThreshold()
+    {
+        DeckGamepadAxisTransform transform;
+        transform.min = -100;
+        transform.max = 100;
+        transform.hasDeadzone = true;
+        transform.deadzone = 0.2f;
+        transform.buildLut();
+
+        QCOMPARE(transform.apply(0), 0.0);
+        QCOMPARE(transform.apply(20), 0.0);
+        QCOMPARE(transform.apply(100), 1.0);
+        QVERIFY(transform.apply(60) > 0.0 && transform.apply(60) < 0.6);
+    }
+};
+
+QTEST_MAIN(TestAxisTransform)
+
+#include "test_axis_transform.moc"
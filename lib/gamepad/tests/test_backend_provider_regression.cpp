@@ -4,6 +4,7 @@
 
 #include <deckshell/deckgamepad/backend/deckgamepadbackend.h>
 
+#include <QtCore/QCoreApplication>
 #include <QtCore/QFile>
 #include <QtCore/QTemporaryDir>
 #include <QtTest/QSignalSpy>
@@ -42,6 +43,13 @@ public:
 
     static void closeGamepad(DeckGamepadBackend &backend, int deviceId) { backend.closeGamepad(deviceId); }
 
+    static void scheduleOpen(DeckGamepadBackend &backend, int deviceId, const QString &devpath)
+    {
+        backend.scheduleOpen(deviceId, devpath, true);
+    }
+
+    static void waitForProbes(DeckGamepadBackend &backend) { backend.m_probePool.waitForDone(); }
+
     static void handleSessionGateActiveChanged(DeckGamepadBackend &backend, bool active)
     {
         backend.handleSessionGateActiveChanged(active);
@@ -164,6 +172,104 @@ private Q_SLOTS:
         QVERIFY(err.sysErrno != 0);
     }
 
+    void asyncOpen_publishesDeviceWhenProbeCompletes()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        const QString devpath = createFileWithPermissions(dir,
+                                                          QStringLiteral("regular-file-async"),
+                                                          QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+        QVERIFY(!devpath.isEmpty());
+
+        DeckGamepadBackend backend;
+
+        DeckGamepadRuntimeConfig cfg = backend.runtimeConfig();
+        cfg.deviceAccessMode = DeckGamepadDeviceAccessMode::DirectOpen;
+        cfg.enableAutoRetryOpen = false;
+        cfg.grabMode = DeckGamepadEvdevGrabMode::Auto;
+        cfg.probeConcurrency = 2;
+        backend.setRuntimeConfig(cfg);
+
+        DeckGamepadBackendTestHooks::addKnownDevice(backend, 6, devpath);
+
+        QSignalSpy connectedSpy(&backend, &DeckGamepadBackend::gamepadConnected);
+        QSignalSpy histogramSpy(&backend, &DeckGamepadBackend::probeHistogramChanged);
+
+        DeckGamepadBackendTestHooks::scheduleOpen(backend, 6, devpath);
+        QCOMPARE(backend.pendingProbeCount(), 1);
+        // 重复提交同一节点被合并
+        DeckGamepadBackendTestHooks::scheduleOpen(backend, 6, devpath);
+        QCOMPARE(backend.pendingProbeCount(), 1);
+
+        QTRY_COMPARE_WITH_TIMEOUT(connectedSpy.count(), 1, 2000);
+        QCOMPARE(connectedSpy.at(0).at(0).toInt(), 6);
+        QVERIFY(backend.connectedGamepads().contains(6));
+        QCOMPARE(backend.deviceAvailability(6), DeckGamepadDeviceAvailability::Available);
+        QCOMPARE(backend.pendingProbeCount(), 0);
+
+        QCOMPARE(backend.probeHistogram().samples, 1);
+        QVERIFY(histogramSpy.count() >= 1);
+        const auto histogram = qvariant_cast<DeckGamepadProbeHistogram>(histogramSpy.last().at(0));
+        QCOMPARE(histogram.samples, 1);
+    }
+
+    void asyncOpen_resultAfterStopIsDiscarded()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        const QString devpath = createFileWithPermissions(dir,
+                                                          QStringLiteral("regular-file-stale"),
+                                                          QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+        QVERIFY(!devpath.isEmpty());
+
+        DeckGamepadBackend backend;
+
+        DeckGamepadRuntimeConfig cfg = backend.runtimeConfig();
+        cfg.deviceAccessMode = DeckGamepadDeviceAccessMode::DirectOpen;
+        cfg.enableAutoRetryOpen = false;
+        cfg.grabMode = DeckGamepadEvdevGrabMode::Shared;
+        backend.setRuntimeConfig(cfg);
+
+        DeckGamepadBackendTestHooks::addKnownDevice(backend, 7, devpath);
+
+        QSignalSpy connectedSpy(&backend, &DeckGamepadBackend::gamepadConnected);
+
+        DeckGamepadBackendTestHooks::scheduleOpen(backend, 7, devpath);
+        backend.stop();
+        DeckGamepadBackendTestHooks::waitForProbes(backend);
+        QCoreApplication::processEvents();
+
+        QCOMPARE(connectedSpy.count(), 0);
+        QCOMPARE(backend.pendingProbeCount(), 0);
+        QVERIFY(!backend.connectedGamepads().contains(7));
+    }
+
+    void probeHistogram_bucketsByLatency()
+    {
+        DeckGamepadProbeHistogram histogram;
+        QVERIFY(histogram.isEmpty());
+
+        histogram.record(500);
+        histogram.record(1000);
+        histogram.record(1001);
+        histogram.record(30000);
+        histogram.record(250000);
+
+        QCOMPARE(histogram.samples, 5);
+        QCOMPARE(histogram.buckets[0], 2);
+        QCOMPARE(histogram.buckets[1], 1);
+        QCOMPARE(histogram.buckets[5], 1);
+        QCOMPARE(histogram.buckets[DeckGamepadProbeHistogram::kBucketCount - 1], 1);
+        QCOMPARE(histogram.maxUs, qint64(250000));
+        QCOMPARE(histogram.totalUs, qint64(500 + 1000 + 1001 + 30000 + 250000));
+
+        const QVariantMap map = histogram.toVariantMap();
+        QCOMPARE(map.value(QStringLiteral("samples")).toInt(), 5);
+        QCOMPARE(map.value(QStringLiteral("buckets")).toList().size(), DeckGamepadProbeHistogram::kBucketCount);
+    }
+
     void sessionGateInactive_closesDevicesAndMarksUnavailable()
     {
         DeckGamepadBackend backend;
@@ -4,8 +4,10 @@
 
 #include "testprovider.h"
 
+#include <deckshell/deckgamepad/service/deckgamepadcoalescetable_p.h>
 #include <deckshell/deckgamepad/service/deckgamepadservice.h>
 
+#include <QtCore/QElapsedTimer>
 #include <QtTest/QSignalSpy>
 #include <QtTest/QTest>
 
@@ -136,6 +138,144 @@ private Q_SLOTS:
         QCOMPARE(out1.hat, 1u);
         QCOMPARE(out1.value, static_cast<int32_t>(GAMEPAD_HAT_DOWN));
     }
+
+    void coalesceFlushOrderIsDeviceThenIndex()
+    {
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+
+        DeckGamepadRuntimeConfig cfg = service.runtimeConfig();
+        cfg.axisCoalesceIntervalMs = 20;
+        cfg.hatCoalesceIntervalMs = 20;
+        QVERIFY(service.setRuntimeConfig(cfg));
+
+        QVERIFY(service.start());
+
+        QSignalSpy axisSpy(&service, &DeckGamepadService::axisEvent);
+        QSignalSpy hatSpy(&service, &DeckGamepadService::hatEvent);
+
+        // 入队顺序刻意打乱：输出必须按 (deviceId, axis/hat) 升序。
+        provider->emitAxisEvent(3, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_TRIGGER_RIGHT, 0.5 });
+        provider->emitAxisEvent(1, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_RIGHT_X, 0.2 });
+        provider->emitAxisEvent(3, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_X, 0.3 });
+        provider->emitAxisEvent(2, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_Y, 0.4 });
+        provider->emitAxisEvent(1, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_X, 0.1 });
+        provider->emitAxisEvent(1, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_RIGHT_X, 0.25 });
+
+        provider->emitHatEvent(2, DeckGamepadHatEvent{ 0, 1, GAMEPAD_HAT_LEFT });
+        provider->emitHatEvent(1, DeckGamepadHatEvent{ 0, 0, GAMEPAD_HAT_UP });
+        provider->emitHatEvent(2, DeckGamepadHatEvent{ 0, 0, GAMEPAD_HAT_DOWN });
+
+        QTest::qWait(40);
+
+        const QList<QPair<int, uint32_t>> expectedAxes = {
+            { 1, GAMEPAD_AXIS_LEFT_X },
+            { 1, GAMEPAD_AXIS_RIGHT_X },
+            { 2, GAMEPAD_AXIS_LEFT_Y },
+            { 3, GAMEPAD_AXIS_LEFT_X },
+            { 3, GAMEPAD_AXIS_TRIGGER_RIGHT },
+        };
+        QCOMPARE(axisSpy.count(), expectedAxes.size());
+        for (int i = 0; i < expectedAxes.size(); ++i) {
+            QCOMPARE(axisSpy.at(i).at(0).toInt(), expectedAxes.at(i).first);
+            const auto out = qvariant_cast<DeckGamepadAxisEvent>(axisSpy.at(i).at(1));
+            QCOMPARE(out.axis, expectedAxes.at(i).second);
+        }
+        QCOMPARE(qvariant_cast<DeckGamepadAxisEvent>(axisSpy.at(1).at(1)).value, 0.25);
+
+        const QList<QPair<int, uint32_t>> expectedHats = {
+            { 1, 0 },
+            { 2, 0 },
+            { 2, 1 },
+        };
+        QCOMPARE(hatSpy.count(), expectedHats.size());
+        for (int i = 0; i < expectedHats.size(); ++i) {
+            QCOMPARE(hatSpy.at(i).at(0).toInt(), expectedHats.at(i).first);
+            const auto out = qvariant_cast<DeckGamepadHatEvent>(hatSpy.at(i).at(1));
+            QCOMPARE(out.hat, expectedHats.at(i).second);
+        }
+
+        QCOMPARE(service.axisRawEventCount(), quint64(6));
+        QCOMPARE(service.axisDroppedEventCount(), quint64(1));
+    }
+
+    void coalesceOutOfRangeIndexPassesThrough()
+    {
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+
+        DeckGamepadRuntimeConfig cfg = service.runtimeConfig();
+        cfg.axisCoalesceIntervalMs = 20;
+        QVERIFY(service.setRuntimeConfig(cfg));
+
+        QVERIFY(service.start());
+
+        QSignalSpy axisSpy(&service, &DeckGamepadService::axisEvent);
+        provider->emitAxisEvent(1, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_MAX + 2, 0.5 });
+        QCOMPARE(axisSpy.count(), 1);
+    }
+
+    void coalesceTableTakesInDeviceAxisOrder()
+    {
+        DeckGamepadCoalesceTable table;
+        QVERIFY(table.enqueueAxis(7, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_RIGHT_X, 0.1 }));
+        QVERIFY(table.enqueueAxis(2, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_Y, 0.2 }));
+        QVERIFY(table.enqueueAxis(7, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_X, 0.3 }));
+        QVERIFY(table.enqueueAxis(2, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_Y, 0.4 }));
+        QVERIFY(!table.enqueueAxis(2, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_MAX, 0.5 }));
+        QVERIFY(!table.enqueueHat(2, DeckGamepadHatEvent{ 0, DeckGamepadCoalesceTable::kMaxHats, GAMEPAD_HAT_UP }));
+        QCOMPARE(table.pendingAxisCount(), 3);
+
+        QList<QPair<int, uint32_t>> order;
+        QList<double> values;
+        table.takeAxes([&](int deviceId, const DeckGamepadAxisEvent &event) {
+            order.append({ deviceId, event.axis });
+            values.append(event.value);
+        });
+        QCOMPARE(order,
+                 (QList<QPair<int, uint32_t>>{ { 2, GAMEPAD_AXIS_LEFT_Y },
+                                               { 7, GAMEPAD_AXIS_LEFT_X },
+                                               { 7, GAMEPAD_AXIS_RIGHT_X } }));
+        QCOMPARE(values, (QList<double>{ 0.4, 0.3, 0.1 }));
+        QCOMPARE(table.pendingAxisCount(), 0);
+
+        int again = 0;
+        table.takeAxes([&](int, const DeckGamepadAxisEvent &) { ++again; });
+        QCOMPARE(again, 0);
+    }
+
+    void benchmarkCoalesceFlush8Devices()
+    {
+        // 一个合并窗口：8 台设备 × 全部标准轴各入队一次，随后 flush。
+        // 只对 flush（按序遍历 dirty 槽位并回调）计时，入队不计入结果。
+        constexpr int kDevices = 8;
+        constexpr int kIterations = 20000;
+
+        DeckGamepadCoalesceTable table;
+        QElapsedTimer timer;
+        qint64 flushNs = 0;
+        int flushed = 0;
+        double sum = 0.0;
+        for (int i = 0; i < kIterations; ++i) {
+            const double value = (i % 100) * 0.01;
+            for (int deviceId = 0; deviceId < kDevices; ++deviceId) {
+                for (int axis = 0; axis < GAMEPAD_AXIS_MAX; ++axis) {
+                    (void)table.enqueueAxis(deviceId, DeckGamepadAxisEvent{ 0, uint32_t(axis), value });
+                }
+            }
+
+            timer.start();
+            table.takeAxes([&](int, const DeckGamepadAxisEvent &event) {
+                sum += event.value;
+                ++flushed;
+            });
+            flushNs += timer.nsecsElapsed();
+        }
+
+        QCOMPARE(flushed, kIterations * kDevices * GAMEPAD_AXIS_MAX);
+        QVERIFY(sum >= 0.0);
+        QTest::setBenchmarkResult(qreal(flushNs) / kIterations, QTest::WalltimeNanoseconds);
+    }
 };
 
 QTEST_MAIN(TestCoalesce)
@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
+#include <QtTest/QSignalSpy>
 #include <QtTest/QTest>
 
 #include <deckshell/deckgamepad/core/deckgamepadaction.h>
@@ -205,8 +206,16 @@ QtObject {
         auto *mgr = service.customMappingManager();
         QVERIFY(mgr != nullptr);
         QTRY_VERIFY_WITH_TIMEOUT(mgr->hasCustomMapping(deviceId), 1500);
-        QVERIFY(mgr->applyMapping(deviceId));
-        QTest::qWait(50);
+        QSignalSpy transactionSpy(mgr, &DeckGamepadCustomMappingManager::transactionFinished);
+        const quint64 applyTx = mgr->applyMappingAsync(deviceId);
+        QVERIFY(applyTx != 0);
+        QTRY_VERIFY_WITH_TIMEOUT(!transactionSpy.isEmpty(), 1500);
+        {
+            const QList<QVariant> args = transactionSpy.takeFirst();
+            QCOMPARE(args.at(0).toULongLong(), applyTx);
+            QCOMPARE(args.at(1).toInt(), deviceId);
+            QVERIFY(args.at(2).toBool());
+        }
 
         resetTracking();
         QVERIFY(dev.emitKey(BTN_SOUTH, 1));
@@ -222,6 +231,23 @@ QtObject {
         QTRY_VERIFY_WITH_TIMEOUT(sink.releaseCount >= 1, 1500);
         QCOMPARE(sink.lastReleasedKey, static_cast<int>(Qt::Key_Escape));
 
+        // Bulk edit + commit: restore A/B in one transaction, BTN_SOUTH maps back to NavAccept.
+        const quint64 editTx = mgr->commitEdits(deviceId,
+                                                { DeckGamepadMappingEdit::setButton(GAMEPAD_BUTTON_A, BTN_SOUTH),
+                                                  DeckGamepadMappingEdit::setButton(GAMEPAD_BUTTON_B, BTN_EAST) });
+        QVERIFY(editTx > applyTx);
+        QTRY_VERIFY_WITH_TIMEOUT(!transactionSpy.isEmpty(), 1500);
+        QCOMPARE(transactionSpy.takeFirst().at(0).toULongLong(), editTx);
+
+        resetTracking();
+        QVERIFY(dev.emitKey(BTN_SOUTH, 1));
+        QVERIFY(dev.sync());
+        QTRY_VERIFY_WITH_TIMEOUT(sink.pressCount >= 1, 1500);
+        QCOMPARE(sink.lastPressedKey, static_cast<int>(Qt::Key_Return));
+        QVERIFY(dev.emitKey(BTN_SOUTH, 0));
+        QVERIFY(dev.sync());
+        QTRY_VERIFY_WITH_TIMEOUT(sink.releaseCount >= 1, 1500);
+
         dev = UinputTestDevice{};
         obj->deleteLater();
         QCoreApplication::processEvents();
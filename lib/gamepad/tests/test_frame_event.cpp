@@ -0,0 +1,204 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "testprovider.h"
+
+#include <deckshell/deckgamepad/core/deckgamepadaction.h>
+#include <deckshell/deckgamepad/extras/deckgamepadactionmapper.h>
+#include <deckshell/deckgamepad/service/deckgamepadservice.h>
+
+#include <QtCore/QDeadlineTimer>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+using namespace deckshell::deckgamepad;
+
+class TestFrameEvent : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void frameIsUnpackedIntoServiceSignals()
+    {
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+        QVERIFY(service.start());
+
+        QSignalSpy buttonSpy(&service, &DeckGamepadService::buttonEvent);
+        QSignalSpy axisSpy(&service, &DeckGamepadService::axisEvent);
+        QSignalSpy hatSpy(&service, &DeckGamepadService::hatEvent);
+
+        DeckGamepadFrameEvent frame;
+        frame.time_msec = 10;
+        frame.buttons.append(DeckGamepadButtonEvent{ 10, GAMEPAD_BUTTON_A, true });
+        frame.axes.append(DeckGamepadAxisEvent{ 10, GAMEPAD_AXIS_RIGHT_X, 0.5 });
+        frame.axes.append(DeckGamepadAxisEvent{ 10, GAMEPAD_AXIS_RIGHT_Y, -0.5 });
+        frame.hats.append(DeckGamepadHatEvent{ 10, 0, GAMEPAD_HAT_UP | GAMEPAD_HAT_LEFT });
+        provider->emitFrameEvent(1, frame);
+
+        QCOMPARE(buttonSpy.count(), 1);
+        QCOMPARE(axisSpy.count(), 2);
+        QCOMPARE(hatSpy.count(), 1);
+        QCOMPARE(service.totalEventCount(), quint64(4));
+        QCOMPARE(service.axisRawEventCount(), quint64(2));
+
+        const auto firstAxis = qvariant_cast<DeckGamepadAxisEvent>(axisSpy.at(0).at(1));
+        QCOMPARE(firstAxis.axis, static_cast<uint32_t>(GAMEPAD_AXIS_RIGHT_X));
+        const auto secondAxis = qvariant_cast<DeckGamepadAxisEvent>(axisSpy.at(1).at(1));
+        QCOMPARE(secondAxis.axis, static_cast<uint32_t>(GAMEPAD_AXIS_RIGHT_Y));
+    }
+
+    void diagonalFrameIsJudgedOnce()
+    {
+        // X 先到时逐事件判定会先锁定水平方向；整帧判定应按 |Y| > |X| 选择垂直方向。
+        DeckGamepadActionMapper mapper;
+
+        QStringList pressed;
+        connect(&mapper, &DeckGamepadActionMapper::actionTriggered, this, [&](const QString &actionId, bool isPressed, bool) {
+            if (isPressed) {
+                pressed.append(actionId);
+            }
+        });
+
+        QList<DeckGamepadAxisEvent> axes;
+        axes.append(DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_X, 0.6 });
+        axes.append(DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_Y, -0.9 });
+        mapper.processAxes(axes);
+
+        QCOMPARE(pressed, QStringList{ QString::fromLatin1(DeckGamepadActionId::NavUp) });
+    }
+
+    void diagonalFrameThroughServiceIsNotTorn()
+    {
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+        QVERIFY(service.start());
+
+        QStringList pressed;
+        connect(&service,
+                &DeckGamepadService::actionTriggered,
+                this,
+                [&](int deviceId, const QString &actionId, bool isPressed, bool) {
+                    if (deviceId == 1 && isPressed) {
+                        pressed.append(actionId);
+                    }
+                });
+
+        DeckGamepadFrameEvent frame;
+        frame.axes.append(DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_X, 0.6 });
+        frame.axes.append(DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_Y, -0.9 });
+        provider->emitFrameEvent(1, frame);
+
+        QCOMPARE(pressed, QStringList{ QString::fromLatin1(DeckGamepadActionId::NavUp) });
+    }
+
+    void frameAxesAreCoalescedWhenEnabled()
+    {
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+
+        DeckGamepadRuntimeConfig cfg = service.runtimeConfig();
+        cfg.axisCoalesceIntervalMs = 20;
+        QVERIFY(service.setRuntimeConfig(cfg));
+        QVERIFY(service.start());
+
+        QSignalSpy axisSpy(&service, &DeckGamepadService::axisEvent);
+
+        for (int i = 1; i <= 3; ++i) {
+            DeckGamepadFrameEvent frame;
+            frame.axes.append(DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_X, 0.1 * i });
+            frame.axes.append(DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_Y, -0.1 * i });
+            provider->emitFrameEvent(1, frame);
+        }
+
+        QTest::qWait(40);
+
+        QCOMPARE(axisSpy.count(), 2);
+        QCOMPARE(service.axisRawEventCount(), quint64(6));
+        QCOMPARE(service.axisDroppedEventCount(), quint64(4));
+    }
+
+    void coalescedDiagonalIsNotTorn()
+    {
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+
+        DeckGamepadRuntimeConfig cfg = service.runtimeConfig();
+        cfg.axisCoalesceIntervalMs = 10;
+        QVERIFY(service.setRuntimeConfig(cfg));
+        QVERIFY(service.start());
+
+        QList<QPair<int, QString>> pressed;
+        connect(&service,
+                &DeckGamepadService::actionTriggered,
+                this,
+                [&](int deviceId, const QString &actionId, bool isPressed, bool) {
+                    if (isPressed) {
+                        pressed.append({ deviceId, actionId });
+                    }
+                });
+
+        // 定时合并路径：同一设备的 X/Y 在一次 flush 内统一判定，多设备互不影响。
+        provider->emitAxisEvent(1, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_X, 0.6 });
+        provider->emitAxisEvent(1, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_Y, -0.9 });
+        provider->emitAxisEvent(2, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_X, -0.9 });
+        provider->emitAxisEvent(2, DeckGamepadAxisEvent{ 0, GAMEPAD_AXIS_LEFT_Y, 0.6 });
+        QVERIFY(pressed.isEmpty());
+
+        QTRY_COMPARE_WITH_TIMEOUT(pressed.size(), 2, 500);
+        QCOMPARE(pressed.at(0), qMakePair(1, QString::fromLatin1(DeckGamepadActionId::NavUp)));
+        QCOMPARE(pressed.at(1), qMakePair(2, QString::fromLatin1(DeckGamepadActionId::NavLeft)));
+    }
+
+    void transportLatencyIsReported()
+    {
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+        QVERIFY(service.start());
+        QCOMPARE(service.lastTransportLatencyUs(), -1);
+        QCOMPARE(service.maxTransportLatencyUs(), -1);
+
+        DeckGamepadFrameEvent frame;
+        frame.monotonicNs = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs() - 5 * 1000 * 1000;
+        frame.buttons.append(DeckGamepadButtonEvent{ 0, GAMEPAD_BUTTON_A, true });
+        provider->emitFrameEvent(1, frame);
+
+        QVERIFY(service.lastTransportLatencyUs() >= 5000);
+        QVERIFY(service.lastCoalesceLatencyMs() >= 5);
+        QCOMPARE(service.maxTransportLatencyUs(), service.lastTransportLatencyUs());
+        const int slowestUs = service.maxTransportLatencyUs();
+
+        // 亚毫秒投递延迟：毫秒值向上取整而不是归零；最大值保留较慢的样本。
+        DeckGamepadFrameEvent fastFrame;
+        fastFrame.monotonicNs = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+        fastFrame.buttons.append(DeckGamepadButtonEvent{ 0, GAMEPAD_BUTTON_A, false });
+        provider->emitFrameEvent(1, fastFrame);
+        QVERIFY(service.lastTransportLatencyUs() < slowestUs);
+        if (service.lastTransportLatencyUs() > 0) {
+            QVERIFY(service.lastCoalesceLatencyMs() >= 1);
+        }
+        QCOMPARE(service.maxTransportLatencyUs(), slowestUs);
+        provider->emitFrameEvent(1, frame);
+
+        // 其他设备移除不影响；上报该延迟的设备移除后不再报告旧值。
+        provider->addConnectedGamepad(1);
+        provider->addConnectedGamepad(2);
+        provider->removeConnectedGamepad(2);
+        QVERIFY(service.lastTransportLatencyUs() >= 5000);
+        provider->removeConnectedGamepad(1);
+        QCOMPARE(service.lastTransportLatencyUs(), -1);
+        QCOMPARE(service.lastCoalesceLatencyMs(), 0);
+
+        provider->emitFrameEvent(1, frame);
+        QVERIFY(service.lastTransportLatencyUs() >= 5000);
+        QVERIFY(service.maxTransportLatencyUs() >= 5000);
+        service.stop();
+        QCOMPARE(service.lastTransportLatencyUs(), -1);
+        QCOMPARE(service.maxTransportLatencyUs(), -1);
+    }
+};
+
+QTEST_MAIN(TestFrameEvent)
+
+#include "test_frame_event.moc"
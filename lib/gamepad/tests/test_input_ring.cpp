@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/core/deckgamepadspscring.h>
+#include <deckshell/deckgamepad/providers/evdev/evdevinputring.h>
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <atomic>
+#include <thread>
+
+using namespace deckshell::deckgamepad;
+
+static DeckGamepadFrameEvent makeAxisFrame(uint32_t timeMsec, double value)
+{
+    DeckGamepadFrameEvent frame;
+    frame.time_msec = timeMsec;
+    frame.monotonicNs = 1000 + timeMsec;
+    frame.axes.append(DeckGamepadAxisEvent{ timeMsec, GAMEPAD_AXIS_LEFT_X, value });
+    return frame;
+}
+
+class TestInputRing : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void stagedRecordsAreInvisibleUntilCommit()
+    {
+        DeckGamepadSpscRing<int, 8> ring;
+        QCOMPARE(ring.writableCount(), size_t(8));
+
+        ring.stage(1);
+        ring.stage(2);
+        QVERIFY(ring.isEmpty());
+
+        ring.commit();
+        QVERIFY(!ring.isEmpty());
+        QCOMPARE(ring.writableCount(), size_t(6));
+
+        QList<int> seen;
+        QCOMPARE(ring.drain([&](int v) { seen.append(v); }), size_t(2));
+        QCOMPARE(seen, (QList<int>{ 1, 2 }));
+        QCOMPARE(ring.writableCount(), size_t(8));
+
+        ring.stage(3);
+        ring.discardStaged();
+        ring.commit();
+        QVERIFY(ring.isEmpty());
+    }
+
+    void frameRoundTripsThroughRing()
+    {
+        EvdevInputRing ring;
+        if (!ring.isValid()) {
+            QSKIP("eventfd not available");
+        }
+
+        QSignalSpy spy(&ring, &EvdevInputRing::frameEvent);
+
+        DeckGamepadFrameEvent frame;
+        frame.time_msec = 42;
+        frame.monotonicNs = 123456;
+        frame.buttons.append(DeckGamepadButtonEvent{ 42, GAMEPAD_BUTTON_A, true });
+        frame.axes.append(DeckGamepadAxisEvent{ 42, GAMEPAD_AXIS_RIGHT_Y, -0.25 });
+        frame.hats.append(DeckGamepadHatEvent{ 42, 0, GAMEPAD_HAT_DOWN });
+
+        bool pushed = false;
+        std::thread producer([&ring, &pushed, frame] { pushed = ring.pushFrame(3, frame); });
+        producer.join();
+        QVERIFY(pushed);
+
+        QVERIFY(spy.wait(1000));
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toInt(), 3);
+
+        const auto out = qvariant_cast<DeckGamepadFrameEvent>(spy.at(0).at(1));
+        QCOMPARE(out.time_msec, uint32_t(42));
+        QCOMPARE(out.monotonicNs, qint64(123456));
+        QCOMPARE(out.buttons.size(), 1);
+        QCOMPARE(out.buttons.at(0).button, static_cast<uint32_t>(GAMEPAD_BUTTON_A));
+        QVERIFY(out.buttons.at(0).pressed);
+        QCOMPARE(out.axes.size(), 1);
+        QCOMPARE(out.axes.at(0).value, -0.25);
+        QCOMPARE(out.hats.size(), 1);
+        QCOMPARE(out.hats.at(0).value, int32_t(GAMEPAD_HAT_DOWN));
+    }
+
+    void burstIsDeliveredInOrderPerDevice()
+    {
+        EvdevInputRing ring;
+        if (!ring.isValid()) {
+            QSKIP("eventfd not available");
+        }
+
+        // 4 台设备 × 200 帧：一次排空内每设备保持提交顺序。
+        QHash<int, QList<uint32_t>> timesByDevice;
+        connect(&ring, &EvdevInputRing::frameEvent, this, [&](int deviceId, DeckGamepadFrameEvent frame) {
+            timesByDevice[deviceId].append(frame.time_msec);
+        });
+
+        std::thread producer([&ring] {
+            for (uint32_t t = 1; t <= 200; ++t) {
+                for (int deviceId = 0; deviceId < 4; ++deviceId) {
+                    (void)ring.pushFrame(deviceId, makeAxisFrame(t, 0.001 * t));
+                }
+            }
+        });
+        producer.join();
+
+        QTRY_COMPARE_WITH_TIMEOUT(timesByDevice.value(3).size(), 200, 1000);
+        for (int deviceId = 0; deviceId < 4; ++deviceId) {
+            const QList<uint32_t> times = timesByDevice.value(deviceId);
+            QCOMPARE(times.size(), 200);
+            for (int i = 0; i < times.size(); ++i) {
+                QCOMPARE(times.at(i), uint32_t(i + 1));
+            }
+        }
+        QCOMPARE(ring.droppedFrameCount(), quint64(0));
+    }
+
+    void overflowCoalescesAxesAndKeepsTransitions()
+    {
+        EvdevInputRing ring;
+        if (!ring.isValid()) {
+            QSKIP("eventfd not available");
+        }
+
+        // 单轴帧占 2 条记录：未排空时最多容纳 kRecordsPerDevice / 2 帧，之后的帧并入溢出帧。
+        const int capacityFrames = int(EvdevInputRing::kRecordsPerDevice / 2);
+        uint32_t t = 0;
+        for (int i = 0; i < capacityFrames; ++i) {
+            QVERIFY(ring.pushFrame(0, makeAxisFrame(++t, 0.5)));
+        }
+
+        DeckGamepadFrameEvent press = makeAxisFrame(++t, 0.6);
+        press.buttons.append(DeckGamepadButtonEvent{ t, GAMEPAD_BUTTON_A, true });
+        QVERIFY(ring.pushFrame(0, press));
+        for (int i = 0; i < 8; ++i) {
+            QVERIFY(ring.pushFrame(0, makeAxisFrame(++t, 0.7)));
+        }
+        DeckGamepadFrameEvent release = makeAxisFrame(++t, 0.8);
+        release.buttons.append(DeckGamepadButtonEvent{ t, GAMEPAD_BUTTON_A, false });
+        release.hats.append(DeckGamepadHatEvent{ t, 0, GAMEPAD_HAT_UP });
+        QVERIFY(ring.pushFrame(0, release));
+
+        QCOMPARE(ring.droppedFrameCount(), quint64(0));
+        QCOMPARE(ring.coalescedFrameCount(), quint64(9));
+
+        QSignalSpy spy(&ring, &EvdevInputRing::frameEvent);
+        QCOMPARE(ring.drain(), capacityFrames + 1);
+        QCOMPARE(spy.count(), capacityFrames + 1);
+
+        // ring 中的帧先于溢出帧按序送达。
+        for (int i = 0; i < capacityFrames; ++i) {
+            QCOMPARE(qvariant_cast<DeckGamepadFrameEvent>(spy.at(i).at(1)).time_msec, uint32_t(i + 1));
+        }
+
+        const auto merged = qvariant_cast<DeckGamepadFrameEvent>(spy.at(capacityFrames).at(1));
+        QCOMPARE(merged.time_msec, t);
+        QCOMPARE(merged.buttons.size(), 2);
+        QVERIFY(merged.buttons.at(0).pressed);
+        QVERIFY(!merged.buttons.at(1).pressed);
+        QCOMPARE(merged.hats.size(), 1);
+        QCOMPARE(merged.hats.at(0).value, int32_t(GAMEPAD_HAT_UP));
+        QCOMPARE(merged.axes.size(), 1);
+        QCOMPARE(merged.axes.at(0).value, 0.8);
+
+        // 溢出帧取走后恢复走 ring。
+        QVERIFY(ring.pushFrame(0, makeAxisFrame(++t, 0.9)));
+        QCOMPARE(ring.drain(), 1);
+        QCOMPARE(ring.coalescedFrameCount(), quint64(9));
+    }
+
+    void overflowKeepsOrderWithConcurrentProducer()
+    {
+        EvdevInputRing ring;
+        if (!ring.isValid()) {
+            QSKIP("eventfd not available");
+        }
+
+        // 生产者与消费者并发且 ring 反复写满：每次按下后紧跟释放，所有跳变都必须按序送达。
+        constexpr int kPresses = 5000;
+        QList<bool> transitions;
+        uint32_t lastTime = 0;
+        bool ordered = true;
+        connect(&ring, &EvdevInputRing::frameEvent, this, [&](int, DeckGamepadFrameEvent frame) {
+            ordered = ordered && frame.time_msec > lastTime;
+            lastTime = frame.time_msec;
+            for (const DeckGamepadButtonEvent &event : std::as_const(frame.buttons)) {
+                transitions.append(event.pressed);
+            }
+        });
+
+        std::atomic<bool> done{ false };
+        std::thread producer([&ring, &done] {
+            uint32_t t = 0;
+            for (int i = 0; i < kPresses; ++i) {
+                for (bool pressed : { true, false }) {
+                    DeckGamepadFrameEvent frame = makeAxisFrame(++t, 0.1);
+                    frame.buttons.append(DeckGamepadButtonEvent{ t, GAMEPAD_BUTTON_B, pressed });
+                    (void)ring.pushFrame(1, frame);
+                }
+            }
+            done.store(true);
+        });
+        while (!done.load()) {
+            ring.drain();
+        }
+        producer.join();
+        ring.drain();
+
+        QCOMPARE(transitions.size(), 2 * kPresses);
+        QVERIFY(ordered);
+        for (int i = 0; i < transitions.size(); ++i) {
+            QCOMPARE(transitions.at(i), i % 2 == 0);
+        }
+    }
+
+    void outOfRangeDeviceIsRejected()
+    {
+        EvdevInputRing ring;
+        QVERIFY(!ring.pushFrame(EvdevInputRing::kMaxDevices, makeAxisFrame(1, 0.1)));
+        QVERIFY(!ring.pushFrame(-1, makeAxisFrame(1, 0.1)));
+        QCOMPARE(ring.droppedFrameCount(), quint64(2));
+    }
+};
+
+QTEST_MAIN(TestInputRing)
+
+#include "test_input_ring.moc"
@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/backend/deviceaccessbroker.h>
+
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThread>
+#include <QtDBus/QDBusConnection>
+#include <QtDBus/QDBusContext>
+#include <QtDBus/QDBusMessage>
+#include <QtDBus/QDBusObjectPath>
+#include <QtDBus/QDBusUnixFileDescriptor>
+#include <QtTest/QTest>
+
+#include <atomic>
+#include <memory>
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+using namespace deckshell::deckgamepad;
+
+static const QString kSessionPath = QStringLiteral("/org/freedesktop/login1/session/_31");
+
+class FakeLogindManager : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.login1.Manager")
+
+public:
+    std::atomic<int> getSessionCalls{ 0 };
+
+public Q_SLOTS:
+    QDBusObjectPath GetSessionByPID(uint pid)
+    {
+        Q_UNUSED(pid);
+        ++getSessionCalls;
+        return QDBusObjectPath(kSessionPath);
+    }
+};
+
+class FakeLogindSession : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.login1.Session")
+
+public:
+    std::atomic<int> takeDeviceCalls{ 0 };
+    std::atomic<int> releaseDeviceCalls{ 0 };
+    std::atomic<bool> sessionGone{ false };
+    std::atomic<int> holdReplies{ 0 }; // >0：攒够 N 个 TakeDevice 请求后才统一回复
+
+public Q_SLOTS:
+    QDBusUnixFileDescriptor TakeDevice(uint major, uint minor, bool &inactive)
+    {
+        Q_UNUSED(major);
+        Q_UNUSED(minor);
+        ++takeDeviceCalls;
+        inactive = false;
+
+        if (sessionGone) {
+            sendErrorReply(QStringLiteral("org.freedesktop.login1.NoSuchSession"), QStringLiteral("No such session"));
+            return {};
+        }
+
+        if (holdReplies > 0) {
+            setDelayedReply(true);
+            m_held.append(message());
+            if (m_held.size() >= holdReplies) {
+                for (const QDBusMessage &held : std::as_const(m_held)) {
+                    connection().send(held.createReply(QVariantList{ QVariant::fromValue(nullFd()), false }));
+                }
+                m_held.clear();
+            }
+            return {};
+        }
+
+        return nullFd();
+    }
+
+    void ReleaseDevice(uint major, uint minor)
+    {
+        Q_UNUSED(major);
+        Q_UNUSED(minor);
+        ++releaseDeviceCalls;
+    }
+
+private:
+    static QDBusUnixFileDescriptor nullFd()
+    {
+        const int fd = ::open("/dev/null", O_RDWR | O_CLOEXEC);
+        QDBusUnixFileDescriptor out(fd); // 内部 dup
+        ::close(fd);
+        return out;
+    }
+
+    QList<QDBusMessage> m_held;
+};
+
+static void closeResult(DeckGamepadDeviceOpenResult &r)
+{
+    if (r.releaseDevice) {
+        r.releaseDevice();
+    }
+    if (r.fd >= 0) {
+        ::close(r.fd);
+    }
+}
+
+class TestLogindBroker : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QDBusConnection bus = QDBusConnection::sessionBus();
+        if (!bus.isConnected()) {
+            QSKIP("D-Bus session bus not available");
+        }
+        if (!(bus.connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing)) {
+            QSKIP("D-Bus session bus does not support fd passing");
+        }
+
+        // fake logind 使用独立连接并在独立线程处理调用：broker 的同步调用不会与之互相阻塞。
+        m_fakeBus = std::make_unique<QDBusConnection>(
+            QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("deckgamepad-fake-logind")));
+        QVERIFY(m_fakeBus->isConnected());
+        if (!m_fakeBus->registerService(QStringLiteral("org.freedesktop.login1"))) {
+            QSKIP("org.freedesktop.login1 is already owned on the session bus");
+        }
+
+        m_thread.start();
+        m_manager.moveToThread(&m_thread);
+        m_session.moveToThread(&m_thread);
+        QVERIFY(m_fakeBus->registerObject(QStringLiteral("/org/freedesktop/login1"),
+                                          &m_manager,
+                                          QDBusConnection::ExportAllSlots));
+        QVERIFY(m_fakeBus->registerObject(kSessionPath, &m_session, QDBusConnection::ExportAllSlots));
+
+        QVERIFY(m_file.open());
+    }
+
+    void cleanupTestCase()
+    {
+        if (m_fakeBus) {
+            m_fakeBus->unregisterObject(kSessionPath);
+            m_fakeBus->unregisterObject(QStringLiteral("/org/freedesktop/login1"));
+            m_fakeBus->unregisterService(QStringLiteral("org.freedesktop.login1"));
+            m_fakeBus.reset();
+            QDBusConnection::disconnectFromBus(QStringLiteral("deckgamepad-fake-logind"));
+        }
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    void init()
+    {
+        m_manager.getSessionCalls = 0;
+        m_session.takeDeviceCalls = 0;
+        m_session.releaseDeviceCalls = 0;
+        m_session.sessionGone = false;
+        m_session.holdReplies = 0;
+    }
+
+    void sessionResolvedOnceAcrossOpens()
+    {
+        DeviceAccessBroker broker(QDBusConnection::sessionBus());
+        broker.setRuntimeConfig(logindConfig());
+
+        DeckGamepadDeviceOpenResult first = broker.openDevice(m_file.fileName());
+        DeckGamepadDeviceOpenResult second = broker.openDevice(m_file.fileName());
+        QVERIFY2(first.ok(), qPrintable(first.error.message));
+        QVERIFY2(second.ok(), qPrintable(second.error.message));
+        QCOMPARE(first.method, QStringLiteral("logind"));
+        QCOMPARE(broker.sessionPath(), kSessionPath);
+
+        QCOMPARE(m_manager.getSessionCalls.load(), 1);
+        QCOMPARE(m_session.takeDeviceCalls.load(), 2);
+
+        closeResult(first);
+        closeResult(second);
+        QTRY_COMPARE(m_session.releaseDeviceCalls.load(), 2);
+    }
+
+    void injectedSessionPathSkipsLookup()
+    {
+        DeviceAccessBroker broker(QDBusConnection::sessionBus());
+        broker.setRuntimeConfig(logindConfig());
+        broker.setSessionPath(kSessionPath);
+
+        DeckGamepadDeviceOpenResult r = broker.openDevice(m_file.fileName());
+        QVERIFY2(r.ok(), qPrintable(r.error.message));
+        QCOMPARE(m_manager.getSessionCalls.load(), 0);
+        closeResult(r);
+    }
+
+    void takeDeviceRequestsArePipelined()
+    {
+        DeviceAccessBroker broker(QDBusConnection::sessionBus());
+        broker.setRuntimeConfig(logindConfig());
+        broker.setSessionPath(kSessionPath);
+
+        // fake 只有在 3 个请求都到达后才回复：逐个同步等待的实现会在这里超时。
+        m_session.holdReplies = 3;
+        QList<DeckGamepadDeviceOpenResult> results;
+        for (int i = 0; i < 3; ++i) {
+            broker.completeOpenViaLogind(m_file.fileName(), [&results](DeckGamepadDeviceOpenResult r) {
+                results.append(std::move(r));
+            });
+        }
+        QCOMPARE(broker.pendingTakeDeviceCount(), 3);
+
+        QTRY_COMPARE_WITH_TIMEOUT(results.size(), 3, 5000);
+        QCOMPARE(broker.pendingTakeDeviceCount(), 0);
+        QCOMPARE(m_session.takeDeviceCalls.load(), 3);
+        for (DeckGamepadDeviceOpenResult &r : results) {
+            QVERIFY2(r.ok(), qPrintable(r.error.message));
+            QVERIFY(::fcntl(r.fd, F_GETFL) & O_NONBLOCK);
+            closeResult(r);
+        }
+    }
+
+    void goneSessionIsReResolved()
+    {
+        DeviceAccessBroker broker(QDBusConnection::sessionBus());
+        broker.setRuntimeConfig(logindConfig());
+        broker.setSessionPath(kSessionPath);
+
+        m_session.sessionGone = true;
+        DeckGamepadDeviceOpenResult failed = broker.openDevice(m_file.fileName());
+        QVERIFY(!failed.ok());
+        QVERIFY(failed.error.context.contains(QStringLiteral("NoSuchSession")));
+        QVERIFY(broker.sessionPath().isEmpty());
+
+        m_session.sessionGone = false;
+        DeckGamepadDeviceOpenResult r = broker.openDevice(m_file.fileName());
+        QVERIFY2(r.ok(), qPrintable(r.error.message));
+        QCOMPARE(m_manager.getSessionCalls.load(), 1);
+        closeResult(r);
+    }
+
+private:
+    static DeckGamepadRuntimeConfig logindConfig()
+    {
+        DeckGamepadRuntimeConfig config;
+        config.deviceAccessMode = DeckGamepadDeviceAccessMode::LogindTakeDevice;
+        return config;
+    }
+
+    std::unique_ptr<QDBusConnection> m_fakeBus;
+    QThread m_thread;
+    FakeLogindManager m_manager;
+    FakeLogindSession m_session;
+    QTemporaryFile m_file;
+};
+
+QTEST_MAIN(TestLogindBroker)
+
+#include "test_logind_broker.moc"
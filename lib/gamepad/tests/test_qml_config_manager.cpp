@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtTest/QTest>
+
+#include <deckshell/deckgamepad/service/deckgamepadservice.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QGuiApplication>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlEngine>
+
+#include <memory>
+
+#include "testprovider.h"
+
+using namespace deckshell::deckgamepad;
+
+namespace {
+
+// 设备没有 GUID 时配置按名称（空格换成 _）索引。
+QJsonObject makeConfig(double defaultDeadzone, double padTwoDeadzone, double padTwoSensitivity)
+{
+    QJsonObject global;
+    global.insert(QStringLiteral("autoAssignPlayer"), false);
+    global.insert(QStringLiteral("defaultDeadzone"), defaultDeadzone);
+    global.insert(QStringLiteral("defaultSensitivity"), 1.0);
+
+    QJsonObject padOne;
+    padOne.insert(QStringLiteral("deadzone"), QJsonObject{ { QStringLiteral("0"), 0.2 } });
+
+    QJsonObject padTwo;
+    padTwo.insert(QStringLiteral("deadzone"), QJsonObject{ { QStringLiteral("0"), padTwoDeadzone } });
+    padTwo.insert(QStringLiteral("sensitivity"), QJsonObject{ { QStringLiteral("1"), padTwoSensitivity } });
+
+    QJsonObject config;
+    config.insert(QStringLiteral("global"), global);
+    config.insert(QStringLiteral("devices"),
+                  QJsonObject{ { QStringLiteral("Pad_One"), padOne }, { QStringLiteral("Pad_Two"), padTwo } });
+    return config;
+}
+
+bool writeConfig(const QString &path, const QJsonObject &config)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(QJsonDocument(config).toJson()) > 0;
+}
+
+} // namespace
+
+class TestQmlConfigManager final : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        QVERIFY(m_configDir.isValid());
+        // GamepadConfigManager 构造时读取。
+        qputenv("DECKSHELL_GAMEPAD_CONFIG_DIR", QFile::encodeName(m_configDir.path()));
+    }
+
+    void editingOneDeviceOnlyRetunesThatDevice()
+    {
+        const QString path = m_configDir.filePath(QStringLiteral("gamepad-config.json"));
+        QVERIFY(writeConfig(path, makeConfig(0.15, 0.3, 1.0)));
+
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+        QVERIFY(service.start());
+        provider->addConnectedGamepad(1, QStringLiteral("Pad One"));
+        provider->addConnectedGamepad(2, QStringLiteral("Pad Two"));
+
+        QQmlEngine engine;
+#if defined(DECKGAMEPAD_QML_IMPORT_ROOT)
+        engine.addImportPath(QStringLiteral(DECKGAMEPAD_QML_IMPORT_ROOT));
+#endif
+        engine.rootContext()->setContextProperty(QStringLiteral("_deckGamepadService"), &service);
+
+        static const char qml[] = R"qml(
+import QtQml
+import DeckShell.DeckGamepad 1.0
+
+QtObject {
+    property QtObject config: GamepadConfigManager
+}
+)qml";
+        QQmlComponent component(&engine);
+        component.setData(qml, QUrl(QStringLiteral("qrc:/deckgamepad_config_manager.qml")));
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+        std::unique_ptr<QObject> root(component.create());
+        QVERIFY2(root, qPrintable(component.errorString()));
+        QObject *config = root->property("config").value<QObject *>();
+        QVERIFY(config);
+
+        bool ok = false;
+        QVERIFY(QMetaObject::invokeMethod(config, "loadConfig", Q_RETURN_ARG(bool, ok), Q_ARG(QString, path)));
+        QVERIFY(ok);
+
+        // 只改 Pad_Two 的 axis0 deadzone 与 axis1 sensitivity：Pad_One 不应收到任何调用，
+        // Pad_Two 只重下发变化的两个轴。
+        provider->resetAxisTuningCallCounts();
+        QVERIFY(writeConfig(path, makeConfig(0.15, 0.35, 1.5)));
+        QVERIFY(QMetaObject::invokeMethod(config, "loadConfig", Q_RETURN_ARG(bool, ok), Q_ARG(QString, path)));
+        QVERIFY(ok);
+
+        QCOMPARE(provider->axisDeadzoneCallCount(1), 0);
+        QCOMPARE(provider->axisSensitivityCallCount(1), 0);
+        QCOMPARE(provider->axisDeadzoneCallCount(2), 1);
+        QCOMPARE(provider->axisSensitivityCallCount(2), 1);
+
+        // 内容未变的重载不下发任何调用。
+        provider->resetAxisTuningCallCounts();
+        QVERIFY(QMetaObject::invokeMethod(config, "loadConfig", Q_RETURN_ARG(bool, ok), Q_ARG(QString, path)));
+        QVERIFY(ok);
+        QCOMPARE(provider->axisDeadzoneCallCount(1), 0);
+        QCOMPARE(provider->axisDeadzoneCallCount(2), 0);
+
+        // 全局默认值变化作用于两台设备未单独配置的轴（axis0 各有覆盖值，其余 5 轴跟随默认）。
+        provider->resetAxisTuningCallCounts();
+        QVERIFY(writeConfig(path, makeConfig(0.1, 0.35, 1.5)));
+        QVERIFY(QMetaObject::invokeMethod(config, "loadConfig", Q_RETURN_ARG(bool, ok), Q_ARG(QString, path)));
+        QVERIFY(ok);
+        QCOMPARE(provider->axisDeadzoneCallCount(1), 5);
+        QCOMPARE(provider->axisDeadzoneCallCount(2), 5);
+        QCOMPARE(provider->axisSensitivityCallCount(1), 0);
+        QCOMPARE(provider->axisSensitivityCallCount(2), 0);
+    }
+
+private:
+    QTemporaryDir m_configDir;
+};
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+    TestQmlConfigManager tc;
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "test_qml_config_manager.moc"
@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtTest/QTest>
+#include <QtTest/QSignalSpy>
+
+#include <deckshell/deckgamepad/service/deckgamepadservice.h>
+
+#include <QtGui/QGuiApplication>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlEngine>
+
+#include <memory>
+
+#include "testprovider.h"
+
+using namespace deckshell::deckgamepad;
+
+// GamepadManager 是进程内单例：整个用例共用一个 engine/service，避免重复注入。
+class TestQmlGamepad final : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        m_provider = new TestGamepadProvider();
+        m_service = std::make_unique<DeckGamepadService>(m_provider);
+        QVERIFY(m_service->start());
+        m_provider->addConnectedGamepad(1);
+        m_provider->addConnectedGamepad(2);
+
+        m_engine = std::make_unique<QQmlEngine>();
+#if defined(DECKGAMEPAD_QML_IMPORT_ROOT)
+        m_engine->addImportPath(QStringLiteral(DECKGAMEPAD_QML_IMPORT_ROOT));
+#endif
+        m_engine->rootContext()->setContextProperty(QStringLiteral("_deckGamepadService"), m_service.get());
+    }
+
+    void cleanupTestCase()
+    {
+        m_engine.reset();
+        m_service.reset();
+    }
+
+    void eventsAreDispatchedPerDevice()
+    {
+        std::unique_ptr<QObject> root(createRoot(R"qml(
+import QtQml
+import DeckShell.DeckGamepad 1.0
+
+QtObject {
+    property Gamepad gp1: Gamepad { deviceId: 1; coalesceIntervalMs: 0 }
+    property Gamepad gp2: Gamepad { deviceId: 2; coalesceIntervalMs: 0 }
+}
+)qml"));
+        QVERIFY(root);
+        QObject *gp1 = root->property("gp1").value<QObject *>();
+        QObject *gp2 = root->property("gp2").value<QObject *>();
+        QVERIFY(gp1 && gp2);
+
+        QSignalSpy button1(gp1, SIGNAL(buttonEvent(int,bool,int)));
+        QSignalSpy button2(gp2, SIGNAL(buttonEvent(int,bool,int)));
+        QSignalSpy axis1(gp1, SIGNAL(axisEvent(int,double,int)));
+        QSignalSpy axis2(gp2, SIGNAL(axisEvent(int,double,int)));
+
+        DeckGamepadButtonEvent button{};
+        button.time_msec = 1;
+        button.button = GAMEPAD_BUTTON_A;
+        button.pressed = true;
+        m_provider->emitButtonEvent(1, button);
+
+        DeckGamepadAxisEvent axis{};
+        axis.time_msec = 2;
+        axis.axis = GAMEPAD_AXIS_LEFT_X;
+        axis.value = 0.5;
+        m_provider->emitAxisEvent(2, axis);
+
+        QCOMPARE(button1.count(), 1);
+        QCOMPARE(button2.count(), 0);
+        QCOMPARE(axis1.count(), 0);
+        QCOMPARE(axis2.count(), 1);
+        QVERIFY(gp1->property("buttonA").toBool());
+        QVERIFY(!gp2->property("buttonA").toBool());
+        QCOMPARE(gp2->property("axisLeftX").toDouble(), 0.5);
+
+        // 切换 deviceId 后只收新设备的事件。
+        gp2->setProperty("deviceId", 1);
+        button.button = GAMEPAD_BUTTON_B;
+        m_provider->emitButtonEvent(1, button);
+        QCOMPARE(button1.count(), 2);
+        QCOMPARE(button2.count(), 1);
+    }
+
+    void notifyOnlyOnTransitions()
+    {
+        std::unique_ptr<QObject> root(createRoot(R"qml(
+import QtQml
+import DeckShell.DeckGamepad 1.0
+
+QtObject {
+    property Gamepad gp: Gamepad { deviceId: 1; coalesceIntervalMs: 0 }
+}
+)qml"));
+        QVERIFY(root);
+        QObject *gp = root->property("gp").value<QObject *>();
+        QVERIFY(gp);
+
+        QSignalSpy rawSpy(gp, SIGNAL(buttonEvent(int,bool,int)));
+        QSignalSpy notifySpy(gp, SIGNAL(buttonAChanged()));
+        QSignalSpy hatNotifySpy(gp, SIGNAL(hatDirectionChanged()));
+        QSignalSpy dpadUpSpy(gp, SIGNAL(buttonDpadUpChanged()));
+
+        DeckGamepadButtonEvent button{};
+        button.button = GAMEPAD_BUTTON_A;
+        button.pressed = true;
+        for (int i = 0; i < 3; ++i) {
+            button.time_msec = static_cast<uint32_t>(i);
+            m_provider->emitButtonEvent(1, button);
+        }
+        QCOMPARE(rawSpy.count(), 3);
+        QCOMPARE(notifySpy.count(), 1);
+
+        button.pressed = false;
+        m_provider->emitButtonEvent(1, button);
+        m_provider->emitButtonEvent(1, button);
+        QCOMPARE(rawSpy.count(), 5);
+        QCOMPARE(notifySpy.count(), 2);
+
+        DeckGamepadHatEvent hat{};
+        hat.hat = 0;
+        hat.value = GAMEPAD_HAT_UP;
+        m_provider->emitHatEvent(1, hat);
+        m_provider->emitHatEvent(1, hat);
+        QCOMPARE(hatNotifySpy.count(), 1);
+        QCOMPARE(dpadUpSpy.count(), 1);
+
+        hat.value = GAMEPAD_HAT_CENTER;
+        m_provider->emitHatEvent(1, hat);
+        QCOMPARE(hatNotifySpy.count(), 2);
+        QCOMPARE(dpadUpSpy.count(), 2);
+    }
+
+    void axisNotifiesAreCoalesced()
+    {
+        std::unique_ptr<QObject> root(createRoot(R"qml(
+import QtQml
+import DeckShell.DeckGamepad 1.0
+
+QtObject {
+    property Gamepad gp: Gamepad { deviceId: 1; coalesceIntervalMs: 10 }
+}
+)qml"));
+        QVERIFY(root);
+        QObject *gp = root->property("gp").value<QObject *>();
+        QVERIFY(gp);
+
+        QSignalSpy rawSpy(gp, SIGNAL(axisEvent(int,double,int)));
+        QSignalSpy notifySpy(gp, SIGNAL(axisLeftXChanged()));
+        QSignalSpy changedSpy(gp, SIGNAL(axisChanged(int,double)));
+
+        DeckGamepadAxisEvent axis{};
+        axis.axis = GAMEPAD_AXIS_LEFT_X;
+        for (int i = 1; i <= 5; ++i) {
+            axis.time_msec = static_cast<uint32_t>(i);
+            axis.value = 0.1 * i;
+            m_provider->emitAxisEvent(1, axis);
+        }
+
+        // raw 事件逐个到达，属性通知等到合并窗口结束（无窗口时走定时器兜底）。
+        QCOMPARE(rawSpy.count(), 5);
+        QCOMPARE(notifySpy.count(), 0);
+
+        QTRY_COMPARE_WITH_TIMEOUT(notifySpy.count(), 1, 500);
+        QCOMPARE(changedSpy.count(), 1);
+        QCOMPARE(changedSpy.at(0).at(1).toDouble(), 0.5);
+        QCOMPARE(gp->property("axisNotifyCount").toULongLong(), 1ull);
+        QCOMPARE(gp->property("axisDroppedEventCount").toULongLong(), 4ull);
+
+        QTest::qWait(30);
+        QCOMPARE(notifySpy.count(), 1);
+    }
+
+    void coalescedFlushFollowsNextAfterAnimating()
+    {
+        std::unique_ptr<QObject> root(createRoot(R"qml(
+import QtQuick
+import DeckShell.DeckGamepad 1.0
+
+Window {
+    visible: false
+    property Gamepad gp: Gamepad { deviceId: 1; coalesceIntervalMs: 1000 }
+}
+)qml"));
+        QVERIFY(root);
+        QObject *gp = root->property("gp").value<QObject *>();
+        QVERIFY(gp);
+
+        QSignalSpy notifySpy(gp, SIGNAL(axisLeftYChanged()));
+
+        DeckGamepadAxisEvent axis{};
+        axis.axis = GAMEPAD_AXIS_LEFT_Y;
+        axis.value = -0.25;
+        m_provider->emitAxisEvent(1, axis);
+        axis.value = -0.75;
+        m_provider->emitAxisEvent(1, axis);
+        QCOMPARE(notifySpy.count(), 0);
+
+        // 未出帧时不会刷新；下一次 afterAnimating 合并发出一次通知（远早于 1s 兜底定时器）。
+        QCoreApplication::processEvents();
+        QCOMPARE(notifySpy.count(), 0);
+
+        QVERIFY(QMetaObject::invokeMethod(root.get(), "afterAnimating"));
+        QCOMPARE(notifySpy.count(), 1);
+        QCOMPARE(gp->property("axisLeftY").toDouble(), -0.75);
+
+        // 挂钩只生效一次：没有新输入时后续帧不再通知。
+        QVERIFY(QMetaObject::invokeMethod(root.get(), "afterAnimating"));
+        QCOMPARE(notifySpy.count(), 1);
+
+        axis.value = 0.0;
+        m_provider->emitAxisEvent(1, axis);
+        QVERIFY(QMetaObject::invokeMethod(root.get(), "afterAnimating"));
+        QCOMPARE(notifySpy.count(), 2);
+    }
+
+private:
+    QObject *createRoot(const char *qml)
+    {
+        QQmlComponent component(m_engine.get());
+        component.setData(qml, QUrl(QStringLiteral("qrc:/deckgamepad_qml_gamepad.qml")));
+        if (!component.isReady()) {
+            qWarning() << component.errorString();
+            return nullptr;
+        }
+        QObject *obj = component.create();
+        if (!obj) {
+            qWarning() << component.errorString();
+        }
+        return obj;
+    }
+
+    TestGamepadProvider *m_provider = nullptr;
+    std::unique_ptr<DeckGamepadService> m_service;
+    std::unique_ptr<QQmlEngine> m_engine;
+};
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+    TestQmlGamepad tc;
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "test_qml_gamepad.moc"
@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "testprovider.h"
+
+#include <deckshell/deckgamepad/providers/replay/replayprovider.h>
+#include <deckshell/deckgamepad/providers/replay/replayrecorder.h>
+#include <deckshell/deckgamepad/service/deckgamepadservice.h>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+using namespace deckshell::deckgamepad;
+
+namespace {
+// 事件流的文本化表示：便于整体比较录制端与回放端的顺序与内容。
+void attachTrace(IDeckGamepadProvider *provider, QObject *context, QStringList *trace)
+{
+    QObject::connect(provider, &IDeckGamepadProvider::gamepadConnected, context, [trace](int id, const QString &name) {
+        trace->append(QStringLiteral("connected %1 %2").arg(id).arg(name));
+    });
+    QObject::connect(provider, &IDeckGamepadProvider::gamepadDisconnected, context, [trace](int id) {
+        trace->append(QStringLiteral("disconnected %1").arg(id));
+    });
+    QObject::connect(provider,
+                     &IDeckGamepadProvider::deviceAvailabilityChanged,
+                     context,
+                     [trace](int id, DeckGamepadDeviceAvailability availability) {
+                         trace->append(QStringLiteral("availability %1 %2").arg(id).arg(int(availability)));
+                     });
+    QObject::connect(provider, &IDeckGamepadProvider::deviceLastErrorChanged, context, [trace](int id, DeckGamepadError error) {
+        trace->append(QStringLiteral("deviceError %1 %2 %3").arg(id).arg(int(error.code)).arg(error.message));
+    });
+    QObject::connect(provider, &IDeckGamepadProvider::buttonEvent, context, [trace](int id, DeckGamepadButtonEvent event) {
+        trace->append(QStringLiteral("button %1 %2 %3 %4").arg(id).arg(event.time_msec).arg(event.button).arg(event.pressed));
+    });
+    QObject::connect(provider, &IDeckGamepadProvider::axisEvent, context, [trace](int id, DeckGamepadAxisEvent event) {
+        trace->append(QStringLiteral("axis %1 %2 %3 %4").arg(id).arg(event.time_msec).arg(event.axis).arg(event.value, 0, 'g', 17));
+    });
+    QObject::connect(provider, &IDeckGamepadProvider::hatEvent, context, [trace](int id, DeckGamepadHatEvent event) {
+        trace->append(QStringLiteral("hat %1 %2 %3 %4").arg(id).arg(event.time_msec).arg(event.hat).arg(event.value));
+    });
+    QObject::connect(provider, &IDeckGamepadProvider::frameEvent, context, [trace](int id, DeckGamepadFrameEvent frame) {
+        trace->append(QStringLiteral("frame %1 %2 %3/%4/%5")
+                          .arg(id)
+                          .arg(frame.time_msec)
+                          .arg(frame.buttons.size())
+                          .arg(frame.axes.size())
+                          .arg(frame.hats.size()));
+    });
+}
+
+DeckGamepadFrameEvent makeFrame()
+{
+    DeckGamepadFrameEvent frame;
+    frame.time_msec = 1200;
+    frame.monotonicNs = 1;
+    frame.buttons.append(DeckGamepadButtonEvent{ 1200, GAMEPAD_BUTTON_B, true });
+    frame.axes.append(DeckGamepadAxisEvent{ 1200, GAMEPAD_AXIS_LEFT_X, 0.25 });
+    frame.axes.append(DeckGamepadAxisEvent{ 1200, GAMEPAD_AXIS_LEFT_Y, -1.0 / 3.0 });
+    frame.hats.append(DeckGamepadHatEvent{ 1200, 0, GAMEPAD_HAT_LEFT });
+    return frame;
+}
+} // namespace
+
+class TestReplayProvider : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void replaysRecordedStreamInOrder()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath(QStringLiteral("session.dgrl"));
+
+        TestGamepadProvider live;
+        live.addConnectedGamepad(1, QStringLiteral("Pad A"));
+
+        QStringList liveTrace;
+        ReplayRecorder recorder;
+        QVERIFY2(recorder.start(&live, path), qPrintable(recorder.errorString()));
+        attachTrace(&live, this, &liveTrace);
+
+        live.addConnectedGamepad(2, QStringLiteral("Pad B"));
+        live.emitButtonEvent(1, DeckGamepadButtonEvent{ 1000, GAMEPAD_BUTTON_A, true });
+        live.emitAxisEvent(2, DeckGamepadAxisEvent{ 1001, GAMEPAD_AXIS_RIGHT_X, 0.123456789 });
+        live.emitHatEvent(1, DeckGamepadHatEvent{ 1002, 0, GAMEPAD_HAT_UP });
+        live.emitFrameEvent(2, makeFrame());
+        live.emitDeviceAvailabilityChanged(2, DeckGamepadDeviceAvailability::Unavailable);
+        DeckGamepadError error;
+        error.code = DeckGamepadErrorCode::Io;
+        error.message = QStringLiteral("read failed");
+        live.emitDeviceLastErrorChanged(2, error);
+        live.removeConnectedGamepad(2);
+        live.emitButtonEvent(1, DeckGamepadButtonEvent{ 1300, GAMEPAD_BUTTON_A, false });
+
+        QVERIFY(recorder.stop());
+        QCOMPARE(recorder.recordCount(), quint64(10)); // 1 快照 + 9 事件
+
+        ReplayProvider replay;
+        replay.setLogPath(path);
+        replay.setSpeed(0.0);
+
+        QStringList replayTrace;
+        attachTrace(&replay, this, &replayTrace);
+        bool finished = false;
+        connect(&replay, &ReplayProvider::replayFinished, this, [&finished] {
+            finished = true;
+        });
+
+        QVERIFY(replay.start());
+        QCOMPARE(replay.recordedProviderName(), QStringLiteral("TestGamepadProvider"));
+        // 快照在 start 内同步恢复。
+        QCOMPARE(replay.connectedGamepads(), QList<int>{ 1 });
+        QCOMPARE(replay.deviceName(1), QStringLiteral("Pad A"));
+        QCOMPARE(replayTrace, QStringList{ QStringLiteral("connected 1 Pad A") });
+
+        QTRY_VERIFY_WITH_TIMEOUT(finished, 2000);
+        QCOMPARE(replayTrace.mid(1), liveTrace);
+        QCOMPARE(replay.replayedRecordCount(), quint64(10));
+        QCOMPARE(replay.connectedGamepads(), QList<int>{ 1 });
+        QCOMPARE(replay.knownGamepads(), (QList<int>{ 1, 2 }));
+        QCOMPARE(replay.deviceAvailability(2), DeckGamepadDeviceAvailability::Unavailable);
+        QCOMPARE(replay.deviceLastError(2).message, QStringLiteral("read failed"));
+
+        replay.stop();
+        QVERIFY(replay.connectedGamepads().isEmpty());
+    }
+
+    void replayDrivesService()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath(QStringLiteral("service.dgrl"));
+
+        TestGamepadProvider live;
+        ReplayRecorder recorder;
+        QVERIFY(recorder.start(&live, path));
+        live.addConnectedGamepad(7, QStringLiteral("Pad C"));
+        live.emitButtonEvent(7, DeckGamepadButtonEvent{ 10, GAMEPAD_BUTTON_A, true });
+        live.emitButtonEvent(7, DeckGamepadButtonEvent{ 20, GAMEPAD_BUTTON_A, false });
+        QVERIFY(recorder.stop());
+
+        auto *replay = new ReplayProvider();
+        replay->setLogPath(path);
+        replay->setSpeed(0.0);
+        DeckGamepadService service(replay);
+
+        int connected = 0;
+        int buttons = 0;
+        connect(&service, &DeckGamepadService::gamepadConnected, this, [&connected](int id, const QString &) {
+            connected += id == 7 ? 1 : 0;
+        });
+        connect(&service, &DeckGamepadService::buttonEvent, this, [&buttons](int id, DeckGamepadButtonEvent) {
+            buttons += id == 7 ? 1 : 0;
+        });
+
+        QVERIFY(service.start());
+        QCOMPARE(service.activeProviderName(), QStringLiteral("replay"));
+        QTRY_VERIFY_WITH_TIMEOUT(replay->isFinished(), 2000);
+        QCOMPARE(connected, 1);
+        QCOMPARE(buttons, 2);
+        service.stop();
+    }
+
+    void honorsRecordedTimingAndSpeed()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath(QStringLiteral("timing.dgrl"));
+
+        TestGamepadProvider live;
+        ReplayRecorder recorder;
+        QVERIFY(recorder.start(&live, path));
+        live.emitButtonEvent(1, DeckGamepadButtonEvent{ 0, GAMEPAD_BUTTON_A, true });
+        QTest::qWait(200);
+        live.emitButtonEvent(1, DeckGamepadButtonEvent{ 200, GAMEPAD_BUTTON_A, false });
+        QVERIFY(recorder.stop());
+
+        ReplayProvider replay;
+        replay.setLogPath(path);
+        QVERIFY(replay.start());
+        QVERIFY(replay.logDurationUs() >= 200 * 1000);
+        QElapsedTimer clock;
+        clock.start();
+        QTRY_VERIFY_WITH_TIMEOUT(replay.isFinished(), 3000);
+        QVERIFY2(clock.elapsed() >= 180, qPrintable(QString::number(clock.elapsed())));
+        replay.stop();
+
+        replay.setSpeed(4.0);
+        QVERIFY(replay.start());
+        clock.restart();
+        QTRY_VERIFY_WITH_TIMEOUT(replay.isFinished(), 3000);
+        QVERIFY2(clock.elapsed() >= 40, qPrintable(QString::number(clock.elapsed())));
+        replay.stop();
+    }
+
+    void speedChangeRebasesSchedule()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath(QStringLiteral("speed.dgrl"));
+
+        TestGamepadProvider live;
+        ReplayRecorder recorder;
+        QVERIFY(recorder.start(&live, path));
+        live.emitButtonEvent(1, DeckGamepadButtonEvent{ 0, GAMEPAD_BUTTON_A, true });
+        QTest::qWait(600);
+        live.emitButtonEvent(1, DeckGamepadButtonEvent{ 600, GAMEPAD_BUTTON_A, false });
+        QVERIFY(recorder.stop());
+
+        ReplayProvider replay;
+        replay.setLogPath(path);
+        int buttons = 0;
+        connect(&replay, &IDeckGamepadProvider::buttonEvent, this, [&buttons](int, DeckGamepadButtonEvent) {
+            ++buttons;
+        });
+        QVERIFY(replay.start());
+        QTRY_COMPARE_WITH_TIMEOUT(buttons, 1, 1000);
+        QTest::qWait(100);
+        QCOMPARE(buttons, 1);
+
+        // 约 100ms 处切到 10 倍速：剩余 ~500ms 日志应在 ~50ms 内放完，而不是按原时间表等待，
+        // 也不能把已经过去的 100ms 按 10 倍折算成跳到日志末尾。
+        QElapsedTimer clock;
+        clock.start();
+        replay.setSpeed(10.0);
+        QCOMPARE(buttons, 1);
+        QTRY_VERIFY_WITH_TIMEOUT(replay.isFinished(), 3000);
+        QCOMPARE(buttons, 2);
+        QVERIFY2(clock.elapsed() >= 30, qPrintable(QString::number(clock.elapsed())));
+        QVERIFY2(clock.elapsed() < 400, qPrintable(QString::number(clock.elapsed())));
+        replay.stop();
+    }
+
+    void rejectsCorruptLogs()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        const QString garbagePath = dir.filePath(QStringLiteral("garbage.dgrl"));
+        {
+            QFile file(garbagePath);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write("not a replay log");
+        }
+        ReplayProvider replay;
+        replay.setLogPath(garbagePath);
+        QVERIFY(!replay.start());
+        QCOMPARE(replay.lastError().code, DeckGamepadErrorCode::InvalidConfig);
+
+        const QString truncatedPath = dir.filePath(QStringLiteral("truncated.dgrl"));
+        TestGamepadProvider live;
+        ReplayRecorder recorder;
+        QVERIFY(recorder.start(&live, truncatedPath));
+        live.emitFrameEvent(1, makeFrame());
+        QVERIFY(recorder.stop());
+        {
+            QFile file(truncatedPath);
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.resize(file.size() - 4));
+        }
+        replay.setLogPath(truncatedPath);
+        QVERIFY(!replay.start());
+        QCOMPARE(replay.lastError().code, DeckGamepadErrorCode::InvalidConfig);
+
+        replay.setLogPath(dir.filePath(QStringLiteral("missing.dgrl")));
+        QVERIFY(!replay.start());
+        QCOMPARE(replay.lastError().code, DeckGamepadErrorCode::Io);
+    }
+};
+
+QTEST_MAIN(TestReplayProvider)
+
+#include "test_replay_provider.moc"
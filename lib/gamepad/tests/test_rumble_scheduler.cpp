@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/core/deckgamepadrumble.h>
+
+#include <QtTest/QTest>
+
+using namespace deckshell::deckgamepad;
+
+namespace {
+struct RumbleOutput {
+    float weak = 0.0f;
+    float strong = 0.0f;
+    int durationMs = 0;
+};
+} // namespace
+
+class TestRumbleScheduler : public QObject
+{
+    Q_OBJECT
+
+private:
+    DeckGamepadRumbleScheduler::Output recorder()
+    {
+        return [this](float weak, float strong, int durationMs) {
+            m_outputs.append(RumbleOutput{ weak, strong, durationMs });
+            return true;
+        };
+    }
+
+    QList<RumbleOutput> m_outputs;
+
+private Q_SLOTS:
+    void init() { m_outputs.clear(); }
+
+    void coalescesBurstToLatestLevel()
+    {
+        DeckGamepadRumbleScheduler scheduler(recorder());
+        scheduler.setMinIntervalMs(20);
+
+        for (int i = 1; i <= 10; ++i) {
+            QVERIFY(scheduler.setLevel(i / 10.0f, 0.0f, 0));
+        }
+        // 第一次立即输出，其余在间隔内合并为一次。
+        QCOMPARE(m_outputs.size(), 1);
+        QCOMPARE(m_outputs.first().weak, 0.1f);
+        QCOMPARE(scheduler.coalescedCount(), quint64(8));
+
+        QTRY_COMPARE_WITH_TIMEOUT(m_outputs.size(), 2, 500);
+        QCOMPARE(m_outputs.last().weak, 1.0f);
+        QCOMPARE(m_outputs.last().durationMs, 0);
+        QCOMPARE(scheduler.outputCount(), quint64(2));
+    }
+
+    void skipsUnchangedLevel()
+    {
+        DeckGamepadRumbleScheduler scheduler(recorder());
+        scheduler.setMinIntervalMs(0);
+
+        QVERIFY(scheduler.setLevel(0.5f, 0.25f, 0));
+        QVERIFY(scheduler.setLevel(0.5f, 0.25f, 0));
+        QVERIFY(scheduler.setLevel(0.5f, 0.25f, 0));
+        QCOMPARE(m_outputs.size(), 1);
+
+        QVERIFY(scheduler.setLevel(0.5f, 0.5f, 0));
+        QCOMPARE(m_outputs.size(), 2);
+
+        scheduler.stop();
+        QCOMPARE(m_outputs.size(), 3);
+        QCOMPARE(m_outputs.last().weak, 0.0f);
+        QCOMPARE(m_outputs.last().strong, 0.0f);
+        QVERIFY(!scheduler.isActive());
+
+        // 已停止时再次 stop 不写设备。
+        scheduler.stop();
+        QCOMPARE(m_outputs.size(), 3);
+    }
+
+    void playsSequence()
+    {
+        DeckGamepadRumbleScheduler scheduler(recorder());
+        scheduler.setMinIntervalMs(5);
+
+        DeckGamepadRumblePattern pattern;
+        pattern.steps.append(DeckGamepadRumbleStep{ 1.0f, 0.0f, 40, false });
+        pattern.steps.append(DeckGamepadRumbleStep{ 0.0f, 1.0f, 40, false });
+        QVERIFY(scheduler.play(pattern));
+        QVERIFY(scheduler.isActive());
+
+        QTRY_VERIFY_WITH_TIMEOUT(!scheduler.isActive(), 1000);
+        QVERIFY(m_outputs.size() >= 2);
+        QCOMPARE(m_outputs.at(0).weak, 1.0f);
+        QCOMPARE(m_outputs.at(0).strong, 0.0f);
+        // 中间段带衔接余量，最后一段在片段结束时由设备侧自行停止。
+        QVERIFY(m_outputs.at(0).durationMs > 40);
+        QCOMPARE(m_outputs.at(1).weak, 0.0f);
+        QCOMPARE(m_outputs.at(1).strong, 1.0f);
+        QVERIFY(m_outputs.at(1).durationMs > 0 && m_outputs.at(1).durationMs <= 40);
+    }
+
+    void samplesEnvelope()
+    {
+        DeckGamepadRumbleScheduler scheduler(recorder());
+        scheduler.setMinIntervalMs(5);
+
+        const DeckGamepadRumblePattern pattern = DeckGamepadRumblePattern::envelope(1.0f, 0.5f, 60, 0, 0);
+        QCOMPARE(pattern.steps.size(), 1);
+        QCOMPARE(pattern.cycleDurationMs(), 60);
+        QVERIFY(scheduler.play(pattern));
+
+        QTRY_VERIFY_WITH_TIMEOUT(!scheduler.isActive(), 1000);
+        QVERIFY(m_outputs.size() >= 3);
+        for (qsizetype i = 1; i < m_outputs.size(); ++i) {
+            if (m_outputs.at(i).weak == 0.0f && m_outputs.at(i).strong == 0.0f) {
+                continue;
+            }
+            QVERIFY(m_outputs.at(i).weak >= m_outputs.at(i - 1).weak);
+            QCOMPARE(m_outputs.at(i).strong, m_outputs.at(i).weak * 0.5f);
+        }
+    }
+
+    void repeatsAndRejectsInvalidInput()
+    {
+        DeckGamepadRumbleScheduler scheduler(recorder());
+        scheduler.setMinIntervalMs(0);
+
+        QVERIFY(!scheduler.setLevel(1.5f, 0.0f, 100));
+        QVERIFY(!scheduler.setLevel(0.5f, 0.0f, -1));
+        QVERIFY(!scheduler.play(DeckGamepadRumblePattern{}));
+
+        DeckGamepadRumblePattern zeroLength;
+        zeroLength.steps.append(DeckGamepadRumbleStep{ 1.0f, 1.0f, 0, false });
+        QVERIFY(!scheduler.play(zeroLength));
+        QVERIFY(m_outputs.isEmpty());
+
+        DeckGamepadRumblePattern pulse;
+        pulse.steps.append(DeckGamepadRumbleStep{ 1.0f, 1.0f, 15, false });
+        pulse.steps.append(DeckGamepadRumbleStep{ 0.0f, 0.0f, 15, false });
+        pulse.repeatCount = 2;
+        QVERIFY(scheduler.play(pulse));
+
+        QTRY_VERIFY_WITH_TIMEOUT(!scheduler.isActive(), 1000);
+        int pulses = 0;
+        for (const RumbleOutput &out : std::as_const(m_outputs)) {
+            if (out.weak > 0.0f) {
+                ++pulses;
+            }
+        }
+        QCOMPARE(pulses, 3);
+    }
+};
+
+QTEST_MAIN(TestRumbleScheduler)
+
+#include "test_rumble_scheduler.moc"
@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/mapping/deckgamepadsdlcontrollerdb.h>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+#include <linux/input.h>
+
+using namespace deckshell::deckgamepad;
+
+namespace {
+
+const QString kPadGuid = QStringLiteral("03000000deadbeef0000000000000000");
+const QString kOtherGuid = QStringLiteral("03000000cafebabe0000000000000000");
+
+QByteArray sampleDatabase()
+{
+    return QByteArrayLiteral(
+        "# sample\n"
+        "03000000deadbeef0000000000000000,Test Pad,a:b0,b:b1,leftx:~a0,lefty:a1,"
+        "dpup:h0.1,dpdown:h0.4,lefttrigger:+a2,platform:Linux,\n"
+        "03000000cafebabe0000000000000000,Other Pad,a:b1,b:b0,platform:Linux,\n"
+        "03000000feedface0000000000000000,Windows Pad,a:b0,platform:Windows,\n");
+}
+
+bool writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(content) == content.size();
+}
+
+DeviceMapping padMapping(const DeckGamepadSdlControllerDb &db)
+{
+    QHash<int, int> physicalButtons;
+    physicalButtons.insert(BTN_SOUTH, 0);
+    physicalButtons.insert(BTN_EAST, 1);
+    QHash<int, int> physicalAxes;
+    physicalAxes.insert(ABS_X, 0);
+    physicalAxes.insert(ABS_Y, 1);
+    physicalAxes.insert(ABS_Z, 2);
+    return db.createDeviceMapping(kPadGuid, physicalButtons, physicalAxes);
+}
+
+} // namespace
+
+class TestSdlDbCache final : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QVERIFY(m_cacheHome.isValid());
+        qputenv("XDG_CACHE_HOME", m_cacheHome.path().toUtf8());
+    }
+
+    void textLoad_writesCacheUsedByNextLoad()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString source = dir.filePath(QStringLiteral("gamecontrollerdb.txt"));
+        QVERIFY(writeFile(source, sampleDatabase()));
+
+        DeckGamepadSdlControllerDb first;
+        QCOMPARE(first.loadDatabase(source), 2);
+        const QString cachePath = first.indexPath();
+        QVERIFY(!cachePath.isEmpty());
+        QVERIFY(cachePath.startsWith(m_cacheHome.path()));
+        QVERIFY(QFileInfo::exists(cachePath));
+
+        const QDateTime cacheMtime = QFileInfo(cachePath).lastModified();
+
+        DeckGamepadSdlControllerDb second;
+        QCOMPARE(second.loadDatabase(source), 2);
+        QCOMPARE(second.indexPath(), cachePath);
+        // 命中缓存时不重写 index
+        QCOMPARE(QFileInfo(cachePath).lastModified(), cacheMtime);
+
+        QVERIFY(second.hasMapping(kPadGuid.toUpper()));
+        QVERIFY(!second.hasMapping(QStringLiteral("03000000feedface0000000000000000")));
+        QCOMPARE(second.getDeviceName(kOtherGuid), QStringLiteral("Other Pad"));
+
+        const DeviceMapping a = padMapping(first);
+        const DeviceMapping b = padMapping(second);
+        QVERIFY(b.isValid());
+        QCOMPARE(b.buttonMap, a.buttonMap);
+        QCOMPARE(b.axisMap, a.axisMap);
+        QCOMPARE(b.invertedAxes, a.invertedAxes);
+        QCOMPARE(b.hatButtonMap, a.hatButtonMap);
+        QCOMPARE(b.halfAxisPosButtonMap, a.halfAxisPosButtonMap);
+        QVERIFY(b.invertedAxes.contains(ABS_X));
+        QCOMPARE(b.axisMap.value(ABS_Y), GAMEPAD_AXIS_LEFT_Y);
+    }
+
+    void modifiedSource_invalidatesCache()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString source = dir.filePath(QStringLiteral("gamecontrollerdb.txt"));
+        QVERIFY(writeFile(source, sampleDatabase()));
+
+        DeckGamepadSdlControllerDb db;
+        QCOMPARE(db.loadDatabase(source), 2);
+
+        QVERIFY(writeFile(source, sampleDatabase()
+                                      + "0300000011112222000000000000000,Short Guid Pad,a:b0,platform:Linux,\n"
+                                      + "03000000aaaabbbb0000000000000000,New Pad,a:b0,platform:Linux,\n"));
+
+        DeckGamepadSdlControllerDb reloaded;
+        QCOMPARE(reloaded.loadDatabase(source), 4);
+        QVERIFY(reloaded.hasMapping(QStringLiteral("03000000aaaabbbb0000000000000000")));
+        QCOMPARE(reloaded.getDeviceName(QStringLiteral("0300000011112222000000000000000")),
+                 QStringLiteral("Short Guid Pad"));
+    }
+
+    void overlay_addsAndRemovesOverIndex()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString source = dir.filePath(QStringLiteral("gamecontrollerdb.txt"));
+        QVERIFY(writeFile(source, sampleDatabase()));
+
+        DeckGamepadSdlControllerDb db;
+        QCOMPARE(db.loadDatabase(source), 2);
+        QVERIFY(!db.indexPath().isEmpty());
+
+        // 覆盖基础 index 中的条目：计数不变，查询命中覆盖层
+        QVERIFY(db.addMapping(kOtherGuid + QStringLiteral(",Other Pad Override,a:b0,platform:Linux")));
+        QCOMPARE(db.mappingCount(), 2);
+        QCOMPARE(db.getDeviceName(kOtherGuid), QStringLiteral("Other Pad Override"));
+
+        const QString extra = dir.filePath(QStringLiteral("extra.txt"));
+        QVERIFY(writeFile(extra, "03000000aaaabbbb0000000000000000,Extra Pad,a:b0,platform:Linux,\n"));
+        QCOMPARE(db.appendDatabase(extra), 1);
+        QCOMPARE(db.mappingCount(), 3);
+
+        db.removeMapping(kPadGuid);
+        QVERIFY(!db.hasMapping(kPadGuid));
+        QVERIFY(!padMapping(db).isValid());
+        QCOMPARE(db.mappingCount(), 2);
+
+        db.removeMapping(kOtherGuid);
+        QVERIFY(!db.hasMapping(kOtherGuid));
+        QCOMPARE(db.mappingCount(), 1);
+        QCOMPARE(db.exportMappings(), QStringList{ QStringLiteral("03000000aaaabbbb0000000000000000") });
+
+        // 重新添加被移除的基础条目
+        QVERIFY(db.addMapping(kPadGuid + QStringLiteral(",Test Pad Again,a:b0,platform:Linux")));
+        QCOMPARE(db.mappingCount(), 2);
+        QCOMPARE(db.getDeviceName(kPadGuid), QStringLiteral("Test Pad Again"));
+    }
+
+    void precompiledSibling_isUsedWhenMtimeDiffers()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString source = dir.filePath(QStringLiteral("gamecontrollerdb.txt"));
+        const QString sibling = dir.filePath(QStringLiteral("gamecontrollerdb.bin"));
+        QVERIFY(writeFile(source, sampleDatabase()));
+        QVERIFY(DeckGamepadSdlControllerDb::compileDatabase(source, sibling));
+
+        // 模拟安装后时间戳变化：size 相同，内容哈希兜底
+        {
+            QFile file(source);
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.setFileTime(QDateTime::currentDateTime().addDays(-3), QFileDevice::FileModificationTime));
+        }
+
+        DeckGamepadSdlControllerDb db;
+        QCOMPARE(db.loadDatabase(source), 2);
+        QCOMPARE(db.indexPath(), sibling);
+        QVERIFY(padMapping(db).isValid());
+
+        // 哈希确认后写入带当前 mtime 的运行期缓存：下次启动直接命中缓存，不再重算哈希
+        DeckGamepadSdlControllerDb again;
+        QCOMPARE(again.loadDatabase(source), 2);
+        QVERIFY(again.indexPath() != sibling);
+        QVERIFY(again.indexPath().startsWith(m_cacheHome.path()));
+        QCOMPARE(again.getDeviceName(kPadGuid), QStringLiteral("Test Pad"));
+    }
+
+private:
+    QTemporaryDir m_cacheHome;
+};
+
+QTEST_MAIN(TestSdlDbCache)
+#include "test_sdl_db_cache.moc"
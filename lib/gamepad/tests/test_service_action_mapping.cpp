@@ -9,6 +9,7 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
 #include <QtTest/QSignalSpy>
 #include <QtTest/QTest>
 
@@ -44,6 +45,86 @@ private Q_SLOTS:
         QCOMPARE(args.at(3).toBool(), false);
     }
 
+    void stringSignalsAreForwardedOnlyWhileConnected()
+    {
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+
+        QVERIFY(service.start());
+
+        DeckGamepadButtonEvent ev;
+        ev.time_msec = 1;
+        ev.button = static_cast<uint32_t>(GAMEPAD_BUTTON_A);
+
+        // 只订阅整数 id：mapper 在此时创建，不订阅字符串信号。
+        QSignalSpy idSpy(&service, &DeckGamepadService::actionTriggeredId);
+        ev.pressed = true;
+        provider->emitButtonEvent(1, ev);
+        QCOMPARE(idSpy.count(), 1);
+        QCOMPARE(idSpy.at(0).at(1).toInt(), int(DECKGAMEPAD_ACTION_NAV_ACCEPT));
+
+        // mapper 已存在后再连接字符串信号，也应开始转发。
+        {
+            QSignalSpy eventSpy(&service, &DeckGamepadService::actionEvent);
+            QSignalSpy stringSpy(&service, &DeckGamepadService::actionTriggered);
+            ev.pressed = false;
+            provider->emitButtonEvent(1, ev);
+            QCOMPARE(idSpy.count(), 2);
+            QCOMPARE(stringSpy.count(), 1);
+            QCOMPARE(stringSpy.at(0).at(1).toString(), QString::fromLatin1(DeckGamepadActionId::NavAccept));
+            QCOMPARE(eventSpy.count(), 1);
+            const auto event = qvariant_cast<DeckGamepadActionEvent>(eventSpy.at(0).at(1));
+            QCOMPARE(event.numericId, int(DECKGAMEPAD_ACTION_NAV_ACCEPT));
+            QVERIFY(!event.pressed);
+        }
+
+        // 字符串监听断开后整数 id 仍照常发出。
+        ev.pressed = true;
+        provider->emitButtonEvent(1, ev);
+        QCOMPARE(idSpy.count(), 3);
+    }
+
+    void stringSignalsConnectedFromAnotherThread()
+    {
+        auto *provider = new TestGamepadProvider();
+        DeckGamepadService service(provider);
+
+        QVERIFY(service.start());
+
+        DeckGamepadButtonEvent ev;
+        ev.time_msec = 1;
+        ev.button = static_cast<uint32_t>(GAMEPAD_BUTTON_A);
+        ev.pressed = true;
+        provider->emitButtonEvent(1, ev);
+
+        // connectNotify 在连接方线程执行：订阅更新须延后到服务线程完成。
+        QObject receiver;
+        int stringCount = 0;
+        QThread *thread = QThread::create([&] {
+            QObject::connect(&service,
+                             &DeckGamepadService::actionTriggered,
+                             &receiver,
+                             [&stringCount](int, const QString &, bool, bool) { ++stringCount; },
+                             Qt::DirectConnection);
+        });
+        thread->start();
+        QVERIFY(thread->wait(5000));
+        delete thread;
+
+        ev.pressed = false;
+        provider->emitButtonEvent(1, ev);
+        QCOMPARE(stringCount, 1);
+
+        // 断开后由排队的重新判定退订字符串信号，整数 id 照常发出。
+        QSignalSpy idSpy(&service, &DeckGamepadService::actionTriggeredId);
+        QObject::disconnect(&service, &DeckGamepadService::actionTriggered, &receiver, nullptr);
+        QCoreApplication::processEvents();
+        ev.pressed = true;
+        provider->emitButtonEvent(1, ev);
+        QCOMPARE(stringCount, 1);
+        QCOMPARE(idSpy.count(), 1);
+    }
+
     void hatDerivesVirtualDpadButtons()
     {
         auto *provider = new TestGamepadProvider();
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "testprovider.h"
+
+#include <deckshell/deckgamepad/core/deckgamepadsharedstate.h>
+#include <deckshell/deckgamepad/core/deckgamepadsharedstate_p.h>
+#include <deckshell/deckgamepad/service/deckgamepadservice.h>
+
+#include <QtTest/QTest>
+
+#include <atomic>
+#include <thread>
+
+using namespace deckshell::deckgamepad;
+
+class TestSharedState : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void publishesFramesAtomically()
+    {
+        DeckGamepadSharedStateWriter writer;
+        QString error;
+        QVERIFY2(writer.create(&error), qPrintable(error));
+        QVERIFY(writer.fd() >= 0);
+        QCOMPARE(writer.acquireSlot(3), 0);
+
+        DeckGamepadSharedStateReader reader;
+        QVERIFY2(reader.attach(writer.fd()), qPrintable(reader.errorString()));
+        QCOMPARE(reader.deviceIds(), QList<int>{ 3 });
+
+        DeckGamepadFrameEvent frame;
+        frame.time_msec = 42;
+        frame.buttons.append(DeckGamepadButtonEvent{ 42, GAMEPAD_BUTTON_A, true });
+        frame.buttons.append(DeckGamepadButtonEvent{ 42, GAMEPAD_BUTTON_B, true });
+        frame.buttons.append(DeckGamepadButtonEvent{ 42, GAMEPAD_BUTTON_B, false });
+        frame.axes.append(DeckGamepadAxisEvent{ 42, GAMEPAD_AXIS_LEFT_X, 0.5 });
+        frame.hats.append(DeckGamepadHatEvent{ 42, 0, GAMEPAD_HAT_UP | GAMEPAD_HAT_LEFT });
+        writer.publishFrame(3, frame);
+
+        DeckGamepadStateSample sample;
+        QVERIFY(reader.read(3, &sample));
+        QCOMPARE(sample.deviceId, 3);
+        QVERIFY(sample.button(GAMEPAD_BUTTON_A));
+        QVERIFY(!sample.button(GAMEPAD_BUTTON_B));
+        QCOMPARE(sample.axis(GAMEPAD_AXIS_LEFT_X), 0.5);
+        QCOMPARE(sample.hat(0), int(GAMEPAD_HAT_UP | GAMEPAD_HAT_LEFT));
+        QCOMPARE(sample.frameCounter, quint64(1));
+        QCOMPARE(sample.timeMsec, quint32(42));
+        QVERIFY(sample.timestampNs > 0);
+
+        writer.publishButton(3, DeckGamepadButtonEvent{ 50, GAMEPAD_BUTTON_A, false });
+        QVERIFY(reader.read(3, &sample));
+        QCOMPARE(sample.buttons, quint32(0));
+        QCOMPARE(sample.frameCounter, quint64(2));
+
+        // 未占槽的设备不发布；释放后读取失败，重新占用从零状态开始。
+        writer.publishButton(9, DeckGamepadButtonEvent{ 60, GAMEPAD_BUTTON_X, true });
+        QVERIFY(!reader.read(9, &sample));
+        const quint64 generation = reader.generation();
+        writer.releaseSlot(3);
+        QVERIFY(reader.generation() > generation);
+        QVERIFY(!reader.read(3, &sample));
+        writer.acquireSlot(3);
+        QVERIFY(reader.read(3, &sample));
+        QCOMPARE(sample.axis(GAMEPAD_AXIS_LEFT_X), 0.0);
+        QCOMPARE(sample.frameCounter, quint64(0));
+    }
+
+    void attachesReadOnlyByPath()
+    {
+        DeckGamepadSharedStateWriter writer;
+        QVERIFY(writer.create(nullptr));
+        writer.acquireSlot(1);
+        writer.publishAxis(1, DeckGamepadAxisEvent{ 1, GAMEPAD_AXIS_RIGHT_Y, -0.25 });
+
+        DeckGamepadSharedStateReader reader;
+        QVERIFY2(reader.attach(QStringLiteral("/proc/self/fd/%1").arg(writer.fd())), qPrintable(reader.errorString()));
+        DeckGamepadStateSample sample;
+        QVERIFY(reader.read(1, &sample));
+        QCOMPARE(sample.axis(GAMEPAD_AXIS_RIGHT_Y), -0.25);
+
+        DeckGamepadSharedStateReader missing;
+        QVERIFY(!missing.attach(QStringLiteral("/nonexistent/deckgamepad-state")));
+        QVERIFY(!missing.errorString().isEmpty());
+    }
+
+    void readerNeverSeesTornState()
+    {
+        DeckGamepadSharedStateWriter writer;
+        QVERIFY(writer.create(nullptr));
+        writer.acquireSlot(0);
+
+        DeckGamepadSharedStateReader reader;
+        QVERIFY(reader.attach(writer.fd()));
+
+        // 写端第 n 帧把全部轴写成 n/1e5、按 n 的奇偶设置按钮 A，time_msec = n；读端任何一次成功读取都必须自洽。
+        std::atomic<bool> done{ false };
+        std::atomic<int> torn{ 0 };
+        std::atomic<int> reads{ 0 };
+        std::thread consumer([&] {
+            DeckGamepadStateSample sample;
+            while (!done.load(std::memory_order_relaxed)) {
+                if (!reader.read(0, &sample)) {
+                    continue;
+                }
+                reads.fetch_add(1, std::memory_order_relaxed);
+                if (sample.timeMsec == 0) {
+                    continue;
+                }
+                const auto expected = float(double(sample.timeMsec) / 100000.0);
+                for (int i = 0; i < GAMEPAD_AXIS_MAX; ++i) {
+                    if (sample.axes[size_t(i)] != expected) {
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                if (sample.button(GAMEPAD_BUTTON_A) != ((sample.timeMsec % 2) == 1)) {
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        for (int n = 1; n <= 50000; ++n) {
+            DeckGamepadFrameEvent frame;
+            frame.time_msec = uint32_t(n);
+            const double value = double(n) / 100000.0;
+            for (int axis = 0; axis < GAMEPAD_AXIS_MAX; ++axis) {
+                frame.axes.append(DeckGamepadAxisEvent{ uint32_t(n), uint32_t(axis), value });
+            }
+            frame.buttons.append(DeckGamepadButtonEvent{ uint32_t(n), GAMEPAD_BUTTON_A, (n % 2) == 1 });
+            writer.publishFrame(0, frame);
+        }
+        done.store(true, std::memory_order_relaxed);
+        consumer.join();
+
+        QCOMPARE(torn.load(), 0);
+        QVERIFY(reads.load() > 0);
+    }
+
+    void servicePublishesProviderEvents()
+    {
+        auto *provider = new TestGamepadProvider();
+        provider->addConnectedGamepad(5, QStringLiteral("Pad"));
+        DeckGamepadService service(provider);
+        QCOMPARE(service.sharedStateFd(), -1);
+        QVERIFY(service.sharedStatePath().isEmpty());
+
+        QVERIFY(service.start());
+        QVERIFY(service.enableSharedState());
+        QVERIFY(service.enableSharedState());
+        QVERIFY(service.sharedStateFd() >= 0);
+
+        DeckGamepadSharedStateReader reader;
+        QVERIFY2(reader.attach(service.sharedStatePath()), qPrintable(reader.errorString()));
+        // 运行中启用：已连接设备立即有槽位。
+        QCOMPARE(reader.deviceIds(), QList<int>{ 5 });
+
+        provider->emitButtonEvent(5, DeckGamepadButtonEvent{ 10, GAMEPAD_BUTTON_Y, true });
+        provider->emitAxisEvent(5, DeckGamepadAxisEvent{ 11, GAMEPAD_AXIS_TRIGGER_LEFT, 1.0 });
+        provider->emitHatEvent(5, DeckGamepadHatEvent{ 12, 0, GAMEPAD_HAT_DOWN });
+
+        DeckGamepadStateSample sample;
+        QVERIFY(reader.read(5, &sample));
+        QVERIFY(sample.button(GAMEPAD_BUTTON_Y));
+        QCOMPARE(sample.axis(GAMEPAD_AXIS_TRIGGER_LEFT), 1.0);
+        QCOMPARE(sample.hat(0), int(GAMEPAD_HAT_DOWN));
+        QCOMPARE(sample.frameCounter, quint64(3));
+
+        provider->addConnectedGamepad(6, QStringLiteral("Pad 2"));
+        QCOMPARE(reader.deviceIds(), (QList<int>{ 5, 6 }));
+        provider->removeConnectedGamepad(5);
+        QCOMPARE(reader.deviceIds(), QList<int>{ 6 });
+
+        service.stop();
+        QVERIFY(reader.deviceIds().isEmpty());
+    }
+};
+
+QTEST_MAIN(TestSharedState)
+
+#include "test_shared_state.moc"
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// SteamInputDetector 未调用 detectSteamInput()、自动检测关闭时仍按实时 /proc 状态回答。
+
+#include <deckshell/deckgamepad/extras/steaminputdetector.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QProcess>
+#include <QtCore/QTemporaryFile>
+#include <QtTest/QTest>
+
+using namespace deckshell::deckgamepad;
+
+class TestSteamInputDetector : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void freshDetectorSeesRunningProcesses()
+    {
+        // 本进程 cmdline（test_steam_input_detector）含 "steam"，会被当作 Steam 进程匹配。
+        QVERIFY(QCoreApplication::arguments().constFirst().contains(QStringLiteral("steam")));
+
+        SteamInputDetector detector;
+        QVERIFY(detector.isSteamProcessRunning());
+        QVERIFY(detector.steamProcesses().contains(QStringLiteral("steam")));
+
+        // Steam 运行中才会探测设备节点：未被占用的节点不冲突。
+        QTemporaryFile node;
+        QVERIFY(node.open());
+        QVERIFY(!detector.checkDeviceConflict(node.fileName()));
+    }
+
+    void idleDetectorRefreshesOnQuery()
+    {
+        SteamInputDetector detector;
+        QVERIFY(!detector.isAutoDetectEnabled());
+        QVERIFY(!detector.steamProcesses().contains(QStringLiteral("reaper")));
+
+        // $0 为 "reaper" 的子进程；"; :" 阻止 shell 直接 exec sleep 而丢掉该 cmdline。
+        QProcess child;
+        child.start(QStringLiteral("/bin/sh"),
+                    { QStringLiteral("-c"), QStringLiteral("sleep 30; :"), QStringLiteral("reaper") });
+        QVERIFY(child.waitForStarted());
+
+        QVERIFY(detector.steamProcesses().contains(QStringLiteral("reaper")));
+
+        child.kill();
+        QVERIFY(child.waitForFinished());
+        QVERIFY(!detector.steamProcesses().contains(QStringLiteral("reaper")));
+    }
+};
+
+QTEST_MAIN(TestSteamInputDetector)
+
+#include "test_steam_input_detector.moc"
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/extras/steamprocesswatcher_p.h>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+using namespace deckshell::deckgamepad;
+
+namespace {
+
+const QStringList kSteamNames = {
+    QStringLiteral("steam"),
+    QStringLiteral("steamwebhelper"),
+    QStringLiteral("reaper"),
+};
+
+// 伪 /proc：<root>/<pid>/cmdline（argv 以 NUL 分隔）。
+void addProcess(const QTemporaryDir &root, int pid, const QByteArray &cmdline)
+{
+    const QString dir = root.filePath(QString::number(pid));
+    QVERIFY(QDir().mkpath(dir));
+    QFile file(dir + QStringLiteral("/cmdline"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QByteArray raw = cmdline;
+    raw.replace(' ', '\0');
+    raw.append('\0');
+    file.write(raw);
+}
+
+void removeProcess(const QTemporaryDir &root, int pid)
+{
+    QVERIFY(QDir(root.filePath(QString::number(pid))).removeRecursively());
+}
+
+} // namespace
+
+class TestSteamProcessWatcher : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initialScanMatchesCmdline()
+    {
+        QTemporaryDir root;
+        QVERIFY(root.isValid());
+        addProcess(root, 100, "/usr/bin/bash");
+        addProcess(root, 200, "/home/deck/.local/share/Steam/ubuntu12_32/STEAM -silent");
+        QVERIFY(QDir().mkpath(root.filePath(QStringLiteral("self"))));
+
+        SteamProcessWatcher watcher(nullptr, root.path());
+        watcher.setProcessNames(kSteamNames);
+        QCOMPARE(watcher.start(), SteamProcessWatcher::Mode::Polling);
+
+        QVERIFY(watcher.isSteamRunning());
+        QCOMPARE(watcher.matchedNames(), QStringList{ QStringLiteral("steam") });
+        QCOMPARE(watcher.cmdlineReadCount(), quint64(2));
+    }
+
+    void incrementalRefreshReadsOnlyNewPids()
+    {
+        QTemporaryDir root;
+        QVERIFY(root.isValid());
+        for (int pid = 1000; pid < 1200; ++pid) {
+            addProcess(root, pid, "/usr/libexec/some-daemon --flag");
+        }
+
+        SteamProcessWatcher watcher(nullptr, root.path());
+        watcher.setProcessNames(kSteamNames);
+        QSignalSpy spy(&watcher, &SteamProcessWatcher::steamRunningChanged);
+
+        watcher.refresh();
+        QVERIFY(!watcher.isSteamRunning());
+        QCOMPARE(watcher.cmdlineReadCount(), quint64(200));
+
+        // 已见过的 pid 不再读取 cmdline。
+        watcher.refresh();
+        QCOMPARE(watcher.cmdlineReadCount(), quint64(200));
+
+        addProcess(root, 4242, "reaper SteamLaunch AppId=123");
+        watcher.refresh();
+        QCOMPARE(watcher.cmdlineReadCount(), quint64(201));
+        QVERIFY(watcher.isSteamRunning());
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toBool(), true);
+
+        // 候选 pid 只复核 stat：刷新不产生额外读取。
+        watcher.refresh();
+        QCOMPARE(watcher.cmdlineReadCount(), quint64(201));
+
+        removeProcess(root, 4242);
+        watcher.refresh();
+        QVERIFY(!watcher.isSteamRunning());
+        QCOMPARE(spy.count(), 2);
+        QCOMPARE(spy.at(1).at(0).toBool(), false);
+    }
+
+    void periodicFullRescanCatchesMissedChanges()
+    {
+        QTemporaryDir root;
+        QVERIFY(root.isValid());
+        addProcess(root, 300, "/usr/bin/sleep 100");
+
+        SteamProcessWatcher watcher(nullptr, root.path());
+        watcher.setProcessNames(kSteamNames);
+        watcher.refresh();
+        QVERIFY(!watcher.isSteamRunning());
+
+        // 同一 pid 被复用为 Steam 进程：增量扫描看不到，由周期性全量扫描补齐。
+        addProcess(root, 300, "steamwebhelper --type=renderer");
+        for (int i = 0; i < SteamProcessWatcher::kFullRescanEvery; ++i) {
+            watcher.refresh();
+        }
+        QVERIFY(watcher.isSteamRunning());
+        QCOMPARE(watcher.matchedNames(), QStringList{ QStringLiteral("steamwebhelper") });
+    }
+};
+
+QTEST_MAIN(TestSteamProcessWatcher)
+
+#include "test_steam_process_watcher.moc"
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// TreelandGamepadClient 异步连接与读取线程：用进程内最小 wayland-server（不提供 treeland 协议）验证
+// connectFailed 与读取线程运行中的析构。
+
+#include <deckshell/deckgamepad/treeland/treelandgamepadclient.h>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <wayland-server-core.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using TreelandGamepad::TreelandGamepadClient;
+
+namespace {
+
+// 只监听 socket 的 compositor 替身；startLoop() 后在后台线程分发（应答 registry/sync）。
+class FakeCompositor
+{
+public:
+    FakeCompositor()
+        : m_display(wl_display_create())
+    {
+        m_socket = m_display ? wl_display_add_socket_auto(m_display) : nullptr;
+    }
+
+    ~FakeCompositor()
+    {
+        stopLoop();
+        if (m_display) {
+            wl_display_destroy(m_display);
+        }
+    }
+
+    bool isValid() const { return m_socket != nullptr; }
+    QString socketName() const { return QString::fromUtf8(m_socket); }
+
+    void startLoop()
+    {
+        m_thread = std::thread([this] {
+            wl_event_loop *loop = wl_display_get_event_loop(m_display);
+            while (!m_stop.load(std::memory_order_acquire)) {
+                wl_event_loop_dispatch(loop, 10);
+                wl_display_flush_clients(m_display);
+            }
+        });
+    }
+
+    void stopLoop()
+    {
+        if (m_thread.joinable()) {
+            m_stop.store(true, std::memory_order_release);
+            m_thread.join();
+        }
+    }
+
+private:
+    wl_display *m_display = nullptr;
+    const char *m_socket = nullptr;
+    std::atomic<bool> m_stop{ false };
+    std::thread m_thread;
+};
+
+TreelandGamepadClient::ConnectOptions readerThreadOptions()
+{
+    TreelandGamepadClient::ConnectOptions options;
+    options.async = true;
+    options.dispatchMode = TreelandGamepadClient::DispatchMode::ReaderThread;
+    return options;
+}
+
+} // namespace
+
+class TestTreelandClient : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        // socket 只落在临时目录；WAYLAND_SOCKET 会让 wl_display_connect 忽略 name，需清掉。
+        QVERIFY(m_runtimeDir.isValid());
+        qputenv("XDG_RUNTIME_DIR", QFile::encodeName(m_runtimeDir.path()));
+        qunsetenv("WAYLAND_SOCKET");
+    }
+
+    void missingSocketEmitsConnectFailed()
+    {
+        TreelandGamepadClient client;
+        QSignalSpy failed(&client, &TreelandGamepadClient::connectFailed);
+        QSignalSpy connected(&client, &TreelandGamepadClient::connectedChanged);
+
+        TreelandGamepadClient::ConnectOptions options;
+        options.async = true;
+        QVERIFY(client.connectToCompositor(QStringLiteral("deckgamepad-test-missing"), options));
+        QVERIFY(!client.isConnecting());
+        QCOMPARE(failed.count(), 0);
+
+        QTRY_COMPARE_WITH_TIMEOUT(failed.count(), 1, 1000);
+        QCOMPARE(connected.count(), 0);
+        QVERIFY(!client.isConnected());
+
+        // 同步模式仍以返回值报告失败。
+        QVERIFY(!client.connectToCompositor(QStringLiteral("deckgamepad-test-missing")));
+        QTest::qWait(20);
+        QCOMPARE(failed.count(), 1);
+    }
+
+    void missingProtocolEmitsConnectFailedWithReaderThread()
+    {
+        FakeCompositor compositor;
+        QVERIFY(compositor.isValid());
+        compositor.startLoop();
+
+        TreelandGamepadClient client;
+        QSignalSpy failed(&client, &TreelandGamepadClient::connectFailed);
+        QSignalSpy connected(&client, &TreelandGamepadClient::connectedChanged);
+
+        QVERIFY(client.connectToCompositor(compositor.socketName(), readerThreadOptions()));
+        QVERIFY(client.isConnecting());
+
+        QTRY_COMPARE_WITH_TIMEOUT(failed.count(), 1, 2000);
+        QCOMPARE(connected.count(), 0);
+        QVERIFY(!client.isConnecting());
+    }
+
+    void teardownWhileReaderThreadBlocked()
+    {
+        // compositor 不分发：读取线程停在 poll 上，析构必须唤醒并回收它。
+        FakeCompositor compositor;
+        QVERIFY(compositor.isValid());
+
+        auto client = std::make_unique<TreelandGamepadClient>();
+        QSignalSpy failed(client.get(), &TreelandGamepadClient::connectFailed);
+        QVERIFY(client->connectToCompositor(compositor.socketName(), readerThreadOptions()));
+        QTest::qWait(50);
+        QVERIFY(client->isConnecting());
+
+        QElapsedTimer clock;
+        clock.start();
+        client.reset();
+        QVERIFY2(clock.elapsed() < 1000, qPrintable(QString::number(clock.elapsed())));
+        QCOMPARE(failed.count(), 0);
+    }
+
+    void teardownWithBatchPending()
+    {
+        // compositor 已应答、读取线程已投递分发但事件循环尚未运行时析构：排队的分发随对象一起丢弃。
+        FakeCompositor compositor;
+        QVERIFY(compositor.isValid());
+        compositor.startLoop();
+
+        for (int i = 0; i < 20; ++i) {
+            auto client = std::make_unique<TreelandGamepadClient>();
+            QVERIFY(client->connectToCompositor(compositor.socketName(), readerThreadOptions()));
+            std::this_thread::sleep_for(std::chrono::milliseconds(i % 5));
+            client.reset();
+        }
+        QTest::qWait(20);
+    }
+
+private:
+    QTemporaryDir m_runtimeDir;
+};
+
+QTEST_MAIN(TestTreelandClient)
+
+#include "test_treeland_client.moc"
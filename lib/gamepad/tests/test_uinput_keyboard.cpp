@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/extras/deckgamepadkeyboardmapping.h>
+#include <deckshell/deckgamepad/extras/deckgamepaduinputkeyboard.h>
+
+#include <QtTest/QTest>
+
+#include <linux/input.h>
+
+using namespace deckshell::deckgamepad;
+
+namespace {
+using Batch = QList<QPair<int, bool>>;
+
+DeckGamepadFrameEvent axisFrame(std::initializer_list<QPair<GamepadAxis, double>> axes)
+{
+    DeckGamepadFrameEvent frame;
+    for (const auto &axis : axes) {
+        frame.axes.append(DeckGamepadAxisEvent{ 0, uint32_t(axis.first), axis.second });
+    }
+    return frame;
+}
+
+DeckGamepadFrameEvent buttonFrame(GamepadButton button, bool pressed)
+{
+    DeckGamepadFrameEvent frame;
+    frame.buttons.append(DeckGamepadButtonEvent{ 0, uint32_t(button), pressed });
+    return frame;
+}
+} // namespace
+
+class TestUinputKeyboard : public QObject
+{
+    Q_OBJECT
+
+private:
+    void record(DeckGamepadUinputKeyboard &keyboard)
+    {
+        keyboard.setOutput([this](const DeckGamepadKeyboardKeyChange *changes, int count) {
+            Batch batch;
+            for (int i = 0; i < count; ++i) {
+                batch.append(qMakePair(int(changes[i].code), changes[i].pressed));
+            }
+            m_batches.append(batch);
+            return true;
+        });
+    }
+
+    QList<Batch> m_batches;
+
+private Q_SLOTS:
+    void init() { m_batches.clear(); }
+
+    void translatesQtKeys()
+    {
+        QCOMPARE(DeckGamepadUinputKeyboard::linuxKeyCode(Qt::Key_W), KEY_W);
+        QCOMPARE(DeckGamepadUinputKeyboard::linuxKeyCode(Qt::Key_Space), KEY_SPACE);
+        QCOMPARE(DeckGamepadUinputKeyboard::linuxKeyCode(Qt::Key_Return), KEY_ENTER);
+        QCOMPARE(DeckGamepadUinputKeyboard::linuxKeyCode(Qt::Key_4), KEY_4);
+        QCOMPARE(DeckGamepadUinputKeyboard::linuxKeyCode(Qt::Key_4, Qt::KeypadModifier), KEY_KP4);
+        QCOMPARE(DeckGamepadUinputKeyboard::linuxKeyCode(Qt::Key_unknown), 0);
+    }
+
+    void wasdPresetBatchesPerFrame()
+    {
+        DeckGamepadUinputKeyboard keyboard;
+        record(keyboard);
+
+        DeckGamepadKeyboardMappingManager manager;
+        manager.setUinputKeyboard(&keyboard);
+        manager.applyWASDPreset();
+
+        // 未启用时不输出。
+        keyboard.processFrame(0, axisFrame({ { GAMEPAD_AXIS_LEFT_X, -0.8 } }));
+        QVERIFY(m_batches.isEmpty());
+
+        manager.setEnabled(true);
+        DeckGamepadFrameEvent frame = axisFrame({ { GAMEPAD_AXIS_LEFT_X, -0.8 }, { GAMEPAD_AXIS_LEFT_Y, -0.8 } });
+        frame.buttons.append(DeckGamepadButtonEvent{ 0, GAMEPAD_BUTTON_A, true });
+        keyboard.processFrame(0, frame);
+
+        QCOMPARE(m_batches.size(), 1);
+        QCOMPARE(m_batches.first(), (Batch{ { KEY_SPACE, true }, { KEY_A, true }, { KEY_W, true } }));
+        QCOMPARE(keyboard.reportCount(), quint64(1));
+        QCOMPARE(keyboard.keyEventCount(), quint64(3));
+
+        // 状态不变的帧不产生输出。
+        keyboard.processFrame(0, axisFrame({ { GAMEPAD_AXIS_LEFT_X, -0.9 } }));
+        QCOMPARE(m_batches.size(), 1);
+
+        keyboard.processFrame(0, axisFrame({ { GAMEPAD_AXIS_LEFT_X, 0.0 }, { GAMEPAD_AXIS_LEFT_Y, 0.8 } }));
+        QCOMPARE(m_batches.size(), 2);
+        QCOMPARE(m_batches.last(), (Batch{ { KEY_A, false }, { KEY_W, false }, { KEY_S, true } }));
+
+        // 禁用映射时释放仍按下的按键。
+        manager.setEnabled(false);
+        QCOMPARE(m_batches.size(), 3);
+        QCOMPARE(m_batches.last(), (Batch{ { KEY_SPACE, false }, { KEY_S, false } }));
+    }
+
+    void sharedKeysAreReferenceCounted()
+    {
+        DeckGamepadUinputKeyboard keyboard;
+        record(keyboard);
+
+        QHash<GamepadButton, KeyMapping> buttons;
+        buttons.insert(GAMEPAD_BUTTON_A, KeyMapping(Qt::Key_Q, Qt::ControlModifier));
+        buttons.insert(GAMEPAD_BUTTON_B, KeyMapping(Qt::Key_Control));
+        keyboard.setMappings(buttons, {});
+
+        keyboard.processFrame(1, buttonFrame(GAMEPAD_BUTTON_A, true));
+        QCOMPARE(m_batches.last(), (Batch{ { KEY_LEFTCTRL, true }, { KEY_Q, true } }));
+
+        // 其他设备/映射再按下同一按键：不重复输出。
+        keyboard.processFrame(2, buttonFrame(GAMEPAD_BUTTON_A, true));
+        keyboard.processFrame(2, buttonFrame(GAMEPAD_BUTTON_B, true));
+        QCOMPARE(m_batches.size(), 1);
+
+        keyboard.processFrame(1, buttonFrame(GAMEPAD_BUTTON_A, false));
+        QCOMPARE(m_batches.size(), 1);
+
+        keyboard.processFrame(2, buttonFrame(GAMEPAD_BUTTON_A, false));
+        QCOMPARE(m_batches.last(), (Batch{ { KEY_Q, false } }));
+
+        // 断开设备释放其按键；未按下的按钮松开不输出。
+        keyboard.releaseDevice(2);
+        QCOMPARE(m_batches.last(), (Batch{ { KEY_LEFTCTRL, false } }));
+        const int count = int(m_batches.size());
+        keyboard.processFrame(2, buttonFrame(GAMEPAD_BUTTON_B, false));
+        QCOMPARE(m_batches.size(), count);
+    }
+
+    void hatDrivesDpadMappings()
+    {
+        DeckGamepadUinputKeyboard keyboard;
+        record(keyboard);
+
+        DeckGamepadKeyboardMappingManager manager;
+        manager.applyArrowPreset();
+        manager.setEnabled(true);
+        manager.setUinputKeyboard(&keyboard);
+
+        DeckGamepadFrameEvent frame;
+        frame.hats.append(DeckGamepadHatEvent{ 0, 0, GAMEPAD_HAT_UP | GAMEPAD_HAT_LEFT });
+        keyboard.processFrame(0, frame);
+        QCOMPARE(m_batches.last(), (Batch{ { KEY_UP, true }, { KEY_LEFT, true } }));
+
+        frame.hats.first().value = GAMEPAD_HAT_LEFT;
+        keyboard.processFrame(0, frame);
+        QCOMPARE(m_batches.last(), (Batch{ { KEY_UP, false } }));
+
+        // 映射替换先按旧映射释放。
+        manager.applyWASDPreset();
+        QCOMPARE(m_batches.last(), (Batch{ { KEY_LEFT, false } }));
+
+        frame.hats.first().value = GAMEPAD_HAT_CENTER;
+        const int count = int(m_batches.size());
+        keyboard.processFrame(0, frame);
+        QCOMPARE(m_batches.size(), count);
+    }
+};
+
+QTEST_MAIN(TestUinputKeyboard)
+
+#include "test_uinput_keyboard.moc"
@@ -48,16 +48,16 @@ public:
 
     void setAxisDeadzone(int deviceId, uint32_t axis, float deadzone) override
     {
-        Q_UNUSED(deviceId);
         Q_UNUSED(axis);
         Q_UNUSED(deadzone);
+        m_axisDeadzoneCalls[deviceId]++;
     }
 
     void setAxisSensitivity(int deviceId, uint32_t axis, float sensitivity) override
     {
-        Q_UNUSED(deviceId);
         Q_UNUSED(axis);
         Q_UNUSED(sensitivity);
+        m_axisSensitivityCalls[deviceId]++;
     }
 
     bool startVibration(int deviceId, float weakMagnitude, float strongMagnitude, int durationMs) override
@@ -79,6 +79,13 @@ public:
 
     // test controls
     void setStartOk(bool ok) { m_startOk = ok; }
+    int axisDeadzoneCallCount(int deviceId) const { return m_axisDeadzoneCalls.value(deviceId); }
+    int axisSensitivityCallCount(int deviceId) const { return m_axisSensitivityCalls.value(deviceId); }
+    void resetAxisTuningCallCounts()
+    {
+        m_axisDeadzoneCalls.clear();
+        m_axisSensitivityCalls.clear();
+    }
     void setLastErrorValue(const DeckGamepadError &error) { m_lastError = error; }
     void setDiagnosticValue(const DeckGamepadDiagnostic &diag) { m_diagnostic = diag; }
 
@@ -115,6 +122,7 @@ public:
     void emitButtonEvent(int deviceId, DeckGamepadButtonEvent event) { Q_EMIT buttonEvent(deviceId, event); }
     void emitAxisEvent(int deviceId, DeckGamepadAxisEvent event) { Q_EMIT axisEvent(deviceId, event); }
     void emitHatEvent(int deviceId, DeckGamepadHatEvent event) { Q_EMIT hatEvent(deviceId, event); }
+    void emitFrameEvent(int deviceId, DeckGamepadFrameEvent frame) { Q_EMIT frameEvent(deviceId, frame); }
 
     void addConnectedGamepad(int deviceId, const QString &name = QStringLiteral("Test Gamepad"))
     {
@@ -150,6 +158,8 @@ private:
     QHash<int, QString> m_deviceUid;
     QHash<int, DeckGamepadDeviceAvailability> m_deviceAvailability;
     QHash<int, DeckGamepadError> m_deviceLastError;
+    QHash<int, int> m_axisDeadzoneCalls;
+    QHash<int, int> m_axisSensitivityCalls;
 };
 
 DECKGAMEPAD_END_NAMESPACE
@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2026 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <deckshell/deckgamepad/mapping/deckgamepadsdlcontrollerdb.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTextStream>
+
+using namespace deckshell::deckgamepad;
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const QStringList args = app.arguments();
+    if (args.size() != 3) {
+        QTextStream(stderr) << "Usage: deckgamepad-sdldb-compile <gamecontrollerdb.txt> <output.bin>\n";
+        return 2;
+    }
+
+    return DeckGamepadSdlControllerDb::compileDatabase(args.at(1), args.at(2)) ? 0 : 1;
+}